@@ -33,6 +33,9 @@
 #include "cCountTracker.h"
 #include "cDoubleSum.h"
 
+class cChunkBuffer;
+class cPopulationCheckpointWriter;
+
 
 namespace Avida {
   namespace Systematics {
@@ -60,6 +63,7 @@ namespace Avida {
     private:
       mutable GenotypeArbiterPtr m_mgr;
       Apto::List<GenotypePtr, Apto::SparseVector>::EntryHandle* m_handle;
+      Apto::List<GenotypePtr, Apto::SparseVector>::EntryHandle* m_threshold_handle;
       
       Source m_src;
       Genome m_genome;
@@ -125,8 +129,10 @@ namespace Avida {
       
       bool Serialize(ArchivePtr ar) const;
       bool LegacySave(void* df) const;
+      bool LegacySave(cPopulationCheckpointWriter& df) const;
 
       void RemoveActiveReference() const;
+      void RemovePassiveReference() const;
       
 
       // Genotype Specific Methods
@@ -165,6 +171,7 @@ namespace Avida {
             
     private:
       void setupPropertyMap() const;
+      template <class DF> void legacySave(DF& df) const;
       inline GenotypePtr thisPtr();
     };
 
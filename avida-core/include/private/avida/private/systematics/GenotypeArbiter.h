@@ -31,6 +31,8 @@
 
 #include "avida/private/systematics/Genotype.h"
 
+#include <cmath>
+
 
 namespace Avida {
   namespace Systematics {
@@ -47,17 +49,59 @@ namespace Avida {
         EVENT_REMOVE_THRESHOLD
       };
       
-      static const int HASH_SIZE = 3203;
-      
     private:
+      // Slot in the open-addressing genome table, empty when genotype is NULL
+      struct GenomeSlot
+      {
+        GenotypePtr genotype;
+        unsigned long long hash;
+        int stamp;
+        
+        GenomeSlot() : hash(0), stamp(0) { ; }
+      };
+      
+      // Running sums equivalent to a cDoubleSum of (value, weight) pairs.  They are kept as integers, modulo 2^64 so
+      // that transient overflow is harmless, which lets entries be subtracted and all values shifted without drift.
+      // Whenever the exact sum of squares fits in a double's mantissa, the derived statistics are identical to those of
+      // a cDoubleSum built from scratch.
+      struct StatSum
+      {
+        unsigned long long n;     // Sum (w)
+        unsigned long long s1;    // Sum (v * w)
+        unsigned long long s2;    // Sum ((v * w)^2), as accumulated by cDoubleSum
+        unsigned long long w2;    // Sum (w^2)
+        unsigned long long w2v;   // Sum (w^2 * v)
+        double s2_approx;         // Floating point s2, used only to tell whether the exact value is in range
+        
+        StatSum() : n(0), s1(0), s2(0), w2(0), w2v(0), s2_approx(0.0) { ; }
+        
+        inline void Add(long long v, long long w);
+        inline void Subtract(long long v, long long w);
+        inline void Shift(long long d);
+        
+        inline bool IsExact() const { return s2_approx < 4503599627370496.0; } // 2^52, leaving room for rounding
+        
+        inline double N() const { return (double)(long long)n; }
+        inline double Average() const;
+        inline double Variance() const;
+        inline double StdError() const;
+      };
+      
+
       // Config Settings
       int m_threshold;
       bool m_disable_class;
+      bool m_keep_loaded_ids;
       
       // Internal Data Structures
-      Apto::List<GenotypePtr, Apto::SparseVector> m_active_hash[HASH_SIZE];
+      Apto::Array<GenomeSlot> m_active_hash;    // Active genotypes by genome hash, linear probing, capacity power of 2
+      int m_active_hash_count;
+      int m_active_hash_stamp;                  // Insertion order, so that duplicate genomes resolve to the newest
+      Apto::Map<GroupID, GenotypePtr> m_id_index; // All genotypes (active and historic) by ID
       Apto::Array<Apto::List<GenotypePtr, Apto::SparseVector>, Apto::ManagedPointer> m_active_sz;
       Apto::List<GenotypePtr, Apto::SparseVector> m_historic;
+      Apto::List<GenotypePtr, Apto::SparseVector> m_threshold_list;
+      Apto::Array<GenotypePtr, Apto::Smart> m_pending_removal; // Historic genotypes that may have lost all references
       GenotypePtr m_coalescent;
       int m_best;
       int m_next_id;
@@ -67,6 +111,14 @@ namespace Avida {
       
       Update m_cur_update;
       
+      // Running totals over all genotypes with at least one unit, see UpdateProvidedValues
+      Update m_stats_update;                    // Update that ages in m_age_stats are relative to
+      StatSum m_age_stats;
+      StatSum m_abundance_stats;
+      StatSum m_depth_stats;
+      StatSum m_size_stats;
+      StatSum m_threshold_age_stats;
+      
       // Stats
       int m_tot_genotypes;
       
@@ -129,8 +181,15 @@ namespace Avida {
       
       bool Serialize(ArchivePtr ar) const;
       bool LegacySave(void* df) const;
+      bool LegacySave(cPopulationCheckpointWriter& df) const;
       GroupPtr LegacyLoad(void* props);
       
+      // Snapshot support, covering the id counter and dominant genotype tracking.  While loaded ids are kept,
+      // LegacyLoad gives each genotype the "id" it was saved with rather than the next free id.
+      void SaveState(cChunkBuffer& buf) const;
+      bool LoadState(cChunkBuffer& buf);
+      void SetKeepLoadedIDs(bool keep) { m_keep_loaded_ids = keep; }
+      
       IteratorPtr Begin();
       
       
@@ -157,12 +216,22 @@ namespace Avida {
       template <class T> Data::PackagePtr packageData(const T&) const;
       Data::ProviderPtr activateProvider(World*);
       
-      unsigned int hashGenome(const InstructionSequence& genome) const;
+      unsigned long long hashGenome(const InstructionSequence& genome) const;
+      GenotypePtr findActive(UnitPtr u, unsigned long long hash);
+      void insertActive(GenotypePtr genotype, unsigned long long hash);
+      void removeActive(GenotypePtr genotype, unsigned long long hash);
+      void growActiveHash();
       Apto::String nameGenotype(int size);
       
       void removeGenotype(GenotypePtr genotype);
       void updateCoalescent();
       
+      void adjustStats(GenotypePtr genotype, int old_size, int new_size);
+      void addThreshold(GenotypePtr genotype);
+      void removeThreshold(GenotypePtr genotype);
+      inline void queueRemoval(GenotypePtr genotype) { m_pending_removal.Push(genotype); }
+      void scanProvidedValues(Update current_update);
+      
       inline void resizeActiveList(int size);
       inline GenotypePtr getBest();
       
@@ -196,6 +265,55 @@ namespace Avida {
       return (m_best) ? m_active_sz[m_best].GetFirst() : GenotypePtr(NULL);
     }
 
+    
+    inline void GenotypeArbiter::StatSum::Add(long long v, long long w)
+    {
+      const unsigned long long uv = v, uw = w;
+      n += uw;
+      s1 += uv * uw;
+      s2 += uv * uw * uv * uw;
+      w2 += uw * uw;
+      w2v += uw * uw * uv;
+      s2_approx += ((double)v * (double)w) * ((double)v * (double)w);
+    }
+    
+    inline void GenotypeArbiter::StatSum::Subtract(long long v, long long w)
+    {
+      const unsigned long long uv = v, uw = w;
+      n -= uw;
+      s1 -= uv * uw;
+      s2 -= uv * uw * uv * uw;
+      w2 -= uw * uw;
+      w2v -= uw * uw * uv;
+      s2_approx -= ((double)v * (double)w) * ((double)v * (double)w);
+    }
+    
+    inline void GenotypeArbiter::StatSum::Shift(long long d)
+    {
+      // Add d to every value: Sum (w^2 (v + d)^2) = s2 + 2d * w2v + d^2 * w2
+      const unsigned long long ud = d;
+      s2_approx += 2.0 * (double)d * (double)(long long)w2v + (double)d * (double)d * (double)(long long)w2;
+      s2 += 2 * ud * w2v + ud * ud * w2;
+      w2v += ud * w2;
+      s1 += ud * n;
+    }
+    
+    inline double GenotypeArbiter::StatSum::Average() const
+    {
+      return (N() > 0.0) ? ((double)(long long)s1 / N()) : 0.0;
+    }
+    
+    inline double GenotypeArbiter::StatSum::Variance() const
+    {
+      const double ds1 = (double)(long long)s1;
+      return (N() > 1.0) ? ((double)(long long)s2 - ds1 * ds1 / N()) / (N() - 1.0) : 0.0;
+    }
+    
+    inline double GenotypeArbiter::StatSum::StdError() const
+    {
+      return (N() > 1) ? sqrt(Variance() / N()) : 0.0;
+    }
+
   };
 };
 
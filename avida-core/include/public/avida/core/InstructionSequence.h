@@ -135,7 +135,7 @@ namespace Avida {
     static int FindHammingDistance(const InstructionSequence& seq1, const InstructionSequence& seq2, int offset = 0);
     static int FindBestOffset(const InstructionSequence& seq1, const InstructionSequence& seq2);
     static int FindSlidingDistance(const InstructionSequence& seq1, const InstructionSequence& seq2);
-    static int FindEditDistance(const InstructionSequence& seq1, const InstructionSequence& seq2);
+    static int FindEditDistance(const InstructionSequence& seq1, const InstructionSequence& seq2, int max_dist = -1);
     
     
   protected:
@@ -144,6 +144,41 @@ namespace Avida {
   };
 
 
+  // EditDistancePattern - a sequence prepared for edit distance calculations against many others
+  // --------------------------------------------------------------------------------------------------------------
+  //
+  // Keeps a bit mask of the positions of each instruction in the sequence, so that edit distances can be found 64 rows
+  // of the dynamic programming matrix at a time with the bit-vector algorithm of Myers (1999), in the blocked form given
+  // by Hyyrö (2003).  Building the masks costs about as much as one distance, so prepare a pattern once when comparing
+  // a sequence against many others.
+  
+  class EditDistancePattern
+  {
+  private:
+    int m_size;
+    int m_words;
+    int m_slot[256];                          // Row of m_masks for each instruction, 0 (no bits) if it does not occur
+    Apto::Array<unsigned long long> m_masks;  // m_words masks per row
+
+    static const int LOCAL_WORDS = 16;        // Patterns up to 64 * LOCAL_WORDS long need no scratch allocation
+    
+  public:
+    LIB_EXPORT inline EditDistancePattern() : m_size(0), m_words(0) { ; }
+    LIB_EXPORT inline explicit EditDistancePattern(const InstructionSequence& seq) { Set(seq, 0, seq.GetSize()); }
+    
+    LIB_EXPORT void Set(const InstructionSequence& seq, int begin, int end);
+    LIB_EXPORT inline int GetSize() const { return m_size; }
+    
+    // Edit distance from the pattern to the sites [begin, end) of seq.  With max_dist >= 0, gives up as soon as the
+    // distance is known to exceed max_dist, returning max_dist + 1.
+    LIB_EXPORT int Distance(const InstructionSequence& seq, int begin, int end, int max_dist = -1) const;
+    LIB_EXPORT inline int Distance(const InstructionSequence& seq, int max_dist = -1) const
+    {
+      return Distance(seq, 0, seq.GetSize(), max_dist);
+    }
+  };
+  
+
   // InstructionSequence Helper Methods
   // --------------------------------------------------------------------------------------------------------------
   
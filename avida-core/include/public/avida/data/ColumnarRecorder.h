@@ -0,0 +1,156 @@
+/*
+ *  data/ColumnarRecorder.h
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaDataColumnarRecorder_h
+#define AvidaDataColumnarRecorder_h
+
+#include "apto/core/Array.h"
+#include "avida/core/Types.h"
+#include "avida/data/Recorder.h"
+
+class cChunkBuffer;
+class cChunkedFileReader;
+class cChunkedFileWriter;
+
+
+namespace Avida {
+  namespace Data {
+
+    // Binary time series files (.tsr) are chunked files (see cChunkedFile).  The first chunk is the header: the recording
+    // interval followed by the data id and value type of each column.  Every following chunk holds a block of consecutive
+    // rows stored by column -- the updates first, then the values of each column in turn, each prefixed by its size in
+    // bytes so that readers can skip columns.  Blocks are flushed as they are written, so that a file can be read while
+    // the run is still adding to it.
+
+    enum ColumnType {
+      COLUMN_INT = 1,
+      COLUMN_DOUBLE = 2,
+      COLUMN_BOOL = 3,
+      COLUMN_STRING = 4
+    };
+
+
+    // Data::ColumnarRecorder - Records data values to a binary time series file
+    // --------------------------------------------------------------------------------------------------------------
+
+    class ColumnarRecorder : public Recorder
+    {
+    public:
+      static const char MAGIC[8];
+      static const unsigned int VERSION = 1;
+
+    private:
+      Apto::String m_path;
+      int m_interval;
+      int m_block_rows;
+
+      DataSetPtr m_requested;
+      Apto::Array<DataID> m_ids;
+      Apto::Array<ColumnType> m_types;
+
+      cChunkedFileWriter* m_file;
+      cChunkBuffer* m_updates;
+      Apto::Array<cChunkBuffer*> m_columns;   // Values of the rows in the current block, one buffer per column
+      int m_rows;
+      Update m_last_update;
+      bool m_failed;
+
+      ColumnarRecorder(const ColumnarRecorder&); // @not_implemented
+      ColumnarRecorder& operator=(const ColumnarRecorder&); // @not_implemented
+
+    public:
+      LIB_EXPORT ColumnarRecorder(const Apto::String& path, int interval = 1, int block_rows = 256);
+      LIB_EXPORT ~ColumnarRecorder();
+
+      // All columns must be added before the file is opened
+      LIB_EXPORT bool AddColumn(const DataID& data_id, ColumnType type);
+      LIB_EXPORT bool Open();
+
+      LIB_EXPORT bool Flush();  // Writes out the rows recorded so far as a block
+      LIB_EXPORT bool Close();
+      LIB_EXPORT inline bool Failed() const { return m_failed; }
+
+      // Data::Recorder Interface
+      LIB_EXPORT inline ConstDataSetPtr RequestedData() const { return m_requested; }
+      LIB_EXPORT void NotifyData(Update current_update, DataRetrievalFunctor retrieve_data);
+    };
+
+
+    // Data::ColumnarReader - Reads a binary time series file a row at a time, including one that is still being written
+    // --------------------------------------------------------------------------------------------------------------
+
+    class ColumnarReader
+    {
+    private:
+      cChunkedFileReader* m_file;
+      cChunkBuffer* m_chunk;
+      bool m_fail;
+
+      int m_interval;
+      Apto::Array<DataID> m_ids;
+      Apto::Array<ColumnType> m_types;
+
+      // The current block, decoded by column
+      struct BlockColumn
+      {
+        Apto::Array<long long> ints;   // Ints and bools
+        Apto::Array<double> doubles;
+        Apto::Array<Apto::String> strings;
+      };
+      Apto::Array<Update> m_updates;
+      Apto::Array<BlockColumn> m_block;
+      int m_row;
+
+      bool readBlock();
+
+      ColumnarReader(const ColumnarReader&); // @not_implemented
+      ColumnarReader& operator=(const ColumnarReader&); // @not_implemented
+
+    public:
+      LIB_EXPORT ColumnarReader();
+      LIB_EXPORT ~ColumnarReader();
+
+      LIB_EXPORT bool Open(const Apto::String& path);
+
+      LIB_EXPORT inline int Interval() const { return m_interval; }
+      LIB_EXPORT inline int NumColumns() const { return m_ids.GetSize(); }
+      LIB_EXPORT inline const DataID& ColumnID(int col) const { return m_ids[col]; }
+      LIB_EXPORT inline ColumnType GetColumnType(int col) const { return m_types[col]; }
+
+      // Advances to the next row.  Returns false when there are no more rows for now: either the file is complete
+      // (Done), it is damaged (Fail), or the run has not yet written more, in which case NextRow can be tried again.
+      LIB_EXPORT bool NextRow();
+      LIB_EXPORT bool Done() const;
+      LIB_EXPORT inline bool Fail() const { return m_fail; }
+
+      LIB_EXPORT inline Update RowUpdate() const { return m_updates[m_row]; }
+      LIB_EXPORT double DoubleValue(int col) const;
+      LIB_EXPORT long long IntValue(int col) const;
+      LIB_EXPORT Apto::String StringValue(int col) const;  // Formatted as in text data files
+
+      // Writes the rows of a time series file as a text data file, with a numbered column description header
+      LIB_EXPORT static bool ExportText(const Apto::String& in_path, const Apto::String& out_path, Feedback& feedback);
+    };
+
+  };
+};
+
+#endif
@@ -28,17 +28,22 @@
 #include "avida/output/Socket.h"
 
 #include <fstream>
+#include <ostream>
 #include <sstream>
 
 
 namespace Avida {
   namespace Output {
     
-    // Output::Socket - Protocol defining interface for output sockets that can be managed by the output manager
+    // Output::File - Text data file.  Output is collected in blocks that are written out by a shared background
+    // writer thread, unless the output manager's buffer limit is zero, in which case they are written directly.
     // --------------------------------------------------------------------------------------------------------------
     
     class File : public Socket
     {
+    public:
+      class Buffer;
+      
     private:
       Apto::String m_descr;
       Apto::String m_filetype;
@@ -48,7 +53,8 @@ namespace Avida {
       
       int m_num_cols;
       
-      std::ofstream m_fp;
+      Buffer* m_buf;
+      std::ostream m_fp;
 
       
     public:
@@ -70,14 +76,14 @@ namespace Avida {
       LIB_EXPORT inline const OutputID& Name() const { return m_output_id; }
       LIB_EXPORT inline const Apto::String& GetFileType() const { return m_filetype; }
       
-      LIB_EXPORT inline bool Fail() const { return m_fp.fail(); }
-      LIB_EXPORT inline bool Good() const { return m_fp.good(); }
+      LIB_EXPORT bool Fail() const;
+      LIB_EXPORT bool Good() const;
       LIB_EXPORT inline bool HeaderDone() { return m_descr_written; }
       
       LIB_EXPORT inline bool SetFileType(const Apto::String& ft);
 
       
-      LIB_EXPORT inline std::ofstream& OFStream() { return m_fp; }
+      LIB_EXPORT inline std::ostream& OFStream() { return m_fp; }
       
       
       // The following methods output a value into the data file.
@@ -118,7 +124,11 @@ namespace Avida {
       LIB_EXPORT void Endl(); // Write all data to disk and start a new line.
       
       
-      LIB_EXPORT void Flush();
+      LIB_EXPORT void Flush(); // Writes out all data so far and waits until it has reached the file
+      LIB_EXPORT void Submit();
+      
+      // Waits until all output handed to the background writer, including that of closed files, has been written
+      LIB_EXPORT static void WaitForPendingWrites();
       
       
     private:
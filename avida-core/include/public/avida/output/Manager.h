@@ -34,6 +34,10 @@ namespace Avida {
   namespace Output {
     
     // Output::Manager - Manages output sockets (files, etc.) and their identifiers
+    //
+    // Files are written by a background writer thread, which holds at most BufferLimit() bytes of their output at a
+    // time; the simulation waits for the writer when it gets that far ahead.  Buffered output is passed on to the
+    // writer at the end of each update.  A buffer limit of zero writes files directly from the simulation thread.
     // --------------------------------------------------------------------------------------------------------------
     
     class Manager : public WorldFacet
@@ -43,23 +47,28 @@ namespace Avida {
       World* m_world;
       
       Apto::String m_output_path;
+      int m_buffer_limit;
       
       mutable Apto::Mutex m_mutex;
       Apto::Map<OutputID, SocketWeakRef> m_sockets;
       Apto::Map<OutputID, SocketPtr> m_static_sockets;
       
     public:
-      LIB_EXPORT Manager(const Apto::String& output_path);
+      static const int DEFAULT_BUFFER_LIMIT = 16 * 1024 * 1024;
+      
+    public:
+      LIB_EXPORT Manager(const Apto::String& output_path, int buffer_limit = DEFAULT_BUFFER_LIMIT);
       LIB_EXPORT ~Manager();
       
       LIB_EXPORT inline const Apto::String& OutputPath() const { return m_output_path; }
+      LIB_EXPORT inline int BufferLimit() const { return m_buffer_limit; }
       
       LIB_EXPORT OutputID OutputIDFromPath(Apto::String path) const;
 
       LIB_EXPORT bool IsOpen(const OutputID& output_id) const;
       LIB_EXPORT bool Close(const OutputID& output_id);
       
-      LIB_EXPORT void FlushAll();
+      LIB_EXPORT void FlushAll(); // Writes out all open sockets and waits for any closed files still being written
       
       LIB_EXPORT bool AttachTo(World* world);
       LIB_EXPORT static ManagerPtr Of(World* world);
@@ -70,6 +79,7 @@ namespace Avida {
     public:
       LIB_LOCAL WorldFacetID UpdateBefore() const;
       LIB_LOCAL WorldFacetID UpdateAfter() const;
+      LIB_LOCAL void PerformUpdate(Avida::Context& ctx, Update current_update);
       
     private:
       LIB_EXPORT bool RegisterSocket(const OutputID& output_id, SocketWeakRef socket_ref);
@@ -49,6 +49,7 @@ namespace Avida {
       LIB_EXPORT virtual ~Socket() = 0;
       
       LIB_EXPORT virtual void Flush() = 0;
+      LIB_EXPORT virtual void Submit() { ; } // Passes any buffered output on to be written, without waiting for it
       
     protected:
       LIB_EXPORT bool registerAsStatic();
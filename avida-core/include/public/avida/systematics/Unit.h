@@ -86,6 +86,10 @@ namespace Avida {
       
       LIB_EXPORT void HandleGestation();
       
+    protected:
+      // Leaves every group, as destruction would, so that the storage of a dead unit can be reused for a new one
+      LIB_EXPORT void ResetClassification();
+      
     private:
       LIB_LOCAL inline UnitPtr thisPtr();
     };
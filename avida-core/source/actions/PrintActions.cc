@@ -24,16 +24,19 @@
 #include "avida/core/Feedback.h"
 #include "avida/core/InstructionSequence.h"
 #include "avida/core/WorldDriver.h"
+#include "avida/data/ColumnarRecorder.h"
 #include "avida/data/Manager.h"
 #include "avida/data/Package.h"
 #include "avida/data/Recorder.h"
 #include "avida/output/File.h"
+#include "avida/output/Manager.h"
 #include "avida/systematics/Arbiter.h"
 #include "avida/systematics/Group.h"
 #include "avida/systematics/Manager.h"
 
 #include "avida/private/util/GenomeLoader.h"
 
+#include "apto/core/FileSystem.h"
 #include "apto/rng.h"
 
 #include "cAction.h"
@@ -109,6 +112,8 @@ STATS_OUT_FILE(PrintReactionRewardData,     reaction_reward.dat );
 STATS_OUT_FILE(PrintCurrentReactionRewardData,     cur_reaction_reward.dat );
 STATS_OUT_FILE(PrintTimeData,               time.dat            );
 STATS_OUT_FILE(PrintExtendedTimeData,       xtime.dat           );
+STATS_OUT_FILE(PrintPhenotypeCacheData,     phenotype_cache.dat );
+STATS_OUT_FILE(PrintObjectPoolData,         object_pool.dat     );
 STATS_OUT_FILE(PrintMutationRateData,       mutation_rates.dat  );
 STATS_OUT_FILE(PrintDivideMutData,          divide_mut.dat      );
 STATS_OUT_FILE(PrintParasiteData,           parasite.dat        );
@@ -482,6 +487,112 @@ public:
 };
 
 
+/*
+ Records data values to a binary time series file (see Data::ColumnarRecorder), one row every <interval> updates.  The
+ recording starts when the event first fires; each later firing writes out the rows recorded so far.  Columns name a
+ data id, optionally followed by its type -- int, double (the default), bool or string -- as in core.update:int.  Use
+ ExportTimeSeries to convert the file to a text data file.
+ 
+ Parameters:
+   filename (string)
+     Name of the time series file.
+   interval (int)
+     Updates between recorded rows.
+   columns (string) ...
+     Data ids of the recorded values.
+ */
+class cActionRecordTimeSeries : public cAction
+{
+private:
+  cString m_filename;
+  int m_interval;
+  Apto::Array<Data::DataID> m_ids;
+  Apto::Array<Data::ColumnType> m_types;
+  Apto::SmartPtr<Data::ColumnarRecorder, Apto::InternalRCObject> m_recorder;
+  
+public:
+  cActionRecordTimeSeries(cWorld* world, const cString& args, Feedback& feedback)
+    : cAction(world, args), m_filename("series.tsr"), m_interval(1)
+  {
+    cString largs(args);
+    if (largs.GetSize()) m_filename = largs.PopWord();
+    if (largs.GetSize()) m_interval = largs.PopWord().AsInt();
+    while (largs.GetSize()) {
+      cString column = largs.PopWord();
+      cString data_id = column.Pop(':');
+      Data::ColumnType type = Data::COLUMN_DOUBLE;
+      if (column == "int") type = Data::COLUMN_INT;
+      else if (column == "bool") type = Data::COLUMN_BOOL;
+      else if (column == "string") type = Data::COLUMN_STRING;
+      else if (column.GetSize() && column != "double") feedback.Error("RecordTimeSeries: unknown column type '%s'", (const char*)column);
+      m_ids.Push((const char*)data_id);
+      m_types.Push(type);
+    }
+    if (!m_ids.GetSize()) feedback.Error("RecordTimeSeries: no data ids given");
+  }
+  
+  static const cString GetDescription() { return "Arguments: <string fname> <int interval> <string data_id[:type]> [...]"; }
+  
+  void Process(cAvidaContext& ctx)
+  {
+    if (m_recorder) {
+      m_recorder->Flush();
+      return;
+    }
+    
+    Apto::String path = Avida::Output::Manager::Of(m_world->GetNewWorld())->OutputIDFromPath((const char*)m_filename);
+    m_recorder = Apto::SmartPtr<Data::ColumnarRecorder, Apto::InternalRCObject>(new Data::ColumnarRecorder(path, m_interval));
+    for (int i = 0; i < m_ids.GetSize(); i++) m_recorder->AddColumn(m_ids[i], m_types[i]);
+    
+    if (!path.GetSize() || !m_recorder->Open()) {
+      ctx.Driver().Feedback().Error("RecordTimeSeries: unable to open '%s' for writing", (const char*)m_filename);
+      return;
+    }
+    if (!m_world->GetDataManager()->AttachRecorder(m_recorder)) {
+      ctx.Driver().Feedback().Error("RecordTimeSeries: unavailable data requested for '%s'", (const char*)m_filename);
+    }
+  }
+};
+
+
+/*
+ Converts a binary time series file written by RecordTimeSeries to a text data file.  A file that is still being
+ recorded is exported up to its last complete block.
+ 
+ Parameters:
+   input (string)
+     The time series file, relative to the working directory.
+   output (string)
+     Name of the text data file.
+ */
+class cActionExportTimeSeries : public cAction
+{
+private:
+  cString m_input;
+  cString m_output;
+  
+public:
+  cActionExportTimeSeries(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_input(""), m_output("")
+  {
+    cString largs(args);
+    if (largs.GetSize()) m_input = largs.PopWord();
+    if (largs.GetSize()) m_output = largs.PopWord();
+  }
+  
+  static const cString GetDescription() { return "Arguments: <cString input> <cString output>"; }
+  
+  void Process(cAvidaContext& ctx)
+  {
+    Feedback& feedback = ctx.Driver().Feedback();
+    Apto::String input = Apto::FileSystem::GetAbsolutePath(Apto::String(m_input), Apto::String(m_world->GetWorkingDir()));
+    Apto::String output = Avida::Output::Manager::Of(m_world->GetNewWorld())->OutputIDFromPath((const char*)m_output);
+    
+    if (!output.GetSize()) feedback.Error("unable to translate path '%s' to output id", (const char*)m_output);
+    else Data::ColumnarReader::ExportText(input, output, feedback);
+  }
+};
+
+
 class cActionPrintPreyInstructionData : public cAction
 {
 private:
@@ -1523,8 +1634,8 @@ public:
     }
     
     Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    if (!fp.is_open()) {
+    ostream& fp = df->OFStream();
+    if (!df->Good()) {
       ctx.Driver().Feedback().Error("PrintCCladeCount: Unable to open output file.");
       ctx.Driver().Abort(Avida::IO_ERROR);
     }
@@ -2005,8 +2116,8 @@ public:
     
     //Create and print the histograms; this calls a static method in another action
     Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)m_filename);
-    ofstream& fp = df->OFStream();
-    if (!fp.is_open()) {
+    ostream& fp = df->OFStream();
+    if (!df->Good()) {
       ctx.Driver().Feedback().Error("PrintCCladeFitnessHistogram: Unable to open output file.");
       ctx.Driver().Abort(Avida::IO_ERROR);
     }
@@ -2134,8 +2245,8 @@ public:
     
     //Create and print the histograms; this calls a static method in another action
     Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)m_filename);
-    ofstream& fp = df->OFStream();
-    if (!fp.is_open()) {
+    ostream& fp = df->OFStream();
+    if (!df->Good()) {
       ctx.Driver().Feedback().Error("PrintCCladeRelativeFitnessHistogram: Unable to open output file.");
       ctx.Driver().Abort(Avida::IO_ERROR);      
     }
@@ -2307,7 +2418,7 @@ private:
   int     m_num_trials;
   
 private:
-  void PrintHeader(ofstream& fot)
+  void PrintHeader(ostream& fot)
   {
     fot << "# Phenotypic Plasticity" << endl
     << "# Format: " << endl
@@ -2325,7 +2436,7 @@ private:
     fot << endl;
   }
   
-  void PrintPPG(ofstream& fot, Apto::SmartPtr<cPhenPlastGenotype> ppgen, int id, const cString& pid)
+  void PrintPPG(ostream& fot, Apto::SmartPtr<cPhenPlastGenotype> ppgen, int id, const cString& pid)
   {
     
     for (int k = 0; k < ppgen->GetNumPhenotypes(); k++){
@@ -2366,7 +2477,7 @@ public:
     if (ctx.GetAnalyzeMode()){ // Analyze mode
       cString this_path = m_filename;
       Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)this_path);
-      ofstream& fot = df->OFStream();
+      ostream& fot = df->OFStream();
       PrintHeader(fot);
       tListIterator<cAnalyzeGenotype> batch_it(m_world->GetAnalyze().GetCurrentBatch().List());
       cAnalyzeGenotype* genotype = NULL;
@@ -2377,7 +2488,7 @@ public:
     } else{  // Run mode
       cString this_path = m_filename + "-" + cStringUtil::Convert(m_world->GetStats().GetUpdate()) + ".dat";
       Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)m_filename);
-      ofstream& fot = df->OFStream();
+      ostream& fot = df->OFStream();
       PrintHeader(fot);
       
       Systematics::ManagerPtr classmgr = Systematics::Manager::Of(m_world->GetNewWorld());
@@ -2412,7 +2523,7 @@ private:
   bool    m_first_run; //Is this the first time the process is run?
   bool    m_weighted;  //Weight by num_cpu?
   
-  void PrintHeader(ofstream& fot){
+  void PrintHeader(ostream& fot){
     fot << "# Task Probability Histogram" << endl
     << "#format update task_id [0] (0,0.5] (0.5,0.10] ... (0.90,0.95], (0.95, 1.0], [1.0]" << endl << endl;
     return;
@@ -2442,7 +2553,7 @@ public:
     if (ctx.GetAnalyzeMode()) df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)m_filename);
     else df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)m_filename);
 
-    ofstream& fot = df->OFStream();  //Setup output file
+    ostream& fot = df->OFStream();  //Setup output file
     if (m_first_run == true){
       PrintHeader(fot);
       m_first_run = false;
@@ -2504,7 +2615,7 @@ private:
   cString m_filename;
   bool    m_first_run;
   
-  void PrintHeader(ofstream& fot)
+  void PrintHeader(ostream& fot)
   {
     fot << "# Plastic Genotype Sumary" << endl
     <<  "#format  update num_genotypes num_plastic_genotypes num_gen_taskplast num_orgs num_plastic_orgs num_org_taskplast median_phenplast_entropy median_taskplast_entropy" << endl
@@ -2543,7 +2654,7 @@ public:
     Avida::Output::FilePtr df;
     if (ctx.GetAnalyzeMode()) df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)m_filename);
     else df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)m_filename);
-    ofstream& fot = df->OFStream();
+    ostream& fot = df->OFStream();
     if (m_first_run == true){
       PrintHeader(fot);
       m_first_run = false;
@@ -3287,7 +3398,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_energy.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     for (int i = 0; i < m_world->GetPopulation().GetWorldY(); i++) {
       for (int j = 0; j < m_world->GetPopulation().GetWorldX(); j++) {
@@ -3317,7 +3428,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_exe_ratio.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     for (int i = 0; i < m_world->GetPopulation().GetWorldY(); i++) {
       for (int j = 0; j < m_world->GetPopulation().GetWorldX(); j++) {
@@ -3347,7 +3458,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_cell_data.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     for (int i = 0; i < m_world->GetPopulation().GetWorldY(); i++) {
       for (int j = 0; j < m_world->GetPopulation().GetWorldX(); j++) {
@@ -3377,7 +3488,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_fitness-%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
       for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
@@ -3411,7 +3522,7 @@ public:
     if (filename == "") filename = "grid_class_id";
     filename.Set("%s-%d.dat", (const char*)filename, m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
       for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
@@ -3471,7 +3582,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_genotype_color-%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
       for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
@@ -3531,7 +3642,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_phenotype_id.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
       for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
@@ -3561,7 +3672,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("id_grid.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
       for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
@@ -3591,7 +3702,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_dumps/vitality_grid.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
       for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
@@ -3624,7 +3735,7 @@ public:
     if (m_world->GetConfig().USE_AVATARS.Get()) {
       if (filename == "") filename.Set("grid_dumps/avatar_grid.%d.dat", m_world->GetStats().GetUpdate());
       Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-      ofstream& fp = df->OFStream();
+      ostream& fp = df->OFStream();
       
       for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
         for (int i = 0; i < worldx; i++) {
@@ -3643,7 +3754,7 @@ public:
     else {
       if (filename == "") filename.Set("grid_dumps/target_grid.%d.dat", m_world->GetStats().GetUpdate());
       Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-      ofstream& fp = df->OFStream();
+      ostream& fp = df->OFStream();
       
       for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
         for (int i = 0; i < worldx; i++) {
@@ -3676,7 +3787,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_dumps/max_res_grid.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
       for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
@@ -3725,7 +3836,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_sleep.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     for (int i = 0; i < m_world->GetPopulation().GetWorldY(); i++) {
       for (int j = 0; j < m_world->GetPopulation().GetWorldX(); j++) {
@@ -3756,7 +3867,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_genome_length.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     cPopulation* pop = &m_world->GetPopulation();
     
@@ -3797,7 +3908,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_task.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     cPopulation* pop = &m_world->GetPopulation();
     cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
@@ -3847,7 +3958,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_last_task.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     cPopulation* pop = &m_world->GetPopulation();
     int task_id;      
@@ -3888,7 +3999,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_task_hosts.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     cPopulation* pop = &m_world->GetPopulation();
     
@@ -3934,7 +4045,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_task_parasite.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     cPopulation* pop = &m_world->GetPopulation();
     
@@ -3984,7 +4095,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_task_hosts_comma.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     cPopulation* pop = &m_world->GetPopulation();
   
     const int num_tasks = m_world->GetEnvironment().GetNumTasks();
@@ -4031,7 +4142,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_task_parasites_comma.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     cPopulation* pop = &m_world->GetPopulation();
     
     const int num_tasks = m_world->GetEnvironment().GetNumTasks();
@@ -4081,7 +4192,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_virulence.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     cPopulation* pop = &m_world->GetPopulation();
     
@@ -4125,7 +4236,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("counts_offspring_migration.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     int num_demes = (&m_world->GetPopulation())->GetNumDemes();
     cMigrationMatrix* mig_mat = &m_world->GetMigrationMatrix();
@@ -4160,7 +4271,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("counts_parasite_migration.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     int num_demes = (&m_world->GetPopulation())->GetNumDemes();
     cMigrationMatrix* mig_mat = &m_world->GetMigrationMatrix();
@@ -4197,7 +4308,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_reactions.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     cPopulation* pop = &m_world->GetPopulation();
     
@@ -4240,7 +4351,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_genome.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     cPopulation* pop = &m_world->GetPopulation();
     
@@ -4280,7 +4391,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("host_genome_list.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     cPopulation* pop = &m_world->GetPopulation();
     
@@ -4319,7 +4430,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("parasite_genome_list.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     cPopulation* pop = &m_world->GetPopulation();
     
@@ -4363,7 +4474,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_genome_parasite.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     cPopulation* pop = &m_world->GetPopulation();
     
@@ -4408,7 +4519,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_donor.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
       for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
@@ -4438,7 +4549,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_receiver.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
       for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
@@ -4469,7 +4580,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("divides.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     fp << "# org_id,age,num_divides" << endl;
     
@@ -4504,7 +4615,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_dumps/org_loc.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     bool use_av = m_world->GetConfig().USE_AVATARS.Get();
     if (!use_av) fp << "# org_id,org_cellx,org_celly,org_forage_target,org_group_id,org_facing" << endl;
@@ -4556,7 +4667,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_dumps/prey_flocking.%d.dat", m_world->GetStats().GetUpdate());    
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     bool use_av = m_world->GetConfig().USE_AVATARS.Get();
     if (!use_av) fp << "# org_id,org_cellx,org_celly,num_prey_neighbors,num_prey_this_cell" << endl;
@@ -4620,7 +4731,7 @@ public:
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_dumps/org_loc_guard.%d.dat", m_world->GetStats().GetUpdate());
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     bool use_av = m_world->GetConfig().USE_AVATARS.Get();
     if (!use_av) fp << "# org_id,org_cellx,org_celly,org_forage_target,org_group_id,org_facing,is_guard,num_guard_inst,on_den,r_bins_total,time_used,num_deposits,amount_deposited_total" << endl;
@@ -5297,6 +5408,8 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   action_lib->Register<cActionPrintCurrentReactionRewardData>("PrintCurrentReactionRewardData");
   action_lib->Register<cActionPrintTimeData>("PrintTimeData");
   action_lib->Register<cActionPrintExtendedTimeData>("PrintExtendedTimeData");
+  action_lib->Register<cActionPrintPhenotypeCacheData>("PrintPhenotypeCacheData");
+  action_lib->Register<cActionPrintObjectPoolData>("PrintObjectPoolData");
   action_lib->Register<cActionPrintMutationRateData>("PrintMutationRateData");
   action_lib->Register<cActionPrintDivideMutData>("PrintDivideMutData");
   action_lib->Register<cActionPrintParasiteData>("PrintParasiteData");
@@ -5323,6 +5436,9 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   
   action_lib->Register<cActionPrintFromMessageInstructionData>("PrintFromMessageInstructionData");
   
+  action_lib->Register<cActionRecordTimeSeries>("RecordTimeSeries");
+  action_lib->Register<cActionExportTimeSeries>("ExportTimeSeries");
+  
   action_lib->Register<cActionPrintMaleInstructionData>("PrintMaleInstructionData");
   action_lib->Register<cActionPrintFemaleInstructionData>("PrintFemaleInstructionData");
   action_lib->Register<cActionPrintSenseData>("PrintSenseData");
@@ -21,11 +21,16 @@
 
 #include "SaveLoadActions.h"
 
+#include "avida/output/Manager.h"
+
+#include "apto/core/FileSystem.h"
+
 #include "cAction.h"
 #include "cActionLibrary.h"
 #include "cArgContainer.h"
 #include "cArgSchema.h"
 #include "cPopulation.h"
+#include "cPopulationCheckpoint.h"
 #include "cStats.h"
 #include "cStringUtil.h"
 #include "cWorld.h"
@@ -57,9 +62,10 @@ private:
   bool m_load_rebirth;
   bool m_load_parent_dat;
   int m_load_traceq;
+  bool m_use_mmap;
   
 public:
-  cActionLoadPopulation(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename(""), m_update(-1), m_cellid_offset(0), m_lineage_offset(0), m_load_groups(0), m_load_birth_cells(0), m_load_avatars(0), m_load_rebirth(0), m_load_parent_dat(0), m_load_traceq(0)
+  cActionLoadPopulation(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename(""), m_update(-1), m_cellid_offset(0), m_lineage_offset(0), m_load_groups(0), m_load_birth_cells(0), m_load_avatars(0), m_load_rebirth(0), m_load_parent_dat(0), m_load_traceq(0), m_use_mmap(0)
   {
     cString largs(args);
     if (largs.GetSize()) m_filename = largs.PopWord();
@@ -72,16 +78,17 @@ public:
     if (largs.GetSize()) m_load_rebirth = largs.PopWord().AsInt();
     if (largs.GetSize()) m_load_parent_dat = largs.PopWord().AsInt();
     if (largs.GetSize()) m_load_traceq = largs.PopWord().AsInt();
+    if (largs.GetSize()) m_use_mmap = largs.PopWord().AsInt();
   }
   
-  static const cString GetDescription() { return "Arguments: <cString fname> [int update=-1] [int cellid_offset=0] [int lineage_offset=0] [bool load_groups=0] [bool load_birth_cells=0] [bool load_avatars] [bool load_rebirth] [bool load_parent_dat] [int load_traceq]"; }
+  static const cString GetDescription() { return "Arguments: <cString fname> [int update=-1] [int cellid_offset=0] [int lineage_offset=0] [bool load_groups=0] [bool load_birth_cells=0] [bool load_avatars] [bool load_rebirth] [bool load_parent_dat] [int load_traceq] [bool mmap=0]"; }
   
   void Process(cAvidaContext& ctx)
   {
     // set the update if requested
     if (m_update >= 0) m_world->GetStats().SetCurrentUpdate(m_update);
     
-    if (!m_world->GetPopulation().LoadPopulation(m_filename, ctx, m_cellid_offset, m_lineage_offset, m_load_groups, m_load_birth_cells, m_load_avatars, m_load_rebirth, m_load_parent_dat, m_load_traceq)) {
+    if (!m_world->GetPopulation().LoadPopulation(m_filename, ctx, m_cellid_offset, m_lineage_offset, m_load_groups, m_load_birth_cells, m_load_avatars, m_load_rebirth, m_load_parent_dat, m_load_traceq, m_use_mmap)) {
       m_world->GetDriver().Feedback().Error("failed to load population");
       m_world->GetDriver().Abort(Avida::INVALID_CONFIG);
     }
@@ -136,10 +143,12 @@ private:
   bool m_save_group_info;
   bool m_save_avatars;
   bool m_save_rebirth;
+  bool m_binary;
   
 public:
   cActionSavePopulation(cWorld* world, const cString& args, Feedback& feedback)
     : cAction(world, args), m_filename(""), m_save_historic(true), m_save_group_info(false), m_save_avatars(false), m_save_rebirth(false)
+    , m_binary(false)
   {
     cArgSchema schema(':','=');
     
@@ -151,6 +160,7 @@ public:
     schema.AddEntry("save_groups", 1, 0, 1, 0);
     schema.AddEntry("save_avatars", 2, 0, 1, 0);
     schema.AddEntry("save_rebirth", 3, 0, 1, 0);
+    schema.AddEntry("binary", 4, 0, 1, 0);
 
     cArgContainer* argc = cArgContainer::Load(args, schema, feedback);
     
@@ -160,18 +170,64 @@ public:
       m_save_group_info = argc->GetInt(1);
       m_save_avatars = argc->GetInt(2);
       m_save_rebirth = argc->GetInt(3);
+      m_binary = argc->GetInt(4);
     }
     
     delete argc;
   }
   
-  static const cString GetDescription() { return "Arguments: [string filename='detail'] [boolean save_historic=1] [boolean save_groups=0] [boolean save_avatars=0] [boolean save_rebirth=0]"; }
+  static const cString GetDescription() { return "Arguments: [string filename='detail'] [boolean save_historic=1] [boolean save_groups=0] [boolean save_avatars=0] [boolean save_rebirth=0] [boolean binary=0]"; }
   
   void Process(cAvidaContext&)
   {
     int update = m_world->GetStats().GetUpdate();
-    cString filename = cStringUtil::Stringf("%s-%d.spop", (const char*)m_filename, update);
-    m_world->GetPopulation().SavePopulation(filename, m_save_historic, m_save_group_info, m_save_avatars, m_save_rebirth);
+    cString filename = cStringUtil::Stringf(m_binary ? "%s-%d.bpop" : "%s-%d.spop", (const char*)m_filename, update);
+    m_world->GetPopulation().SavePopulation(filename, m_save_historic, m_save_group_info, m_save_avatars, m_save_rebirth, m_binary);
+  }
+};
+
+
+/*
+ Converts a population save between the text (.spop) and binary (.bpop) formats.  The direction is taken from the
+ input file, which is read relative to the working directory; the output is written to the data directory.
+ 
+ Parameters:
+   input (string)
+     The population save to convert.
+   output (string)
+     The name of the converted file.
+ */
+class cActionConvertPopulation : public cAction
+{
+private:
+  cString m_input;
+  cString m_output;
+  
+public:
+  cActionConvertPopulation(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_input(""), m_output("")
+  {
+    cString largs(args);
+    if (largs.GetSize()) m_input = largs.PopWord();
+    if (largs.GetSize()) m_output = largs.PopWord();
+  }
+  
+  static const cString GetDescription() { return "Arguments: <cString input> <cString output>"; }
+  
+  void Process(cAvidaContext&)
+  {
+    Feedback& feedback = m_world->GetDriver().Feedback();
+    cString input(Apto::FileSystem::GetAbsolutePath(Apto::String(m_input), Apto::String(m_world->GetWorkingDir())));
+    cString output((const char*)Avida::Output::Manager::Of(m_world->GetNewWorld())->OutputIDFromPath((const char*)m_output));
+    
+    bool success = false;
+    if (!output.GetSize()) feedback.Error("unable to translate path '%s' to output id", (const char*)m_output);
+    else if (cPopulationCheckpoint::IsCheckpoint(input)) success = cPopulationCheckpoint::ConvertToText(input, output, feedback);
+    else success = cPopulationCheckpoint::ConvertFromText(input, output, feedback);
+    
+    if (!success) {
+      feedback.Error("failed to convert population");
+      m_world->GetDriver().Abort(Avida::INVALID_CONFIG);
+    }
   }
 };
 
@@ -281,13 +337,100 @@ public:
   }
 };
 
+
+/*
+ Saves a full snapshot of the simulation at the end of this update's events, from which LoadSnapshot restarts the run
+ exactly.  Two files are written to the data directory: <name>-<update>.bpop and <name>-<update>.snap.  Taking a
+ snapshot reseeds the random streams from themselves, so the saving run continues differently from one that takes no
+ snapshot (and identically to runs restored from the snapshot).  Snapshots require a batched SLICING_METHOD (6 or 7),
+ as the state of the other schedulers cannot be saved.  They are also refused while the run holds state they do not
+ carry: messaging, opinions and groups, HGT fragments, deme germlines, cell events and predicates, and offspring
+ waiting in the birth chamber.
+ 
+ Parameters:
+   name (string) [default: snapshot]
+     Prefix of the snapshot file names.
+   background (int) [default: 1]
+     Compress and write the files on a background thread, so that the run continues while they are written.  The
+     state itself is always captured before the run continues.
+ */
+class cActionSaveSnapshot : public cAction
+{
+private:
+  cString m_name;
+  bool m_background;
+  
+public:
+  cActionSaveSnapshot(cWorld* world, const cString& args, Feedback& feedback)
+    : cAction(world, args), m_name("snapshot"), m_background(true)
+  {
+    cArgSchema schema(':','=');
+    
+    // String Entries
+    schema.AddEntry("name", 0, "snapshot");
+    
+    // Integer Entries
+    schema.AddEntry("background", 0, 0, 1, 1);
+    
+    cArgContainer* argc = cArgContainer::Load(args, schema, feedback);
+    
+    if (argc) {
+      m_name = argc->GetString(0);
+      m_background = argc->GetInt(0);
+    }
+    
+    delete argc;
+  }
+  
+  static const cString GetDescription() { return "Arguments: [string name='snapshot'] [boolean background=1]"; }
+  
+  void Process(cAvidaContext&)
+  {
+    int update = m_world->GetStats().GetUpdate();
+    m_world->RequestSnapshot(cStringUtil::Stringf("%s-%d", (const char*)m_name, update), m_background);
+  }
+};
+
+
+/*
+ Replaces the whole simulation with a snapshot written by SaveSnapshot, once this update's events are done.  The
+ matching .bpop file must sit beside the .snap file.  The configuration must be the same as that of the saving run.
+ 
+ Parameters:
+   filename (string)
+     The .snap file to restore, relative to the working directory.
+ */
+class cActionLoadSnapshot : public cAction
+{
+private:
+  cString m_filename;
+  
+public:
+  cActionLoadSnapshot(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  {
+    cString largs(args);
+    if (largs.GetSize()) m_filename = largs.PopWord();
+  }
+  
+  static const cString GetDescription() { return "Arguments: <cString filename>"; }
+  
+  void Process(cAvidaContext&)
+  {
+    m_world->RequestRestore(m_filename);
+  }
+};
+
+
 void RegisterSaveLoadActions(cActionLibrary* action_lib)
 {
   action_lib->Register<cActionLoadParasiteGenotypeList>("LoadParasiteGenotypeList");
   action_lib->Register<cActionLoadHostGenotypeList>("LoadHostGenotypeList");
   action_lib->Register<cActionLoadPopulation>("LoadPopulation");
   action_lib->Register<cActionSavePopulation>("SavePopulation");
+  action_lib->Register<cActionConvertPopulation>("ConvertPopulation");
   action_lib->Register<cActionLoadStructuredSystematicsGroup>("LoadStructuredSystematicsGroup");
   action_lib->Register<cActionSaveStructuredSystematicsGroup>("SaveStructuredSystematicsGroup");
   action_lib->Register<cActionSaveFlameData>("SaveFlameData");
+  action_lib->Register<cActionSaveSnapshot>("SaveSnapshot");
+  action_lib->Register<cActionLoadSnapshot>("LoadSnapshot");
 }
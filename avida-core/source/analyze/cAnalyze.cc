@@ -39,10 +39,12 @@
 #include "cAnalyzeCommandAction.h"
 #include "cAnalyzeCommandDef.h"
 #include "cAnalyzeCommandDefBase.h"
+#include "cAnalyzeDistanceMatrix.h"
 #include "cAnalyzeFlowCommand.h"
 #include "cAnalyzeFlowCommandDef.h"
 #include "cAnalyzeFunction.h"
 #include "cAnalyzeGenotype.h"
+#include "cAnalyzeRecalcBatch.h"
 #include "cAnalyzeTreeStats_CumulativeStemminess.h"
 #include "cAnalyzeTreeStats_Gamma.h"
 #include "cAvidaContext.h"
@@ -1822,7 +1824,7 @@ void cAnalyze::CommandPrintTasks(cString cur_string)
   if (cur_string.GetSize() != 0) filename = cur_string.PopWord();
   
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   // Loop through all of the genotypes in this batch...
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
@@ -1844,7 +1846,7 @@ void cAnalyze::CommandPrintTasksQuality(cString cur_string)
   if (cur_string.GetSize() != 0) filename = cur_string.PopWord();
   
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   // Loop through all of the genotypes in this batch...
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
@@ -1885,7 +1887,7 @@ void cAnalyze::CommandDetail(cString cur_string)
     CommandDetail_Body(cout, file_type, output_it);
   } else {
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     CommandDetail_Header(fp, file_type, output_it);
     CommandDetail_Body(fp, file_type, output_it);
 	}
@@ -1931,7 +1933,7 @@ void cAnalyze::CommandDetailTimeline(cString cur_string)
     CommandDetail_Body(cout, file_type, output_it, time_step, max_time);
   } else {
     Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     CommandDetail_Header(fp, file_type, output_it, time_step);
     CommandDetail_Body(fp, file_type, output_it, time_step, max_time);
   }
@@ -2115,7 +2117,7 @@ void cAnalyze::CommandDetailAverage(cString cur_string)
   bool file_active = omgr->IsOpen(oid);
   
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), oid);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   // if it's a new file print out the header
   if (file_active == false) {
@@ -2153,7 +2155,7 @@ void cAnalyze::CommandDetailBatches(cString cur_string)
   if (file_extension == "html") file_type = FILE_TYPE_HTML;
   
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   cAnalyzeGenotype* first_genotype = batch[cur_batch].List().GetFirst();
   
   // Write out the header on the file
@@ -2248,7 +2250,7 @@ void cAnalyze::CommandDetailIndex(cString cur_string)
   
   // Setup the file...
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   cAnalyzeGenotype* first_genotype = batch[cur_batch].List().GetFirst();
   
   // Determine the file type...
@@ -2357,7 +2359,7 @@ void cAnalyze::CommandHistogram(cString cur_string)
     CommandHistogram_Body(cout, file_type, output_it);
   } else {
     Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     CommandHistogram_Header(fp, file_type, output_it);
     CommandHistogram_Body(fp, file_type, output_it);
   }
@@ -2596,7 +2598,7 @@ void cAnalyze::CommandPrintPhenotypes(cString cur_string)
   }
     
   Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   fp << "# 1: Number of organisms of this phenotype" << endl
     << "# 2: Number of genotypes of this phenotye" << endl
@@ -2772,7 +2774,7 @@ void cAnalyze::PhyloCommunityComplexity(cString cur_string)
   
   filename.Set("%s%s", static_cast<const char*>(directory), static_cast<const char*>(filename));
   Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& cpx_fp = df->OFStream();
+  ostream& cpx_fp = df->OFStream();
   
   cpx_fp << "# Legend:" << endl;
   cpx_fp << "# 1: Genotype ID" << endl;
@@ -3196,6 +3198,23 @@ void cAnalyze::PhyloCommunityComplexity(cString cur_string)
 }
 
 
+// Fills in the genotypes of a batch in batch order, along with their instruction sequences.
+static void getBatchSequences(tList<cAnalyzeGenotype>& list, Apto::Array<cAnalyzeGenotype*>& genotypes,
+                              Apto::Array<const InstructionSequence*>& seqs)
+{
+  genotypes.Resize(0);
+  seqs.Resize(0);
+  
+  tListIterator<cAnalyzeGenotype> batch_it(list);
+  cAnalyzeGenotype* genotype = NULL;
+  while ((genotype = batch_it.Next()) != NULL) {
+    ConstInstructionSequencePtr seq_p;
+    seq_p.DynamicCastFrom(genotype->GetGenome().Representation());
+    genotypes.Push(genotype);
+    seqs.Push(&(*seq_p));
+  }
+}
+
 // Calculate Edit Distance stats for all pairs of organisms across the population.
 void cAnalyze::CommandPrintDistances(cString cur_string)
 {
@@ -3211,7 +3230,7 @@ void cAnalyze::CommandPrintDistances(cString cur_string)
   }
   
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fout = df->OFStream();
+  ostream& fout = df->OFStream();
   
   fout << "# All pairs edit distance" << endl;
   fout << "# 1: Num organism pairs" << endl;
@@ -3222,55 +3241,61 @@ void cAnalyze::CommandPrintDistances(cString cur_string)
   fout << endl;
   
   // Loop through all pairs of organisms.
-  int dist_total = 0;
-  int dist_max = 0;
-  int pair_count = 0;
-  int threshold_pair_count = 0;
-	double count = 0;
-	
-  cAnalyzeGenotype * genotype1 = NULL;
-  cAnalyzeGenotype * genotype2 = NULL;
-  tListIterator<cAnalyzeGenotype> batch_it1(batch[cur_batch].List());
-
-  int watermark = 0;
-  
-  while ((genotype1 = batch_it1.Next()) != NULL) {
-		count ++;
-    const int gen1_count = genotype1->GetNumCPUs();
-
-    // Pair this genotype with itself for a distance of 0.
-    pair_count += gen1_count * (gen1_count - 1) / 2;
-
-    // Loop through the other genotypes this one can be paired with.
-    tListIterator<cAnalyzeGenotype> batch_it2(batch_it1);
-    while ((genotype2 = batch_it2.Next()) != NULL) {
-      const int gen2_count = genotype2->GetNumCPUs();
-      const int cur_pairs = gen1_count * gen2_count;
+  class cDistanceTotals : public cAnalyzeDistanceMatrix::cRowHandler
+  {
+  private:
+    const Apto::Array<cAnalyzeGenotype*>& m_genotypes;
+    const int m_dist_threshold;
+    
+  public:
+    int dist_total;
+    int dist_max;
+    int pair_count;
+    int threshold_pair_count;
+    int watermark;
+    
+    cDistanceTotals(const Apto::Array<cAnalyzeGenotype*>& genotypes, int dist_threshold)
+      : m_genotypes(genotypes), m_dist_threshold(dist_threshold)
+      , dist_total(0), dist_max(0), pair_count(0), threshold_pair_count(0), watermark(0) { ; }
+    
+    void HandleRow(int row, int first_col, const int* dists, int num_dists)
+    {
+      const int gen1_count = m_genotypes[row]->GetNumCPUs();
       
-      const Genome& genotype1_genome = genotype1->GetGenome();
-      ConstInstructionSequencePtr genotype1_seq_p;
-      ConstGeneticRepresentationPtr genotype1_rep_p = genotype1_genome.Representation();
-      genotype1_seq_p.DynamicCastFrom(genotype1_rep_p);
-      const InstructionSequence& genotype1_seq = *genotype1_seq_p;
+      // Pair this genotype with itself for a distance of 0.
+      pair_count += gen1_count * (gen1_count - 1) / 2;
       
-      const Genome& genotype2_genome = genotype2->GetGenome();
-      ConstInstructionSequencePtr genotype2_seq_p;
-      ConstGeneticRepresentationPtr genotype2_rep_p = genotype2_genome.Representation();
-      genotype2_seq_p.DynamicCastFrom(genotype2_rep_p);
-      const InstructionSequence& genotype2_seq = *genotype2_seq_p;
-
-      const int cur_dist = InstructionSequence::FindEditDistance(genotype1_seq, genotype2_seq);
-      dist_total += cur_pairs * cur_dist;
-      if (cur_dist > dist_max) dist_max = cur_dist;
-      pair_count += cur_pairs;
-      if (cur_dist >= dist_threshold) threshold_pair_count += cur_pairs;
-
-      if (pair_count > watermark) {
-	cout << watermark << endl;
-	watermark += 100000;
+      // Loop through the other genotypes this one can be paired with.
+      for (int i = 0; i < num_dists; i++) {
+        const int gen2_count = m_genotypes[first_col + i]->GetNumCPUs();
+        const int cur_pairs = gen1_count * gen2_count;
+        
+        const int cur_dist = dists[i];
+        dist_total += cur_pairs * cur_dist;
+        if (cur_dist > dist_max) dist_max = cur_dist;
+        pair_count += cur_pairs;
+        if (cur_dist >= m_dist_threshold) threshold_pair_count += cur_pairs;
+        
+        if (pair_count > watermark) {
+          cout << watermark << endl;
+          watermark += 100000;
+        }
       }
     }
-  }
+  };
+  
+  Apto::Array<cAnalyzeGenotype*> genotypes;
+  Apto::Array<const InstructionSequence*> seqs;
+  getBatchSequences(batch[cur_batch].List(), genotypes, seqs);
+  
+  cDistanceTotals totals(genotypes, dist_threshold);
+  cAnalyzeDistanceMatrix(m_jobqueue).Compute(seqs, seqs, true, -1, totals);
+  
+  const int dist_total = totals.dist_total;
+  const int dist_max = totals.dist_max;
+  const int pair_count = totals.pair_count;
+  const int threshold_pair_count = totals.threshold_pair_count;
+  double count = genotypes.GetSize();
   
 	count = (count * (count-1) ) /2;
   fout << pair_count << " "
@@ -3282,6 +3307,59 @@ void cAnalyze::CommandPrintDistances(cString cur_string)
 }
 
 
+// Print the edit distance between every pair of genotypes in the current batch, as the upper triangle of the matrix.
+void cAnalyze::CommandPrintDistanceMatrix(cString cur_string)
+{
+  cString filename("distance_matrix.dat");
+  if (cur_string.GetSize() != 0) filename = cur_string.PopWord();
+  int max_dist = -1;
+  if (cur_string.GetSize() != 0) max_dist = cur_string.PopWord().AsInt();
+  
+  if (m_world->GetVerbosity() >= VERBOSE_ON) {
+    cout << "Printing edit distance matrix for batch " << cur_batch << " to " << filename << endl;
+  } else {
+    cout << "Printing edit distance matrix..." << endl;
+  }
+  
+  Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
+  ostream& fout = df->OFStream();
+  
+  fout << "# Edit distance matrix" << endl;
+  fout << "# Each line is a genotype ID followed by its distances to all later genotypes in the batch" << endl;
+  if (max_dist >= 0) fout << "# Distances greater than " << max_dist << " are given as -1" << endl;
+  fout << endl;
+  
+  // Rows arrive in batch order as each band of the matrix completes, so the file is written as it goes
+  class cMatrixWriter : public cAnalyzeDistanceMatrix::cRowHandler
+  {
+  private:
+    ostream& m_fout;
+    const Apto::Array<cAnalyzeGenotype*>& m_genotypes;
+    const int m_max_dist;
+    
+  public:
+    cMatrixWriter(ostream& fout, const Apto::Array<cAnalyzeGenotype*>& genotypes, int max_dist)
+      : m_fout(fout), m_genotypes(genotypes), m_max_dist(max_dist) { ; }
+    
+    void HandleRow(int row, int, const int* dists, int num_dists)
+    {
+      m_fout << m_genotypes[row]->GetID();
+      for (int i = 0; i < num_dists; i++) {
+        m_fout << ' ' << ((m_max_dist >= 0 && dists[i] > m_max_dist) ? -1 : dists[i]);
+      }
+      m_fout << '\n';
+    }
+  };
+  
+  Apto::Array<cAnalyzeGenotype*> genotypes;
+  Apto::Array<const InstructionSequence*> seqs;
+  getBatchSequences(batch[cur_batch].List(), genotypes, seqs);
+  
+  cMatrixWriter writer(fout, genotypes, max_dist);
+  cAnalyzeDistanceMatrix(m_jobqueue).Compute(seqs, seqs, true, max_dist, writer);
+  fout.flush();
+}
+
 // Calculate various stats for trees in population.
 void cAnalyze::CommandPrintTreeStats(cString cur_string)
 {
@@ -3294,7 +3372,7 @@ void cAnalyze::CommandPrintTreeStats(cString cur_string)
   if (cur_string.GetSize() != 0) filename = cur_string.PopWord();
 
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
 
   fp << "# Legend:" << endl;
   fp << "# 1: Average cumulative stemminess" << endl;
@@ -3320,7 +3398,7 @@ void cAnalyze::CommandPrintCumulativeStemminess(cString cur_string)
   if (cur_string.GetSize() != 0) filename = cur_string.PopWord();
   
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   fp << "# Legend:" << endl;
   fp << "# 1: Average cumulative stemminess" << endl;
@@ -3372,7 +3450,7 @@ void cAnalyze::CommandPrintGamma(cString cur_string)
   int furcation_time_convention = 1;
   
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   fp << "# Legend:" << endl;
   fp << "# 1: Pybus-Harvey gamma statistic" << endl;
@@ -3386,7 +3464,7 @@ void cAnalyze::CommandPrintGamma(cString cur_string)
 
   if(lineage_thru_time_fname != ""){
     Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)lineage_thru_time_fname);
-    ofstream& ltt_fp = df->OFStream();
+    ostream& ltt_fp = df->OFStream();
 
     ltt_fp << "# Legend:" << endl;
     ltt_fp << "# 1: num_lineages" << endl;
@@ -3429,7 +3507,7 @@ void cAnalyze::AnalyzeCommunityComplexity(cString cur_string)
   
   filename.Set("%s%s", static_cast<const char*>(directory), static_cast<const char*>(filename));
   Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& cpx_fp = df->OFStream();
+  ostream& cpx_fp = df->OFStream();
   
   cpx_fp << "# Legend:" << endl;
   cpx_fp << "# 1: Genotype ID" << endl;
@@ -3765,7 +3843,7 @@ void cAnalyze::CommandPrintResourceFitnessMap(cString cur_string)
   cString filename("resourcefitmap.dat");
   if (cur_string.GetSize() != 0) filename = cur_string.PopWord();
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
 
   int f1=-1, f2=-1, rangecount[2]={0,0}, threshcount[2]={0,0};
   double f1Max = 0.0, f1Min = 0.0, f2Max = 0.0, f2Min = 0.0;
@@ -4480,6 +4558,35 @@ void cAnalyze::AnalyzeComplexityDelta(cString cur_string)
   }
 }
 
+// Build one genotype for every single-site knockout of genotype (site i replaced with the null instruction) and
+// recalculate them all on the job queue.  The caller is responsible for deleting the returned knockouts.
+void cAnalyze::RecalculateKnockouts(cAnalyzeGenotype* genotype, Apto::Array<cAnalyzeGenotype*>& knockouts,
+                                    const cCPUTestInfo* test_info)
+{
+  const Genome& base_genome = genotype->GetGenome();
+  ConstInstructionSequencePtr base_seq_p;
+  ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
+  base_seq_p.DynamicCastFrom(rep_p);
+  const InstructionSequence& base_seq = *base_seq_p;
+  
+  Genome mod_genome(base_genome);
+  InstructionSequencePtr mod_seq_p;
+  GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
+  mod_seq_p.DynamicCastFrom(mod_rep_p);
+  InstructionSequence& mod_seq = *mod_seq_p;
+  
+  const Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
+  
+  knockouts.Resize(base_seq.GetSize());
+  for (int line_num = 0; line_num < knockouts.GetSize(); line_num++) {
+    mod_seq[line_num] = null_inst;
+    knockouts[line_num] = new cAnalyzeGenotype(m_world, mod_genome);
+    mod_seq[line_num] = base_seq[line_num];
+  }
+  
+  cAnalyzeRecalcBatch(m_world, m_jobqueue).Recalculate(knockouts, test_info);
+}
+
 void cAnalyze::AnalyzeKnockouts(cString cur_string)
 {
   cout << "Analyzing the effects of knockouts..." << endl;
@@ -4496,6 +4603,8 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
   df->WriteTimeStamp();  
   
   
+  cAnalyzeRecalcBatch recalc(m_world, m_jobqueue);
+  
   // Loop through all of the genotypes in this batch...
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
   cAnalyzeGenotype * genotype = NULL;
@@ -4529,14 +4638,12 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
     int neut_count = 0;
     int pos_count = 0;
     Apto::Array<int> ko_effect(max_line);
+    
+    Apto::Array<cAnalyzeGenotype*> ko_genotypes;
+    RecalculateKnockouts(genotype, ko_genotypes);
     for (int line_num = 0; line_num < max_line; line_num++) {
-      // Save a copy of the current instruction and replace it with "NULL"
-      int cur_inst = base_seq[line_num].GetOp();
-      mod_seq[line_num] = null_inst;
-      cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-      ko_genotype.Recalculate(m_ctx);
-      
-      double ko_fitness = ko_genotype.GetFitness();
+      double ko_fitness = ko_genotypes[line_num]->GetFitness();
+      delete ko_genotypes[line_num];
       if (ko_fitness == 0.0) {
         dead_count++;
         ko_effect[line_num] = -2;
@@ -4552,23 +4659,29 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
       } else {
         cerr << "ERROR: illegal state in AnalyzeKnockouts()" << endl;
       }
-      
-      // Reset the mod_genome back to the original sequence.
-      mod_seq[line_num].SetOp(cur_inst);
     }
     
     Apto::Array<int> ko_pair_effect(ko_effect);
     if (max_knockouts > 1) {
       for (int line1 = 0; line1 < max_line; line1++) {
+        // Test all pairs starting at line1 together...
+        Apto::Array<cAnalyzeGenotype*> pair_genotypes(max_line - line1 - 1);
       	for (int line2 = line1+1; line2 < max_line; line2++) {
           int cur_inst1 = base_seq[line1].GetOp();
           int cur_inst2 = base_seq[line2].GetOp();
           mod_seq[line1] = null_inst;
           mod_seq[line2] = null_inst;
-          cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-          ko_genotype.Recalculate(m_ctx);
+          pair_genotypes[line2 - line1 - 1] = new cAnalyzeGenotype(m_world, mod_genome);
           
-          double ko_fitness = ko_genotype.GetFitness();
+          // Reset the mod_genome back to the original sequence.
+          mod_seq[line1].SetOp(cur_inst1);
+          mod_seq[line2].SetOp(cur_inst2);
+        }
+        recalc.Recalculate(pair_genotypes);
+        
+      	for (int line2 = line1+1; line2 < max_line; line2++) {
+          double ko_fitness = pair_genotypes[line2 - line1 - 1]->GetFitness();
+          delete pair_genotypes[line2 - line1 - 1];
           
           // If both individual knockouts are both harmful, but in combination
           // they are neutral or even beneficial, they should not count as 
@@ -4587,10 +4700,6 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
             ko_pair_effect[line1] = -1;
             ko_pair_effect[line2] = -1;
           }	
-          
-          // Reset the mod_genome back to the original sequence.
-          mod_seq[line1].SetOp(cur_inst1);
-          mod_seq[line2].SetOp(cur_inst2);
         }
       }
     }    
@@ -6139,7 +6248,7 @@ void cAnalyze::CommandMapTasks(cString cur_string)
       filename.Set("%stasksites.%s.html", static_cast<const char*>(directory), static_cast<const char*>(genotype->GetName()));
     }
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     // Construct linked filenames...
     cString next_file("");
@@ -6252,12 +6361,6 @@ void cAnalyze::CommandMapTasks(cString cur_string)
     base_seq_p.DynamicCastFrom(rep_p);
     const InstructionSequence& base_seq = *base_seq_p;
     
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& mod_seq = *mod_seq_p;
-    
     // Keep track of the number of failues/successes for attributes...
     int * col_pass_count = new int[num_cols];
     int * col_fail_count = new int[num_cols];
@@ -6267,16 +6370,17 @@ void cAnalyze::CommandMapTasks(cString cur_string)
     }
     
     cInstSet& is = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
-    const Instruction null_inst = is.ActivateNullInst();
     
-    // Loop through all the lines of code, testing the removal of each.
+    // Test the removal of each line of code...
+    Apto::Array<cAnalyzeGenotype*> knockouts;
+    RecalculateKnockouts(genotype, knockouts, &test_info);
+    
+    // Loop through all the lines of code, printing the effects of each removal.
     for (int line_num = 0; line_num < max_line; line_num++) {
       int cur_inst = base_seq[line_num].GetOp();
       char cur_symbol = base_seq[line_num].GetSymbol()[0]; // hack to work around multichar symbols
       
-      mod_seq[line_num] = null_inst;
-      cAnalyzeGenotype test_genotype(m_world, mod_genome);
-      test_genotype.Recalculate(m_ctx, &test_info);
+      cAnalyzeGenotype& test_genotype = *knockouts[line_num];
       
       if (file_type == FILE_TYPE_HTML) fp << "<tr><td align=right>";
       fp << (line_num + 1) << " ";
@@ -6313,8 +6417,7 @@ void cAnalyze::CommandMapTasks(cString cur_string)
       if (file_type == FILE_TYPE_HTML) fp << "</tr>";
       fp << endl;
       
-      // Reset the mod_genome back to the original sequence.
-      mod_seq[line_num].SetOp(cur_inst);
+      delete knockouts[line_num];
     }
     
     
@@ -6407,7 +6510,7 @@ void cAnalyze::CommandAverageModularity(cString cur_string)
   }
   
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   // printing the headers
   // not done by default since many dumps may be analyzed at the same time
@@ -6501,20 +6604,6 @@ void cAnalyze::CommandAverageModularity(cString cur_string)
       
       const int max_line = genotype->GetLength();
       
-      const Genome& base_genome = genotype->GetGenome();
-      ConstInstructionSequencePtr base_seq_p;
-      ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
-      base_seq_p.DynamicCastFrom(rep_p);
-      const InstructionSequence& base_seq = *base_seq_p;
-      
-      Genome mod_genome(base_genome);
-      InstructionSequencePtr mod_seq_p;
-      GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-      mod_seq_p.DynamicCastFrom(mod_rep_p);
-      InstructionSequence& mod_seq = *mod_seq_p;
-      
-      Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
-      
       // Create and initialize the modularity matrix
       tMatrix<int> mod_matrix(num_cols, max_line);
       mod_matrix.SetAll(0);
@@ -6543,13 +6632,13 @@ void cAnalyze::CommandAverageModularity(cString cur_string)
       int total_all = 0;         // sum of mod_matrix
       double sum_task_overlap = 0;// task overlap for for this geneome
       
-      // Loop through all the lines of code, testing the removal of each.
+      // Test the removal of each line of code...
+      Apto::Array<cAnalyzeGenotype*> knockouts;
+      RecalculateKnockouts(genotype, knockouts);
+      
+      // Loop through all the lines of code, checking the effects of each removal.
       for (int line_num = 0; line_num < max_line; line_num++) {
-        int cur_inst = base_seq[line_num].GetOp();
-        
-        mod_seq[line_num] = null_inst;
-        cAnalyzeGenotype test_genotype(m_world, mod_genome);
-        test_genotype.Recalculate(m_ctx);
+        cAnalyzeGenotype& test_genotype = *knockouts[line_num];
         
         // Print the individual columns...
         output_it.Reset();
@@ -6579,8 +6668,7 @@ void cAnalyze::CommandAverageModularity(cString cur_string)
           cur_col++;
         }
         
-        // Reset the mod_genome back to the original sequence.
-        mod_seq[line_num].SetOp(cur_inst);
+        delete knockouts[line_num];
       } // end of genotype-phenotype mapping for a single organism
       
       for (int i = 0; i < num_cols; i++) if (num_inst[i] != 0) total_task++;
@@ -6748,21 +6836,12 @@ void cAnalyze::CommandAnalyzeModularity(cString cur_string)
   cAnalyzeGenotype * genotype = NULL;
   while ((genotype = batch_it.Next()) != NULL) {
     const int base_length = genotype->GetLength();
-    const Genome& base_genome = genotype->GetGenome();
-    ConstInstructionSequencePtr base_seq_p;
-    ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
-    base_seq_p.DynamicCastFrom(rep_p);
-    const InstructionSequence& base_seq = *base_seq_p;    
-    
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& seq = *mod_seq_p;    
     
     genotype->Recalculate(m_ctx);
     
-    const Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
+    // Determine what happens to this genotype when each line is knocked out
+    Apto::Array<cAnalyzeGenotype*> knockouts;
+    RecalculateKnockouts(genotype, knockouts);
     
     tMatrix<bool> task_matrix(num_traits, base_length);
     Apto::Array<int> num_inst(num_traits);  // Number of instructions for each task
@@ -6773,12 +6852,7 @@ void cAnalyze::CommandAnalyzeModularity(cString cur_string)
     
     // Loop through all lines in this genome
     for (int line_num = 0; line_num < base_length; line_num++) {
-      int cur_inst = base_seq[line_num].GetOp();
-      
-      // Determine what happens to this genotype when this line is knocked out
-      seq[line_num] = null_inst;
-      cAnalyzeGenotype test_genotype(m_world, mod_genome);
-      test_genotype.Recalculate(m_ctx);
+      cAnalyzeGenotype& test_genotype = *knockouts[line_num];
       
       // Loop through the individual traits
       output_it.Reset();
@@ -6804,8 +6878,7 @@ void cAnalyze::CommandAnalyzeModularity(cString cur_string)
         cur_trait++;
       }
       
-      // Reset the mod_genome back to the original sequence.
-      seq[line_num].SetOp(cur_inst);
+      delete knockouts[line_num];
     } // end of genotype-phenotype mapping for a single organism
     
     
@@ -7040,7 +7113,7 @@ void cAnalyze::CommandMapMutations(cString cur_string)
       cout << "  Using filename \"" << filename << "\"" << endl;
     }
     Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     // Calculate the stats for the genotype we're working with...
     genotype->Recalculate(m_ctx);
@@ -7124,6 +7197,9 @@ void cAnalyze::CommandMapMutations(cString cur_string)
     
     cString color_string;  // For coloring cells...
     
+    cAnalyzeRecalcBatch recalc(m_world, m_jobqueue);
+    Apto::Array<cAnalyzeGenotype*> row_mutants(num_insts + 1);  // one per instruction, knockout last
+    
     // Loop through all the lines of code, testing all mutations...
     for (int line_num = 0; line_num < max_line; line_num++) {
       int cur_inst = base_seq[line_num].GetOp();
@@ -7131,6 +7207,19 @@ void cAnalyze::CommandMapMutations(cString cur_string)
       int row_dead = 0, row_neg = 0, row_neut = 0, row_pos = 0;
       double row_fitness = 0.0;
       
+      // Build and test every point mutation at this line (and its knockout) together
+      Apto::Array<cAnalyzeGenotype*> row_tests;
+      for (int mod_inst = 0; mod_inst <= num_insts; mod_inst++) {
+        row_mutants[mod_inst] = NULL;
+        if (mod_inst == cur_inst) continue;
+        if (mod_inst == num_insts) seq[line_num] = null_inst;
+        else seq[line_num].SetOp(mod_inst);
+        row_mutants[mod_inst] = new cAnalyzeGenotype(m_world, mod_genome);
+        row_tests.Push(row_mutants[mod_inst]);
+      }
+      seq[line_num].SetOp(cur_inst);
+      recalc.Recalculate(row_tests);
+      
       // Column 1... the original instruction in the geneome.
       if (file_type == FILE_TYPE_HTML) {
         fp << "<tr><td align=right>" << inst_set.GetName(cur_inst)
@@ -7149,10 +7238,7 @@ void cAnalyze::CommandMapMutations(cString cur_string)
           }
         }
         else {
-          seq[line_num].SetOp(mod_inst);
-          cAnalyzeGenotype test_genotype(m_world, mod_genome);
-          test_genotype.Recalculate(m_ctx);
-          const double test_fitness = test_genotype.GetFitness() / base_fitness;
+          const double test_fitness = row_mutants[mod_inst]->GetFitness() / base_fitness;
           row_fitness += test_fitness;
           total_fitness += test_fitness;
           col_fitness[mod_inst] += test_fitness;
@@ -7185,10 +7271,7 @@ void cAnalyze::CommandMapMutations(cString cur_string)
       }
       
       // Column: Knockout
-      seq[line_num] = null_inst;
-      cAnalyzeGenotype test_genotype(m_world, mod_genome);
-      test_genotype.Recalculate(m_ctx);
-      const double test_fitness = test_genotype.GetFitness() / base_fitness;
+      const double test_fitness = row_mutants[num_insts]->GetFitness() / base_fitness;
       col_fitness[num_insts] += test_fitness;
       
       // Categorize this mutation if its in HTML mode (color only)...
@@ -7229,8 +7312,7 @@ void cAnalyze::CommandMapMutations(cString cur_string)
       if (file_type == FILE_TYPE_HTML) fp << "</tr>";
       fp << endl;
       
-      // Reset the mod_genome back to the original sequence.
-      seq[line_num].SetOp(cur_inst);
+      for (int i = 0; i < row_tests.GetSize(); i++) delete row_tests[i];
     }
     
     
@@ -7286,7 +7368,7 @@ void cAnalyze::CommandMapDepth(cString cur_string)
   cout << "max_depth = " << max_depth << endl;
   
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   cout << "Output to " << filename << endl;
   Apto::Array<int> depth_array(max_depth+1);
@@ -7407,43 +7489,49 @@ void cAnalyze::CommandLevenstein(cString cur_string)
   }
   
   // Setup some variables;
-  cAnalyzeGenotype * genotype1 = NULL;
-  cAnalyzeGenotype * genotype2 = NULL;
-  double total_dist = 0;
-  double total_count = 0;
-  
-  tListIterator<cAnalyzeGenotype> list1_it(batch[batch1].List());
-  tListIterator<cAnalyzeGenotype> list2_it(batch[batch2].List());
+  class cDistanceTotals : public cAnalyzeDistanceMatrix::cRowHandler
+  {
+  private:
+    const Apto::Array<cAnalyzeGenotype*>& m_genotypes1;
+    const Apto::Array<cAnalyzeGenotype*>& m_genotypes2;
+    
+  public:
+    double total_dist;
+    double total_count;
+    
+    cDistanceTotals(const Apto::Array<cAnalyzeGenotype*>& genotypes1, const Apto::Array<cAnalyzeGenotype*>& genotypes2)
+      : m_genotypes1(genotypes1), m_genotypes2(genotypes2), total_dist(0), total_count(0) { ; }
+    
+    void HandleRow(int row, int first_col, const int* dists, int num_dists)
+    {
+      cAnalyzeGenotype* genotype1 = m_genotypes1[row];
+      for (int i = 0; i < num_dists; i++) {
+        cAnalyzeGenotype* genotype2 = m_genotypes2[first_col + i];
+        
+        // Determine the counts...
+        const int count1 = genotype1->GetNumCPUs();
+        const int count2 = genotype2->GetNumCPUs();
+        const int num_pairs = (genotype1 == genotype2) ?
+          ((count1 - 1) * (count2 - 1)) : (count1 * count2);
+        if (num_pairs == 0) continue;
+        
+        const int dist = dists[i];
+        total_dist += dist * num_pairs;
+        total_count += num_pairs;
+      }
+    }
+  };
   
   // Loop through all of the genotypes in each batch...
-  while ((genotype1 = list1_it.Next()) != NULL) {
-    list2_it.Reset();
-    while ((genotype2 = list2_it.Next()) != NULL) {
-      // Determine the counts...
-      const int count1 = genotype1->GetNumCPUs();
-      const int count2 = genotype2->GetNumCPUs();
-      const int num_pairs = (genotype1 == genotype2) ?
-        ((count1 - 1) * (count2 - 1)) : (count1 * count2);
-      if (num_pairs == 0) continue;
-      
-      // And do the tests...
-      const Genome& genotype1_genome = genotype1->GetGenome();
-      ConstInstructionSequencePtr genotype1_seq_p;
-      ConstGeneticRepresentationPtr genotype1_rep_p = genotype1_genome.Representation();
-      genotype1_seq_p.DynamicCastFrom(genotype1_rep_p);
-      const InstructionSequence& genotype1_seq = *genotype1_seq_p;
-
-      const Genome& genotype2_genome = genotype2->GetGenome();
-      ConstInstructionSequencePtr genotype2_seq_p;
-      ConstGeneticRepresentationPtr genotype2_rep_p = genotype2_genome.Representation();
-      genotype2_seq_p.DynamicCastFrom(genotype2_rep_p);
-      const InstructionSequence& genotype2_seq = *genotype2_seq_p;
-
-      const int dist = InstructionSequence::FindEditDistance(genotype1_seq, genotype2_seq);
-      total_dist += dist * num_pairs;
-      total_count += num_pairs;
-    }
-  }
+  Apto::Array<cAnalyzeGenotype*> genotypes1, genotypes2;
+  Apto::Array<const InstructionSequence*> seqs1, seqs2;
+  getBatchSequences(batch[batch1].List(), genotypes1, seqs1);
+  getBatchSequences(batch[batch2].List(), genotypes2, seqs2);
+  
+  cDistanceTotals totals(genotypes1, genotypes2);
+  cAnalyzeDistanceMatrix(m_jobqueue).Compute(seqs1, seqs2, false, -1, totals);
+  const double total_dist = totals.total_dist;
+  const double total_count = totals.total_count;
   
   // Calculate the final answer
   double ave_dist = (double) total_dist / (double) total_count;
@@ -7935,7 +8023,7 @@ void cAnalyze::AnalyzeNewInfo(cString cur_string)
   cString newinfo_fn;
   newinfo_fn.Set("%s%s.newinfo.dat", static_cast<const char*>(directory), "lineage");
   Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)newinfo_fn);
-  ofstream& newinfo_fp = df->OFStream();
+  ostream& newinfo_fp = df->OFStream();
   
   newinfo_fp << "# Legend:" << endl;
   newinfo_fp << "# 1:Child Genotype ID" << endl;
@@ -8007,7 +8095,7 @@ void cAnalyze::WriteClone(cString cur_string)
   
   
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   // Start up again at update zero...
   fp << "0 ";
@@ -8071,7 +8159,7 @@ void cAnalyze::WriteInjectEvents(cString cur_string)
   if (cur_string.GetSize() != 0) lineage = cur_string.PopWord().AsInt();
   
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   int org_count = 0;
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
@@ -8107,7 +8195,7 @@ void cAnalyze::WriteInjectInitial(cString cur_string)
   if (cur_string.GetSize() != 0) lineage = cur_string.PopWord().AsInt();
   
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   int org_count = 0;
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
@@ -8165,7 +8253,7 @@ void cAnalyze::WriteCompetition(cString cur_string)
   }
   
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   // Count the number of organisms in each batch...
   cAnalyzeGenotype * genotype = NULL;
@@ -8296,7 +8384,7 @@ void cAnalyze::AnalyzeMuts(cString cur_string)
   
   // Print out the header...
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   fp << "# " << sequences[0] << endl;
   fp << "# " << sequences[num_sequences - 1] << endl;
   fp << "# ";
@@ -8465,7 +8553,7 @@ void cAnalyze::AnalyzeInstructions(cString cur_string)
   
   // Setup the file...
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   // Determine the file type...
   int file_type = FILE_TYPE_TEXT;
@@ -8616,7 +8704,7 @@ void cAnalyze::AnalyzeInstPop(cString cur_string)
   
   // Setup the file...
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   for (int i = 0; i < num_insts; i++) {
     Instruction cur_inst(i);
@@ -8709,7 +8797,7 @@ void cAnalyze::AnalyzeMutationTraceback(cString cur_string)
   
   // Open the output file...
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(m_ctx);
   
@@ -8839,7 +8927,7 @@ void cAnalyze::AnalyzeComplexity(cString cur_string)
     lineage_filename.Set("%s%s.complexity.dat", static_cast<const char*>(directory), "nonlineage");
   }
   Avida::Output::FilePtr lineage_df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)lineage_filename);
-  ofstream& lineage_fp = lineage_df->OFStream();
+  ostream& lineage_fp = lineage_df->OFStream();
   
   while ((genotype = batch_it.Next()) != NULL) {
     if (m_world->GetVerbosity() >= VERBOSE_ON) {
@@ -8850,7 +8938,7 @@ void cAnalyze::AnalyzeComplexity(cString cur_string)
     cString filename;
     filename.Set("%s%s.complexity.dat", static_cast<const char*>(directory), static_cast<const char*>(genotype->GetName()));
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
+    ostream& fp = df->OFStream();
     
     lineage_fp << genotype->GetID() << " ";
     
@@ -9872,7 +9960,7 @@ void cAnalyze::AnalyzePopComplexity(cString cur_string)
   cString filename;
   filename.Set("%spop%s.complexity.dat", static_cast<const char*>(directory), static_cast<const char*>(file));
   Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   
   //////////////////////////////////////////////////////////
   // Loop through all of the genotypes in this batch ...
@@ -9960,7 +10048,7 @@ void cAnalyze::MutationRevert(cString cur_string)
 	
 	//Request a file
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& FOT = df->OFStream();
+  ostream& FOT = df->OFStream();
 	/*
    FOT output per line
    ID
@@ -10303,16 +10391,19 @@ void cAnalyze::BatchRecalculate(cString cur_string)
     cerr << "warning: " << msg << endl;
   }
   
+  // Run the whole batch through the test CPUs in parallel...
+  Apto::Array<cAnalyzeGenotype*> genotypes(batch[cur_batch].List().GetSize());
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-  cAnalyzeGenotype * genotype = NULL;
+  for (int i = 0; i < genotypes.GetSize(); i++) genotypes[i] = batch_it.Next();
+  cAnalyzeRecalcBatch(m_world, m_jobqueue).Recalculate(genotypes, &test_info);
+  
   cAnalyzeGenotype * last_genotype = NULL;
-  while ((genotype = batch_it.Next()) != NULL) {    
-    // If the previous genotype was the parent of this one, pass in a pointer
-    // to it for improved recalculate (such as distance to parent, etc.)
+  for (int i = 0; i < genotypes.GetSize(); i++) {
+    cAnalyzeGenotype* genotype = genotypes[i];
+    // If the previous genotype was the parent of this one, use it for the
+    // parent based stats (such as distance to parent, etc.)
     if (last_genotype != NULL && genotype->GetParentID() == last_genotype->GetID()) {
-      genotype->Recalculate(m_ctx, &test_info, last_genotype);
-    } else {
-      genotype->Recalculate(m_ctx, &test_info);
+      genotype->CalcParentStats(last_genotype);
     }
     last_genotype = genotype;
   }
@@ -10396,16 +10487,19 @@ void cAnalyze::BatchRecalculateWithArgs(cString cur_string)
     cerr << "warning: " << msg << endl;
   }
   
+  // Run the whole batch through the test CPUs in parallel...
+  Apto::Array<cAnalyzeGenotype*> genotypes(batch[cur_batch].List().GetSize());
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-  cAnalyzeGenotype * genotype = NULL;
+  for (int i = 0; i < genotypes.GetSize(); i++) genotypes[i] = batch_it.Next();
+  cAnalyzeRecalcBatch(m_world, m_jobqueue).Recalculate(genotypes, &test_info, num_trials);
+  
   cAnalyzeGenotype * last_genotype = NULL;
-  while ((genotype = batch_it.Next()) != NULL) {    
-    // If the previous genotype was the parent of this one, pass in a pointer
-    // to it for improved recalculate (such as distance to parent, etc.)
+  for (int i = 0; i < genotypes.GetSize(); i++) {
+    cAnalyzeGenotype* genotype = genotypes[i];
+    // If the previous genotype was the parent of this one, use it for the
+    // parent based stats (such as distance to parent, etc.)
     if (last_genotype != NULL && genotype->GetParentID() == last_genotype->GetID()) {
-      genotype->Recalculate(m_ctx, &test_info, last_genotype, num_trials);
-    } else {
-      genotype->Recalculate(m_ctx, &test_info, NULL, num_trials);
+      genotype->CalcParentStats(last_genotype);
     }
     last_genotype = genotype;
   }
@@ -11238,6 +11332,7 @@ void cAnalyze::SetupCommandDefLibrary()
   AddLibraryDef("PRINT_PHENOTYPES", &cAnalyze::CommandPrintPhenotypes);
   AddLibraryDef("PRINT_DIVERSITY", &cAnalyze::CommandPrintDiversity);
   AddLibraryDef("PRINT_DISTANCES", &cAnalyze::CommandPrintDistances);
+  AddLibraryDef("PRINT_DISTANCE_MATRIX", &cAnalyze::CommandPrintDistanceMatrix);
   AddLibraryDef("PRINT_TREE_STATS", &cAnalyze::CommandPrintTreeStats);
   AddLibraryDef("PRINT_CUMULATIVE_STEMMINESS", &cAnalyze::CommandPrintCumulativeStemminess);
   AddLibraryDef("PRINT_GAMMA", &cAnalyze::CommandPrintGamma);
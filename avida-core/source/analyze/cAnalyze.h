@@ -188,6 +188,8 @@ private:
   int BatchUtil_GetMaxLength(int batch_id = -1);
   
   // Command helpers...
+  void RecalculateKnockouts(cAnalyzeGenotype* genotype, Apto::Array<cAnalyzeGenotype*>& knockouts,
+                            const cCPUTestInfo* test_info = NULL);
   void CommandDetail_Header(std::ostream& fp, int format_type,
                             tListIterator< tDataEntryCommand<cAnalyzeGenotype> >& output_it, int time_step = -1);
   void CommandDetail_Body(std::ostream& fp, int format_type,
@@ -242,6 +244,7 @@ private:
   void CommandPrintPhenotypes(cString cur_string);
   void CommandPrintDiversity(cString cur_string);
   void CommandPrintDistances(cString cur_String);
+  void CommandPrintDistanceMatrix(cString cur_string);
   void CommandPrintTreeStats(cString cur_string);
   void CommandPrintCumulativeStemminess(cString cur_string);
   void CommandPrintGamma(cString cur_string);
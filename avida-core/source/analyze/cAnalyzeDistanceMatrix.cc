@@ -0,0 +1,151 @@
+/*
+ *  cAnalyzeDistanceMatrix.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cAnalyzeDistanceMatrix.h"
+
+#include "avida/core/InstructionSequence.h"
+
+#include "cAnalyzeJob.h"
+#include "cAnalyzeJobQueue.h"
+
+#include <cassert>
+
+using namespace Avida;
+
+
+class cAnalyzeDistanceMatrix::cTileJob : public cAnalyzeJob
+{
+private:
+  cAnalyzeDistanceMatrix* m_matrix;
+  int* m_dists;       // distances of row m_row_begin, the rows that follow come every num_cols entries
+  int m_row_begin;
+  int m_row_end;
+  int m_col_begin;
+  int m_col_end;
+
+public:
+  cTileJob(cAnalyzeDistanceMatrix* matrix, int* dists, int row_begin, int row_end, int col_begin, int col_end)
+    : m_matrix(matrix), m_dists(dists), m_row_begin(row_begin), m_row_end(row_end), m_col_begin(col_begin), m_col_end(col_end) { ; }
+
+  void Run(cAvidaContext&)
+  {
+    const Apto::Array<const InstructionSequence*>& rows = *m_matrix->m_rows;
+    const Apto::Array<const InstructionSequence*>& cols = *m_matrix->m_cols;
+    const int num_cols = cols.GetSize();
+
+    // One pattern per row, reused across the whole run of columns
+    EditDistancePattern pattern;
+    for (int r = m_row_begin; r < m_row_end; r++) {
+      const int first_col = m_matrix->m_upper_only ? Apto::Max(m_col_begin, r + 1) : m_col_begin;
+      if (first_col >= m_col_end) continue;
+
+      pattern.Set(*rows[r], 0, rows[r]->GetSize());
+      int* row_dists = m_dists + (r - m_row_begin) * num_cols;
+      for (int c = first_col; c < m_col_end; c++) row_dists[c] = pattern.Distance(*cols[c], m_matrix->m_max_dist);
+    }
+
+    m_matrix->jobCompleted();
+  }
+};
+
+
+void cAnalyzeDistanceMatrix::submitBand(int band)
+{
+  const int num_rows = m_rows->GetSize();
+  const int num_cols = m_cols->GetSize();
+  const int band_begin = band * BAND_ROWS;
+  const int band_end = Apto::Min(band_begin + BAND_ROWS, num_rows);
+  int* dists = m_bands[band % 2].GetSize() ? &m_bands[band % 2][0] : NULL;
+
+  Apto::Array<cAnalyzeJob*> jobs;
+  for (int row_begin = band_begin; row_begin < band_end; row_begin += TILE_ROWS) {
+    const int row_end = Apto::Min(row_begin + TILE_ROWS, band_end);
+    const int cols_begin = m_upper_only ? row_begin + 1 : 0;
+    for (int col_begin = cols_begin; col_begin < num_cols; col_begin += TILE_COLS) {
+      const int col_end = Apto::Min(col_begin + TILE_COLS, num_cols);
+      jobs.Push(new cTileJob(this, dists + (row_begin - band_begin) * num_cols, row_begin, row_end, col_begin, col_end));
+    }
+  }
+  if (!jobs.GetSize()) return;
+
+  // Count must be in place before submission, single threaded queues run the jobs as they are added
+  m_mutex.Lock();
+  m_jobs += jobs.GetSize();
+  m_mutex.Unlock();
+
+  m_queue.AddJobs(jobs);
+  m_queue.Start();
+}
+
+void cAnalyzeDistanceMatrix::waitForJobs()
+{
+  m_mutex.Lock();
+  while (m_jobs > 0) m_cond.Wait(m_mutex);
+  m_mutex.Unlock();
+}
+
+void cAnalyzeDistanceMatrix::jobCompleted()
+{
+  // Signal while still holding the lock, once the count reaches zero the waiting thread may return and destroy us
+  m_mutex.Lock();
+  m_jobs--;
+  m_cond.Signal();
+  m_mutex.Unlock();
+}
+
+
+void cAnalyzeDistanceMatrix::Compute(const Apto::Array<const InstructionSequence*>& rows,
+                                     const Apto::Array<const InstructionSequence*>& cols, bool upper_only, int max_dist,
+                                     cRowHandler& handler)
+{
+  assert(!upper_only || rows.GetSize() == cols.GetSize());
+
+  const int num_rows = rows.GetSize();
+  const int num_cols = cols.GetSize();
+  if (!num_rows) return;
+
+  m_rows = &rows;
+  m_cols = &cols;
+  m_upper_only = upper_only;
+  m_max_dist = max_dist;
+  for (int i = 0; i < 2; i++) m_bands[i].ResizeClear(Apto::Min(BAND_ROWS, num_rows) * num_cols);
+
+  const int num_bands = (num_rows + BAND_ROWS - 1) / BAND_ROWS;
+  submitBand(0);
+  waitForJobs();
+  for (int band = 0; band < num_bands; band++) {
+    if (band + 1 < num_bands) submitBand(band + 1);
+
+    const int band_begin = band * BAND_ROWS;
+    const int band_end = Apto::Min(band_begin + BAND_ROWS, num_rows);
+    const int* dists = m_bands[band % 2].GetSize() ? &m_bands[band % 2][0] : NULL;
+    for (int r = band_begin; r < band_end; r++) {
+      const int first_col = upper_only ? r + 1 : 0;
+      handler.HandleRow(r, first_col, dists + (r - band_begin) * num_cols + first_col, num_cols - first_col);
+    }
+
+    waitForJobs();
+  }
+
+  m_rows = NULL;
+  m_cols = NULL;
+  for (int i = 0; i < 2; i++) m_bands[i].ResizeClear(0);
+}
@@ -0,0 +1,93 @@
+/*
+ *  cAnalyzeDistanceMatrix.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cAnalyzeDistanceMatrix_h
+#define cAnalyzeDistanceMatrix_h
+
+#include "apto/core.h"
+
+class cAnalyzeJobQueue;
+
+namespace Avida {
+  class InstructionSequence;
+};
+
+
+// Computes the edit distances between all pairs of sequences on the analyze job queue.  The matrix is worked through in
+// bands of BAND_ROWS rows, each split into tiles of TILE_ROWS x TILE_COLS pairs that run as separate jobs.  As soon as
+// a band is complete its rows are handed, in order, to a row handler on the calling thread while the next band is being
+// computed, so memory use is bounded by two bands however many sequences there are, and the handler sees the same
+// results in the same order for any number of worker threads.
+
+class cAnalyzeDistanceMatrix
+{
+public:
+  class cRowHandler
+  {
+  public:
+    virtual ~cRowHandler() { ; }
+
+    // dists[i] is the distance from row sequence row to column sequence first_col + i
+    virtual void HandleRow(int row, int first_col, const int* dists, int num_dists) = 0;
+  };
+
+private:
+  class cTileJob;
+  friend class cTileJob;
+
+  static const int BAND_ROWS = 64;
+  static const int TILE_ROWS = 8;
+  static const int TILE_COLS = 512;
+
+  cAnalyzeJobQueue& m_queue;
+
+  const Apto::Array<const Avida::InstructionSequence*>* m_rows;
+  const Apto::Array<const Avida::InstructionSequence*>* m_cols;
+  bool m_upper_only;
+  int m_max_dist;
+  Apto::Array<int> m_bands[2];    // distances of the band being handled and of the one being computed
+
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;
+  int m_jobs;
+
+
+  void submitBand(int band);
+  void waitForJobs();
+  void jobCompleted();
+
+  cAnalyzeDistanceMatrix(); // @not_implemented
+  cAnalyzeDistanceMatrix(const cAnalyzeDistanceMatrix&); // @not_implemented
+  cAnalyzeDistanceMatrix& operator=(const cAnalyzeDistanceMatrix&); // @not_implemented
+
+public:
+  cAnalyzeDistanceMatrix(cAnalyzeJobQueue& queue)
+    : m_queue(queue), m_rows(NULL), m_cols(NULL), m_upper_only(false), m_max_dist(-1), m_jobs(0) { ; }
+
+  // Hands the distances from each row sequence to every column sequence to the handler, one row at a time in row
+  // order.  With upper_only, rows and cols must be the same sequences and each row only gets the distances to the
+  // columns after it.  With max_dist >= 0, distances greater than max_dist are given as max_dist + 1.
+  void Compute(const Apto::Array<const Avida::InstructionSequence*>& rows,
+               const Apto::Array<const Avida::InstructionSequence*>& cols, bool upper_only, int max_dist,
+               cRowHandler& handler);
+};
+
+#endif
@@ -557,7 +557,8 @@ void cAnalyzeGenotype::CalcLandscape(cAvidaContext& ctx)
 }
 
 
-void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info, cAnalyzeGenotype* parent_genotype, int num_trials)
+void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info, cAnalyzeGenotype* parent_genotype, int num_trials,
+                                   cTestCPU* testcpu)
 {  
   // Allocate our own test info if it wasn't provided
   cCPUTestInfo* local_test_info = NULL;
@@ -567,7 +568,7 @@ void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info,
   }
   
   // Handling recalculation here
-  cPhenPlastGenotype recalc_data(m_genome, num_trials, *test_info, m_world, ctx);
+  cPhenPlastGenotype recalc_data(m_genome, num_trials, *test_info, m_world, ctx, testcpu);
   
   // The most likely phenotype will be assigned to the phenotype stats
   const cPlasticPhenotype* likely_phenotype = recalc_data.GetMostLikelyPhenotype();
@@ -599,25 +600,7 @@ void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info,
 
   
   // Setup a new parent stats if we have a parent to work with.
-  if (parent_genotype != NULL) {
-    fitness_ratio = GetFitness() / parent_genotype->GetFitness();
-    efficiency_ratio = GetEfficiency() / parent_genotype->GetEfficiency();
-    comp_merit_ratio = GetCompMerit() / parent_genotype->GetCompMerit();
-    ConstInstructionSequencePtr seq_p;
-    GeneticRepresentationPtr rep_p = m_genome.Representation();
-    seq_p.DynamicCastFrom(rep_p);
-    const InstructionSequence& seq = *seq_p;
-    
-    const Genome& parent_genome = parent_genotype->GetGenome();
-    ConstInstructionSequencePtr parent_seq_p;
-    ConstGeneticRepresentationPtr parent_rep_p = parent_genome.Representation();
-    parent_seq_p.DynamicCastFrom(parent_rep_p);
-    const InstructionSequence& parent_seq = *parent_seq_p;
-    
-    parent_dist = cStringUtil::EditDistance((const char *)seq.AsString(), (const char *)parent_seq.AsString(), parent_muts);
-    
-    ancestor_dist = parent_genotype->GetAncestorDist() + parent_dist;
-  }
+  if (parent_genotype != NULL) CalcParentStats(parent_genotype);
   
   // Summarize plasticity information if multiple recalculations performed
   if (num_trials > 1){
@@ -630,7 +613,29 @@ void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info,
 }
 
 
-void cAnalyzeGenotype::PrintTasks(ofstream& fp, int min_task, int max_task)
+void cAnalyzeGenotype::CalcParentStats(cAnalyzeGenotype* parent_genotype)
+{
+  fitness_ratio = GetFitness() / parent_genotype->GetFitness();
+  efficiency_ratio = GetEfficiency() / parent_genotype->GetEfficiency();
+  comp_merit_ratio = GetCompMerit() / parent_genotype->GetCompMerit();
+  ConstInstructionSequencePtr seq_p;
+  GeneticRepresentationPtr rep_p = m_genome.Representation();
+  seq_p.DynamicCastFrom(rep_p);
+  const InstructionSequence& seq = *seq_p;
+  
+  const Genome& parent_genome = parent_genotype->GetGenome();
+  ConstInstructionSequencePtr parent_seq_p;
+  ConstGeneticRepresentationPtr parent_rep_p = parent_genome.Representation();
+  parent_seq_p.DynamicCastFrom(parent_rep_p);
+  const InstructionSequence& parent_seq = *parent_seq_p;
+  
+  parent_dist = cStringUtil::EditDistance((const char *)seq.AsString(), (const char *)parent_seq.AsString(), parent_muts);
+  
+  ancestor_dist = parent_genotype->GetAncestorDist() + parent_dist;
+}
+
+
+void cAnalyzeGenotype::PrintTasks(ostream& fp, int min_task, int max_task)
 {
   if (max_task == -1) max_task = task_counts.GetSize();
   
@@ -639,7 +644,7 @@ void cAnalyzeGenotype::PrintTasks(ofstream& fp, int min_task, int max_task)
   }
 }
 
-void cAnalyzeGenotype::PrintTasksQuality(ofstream& fp, int min_task, int max_task)
+void cAnalyzeGenotype::PrintTasksQuality(ostream& fp, int min_task, int max_task)
 {
   if (max_task == -1) max_task = task_counts.GetSize();
   
@@ -648,7 +653,7 @@ void cAnalyzeGenotype::PrintTasksQuality(ofstream& fp, int min_task, int max_tas
   }
 }
 
-void cAnalyzeGenotype::PrintInternalTasks(ofstream& fp, int min_task, int max_task)
+void cAnalyzeGenotype::PrintInternalTasks(ostream& fp, int min_task, int max_task)
 {
   if (max_task == -1) max_task = internal_task_counts.GetSize();
   
@@ -657,7 +662,7 @@ void cAnalyzeGenotype::PrintInternalTasks(ofstream& fp, int min_task, int max_ta
   }
 }
 
-void cAnalyzeGenotype::PrintInternalTasksQuality(ofstream& fp, int min_task, int max_task)
+void cAnalyzeGenotype::PrintInternalTasksQuality(ostream& fp, int min_task, int max_task)
 {
   if (max_task == -1) max_task = internal_task_counts.GetSize();
   
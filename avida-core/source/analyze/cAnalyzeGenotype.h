@@ -231,11 +231,13 @@ public:
   
   void SetCPUTestInfo(cCPUTestInfo& in_cpu_test_info) { m_cpu_test_info = in_cpu_test_info; }
   
-  void Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info = NULL, cAnalyzeGenotype* parent_genotype = NULL, int num_trials = 1);
-  void PrintTasks(std::ofstream& fp, int min_task = 0, int max_task = -1);
-  void PrintTasksQuality(std::ofstream& fp, int min_task = 0, int max_task = -1);
-  void PrintInternalTasks(std::ofstream& fp, int min_task = 0, int max_task = -1);
-  void PrintInternalTasksQuality(std::ofstream& fp, int min_task = 0, int max_task = -1);
+  void Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info = NULL, cAnalyzeGenotype* parent_genotype = NULL, int num_trials = 1,
+                   cTestCPU* testcpu = NULL);
+  void CalcParentStats(cAnalyzeGenotype* parent_genotype);
+  void PrintTasks(std::ostream& fp, int min_task = 0, int max_task = -1);
+  void PrintTasksQuality(std::ostream& fp, int min_task = 0, int max_task = -1);
+  void PrintInternalTasks(std::ostream& fp, int min_task = 0, int max_task = -1);
+  void PrintInternalTasksQuality(std::ostream& fp, int min_task = 0, int max_task = -1);
   void CalcLandscape(cAvidaContext& ctx);
 
   // Set...
@@ -27,6 +27,9 @@
 #include "avida/core/WorldDriver.h"
 
 #include "cAnalyzeJobWorker.h"
+#include "cAvidaContext.h"
+#include "cHardwareManager.h"
+#include "cTestCPU.h"
 #include "cWorld.h"
 
 
@@ -38,7 +41,8 @@ using namespace Avida;
 
 
 cAnalyzeJobQueue::cAnalyzeJobQueue(cWorld* world)
-: m_world(world), m_last_jobid(0), m_jobs(0), m_pending(0), m_workers(Apto::Platform::AvailableCPUs())
+: m_world(world), m_last_jobid(0), m_testcpu(NULL), m_submitted(0), m_outstanding(0), m_next_deque(0), m_shutdown(false)
+, m_workers(Apto::Platform::AvailableCPUs())
 {
   const int max_workers = world->GetConfig().MAX_CONCURRENCY.Get();
   if (max_workers > 0 && max_workers < m_workers.GetSize()) m_workers.Resize(max_workers);
@@ -46,8 +50,10 @@ cAnalyzeJobQueue::cAnalyzeJobQueue(cWorld* world)
   m_job_seed_rng = new Apto::RNG::AvidaRNG(world->GetRandom().GetInt(world->GetRandom().MaxSeed()));
   
   if (m_workers.GetSize() > 1) {
+    m_deques.Resize(m_workers.GetSize());
+    for (int i = 0; i < m_deques.GetSize(); i++) m_deques[i] = new sWorkerDeque;
     for (int i = 0; i < m_workers.GetSize(); i++) {
-      m_workers[i] = new cAnalyzeJobWorker(this);
+      m_workers[i] = new cAnalyzeJobWorker(this, i);
       m_workers[i]->Start();
     }
   } else {
@@ -62,11 +68,14 @@ cAnalyzeJobQueue::~cAnalyzeJobQueue()
   m_mutex.Lock();
   
   // Clean out any waiting jobs
-  cAnalyzeJob* job;
-  while ((job = m_queue.Pop())) delete job;
+  for (int i = 0; i < m_deques.GetSize(); i++) {
+    Apto::MutexAutoLock lock(m_deques[i]->mutex);
+    cAnalyzeJob* job;
+    while ((job = m_deques[i]->jobs.Pop())) delete job;
+  }
   
-  // Set job count so that all workers receive NULL jobs
-  m_jobs = num_workers;
+  // Flag shutdown so that idle workers exit rather than wait for more jobs
+  m_shutdown = true;
   
   m_mutex.Unlock();
   
@@ -77,32 +86,120 @@ cAnalyzeJobQueue::~cAnalyzeJobQueue()
     m_workers[i]->Join();
     delete m_workers[i];
   }
+  for (int i = 0; i < m_deques.GetSize(); i++) delete m_deques[i];
   
   delete m_job_seed_rng;
+  delete m_testcpu;
+}
+
+inline void cAnalyzeJobQueue::prepareJob(cAnalyzeJob* job)
+{
+  // Caller must hold m_mutex.  Seeds are drawn in job ID order, so each job sees the same random stream regardless
+  // of how many workers there are or which one runs it.
+  job->SetID(m_last_jobid++);
+  job->SetSeed(m_job_seed_rng->GetInt(m_job_seed_rng->MaxSeed()));
 }
 
 inline void cAnalyzeJobQueue::queueJob(cAnalyzeJob* job)
 {
-  if (m_workers.GetSize()) m_queue.PushRear(job);
-  else singleThreadedJobExecution(job);
+  // Caller must hold m_mutex
+  sWorkerDeque* deque = m_deques[m_next_deque];
+  m_next_deque = (m_next_deque + 1) % m_deques.GetSize();
+  
+  deque->mutex.Lock();
+  deque->jobs.PushRear(job);
+  deque->mutex.Unlock();
+  
+  m_submitted++;
+  m_outstanding++;
 }
 
 void cAnalyzeJobQueue::AddJob(cAnalyzeJob* job)
 {
-  Apto::MutexAutoLock lock(m_mutex);
-  job->SetID(m_last_jobid++);
-  queueJob(job);
-  m_jobs++;
+  m_mutex.Lock();
+  prepareJob(job);
+  if (m_workers.GetSize()) {
+    queueJob(job);
+    m_mutex.Unlock();
+  } else {
+    m_mutex.Unlock();
+    singleThreadedJobExecution(job);
+  }
+}
+
+void cAnalyzeJobQueue::AddJobs(const Apto::Array<cAnalyzeJob*>& jobs)
+{
+  const int num_jobs = jobs.GetSize();
+  
+  m_mutex.Lock();
+  for (int i = 0; i < num_jobs; i++) prepareJob(jobs[i]);
+  
+  if (!m_workers.GetSize()) {
+    m_mutex.Unlock();
+    for (int i = 0; i < num_jobs; i++) singleThreadedJobExecution(jobs[i]);
+    return;
+  }
+  
+  // Hand each deque one contiguous run of the batch, taking its lock only once
+  const int num_deques = m_deques.GetSize();
+  const int run_size = (num_jobs + num_deques - 1) / num_deques;
+  for (int begin = 0; begin < num_jobs; begin += run_size) {
+    sWorkerDeque* deque = m_deques[m_next_deque];
+    m_next_deque = (m_next_deque + 1) % num_deques;
+    
+    const int end = Apto::Min(begin + run_size, num_jobs);
+    deque->mutex.Lock();
+    for (int i = begin; i < end; i++) deque->jobs.PushRear(jobs[i]);
+    deque->mutex.Unlock();
+  }
+  m_submitted += num_jobs;
+  m_outstanding += num_jobs;
+  
+  m_mutex.Unlock();
 }
 
 void cAnalyzeJobQueue::AddJobImmediate(cAnalyzeJob* job)
 {
   m_mutex.Lock();
-  job->SetID(m_last_jobid++);
-  queueJob(job);
-  m_jobs++;
-  m_mutex.Unlock(); // should unlock prior to signaling condition variable
-  m_cond.Signal();
+  prepareJob(job);
+  if (m_workers.GetSize()) {
+    queueJob(job);
+    m_mutex.Unlock(); // should unlock prior to signaling condition variable
+    m_cond.Signal();
+  } else {
+    m_mutex.Unlock();
+    singleThreadedJobExecution(job);
+  }
+}
+
+
+cAnalyzeJob* cAnalyzeJobQueue::takeJob(int worker_id)
+{
+  // Own deque first, oldest job first
+  sWorkerDeque* own = m_deques[worker_id];
+  own->mutex.Lock();
+  cAnalyzeJob* job = own->jobs.Pop();
+  own->mutex.Unlock();
+  if (job) return job;
+  
+  // Steal the newest job of the next non-empty deque
+  const int num_deques = m_deques.GetSize();
+  for (int i = 1; i < num_deques; i++) {
+    sWorkerDeque* victim = m_deques[(worker_id + i) % num_deques];
+    victim->mutex.Lock();
+    job = victim->jobs.PopRear();
+    victim->mutex.Unlock();
+    if (job) return job;
+  }
+  
+  return NULL;
+}
+
+void cAnalyzeJobQueue::reportCompleted(int num_completed)
+{
+  // Caller must hold m_mutex
+  m_outstanding -= num_completed;
+  if (!m_outstanding) m_term_cond.Signal();
 }
 
 
@@ -124,7 +221,7 @@ void cAnalyzeJobQueue::Execute()
   
   // Wait for term signal
   m_mutex.Lock();
-  while (m_jobs > 0 || m_pending > 0) {
+  while (m_outstanding > 0) {
     m_term_cond.Wait(m_mutex);
   }
   m_mutex.Unlock();
@@ -135,9 +232,16 @@ void cAnalyzeJobQueue::Execute()
 
 void cAnalyzeJobQueue::singleThreadedJobExecution(cAnalyzeJob* job)
 {
-  Apto::RNG::AvidaRNG rng(GetSeedForJob(job->GetID()));
+  Apto::RNG::AvidaRNG rng(job->GetSeed());
   cAvidaContext ctx(&m_world->GetDriver(), rng);
+  
+  // Created ahead of the reseed, like the per-worker test CPUs, so it draws nothing from the job's random stream
+  if (!m_testcpu) {
+    m_testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+    rng.ResetSeed(job->GetSeed());
+  }
+  ctx.SetTestCPU(m_testcpu);
+  
   job->Run(ctx);
   delete job;
 }
-
@@ -29,6 +29,7 @@
 #include "tList.h"
 
 class cAnalyzeJobWorker;
+class cTestCPU;
 class cWorld;
 
 #if APTO_PLATFORM(WINDOWS) && defined(AddJob)
@@ -39,27 +40,44 @@ class cWorld;
 const int MT_RANDOM_INDEX_MASK = 0x7F;
 
 
+// Jobs are spread across one deque per worker thread.  Each worker runs jobs from the front of its own deque and, once
+// that runs dry, steals from the rear of the others, so workers only contend with each other when work is unbalanced.
+// Every job is assigned its RNG seed at submission, in job ID order, making results independent of which worker runs
+// it (and identical to single threaded execution).
+
 class cAnalyzeJobQueue
 {
   friend class cAnalyzeJobWorker;
   
 private:
+  struct sWorkerDeque
+  {
+    Apto::Mutex mutex;
+    tList<cAnalyzeJob> jobs;
+  };
+
   cWorld* m_world;
-  tList<cAnalyzeJob> m_queue;
   int m_last_jobid;
   Apto::Random* m_job_seed_rng;
-  Apto::Mutex m_mutex;
+  cTestCPU* m_testcpu;      // shared by jobs executed on the submitting thread when there are no workers
+  Apto::Mutex m_mutex;      // guards submission (job ids, seeds) and the counters below
   Apto::ConditionVariable m_cond;
   Apto::ConditionVariable m_term_cond;
   
-  volatile int m_jobs;      // count of waiting jobs, used in condition variable constructs
-  volatile int m_pending;   // count of currently executing jobs
+  int m_submitted;          // total jobs submitted, idle workers sleep until this changes
+  int m_outstanding;        // jobs submitted but not yet reported complete
+  int m_next_deque;         // round-robin target for the next submission
+  bool m_shutdown;
   
   Apto::Array<cAnalyzeJobWorker*> m_workers;
+  Apto::Array<sWorkerDeque*> m_deques;
 
 
   void singleThreadedJobExecution(cAnalyzeJob* job);
+  inline void prepareJob(cAnalyzeJob* job);
   inline void queueJob(cAnalyzeJob* job);
+  cAnalyzeJob* takeJob(int worker_id);
+  void reportCompleted(int num_completed);
 
   
   cAnalyzeJobQueue(); // @not_implemented
@@ -72,12 +90,11 @@ public:
   ~cAnalyzeJobQueue();
 
   void AddJob(cAnalyzeJob* job);
+  void AddJobs(const Apto::Array<cAnalyzeJob*>& jobs);
   void AddJobImmediate(cAnalyzeJob* job);
 
   void Start();
   void Execute();
-  
-  int GetSeedForJob(int jobid) { Apto::MutexAutoLock lock(m_mutex); return m_job_seed_rng->GetInt(m_job_seed_rng->MaxSeed()); }
 };
 
 #endif
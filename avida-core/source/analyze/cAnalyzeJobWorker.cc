@@ -23,6 +23,8 @@
 
 #include "cAnalyzeJobQueue.h"
 #include "cAvidaContext.h"
+#include "cHardwareManager.h"
+#include "cTestCPU.h"
 #include "cWorld.h"
 
 
@@ -31,35 +33,43 @@ void cAnalyzeJobWorker::Run()
   Apto::RNG::AvidaRNG rng;
   cAvidaContext ctx(&m_queue->m_world->GetDriver(), rng);
   ctx.SetAnalyzeMode();
+  cTestCPU* testcpu = NULL;
   
-  cAnalyzeJob* job = NULL;
+  int seen = 0;       // m_submitted as of the last time this worker went looking for work
+  int completed = 0;  // jobs finished since completions were last reported to the queue
   
   while (1) {
+    cAnalyzeJob* job = m_queue->takeJob(m_id);
+    if (job) {
+      // One test CPU serves every job this worker runs, created ahead of the reseed so that it draws nothing from the
+      // job's random stream
+      if (!testcpu) {
+        testcpu = m_queue->m_world->GetHardwareManager().CreateTestCPU(ctx);
+        ctx.SetTestCPU(testcpu);
+      }
+      
+      // Set RNG from the job's assigned seed and execute the job
+      rng.ResetSeed(job->GetSeed());
+      job->Run(ctx);
+      delete job;
+      completed++;
+      continue;
+    }
+    
+    // Out of work, report completions and sleep until more jobs are submitted
     m_queue->m_mutex.Lock();
-    while (m_queue->m_jobs == 0) {
+    m_queue->reportCompleted(completed);
+    completed = 0;
+    while (!m_queue->m_shutdown && m_queue->m_submitted == seen) {
       m_queue->m_cond.Wait(m_queue->m_mutex);
     }
-    job = m_queue->m_queue.Pop();
-    m_queue->m_jobs--;
-    m_queue->m_pending++; 
+    seen = m_queue->m_submitted;
+    const bool shutdown = m_queue->m_shutdown;
     m_queue->m_mutex.Unlock();
     
-    if (job) {
-      // Set RNG from the waiting pool and execute the job
-      rng.ResetSeed(m_queue->GetSeedForJob(job->GetID()));
-      job->Run(ctx);
-      delete job;
-      m_queue->m_mutex.Lock();
-      int pending = --m_queue->m_pending;
-      m_queue->m_mutex.Unlock();
-      if (!pending) m_queue->m_term_cond.Signal();
-    } else {
-      // Terminate worker on NULL job receipt
-      m_queue->m_mutex.Lock();
-      int pending = --m_queue->m_pending;
-      m_queue->m_mutex.Unlock();
-      if (!pending) m_queue->m_term_cond.Signal();
-      break;
-    }
+    // Terminate worker on shutdown
+    if (shutdown) break;
   }
+  
+  delete testcpu;
 }
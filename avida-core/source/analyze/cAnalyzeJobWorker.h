@@ -31,11 +31,12 @@ class cAnalyzeJobWorker : public Apto::Thread
 {
 private:
   cAnalyzeJobQueue* m_queue;
+  int m_id;
   
   void Run();
 
 public:
-  cAnalyzeJobWorker(cAnalyzeJobQueue* queue) : m_queue(queue) { ; }  
+  cAnalyzeJobWorker(cAnalyzeJobQueue* queue, int worker_id) : m_queue(queue), m_id(worker_id) { ; }  
 };
 
 #endif
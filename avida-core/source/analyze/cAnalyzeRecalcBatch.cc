@@ -0,0 +1,99 @@
+/*
+ *  cAnalyzeRecalcBatch.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cAnalyzeRecalcBatch.h"
+
+#include "cAnalyzeGenotype.h"
+#include "cAvidaContext.h"
+#include "cCPUTestInfo.h"
+#include "cHardwareManager.h"
+#include "cTestCPU.h"
+#include "cWorld.h"
+#include "tAnalyzeJobBatch.h"
+
+
+class cAnalyzeRecalcBatch::cRecalcRun
+{
+private:
+  cWorld* m_world;
+  const Apto::Array<cAnalyzeGenotype*>* m_genotypes;
+  int m_begin;
+  int m_end;
+  const cCPUTestInfo* m_test_info;
+  int m_num_trials;
+
+public:
+  cRecalcRun() : m_world(NULL), m_genotypes(NULL), m_begin(0), m_end(0), m_test_info(NULL), m_num_trials(1) { ; }
+
+  void Setup(cWorld* world, const Apto::Array<cAnalyzeGenotype*>& genotypes, int begin, int end,
+             const cCPUTestInfo* test_info, int num_trials)
+  {
+    m_world = world;
+    m_genotypes = &genotypes;
+    m_begin = begin;
+    m_end = end;
+    m_test_info = test_info;
+    m_num_trials = num_trials;
+  }
+
+  void Run(cAvidaContext& ctx)
+  {
+    cCPUTestInfo test_info(m_test_info ? m_test_info->GetGenerationTests() : nHardware::TEST_CPU_GENERATIONS);
+    if (m_test_info) test_info.CopySettings(*m_test_info);
+
+    // Worker threads keep one test CPU for all of their jobs, only contexts without one need a temporary
+    cTestCPU* testcpu = ctx.GetTestCPU();
+    cTestCPU* local_testcpu = NULL;
+    if (!testcpu) testcpu = local_testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+
+    for (int i = m_begin; i < m_end; i++) (*m_genotypes)[i]->Recalculate(ctx, &test_info, NULL, m_num_trials, testcpu);
+
+    delete local_testcpu;
+  }
+};
+
+
+void cAnalyzeRecalcBatch::Recalculate(const Apto::Array<cAnalyzeGenotype*>& genotypes, const cCPUTestInfo* test_info,
+                                      int num_trials)
+{
+  const int num_genotypes = genotypes.GetSize();
+  if (!num_genotypes) return;
+
+  Apto::Array<cRecalcRun> runs((num_genotypes + RUN_SIZE - 1) / RUN_SIZE);
+  for (int i = 0; i < runs.GetSize(); i++) {
+    const int begin = i * RUN_SIZE;
+    runs[i].Setup(m_world, genotypes, begin, Apto::Min(begin + RUN_SIZE, num_genotypes), test_info, num_trials);
+  }
+
+  // A tracer is shared by every copy of the test settings, so traced recalculations run their jobs one at a time (in
+  // the same order, so with the same seeds)
+  if (test_info && test_info->GetTracer()) {
+    for (int i = 0; i < runs.GetSize(); i++) {
+      tAnalyzeJobBatch<cRecalcRun> jobbatch(m_queue);
+      jobbatch.AddJob(&runs[i], &cRecalcRun::Run);
+      jobbatch.RunBatch();
+    }
+  } else {
+    tAnalyzeJobBatch<cRecalcRun> jobbatch(m_queue);
+    for (int i = 0; i < runs.GetSize(); i++) jobbatch.AddJob(&runs[i], &cRecalcRun::Run);
+    jobbatch.RunBatch();
+  }
+}
@@ -0,0 +1,63 @@
+/*
+ *  cAnalyzeRecalcBatch.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cAnalyzeRecalcBatch_h
+#define cAnalyzeRecalcBatch_h
+
+#include "apto/core.h"
+
+class cAnalyzeGenotype;
+class cAnalyzeJobQueue;
+class cCPUTestInfo;
+class cWorld;
+
+
+// Recalculates a set of genotypes on the analyze job queue.  Genotypes are handed out in runs of RUN_SIZE, one batch
+// job per run, and each job tests its whole run on the test CPU of the thread executing it (see
+// cAvidaContext::GetTestCPU) using a copy of the test settings.  The run layout is fixed and job seeds follow
+// submission order, so the results do not depend on the number of worker threads.  Settings with a tracer run the jobs
+// one at a time, since every copy writes to the same tracer.
+
+class cAnalyzeRecalcBatch
+{
+private:
+  class cRecalcRun;
+
+  static const int RUN_SIZE = 4;
+
+  cWorld* m_world;
+  cAnalyzeJobQueue& m_queue;
+
+
+  cAnalyzeRecalcBatch(); // @not_implemented
+  cAnalyzeRecalcBatch(const cAnalyzeRecalcBatch&); // @not_implemented
+  cAnalyzeRecalcBatch& operator=(const cAnalyzeRecalcBatch&); // @not_implemented
+
+public:
+  cAnalyzeRecalcBatch(cWorld* world, cAnalyzeJobQueue& queue) : m_world(world), m_queue(queue) { ; }
+
+  // Runs Recalculate on every genotype and returns once all have completed.  Parent statistics are not computed, use
+  // cAnalyzeGenotype::CalcParentStats afterwards in lineage order.  A NULL test_info uses default test settings.
+  void Recalculate(const Apto::Array<cAnalyzeGenotype*>& genotypes, const cCPUTestInfo* test_info = NULL,
+                   int num_trials = 1);
+};
+
+#endif
@@ -165,7 +165,7 @@ void cMutationalNeighborhood::ProcessInitialize(cAvidaContext& ctx)
   // Generate base information
   cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
   cCPUTestInfo test_info;
-  testcpu->TestGenome(ctx, test_info, m_base_genome);
+  testcpu->RecordCheckpoints(ctx, test_info, m_base_genome, m_base_checkpoints);
   
   cPhenotype& phenotype = test_info.GetColonyOrganism()->GetPhenotype();
   m_base_fitness = test_info.GetColonyFitness();
@@ -208,8 +208,10 @@ void cMutationalNeighborhood::ProcessInitialize(cAvidaContext& ctx)
   
   // Load enough jobs to process all sites
   cAnalyzeJobQueue& jobqueue = m_world->GetAnalyze().GetJobQueue();
+  Apto::Array<cAnalyzeJob*> jobs(m_base_genome_size);
   for (int i = 0; i < m_base_genome_size; i++)
-    jobqueue.AddJob(new tAnalyzeJob<cMutationalNeighborhood>(this, &cMutationalNeighborhood::Process));
+    jobs[i] = new tAnalyzeJob<cMutationalNeighborhood>(this, &cMutationalNeighborhood::Process);
+  jobqueue.AddJobs(jobs);
   
   jobqueue.Start();
 }
@@ -294,7 +296,7 @@ double cMutationalNeighborhood::ProcessOneStepGenome(cAvidaContext& ctx, cTestCP
                                                      const Genome& mod_genome, sStep& odata, int cur_site)
 {
   // Run the modified genome through the Test CPU
-  testcpu->TestGenome(ctx, test_info, mod_genome);
+  testcpu->TestGenome(ctx, test_info, mod_genome, m_base_checkpoints);
   
   // Collect the calculated fitness
   double test_fitness = test_info.GetColonyFitness();
@@ -504,7 +506,7 @@ double cMutationalNeighborhood::ProcessTwoStepGenome(cAvidaContext& ctx, cTestCP
                                                      const sPendFit& cur, const sPendFit& oth)
 {
   // Run the modified genome through the Test CPU
-  testcpu->TestGenome(ctx, test_info, mod_genome);
+  testcpu->TestGenome(ctx, test_info, mod_genome, m_base_checkpoints);
   
   // Collect the calculated fitness
   double test_fitness = test_info.GetColonyFitness();
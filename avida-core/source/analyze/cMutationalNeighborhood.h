@@ -26,6 +26,7 @@
 #include "avida/core/Genome.h"
 #include "avida/output/Types.h"
 
+#include "cTestCPUCheckpoints.h"
 #include "tList.h"
 #include "tMatrix.h"
 
@@ -70,6 +71,7 @@ private:
   Apto::Array<int> m_base_tasks;
   double m_neut_min;  // These two variables are a range around the base
   double m_neut_max;  //   fitness to be counted as neutral mutations.
+  cTestCPUCheckpoints m_base_checkpoints;  // Base gestation, resumed by point mutant tests
   
   
 
@@ -85,10 +85,11 @@ protected:
     {
       tAnalyzeJob<T>::Run(ctx);
       
+      // Signal while still holding the lock, once the count reaches zero the waiting thread may return and destroy the batch
       m_batch->m_mutex.Lock();
       m_batch->m_jobs--;
-      m_batch->m_mutex.Unlock();
       m_batch->m_cond.Signal();
+      m_batch->m_mutex.Unlock();
     }
   };
 };
@@ -544,14 +544,14 @@ int Avida::InstructionSequence::FindSlidingDistance(const InstructionSequence& s
 }
 
 
-int Avida::InstructionSequence::FindEditDistance(const InstructionSequence& seq1, const InstructionSequence& seq2)
+int Avida::InstructionSequence::FindEditDistance(const InstructionSequence& seq1, const InstructionSequence& seq2, int max_dist)
 {
   const int size1 = seq1.GetSize();
   const int size2 = seq2.GetSize();
   const int min_size = (size1 < size2) ? size1 : size2;
   
   // If either size is zero, return the other one!
-  if (!min_size) return (size1 > size2) ? size1 : size2;
+  if (!min_size) return (max_dist >= 0) ? Apto::Min(size1 + size2, max_dist + 1) : size1 + size2;
   
   // Count how many direct matches we have at the front and end.
   int match_front = 0, match_end = 0;
@@ -562,52 +562,118 @@ int Avida::InstructionSequence::FindEditDistance(const InstructionSequence& seq1
   const int test_size1 = size1 - match_front - match_end;
   const int test_size2 = size2 - match_front - match_end;
   
-  if (test_size1 <= 0 || test_size2 <=0) return abs(test_size1 - test_size2);
+  if (test_size1 <= 0 || test_size2 <=0) {
+    const int value = abs(test_size1 - test_size2);
+    return (max_dist >= 0) ? Apto::Min(value, max_dist + 1) : value;
+  }
+  
+  // Now match everything else, using the shorter of the two as the pattern (fewer words per column)
+  EditDistancePattern pattern;
+  if (test_size1 <= test_size2) {
+    pattern.Set(seq1, match_front, size1 - match_end);
+    return pattern.Distance(seq2, match_front, size2 - match_end, max_dist);
+  }
+  pattern.Set(seq2, match_front, size2 - match_end);
+  return pattern.Distance(seq1, match_front, size1 - match_end, max_dist);
+}
+
+
+void Avida::EditDistancePattern::Set(const InstructionSequence& seq, int begin, int end)
+{
+  assert(begin >= 0 && begin <= end && end <= seq.GetSize());
+  
+  m_size = end - begin;
+  m_words = (m_size + 63) / 64;
+  
+  // Give each instruction that occurs its own row of masks, all others share the empty row 0
+  for (int i = 0; i < 256; i++) m_slot[i] = 0;
+  int num_slots = 1;
+  for (int i = begin; i < end; i++) {
+    const int op = seq[i].GetOp();
+    if (!m_slot[op]) m_slot[op] = num_slots++;
+  }
+  
+  m_masks.ResizeClear(num_slots * m_words);
+  m_masks.SetAll(0);
+  for (int i = 0; i < m_size; i++) {
+    m_masks[m_slot[seq[begin + i].GetOp()] * m_words + i / 64] |= 1ULL << (i % 64);
+  }
+}
+
+
+int Avida::EditDistancePattern::Distance(const InstructionSequence& seq, int begin, int end, int max_dist) const
+{
+  assert(begin >= 0 && begin <= end && end <= seq.GetSize());
+  
+  const int size = end - begin;
+  if (max_dist >= 0 && abs(m_size - size) > max_dist) return max_dist + 1;
+  if (!m_size || !size) return m_size + size;
+  
+  // Each column of the matrix is held as vertical deltas, one bit per row in pv (+1) and mv (-1), along with the score
+  // (matrix value) at the last row of each block of 64 rows.
+  unsigned long long local_deltas[2 * LOCAL_WORDS];
+  int local_scores[LOCAL_WORDS];
+  Apto::Array<unsigned long long> heap_deltas;
+  Apto::Array<int> heap_scores;
+  unsigned long long* pv = local_deltas;
+  int* scores = local_scores;
+  if (m_words > LOCAL_WORDS) {
+    heap_deltas.Resize(2 * m_words);
+    heap_scores.Resize(m_words);
+    pv = &heap_deltas[0];
+    scores = &heap_scores[0];
+  }
+  unsigned long long* mv = pv + m_words;
   
-  // Now match everything else...
-  int* cur_row  = new int[test_size1];  // The row we are calculating
-  int* prev_row = new int[test_size1];  // The last row we calculated
+  for (int w = 0; w < m_words; w++) {
+    pv[w] = ~0ULL;
+    mv[w] = 0;
+    scores[w] = Apto::Min(64 * (w + 1), m_size);
+  }
   
-  // Initialize the previous row to record the differece from nothing.
-  for (int i = 0; i < test_size1; i++)  prev_row[i] = i + 1;
+  const unsigned long long full_high = 1ULL << 63;
+  const unsigned long long last_high = 1ULL << ((m_size - 1) % 64);
   
-  // Loop through each subsequent character in the test code
-  for (int i = 0; i < test_size2; i++) {
-    // Initialize the first entry in cur_row.
-    if (seq1[match_front] == seq2[match_front + i]) cur_row[0] = i;
-    else cur_row[0] = (i < prev_row[0]) ? (i+1) : (prev_row[0] + 1);
+  for (int j = 0; j < size; j++) {
+    const unsigned long long* eq_col = &m_masks[m_slot[seq[begin + j].GetOp()] * m_words];
     
-    // Move down the cur_row and fill it out.
-    for (int j = 1; j < test_size1; j++) {
-      // If the values are equal, keep the value in the upper left.
-      if (seq1[match_front + j] == seq2[match_front + i]) {
-        cur_row[j] = prev_row[j-1];
-      }
+    // The first row always grows by one per column, later blocks take the change at the bottom of the one above
+    int h_in = 1;
+    for (int w = 0; w < m_words; w++) {
+      const unsigned long long high = (w == m_words - 1) ? last_high : full_high;
+      const unsigned long long pv_w = pv[w];
+      const unsigned long long mv_w = mv[w];
+      unsigned long long eq = eq_col[w];
       
-      // Otherwise, set the current position the the minimal of the three
-      // numbers above (insertion), to the left (deletion), or upper left
-      // (mutation) in the chart, plus one.
-      else {
-        cur_row[j] = (prev_row[j] < prev_row[j-1]) ? prev_row[j] : prev_row[j-1];
-        if (cur_row[j-1] < cur_row[j]) cur_row[j] = cur_row[j-1];
-        cur_row[j]++;
-      }
+      const unsigned long long xv = eq | mv_w;
+      if (h_in < 0) eq |= 1;
+      const unsigned long long xh = (((eq & pv_w) + pv_w) ^ pv_w) | eq;
+      unsigned long long ph = mv_w | ~(xh | pv_w);
+      unsigned long long mh = pv_w & xh;
+      
+      const int h_out = (ph & high) ? 1 : ((mh & high) ? -1 : 0);
+      
+      ph <<= 1;
+      mh <<= 1;
+      if (h_in < 0) mh |= 1;
+      else if (h_in > 0) ph |= 1;
+      pv[w] = mh | ~(xv | ph);
+      mv[w] = ph & xv;
+      
+      scores[w] += h_out;
+      h_in = h_out;
     }
     
-    // Swap cur_row and prev_row. (we only really need to move the cur row
-    // over to prev, but this saves us from having to keep re-allocating
-    // new rows.  We recycle!
-    int* temp_row = cur_row;
-    cur_row = prev_row;
-    prev_row = temp_row;
+    if (max_dist >= 0) {
+      // Values never fall along a diagonal, and fall by at most one per step across or down, so the final distance is
+      // at least any block's score less the number of steps off the diagonal it is from the final corner
+      const int cols_left = size - j - 1;
+      for (int w = 0; w < m_words; w++) {
+        const int rows_left = m_size - Apto::Min(64 * (w + 1), m_size);
+        if (scores[w] - abs(rows_left - cols_left) > max_dist) return max_dist + 1;
+      }
+    }
   }
   
-  // Now that we are done, return the bottom-right corner of the chart.
-  
-  const int value = prev_row[test_size1 - 1];
-  
-  delete [] cur_row;
-  delete [] prev_row;
-  
-  return value;
+  return scores[m_words - 1];
 }
@@ -22,10 +22,13 @@
 
 #include "cCPUMemory.h"
 
+#include "cChunkedFile.h"
+
 using namespace std;
 using namespace Avida;
 
-cCPUMemory::cCPUMemory(const cCPUMemory& in_memory) : InstructionSequence(in_memory), m_flag_array(in_memory.GetSize())
+cCPUMemory::cCPUMemory(const cCPUMemory& in_memory)
+  : InstructionSequence(in_memory), m_flag_array(in_memory.GetSize()), m_num_nops(in_memory.m_num_nops), m_runs_stale(true)
 {
   for (int i = 0; i < m_flag_array.GetSize(); i++) m_flag_array[i] = in_memory.m_flag_array[i];
 }
@@ -54,6 +57,17 @@ void cCPUMemory::prepareInsert(int pos, int num_sites)
 }
 
 
+void cCPUMemory::removeSites(int pos, int num_sites)
+{
+  const int new_size = m_active_size - num_sites;
+  for (int i = pos; i < new_size; i++) {
+    m_seq[i] = m_seq[i + num_sites];
+    m_flag_array[i] = m_flag_array[i + num_sites];
+  }
+  adjustCapacity(new_size);
+}
+
+
 void cCPUMemory::Reset(int new_size)
 {
   assert(new_size >= 0);
@@ -69,6 +83,7 @@ void cCPUMemory::Resize(int new_size)
 
   const int old_size = m_active_size;
   adjustCapacity(new_size);
+  m_runs_stale = true;
   
   for (int i = old_size; i < new_size; i++) {
     m_seq[i].SetOp(0);
@@ -83,6 +98,7 @@ void cCPUMemory::ResizeOld(int new_size)
 
   const int old_size = m_active_size;
   adjustCapacity(new_size);
+  m_runs_stale = true;
 
   for (int i = old_size; i < new_size; i++) m_flag_array[i] = 0;
 }
@@ -97,6 +113,7 @@ void cCPUMemory::Copy(int to, int from)
   
   m_seq[to] = m_seq[from];
   m_flag_array[to] = m_flag_array[from];
+  if (m_num_nops) markDirty(to);
 }
 
 
@@ -105,9 +122,11 @@ void cCPUMemory::Insert(int pos, const Instruction& inst)
   assert(pos >= 0);
   assert(pos <= m_seq.GetSize());
 
+  if (m_num_nops && !m_runs_stale) syncNopRuns();
   prepareInsert(pos, 1);
   m_seq[pos] = inst;
   m_flag_array[pos] = 0;
+  if (m_num_nops) spliceNopRuns(pos, 0, 1);
 }
 
 void cCPUMemory::Insert(int pos, const InstructionSequence& genome)
@@ -115,11 +134,13 @@ void cCPUMemory::Insert(int pos, const InstructionSequence& genome)
   assert(pos >= 0);
   assert(pos <= m_seq.GetSize());
 
+  if (m_num_nops && !m_runs_stale) syncNopRuns();
   prepareInsert(pos, genome.GetSize());
   for (int i = 0; i < genome.GetSize(); i++) {
     m_seq[i + pos] = genome[i];
     m_flag_array[i + pos] = 0;
   }
+  if (m_num_nops) spliceNopRuns(pos, 0, genome.GetSize());
 }
 
 void cCPUMemory::Remove(int pos, int num_sites)
@@ -128,12 +149,9 @@ void cCPUMemory::Remove(int pos, int num_sites)
   assert(pos >= 0);                         // Removal must be in genome.
   assert(pos + num_sites <= m_active_size); // Cannot extend past end of genome.
 
-  const int new_size = m_active_size - num_sites;
-  for (int i = pos; i < new_size; i++) {
-    m_seq[i] = m_seq[i + num_sites];
-    m_flag_array[i] = m_flag_array[i + num_sites];
-  }
-  adjustCapacity(new_size);
+  if (m_num_nops && !m_runs_stale) syncNopRuns();
+  removeSites(pos, num_sites);
+  if (m_num_nops) spliceNopRuns(pos, num_sites, 0);
 }
 
 void cCPUMemory::Replace(int pos, int num_sites, const InstructionSequence& genome)
@@ -143,22 +161,25 @@ void cCPUMemory::Replace(int pos, int num_sites, const InstructionSequence& geno
   assert(pos + num_sites <= m_active_size); // Cannot extend past end!
   
   const int size_change = genome.GetSize() - num_sites;
+  if (m_num_nops && !m_runs_stale) syncNopRuns();
   
   // First, get the size right
   if (size_change > 0) prepareInsert(pos, size_change);
-  else if (size_change < 0) Remove(pos, -size_change);
+  else if (size_change < 0) removeSites(pos, -size_change);
   
   // Now just copy everything over!
   for (int i = 0; i < genome.GetSize(); i++) {
     m_seq[i + pos] = genome[i];
     m_flag_array[i + pos] = 0;
   }
+  if (m_num_nops) spliceNopRuns(pos, num_sites, genome.GetSize());
 }
 
 
 void cCPUMemory::operator=(const cCPUMemory& other_memory)
 {
   adjustCapacity(other_memory.m_active_size);
+  m_runs_stale = true;
   
   // Fill in the new information...
   for (int i = 0; i < m_active_size; i++) {
@@ -171,6 +192,7 @@ void cCPUMemory::operator=(const cCPUMemory& other_memory)
 void cCPUMemory::operator=(const InstructionSequence& other_genome)
 {
   adjustCapacity(other_genome.GetSize());
+  m_runs_stale = true;
   
   // Fill in the new information...
   for (int i = 0; i < m_active_size; i++) {
@@ -179,3 +201,250 @@ void cCPUMemory::operator=(const InstructionSequence& other_genome)
   }
 }
 
+
+void cCPUMemory::EnableNopIndex(int num_nops)
+{
+  assert(num_nops > 0);
+  m_num_nops = num_nops;
+  m_runs_stale = true;
+}
+
+
+int cCPUMemory::FindNopRun(int pos) const
+{
+  syncNopRuns();
+  
+  // Binary search for the first run ending after pos
+  int lo = 0;
+  int hi = m_run_end.GetSize();
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (m_run_end[mid] > pos) hi = mid;
+    else lo = mid + 1;
+  }
+  return lo;
+}
+
+
+int cCPUMemory::FindNopRunBefore(int pos) const
+{
+  syncNopRuns();
+  
+  // Binary search for the first run starting at or after pos, the one before it is the answer
+  int lo = 0;
+  int hi = m_run_start.GetSize();
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (m_run_start[mid] >= pos) hi = mid;
+    else lo = mid + 1;
+  }
+  return lo - 1;
+}
+
+
+void cCPUMemory::syncNopRuns() const
+{
+  assert(m_num_nops > 0);
+  
+  if (m_runs_stale) {
+    rebuildNopRuns();
+    return;
+  }
+  
+  for (int i = 0; i < m_dirty_sites.GetSize(); i++) {
+    if (m_dirty_sites[i] < m_active_size) updateNopRunsAt(m_dirty_sites[i]);
+  }
+  m_dirty_sites.Resize(0);
+}
+
+
+void cCPUMemory::rebuildNopRuns() const
+{
+  m_run_start.Resize(0);
+  m_run_end.Resize(0);
+  
+  int pos = 0;
+  while (pos < m_active_size) {
+    if (m_seq[pos].GetOp() >= m_num_nops) {
+      pos++;
+      continue;
+    }
+    m_run_start.Push(pos);
+    while (pos < m_active_size && m_seq[pos].GetOp() < m_num_nops) pos++;
+    m_run_end.Push(pos);
+  }
+  
+  m_dirty_sites.Resize(0);
+  m_runs_stale = false;
+}
+
+
+// Bring the runs up to date with the current contents of a single site
+void cCPUMemory::updateNopRunsAt(int pos) const
+{
+  const bool is_nop = (m_seq[pos].GetOp() < m_num_nops);
+  
+  int lo = 0;
+  int hi = m_run_end.GetSize();
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (m_run_end[mid] > pos) hi = mid;
+    else lo = mid + 1;
+  }
+  const int run = lo;
+  const int num_runs = m_run_start.GetSize();
+  const bool in_run = (run < num_runs && m_run_start[run] <= pos);
+  if (is_nop == in_run) return;
+  
+  if (is_nop) {
+    const bool join_prev = (run > 0 && m_run_end[run - 1] == pos);
+    const bool join_next = (run < num_runs && m_run_start[run] == pos + 1);
+    if (join_prev && join_next) {
+      // Site bridges two runs, merge them
+      m_run_end[run - 1] = m_run_end[run];
+      for (int i = run; i < num_runs - 1; i++) {
+        m_run_start[i] = m_run_start[i + 1];
+        m_run_end[i] = m_run_end[i + 1];
+      }
+      m_run_start.Resize(num_runs - 1);
+      m_run_end.Resize(num_runs - 1);
+    } else if (join_prev) {
+      m_run_end[run - 1] = pos + 1;
+    } else if (join_next) {
+      m_run_start[run] = pos;
+    } else {
+      m_run_start.Push(0);
+      m_run_end.Push(0);
+      for (int i = num_runs; i > run; i--) {
+        m_run_start[i] = m_run_start[i - 1];
+        m_run_end[i] = m_run_end[i - 1];
+      }
+      m_run_start[run] = pos;
+      m_run_end[run] = pos + 1;
+    }
+  } else {
+    const int start = m_run_start[run];
+    const int end = m_run_end[run];
+    if (start == pos && end == pos + 1) {
+      for (int i = run; i < num_runs - 1; i++) {
+        m_run_start[i] = m_run_start[i + 1];
+        m_run_end[i] = m_run_end[i + 1];
+      }
+      m_run_start.Resize(num_runs - 1);
+      m_run_end.Resize(num_runs - 1);
+    } else if (start == pos) {
+      m_run_start[run] = pos + 1;
+    } else if (end == pos + 1) {
+      m_run_end[run] = pos;
+    } else {
+      // Site splits the run in two
+      m_run_start.Push(0);
+      m_run_end.Push(0);
+      for (int i = num_runs; i > run + 1; i--) {
+        m_run_start[i] = m_run_start[i - 1];
+        m_run_end[i] = m_run_end[i - 1];
+      }
+      m_run_end[run] = pos;
+      m_run_start[run + 1] = pos + 1;
+      m_run_end[run + 1] = end;
+    }
+  }
+}
+
+
+// Replace the runs over [pos, pos + removed) of the previous contents with those of the inserted sites, now in
+// [pos, pos + inserted), shifting the runs that follow.  Pending sites must have been synced beforehand.
+void cCPUMemory::spliceNopRuns(int pos, int removed, int inserted)
+{
+  if (m_runs_stale) return;
+  
+  const int old_end = pos + removed;
+  const int delta = inserted - removed;
+  const int num_runs = m_run_start.GetSize();
+  
+  // Runs [first, last) touch the replaced range, including those merely adjacent to it
+  int first = 0;
+  while (first < num_runs && m_run_end[first] < pos) first++;
+  int last = first;
+  while (last < num_runs && m_run_start[last] <= old_end) last++;
+  
+  // Rebuild the runs of that stretch, merging adjacent pieces
+  m_splice_start.Resize(0);
+  m_splice_end.Resize(0);
+  int tail_start = -1;
+  int tail_end = -1;
+  for (int r = first; r < last; r++) {
+    if (m_run_start[r] < pos) {
+      m_splice_start.Push(m_run_start[r]);
+      m_splice_end.Push(Apto::Min(m_run_end[r], pos));
+    }
+    if (m_run_end[r] > old_end) {
+      tail_start = Apto::Max(m_run_start[r], old_end) + delta;
+      tail_end = m_run_end[r] + delta;
+    }
+  }
+  for (int i = pos; i < pos + inserted; i++) {
+    if (m_seq[i].GetOp() >= m_num_nops) continue;
+    const int n = m_splice_end.GetSize();
+    if (n && m_splice_end[n - 1] == i) m_splice_end[n - 1] = i + 1;
+    else {
+      m_splice_start.Push(i);
+      m_splice_end.Push(i + 1);
+    }
+  }
+  if (tail_start >= 0 && tail_end > tail_start) {
+    const int n = m_splice_end.GetSize();
+    if (n && m_splice_end[n - 1] == tail_start) m_splice_end[n - 1] = tail_end;
+    else {
+      m_splice_start.Push(tail_start);
+      m_splice_end.Push(tail_end);
+    }
+  }
+  
+  // Put the rebuilt stretch in place of the old one and shift the runs after it
+  const int new_count = m_splice_start.GetSize();
+  const int new_num_runs = num_runs - (last - first) + new_count;
+  if (new_num_runs > num_runs) {
+    m_run_start.Resize(new_num_runs);
+    m_run_end.Resize(new_num_runs);
+    for (int i = num_runs - 1; i >= last; i--) {
+      m_run_start[i - num_runs + new_num_runs] = m_run_start[i] + delta;
+      m_run_end[i - num_runs + new_num_runs] = m_run_end[i] + delta;
+    }
+  } else {
+    for (int i = last; i < num_runs; i++) {
+      m_run_start[i - num_runs + new_num_runs] = m_run_start[i] + delta;
+      m_run_end[i - num_runs + new_num_runs] = m_run_end[i] + delta;
+    }
+    m_run_start.Resize(new_num_runs);
+    m_run_end.Resize(new_num_runs);
+  }
+  for (int i = 0; i < new_count; i++) {
+    m_run_start[first + i] = m_splice_start[i];
+    m_run_end[first + i] = m_splice_end[i];
+  }
+}
+
+
+void cCPUMemory::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarUInt(m_active_size);
+  for (int i = 0; i < m_active_size; i++) buf.PutByte((unsigned char)m_seq[i].GetOp());
+  if (m_active_size) buf.PutBytes(&m_flag_array[0], m_active_size);
+}
+
+
+bool cCPUMemory::LoadState(cChunkBuffer& buf)
+{
+  const unsigned long long size = buf.GetVarUInt();
+  if (buf.Fail() || size > (unsigned long long)buf.GetRemaining()) return false;
+  
+  Reset((int)size);
+  for (int i = 0; i < m_active_size; i++) m_seq[i].SetOp(buf.GetByte());
+  const unsigned char* flags = buf.GetBytes(m_active_size);
+  if (m_active_size && !flags) return false;
+  for (int i = 0; i < m_active_size; i++) m_flag_array[i] = flags[i];
+  m_runs_stale = true;
+  
+  return !buf.Fail();
+}
@@ -25,6 +25,8 @@
 
 #include "avida/core/InstructionSequence.h"
 
+class cChunkBuffer;
+
 
 class cCPUMemory : public Avida::InstructionSequence
 {
@@ -38,17 +40,49 @@ private:
 	static const unsigned char MASK_UNUSED1  = 0x40; // unused bit
 	static const unsigned char MASK_UNUSED2  = 0x80; // unused bit
   
+  static const int MAX_DIRTY_SITES = 64;
+  
   Apto::Array<unsigned char> m_flag_array;
+  
+  // Optional index of the maximal runs of nops in memory, used by label and template searches.  Structural changes
+  // update it in place, sites handed out for writing are rechecked on the next query, and anything else (resizing,
+  // whole memory assignment, too many pending sites) has it rebuilt on the next query.
+  int m_num_nops;                                   // Opcodes below this are nops, 0 when the index is disabled
+  mutable bool m_runs_stale;
+  mutable Apto::Array<int, Apto::Smart> m_run_start;  // Sorted run bounds, [start, end)
+  mutable Apto::Array<int, Apto::Smart> m_run_end;
+  mutable Apto::Array<int, Apto::Smart> m_dirty_sites;
+  Apto::Array<int, Apto::Smart> m_splice_start;
+  Apto::Array<int, Apto::Smart> m_splice_end;
 
   void adjustCapacity(int new_size);
   void prepareInsert(int pos, int num_sites);
+  void removeSites(int pos, int num_sites);
+  
+  inline void markDirty(int pos)
+  {
+    if (m_runs_stale) return;
+    if (m_dirty_sites.GetSize() < MAX_DIRTY_SITES) m_dirty_sites.Push(pos);
+    else m_runs_stale = true;
+  }
+  void syncNopRuns() const;
+  void rebuildNopRuns() const;
+  void updateNopRunsAt(int pos) const;
+  void spliceNopRuns(int pos, int removed, int inserted);
 
 public:
   cCPUMemory(const cCPUMemory& in_memory);
-  cCPUMemory(const InstructionSequence& in_genome) : InstructionSequence(in_genome), m_flag_array(in_genome.GetSize()) { ; }
-  explicit cCPUMemory(int size = 1)  : InstructionSequence(size), m_flag_array(size) { ClearFlags(); }
-  cCPUMemory(const Apto::String& in_string) : InstructionSequence(in_string), m_flag_array(in_string.GetSize()) { ; }
+  cCPUMemory(const InstructionSequence& in_genome)
+    : InstructionSequence(in_genome), m_flag_array(in_genome.GetSize()), m_num_nops(0), m_runs_stale(true) { ; }
+  explicit cCPUMemory(int size = 1)
+    : InstructionSequence(size), m_flag_array(size), m_num_nops(0), m_runs_stale(true) { ClearFlags(); }
+  cCPUMemory(const Apto::String& in_string)
+    : InstructionSequence(in_string), m_flag_array(in_string.GetSize()), m_num_nops(0), m_runs_stale(true) { ; }
   ~cCPUMemory() { ; }
+  
+  // Sites handed out writable are rechecked by the nop index on its next query, read through const references if possible
+  inline Avida::Instruction& operator[](int idx) { if (m_num_nops) markDirty(idx); return InstructionSequence::operator[](idx); }
+  inline const Avida::Instruction& operator[](int idx) const { return InstructionSequence::operator[](idx); }
 
   inline bool FlagCopied(int pos) const     { return (MASK_COPIED   & m_flag_array[pos]) != 0; }
   inline bool FlagMutated(int pos) const    { return (MASK_MUTATED  & m_flag_array[pos]) != 0; }
@@ -74,6 +108,7 @@ public:
   
   void Clear()
 	{
+		m_runs_stale = true;
 		for (int i = 0; i < m_active_size; i++) {
 			m_seq[i].SetOp(0);
 			m_flag_array[i] = 0;
@@ -93,6 +128,25 @@ public:
 
   void operator=(const cCPUMemory& other_memory);
   void operator=(const InstructionSequence& other_genome);
+  
+  
+  // Nop Run Index
+  // Sites written through an InstructionSequence reference bypass the index, callers doing so must Resize (as slip
+  // mutations do) or call InvalidateNopIndex afterwards.  Run bounds are valid after FindNopRun or FindNopRunBefore
+  // until the memory is next modified.
+  void EnableNopIndex(int num_nops);
+  inline bool HasNopIndex() const { return m_num_nops > 0; }
+  inline void InvalidateNopIndex() { m_runs_stale = true; }
+  
+  int FindNopRun(int pos) const;        // First run ending after pos (containing or following it), or GetNumNopRuns()
+  int FindNopRunBefore(int pos) const;  // Last run starting before pos, or -1
+  inline int GetNumNopRuns() const { syncNopRuns(); return m_run_start.GetSize(); }
+  inline int GetNopRunStart(int run) const { return m_run_start[run]; }
+  inline int GetNopRunEnd(int run) const { return m_run_end[run]; }
+  
+  // Snapshot state: the instructions and their flags (the nop index is rebuilt on demand)
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
 };
 
 #endif
@@ -23,6 +23,7 @@
 #include "cCPUStack.h"
 
 #include <cassert>
+#include "cChunkedFile.h"
 #include "cString.h"
 
 using namespace std;
@@ -75,3 +76,16 @@ void cCPUStack::LoadState(istream & fp)
     Push(value);
   }
 }
+
+void cCPUStack::SaveState(cChunkBuffer& buf) const
+{
+  for (int i = 0; i < nHardware::STACK_SIZE; i++) buf.PutVarInt(stack[i]);
+  buf.PutByte(stack_pointer);
+}
+
+bool cCPUStack::LoadState(cChunkBuffer& buf)
+{
+  for (int i = 0; i < nHardware::STACK_SIZE; i++) stack[i] = (int)buf.GetVarInt();
+  stack_pointer = buf.GetByte();
+  return !buf.Fail() && stack_pointer < nHardware::STACK_SIZE;
+}
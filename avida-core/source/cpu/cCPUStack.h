@@ -29,6 +29,8 @@
 #include "nHardware.h"
 #endif
 
+class cChunkBuffer;
+
 class cCPUStack
 {
 private:
@@ -53,6 +55,8 @@ public:
 
   void SaveState(std::ostream& fp);
   void LoadState(std::istream & fp);
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
 };
 
 
@@ -46,6 +46,7 @@ enum eTestCPUResourceMethod { RES_INITIAL = 0, RES_CONSTANT, RES_UPDATED_DEPLETA
 class cCPUTestInfo
 {
   friend class cTestCPU;
+  friend class cTestCPUCheckpoints;
 private:
   // Inputs...
   int generation_tests; // Maximum depth in generations to test
@@ -82,6 +83,10 @@ public:
   ~cCPUTestInfo();
 
   void Clear();
+  
+  // Copy the test configuration (inputs, tracer, mutation rates, resources) without any results or test organisms.
+  // Both test infos must have been constructed with the same number of generation tests.
+  void CopySettings(const cCPUTestInfo& test_info);
  
   // Input Setup
   void TraceTaskOrder(bool _trace=true) { trace_task_order = _trace; }
@@ -101,7 +106,7 @@ public:
   bool GetUseRandomInputs() const { return use_random_inputs; }
 	bool GetUseManualInputs() const { return use_manual_inputs; }
 	const Apto::Array<int>& GetTestCPUInputs() const { return used_inputs; }
-  HardwareTracerPtr GetTracer() { return m_tracer; }
+  HardwareTracerPtr GetTracer() const { return m_tracer; }
 
 
   // Output Accessors
@@ -22,6 +22,8 @@
 
 #include "cCodeLabel.h"
 
+#include "cChunkedFile.h"
+
 
 #include <cmath>
 #include <vector>
@@ -215,3 +217,18 @@ int cCodeLabel::AsIntPolynomialCoefficent(const int base) const
 
   return value;
 }
+
+void cCodeLabel::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarUInt(m_nops.GetSize());
+  for (int i = 0; i < m_nops.GetSize(); i++) buf.PutByte((unsigned char)m_nops[i]);
+}
+
+bool cCodeLabel::LoadState(cChunkBuffer& buf)
+{
+  const unsigned long long size = buf.GetVarUInt();
+  if (buf.Fail() || size > (unsigned long long)MAX_LENGTH) return false;
+  m_nops.Resize((int)size);
+  for (int i = 0; i < m_nops.GetSize(); i++) m_nops[i] = (char)buf.GetByte();
+  return !buf.Fail();
+}
@@ -28,6 +28,8 @@
 #include "cString.h"
 #include "nHardware.h"
 
+class cChunkBuffer;
+
 /**
  * The cCodeLabel class is used to identify a label within the genotype of
  * a creature, and aid in its manipulation.
@@ -53,6 +55,9 @@ public:
 
   void ReadString(const cString& label_str);
   
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
+  
   int FindSublabel(const cCodeLabel& sub_label) const;
   inline bool Contains(const cCodeLabel& sub_label) const { return (FindSublabel(sub_label) >= 0); }
 
@@ -29,6 +29,7 @@
 #include "avida/output/File.h"
 
 #include "cAvidaContext.h"
+#include "cChunkedFile.h"
 #include "cHardwareManager.h"
 #include "cHardwareTracer.h"
 #include "cInstSet.h"
@@ -432,6 +433,212 @@ void cHardwareBCR::Thread::Reset(cHardwareBCR* in_hardware, const Head& start_po
 }
 
 
+static void saveLookInit(cChunkBuffer& buf, const cOrgSensor::sLookInit& look)
+{
+  buf.PutVarInt(look.habitat);
+  buf.PutVarInt(look.distance);
+  buf.PutVarInt(look.search_type);
+  buf.PutVarInt(look.id_sought);
+}
+
+static void loadLookInit(cChunkBuffer& buf, cOrgSensor::sLookInit& look)
+{
+  look.habitat = (int)buf.GetVarInt();
+  look.distance = (int)buf.GetVarInt();
+  look.search_type = (int)buf.GetVarInt();
+  look.id_sought = (int)buf.GetVarInt();
+}
+
+
+void cHardwareBCR::DataValue::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarInt(value);
+  buf.PutVarUInt(originated);
+  buf.PutVarUInt(oldest_component);
+  buf.PutByte(from_env | (env_component << 1));
+}
+
+void cHardwareBCR::DataValue::LoadState(cChunkBuffer& buf)
+{
+  value = (int)buf.GetVarInt();
+  originated = (unsigned int)buf.GetVarUInt();
+  oldest_component = (unsigned int)buf.GetVarUInt();
+  const unsigned char flags = buf.GetByte();
+  from_env = flags & 1;
+  env_component = (flags >> 1) & 1;
+}
+
+
+void cHardwareBCR::Head::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarInt(m_pos);
+  buf.PutVarUInt(m_ms);
+  buf.PutBool(m_is_gene);
+}
+
+bool cHardwareBCR::Head::LoadState(cChunkBuffer& buf, cHardwareBCR* hw)
+{
+  m_hw = hw;
+  m_pos = (int)buf.GetVarInt();
+  const unsigned int ms = (unsigned int)buf.GetVarUInt();
+  m_is_gene = buf.GetBool();
+  if (buf.Fail()) return false;
+  m_ms = ms;
+  return (int)ms < (m_is_gene ? hw->m_genes.GetSize() : hw->m_mem_array.GetSize());
+}
+
+
+void cHardwareBCR::Stack::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarUInt(m_sz);
+  buf.PutVarUInt(m_sp);
+  for (int i = 0; i < m_sz; i++) m_stack[i].SaveState(buf);
+}
+
+bool cHardwareBCR::Stack::LoadState(cChunkBuffer& buf)
+{
+  const int sz = (int)buf.GetVarUInt();
+  const int sp = (int)buf.GetVarUInt();
+  if (buf.Fail() || sz < 1 || sz > buf.GetRemaining() || sp >= sz) return false;
+  Clear(sz);
+  m_sp = sp;
+  for (int i = 0; i < m_sz; i++) m_stack[i].LoadState(buf);
+  return !buf.Fail();
+}
+
+
+void cHardwareBCR::Thread::SaveState(cChunkBuffer& buf) const
+{
+  thread_label.SaveState(buf);
+  for (int i = 0; i < NUM_REGISTERS; i++) reg[i].SaveState(buf);
+  for (int i = 0; i < NUM_HEADS; i++) heads[i].SaveState(buf);
+  stack.SaveState(buf);
+  
+  buf.PutByte(cur_stack);
+  buf.PutBool(reading_label);
+  buf.PutBool(reading_seq);
+  buf.PutBool(running);
+  buf.PutBool(active);
+  buf.PutBool(wait_greater);
+  buf.PutBool(wait_equal);
+  buf.PutBool(wait_less);
+  buf.PutVarInt(wait_reg);
+  buf.PutByte(wait_dst);
+  buf.PutVarInt(wait_value);
+  
+  read_label.SaveState(buf);
+  read_seq.SaveState(buf);
+  next_label.SaveState(buf);
+  saveLookInit(buf, sensor_session);
+}
+
+bool cHardwareBCR::Thread::LoadState(cChunkBuffer& buf, cHardwareBCR* in_hardware)
+{
+  if (!thread_label.LoadState(buf)) return false;
+  for (int i = 0; i < NUM_REGISTERS; i++) reg[i].LoadState(buf);
+  for (int i = 0; i < NUM_HEADS; i++) if (!heads[i].LoadState(buf, in_hardware)) return false;
+  if (!stack.LoadState(buf)) return false;
+  
+  cur_stack = buf.GetByte();
+  reading_label = buf.GetBool();
+  reading_seq = buf.GetBool();
+  running = buf.GetBool();
+  active = buf.GetBool();
+  wait_greater = buf.GetBool();
+  wait_equal = buf.GetBool();
+  wait_less = buf.GetBool();
+  wait_reg = (int)buf.GetVarInt();
+  wait_dst = buf.GetByte();
+  wait_value = (int)buf.GetVarInt();
+  
+  if (!read_label.LoadState(buf) || !read_seq.LoadState(buf) || !next_label.LoadState(buf)) return false;
+  loadLookInit(buf, sensor_session);
+  return !buf.Fail();
+}
+
+
+void cHardwareBCR::SaveState(cChunkBuffer& buf) const
+{
+  saveBaseState(buf);
+  
+  buf.PutVarUInt(m_mem_array.GetSize());
+  for (int i = 0; i < m_mem_array.GetSize(); i++) m_mem_array[i].SaveState(buf);
+  for (int i = 0; i < MAX_MEM_SPACES; i++) buf.PutVarInt(m_mem_ids[i]);
+  buf.PutVarUInt(m_genes.GetSize());
+  for (int i = 0; i < m_genes.GetSize(); i++) {
+    m_genes[i].memory.SaveState(buf);
+    m_genes[i].label.SaveState(buf);
+    buf.PutVarInt(m_genes[i].thread_id);
+  }
+  
+  m_global_stack.SaveState(buf);
+  buf.PutVarUInt(m_threads.GetSize());
+  for (int i = 0; i < m_threads.GetSize(); i++) m_threads[i].SaveState(buf);
+  buf.PutVarInt(m_cur_thread);
+  buf.PutVarUInt(m_waiting_threads);
+  buf.PutVarUInt(m_running_threads);
+  
+  m_sensor.SaveState(buf);
+  buf.PutVarUInt(m_sensor_sessions.GetSize());
+  for (int i = 0; i < m_sensor_sessions.GetSize(); i++) saveLookInit(buf, m_sensor_sessions[i]);
+  
+  buf.PutVarUInt(m_cycle_count);
+  buf.PutVarUInt(m_last_output);
+  buf.PutVarUInt(m_cur_uop);
+  buf.PutVarInt(m_cur_offspring);
+  buf.PutBool(m_advance_ip);
+  buf.PutBool(m_spec_stall);
+  buf.PutBool(m_spec_die);
+  for (int i = 0; i < NUM_BEHAVIORS; i++) buf.PutBool(m_behav_class_used[i]);
+}
+
+bool cHardwareBCR::LoadState(cChunkBuffer& buf)
+{
+  if (!loadBaseState(buf)) return false;
+  
+  // Memory spaces and genes first, so that the heads are restored against them
+  const int num_mem = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_mem < 1 || num_mem > MAX_MEM_SPACES) return false;
+  m_mem_array.Resize(num_mem);
+  for (int i = 0; i < num_mem; i++) if (!m_mem_array[i].LoadState(buf)) return false;
+  for (int i = 0; i < MAX_MEM_SPACES; i++) {
+    m_mem_ids[i] = (char)buf.GetVarInt();
+    if (m_mem_ids[i] >= num_mem) return false;
+  }
+  const int num_genes = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_genes > buf.GetRemaining()) return false;
+  m_genes.Resize(num_genes);
+  for (int i = 0; i < num_genes; i++) {
+    if (!m_genes[i].memory.LoadState(buf) || !m_genes[i].label.LoadState(buf)) return false;
+    m_genes[i].thread_id = (int)buf.GetVarInt();
+  }
+  
+  if (!m_global_stack.LoadState(buf)) return false;
+  const int num_threads = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_threads > buf.GetRemaining()) return false;
+  m_threads.Resize(num_threads);
+  for (int i = 0; i < num_threads; i++) if (!m_threads[i].LoadState(buf, this)) return false;
+  m_cur_thread = (int)buf.GetVarInt();
+  m_waiting_threads = (unsigned int)buf.GetVarUInt();
+  m_running_threads = (unsigned int)buf.GetVarUInt();
+  
+  if (!m_sensor.LoadState(buf)) return false;
+  if ((int)buf.GetVarUInt() != m_sensor_sessions.GetSize()) return false;
+  for (int i = 0; i < m_sensor_sessions.GetSize(); i++) loadLookInit(buf, m_sensor_sessions[i]);
+  
+  m_cycle_count = (unsigned int)buf.GetVarUInt();
+  m_last_output = (unsigned int)buf.GetVarUInt();
+  m_cur_uop = (unsigned int)buf.GetVarUInt();
+  m_cur_offspring = (int)buf.GetVarInt();
+  m_advance_ip = buf.GetBool();
+  m_spec_stall = buf.GetBool();
+  m_spec_die = buf.GetBool();
+  for (int i = 0; i < NUM_BEHAVIORS; i++) m_behav_class_used[i] = buf.GetBool();
+  
+  return !buf.Fail();
+}
+
+
 bool cHardwareBCR::SingleProcess(cAvidaContext& ctx, bool speculative)
 {
   // If speculatively stalled, stay that way until a real instruction comes
@@ -829,6 +1036,23 @@ void cHardwareBCR::FindLabelStart(Head& head, Head& default_pos, bool mark_execu
   }
   
   cCPUMemory& memory = head.GetMemory();
+  
+  if (useNopIndex(memory)) {
+    const int label_pos = findLabelInst(memory, search_label, -1);
+    if (label_pos < 0) {
+      head.Set(default_pos);
+      return;
+    }
+    
+    const int size_matched = search_label.GetSize() + 1; // Include the label instruction
+    if (mark_executed) {
+      const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
+      for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(label_pos + i);
+    }
+    head.SetPosition(label_pos + size_matched - 1);
+    return;
+  }
+  
   int pos = 0;
   
   while (pos < memory.GetSize()) {
@@ -878,6 +1102,23 @@ void cHardwareBCR::FindNopSequenceStart(Head& head, Head& default_pos, bool mark
   }
   
   cCPUMemory& memory = head.GetMemory();
+  
+  if (useNopIndex(memory)) {
+    const int start = findNopSequence(memory, search_label, -1);
+    if (start < 0) {
+      head.Set(default_pos);
+      return;
+    }
+    
+    const int size_matched = search_label.GetSize();
+    if (mark_executed) {
+      const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
+      for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(start + i);
+    }
+    head.SetPosition(start + size_matched - 1);
+    return;
+  }
+  
   int pos = 0;
   
   while (pos < memory.GetSize()) {
@@ -926,6 +1167,30 @@ void cHardwareBCR::FindLabelForward(Head& head, Head& default_pos, bool mark_exe
   head.Adjust();
   
   Head pos(head);
+  
+  if (useNopIndex(head.GetMemory())) {
+    const int label_start = findLabelInst(head.GetMemory(), search_label, head.Position());
+    if (label_start < 0) {
+      head.Set(default_pos);
+      return;
+    }
+    
+    // Step over the label as the scan does, so the returned head wraps the same way
+    const int size_matched = search_label.GetSize();
+    pos.SetPosition(label_start);
+    for (int i = 0; i <= size_matched; i++) pos++;
+    pos--;
+    const int found_pos = pos.Position();
+    
+    if (mark_executed) {
+      pos.SetPosition(label_start);
+      const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
+      for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
+    }
+    head.SetPosition(found_pos);
+    return;
+  }
+  
   pos++;
   
   while (pos.Position() != head.Position()) {
@@ -1037,6 +1302,30 @@ void cHardwareBCR::FindNopSequenceForward(Head& head, Head& default_pos, bool ma
   head.Adjust();
   
   Head pos(head);
+  
+  if (useNopIndex(head.GetMemory())) {
+    const int label_start = findNopSequence(head.GetMemory(), search_label, head.Position());
+    if (label_start < 0) {
+      head.Set(default_pos);
+      return;
+    }
+    
+    // Step over the sequence as the scan does, so the returned head wraps the same way
+    const int size_matched = search_label.GetSize();
+    pos.SetPosition(label_start);
+    for (int i = 0; i < size_matched; i++) pos++;
+    pos--;
+    const int found_pos = pos.Position();
+    
+    if (mark_executed) {
+      pos.SetPosition(label_start);
+      const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
+      for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
+    }
+    head.SetPosition(found_pos);
+    return;
+  }
+  
   pos++;
   
   while (pos.Position() != head.Position()) {
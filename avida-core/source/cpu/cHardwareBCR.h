@@ -84,6 +84,9 @@ private:
     inline DataValue() { Clear(); }
     inline void Clear() { value = 0; originated = 0; from_env = 0, oldest_component = 0; env_component = 0; }
     inline DataValue& operator=(const DataValue& i);
+    
+    void SaveState(cChunkBuffer& buf) const;
+    void LoadState(cChunkBuffer& buf);
   };
   
   class Head
@@ -103,7 +106,11 @@ private:
     inline void Reset(cHardwareBCR* hw, int pos, unsigned int ms, bool is_gene)
       { m_hw = hw; m_pos = pos; m_ms = ms; m_is_gene = is_gene; }
     
+    void SaveState(cChunkBuffer& buf) const;
+    bool LoadState(cChunkBuffer& buf, cHardwareBCR* hw);  // Memory spaces and genes of hw must already be restored
+    
     inline cCPUMemory& GetMemory() { return (m_is_gene) ? m_hw->m_genes[m_ms].memory : m_hw->m_mem_array[m_ms]; }
+    inline const cCPUMemory& GetMemory() const { return (m_is_gene) ? m_hw->m_genes[m_ms].memory : m_hw->m_mem_array[m_ms]; }
     
     inline void Adjust();
     
@@ -122,8 +129,8 @@ private:
     
     inline void Advance() { m_pos++; Adjust(); }
     
-    inline const Instruction& GetInst() { return GetMemory()[m_pos]; }
-    inline const Instruction& GetInst(int offset) { return GetMemory()[m_pos + offset]; }
+    inline const Instruction& GetInst() const { return GetMemory()[m_pos]; }
+    inline const Instruction& GetInst(int offset) const { return GetMemory()[m_pos + offset]; }
     inline Instruction NextInst();
     inline Instruction PrevInst();
     
@@ -179,6 +186,9 @@ private:
     inline const DataValue& Peek() const { return m_stack[(int)m_sp]; }
     inline const DataValue& Get(int d = 0) const { assert(d >= 0); int p = d + m_sp; return m_stack[(p >= m_sz) ? (p - m_sz) : p]; }
     inline void Clear(int sz) { delete [] m_stack; m_sz = sz; m_stack = new DataValue[sz]; }
+    
+    void SaveState(cChunkBuffer& buf) const;
+    bool LoadState(cChunkBuffer& buf);
   };
   
   
@@ -217,6 +227,8 @@ private:
     inline ~Thread() { ; }
     
     void Reset(cHardwareBCR* in_hardware, const Head& start_pos);
+    void SaveState(cChunkBuffer& buf) const;
+    bool LoadState(cChunkBuffer& buf, cHardwareBCR* in_hardware);
     
   private:
     Thread(const Thread& thread);
@@ -300,6 +312,8 @@ public:
   // --------  Helper Methods  --------
   int GetType() const { return HARDWARE_TYPE_CPU_BCR; }
   bool SupportsSpeculative() const { return true; }
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
   void PrintStatus(std::ostream& fp);
   void SetupMiniTraceFileHeader(Avida::Output::File& df, const int gen_id, const Apto::String& genotype);
   void PrintMiniTraceStatus(cAvidaContext& ctx, std::ostream& fp);
@@ -703,12 +717,14 @@ inline bool cHardwareBCR::Head::operator==(const Head& rhs) const
 
 inline Instruction cHardwareBCR::Head::PrevInst()
 {
-  return (AtFront()) ? GetMemory()[GetMemory().GetSize() - 1] : GetMemory()[m_pos - 1];
+  const cCPUMemory& memory = GetMemory();
+  return (AtFront()) ? memory[memory.GetSize() - 1] : memory[m_pos - 1];
 }
 
 inline Instruction cHardwareBCR::Head::NextInst()
 {
-  return (AtEnd()) ? m_hw->GetInstSet().GetInstError() : GetMemory()[m_pos + 1];
+  const cCPUMemory& memory = GetMemory();
+  return (AtEnd()) ? m_hw->GetInstSet().GetInstError() : memory[m_pos + 1];
 }
 
 
@@ -26,7 +26,9 @@
 #include "avida/core/WorldDriver.h"
 
 #include "cAvidaContext.h"
+#include "cChunkedFile.h"
 #include "cCodeLabel.h"
+#include "cCPUMemory.h"
 #include "cCPUTestInfo.h"
 #include "cEnvironment.h"
 #include "cHardwareManager.h"
@@ -47,7 +49,7 @@ using namespace AvidaTools;
 
 
 cHardwareBase::cHardwareBase(cWorld* world, cOrganism* in_organism, cInstSet* inst_set)
-: m_world(world), m_organism(in_organism), m_inst_set(inst_set), m_tracer(NULL)
+: m_world(world), m_organism(in_organism), m_inst_set(inst_set), m_tracer(NULL), m_checkpoints(NULL)
 , m_minitrace(false), m_microtrace(false), m_topnavtrace(false), m_reprotrace(false)
 , m_has_costs(inst_set->HasCosts()), m_has_ft_costs(inst_set->HasFTCosts()) , m_has_energy_costs(m_inst_set->HasEnergyCosts())
 , m_has_res_costs(m_inst_set->HasResCosts()), m_has_fem_res_costs(m_inst_set->HasFemResCosts())
@@ -119,6 +121,25 @@ void cHardwareBase::Reset(cAvidaContext& ctx)
   internalReset();
 }
 
+// Rebinds pooled hardware to a newly born organism, leaving it in the same state the constructor would have
+void cHardwareBase::Recycle(cAvidaContext& ctx, cOrganism* in_organism)
+{
+  assert(SupportsRecycle());
+  assert(in_organism != NULL);
+  
+  m_organism = in_organism;
+  m_tracer = HardwareTracerPtr(NULL);
+  m_checkpoints = NULL;
+  m_minitrace = false;
+  m_microtrace = false;
+  m_topnavtrace = false;
+  m_reprotrace = false;
+  m_task_switching_cost = 0;
+  m_ext_mem.Resize(0);
+  
+  internalRecycle(ctx);
+}
+
 void cHardwareBase::ResizeCostArrays(int new_size)
 {
   m_active_thread_costs.Resize(new_size);
@@ -127,6 +148,28 @@ void cHardwareBase::ResizeCostArrays(int new_size)
   m_active_thread_post_costs.SetAll(0);
 }
 
+void cHardwareBase::saveBaseState(cChunkBuffer& buf) const
+{
+  buf.PutVarInt(m_inst_cost);
+  buf.PutVarInt(m_female_cost);
+  buf.PutVarInt(m_task_switching_cost);
+  buf.PutIntArray(m_inst_ft_cost);
+  buf.PutIntArray(m_active_thread_costs);
+  buf.PutIntArray(m_active_thread_post_costs);
+  buf.PutIntArray(m_ext_mem);
+}
+
+bool cHardwareBase::loadBaseState(cChunkBuffer& buf)
+{
+  m_inst_cost = (int)buf.GetVarInt();
+  m_female_cost = (int)buf.GetVarInt();
+  m_task_switching_cost = (int)buf.GetVarInt();
+  const int ft_size = m_inst_ft_cost.GetSize();
+  if (!buf.GetIntArray(m_inst_ft_cost) || m_inst_ft_cost.GetSize() != ft_size) return false;
+  if (!buf.GetIntArray(m_active_thread_costs) || !buf.GetIntArray(m_active_thread_post_costs)) return false;
+  return buf.GetIntArray(m_ext_mem);
+}
+
 int cHardwareBase::calcExecutedSize(const int parent_size)
 {
   int executed_size = 0;
@@ -816,6 +859,82 @@ void cHardwareBase::doLGTMutation(cAvidaContext& ctx, InstructionSequence& genom
 
 
 
+bool cHardwareBase::useNopIndex(cCPUMemory& memory) const
+{
+  if (!memory.HasNopIndex() && m_inst_set->GetNumNops()) memory.EnableNopIndex(m_inst_set->GetNumNops());
+  return memory.HasNopIndex();
+}
+
+// Label instructions are never nops, so any one followed by a nop sits just before the start of a nop run (or last in
+// memory, before the run starting the memory).  Visit the runs in the order the scan would reach their label site.
+int cHardwareBase::findLabelInst(const cCPUMemory& memory, const cCodeLabel& label, int origin) const
+{
+  const int size = memory.GetSize();
+  const int num_runs = memory.GetNumNopRuns();
+  const int first_run = (origin < 0) ? 0 : memory.FindNopRunBefore(origin + 2) + 1;
+  
+  for (int i = 0; i < num_runs; i++) {
+    const int run = (first_run + i) % num_runs;
+    int pos = memory.GetNopRunStart(run);
+    if (origin < 0 && pos == 0) continue;
+    
+    const int label_pos = (pos > 0) ? pos - 1 : size - 1;
+    if (label_pos == origin || !m_inst_set->IsLabel(memory[label_pos])) continue;
+    if (matchNopSequence(memory, label, pos, origin) == label.GetSize()) return label_pos;
+  }
+  
+  return -1;
+}
+
+// Attempts start at each nop reached, and after a failed one the scan resumes just past the site that ended it
+int cHardwareBase::findNopSequence(const cCPUMemory& memory, const cCodeLabel& label, int origin) const
+{
+  const int size = memory.GetSize();
+  const int num_runs = memory.GetNumNopRuns();
+  
+  int pos = (origin + 1 < size) ? origin + 1 : 0;
+  int remaining = (origin < 0) ? size : size - 1;  // Sites left before the scan reaches the origin or end of memory
+  while (remaining > 0) {
+    // Skip ahead to the next nop
+    const int run = memory.FindNopRun(pos);
+    if (run == num_runs) {
+      if (origin < 0 || size - pos >= remaining) return -1;
+      remaining -= size - pos;
+      pos = 0;
+      continue;
+    }
+    const int start = Apto::Max(memory.GetNopRunStart(run), pos);
+    if (start - pos >= remaining) return -1;
+    remaining -= start - pos;
+    pos = start;
+    
+    const int seq_start = pos;
+    const int matched = matchNopSequence(memory, label, pos, origin);
+    if (matched == label.GetSize()) return seq_start;
+    
+    if (matched >= remaining) return -1;
+    remaining -= matched + 1;
+    if (++pos >= size) pos = 0;
+  }
+  
+  return -1;
+}
+
+// Count the nops matching label from pos, leaving pos at the first site that did not match
+int cHardwareBase::matchNopSequence(const cCPUMemory& memory, const cCodeLabel& label, int& pos, int origin) const
+{
+  const int size = memory.GetSize();
+  int matched = 0;
+  while (matched < label.GetSize() && pos != origin && pos < size) {
+    if (!m_inst_set->IsNop(memory[pos]) || label[matched] != m_inst_set->GetNopMod(memory[pos])) break;
+    matched++;
+    if (++pos == size && origin >= 0) pos = 0;
+  }
+  return matched;
+}
+
+
+
 
 /*
  Return the number of mutations that occur on divide.  AWC 06/29/06
@@ -36,18 +36,28 @@
 #include "tBuffer.h"
 
 class cAvidaContext;
+class cChunkBuffer;
 class cCodeLabel;
 class cCPUMemory;
 class cHeadCPU;
 class cMutation;
 class cOrganism;
 class cString;
+class cTestCPUCheckpoints;
 class cWorld;
 
 using namespace std;
 using namespace Avida;
 
 
+// Saved execution state of a hardware instance, see cHardwareBase::SaveCheckpoint
+class cHardwareCheckpoint
+{
+public:
+  virtual ~cHardwareCheckpoint() { ; }
+};
+
+
 class cHardwareBase
 {
 protected:
@@ -56,6 +66,7 @@ protected:
   cInstSet* m_inst_set;             // Instruction set being used.
 
   HardwareTracerPtr m_tracer;        // Set this if you want execution traced.
+  cTestCPUCheckpoints* m_checkpoints; // Set while the test CPU records a gestation for mutational scans.
   Apto::Array<char, Apto::Smart> m_microtracer;
   Apto::Array<int, Apto::Smart> m_navtraceloc;
   Apto::Array<int, Apto::Smart> m_navtracefacing;
@@ -133,6 +144,7 @@ public:
 
   // --------  Core Functionality  --------
   void Reset(cAvidaContext& ctx);
+  void Recycle(cAvidaContext& ctx, cOrganism* in_organism);
   virtual bool SingleProcess(cAvidaContext& ctx, bool speculative = false) = 0;
   virtual void ProcessBonusInst(cAvidaContext& ctx, const Instruction& inst) = 0;
 
@@ -142,6 +154,7 @@ public:
   // --------  Helper methods  --------
   virtual int GetType() const = 0;
   virtual bool SupportsSpeculative() const = 0;
+  virtual bool SupportsRecycle() const { return false; }
   virtual void PrintStatus(std::ostream& fp) = 0;
   virtual void PrintMiniTraceStatus(cAvidaContext& ctx, std::ostream& fp) = 0;
   virtual void PrintMiniTraceSuccess(std::ostream& fp, const int exec_success) = 0;
@@ -164,6 +177,20 @@ public:
   void SetupExtendedMemory(const Apto::Array<int, Apto::Smart>& ext_mem) { m_ext_mem = ext_mem; }
   void PrintMiniTraceReactions();
   
+  // --------  Checkpoints  --------
+  // Hardware that supports checkpoints reports every use of its memory to the recorder, and can save and restore its
+  // complete execution state.  Support may depend on the instruction set and configuration.
+  virtual bool SupportsCheckpoint() const { return false; }
+  virtual cHardwareCheckpoint* SaveCheckpoint() const { assert(false); return NULL; }
+  virtual void RestoreCheckpoint(const cHardwareCheckpoint& checkpoint) { (void)checkpoint; assert(false); }
+  void SetCheckpointRecorder(cTestCPUCheckpoints* recorder) { m_checkpoints = recorder; }
+
+  // --------  Snapshots  --------
+  // Complete execution state, for world snapshots.  State is loaded into hardware built for the same genome and
+  // instruction set; tracing is not saved.  LoadState returns false if the saved state does not fit this hardware.
+  virtual void SaveState(cChunkBuffer& buf) const = 0;
+  virtual bool LoadState(cChunkBuffer& buf) = 0;
+  
   // --------  Stack Manipulation...  --------
   virtual int GetStack(int depth = 0, int stack_id = -1, int in_thread = -1) const = 0;
   virtual int GetCurStack(int in_thread_id = -1) const { (void)in_thread_id; return -1; }
@@ -244,6 +271,8 @@ public:
   
 protected:
   void ResizeCostArrays(int new_size);
+  void saveBaseState(cChunkBuffer& buf) const;  // Cost counters and extended memory, for SaveState/LoadState
+  bool loadBaseState(cChunkBuffer& buf);
 
   // --------  Core Execution Methods  --------
   bool SingleProcess_PayPreCosts(cAvidaContext& ctx, const Instruction& cur_inst, const int thread_id);
@@ -252,6 +281,7 @@ protected:
   bool IsPayingActiveCost(cAvidaContext& ctx, const int thread_id);
   virtual void internalReset() = 0;
 	virtual void internalResetOnFailedDivide() = 0;
+  virtual void internalRecycle(cAvidaContext& ctx) { (void)ctx; assert(false); }
   
   
   // --------  No-Operation Instruction  --------
@@ -278,6 +308,16 @@ protected:
   void doTransMutation(cAvidaContext& ctx, InstructionSequence& genome, int from = -1);
   void doLGTMutation(cAvidaContext& ctx, InstructionSequence& genome);
   
+  
+  // --------  Indexed Template Search Methods  --------
+  // Searches over memory with a nop index that visit the same sites, in the same order, as the linear scans of the
+  // hardware types that use them.  With an origin of -1 the scan runs from the start to the end of memory, otherwise it
+  // wraps from just past the origin back round to it.  The start of the match is returned, -1 if there is none.
+  bool useNopIndex(cCPUMemory& memory) const;  // Indexes memory spaces created on demand, true if the index is usable
+  int findLabelInst(const cCPUMemory& memory, const cCodeLabel& label, int origin) const;   // 'label' plus its nops
+  int findNopSequence(const cCPUMemory& memory, const cCodeLabel& label, int origin) const;
+  int matchNopSequence(const cCPUMemory& memory, const cCodeLabel& label, int& pos, int origin) const;
+  
 
   // --------  Organism Execution Property Calculation  --------
   virtual int calcExecutedSize(const int parent_size);
@@ -29,6 +29,7 @@
 #include "avida/private/systematics/SexualAncestry.h"
 
 #include "cAvidaContext.h"
+#include "cChunkedFile.h"
 #include "cCPUTestInfo.h"
 #include "cEnvironment.h"
 #include "cHardwareManager.h"
@@ -46,6 +47,7 @@
 #include "cStateGrid.h"
 #include "cStringUtil.h"
 #include "cTestCPU.h"
+#include "cTestCPUCheckpoints.h"
 #include "cWorld.h"
 #include "tInstLibEntry.h"
 
@@ -773,27 +775,214 @@ cHardwareCPU::cHardwareCPU(cAvidaContext& ctx, cWorld* world, cOrganism* in_orga
 {
   m_functions = s_inst_slib->GetFunctions();
   
+  // Resolve each op to its handler up front, the mapping is fixed for the life of the instruction set
+  m_op_functions.Resize(m_inst_set->GetSize());
+  for (int i = 0; i < m_op_functions.GetSize(); i++) {
+    m_op_functions[i] = m_functions[m_inst_set->GetLibFunctionIndex(Instruction(i))];
+  }
+  
   m_spec_die = false;
   m_epigenetic_state = false;
   
-  m_thread_slicing_parallel = (m_world->GetConfig().THREAD_SLICING_METHOD.Get() == 1);
-  m_no_cpu_cycle_time = m_world->GetConfig().NO_CPU_CYCLE_TIME.Get();
-  
-  m_promoters_enabled = m_world->GetConfig().PROMOTERS_ENABLED.Get();
-  m_constitutive_regulation = m_world->GetConfig().CONSTITUTIVE_REGULATION.Get();
-  
-  m_slip_read_head = !m_world->GetConfig().SLIP_COPY_MODE.Get();
+  setupConfig();
+  m_has_addl_time_costs = m_inst_set->HasAddlTimeCosts();
   
   // Initialize memory...
   const Genome& in_genome = in_organism->GetGenome();
   ConstInstructionSequencePtr in_seq_p;
   in_seq_p.DynamicCastFrom(in_genome.Representation());
   m_memory = *in_seq_p;
+  if (m_inst_set->GetNumNops()) m_memory.EnableNopIndex(m_inst_set->GetNumNops());
   
   Reset(ctx);                            // Setup the rest of the hardware...
   internalReset();
 }
 
+void cHardwareCPU::internalRecycle(cAvidaContext& ctx)
+{
+  m_spec_die = false;
+  m_epigenetic_state = false;
+  
+  // Pick up any SetConfig changes made since this hardware was last in use
+  setupConfig();
+  
+  ConstInstructionSequencePtr in_seq_p;
+  in_seq_p.DynamicCastFrom(m_organism->GetGenome().Representation());
+  m_memory = *in_seq_p;
+  
+  Reset(ctx);
+  internalReset();
+}
+
+void cHardwareCPU::setupConfig()
+{
+  m_thread_slicing_parallel = (m_world->GetConfig().THREAD_SLICING_METHOD.Get() == 1);
+  m_no_cpu_cycle_time = m_world->GetConfig().NO_CPU_CYCLE_TIME.Get();
+  
+  m_promoters_enabled = m_world->GetConfig().PROMOTERS_ENABLED.Get();
+  m_constitutive_regulation = m_world->GetConfig().CONSTITUTIVE_REGULATION.Get();
+  
+  m_slip_read_head = !m_world->GetConfig().SLIP_COPY_MODE.Get();
+}
+
+bool cHardwareCPU::SupportsCheckpoint() const
+{
+  // Instructions whose only uses of memory are reported to the checkpoint recorder, and that never draw random numbers
+  // when the test mutation rates are zero
+  static const tMethod s_checkpoint_insts[] = {
+    &cHardwareCPU::Inst_Nop, &cHardwareCPU::Inst_IfNEqu, &cHardwareCPU::Inst_IfLess, &cHardwareCPU::Inst_IfLabel,
+    &cHardwareCPU::Inst_MoveHead, &cHardwareCPU::Inst_JumpHead, &cHardwareCPU::Inst_GetHead, &cHardwareCPU::Inst_SetFlow,
+    &cHardwareCPU::Inst_ShiftR, &cHardwareCPU::Inst_ShiftL, &cHardwareCPU::Inst_Inc, &cHardwareCPU::Inst_Dec,
+    &cHardwareCPU::Inst_Push, &cHardwareCPU::Inst_Pop, &cHardwareCPU::Inst_SwitchStack, &cHardwareCPU::Inst_Swap,
+    &cHardwareCPU::Inst_Add, &cHardwareCPU::Inst_Sub, &cHardwareCPU::Inst_Nand, &cHardwareCPU::Inst_TaskIO,
+    &cHardwareCPU::Inst_MaxAlloc, &cHardwareCPU::Inst_HeadDivide, &cHardwareCPU::Inst_HeadCopy,
+    &cHardwareCPU::Inst_HeadSearch
+  };
+  const int num_checkpoint_insts = sizeof(s_checkpoint_insts) / sizeof(tMethod);
+  
+  if (m_has_any_costs || m_inst_set->HasProbFail() || m_implicit_repro_active) return false;
+  if (m_thread_slicing_parallel || m_promoters_enabled || m_constitutive_regulation ||
+      m_world->GetConfig().TASK_SWITCH_PENALTY_TYPE.Get()) return false;
+  if (m_world->GetConfig().ALLOC_METHOD.Get() != ALLOC_METHOD_DEFAULT) return false;
+  
+  for (int i = 0; i < m_op_functions.GetSize(); i++) {
+    int j = 0;
+    while (j < num_checkpoint_insts && m_op_functions[i] != s_checkpoint_insts[j]) j++;
+    if (j == num_checkpoint_insts) return false;
+  }
+  return true;
+}
+
+cHardwareCheckpoint* cHardwareCPU::SaveCheckpoint() const
+{
+  cCheckpoint* checkpoint = new cCheckpoint;
+  
+  checkpoint->memory = m_memory;
+  checkpoint->global_stack = m_global_stack;
+  checkpoint->threads.Resize(m_threads.GetSize());
+  for (int i = 0; i < m_threads.GetSize(); i++) checkpoint->threads[i].CopyState(m_threads[i], NULL);
+  checkpoint->thread_id_chart = m_thread_id_chart;
+  checkpoint->cur_thread = m_cur_thread;
+  
+  checkpoint->mal_active = m_mal_active;
+  checkpoint->advance_ip = m_advance_ip;
+  checkpoint->executedmatchstrings = m_executedmatchstrings;
+  checkpoint->spec_die = m_spec_die;
+  
+  checkpoint->epigenetic_state = m_epigenetic_state;
+  for (int i = 0; i < NUM_REGISTERS; i++) checkpoint->epigenetic_saved_reg[i] = m_epigenetic_saved_reg[i];
+  checkpoint->epigenetic_saved_stack = m_epigenetic_saved_stack;
+  
+  checkpoint->task_switching_cost = m_task_switching_cost;
+  checkpoint->ext_mem = m_ext_mem;
+  
+  return checkpoint;
+}
+
+void cHardwareCPU::RestoreCheckpoint(const cHardwareCheckpoint& checkpoint)
+{
+  const cCheckpoint& saved = static_cast<const cCheckpoint&>(checkpoint);
+  
+  // Memory first, so that the heads are adjusted against the restored size
+  m_memory = saved.memory;
+  m_global_stack = saved.global_stack;
+  m_threads.Resize(saved.threads.GetSize());
+  for (int i = 0; i < m_threads.GetSize(); i++) m_threads[i].CopyState(saved.threads[i], this);
+  m_thread_id_chart = saved.thread_id_chart;
+  m_cur_thread = saved.cur_thread;
+  
+  m_mal_active = saved.mal_active;
+  m_advance_ip = saved.advance_ip;
+  m_executedmatchstrings = saved.executedmatchstrings;
+  m_spec_die = saved.spec_die;
+  
+  m_epigenetic_state = saved.epigenetic_state;
+  for (int i = 0; i < NUM_REGISTERS; i++) m_epigenetic_saved_reg[i] = saved.epigenetic_saved_reg[i];
+  m_epigenetic_saved_stack = saved.epigenetic_saved_stack;
+  
+  m_task_switching_cost = saved.task_switching_cost;
+  m_ext_mem = saved.ext_mem;
+}
+
+void cHardwareCPU::SaveState(cChunkBuffer& buf) const
+{
+  saveBaseState(buf);
+  
+  m_memory.SaveState(buf);
+  m_global_stack.SaveState(buf);
+  buf.PutVarUInt(m_threads.GetSize());
+  for (int i = 0; i < m_threads.GetSize(); i++) m_threads[i].SaveState(buf);
+  buf.PutVarInt(m_thread_id_chart);
+  buf.PutVarInt(m_cur_thread);
+  
+  buf.PutBool(m_mal_active);
+  buf.PutBool(m_advance_ip);
+  buf.PutBool(m_executedmatchstrings);
+  buf.PutBool(m_spec_die);
+  
+  buf.PutVarInt(m_promoter_index);
+  buf.PutVarInt(m_promoter_offset);
+  buf.PutVarUInt(m_promoters.GetSize());
+  for (int i = 0; i < m_promoters.GetSize(); i++) {
+    buf.PutVarInt(m_promoters[i].m_pos);
+    buf.PutVarInt(m_promoters[i].m_bit_code);
+    buf.PutVarInt(m_promoters[i].m_regulation);
+  }
+  
+  buf.PutBool(m_epigenetic_state);
+  for (int i = 0; i < NUM_REGISTERS; i++) buf.PutVarInt(m_epigenetic_saved_reg[i]);
+  m_epigenetic_saved_stack.SaveState(buf);
+  
+  buf.PutBool(m_last_cell_data.first);
+  buf.PutVarInt(m_last_cell_data.second);
+  buf.PutVarUInt(m_flash_info.first);
+  buf.PutVarUInt(m_flash_info.second);
+  buf.PutVarUInt(m_cycle_counter);
+}
+
+bool cHardwareCPU::LoadState(cChunkBuffer& buf)
+{
+  if (!loadBaseState(buf)) return false;
+  
+  // Memory first, so that the heads are restored against it
+  if (!m_memory.LoadState(buf) || !m_global_stack.LoadState(buf)) return false;
+  const int num_threads = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_threads < 1 || num_threads > buf.GetRemaining()) return false;
+  m_threads.Resize(num_threads);
+  for (int i = 0; i < num_threads; i++) if (!m_threads[i].LoadState(buf, this)) return false;
+  m_thread_id_chart = (int)buf.GetVarInt();
+  m_cur_thread = (int)buf.GetVarInt();
+  if (m_cur_thread < 0 || m_cur_thread >= num_threads) return false;
+  
+  m_mal_active = buf.GetBool();
+  m_advance_ip = buf.GetBool();
+  m_executedmatchstrings = buf.GetBool();
+  m_spec_die = buf.GetBool();
+  
+  m_promoter_index = (int)buf.GetVarInt();
+  m_promoter_offset = (int)buf.GetVarInt();
+  const int num_promoters = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_promoters > buf.GetRemaining()) return false;
+  m_promoters.Resize(num_promoters);
+  for (int i = 0; i < num_promoters; i++) {
+    m_promoters[i].m_pos = (int)buf.GetVarInt();
+    m_promoters[i].m_bit_code = (int)buf.GetVarInt();
+    m_promoters[i].m_regulation = (int)buf.GetVarInt();
+  }
+  
+  m_epigenetic_state = buf.GetBool();
+  for (int i = 0; i < NUM_REGISTERS; i++) m_epigenetic_saved_reg[i] = (int)buf.GetVarInt();
+  if (!m_epigenetic_saved_stack.LoadState(buf)) return false;
+  
+  m_last_cell_data.first = buf.GetBool();
+  m_last_cell_data.second = (int)buf.GetVarInt();
+  m_flash_info.first = (unsigned int)buf.GetVarUInt();
+  m_flash_info.second = (unsigned int)buf.GetVarUInt();
+  m_cycle_counter = (unsigned int)buf.GetVarUInt();
+  
+  return !buf.Fail();
+}
+
 bool cHardwareCPU::checkNoMutList(cHeadCPU to)
 {
     //Anya's code for head to head experiments
@@ -899,6 +1088,53 @@ void cHardwareCPU::cLocalThread::Reset(cHardwareBase* in_hardware, int in_id)
     
 }
 
+void cHardwareCPU::cLocalThread::CopyState(const cLocalThread& in_thread, cHardwareBase* in_hardware)
+{
+  m_id = in_thread.m_id;
+  m_promoter_inst_executed = in_thread.m_promoter_inst_executed;
+  m_messageTriggerType = in_thread.m_messageTriggerType;
+  
+  for (int i = 0; i < NUM_REGISTERS; i++) reg[i] = in_thread.reg[i];
+  for (int i = 0; i < NUM_HEADS; i++) {
+    heads[i] = in_thread.heads[i];
+    heads[i].Rebind(in_hardware);
+  }
+  
+  stack = in_thread.stack;
+  cur_stack = in_thread.cur_stack;
+  cur_head = in_thread.cur_head;
+  read_label = in_thread.read_label;
+  next_label = in_thread.next_label;
+}
+
+void cHardwareCPU::cLocalThread::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarInt(m_id);
+  buf.PutVarInt(m_promoter_inst_executed);
+  buf.PutVarInt(m_messageTriggerType);
+  for (int i = 0; i < NUM_REGISTERS; i++) buf.PutVarInt(reg[i]);
+  for (int i = 0; i < NUM_HEADS; i++) heads[i].SaveState(buf);
+  stack.SaveState(buf);
+  buf.PutByte(cur_stack);
+  buf.PutByte(cur_head);
+  read_label.SaveState(buf);
+  next_label.SaveState(buf);
+}
+
+bool cHardwareCPU::cLocalThread::LoadState(cChunkBuffer& buf, cHardwareBase* in_hardware)
+{
+  m_id = (int)buf.GetVarInt();
+  m_promoter_inst_executed = (int)buf.GetVarInt();
+  m_messageTriggerType = (int)buf.GetVarInt();
+  for (int i = 0; i < NUM_REGISTERS; i++) reg[i] = (int)buf.GetVarInt();
+  for (int i = 0; i < NUM_HEADS; i++) if (!heads[i].LoadState(buf, in_hardware)) return false;
+  if (!stack.LoadState(buf)) return false;
+  cur_stack = buf.GetByte();
+  cur_head = buf.GetByte();
+  if (cur_stack > 1 || cur_head >= NUM_HEADS) return false;
+  return read_label.LoadState(buf) && next_label.LoadState(buf);
+}
+
 void cHardwareCPU::SetupMiniTraceFileHeader(Avida::Output::File& df, const int gen_id, const Apto::String& genotype) { (void)df, (void)gen_id, (void)genotype; }
 
 
@@ -927,7 +1163,7 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
   
   // Count the cpu cycles used
   phenotype.IncCPUCyclesUsed();
-  if (!m_world->GetConfig().NO_CPU_CYCLE_TIME.Get()) phenotype.IncTimeUsed();
+  if (!m_no_cpu_cycle_time) phenotype.IncTimeUsed();
   
   int num_threads = m_threads.GetSize();
   
@@ -957,6 +1193,7 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
     
     // Find the instruction to be executed
     const Instruction cur_inst = ip.GetInst();
+    if (m_checkpoints) m_checkpoints->TouchInst(ip.GetPosition());
     
     if (speculative && (m_spec_die || m_inst_set->ShouldStall(cur_inst))) {
       // Speculative instruction reject, flush and return
@@ -982,10 +1219,11 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
       // NOTE: This call based on the cur_inst must occur prior to instruction
       //       execution, because this instruction reference may be invalid after
       //       certain classes of instructions (namely divide instructions) @DMB
-      const int time_cost = m_inst_set->GetAddlTimeCost(cur_inst);
+      const int time_cost = m_has_addl_time_costs ? m_inst_set->GetAddlTimeCost(cur_inst) : 0;
       
-      // Prob of exec (moved from SingleProcess_PayCosts so that we advance IP after a fail)
-      if (m_inst_set->GetProbFail(cur_inst) > 0.0) {
+      // Prob of exec (moved from SingleProcess_PayCosts so that we advance IP after a fail).  The instruction set is
+      // asked each time, failure probabilities can be changed during a run (SetProbFail)
+      if (m_inst_set->HasProbFail() && m_inst_set->GetProbFail(cur_inst) > 0.0) {
         exec = !( ctx.GetRandom().P(m_inst_set->GetProbFail(cur_inst)) );
       }
       
@@ -1013,7 +1251,7 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
       if (m_advance_ip == true) ip.Advance();
       
       // Pay the time cost of the instruction now
-      phenotype.IncTimeUsed(time_cost);
+      if (time_cost) phenotype.IncTimeUsed(time_cost);
       
       // In the promoter model, we may force termination after a certain number of inst have been executed
       if (m_promoters_enabled) {
@@ -1064,14 +1302,11 @@ bool cHardwareCPU::SingleProcess_ExecuteInst(cAvidaContext& ctx, const Instructi
   // Copy Instruction locally to handle stochastic effects
   Instruction actual_inst = cur_inst;
   
-  // Get a pointer to the corresponding method...
-  int inst_idx = m_inst_set->GetLibFunctionIndex(actual_inst);
-  
   // instruction execution count incremented
   m_organism->GetPhenotype().IncCurInstCount(actual_inst.GetOp());
 	
   // And execute it.
-  const bool exec_success = (this->*(m_functions[inst_idx]))(ctx);
+  const bool exec_success = (this->*(m_op_functions[actual_inst.GetOp()]))(ctx);
   
   // NOTE: Organism may be dead now if instruction executed killed it (such as some divides, "die", or "explode")
   
@@ -1204,6 +1439,18 @@ cHeadCPU cHardwareCPU::FindLabel(int direction)
     found_pos = FindLabel_Forward(search_label, m_memory, 0);
   }
   
+  // Forward searches examine every site from their start through the end of the label run they stop in
+  if (m_checkpoints) {
+    if (direction < 0 || found_pos < 0) {
+      m_checkpoints->TouchNopRange(0, m_memory.GetSize());
+    } else {
+      const cCPUMemory& memory = m_memory;
+      int end_pos = found_pos;
+      while (end_pos < memory.GetSize() && m_inst_set->IsNop(memory[end_pos])) end_pos++;
+      m_checkpoints->TouchNopRange((direction > 0) ? inst_ptr.GetPosition() : 0, end_pos + 1);
+    }
+  }
+  
   // Return the last line of the found label, if it was found.
   if (found_pos >= 0) search_head.Set(found_pos - 1);
   
@@ -1217,7 +1464,7 @@ cHeadCPU cHardwareCPU::FindLabel(int direction)
 // to find search label's match inside another label.
 
 int cHardwareCPU::FindLabel_Forward(const cCodeLabel & search_label,
-                                    const InstructionSequence & search_genome, int pos)
+                                    const cCPUMemory & search_genome, int pos)
 {
   assert (pos < search_genome.GetSize() && pos >= 0);
   
@@ -1225,6 +1472,28 @@ int cHardwareCPU::FindLabel_Forward(const cCodeLabel & search_label,
   int label_size = search_label.GetSize();
   bool found_label = false;
   
+  // With the nop index, visit only the labels the scan below would stop in: those after the start position that can
+  // hold the search label.  Its first probe lies past a label beginning exactly at the start, so one that only just
+  // fits is passed over.
+  if (search_genome.HasNopIndex()) {
+    const int num_runs = search_genome.GetNumNopRuns();
+    for (int run = search_genome.FindNopRun(search_start); run < num_runs; run++) {
+      const int start_pos = Apto::Max(search_genome.GetNopRunStart(run), search_start);
+      const int end_pos = search_genome.GetNopRunEnd(run);
+      const int test_size = end_pos - start_pos;
+      if (test_size < label_size || (start_pos == search_start && test_size == label_size)) continue;
+      
+      for (int offset = start_pos; offset <= end_pos - label_size; offset++) {
+        int matches;
+        for (matches = 0; matches < label_size; matches++) {
+          if (search_label[matches] != m_inst_set->GetNopMod(search_genome[offset + matches])) break;
+        }
+        if (matches == label_size) return offset + label_size;
+      }
+    }
+    return -1;
+  }
+  
   // Move off the template we are on.
   pos += label_size;
   
@@ -1299,7 +1568,7 @@ int cHardwareCPU::FindLabel_Forward(const cCodeLabel & search_label,
 // to find search label's match inside another label.
 
 int cHardwareCPU::FindLabel_Backward(const cCodeLabel & search_label,
-                                     const InstructionSequence & search_genome, int pos)
+                                     const cCPUMemory & search_genome, int pos)
 {
   assert (pos < search_genome.GetSize());
   
@@ -1307,6 +1576,23 @@ int cHardwareCPU::FindLabel_Backward(const cCodeLabel & search_label,
   int label_size = search_label.GetSize();
   bool found_label = false;
   
+  // With the nop index, visit the labels before the start position from the nearest back, as the scan below does
+  if (search_genome.HasNopIndex()) {
+    for (int run = search_genome.FindNopRunBefore(search_start); run >= 0; run--) {
+      const int start_pos = search_genome.GetNopRunStart(run);
+      const int end_pos = Apto::Min(search_genome.GetNopRunEnd(run), search_start);
+      
+      for (int offset = start_pos; offset <= end_pos - label_size; offset++) {
+        int matches;
+        for (matches = 0; matches < label_size; matches++) {
+          if (search_label[matches] != m_inst_set->GetNopMod(search_genome[offset + matches])) break;
+        }
+        if (matches == label_size) return end_pos;
+      }
+    }
+    return -1;
+  }
+  
   // Move off the template we are on.
   pos -= label_size;
   
@@ -1499,6 +1785,9 @@ void cHardwareCPU::ReadLabel(int max_size)
       inst_ptr->SetFlagExecuted();
     }
   }
+  
+  // Every nop of the label and the instruction that ended it were examined
+  if (m_checkpoints) m_checkpoints->TouchNopRange(inst_ptr->GetPosition() - count + 1, inst_ptr->GetPosition() + 2);
 }
 
 
@@ -1623,6 +1912,7 @@ inline int cHardwareCPU::FindModifiedRegister(int default_register)
 {
   assert(default_register < NUM_REGISTERS);  // Reg ID too high.
   
+  if (m_checkpoints) m_checkpoints->TouchNop(getIP().GetPosition() + 1);
   if (m_inst_set->IsNop(getIP().GetNextInst())) {
     getIP().Advance();
     default_register = m_inst_set->GetNopMod(getIP().GetInst());
@@ -1635,6 +1925,7 @@ inline int cHardwareCPU::FindModifiedNextRegister(int default_register)
 {
   assert(default_register < NUM_REGISTERS);  // Reg ID too high.
   
+  if (m_checkpoints) m_checkpoints->TouchNop(getIP().GetPosition() + 1);
   if (m_inst_set->IsNop(getIP().GetNextInst())) {
     getIP().Advance();
     default_register = m_inst_set->GetNopMod(getIP().GetInst());
@@ -1649,6 +1940,7 @@ inline int cHardwareCPU::FindModifiedPreviousRegister(int default_register)
 {
   assert(default_register < NUM_REGISTERS);  // Reg ID too high.
   
+  if (m_checkpoints) m_checkpoints->TouchNop(getIP().GetPosition() + 1);
   if (m_inst_set->IsNop(getIP().GetNextInst())) {
     getIP().Advance();
     default_register = m_inst_set->GetNopMod(getIP().GetInst());
@@ -1664,6 +1956,7 @@ inline int cHardwareCPU::FindModifiedHead(int default_head)
 {
   assert(default_head < NUM_HEADS); // Head ID too high.
   
+  if (m_checkpoints) m_checkpoints->TouchNop(getIP().GetPosition() + 1);
   if (m_inst_set->IsNop(getIP().GetNextInst())) {
     getIP().Advance();
     default_head = m_inst_set->GetNopMod(getIP().GetInst());
@@ -6941,6 +7234,7 @@ bool cHardwareCPU::Inst_IfLabel2(cAvidaContext&)
 
 bool cHardwareCPU::Inst_HeadDivideMut(cAvidaContext& ctx, double mut_multiplier)
 {
+  if (m_checkpoints) m_checkpoints->TouchAll();
   AdjustHeads();
   const int divide_pos = getHead(nHardware::HEAD_READ).GetPosition();
   int child_end =  getHead(nHardware::HEAD_WRITE).GetPosition();
@@ -7135,6 +7429,10 @@ bool cHardwareCPU::Inst_HeadCopy(cAvidaContext& ctx)
   
   read_head.Adjust();
   write_head.Adjust();
+  if (m_checkpoints) {
+    m_checkpoints->TouchInst(read_head.GetPosition());
+    m_checkpoints->TouchInst(write_head.GetPosition());
+  }
   
   // Do mutations.
   Instruction read_inst = read_head.GetInst();
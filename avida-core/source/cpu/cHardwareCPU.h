@@ -87,6 +87,9 @@ protected:
     void operator=(const cLocalThread& in_thread);
 
     void Reset(cHardwareBase* in_hardware, int in_id);
+    void CopyState(const cLocalThread& in_thread, cHardwareBase* in_hardware);
+    void SaveState(cChunkBuffer& buf) const;
+    bool LoadState(cChunkBuffer& buf, cHardwareBase* in_hardware);
     int GetID() const { return m_id; }
     void SetID(int in_id) { m_id = in_id; }
     int GetPromoterInstExecuted() { return m_promoter_inst_executed; }
@@ -97,6 +100,26 @@ protected:
   };
 
 
+  class cCheckpoint : public cHardwareCheckpoint
+  {
+  public:
+    cCPUMemory memory;
+    cCPUStack global_stack;
+    Apto::Array<cLocalThread> threads;  // Heads are unbound, they are rebound to the restoring hardware
+    int thread_id_chart;
+    int cur_thread;
+    bool mal_active;
+    bool advance_ip;
+    bool executedmatchstrings;
+    bool spec_die;
+    bool epigenetic_state;
+    int epigenetic_saved_reg[NUM_REGISTERS];
+    cCPUStack epigenetic_saved_stack;
+    int task_switching_cost;
+    Apto::Array<int, Apto::Smart> ext_mem;
+  };
+
+
   // --------  Static Variables  --------
   static tInstLib<tMethod>* s_inst_slib;
   static tInstLib<tMethod>* initInstLib(void);
@@ -104,6 +127,8 @@ protected:
 
   // --------  Member Variables  --------
   const tMethod* m_functions;
+  Apto::Array<tMethod> m_op_functions;  // Handler for each instruction op, resolved from the instruction set once
+
 
   cCPUMemory m_memory;          // Memory...
   cCPUStack m_global_stack;     // A stack that all threads share.
@@ -126,6 +151,8 @@ protected:
     bool m_constitutive_regulation:1;
 
     bool m_slip_read_head:1;
+    
+    bool m_has_addl_time_costs:1;
   };
 
   // <-- Promoter model
@@ -173,8 +200,8 @@ protected:
   cCodeLabel& GetLabel() { return m_threads[m_cur_thread].next_label; }
   void ReadLabel(int max_size=cCodeLabel::MAX_LENGTH);
   cHeadCPU FindLabel(int direction);
-  int FindLabel_Forward(const cCodeLabel & search_label, const InstructionSequence& search_genome, int pos);
-  int FindLabel_Backward(const cCodeLabel & search_label, const InstructionSequence& search_genome, int pos);
+  int FindLabel_Forward(const cCodeLabel & search_label, const cCPUMemory& search_genome, int pos);
+  int FindLabel_Backward(const cCodeLabel & search_label, const cCPUMemory& search_genome, int pos);
   cHeadCPU FindLabel(const cCodeLabel & in_label, int direction);
   void FindLabelInMemory(const cCodeLabel& label, cHeadCPU& search_head);
 
@@ -214,6 +241,8 @@ protected:
   void internalReset();
 
   void internalResetOnFailedDivide();
+  void internalRecycle(cAvidaContext& ctx);
+  void setupConfig();
 
 
   int calcCopiedSize(const int parent_size, const int child_size);
@@ -248,6 +277,12 @@ public:
   // --------  Helper methods  --------
   int GetType() const { return HARDWARE_TYPE_CPU_ORIGINAL; }  
   bool SupportsSpeculative() const { return true; }
+  bool SupportsRecycle() const { return true; }
+  bool SupportsCheckpoint() const;
+  cHardwareCheckpoint* SaveCheckpoint() const;
+  void RestoreCheckpoint(const cHardwareCheckpoint& checkpoint);
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
   void PrintStatus(std::ostream& fp);
   void SetupMiniTraceFileHeader(Avida::Output::File& df, const int gen_id, const Apto::String& genotype);
   void PrintMiniTraceStatus(cAvidaContext& ctx, std::ostream& fp) { (void)ctx, (void)fp; }
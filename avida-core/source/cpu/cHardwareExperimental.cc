@@ -30,6 +30,7 @@
 #include "avida/private/systematics/SexualAncestry.h"
 
 #include "cAvidaContext.h"
+#include "cChunkedFile.h"
 #include "cHardwareManager.h"
 #include "cHardwareTracer.h"
 #include "cInstSet.h"
@@ -461,6 +462,19 @@ cHardwareExperimental::cHardwareExperimental(cAvidaContext& ctx, cWorld* world,
   Reset(ctx);                            // Setup the rest of the hardware...
 }
 
+void cHardwareExperimental::internalRecycle(cAvidaContext& ctx)
+{
+  m_spec_die = false;
+  m_last_cell_data = std::make_pair(false, 0);
+  m_sensor.SetOrganism(m_organism);
+  
+  ConstInstructionSequencePtr in_seq_p;
+  in_seq_p.DynamicCastFrom(m_organism->GetGenome().Representation());
+  m_memory = *in_seq_p;
+  if (m_inst_set->GetNumNops()) m_memory.EnableNopIndex(m_inst_set->GetNumNops());
+  Reset(ctx);
+}
+
 
 void cHardwareExperimental::internalReset()
 {
@@ -556,6 +570,177 @@ void cHardwareExperimental::cLocalThread::Reset(cHardwareExperimental* in_hardwa
 }
 
 
+void cHardwareExperimental::cLocalThread::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarInt(m_id);
+  buf.PutVarInt(m_promoter_inst_executed);
+  buf.PutVarUInt(m_execurate);
+  for (int i = 0; i < NUM_REGISTERS; i++) reg[i].SaveState(buf);
+  for (int i = 0; i < NUM_HEADS; i++) heads[i].SaveState(buf);
+  stack.SaveState(buf);
+  buf.PutByte(cur_stack);
+  buf.PutByte(cur_head);
+  
+  buf.PutBool(reading_label);
+  buf.PutBool(reading_seq);
+  buf.PutBool(active);
+  buf.PutBool(wait_greater);
+  buf.PutBool(wait_equal);
+  buf.PutBool(wait_less);
+  buf.PutByte(wait_reg);
+  buf.PutByte(wait_dst);
+  buf.PutVarInt(wait_value);
+  
+  read_label.SaveState(buf);
+  read_seq.SaveState(buf);
+  next_label.SaveState(buf);
+}
+
+bool cHardwareExperimental::cLocalThread::LoadState(cChunkBuffer& buf, cHardwareExperimental* in_hardware)
+{
+  m_id = (int)buf.GetVarInt();
+  m_promoter_inst_executed = (int)buf.GetVarInt();
+  m_execurate = (unsigned int)buf.GetVarUInt();
+  for (int i = 0; i < NUM_REGISTERS; i++) reg[i].LoadState(buf);
+  for (int i = 0; i < NUM_HEADS; i++) if (!heads[i].LoadState(buf, in_hardware)) return false;
+  if (!stack.LoadState(buf)) return false;
+  cur_stack = buf.GetByte();
+  cur_head = buf.GetByte();
+  if (cur_stack > 1 || cur_head >= NUM_HEADS) return false;
+  
+  reading_label = buf.GetBool();
+  reading_seq = buf.GetBool();
+  active = buf.GetBool();
+  wait_greater = buf.GetBool();
+  wait_equal = buf.GetBool();
+  wait_less = buf.GetBool();
+  wait_reg = buf.GetByte();
+  wait_dst = buf.GetByte();
+  wait_value = (int)buf.GetVarInt();
+  
+  return read_label.LoadState(buf) && read_seq.LoadState(buf) && next_label.LoadState(buf);
+}
+
+
+void cHardwareExperimental::DataValue::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarInt(value);
+  buf.PutVarUInt(originated);
+  buf.PutVarUInt(oldest_component);
+  buf.PutByte(from_env | (from_sensor << 1) | (from_message << 2)
+              | (env_component << 3) | (sensor_component << 4) | (message_component << 5));
+}
+
+void cHardwareExperimental::DataValue::LoadState(cChunkBuffer& buf)
+{
+  value = (int)buf.GetVarInt();
+  originated = (unsigned int)buf.GetVarUInt();
+  oldest_component = (unsigned int)buf.GetVarUInt();
+  const unsigned char flags = buf.GetByte();
+  from_env = flags & 1;
+  from_sensor = (flags >> 1) & 1;
+  from_message = (flags >> 2) & 1;
+  env_component = (flags >> 3) & 1;
+  sensor_component = (flags >> 4) & 1;
+  message_component = (flags >> 5) & 1;
+}
+
+
+void cHardwareExperimental::Stack::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarUInt(m_sz);
+  buf.PutVarUInt(m_sp);
+  for (int i = 0; i < m_sz; i++) m_stack[i].SaveState(buf);
+}
+
+bool cHardwareExperimental::Stack::LoadState(cChunkBuffer& buf)
+{
+  const int sz = (int)buf.GetVarUInt();
+  const int sp = (int)buf.GetVarUInt();
+  if (buf.Fail() || sz < 1 || sz > buf.GetRemaining() || sp >= sz) return false;
+  Clear(sz);
+  m_sp = sp;
+  for (int i = 0; i < m_sz; i++) m_stack[i].LoadState(buf);
+  return !buf.Fail();
+}
+
+
+void cHardwareExperimental::SaveState(cChunkBuffer& buf) const
+{
+  saveBaseState(buf);
+  
+  m_memory.SaveState(buf);
+  m_global_stack.SaveState(buf);
+  buf.PutVarUInt(m_threads.GetSize());
+  for (int i = 0; i < m_threads.GetSize(); i++) m_threads[i].SaveState(buf);
+  buf.PutVarInt(m_thread_id_chart);
+  buf.PutVarInt(m_cur_thread);
+  buf.PutVarUInt(m_waiting_threads);
+  
+  m_sensor.SaveState(buf);
+  buf.PutVarUInt(m_cycle_count);
+  buf.PutVarUInt(m_last_output);
+  
+  buf.PutBool(m_mal_active);
+  buf.PutBool(m_advance_ip);
+  buf.PutBool(m_executedmatchstrings);
+  buf.PutBool(m_spec_die);
+  
+  buf.PutVarInt(m_promoter_index);
+  buf.PutVarInt(m_promoter_offset);
+  buf.PutVarUInt(m_promoters.GetSize());
+  for (int i = 0; i < m_promoters.GetSize(); i++) {
+    buf.PutVarInt(m_promoters[i].pos);
+    buf.PutVarInt(m_promoters[i].bit_code);
+    buf.PutVarInt(m_promoters[i].regulation);
+  }
+  
+  buf.PutBool(m_last_cell_data.first);
+  buf.PutVarInt(m_last_cell_data.second);
+}
+
+bool cHardwareExperimental::LoadState(cChunkBuffer& buf)
+{
+  if (!loadBaseState(buf)) return false;
+  
+  // Memory first, so that the heads are restored against it
+  if (!m_memory.LoadState(buf) || !m_global_stack.LoadState(buf)) return false;
+  const int num_threads = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_threads < 1 || num_threads > buf.GetRemaining()) return false;
+  m_threads.Resize(num_threads);
+  for (int i = 0; i < num_threads; i++) if (!m_threads[i].LoadState(buf, this)) return false;
+  m_thread_id_chart = (int)buf.GetVarInt();
+  m_cur_thread = (int)buf.GetVarInt();
+  if (m_cur_thread < 0 || m_cur_thread >= num_threads) return false;
+  m_waiting_threads = (unsigned int)buf.GetVarUInt();
+  
+  if (!m_sensor.LoadState(buf)) return false;
+  m_cycle_count = (unsigned int)buf.GetVarUInt();
+  m_last_output = (unsigned int)buf.GetVarUInt();
+  
+  m_mal_active = buf.GetBool();
+  m_advance_ip = buf.GetBool();
+  m_executedmatchstrings = buf.GetBool();
+  m_spec_die = buf.GetBool();
+  
+  m_promoter_index = (int)buf.GetVarInt();
+  m_promoter_offset = (int)buf.GetVarInt();
+  const int num_promoters = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_promoters > buf.GetRemaining()) return false;
+  m_promoters.Resize(num_promoters);
+  for (int i = 0; i < num_promoters; i++) {
+    m_promoters[i].pos = (int)buf.GetVarInt();
+    m_promoters[i].bit_code = (int)buf.GetVarInt();
+    m_promoters[i].regulation = (int)buf.GetVarInt();
+  }
+  
+  m_last_cell_data.first = buf.GetBool();
+  m_last_cell_data.second = (int)buf.GetVarInt();
+  
+  return !buf.Fail();
+}
+
+
 // This function processes the very next command in the genome, and is made
 // to be as optimized as possible.  This is the heart of avida.
 
@@ -973,6 +1158,19 @@ cHeadCPU cHardwareExperimental::FindLabelStart(bool mark_executed)
   if (search_label.GetSize() == 0) return ip;
   
   cCPUMemory& memory = m_memory;
+  
+  if (memory.HasNopIndex()) {
+    const int label_pos = findLabelInst(memory, search_label, -1);
+    if (label_pos < 0) return ip;
+    
+    const int size_matched = search_label.GetSize() + 1; // Include the label instruction
+    if (mark_executed) {
+      const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
+      for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(label_pos + i);
+    }
+    return cHeadCPU(this, label_pos + size_matched - 1, ip.GetMemSpace());
+  }
+  
   int pos = 0;
   
   while (pos < memory.GetSize()) {
@@ -1019,6 +1217,19 @@ cHeadCPU cHardwareExperimental::FindNopSequenceStart(bool mark_executed)
   if (search_label.GetSize() == 0) return ip;
   
   cCPUMemory& memory = m_memory;
+  
+  if (memory.HasNopIndex()) {
+    const int start = findNopSequence(memory, search_label, -1);
+    if (start < 0) return ip;
+    
+    const int size_matched = search_label.GetSize();
+    if (mark_executed) {
+      const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
+      for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(start + i);
+    }
+    return cHeadCPU(this, start + size_matched - 1, ip.GetMemSpace());
+  }
+  
   int pos = 0;
   
   while (pos < memory.GetSize()) {
@@ -1062,6 +1273,26 @@ cHeadCPU cHardwareExperimental::FindLabelForward(bool mark_executed)
   if (search_label.GetSize() == 0) return ip;
   
   cHeadCPU pos(ip);
+  
+  if (m_memory.HasNopIndex()) {
+    const int label_start = findLabelInst(m_memory, search_label, ip.GetPosition());
+    if (label_start < 0) return ip;
+    
+    // Step over the label as the scan does, so the returned head wraps the same way
+    const int size_matched = search_label.GetSize();
+    pos.Set(label_start, ip.GetMemSpace());
+    for (int i = 0; i <= size_matched; i++) pos++;
+    pos--;
+    const int found_pos = pos.GetPosition();
+    
+    if (mark_executed) {
+      pos.Set(label_start, ip.GetMemSpace());
+      const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
+      for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
+    }
+    return cHeadCPU(this, found_pos, ip.GetMemSpace());
+  }
+  
   pos++;
   
   while (pos.GetPosition() != ip.GetPosition()) {
@@ -1163,6 +1394,26 @@ cHeadCPU cHardwareExperimental::FindNopSequenceForward(bool mark_executed)
   if (search_label.GetSize() == 0) return ip;
   
   cHeadCPU pos(ip);
+  
+  if (m_memory.HasNopIndex()) {
+    const int label_start = findNopSequence(m_memory, search_label, ip.GetPosition());
+    if (label_start < 0) return ip;
+    
+    // Step over the sequence as the scan does, so the returned head wraps the same way
+    const int size_matched = search_label.GetSize();
+    pos.Set(label_start, ip.GetMemSpace());
+    for (int i = 0; i < size_matched; i++) pos++;
+    pos--;
+    const int found_pos = pos.GetPosition();
+    
+    if (mark_executed) {
+      pos.Set(label_start, ip.GetMemSpace());
+      const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
+      for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
+    }
+    return cHeadCPU(this, found_pos, ip.GetMemSpace());
+  }
+  
   pos++;
   
   while (pos.GetPosition() != ip.GetPosition()) {
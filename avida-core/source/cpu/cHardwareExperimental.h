@@ -94,6 +94,9 @@ private:
     inline DataValue() { Clear(); }
     inline void Clear() { value = 0; originated = 0; from_env = 0, from_sensor = 0, from_message = 0, oldest_component = 0; env_component = 0, sensor_component = 0, message_component = 0; }
     inline DataValue& operator=(const DataValue& i);
+    
+    void SaveState(cChunkBuffer& buf) const;
+    void LoadState(cChunkBuffer& buf);
   };
   
   
@@ -117,6 +120,9 @@ private:
     inline const DataValue& Peek() const { return m_stack[(int)m_sp]; }
     inline const DataValue& Get(int d = 0) const { assert(d >= 0); int p = d + m_sp; return m_stack[(p >= m_sz) ? (p - m_sz) : p]; }
     inline void Clear(int sz) { delete [] m_stack; m_sz = sz; m_stack = new DataValue[sz]; }
+    
+    void SaveState(cChunkBuffer& buf) const;
+    bool LoadState(cChunkBuffer& buf);
   };
   
   
@@ -159,6 +165,8 @@ private:
     
     void operator=(const cLocalThread& in_thread);
     void Reset(cHardwareExperimental* in_hardware, int in_id);
+    void SaveState(cChunkBuffer& buf) const;
+    bool LoadState(cChunkBuffer& buf, cHardwareExperimental* in_hardware);
     inline int GetID() const { return m_id; }
     inline void SetID(int in_id) { m_id = in_id; }
     
@@ -252,6 +260,9 @@ public:
   // --------  Helper Methods  --------
   int GetType() const { return HARDWARE_TYPE_CPU_EXPERIMENTAL; }  
   bool SupportsSpeculative() const { return true; }
+  bool SupportsRecycle() const { return true; }
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
   void PrintStatus(std::ostream& fp);
   void SetupMiniTraceFileHeader(Avida::Output::File& df, const int gen_id, const Apto::String& genotype);
   void PrintMiniTraceStatus(cAvidaContext& ctx, std::ostream& fp);
@@ -310,6 +321,7 @@ private:
   bool SingleProcess_ExecuteInst(cAvidaContext& ctx, const Instruction& cur_inst);
   void internalReset();
   void internalResetOnFailedDivide();
+  void internalRecycle(cAvidaContext& ctx);
   
   
   // --------  Stack Manipulation  --------
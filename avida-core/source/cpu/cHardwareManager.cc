@@ -26,6 +26,7 @@
 
 #include "cArgContainer.h"
 #include "cArgSchema.h"
+#include "cEnvironment.h"
 #include "cHardwareBCR.h"
 #include "cHardwareCPU.h"
 #include "cHardwareExperimental.h"
@@ -34,6 +35,9 @@
 #include "cHardwareStatusPrinter.h"
 #include "cInitFile.h"
 #include "cInstSet.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+#include "cStats.h"
 #include "cStringList.h"
 #include "cStringUtil.h"
 #include "cWorld.h"
@@ -43,7 +47,10 @@ using namespace Avida;
 static const Apto::BasicString<Apto::ThreadSafe> s_prop_id_instset("instset");
 
 cHardwareManager::cHardwareManager(cWorld* world)
-: m_world(world)
+: m_world(world), m_phenotype_cache(world->GetConfig().PRECALC_PHENOTYPE_CACHE.Get())
+, m_hw_pool_capacity(world->GetConfig().HARDWARE_POOL_SIZE.Get()), m_hw_idle(0), m_hw_idle_peak(0), m_hw_created(0)
+, m_hw_reused(0), m_org_pool_capacity(world->GetConfig().ORGANISM_POOL_SIZE.Get()), m_org_idle_peak(0), m_orgs_created(0)
+, m_orgs_reused(0), m_blank_update(-1), m_blank_env_version(-1)
 {
   cString filename = world->GetConfig().INST_SET.Get();
   m_is_name_map.Set("(default)", 0);
@@ -52,6 +59,11 @@ cHardwareManager::cHardwareManager(cWorld* world)
 
 cHardwareManager::~cHardwareManager()
 {
+  // Pooled organisms have already released their hardware
+  for (int i = 0; i < m_org_pool.GetSize(); i++) delete m_org_pool[i];
+  for (int i = 0; i < m_hw_pool.GetSize(); i++) {
+    for (int j = 0; j < m_hw_pool[i].GetSize(); j++) delete m_hw_pool[i][j];
+  }
   for (int i = 0; i < m_inst_sets.GetSize(); i++) delete m_inst_sets[i];
 }
 
@@ -256,6 +268,21 @@ cHardwareBase* cHardwareManager::Create(cAvidaContext& ctx, cOrganism* org, cons
   }
   
   cHardwareBase* hw = 0;
+  {
+    Apto::MutexAutoLock lock(m_pool_mutex);
+    if (inst_set_id < m_hw_pool.GetSize() && m_hw_pool[inst_set_id].GetSize()) {
+      hw = m_hw_pool[inst_set_id].Pop();
+      m_hw_idle--;
+      m_hw_reused++;
+    } else {
+      m_hw_created++;
+    }
+  }
+  if (hw) {
+    hw->Recycle(ctx, org);
+    return hw;
+  }
+  
   switch (inst_set->GetHardwareType()) {
     case HARDWARE_TYPE_CPU_ORIGINAL:
       hw = new cHardwareCPU(ctx, m_world, org, inst_set);
@@ -282,6 +309,83 @@ cHardwareBase* cHardwareManager::Create(cAvidaContext& ctx, cOrganism* org, cons
   return hw;
 }
 
+void cHardwareManager::Release(cHardwareBase* hw)
+{
+  if (!hw) return;
+  
+  if (hw->SupportsRecycle()) {
+    hw->SetTrace(HardwareTracerPtr(NULL));  // don't hold trace files open while idle
+    
+    const cInstSet* inst_set = &hw->GetInstSet();
+    int inst_set_id = 0;
+    while (inst_set_id < m_inst_sets.GetSize() && m_inst_sets[inst_set_id] != inst_set) inst_set_id++;
+    
+    Apto::MutexAutoLock lock(m_pool_mutex);
+    if (inst_set_id < m_inst_sets.GetSize()) {
+      if (m_hw_pool.GetSize() <= inst_set_id) m_hw_pool.Resize(m_inst_sets.GetSize());
+      if (m_hw_pool[inst_set_id].GetSize() < m_hw_pool_capacity) {
+        m_hw_pool[inst_set_id].Push(hw);
+        if (++m_hw_idle > m_hw_idle_peak) m_hw_idle_peak = m_hw_idle;
+        return;
+      }
+    }
+  }
+  
+  delete hw;
+}
+
+cOrganism* cHardwareManager::CreateOrganism(cAvidaContext& ctx, const Genome& genome, int parent_generation,
+                                            Systematics::Source src)
+{
+  cOrganism* org = NULL;
+  Apto::SmartPtr<cPhenotype, Apto::ThreadSafeRefCount> blank;
+  {
+    Apto::MutexAutoLock lock(m_pool_mutex);
+    if (m_org_pool.GetSize()) {
+      org = m_org_pool.Pop();
+      blank = blankPhenotype();
+      m_orgs_reused++;
+    } else {
+      m_orgs_created++;
+    }
+  }
+  if (!org) return new cOrganism(m_world, ctx, genome, parent_generation, src);
+  
+  org->recycle(ctx, genome, parent_generation, src, *blank);
+  return org;
+}
+
+void cHardwareManager::ReleaseOrganism(cOrganism* org)
+{
+  if (!org) return;
+  
+  org->retire();
+  {
+    Apto::MutexAutoLock lock(m_pool_mutex);
+    if (m_org_pool.GetSize() < m_org_pool_capacity) {
+      m_org_pool.Push(org);
+      if (m_org_pool.GetSize() > m_org_idle_peak) m_org_idle_peak = m_org_pool.GetSize();
+      return;
+    }
+  }
+  delete org;
+}
+
+// Must be called with m_pool_mutex held.  The blank is rebuilt rather than modified, so that organisms still being reset
+// from the previous one are unaffected.
+Apto::SmartPtr<cPhenotype, Apto::ThreadSafeRefCount> cHardwareManager::blankPhenotype()
+{
+  // Rebuilt each update, since configuration changes made by events are picked up by the phenotype constructor
+  const int update = m_world->GetStats().GetUpdate();
+  const int env_version = m_world->GetEnvironment().GetVersion();
+  if (!m_blank_phenotype || update != m_blank_update || env_version != m_blank_env_version) {
+    m_blank_phenotype = Apto::SmartPtr<cPhenotype, Apto::ThreadSafeRefCount>(new cPhenotype(m_world, -1, 0));
+    m_blank_update = update;
+    m_blank_env_version = env_version;
+  }
+  return m_blank_phenotype;
+}
+
 bool cHardwareManager::RegisterInstSet(const Apto::String& name, cInstSet* inst_set)
 {
   if (m_is_name_map.Has(name)) return false;
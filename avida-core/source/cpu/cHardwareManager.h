@@ -22,16 +22,23 @@
 #ifndef cHardwareManager_h
 #define cHardwareManager_h
 
+#include "apto/core/Mutex.h"
+
+#include "cPhenotypeCache.h"
 #include "cTestCPU.h"
 
 namespace Avida {
   class Genome;
+  namespace Systematics {
+    struct Source;
+  };
 };
 
 class cAvidaContext;
 class cHardwareBase;
 class cInstSet;
 class cOrganism;
+class cPhenotype;
 class cStringList;
 class cUserFeedback;
 class cWorld;
@@ -46,6 +53,26 @@ private:
   cWorld* m_world;
   Apto::Array<cInstSet*> m_inst_sets;
   Apto::Map<Apto::String, int> m_is_name_map;
+  cPhenotypeCache m_phenotype_cache;
+  
+  // Hardware and organisms released by dead organisms, handed to the next birth.  Hardware is kept per instruction set.
+  // Pooled organisms are reset in place; their phenotypes are reset from a blank phenotype constructed for the current
+  // update and environment.
+  mutable Apto::Mutex m_pool_mutex;
+  Apto::Array<Apto::Array<cHardwareBase*, Apto::Smart> > m_hw_pool;
+  const int m_hw_pool_capacity;
+  int m_hw_idle;
+  int m_hw_idle_peak;
+  long m_hw_created;
+  long m_hw_reused;
+  Apto::Array<cOrganism*, Apto::Smart> m_org_pool;
+  const int m_org_pool_capacity;
+  int m_org_idle_peak;
+  long m_orgs_created;
+  long m_orgs_reused;
+  Apto::SmartPtr<cPhenotype, Apto::ThreadSafeRefCount> m_blank_phenotype;
+  int m_blank_update;
+  int m_blank_env_version;
 
   
   cHardwareManager(); // @not_implemented
@@ -65,7 +92,21 @@ public:
   bool ConvertLegacyInstSetFile(cString filename, cStringList& str_list, cUserFeedback* feedback = NULL);
   
   cHardwareBase* Create(cAvidaContext& ctx, cOrganism* org, const Genome& mg);
+  void Release(cHardwareBase* hw);
+  cOrganism* CreateOrganism(cAvidaContext& ctx, const Genome& genome, int parent_generation, Systematics::Source src);
+  void ReleaseOrganism(cOrganism* org);
   inline cTestCPU* CreateTestCPU(cAvidaContext& ctx) { return new cTestCPU(ctx, m_world); }
+  cPhenotypeCache& GetPhenotypeCache() { return m_phenotype_cache; }
+  
+  // Pool statistics; created counts are actual allocations, idle peaks are what the pool sizes cost at most
+  int GetHardwarePoolSize() const { Apto::MutexAutoLock lock(m_pool_mutex); return m_hw_idle; }
+  int GetHardwarePoolPeak() const { Apto::MutexAutoLock lock(m_pool_mutex); return m_hw_idle_peak; }
+  long GetHardwareCreated() const { Apto::MutexAutoLock lock(m_pool_mutex); return m_hw_created; }
+  long GetHardwareReused() const { Apto::MutexAutoLock lock(m_pool_mutex); return m_hw_reused; }
+  int GetOrganismPoolSize() const { Apto::MutexAutoLock lock(m_pool_mutex); return m_org_pool.GetSize(); }
+  int GetOrganismPoolPeak() const { Apto::MutexAutoLock lock(m_pool_mutex); return m_org_idle_peak; }
+  long GetOrganismsCreated() const { Apto::MutexAutoLock lock(m_pool_mutex); return m_orgs_created; }
+  long GetOrganismsReused() const { Apto::MutexAutoLock lock(m_pool_mutex); return m_orgs_reused; }
 
   inline bool IsInstSet(const Apto::String& name) const { return m_is_name_map.Has(name); }
   
@@ -80,6 +121,7 @@ public:
   bool RegisterInstSet(const Apto::String& name, cInstSet* inst_set);
     
 private:
+  Apto::SmartPtr<cPhenotype, Apto::ThreadSafeRefCount> blankPhenotype();
   bool loadInstSet(int hw_type, const Apto::String& name, int stack_size, int uops_per_cycle, cStringList& sl, cUserFeedback* feedback);
 };
 
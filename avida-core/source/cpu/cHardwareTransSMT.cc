@@ -23,6 +23,7 @@
 #include "avida/systematics/Unit.h"
 
 #include "cAvidaContext.h"
+#include "cChunkedFile.h"
 #include "cCPUTestInfo.h"
 #include "cEnvironment.h"
 #include "cInstLib.h"
@@ -148,6 +149,18 @@ cHardwareTransSMT::cHardwareTransSMT(cAvidaContext& ctx, cWorld* world, cOrganis
   Reset(ctx);                            // Setup the rest of the hardware...
 }
 
+void cHardwareTransSMT::internalRecycle(cAvidaContext& ctx)
+{
+  ConstInstructionSequencePtr org_seq_p;
+  org_seq_p.DynamicCastFrom(m_organism->GetGenome().Representation());
+  
+  m_mem_array.Resize(1);
+  m_mem_array[0] = *org_seq_p;
+  m_mem_array[0].Resize(m_mem_array[0].GetSize() + 1);
+  m_mem_array[0][m_mem_array[0].GetSize() - 1] = Instruction();
+  Reset(ctx);
+}
+
 void cHardwareTransSMT::internalReset()
 {
   // Setup the memory...
@@ -192,6 +205,113 @@ void cHardwareTransSMT::cLocalThread::Reset(cHardwareBase* in_hardware, int mem_
   skipExecution = false;
 }
 
+void cHardwareTransSMT::cLocalThread::SaveState(cChunkBuffer& buf) const
+{
+  for (int i = 0; i < nHardware::NUM_HEADS; i++) heads[i].SaveState(buf);
+  buf.PutByte(cur_head);
+  for (int i = 0; i < NUM_LOCAL_STACKS; i++) local_stacks[i].SaveState(buf);
+  
+  buf.PutBool(advance_ip);
+  buf.PutBool(skipExecution);
+  read_label.SaveState(buf);
+  next_label.SaveState(buf);
+  buf.PutBool(running);
+  
+  buf.PutDouble(context_phenotype.m_cur_merit);
+  buf.PutIntArray(context_phenotype.m_cur_task_count);
+  buf.PutIntArray(context_phenotype.m_cur_reaction_count);
+  buf.PutVarInt(context_phenotype.m_number_tasks);
+  buf.PutVarInt(context_phenotype.m_number_reactions);
+  
+  buf.PutBool(owner);
+}
+
+bool cHardwareTransSMT::cLocalThread::LoadState(cChunkBuffer& buf, cHardwareBase* in_hardware)
+{
+  for (int i = 0; i < nHardware::NUM_HEADS; i++) if (!heads[i].LoadState(buf, in_hardware)) return false;
+  cur_head = buf.GetByte();
+  if (cur_head >= nHardware::NUM_HEADS) return false;
+  for (int i = 0; i < NUM_LOCAL_STACKS; i++) if (!local_stacks[i].LoadState(buf)) return false;
+  
+  advance_ip = buf.GetBool();
+  skipExecution = buf.GetBool();
+  if (!read_label.LoadState(buf) || !next_label.LoadState(buf)) return false;
+  running = buf.GetBool();
+  
+  context_phenotype.m_cur_merit = buf.GetDouble();
+  if (!buf.GetIntArray(context_phenotype.m_cur_task_count)) return false;
+  if (!buf.GetIntArray(context_phenotype.m_cur_reaction_count)) return false;
+  context_phenotype.m_number_tasks = (int)buf.GetVarInt();
+  context_phenotype.m_number_reactions = (int)buf.GetVarInt();
+  
+  // The parasite that owns an injected thread is not part of the saved state
+  owner = Systematics::UnitPtr(NULL);
+  return !buf.GetBool() && !buf.Fail();
+}
+
+void cHardwareTransSMT::SaveState(cChunkBuffer& buf) const
+{
+  saveBaseState(buf);
+  
+  buf.PutVarUInt(m_mem_array.GetSize());
+  for (int i = 0; i < m_mem_array.GetSize(); i++) m_mem_array[i].SaveState(buf);
+  buf.PutVarUInt(m_mem_lbls.GetSize());
+  for (Apto::Map<int, int>::KeyIterator it = m_mem_lbls.Keys(); it.Next();) {
+    int mem_space = 0;
+    m_mem_lbls.Get(*it.Get(), mem_space);
+    buf.PutVarInt(*it.Get());
+    buf.PutVarInt(mem_space);
+  }
+  for (int i = 0; i < NUM_GLOBAL_STACKS; i++) m_global_stacks[i].SaveState(buf);
+  
+  buf.PutVarUInt(m_threads.GetSize());
+  for (int i = 0; i < m_threads.GetSize(); i++) m_threads[i].SaveState(buf);
+  buf.PutVarUInt(m_thread_lbls.GetSize());
+  for (Apto::Map<int, int>::KeyIterator it = m_thread_lbls.Keys(); it.Next();) {
+    int thread_id = 0;
+    m_thread_lbls.Get(*it.Get(), thread_id);
+    buf.PutVarInt(*it.Get());
+    buf.PutVarInt(thread_id);
+  }
+  buf.PutVarInt(m_cur_thread);
+  buf.PutVarInt(m_cur_child);
+}
+
+bool cHardwareTransSMT::LoadState(cChunkBuffer& buf)
+{
+  if (!loadBaseState(buf)) return false;
+  
+  // Memory spaces first, so that the heads are restored against them
+  const int num_mem = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_mem < 1 || num_mem > buf.GetRemaining()) return false;
+  m_mem_array.Resize(num_mem);
+  for (int i = 0; i < num_mem; i++) if (!m_mem_array[i].LoadState(buf)) return false;
+  const int num_mem_lbls = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_mem_lbls > buf.GetRemaining()) return false;
+  m_mem_lbls.Clear();
+  for (int i = 0; i < num_mem_lbls; i++) {
+    const int key = (int)buf.GetVarInt();
+    m_mem_lbls.Set(key, (int)buf.GetVarInt());
+  }
+  for (int i = 0; i < NUM_GLOBAL_STACKS; i++) if (!m_global_stacks[i].LoadState(buf)) return false;
+  
+  const int num_threads = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_threads < 1 || num_threads > buf.GetRemaining()) return false;
+  m_threads.Resize(num_threads);
+  for (int i = 0; i < num_threads; i++) if (!m_threads[i].LoadState(buf, this)) return false;
+  const int num_thread_lbls = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_thread_lbls > buf.GetRemaining()) return false;
+  m_thread_lbls.Clear();
+  for (int i = 0; i < num_thread_lbls; i++) {
+    const int key = (int)buf.GetVarInt();
+    m_thread_lbls.Set(key, (int)buf.GetVarInt());
+  }
+  m_cur_thread = (int)buf.GetVarInt();
+  m_cur_child = (int)buf.GetVarInt();
+  
+  return !buf.Fail() && m_cur_thread >= 0 && m_cur_thread < num_threads;
+}
+
 Systematics::UnitPtr cHardwareTransSMT::ThreadGetOwner()
 {
   Systematics::UnitPtr orgp(m_organism);
@@ -422,6 +542,8 @@ cHeadCPU cHardwareTransSMT::FindLabel(int direction)
     return inst_ptr;
   }
 	
+  useNopIndex(inst_ptr.GetMemory());
+	
   // Call special functions depending on if jump is forwards or backwards.
   int found_pos = 0;
   if( direction < 0 ) {
@@ -452,7 +574,7 @@ cHeadCPU cHardwareTransSMT::FindLabel(int direction)
 // memory.  Return the first line _after_ the the found label.  It is okay
 // to find search label's match inside another label.
 int cHardwareTransSMT::FindLabel_Forward(const cCodeLabel& search_label,
-                                         const InstructionSequence& search_genome, int pos)
+                                         const cCPUMemory& search_genome, int pos)
 {
   assert (pos < search_genome.GetSize() && pos >= 0);
 	
@@ -460,6 +582,26 @@ int cHardwareTransSMT::FindLabel_Forward(const cCodeLabel& search_label,
   int label_size = search_label.GetSize();
   bool found_label = false;
 	
+  // With the nop index, visit only the labels the scan below would stop in (see cHardwareCPU::FindLabel_Forward)
+  if (search_genome.HasNopIndex()) {
+    const int num_runs = search_genome.GetNumNopRuns();
+    for (int run = search_genome.FindNopRun(search_start); run < num_runs; run++) {
+      const int start_pos = Apto::Max(search_genome.GetNopRunStart(run), search_start);
+      const int end_pos = search_genome.GetNopRunEnd(run);
+      const int test_size = end_pos - start_pos;
+      if (test_size < label_size || (start_pos == search_start && test_size == label_size)) continue;
+      
+      for (int offset = start_pos; offset <= end_pos - label_size; offset++) {
+        int matches;
+        for (matches = 0; matches < label_size; matches++) {
+          if (search_label[matches] != m_inst_set->GetNopMod(search_genome[offset + matches])) break;
+        }
+        if (matches == label_size) return offset + label_size;
+      }
+    }
+    return -1;
+  }
+	
   // Move off the template we are on.
   pos += label_size;
 	
@@ -533,7 +675,7 @@ int cHardwareTransSMT::FindLabel_Forward(const cCodeLabel& search_label,
 // memory.  Return the first line _after_ the the found label.  It is okay
 // to find search label's match inside another label.
 int cHardwareTransSMT::FindLabel_Backward(const cCodeLabel & search_label,
-                                          const InstructionSequence & search_genome, int pos)
+                                          const cCPUMemory & search_genome, int pos)
 {
   assert (pos < search_genome.GetSize());
 	
@@ -541,6 +683,23 @@ int cHardwareTransSMT::FindLabel_Backward(const cCodeLabel & search_label,
   int label_size = search_label.GetSize();
   bool found_label = false;
 	
+  // With the nop index, visit the labels before the start position from the nearest back, as the scan below does
+  if (search_genome.HasNopIndex()) {
+    for (int run = search_genome.FindNopRunBefore(search_start); run >= 0; run--) {
+      const int start_pos = search_genome.GetNopRunStart(run);
+      const int end_pos = Apto::Min(search_genome.GetNopRunEnd(run), search_start);
+      
+      for (int offset = start_pos; offset <= end_pos - label_size; offset++) {
+        int matches;
+        for (matches = 0; matches < label_size; matches++) {
+          if (search_label[matches] != m_inst_set->GetNopMod(search_genome[offset + matches])) break;
+        }
+        if (matches == label_size) return end_pos;
+      }
+    }
+    return -1;
+  }
+	
   // Move off the template we are on.
   pos -= label_size;
 	
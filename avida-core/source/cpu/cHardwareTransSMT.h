@@ -78,6 +78,8 @@ protected:
     ~cLocalThread() { ; }
     
     void Reset(cHardwareBase* in_hardware, int mem_space = 0);
+    void SaveState(cChunkBuffer& buf) const;
+    bool LoadState(cChunkBuffer& buf, cHardwareBase* in_hardware);  // Fails for threads owned by a parasite
   };
   
   // --------  Static Variables  --------
@@ -130,8 +132,8 @@ protected:
   cCodeLabel& GetLabel() { return m_threads[m_cur_thread].next_label; }
   void ReadLabel(int max_size = cCodeLabel::MAX_LENGTH);
   cHeadCPU FindLabel(int direction);
-  int FindLabel_Forward(const cCodeLabel& search_label, const InstructionSequence& search_genome, int pos);
-  int FindLabel_Backward(const cCodeLabel& search_label, const InstructionSequence& search_genome, int pos);
+  int FindLabel_Forward(const cCodeLabel& search_label, const cCPUMemory& search_genome, int pos);
+  int FindLabel_Backward(const cCodeLabel& search_label, const cCPUMemory& search_genome, int pos);
   cHeadCPU FindLabel(const cCodeLabel& in_label, int direction);
   const cCodeLabel& GetReadLabel() const { return m_threads[m_cur_thread].read_label; }
   cCodeLabel& GetReadLabel() { return m_threads[m_cur_thread].read_label; }
@@ -159,6 +161,7 @@ protected:
 
   void internalReset();
 	void internalResetOnFailedDivide();
+  void internalRecycle(cAvidaContext& ctx);
   
   
   int calcCopiedSize(const int parent_size, const int child_size);
@@ -190,6 +193,9 @@ public:
   // --------  Helper methods  --------
   int GetType() const { return HARDWARE_TYPE_CPU_TRANSSMT; }
   bool SupportsSpeculative() const { return false; }
+  bool SupportsRecycle() const { return true; }
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
   void PrintStatus(std::ostream& fp);
   void SetupMiniTraceFileHeader(Avida::Output::File& df, const int gen_id, const Apto::String& genotype) { }
   void PrintMiniTraceStatus(cAvidaContext& ctx, std::ostream& fp) { (void)ctx; (void)fp; }
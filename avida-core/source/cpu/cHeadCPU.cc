@@ -22,6 +22,8 @@
 
 #include "cHeadCPU.h"
 
+#include "cChunkedFile.h"
+
 #include <cassert>
 
 
@@ -52,3 +54,21 @@ void cHeadCPU::fullAdjust(int mem_size)
   else m_position %= mem_size;
 }
 
+
+void cHeadCPU::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarInt(m_mem_space);
+  buf.PutVarInt(m_position);
+}
+
+bool cHeadCPU::LoadState(cChunkBuffer& buf, cHardwareBase* hw)
+{
+  const int mem_space = (int)buf.GetVarInt();
+  const int position = (int)buf.GetVarInt();
+  if (buf.Fail() || mem_space < 0 || mem_space >= hw->GetNumMemSpaces()) return false;
+  
+  // Bind to the memory space, then restore the position as saved (it may be waiting on an adjustment)
+  Reset(hw, mem_space);
+  m_position = position;
+  return true;
+}
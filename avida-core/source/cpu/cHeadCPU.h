@@ -33,6 +33,7 @@
  * The cHeadCPU class contains a pointer to locations in memory for a CPU.
  **/
 
+class cChunkBuffer;
 class cCodeLabel;
 class cString;
 
@@ -61,6 +62,11 @@ public:
   
   inline void Adjust() { if (m_mem_space != m_cached_ms || m_position < 0 || m_position >= GetMemSize()) fullAdjust(); }
   inline void Reset(cHardwareBase* hw, int ms = 0) { m_hardware = hw; m_position = 0; m_mem_space = ms; if (hw) Adjust(); }
+  inline void Rebind(cHardwareBase* hw) { m_hardware = hw; m_cached_ms = -1; if (hw) Adjust(); }
+  
+  // Snapshot state.  The position is restored exactly, so the memory of hw must already be restored.
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf, cHardwareBase* hw);
   
   inline int GetMemSpace() const { return m_mem_space; }
   inline int GetPosition() const { return m_position; }
@@ -53,6 +53,8 @@ cInstSet::cInstSet(const cInstSet& _in)
   , m_has_choosy_female_costs(_in.m_has_choosy_female_costs)
   , m_has_post_costs(_in.m_has_post_costs)
   , m_has_bonus_costs(_in.m_has_bonus_costs)
+  , m_has_prob_fail(_in.m_has_prob_fail)
+  , m_has_addl_time_costs(_in.m_has_addl_time_costs)
 {
   m_mutation_index = new cOrderedWeightedIndex(*_in.m_mutation_index);
 }
@@ -74,6 +76,8 @@ cInstSet& cInstSet::operator=(const cInstSet& _in)
   m_has_choosy_female_costs = _in.m_has_choosy_female_costs;
   m_has_post_costs = _in.m_has_post_costs;
   m_has_bonus_costs = _in.m_has_bonus_costs;
+  m_has_prob_fail = _in.m_has_prob_fail;
+  m_has_addl_time_costs = _in.m_has_addl_time_costs;
 
   m_mutation_index = new cOrderedWeightedIndex(*_in.m_mutation_index);
   return *this;
@@ -89,6 +93,15 @@ Instruction cInstSet::GetRandomInst(cAvidaContext& ctx) const
 
 
 
+void cInstSet::SetProbFail(const Instruction& inst, double _prob_fail)
+{
+  m_lib_name_map[inst.GetOp()].prob_fail = _prob_fail;
+  
+  // Keep HasProbFail() in step, the hardware checks it before rolling for a failure
+  m_has_prob_fail = false;
+  for (int i = 0; i < m_lib_name_map.GetSize(); i++) if (m_lib_name_map[i].prob_fail > 0.0) m_has_prob_fail = true;
+}
+
 Instruction cInstSet::ActivateNullInst()
 {  
   const int inst_id = m_lib_name_map.GetSize();
@@ -250,6 +263,8 @@ bool cInstSet::LoadWithStringList(const cStringList& sl, cUserFeedback* feedback
     if (m_lib_name_map[inst_id].choosy_female_cost) m_has_choosy_female_costs = true;
     if (m_lib_name_map[inst_id].post_cost > 1) m_has_post_costs = true;
     if (m_lib_name_map[inst_id].bonus_cost) m_has_bonus_costs = true;
+    if (m_lib_name_map[inst_id].prob_fail > 0.0) m_has_prob_fail = true;
+    if (m_lib_name_map[inst_id].addl_time_cost) m_has_addl_time_costs = true;
     
     // Parse the instruction code
     cString inst_code = args->GetString(0);
@@ -313,7 +328,7 @@ bool cInstSet::LoadWithStringList(const cStringList& sl, cUserFeedback* feedback
 }
 
 
-void cInstSet::SaveInstructionSequence(ofstream& of, const InstructionSequence& seq) const
+void cInstSet::SaveInstructionSequence(ostream& of, const InstructionSequence& seq) const
 {
   for (int i = 0; i < seq.GetSize(); i++) of << GetName(seq[i]) << endl;  
 }
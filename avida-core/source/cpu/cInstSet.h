@@ -88,6 +88,8 @@ public:
   bool m_has_choosy_female_costs;
   bool m_has_post_costs;
   bool m_has_bonus_costs;
+  bool m_has_prob_fail;
+  bool m_has_addl_time_costs;
   
   int m_stack_size;
   int m_uops_per_cycle;
@@ -98,7 +100,8 @@ public:
   inline cInstSet(cWorld* world, const cString& name, int hw_type, cInstLib* inst_lib, int stack_size, int uops_per_cycle)
     : m_world(world), m_name(name), m_hw_type(hw_type), m_inst_lib(inst_lib), m_mutation_index(NULL)
     , m_has_costs(false), m_has_ft_costs(false), m_has_energy_costs(false), m_has_res_costs(false), m_has_fem_res_costs(false)
-    , m_has_female_costs(false), m_has_choosy_female_costs(false), m_has_post_costs(false), m_has_bonus_costs(false), m_stack_size(stack_size)
+    , m_has_female_costs(false), m_has_choosy_female_costs(false), m_has_post_costs(false), m_has_bonus_costs(false)
+    , m_has_prob_fail(false), m_has_addl_time_costs(false), m_stack_size(stack_size)
     , m_uops_per_cycle(uops_per_cycle) { ; }
   cInstSet(const cInstSet&); 
   cInstSet& operator=(const cInstSet&); 
@@ -148,6 +151,8 @@ public:
   bool HasChoosyFemaleCosts() const { return m_has_choosy_female_costs; }
   bool HasPostCosts() const { return m_has_post_costs; }
   bool HasBonusCosts() const { return m_has_bonus_costs; }
+  bool HasProbFail() const { return m_has_prob_fail; }
+  bool HasAddlTimeCosts() const { return m_has_addl_time_costs; }
   
   int GetStackSize() const { return m_stack_size; }
   int GetUOpsPerCycle() const { return m_uops_per_cycle; }
@@ -168,7 +173,7 @@ public:
   Instruction ActivateNullInst();
   
   // Modification of instructions during run.
-  void SetProbFail(const Instruction& inst, double _prob_fail) { m_lib_name_map[inst.GetOp()].prob_fail = _prob_fail; }
+  void SetProbFail(const Instruction& inst, double _prob_fail);
   void SetRedundancy(const Instruction& inst, int _redundancy) { m_lib_name_map[inst.GetOp()].redundancy = _redundancy; m_mutation_index->SetWeight(inst.GetOp(), _redundancy);}
 
   // accessors for instruction library
@@ -184,7 +189,7 @@ public:
   
   bool LoadWithStringList(const cStringList& sl, cUserFeedback* errors = NULL);
   
-  void SaveInstructionSequence(ofstream& of, const InstructionSequence& seq) const;
+  void SaveInstructionSequence(ostream& of, const InstructionSequence& seq) const;
 };
 
 
@@ -0,0 +1,120 @@
+/*
+ *  cPhenotypeCache.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPhenotypeCache.h"
+
+#include "avida/core/Genome.h"
+
+
+cPhenotypeCache::cPhenotypeCache(int capacity)
+: m_capacity((capacity > 0) ? capacity : 0), m_next(0), m_env_version(-1)
+, m_hits(0), m_misses(0), m_evictions(0), m_invalidations(0)
+{
+  m_order.Resize(m_capacity);
+}
+
+
+void cPhenotypeCache::syncVersion(int env_version)
+{
+  // Caller must hold m_mutex
+  if (env_version == m_env_version) return;
+
+  if (m_entries.GetSize()) m_invalidations++;
+  m_entries.Clear();
+  for (int i = 0; i < m_order.GetSize(); i++) m_order[i] = "";
+  m_next = 0;
+  m_env_version = env_version;
+}
+
+
+bool cPhenotypeCache::Lookup(const Genome& genome, int env_version, sPhenotype& phenotype)
+{
+  if (!m_capacity) return false;
+
+  Apto::String key(genome.AsString());
+
+  Apto::MutexAutoLock lock(m_mutex);
+  syncVersion(env_version);
+  if (m_entries.Get(key, phenotype)) {
+    m_hits++;
+    return true;
+  }
+  m_misses++;
+  return false;
+}
+
+void cPhenotypeCache::Insert(const Genome& genome, int env_version, const sPhenotype& phenotype)
+{
+  if (!m_capacity) return;
+
+  Apto::String key(genome.AsString());
+
+  Apto::MutexAutoLock lock(m_mutex);
+  syncVersion(env_version);
+  if (m_entries.Has(key)) return;   // another thread finished the same test first
+
+  if (m_entries.GetSize() >= m_capacity) {
+    m_entries.Remove(m_order[m_next]);
+    m_evictions++;
+  }
+  m_entries.Set(key, phenotype);
+  m_order[m_next] = key;
+  m_next = (m_next + 1) % m_capacity;
+}
+
+void cPhenotypeCache::Clear()
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  m_entries.Clear();
+  for (int i = 0; i < m_order.GetSize(); i++) m_order[i] = "";
+  m_next = 0;
+}
+
+
+int cPhenotypeCache::GetSize() const
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  return m_entries.GetSize();
+}
+
+long cPhenotypeCache::GetHits() const
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  return m_hits;
+}
+
+long cPhenotypeCache::GetMisses() const
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  return m_misses;
+}
+
+long cPhenotypeCache::GetEvictions() const
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  return m_evictions;
+}
+
+long cPhenotypeCache::GetInvalidations() const
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  return m_invalidations;
+}
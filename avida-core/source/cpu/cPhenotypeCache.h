@@ -0,0 +1,94 @@
+/*
+ *  cPhenotypeCache.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cPhenotypeCache_h
+#define cPhenotypeCache_h
+
+#include "apto/core.h"
+#include "apto/core/Mutex.h"
+
+#include "cMerit.h"
+
+namespace Avida {
+  class Genome;
+};
+
+using namespace Avida;
+
+
+// Bounded memo of test CPU results used by PRECALC_PHENOTYPE with fixed test inputs.  Entries are keyed by the full
+// genome (hardware type, instruction set and sequence) and belong to a single environment version; the whole cache is
+// dropped whenever the version changes, so altered reactions or resources never return stale results.  Once full, the
+// oldest entry is evicted first.  All methods are safe to call concurrently.
+
+class cPhenotypeCache
+{
+public:
+  struct sPhenotype
+  {
+    cMerit merit;
+    int gestation_time;
+    Apto::Array<int> last_inst_count;
+
+    sPhenotype() : gestation_time(0) { ; }
+  };
+
+private:
+  const int m_capacity;
+
+  mutable Apto::Mutex m_mutex;
+  Apto::Map<Apto::String, sPhenotype> m_entries;
+  Apto::Array<Apto::String> m_order;    // ring of keys in insertion order, used to pick eviction victims
+  int m_next;                           // next slot of m_order to be (re)filled
+  int m_env_version;
+
+  long m_hits;
+  long m_misses;
+  long m_evictions;
+  long m_invalidations;
+
+
+  void syncVersion(int env_version);
+
+  cPhenotypeCache(); // @not_implemented
+  cPhenotypeCache(const cPhenotypeCache&); // @not_implemented
+  cPhenotypeCache& operator=(const cPhenotypeCache&); // @not_implemented
+
+public:
+  // capacity <= 0 disables the cache; lookups always miss and nothing is stored
+  cPhenotypeCache(int capacity);
+  ~cPhenotypeCache() { ; }
+
+  bool IsEnabled() const { return m_capacity > 0; }
+  int GetCapacity() const { return m_capacity; }
+
+  bool Lookup(const Genome& genome, int env_version, sPhenotype& phenotype);
+  void Insert(const Genome& genome, int env_version, const sPhenotype& phenotype);
+  void Clear();
+
+  int GetSize() const;
+  long GetHits() const;
+  long GetMisses() const;
+  long GetEvictions() const;
+  long GetInvalidations() const;
+};
+
+#endif
@@ -33,11 +33,15 @@
 #include "cInstSet.h"
 #include "cOrganism.h"
 #include "cPhenotype.h"
+#include "cReaction.h"
+#include "cReactionLib.h"
+#include "cReactionProcess.h"
 #include "cResource.h"
 #include "cResourceCount.h"
 #include "cResourceHistory.h"
 #include "cResourceLib.h"
 #include "cStringUtil.h"
+#include "cTestCPUCheckpoints.h"
 #include "cTestCPUInterface.h"
 #include "cWorld.h"
 #include "tMatrix.h"
@@ -54,6 +58,8 @@ cTestCPU::cTestCPU(cAvidaContext& ctx, cWorld* world)
 	m_use_manual_inputs = false;
   m_test_solo_res = -1;
   m_test_solo_res_lev = 0;
+  m_record = NULL;
+  m_resume = NULL;
   InitResources(ctx);
 }  
 
@@ -140,6 +146,35 @@ void cTestCPU::ModifyResources(cAvidaContext& ctx, const Apto::Array<double>& re
 }
 
 
+// Checkpoints require that nothing but the genome sites reported by the hardware influences the gestation, and that
+// no random numbers are drawn during it.
+bool cTestCPU::canCheckpoint(cOrganism& organism, cCPUTestInfo& test_info)
+{
+  if (!organism.GetHardware().SupportsCheckpoint()) return false;
+  if (test_info.GetTracer()) return false;
+  if (test_info.m_res_method >= RES_UPDATED_DEPLETABLE) return false;
+  if (m_world->GetConfig().ENERGY_ENABLED.Get()) return false;
+
+  const cMutationRates& rates = test_info.MutationRates();
+  if (rates.GetCopyMutProb() != 0.0 || rates.GetCopyInsProb() != 0.0 || rates.GetCopyDelProb() != 0.0 ||
+      rates.GetCopyUniformProb() != 0.0 || rates.GetCopySlipProb() != 0.0) {
+    return false;
+  }
+
+  const cReactionLib& reaction_lib = m_world->GetEnvironment().GetReactionLib();
+  for (int i = 0; i < reaction_lib.GetSize(); i++) {
+    tLWConstListIterator<cReactionProcess> proc_it(reaction_lib.GetReaction(i)->GetProcesses());
+    const cReactionProcess* cur_proc;
+    while ((cur_proc = proc_it.Next()) != NULL) {
+      if (cur_proc->GetDetect() != NULL || cur_proc->GetInst() != "" || cur_proc->GetIsRandomResource()) return false;
+      if (cur_proc->GetLethal() != 0.0 && cur_proc->GetLethal() != 1.0) return false;
+    }
+  }
+
+  return true;
+}
+
+
 // NOTE: This method assumes that the organism is a fresh creation.
 bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth)
 {
@@ -164,9 +199,32 @@ bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int
   // This way of keeping track of time is only used to update resources...
   int time_used = m_res_cpu_cycle_offset; // Note: the offset is zero by default if no resources being used @JEB
   
+  // Record the base genome of a mutational scan, or pick up a mutant where the recording says it is safe to
+  cTestCPUCheckpoints* record = NULL;
+  const int env_version = m_world->GetEnvironment().GetVersion();
+  if (cur_depth == 0 && m_record) {
+    m_record->Clear();
+    if (canCheckpoint(organism, test_info)) {
+      record = m_record;
+      record->Start(organism.GetHardware().GetInstSet(), *seq, env_version, test_info, input_array, receive_array);
+      organism.GetHardware().SetCheckpointRecorder(record);
+    }
+  } else if (cur_depth == 0 && m_resume && organism.GetHardware().SupportsCheckpoint()) {
+    const cTestCPUCheckpoints::sSnapshot* snapshot =
+      m_resume->FindResumePoint(organism.GetHardware().GetInstSet(), *seq, env_version, test_info, input_array,
+                                receive_array);
+    if (snapshot) {
+      m_resume->Restore(*snapshot, *seq, organism);
+      cur_input = snapshot->cur_input;
+      cur_receive = snapshot->cur_receive;
+      time_used += snapshot->cycle;
+    }
+  }
+  
   organism.GetHardware().SetTrace(test_info.GetTracer());
   while (time_used < time_allocated && organism.GetPhenotype().GetNumDivides() == 0 && !organism.IsDead())
   {
+    if (record) record->Step(organism, cur_input, cur_receive);
     time_used++;
     
     // @CAO Need to watch out for parasites.
@@ -178,6 +236,10 @@ bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int
   }
   
   organism.GetHardware().SetTrace(HardwareTracerPtr(NULL));
+  if (record) {
+    organism.GetHardware().SetCheckpointRecorder(NULL);
+    record->Finish(true);
+  }
 
   // Print out some final info in trace...
   if (test_info.GetTracer()) test_info.GetTracer()->TraceTestCPU(time_used, time_allocated, organism);
@@ -187,9 +249,20 @@ bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int
 }
 
 
+void cTestCPU::releaseOrganisms(cCPUTestInfo& test_info)
+{
+  // Hand the organisms of the previous test back to the world's pool, rather than letting cCPUTestInfo delete them
+  for (int i = 0; i < test_info.generation_tests; i++) {
+    if (test_info.org_array[i] == NULL) break;
+    m_world->GetHardwareManager().ReleaseOrganism(test_info.org_array[i]);
+    test_info.org_array[i] = NULL;
+  }
+}
+
 bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome)
 {
   ctx.SetTestMode();
+  releaseOrganisms(test_info);
   test_info.Clear();
   TestGenome_Body(ctx, test_info, genome, 0);
   ctx.ClearTestMode();
@@ -197,9 +270,10 @@ bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Gen
   return test_info.is_viable;
 }
 
-bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, ofstream& out_fp)
+bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, ostream& out_fp)
 {
   ctx.SetTestMode();
+  releaseOrganisms(test_info);
   test_info.Clear();
   TestGenome_Body(ctx, test_info, genome, 0);
 
@@ -230,6 +304,57 @@ bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Gen
   return test_info.is_viable;
 }
 
+bool cTestCPU::RecordCheckpoints(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome,
+                                 cTestCPUCheckpoints& checkpoints)
+{
+  m_record = &checkpoints;
+  const bool is_viable = TestGenome(ctx, test_info, genome);
+  m_record = NULL;
+  return is_viable;
+}
+
+bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome,
+                          const cTestCPUCheckpoints& checkpoints)
+{
+  m_resume = &checkpoints;
+  const bool is_viable = TestGenome(ctx, test_info, genome);
+  m_resume = NULL;
+  return is_viable;
+}
+
+void cTestCPU::PrecalcPhenotype(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome,
+                                cPhenotypeCache::sPhenotype& phenotype)
+{
+  if (!m_world->GetConfig().PRECALC_PHENOTYPE_INPUTS.Get()) {
+    runPrecalc(ctx, test_info, genome, phenotype);
+    return;
+  }
+  
+  // Fixed input tests run on the environment's fixed inputs with a private, fixed seed random stream.  The result then
+  // depends only on the genome and environment, so a cached result is exactly what a fresh test would return, and
+  // the world's random stream is untouched either way.
+  cPhenotypeCache& cache = m_world->GetHardwareManager().GetPhenotypeCache();
+  const int env_version = m_world->GetEnvironment().GetVersion();
+  if (cache.Lookup(genome, env_version, phenotype)) return;
+  
+  Apto::RNG::AvidaRNG rng(PRECALC_FIXED_SEED);
+  cAvidaContext test_ctx(ctx.HasDriver() ? &ctx.Driver() : NULL, rng);
+  test_info.ResetInputMode();
+  runPrecalc(test_ctx, test_info, genome, phenotype);
+  
+  cache.Insert(genome, env_version, phenotype);
+}
+
+void cTestCPU::runPrecalc(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome,
+                          cPhenotypeCache::sPhenotype& phenotype)
+{
+  TestGenome(ctx, test_info, genome);
+  const cPhenotype& test_phenotype = test_info.GetTestPhenotype();
+  phenotype.merit = test_phenotype.GetMerit();
+  phenotype.gestation_time = test_phenotype.GetGestationTime();
+  phenotype.last_inst_count = test_phenotype.GetLastInstCount();
+}
+
 bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth)
 {
   assert(cur_depth < test_info.generation_tests);
@@ -258,9 +383,9 @@ bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, cons
 
   // Setup the organism we're working with now.
   if (test_info.org_array[cur_depth] != NULL) {
-    delete test_info.org_array[cur_depth];
+    m_world->GetHardwareManager().ReleaseOrganism(test_info.org_array[cur_depth]);
   }
-  cOrganism* organism = new cOrganism(m_world, ctx, genome, -1, Systematics::Source(Systematics::DIVISION, "", true));
+  cOrganism* organism = m_world->GetHardwareManager().CreateOrganism(ctx, genome, -1, Systematics::Source(Systematics::DIVISION, "", true));
   
   // Copy the test mutation rates
   organism->MutationRates().Copy(test_info.MutationRates());
@@ -430,6 +555,7 @@ void cTestCPU::PrintGenome(cAvidaContext& ctx, const Genome& genome, cString fil
 
 void cTestCPU::ResetInputs(cAvidaContext& ctx) 
 { 
+  if (m_record) m_record->TouchInputs();
 	if (!m_use_manual_inputs)
 		m_world->GetEnvironment().SetupInputs(ctx, input_array, m_use_random_inputs);
 }
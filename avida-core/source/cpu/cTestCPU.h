@@ -28,6 +28,8 @@
 #include "cString.h"
 #include "cResourceCount.h"
 #include "cCPUTestInfo.h"
+#include "cPhenotypeCache.h"
+#include "cTestCPUCheckpoints.h"
 #include "cWorld.h"
 
 
@@ -43,6 +45,7 @@ using namespace Avida;
 class cTestCPU
 {
 public:
+  static const int PRECALC_FIXED_SEED = 1;  // random seed of every fixed input phenotype precalculation
 
 private:
   cWorld* m_world;
@@ -66,10 +69,17 @@ private:
   cResourceCount m_faced_cell_resource_count;
   cResourceCount m_deme_resource_count;
   cResourceCount m_cell_resource_count;
+  
+  // Mutational scans and repeated trials, only apply to the top level organism of a test
+  cTestCPUCheckpoints* m_record;          // Base gestation being recorded
+  const cTestCPUCheckpoints* m_resume;    // Base gestation the current test may resume from
     
 
+  bool canCheckpoint(cOrganism& organism, cCPUTestInfo& test_info);
   bool ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth);
   bool TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth);
+  void releaseOrganisms(cCPUTestInfo& test_info);
+  void runPrecalc(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, cPhenotypeCache::sPhenotype& phenotype);
 
   
   cTestCPU(); // @not_implemented
@@ -88,13 +98,25 @@ public:
   ~cTestCPU() { }
   
   bool TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome);
-  bool TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, std::ofstream& out_fp);
+  bool TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, std::ostream& out_fp);
+
+  // Mutational scans: test the base genome once while recording its gestation, then test each mutant of the same length
+  // against the recording.  Mutant results are identical to those of TestGenome, but the part of the gestation that
+  // precedes the first use of a mutated site is skipped when the configuration allows it (see cTestCPUCheckpoints).
+  // Trials of the base genome itself on other inputs likewise skip the part that precedes the first input read.
+  bool RecordCheckpoints(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, cTestCPUCheckpoints& checkpoints);
+  bool TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, const cTestCPUCheckpoints& checkpoints);
+
+  // Merit, gestation time and instruction counts of genome, for PRECALC_PHENOTYPE.  Runs on test_info's inputs, or with
+  // PRECALC_PHENOTYPE_INPUTS set on the fixed test inputs and PRECALC_FIXED_SEED, reusing results from the world's
+  // phenotype cache when it is enabled.
+  void PrecalcPhenotype(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, cPhenotypeCache::sPhenotype& phenotype);
   
   void PrintGenome(cAvidaContext& ctx, const Genome& genome, cString filename = "", int update = -1, bool for_groups = false, int last_birth_cell = 0, int last_group_id = -1, int last_forager_type = -1);
 
   inline int GetInput();
   inline int GetInputAt(int & input_pointer);
-  inline const Apto::Array<int>& GetInputs() const { return input_array; }
+  inline const Apto::Array<int>& GetInputs() const;
   void ResetInputs(cAvidaContext& ctx);
 
   inline int GetReceiveValue();
@@ -125,18 +147,27 @@ public:
 
 inline int cTestCPU::GetInput()
 {
+  if (m_record) m_record->TouchInputs();
   if (cur_input >= input_array.GetSize()) cur_input = 0;
   return input_array[cur_input++];
 }
 
 inline int cTestCPU::GetInputAt(int & input_pointer)
 {
+  if (m_record) m_record->TouchInputs();
   if (input_pointer >= input_array.GetSize()) input_pointer = 0;
   return input_array[input_pointer++];
 }
 
+inline const Apto::Array<int>& cTestCPU::GetInputs() const
+{
+  if (m_record) m_record->TouchInputs();
+  return input_array;
+}
+
 inline int cTestCPU::GetReceiveValue()
 {
+  if (m_record) m_record->TouchInputs();
   if (cur_receive >= receive_array.GetSize()) cur_receive = 0;
   return receive_array[cur_receive++];
 }
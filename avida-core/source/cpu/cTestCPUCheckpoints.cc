@@ -0,0 +1,192 @@
+/*
+ *  cTestCPUCheckpoints.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cTestCPUCheckpoints.h"
+
+#include "cCPUMemory.h"
+#include "cHardwareBase.h"
+#include "cInstSet.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+
+
+static bool sameValues(const Apto::Array<int>& a, const Apto::Array<int>& b)
+{
+  if (a.GetSize() != b.GetSize()) return false;
+  for (int i = 0; i < a.GetSize(); i++) if (a[i] != b[i]) return false;
+  return true;
+}
+
+
+cTestCPUCheckpoints::sSnapshot::~sSnapshot()
+{
+  delete hardware;
+  delete phenotype;
+}
+
+
+cTestCPUCheckpoints::cTestCPUCheckpoints()
+: m_valid(false), m_inst_set(NULL), m_interval(1), m_cycle(0), m_input_touch(NEVER), m_env_version(-1)
+, m_res_method(RES_INITIAL), m_res(NULL), m_res_update(0), m_res_cpu_cycle_offset(0)
+{
+}
+
+
+inline int cTestCPUCheckpoints::nopClass(const Instruction& inst) const
+{
+  return m_inst_set->IsNop(inst) ? m_inst_set->GetNopMod(inst) : -1;
+}
+
+
+void cTestCPUCheckpoints::Clear()
+{
+  for (int i = 0; i < m_snapshots.GetSize(); i++) delete m_snapshots[i];
+  m_snapshots.Resize(0);
+  m_inst_touch.Resize(0);
+  m_nop_touch.Resize(0);
+  m_input_touch = NEVER;
+  m_valid = false;
+  m_cycle = 0;
+}
+
+
+void cTestCPUCheckpoints::Start(const cInstSet& inst_set, const InstructionSequence& base, int env_version,
+                                const cCPUTestInfo& test_info, const Apto::Array<int>& inputs,
+                                const Apto::Array<int>& receive)
+{
+  Clear();
+
+  m_inst_set = &inst_set;
+  m_base = base;
+  m_interval = Apto::Max(1, base.GetSize() / 8);
+
+  m_inst_touch.Resize(base.GetSize());
+  m_inst_touch.SetAll(NEVER);
+  m_nop_touch.Resize(base.GetSize());
+  m_nop_touch.SetAll(NEVER);
+
+  m_env_version = env_version;
+  m_res_method = test_info.m_res_method;
+  m_res = test_info.m_res;
+  m_res_update = test_info.m_res_update;
+  m_res_cpu_cycle_offset = test_info.m_res_cpu_cycle_offset;
+  m_inputs = inputs;
+  m_receive = receive;
+}
+
+void cTestCPUCheckpoints::Step(cOrganism& organism, int cur_input, int cur_receive)
+{
+  // Save the state reached before the cycle about to run
+  if (m_cycle > 0 && m_cycle % m_interval == 0) {
+    if (m_snapshots.GetSize() == MAX_SNAPSHOTS) {
+      // Out of room, keep every other snapshot and save half as often from now on
+      m_interval *= 2;
+      int kept = 0;
+      for (int i = 0; i < m_snapshots.GetSize(); i++) {
+        if (m_snapshots[i]->cycle % m_interval == 0) m_snapshots[kept++] = m_snapshots[i];
+        else delete m_snapshots[i];
+      }
+      m_snapshots.Resize(kept);
+    }
+
+    if (m_cycle % m_interval == 0) {
+      sSnapshot* snapshot = new sSnapshot;
+      snapshot->cycle = m_cycle;
+      snapshot->hardware = organism.GetHardware().SaveCheckpoint();
+      snapshot->phenotype = new cPhenotype(organism.GetPhenotype());
+      snapshot->input_pointer = organism.GetInputPointer();
+      snapshot->input_buf = organism.GetInputBuf();
+      snapshot->output_buf = organism.GetOutputBuf();
+      snapshot->cur_input = cur_input;
+      snapshot->cur_receive = cur_receive;
+      m_snapshots.Push(snapshot);
+    }
+  }
+
+  m_cycle++;
+}
+
+
+void cTestCPUCheckpoints::TouchNopRange(int start, int end)
+{
+  if (start < 0) start = 0;
+  if (end > m_nop_touch.GetSize()) end = m_nop_touch.GetSize();
+  for (int i = start; i < end; i++) if (m_nop_touch[i] > m_cycle) m_nop_touch[i] = m_cycle;
+}
+
+void cTestCPUCheckpoints::TouchAll()
+{
+  for (int i = 0; i < m_inst_touch.GetSize(); i++) if (m_inst_touch[i] > m_cycle) m_inst_touch[i] = m_cycle;
+}
+
+
+const cTestCPUCheckpoints::sSnapshot* cTestCPUCheckpoints::FindResumePoint(const cInstSet& inst_set,
+                                                                          const InstructionSequence& genome,
+                                                                          int env_version, const cCPUTestInfo& test_info,
+                                                                          const Apto::Array<int>& inputs,
+                                                                          const Apto::Array<int>& receive) const
+{
+  if (!m_valid || !m_snapshots.GetSize()) return NULL;
+  if (&inst_set != m_inst_set || genome.GetSize() != m_base.GetSize() || env_version != m_env_version) return NULL;
+
+  // The test must run under the same conditions as the recorded one
+  if (test_info.m_tracer) return NULL;
+  const cMutationRates& rates = test_info.m_mut_rates;
+  if (rates.GetCopyMutProb() != 0.0 || rates.GetCopyInsProb() != 0.0 || rates.GetCopyDelProb() != 0.0 ||
+      rates.GetCopyUniformProb() != 0.0 || rates.GetCopySlipProb() != 0.0) {
+    return NULL;
+  }
+  if (test_info.m_res_method != m_res_method || test_info.m_res != m_res || test_info.m_res_update != m_res_update ||
+      test_info.m_res_cpu_cycle_offset != m_res_cpu_cycle_offset) {
+    return NULL;
+  }
+
+  // Different inputs only matter from the first cycle that read one
+  int limit = NEVER;
+  if (!sameValues(inputs, m_inputs) || !sameValues(receive, m_receive)) limit = m_input_touch;
+
+  // Find the first cycle that used any of the changed sites
+  for (int i = 0; i < genome.GetSize(); i++) {
+    if (genome[i] == m_base[i]) continue;
+    if (m_inst_touch[i] < limit) limit = m_inst_touch[i];
+    if (m_nop_touch[i] < limit && nopClass(genome[i]) != nopClass(m_base[i])) limit = m_nop_touch[i];
+  }
+
+  for (int i = m_snapshots.GetSize() - 1; i >= 0; i--) {
+    if (m_snapshots[i]->cycle < limit) return m_snapshots[i];
+  }
+  return NULL;
+}
+
+void cTestCPUCheckpoints::Restore(const sSnapshot& snapshot, const InstructionSequence& genome, cOrganism& organism) const
+{
+  cHardwareBase& hardware = organism.GetHardware();
+  hardware.RestoreCheckpoint(*snapshot.hardware);
+
+  // None of the changed sites had been used yet, so the saved memory only differs from the genome's at those sites
+  cCPUMemory& memory = hardware.GetMemory();
+  for (int i = 0; i < genome.GetSize(); i++) if (genome[i] != m_base[i]) memory[i] = genome[i];
+
+  organism.GetPhenotype() = *snapshot.phenotype;
+  organism.SetInputPointer(snapshot.input_pointer);
+  organism.GetInputBuf() = snapshot.input_buf;
+  organism.GetOutputBuf() = snapshot.output_buf;
+}
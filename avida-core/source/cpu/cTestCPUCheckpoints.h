@@ -0,0 +1,130 @@
+/*
+ *  cTestCPUCheckpoints.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cTestCPUCheckpoints_h
+#define cTestCPUCheckpoints_h
+
+#include "avida/core/InstructionSequence.h"
+
+#include "cCPUTestInfo.h"
+#include "tBuffer.h"
+
+#include <climits>
+
+class cHardwareCheckpoint;
+class cInstSet;
+class cOrganism;
+class cPhenotype;
+class cResourceHistory;
+
+using namespace Avida;
+
+
+// Saved gestation of a base genome, used by mutational scans to skip the part of each mutant's test CPU run that is
+// identical to the base run.  While the base genome is recorded, the hardware reports the cycle at which each site was
+// first used, either in full (executed, copied or overwritten) or only to see whether and which nop it is (labels and
+// nop modifiers).  The organism is saved every few cycles, along with the test conditions of the run: environment,
+// resources, and the input and receive values.  A mutant of the same length tested under those conditions resumes from
+// the latest saved state taken before any of its changed sites was used; sites whose nop status did not change only
+// count their full uses.  Recording is only enabled when nothing else in the run depends on the genome or the random
+// number generator, so a resumed test matches a full one exactly.
+//
+// The test CPU also reports the first cycle that read any of its input or receive values, so repeated tests of the
+// same genome on different inputs (phenotypic plasticity trials) resume from the latest state saved before that.
+
+class cTestCPUCheckpoints
+{
+public:
+  struct sSnapshot
+  {
+    int cycle;                        // CPU cycles completed when this state was saved
+    cHardwareCheckpoint* hardware;
+    cPhenotype* phenotype;
+    int input_pointer;
+    tBuffer<int> input_buf;
+    tBuffer<int> output_buf;
+    int cur_input;
+    int cur_receive;
+
+    sSnapshot() : cycle(0), hardware(NULL), phenotype(NULL), input_pointer(0), input_buf(0), output_buf(0)
+      , cur_input(0), cur_receive(0) { ; }
+    ~sSnapshot();
+  };
+
+private:
+  static const int MAX_SNAPSHOTS = 32;
+  static const int NEVER = INT_MAX;
+
+  bool m_valid;
+  const cInstSet* m_inst_set;
+  InstructionSequence m_base;
+  int m_interval;
+  int m_cycle;                        // Cycle currently being executed by the recorded run
+
+  Apto::Array<int> m_inst_touch;      // First cycle each site was used in full
+  Apto::Array<int> m_nop_touch;       // First cycle each site was examined for its nop value
+  int m_input_touch;                  // First cycle an input or receive value was read
+  Apto::Array<sSnapshot*, Apto::Smart> m_snapshots;
+
+  // Test conditions of the recorded run; a test on other input or receive values may only resume before m_input_touch
+  int m_env_version;
+  eTestCPUResourceMethod m_res_method;
+  const cResourceHistory* m_res;
+  int m_res_update;
+  int m_res_cpu_cycle_offset;
+  Apto::Array<int> m_inputs;
+  Apto::Array<int> m_receive;
+
+  inline int nopClass(const Instruction& inst) const;
+
+  cTestCPUCheckpoints(const cTestCPUCheckpoints&); // @not_implemented
+  cTestCPUCheckpoints& operator=(const cTestCPUCheckpoints&); // @not_implemented
+
+public:
+  cTestCPUCheckpoints();
+  ~cTestCPUCheckpoints() { Clear(); }
+
+  void Clear();
+  bool IsValid() const { return m_valid; }
+  int GetNumSnapshots() const { return m_snapshots.GetSize(); }
+
+  // --------  Recording (cTestCPU)  --------
+  void Start(const cInstSet& inst_set, const InstructionSequence& base, int env_version, const cCPUTestInfo& test_info,
+             const Apto::Array<int>& inputs, const Apto::Array<int>& receive);
+  void Step(cOrganism& organism, int cur_input, int cur_receive);
+  void Finish(bool valid) { m_valid = valid; }
+
+  // --------  Touch Reporting (hardware)  --------
+  inline void TouchInst(int pos) { if (pos >= 0 && pos < m_inst_touch.GetSize() && m_inst_touch[pos] > m_cycle) m_inst_touch[pos] = m_cycle; }
+  inline void TouchNop(int pos) { if (pos >= 0 && pos < m_nop_touch.GetSize() && m_nop_touch[pos] > m_cycle) m_nop_touch[pos] = m_cycle; }
+  void TouchNopRange(int start, int end);
+  void TouchAll();
+  inline void TouchInputs() { if (m_input_touch > m_cycle) m_input_touch = m_cycle; }
+
+  // --------  Resuming  --------
+  // Latest state a test of genome may resume from, or NULL if it must be run in full
+  const sSnapshot* FindResumePoint(const cInstSet& inst_set, const InstructionSequence& genome, int env_version,
+                                   const cCPUTestInfo& test_info, const Apto::Array<int>& inputs,
+                                   const Apto::Array<int>& receive) const;
+  void Restore(const sSnapshot& snapshot, const InstructionSequence& genome, cOrganism& organism) const;
+};
+
+#endif
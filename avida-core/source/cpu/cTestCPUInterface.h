@@ -116,6 +116,9 @@ public:
   int GetCurrPeakY(cAvidaContext& ctx, int res_id) { return 0; } 
   int GetFrozenPeakX(cAvidaContext& ctx, int res_id) { return 0; } 
   int GetFrozenPeakY(cAvidaContext& ctx, int res_id) { return 0; } 
+  int CountFrozenResCells(int, int, int, int, int) { return -1; }
+  int CountOccupiedCells(int, int, int, int) { return -1; }
+  int CountAVs(int, int, int, int) { return -1; }
 
   cResourceCount* GetResourceCount() { return NULL; }
   void TriggerDoUpdates(cAvidaContext&) { }
@@ -0,0 +1,348 @@
+/*
+ *  data/ColumnarRecorder.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/data/ColumnarRecorder.h"
+
+#include "avida/core/Feedback.h"
+#include "avida/data/Package.h"
+
+#include "cChunkedFile.h"
+
+#include <fstream>
+#include <sstream>
+
+
+const char Avida::Data::ColumnarRecorder::MAGIC[8] = { 'A', 'V', 'I', 'D', 'A', 'T', 'S', 'R' };
+
+
+// Data::ColumnarRecorder
+// --------------------------------------------------------------------------------------------------------------
+
+Avida::Data::ColumnarRecorder::ColumnarRecorder(const Apto::String& path, int interval, int block_rows)
+  : m_path(path), m_interval((interval > 0) ? interval : 1), m_block_rows((block_rows > 0) ? block_rows : 1)
+  , m_requested(new DataSet), m_file(NULL), m_updates(new cChunkBuffer), m_rows(0), m_last_update(0), m_failed(false)
+{
+}
+
+Avida::Data::ColumnarRecorder::~ColumnarRecorder()
+{
+  Close();
+  delete m_updates;
+  for (int i = 0; i < m_columns.GetSize(); i++) delete m_columns[i];
+}
+
+
+bool Avida::Data::ColumnarRecorder::AddColumn(const DataID& data_id, ColumnType type)
+{
+  if (m_file || !data_id.GetSize()) return false;
+  if (type < COLUMN_INT || type > COLUMN_STRING) return false;
+
+  m_ids.Push(data_id);
+  m_types.Push(type);
+  m_columns.Push(new cChunkBuffer);
+  m_requested->Insert(data_id);
+  return true;
+}
+
+
+bool Avida::Data::ColumnarRecorder::Open()
+{
+  if (m_file || !m_ids.GetSize()) return false;
+
+  m_file = new cChunkedFileWriter;
+  if (!m_file->Open(m_path, MAGIC, VERSION)) {
+    m_failed = true;
+    return false;
+  }
+
+  cChunkBuffer header;
+  header.PutVarInt(m_interval);
+  header.PutVarUInt(m_ids.GetSize());
+  for (int i = 0; i < m_ids.GetSize(); i++) {
+    header.PutString((const char*)m_ids[i]);
+    header.PutByte(m_types[i]);
+  }
+  if (!m_file->WriteChunk(header) || !m_file->Flush()) m_failed = true;
+
+  return !m_failed;
+}
+
+
+bool Avida::Data::ColumnarRecorder::Flush()
+{
+  if (!m_file || m_failed) return false;
+  if (m_rows == 0) return true;
+
+  cChunkBuffer block;
+  block.PutVarUInt(m_rows);
+  block.PutVarUInt(m_updates->GetSize());
+  block.PutBytes(m_updates->GetData(), m_updates->GetSize());
+  for (int i = 0; i < m_columns.GetSize(); i++) {
+    block.PutVarUInt(m_columns[i]->GetSize());
+    block.PutBytes(m_columns[i]->GetData(), m_columns[i]->GetSize());
+  }
+  if (!m_file->WriteChunk(block) || !m_file->Flush()) m_failed = true;
+
+  m_updates->Clear();
+  for (int i = 0; i < m_columns.GetSize(); i++) m_columns[i]->Clear();
+  m_rows = 0;
+
+  return !m_failed;
+}
+
+
+bool Avida::Data::ColumnarRecorder::Close()
+{
+  if (!m_file) return false;
+
+  Flush();
+  if (!m_file->Close()) m_failed = true;
+  delete m_file;
+  m_file = NULL;
+
+  return !m_failed;
+}
+
+
+void Avida::Data::ColumnarRecorder::NotifyData(Update current_update, DataRetrievalFunctor retrieve_data)
+{
+  if (!m_file || m_failed || (current_update % m_interval) != 0) return;
+
+  // Updates are stored as differences within each block
+  m_updates->PutVarInt((m_rows == 0) ? current_update : current_update - m_last_update);
+  m_last_update = current_update;
+
+  for (int i = 0; i < m_ids.GetSize(); i++) {
+    PackagePtr value = retrieve_data(m_ids[i]);
+    cChunkBuffer& column = *m_columns[i];
+    switch (m_types[i]) {
+      case COLUMN_INT:    column.PutVarInt((value) ? value->IntValue() : 0); break;
+      case COLUMN_DOUBLE: column.PutDouble((value) ? value->DoubleValue() : 0.0); break;
+      case COLUMN_BOOL:   column.PutBool((value) ? value->BoolValue() : false); break;
+      case COLUMN_STRING: column.PutString((value) ? (const char*)value->StringValue() : ""); break;
+    }
+  }
+
+  if (++m_rows >= m_block_rows) Flush();
+}
+
+
+
+// Data::ColumnarReader
+// --------------------------------------------------------------------------------------------------------------
+
+Avida::Data::ColumnarReader::ColumnarReader()
+  : m_file(new cChunkedFileReader), m_chunk(new cChunkBuffer), m_fail(false), m_interval(1), m_row(-1)
+{
+}
+
+Avida::Data::ColumnarReader::~ColumnarReader()
+{
+  delete m_chunk;
+  delete m_file;
+}
+
+
+bool Avida::Data::ColumnarReader::Open(const Apto::String& path)
+{
+  m_fail = true;
+  m_ids.Resize(0);
+  m_types.Resize(0);
+  m_updates.Resize(0);
+  m_block.Resize(0);
+  m_row = -1;
+
+  if (!m_file->Open(path, ColumnarRecorder::MAGIC) || m_file->GetVersion() != ColumnarRecorder::VERSION) return false;
+  if (!m_file->ReadChunk(*m_chunk)) return false;
+
+  m_interval = (int)m_chunk->GetVarInt();
+  const unsigned long long num_cols = m_chunk->GetVarUInt();
+  if (m_chunk->Fail() || num_cols > (unsigned long long)m_chunk->GetRemaining()) return false;
+
+  for (int i = 0; i < (int)num_cols; i++) {
+    cString data_id;
+    if (!m_chunk->GetString(data_id)) return false;
+    const int type = m_chunk->GetByte();
+    if (type < COLUMN_INT || type > COLUMN_STRING) return false;
+    m_ids.Push((const char*)data_id);
+    m_types.Push((ColumnType)type);
+  }
+  if (m_chunk->Fail()) return false;
+
+  m_block.Resize(m_ids.GetSize());
+  m_fail = false;
+  return true;
+}
+
+
+bool Avida::Data::ColumnarReader::readBlock()
+{
+  if (!m_file->ReadChunk(*m_chunk)) {
+    // A block still being written is read again on the next attempt
+    if (m_file->Incomplete()) {
+      if (!m_file->Resume()) m_fail = true;
+    } else if (!m_file->AtEnd()) {
+      m_fail = true;
+    }
+    return false;
+  }
+
+  m_fail = true;  // until the whole block has been decoded
+
+  const unsigned long long num_rows = m_chunk->GetVarUInt();
+  if (m_chunk->Fail() || num_rows == 0 || num_rows > (unsigned long long)m_chunk->GetRemaining()) return false;
+  const int rows = (int)num_rows;
+
+  cChunkBuffer column;
+  for (int col = -1; col < m_ids.GetSize(); col++) {
+    const unsigned long long size = m_chunk->GetVarUInt();
+    if (m_chunk->Fail() || size > (unsigned long long)m_chunk->GetRemaining()) return false;
+    const unsigned char* data = m_chunk->GetBytes((int)size);
+    if (size && !data) return false;
+    column.StartRead(data, (int)size);
+
+    if (col == -1) {
+      m_updates.Resize(rows);
+      Update update = 0;
+      for (int r = 0; r < rows; r++) {
+        update = (r == 0) ? (Update)column.GetVarInt() : update + (Update)column.GetVarInt();
+        m_updates[r] = update;
+      }
+    } else {
+      BlockColumn& block = m_block[col];
+      switch (m_types[col]) {
+        case COLUMN_INT:
+          block.ints.Resize(rows);
+          for (int r = 0; r < rows; r++) block.ints[r] = column.GetVarInt();
+          break;
+        case COLUMN_DOUBLE:
+          block.doubles.Resize(rows);
+          for (int r = 0; r < rows; r++) block.doubles[r] = column.GetDouble();
+          break;
+        case COLUMN_BOOL:
+          block.ints.Resize(rows);
+          for (int r = 0; r < rows; r++) block.ints[r] = column.GetBool() ? 1 : 0;
+          break;
+        case COLUMN_STRING:
+          block.strings.Resize(rows);
+          for (int r = 0; r < rows; r++) {
+            cString str;
+            column.GetString(str);
+            block.strings[r] = (const char*)str;
+          }
+          break;
+      }
+    }
+    if (column.Fail()) return false;
+  }
+
+  m_row = 0;
+  m_fail = false;
+  return true;
+}
+
+
+bool Avida::Data::ColumnarReader::NextRow()
+{
+  if (m_fail) return false;
+  if (m_row >= 0 && m_row + 1 < m_updates.GetSize()) {
+    m_row++;
+    return true;
+  }
+  return readBlock();
+}
+
+bool Avida::Data::ColumnarReader::Done() const
+{
+  return m_file->AtEnd();
+}
+
+
+double Avida::Data::ColumnarReader::DoubleValue(int col) const
+{
+  switch (m_types[col]) {
+    case COLUMN_DOUBLE: return m_block[col].doubles[m_row];
+    case COLUMN_STRING: return Apto::StrAs(m_block[col].strings[m_row]);
+    default:            return (double)m_block[col].ints[m_row];
+  }
+}
+
+long long Avida::Data::ColumnarReader::IntValue(int col) const
+{
+  switch (m_types[col]) {
+    case COLUMN_DOUBLE: return (long long)m_block[col].doubles[m_row];
+    case COLUMN_STRING: return (int)Apto::StrAs(m_block[col].strings[m_row]);
+    default:            return m_block[col].ints[m_row];
+  }
+}
+
+Apto::String Avida::Data::ColumnarReader::StringValue(int col) const
+{
+  switch (m_types[col]) {
+    case COLUMN_DOUBLE:
+    {
+      // Default stream formatting, as Output::File writes doubles
+      std::ostringstream str;
+      str << m_block[col].doubles[m_row];
+      return str.str().c_str();
+    }
+    case COLUMN_STRING: return m_block[col].strings[m_row];
+    default:            return Apto::FormatStr("%lld", m_block[col].ints[m_row]);
+  }
+}
+
+
+bool Avida::Data::ColumnarReader::ExportText(const Apto::String& in_path, const Apto::String& out_path, Feedback& feedback)
+{
+  ColumnarReader reader;
+  if (!reader.Open(in_path)) {
+    feedback.Error("unable to read time series file '%s'", (const char*)in_path);
+    return false;
+  }
+
+  std::ofstream fp((const char*)out_path);
+  if (!fp.good()) {
+    feedback.Error("unable to open file '%s' for writing", (const char*)out_path);
+    return false;
+  }
+
+  fp << "# Avida time series data, recorded every " << reader.Interval() << " updates" << std::endl;
+  fp << (const char*)Apto::FormatStr("# %2d: %s\n", 1, "Update");
+  for (int i = 0; i < reader.NumColumns(); i++) {
+    fp << (const char*)Apto::FormatStr("# %2d: %s\n", i + 2, (const char*)reader.ColumnID(i));
+  }
+  fp << "\n";
+
+  while (reader.NextRow()) {
+    fp << reader.RowUpdate() << " ";
+    for (int i = 0; i < reader.NumColumns(); i++) fp << (const char*)reader.StringValue(i) << " ";
+    fp << "\n";
+  }
+
+  if (reader.Fail()) {
+    feedback.Error("time series file '%s' is damaged", (const char*)in_path);
+    return false;
+  }
+  if (!reader.Done()) feedback.Warning("time series file '%s' is still being written, exported the rows so far", (const char*)in_path);
+
+  fp.close();
+  return !fp.fail();
+}
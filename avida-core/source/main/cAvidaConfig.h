@@ -298,6 +298,7 @@ public:
   // -------- Configuration File config options --------
   CONFIG_ADD_GROUP(CONFIG_FILE_GROUP, "Other configuration Files");
   CONFIG_ADD_VAR(DATA_DIR, cString, "data", "Directory in which config files are found");
+  CONFIG_ADD_VAR(OUTPUT_BUFFER_SIZE, int, 16, "Megabytes of output that may wait for the background file writer (at most 1024);\n0 = write output files directly from the simulation thread");
   CONFIG_ADD_VAR(EVENT_FILE, cString, "events.cfg", "File containing list of events during run");
   CONFIG_ADD_VAR(ANALYZE_FILE, cString, "analyze.cfg", "File used for analysis mode");
   CONFIG_ADD_VAR(ENVIRONMENT_FILE, cString, "environment.cfg", "File that describes the environment");
@@ -473,6 +474,8 @@ public:
   CONFIG_ADD_GROUP(MP_GROUP, "Config options for multiple, distributed populations");
   CONFIG_ADD_VAR(ENABLE_MP, int, 0, "Enable multi-process Avida; 0=disabled (default),\n1=enabled.");
   CONFIG_ADD_VAR(MP_SCHEDULING_STYLE, int, 0, "Style of scheduling:\n0=non-MP aware (default)\n1=MP aware, integrated across worlds.");
+  CONFIG_ADD_VAR(MP_MIGRATION_LAG, int, 0, "Number of updates a migrant spends in transit between worlds:\n0=arrives at the end of the update it left in (default)\n1=arrives one update later, overlapping communication with the next update.");
+  CONFIG_ADD_VAR(MP_TRANSPORT, int, 0, "How migrants are moved between worlds:\n0=MPI (default)\n1=in-process loopback; a single world that receives its own migrants, for testing.");
 	
   
   // -------- Deme config options --------
@@ -541,7 +544,7 @@ public:
   // -------- Time Slicing config options --------
   CONFIG_ADD_GROUP(TIME_GROUP, "Time Slicing");
   CONFIG_ADD_VAR(AVE_TIME_SLICE, int, 30, "Average number of CPU-cycles per org per update");
-  CONFIG_ADD_VAR(SLICING_METHOD, int, 1, "0 = CONSTANT: all organisms receive equal number of CPU cycles\n1 = PROBABILISTIC: CPU cycles distributed randomly, proportional to merit.\n2 = INTEGRATED: CPU cycles given out deterministicly, proportional to merit\n3 = DEME_PROBABALISTIC: Demes receive fixed number of CPU cycles, awarded probabalistically to members\n4 = CROSS_DEME_PROBABALISTIC: Demes receive CPU cycles proportional to living population size, awarded probabalistically to members");
+  CONFIG_ADD_VAR(SLICING_METHOD, int, 1, "0 = CONSTANT: all organisms receive equal number of CPU cycles\n1 = PROBABILISTIC: CPU cycles distributed randomly, proportional to merit.\n2 = INTEGRATED: CPU cycles given out deterministicly, proportional to merit\n3 = DEME_PROBABALISTIC: Demes receive fixed number of CPU cycles, awarded probabalistically to members\n4 = CROSS_DEME_PROBABALISTIC: Demes receive CPU cycles proportional to living population size, awarded probabalistically to members\n5 = PROBABILISTIC_INTEGRATED: CPU cycles distributed randomly, integrated over merit levels\n6 = BATCHED_PROBABILISTIC: As 1, but merit changes take effect at the next update (faster on large worlds)\n7 = BATCHED_INTEGRATED: As 2, but merit changes take effect at the next update (faster on large worlds)\nOnly 6 and 7 can be saved by SaveSnapshot; the other schedulers keep their state private.");
   CONFIG_ADD_VAR(BASE_MERIT_METHOD, int, 4, "How should merit be initialized?\n0 = Constant (merit independent of size)\n1 = Merit proportional to copied size\n2 = Merit prop. to executed size\n3 = Merit prop. to full size\n4 = Merit prop. to min of executed or copied size\n5 = Merit prop. to sqrt of the minimum size\n6 = Merit prop. to num times MERIT_BONUS_INST is in genome.");
   CONFIG_ADD_VAR(BASE_CONST_MERIT, int, 100, "Base merit valse for BASE_MERIT_METHOD 0");
   CONFIG_ADD_VAR(MERIT_BONUS_INST, int, 0, "Instruction ID to count for BASE_MERIT_METHOD 6"); 
@@ -561,8 +564,19 @@ public:
   CONFIG_ADD_VAR(NO_CPU_CYCLE_TIME, int, 0, "Don't count each CPU cycle as part of gestation time\n");
   CONFIG_ADD_VAR(MAX_LABEL_EXE_SIZE, int, 1, "Max nops marked as executed when labels are used");
   CONFIG_ADD_VAR(PRECALC_PHENOTYPE, int, 0, "0 = Disabled\n 1 = Assign precalculated merit at birth (unlimited resources only)\n 2 = Assign precalculated gestation time\n 3 = Assign precalculated merit AND gestation time.\n 4 = Assign last instruction counts \n 5 = Assign last instruction counts and merit\n 6 = Assign last instruction counts and gestation time \n 7 = Assign everything currently supported\nFitness will be evaluated for organism based on these settings.");
+  CONFIG_ADD_VAR(PRECALC_PHENOTYPE_INPUTS, int, 0, "Inputs used to precalculate phenotypes\n0 = The inputs of the cell the organism is placed in\n1 = The environment's fixed test inputs, run with a fixed random seed.  Results\n    depend only on the genome and environment and may be cached.");
+  CONFIG_ADD_VAR(PRECALC_PHENOTYPE_CACHE, int, 1000, "Number of genotypes whose precalculated phenotypes are remembered and reused\nwhen PRECALC_PHENOTYPE_INPUTS is 1 (0 = disabled).  Reused results are identical\nto running the test again.");
+  CONFIG_ADD_VAR(HARDWARE_POOL_SIZE, int, 100, "Number of idle virtual CPUs kept per instruction set for reuse by newborn\norganisms (0 = always allocate new hardware).  PrintObjectPoolData reports the\npeak number actually held.");
+  CONFIG_ADD_VAR(ORGANISM_POOL_SIZE, int, 100, "Number of dead organisms, with their phenotypes, kept for reuse by newborn\norganisms (0 = always allocate new organisms).  PrintObjectPoolData reports the\npeak number actually held.");
   CONFIG_ADD_VAR(GENOTYPE_PHENPLAST_CALC, int, 100, "Number of times to test a genotype's\nplasticity during runtime.");
   
+  // -------- Parallel Update config options --------
+  CONFIG_ADD_GROUP(PARALLEL_GROUP, "Parallel Update Settings");
+  CONFIG_ADD_VAR(PARALLEL_UPDATE, int, 0, "0 = Process organisms serially (default)\n1 = Partition the world grid into tiles that execute concurrently.  Organisms run\n    non-STALL instructions in parallel; interactions are committed at a barrier.\n2 = Process demes concurrently, each with its own scheduler and random stream.  Implicit\n    deme replication is checked at the barriers between phases, in deme order.\nResults are deterministic for a given seed, independent of PARALLEL_THREADS.\nRequires THREAD_SLICING_METHOD 0, no IMPLICIT_REPRO settings, no per-instruction\n(point) mutations, no resource, energy or post instruction costs, no TASK_SWITCH_PENALTY,\nENERGY_ENABLED or USE_AVATARS; mode 1 also requires a single deme.");
+  CONFIG_ADD_VAR(PARALLEL_TILE_X, int, 16, "Width, in cells, of each parallel update tile");
+  CONFIG_ADD_VAR(PARALLEL_TILE_Y, int, 16, "Height, in cells, of each parallel update tile");
+  CONFIG_ADD_VAR(PARALLEL_THREADS, int, -1, "Number of threads used for parallel updates, -1 == use all available.");
+  
 
   // -------- Altruism config options --------
   CONFIG_ADD_GROUP(ALTRUISM_GROUP, "Altrusim");
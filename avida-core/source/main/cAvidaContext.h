@@ -28,6 +28,7 @@
 
 #include "avida/core/Types.h"
 
+class cTestCPU;
 class cWorld;
 
 
@@ -36,14 +37,15 @@ class cAvidaContext
 private:
   Avida::WorldDriver* m_driver;
   Apto::Random* m_rng;
+  cTestCPU* m_testcpu;
 
   bool m_analyze;
   bool m_testing;
   bool m_org_faults;
   
 public:
-  cAvidaContext(Avida::WorldDriver* driver, Apto::Random& rng) : m_driver(driver), m_rng(&rng), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
-  cAvidaContext(Avida::WorldDriver* driver, Apto::Random* rng) : m_driver(driver), m_rng(rng), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
+  cAvidaContext(Avida::WorldDriver* driver, Apto::Random& rng) : m_driver(driver), m_rng(&rng), m_testcpu(NULL), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
+  cAvidaContext(Avida::WorldDriver* driver, Apto::Random* rng) : m_driver(driver), m_rng(rng), m_testcpu(NULL), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
   ~cAvidaContext() { ; }
   
   Avida::WorldDriver& Driver() { return *m_driver; }
@@ -53,6 +55,10 @@ public:
   void SetRandom(Apto::Random* rng) { m_rng = rng; }
   Apto::Random& GetRandom() { return *m_rng; }
   
+  // Test CPU owned by the thread running with this context (analyze job workers), reused across jobs.  May be NULL.
+  void SetTestCPU(cTestCPU* testcpu) { m_testcpu = testcpu; }
+  cTestCPU* GetTestCPU() { return m_testcpu; }
+  
   void SetAnalyzeMode() { m_analyze = true; }
   void ClearAnalyzeMode() { m_analyze = false; }
   bool GetAnalyzeMode() { return m_analyze; }
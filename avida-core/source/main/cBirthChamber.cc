@@ -30,6 +30,7 @@
 #include "cBirthMateSelectHandler.h"
 #include "cBirthNeighborhoodHandler.h"
 #include "cBirthMatingTypeGlobalHandler.h"
+#include "cHardwareManager.h"
 #include "cOrganism.h"
 #include "cWorld.h"
 #include "cStats.h"
@@ -229,7 +230,7 @@ bool cBirthChamber::DoAsexBirth(cAvidaContext& ctx, const Genome& offspring, cOr
   // This is asexual who doesn't need to wait in the birth chamber
   // just build the child and return.
   child_array.Resize(1);
-  child_array[0] = new cOrganism(m_world, ctx, offspring, parent.GetPhenotype().GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
+  child_array[0] = m_world->GetHardwareManager().CreateOrganism(ctx, offspring, parent.GetPhenotype().GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
   merit_array.Resize(1);
   
   if (m_world->GetConfig().ENERGY_ENABLED.Get() == 1) {
@@ -241,7 +242,7 @@ bool cBirthChamber::DoAsexBirth(cAvidaContext& ctx, const Genome& offspring, cOr
     child_phenotype.SetEnergy(child_energy);
     merit_array[0] = child_phenotype.ConvertEnergyToMerit(child_phenotype.GetStoredEnergy());
     if (merit_array[0].GetDouble() <= 0.0) {  // do not allow zero merit
-      delete child_array[0];  // MAKE SURE THIS GETS DONE! Otherwise, memory leak.	
+      m_world->GetHardwareManager().ReleaseOrganism(child_array[0]);  // MAKE SURE THIS GETS DONE! Otherwise, memory leak.	
       child_array.Resize(0);
       merit_array.Resize(0);
       return false;
@@ -266,8 +267,8 @@ bool cBirthChamber::DoPairAsexBirth(cAvidaContext& ctx, const cBirthEntry& old_e
 {
   // Build both child organisms...
   child_array.Resize(2);
-  child_array[0] = new cOrganism(m_world, ctx, old_entry.genome, parent.GetPhenotype().GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
-  child_array[1] = new cOrganism(m_world, ctx, new_genome, parent.GetPhenotype().GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
+  child_array[0] = m_world->GetHardwareManager().CreateOrganism(ctx, old_entry.genome, parent.GetPhenotype().GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
+  child_array[1] = m_world->GetHardwareManager().CreateOrganism(ctx, new_genome, parent.GetPhenotype().GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
 
   // Setup the merits for both children...
   merit_array.Resize(2);
@@ -535,8 +536,8 @@ bool cBirthChamber::SubmitOffspring(cAvidaContext& ctx, const Genome& offspring,
   
   if (two_fold_cost == 0) {	// Build the two organisms.
     child_array.Resize(2);
-    child_array[0] = new cOrganism(m_world, ctx, genome0, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
-    child_array[1] = new cOrganism(m_world, ctx, genome1, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
+    child_array[0] = m_world->GetHardwareManager().CreateOrganism(ctx, genome0, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
+    child_array[1] = m_world->GetHardwareManager().CreateOrganism(ctx, genome1, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
     
     if(m_world->GetConfig().ENERGY_ENABLED.Get() == 1) {
       child_array[0]->GetPhenotype().SetEnergy(meritOrEnergy0);
@@ -559,7 +560,7 @@ bool cBirthChamber::SubmitOffspring(cAvidaContext& ctx, const Genome& offspring,
     merit_array.Resize(1);
 
     if (ctx.GetRandom().GetDouble() < 0.5) {
-      child_array[0] = new cOrganism(m_world, ctx, genome0, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
+      child_array[0] = m_world->GetHardwareManager().CreateOrganism(ctx, genome0, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
       if(m_world->GetConfig().ENERGY_ENABLED.Get() == 1) {
         child_array[0]->GetPhenotype().SetEnergy(meritOrEnergy0);
         meritOrEnergy0 = child_array[0]->GetPhenotype().ConvertEnergyToMerit(child_array[0]->GetPhenotype().GetStoredEnergy());
@@ -570,7 +571,7 @@ bool cBirthChamber::SubmitOffspring(cAvidaContext& ctx, const Genome& offspring,
       SetupGenotypeInfo(child_array[0], parent0_groups, parent1_groups);
     } 
     else {
-      child_array[0] = new cOrganism(m_world, ctx, genome1, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
+      child_array[0] = m_world->GetHardwareManager().CreateOrganism(ctx, genome1, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
       if(m_world->GetConfig().ENERGY_ENABLED.Get() == 1) {
         child_array[0]->GetPhenotype().SetEnergy(meritOrEnergy1);
         meritOrEnergy1 = child_array[1]->GetPhenotype().ConvertEnergyToMerit(child_array[1]->GetPhenotype().GetStoredEnergy());
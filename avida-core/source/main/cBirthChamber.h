@@ -70,6 +70,8 @@ public:
   void ClearEntry(cBirthEntry& entry);
   
   int GetWaitingOffspringNumber(int which_mating_type, int hw_type);
+  //! Selection handlers are created with the first offspring held back for sexual reproduction (or queried for it).
+  bool InUse() const { return m_handler_map.GetSize() > 0; }
   void PrintBirthChamber(const cString& filename, int hw_type);
 
 private:
@@ -23,6 +23,7 @@
 #include "avida/systematics/Arbiter.h"
 #include "avida/systematics/Manager.h"
 
+#include "cChunkedFile.h"
 #include "cEnvironment.h"
 #include "cOrganism.h"
 #include "cPhenotype.h"
@@ -76,6 +77,9 @@ cDeme::cDeme()
   , avg_founder_generation(0.0)
   , generations_per_lifetime(0.0)
   , deme_resource_count(0)
+  , m_res_clock(NULL)
+  , m_res_synced(0.0)
+  , m_flow_sample_pending(false)
   , m_germline_genotype_id(0)
   , points(0)
   , migrations_out(0)
@@ -102,6 +106,7 @@ cDeme::~cDeme()
 cDeme& cDeme::operator=(const cDeme& in_deme)
 {
   m_world                             = in_deme.m_world;
+  m_res_clock                         = in_deme.m_res_clock;
   _id                                 = in_deme._id;
   cell_ids                            = in_deme.cell_ids;
   width                               = in_deme.width;
@@ -134,6 +139,8 @@ cDeme& cDeme::operator=(const cDeme& in_deme)
   eventKillAttemptsThisSlot           = in_deme.eventKillAttemptsThisSlot;
   consecutiveSuccessfulEventPeriods   = in_deme.consecutiveSuccessfulEventPeriods;
   sleeping_count                      = in_deme.sleeping_count;
+  m_flow_sample                       = in_deme.m_flow_sample;
+  m_flow_sample_pending               = in_deme.m_flow_sample_pending;
   energyUsage                         = in_deme.energyUsage;
   total_energy_donated                = in_deme.total_energy_donated;
   total_energy_received               = in_deme.total_energy_received;
@@ -340,6 +347,7 @@ void cDeme::ProcessPreUpdate()
 void cDeme::ProcessUpdate(cAvidaContext& ctx)
 {
   // test deme predicate
+  syncResourceTime();
   for (int i = 0; i < deme_pred_list.GetSize(); i++) {
     if (deme_pred_list[i]->GetName() == "cDemeResourceThreshold") {
       (*deme_pred_list[i])(ctx, &deme_resource_count);
@@ -379,6 +387,7 @@ void cDeme::ProcessUpdate(cAvidaContext& ctx)
             orgPhenotype.ReduceEnergy(orgPhenotype.GetStoredEnergy()*m_world->GetConfig().ATTACK_DECAY_RATE.Get());
           }
           //remove energy from cell... organism might not takeup all of a cell's energy
+          syncResourceTime();
           Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(eventCell, ctx);  // uses global cell_id; is this a problem
           cell_resources[res->GetID()] *= m_world->GetConfig().ATTACK_DECAY_RATE.Get();
           deme_resource_count.ModifyCell(ctx, cell_resources, eventCell);
@@ -439,15 +448,15 @@ void cDeme::ProcessUpdate(cAvidaContext& ctx)
         consecutiveSuccessfulEventPeriods = 0;
       }
       
-      // update stats.flow_rate_tuples
-      std::map<int, flow_rate_tuple>& flowRateTuples = m_world->GetStats().FlowRateTuples();
-      
-      flowRateTuples[(*iter).second].orgCount.Add(GetOrgCount());
-      flowRateTuples[(*iter).second].eventsKilled.Add(GetEventsKilledThisSlot());
-      flowRateTuples[(*iter).second].attemptsToKillEvents.Add(GetEventKillAttemptsThisSlot());
-      flowRateTuples[(*iter).second].AvgEnergyUsageRatio.Add(energyUsage.Average());
-      flowRateTuples[(*iter).second].totalBirths.Add(birth_count_perslot);
-      flowRateTuples[(*iter).second].currentSleeping.Add(sleeping_count);
+      // sample for stats.flow_rate_tuples, recorded by RecordUpdateStats
+      m_flow_sample.flow_rate = (*iter).second;
+      m_flow_sample.org_count = GetOrgCount();
+      m_flow_sample.events_killed = GetEventsKilledThisSlot();
+      m_flow_sample.kill_attempts = GetEventKillAttemptsThisSlot();
+      m_flow_sample.energy_usage = energyUsage.Average();
+      m_flow_sample.births = birth_count_perslot;
+      m_flow_sample.sleeping = sleeping_count;
+      m_flow_sample_pending = true;
       birth_count_perslot = 0;
       eventsKilledThisSlot = 0;
       eventKillAttemptsThisSlot = 0;
@@ -461,6 +470,21 @@ void cDeme::ProcessUpdate(cAvidaContext& ctx)
 }
 
 
+void cDeme::RecordUpdateStats()
+{
+  if (!m_flow_sample_pending) return;
+  m_flow_sample_pending = false;
+  
+  flow_rate_tuple& tuple = m_world->GetStats().FlowRateTuples()[m_flow_sample.flow_rate];
+  tuple.orgCount.Add(m_flow_sample.org_count);
+  tuple.eventsKilled.Add(m_flow_sample.events_killed);
+  tuple.attemptsToKillEvents.Add(m_flow_sample.kill_attempts);
+  tuple.AvgEnergyUsageRatio.Add(m_flow_sample.energy_usage);
+  tuple.totalBirths.Add(m_flow_sample.births);
+  tuple.currentSleeping.Add(m_flow_sample.sleeping);
+}
+
+
 /*! Called when an organism living in a cell in this deme is about to be killed.
  
  This method is called from cPopulation::KillOrganism().
@@ -558,6 +582,7 @@ void cDeme::Reset(cAvidaContext& ctx, bool resetResources, double deme_energy)
   }
   
   if (resetResources) {
+    syncResourceTime();
     deme_resource_count.ReinitializeResources(ctx, additional_resource);
   }
 
@@ -703,9 +728,192 @@ void cDeme::UpdateDemeMerit(cDeme& source) {
 void cDeme::ModifyDemeResCount(cAvidaContext& ctx, const Apto::Array<double>& res_change, const int absolute_cell_id) {
   // find relative cell_id in deme resource count
   const int relative_cell_id = GetRelativeCellID(absolute_cell_id);
+  syncResourceTime();
   deme_resource_count.ModifyCell(ctx, res_change, relative_cell_id);
 }
 
+void cDeme::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutBool(replicateDeme);
+  buf.PutBool(treatable);
+  buf.PutVarUInt(treatment_ages.size());
+  for (std::set<int>::const_iterator it = treatment_ages.begin(); it != treatment_ages.end(); it++) buf.PutVarInt(*it);
+
+  buf.PutVarInt(cur_birth_count);
+  buf.PutVarInt(last_birth_count);
+  buf.PutVarInt(cur_org_count);
+  buf.PutVarInt(last_org_count);
+  buf.PutVarInt(injected_count);
+  buf.PutVarInt(birth_count_perslot);
+  buf.PutVarInt(_age);
+  buf.PutVarInt(generation);
+  buf.PutDouble(total_org_energy);
+  buf.PutVarInt(time_used);
+  buf.PutVarInt(gestation_time);
+  buf.PutDouble(cur_normalized_time_used);
+  buf.PutDouble(last_normalized_time_used);
+  buf.PutVarUInt(MSG_sendFailed);
+  buf.PutVarUInt(MSG_dropped);
+  buf.PutVarUInt(MSG_SuccessfullySent);
+  buf.PutDouble(energyInjectedIntoOrganisms);
+  buf.PutDouble(energyRemainingInDemeAtReplication);
+  buf.PutDouble(total_energy_testament);
+  buf.PutVarInt(eventsTotal);
+  buf.PutVarUInt(eventsKilled);
+  buf.PutVarUInt(eventsKilledThisSlot);
+  buf.PutVarUInt(eventKillAttempts);
+  buf.PutVarUInt(eventKillAttemptsThisSlot);
+  buf.PutVarUInt(consecutiveSuccessfulEventPeriods);
+  buf.PutVarInt(sleeping_count);
+  energyUsage.SaveState(buf);
+  buf.PutDouble(total_energy_donated);
+  buf.PutDouble(total_energy_received);
+  buf.PutDouble(total_energy_applied);
+
+  buf.PutIntArray(cur_task_exe_count);
+  buf.PutIntArray(cur_reaction_count);
+  buf.PutIntArray(last_task_exe_count);
+  buf.PutIntArray(last_reaction_count);
+  buf.PutIntArray(cur_org_task_count);
+  buf.PutIntArray(cur_org_task_exe_count);
+  buf.PutIntArray(cur_org_reaction_count);
+  buf.PutIntArray(last_org_task_count);
+  buf.PutIntArray(last_org_task_exe_count);
+  buf.PutIntArray(last_org_reaction_count);
+  buf.PutDouble(avg_founder_generation);
+  buf.PutDouble(generations_per_lifetime);
+
+  deme_resource_count.SaveState(buf);
+  buf.PutDouble(m_res_synced);
+
+  buf.PutVarInt(m_germline_genotype_id);
+  buf.PutIntArray(m_founder_genotype_ids);
+  buf.PutVarUInt(m_founder_phenotypes.GetSize());
+  for (int i = 0; i < m_founder_phenotypes.GetSize(); i++) m_founder_phenotypes[i].SaveState(buf);
+  buf.PutDouble(_current_merit.GetDouble());
+  buf.PutDouble(_next_merit.GetDouble());
+  buf.PutDouble(points);
+  buf.PutVarUInt(migrations_out);
+  buf.PutVarUInt(migrations_in);
+  buf.PutVarUInt(suicides);
+
+  // Deme input and output
+  buf.PutVarInt(m_input_pointer);
+  buf.PutIntArray(m_inputs);
+  m_input_buf.SaveState(buf);
+  m_output_buf.SaveState(buf);
+  buf.PutBool(m_task_states.GetSize() > 0);
+  buf.PutIntArray(m_task_count);
+  buf.PutIntArray(m_last_task_count);
+  buf.PutIntArray(m_reaction_count);
+  buf.PutDoubleArray(m_cur_reaction_add_reward);
+  buf.PutDouble(m_cur_bonus);
+  buf.PutDouble(m_cur_merit.GetDouble());
+
+  // Division of labor
+  buf.PutDouble(m_total_res_consumed);
+  buf.PutVarInt(m_switch_penalties);
+  buf.PutVarUInt(m_shannon_matrix.size());
+  for (size_t i = 0; i < m_shannon_matrix.size(); i++) {
+    buf.PutVarUInt(m_shannon_matrix[i].size());
+    for (size_t j = 0; j < m_shannon_matrix[i].size(); j++) buf.PutDouble(m_shannon_matrix[i][j]);
+  }
+  buf.PutVarInt(m_num_active);
+  buf.PutVarInt(m_num_reproductives);
+}
+
+bool cDeme::LoadState(cChunkBuffer& buf)
+{
+  replicateDeme = buf.GetBool();
+  treatable = buf.GetBool();
+  int num_ages = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_ages > buf.GetRemaining()) return false;
+  treatment_ages.clear();
+  for (int i = 0; i < num_ages; i++) treatment_ages.insert((int)buf.GetVarInt());
+
+  cur_birth_count = (int)buf.GetVarInt();
+  last_birth_count = (int)buf.GetVarInt();
+  cur_org_count = (int)buf.GetVarInt();
+  last_org_count = (int)buf.GetVarInt();
+  injected_count = (int)buf.GetVarInt();
+  birth_count_perslot = (int)buf.GetVarInt();
+  _age = (int)buf.GetVarInt();
+  generation = (int)buf.GetVarInt();
+  total_org_energy = buf.GetDouble();
+  time_used = (int)buf.GetVarInt();
+  gestation_time = (int)buf.GetVarInt();
+  cur_normalized_time_used = buf.GetDouble();
+  last_normalized_time_used = buf.GetDouble();
+  MSG_sendFailed = (unsigned int)buf.GetVarUInt();
+  MSG_dropped = (unsigned int)buf.GetVarUInt();
+  MSG_SuccessfullySent = (unsigned int)buf.GetVarUInt();
+  energyInjectedIntoOrganisms = buf.GetDouble();
+  energyRemainingInDemeAtReplication = buf.GetDouble();
+  total_energy_testament = buf.GetDouble();
+  eventsTotal = (int)buf.GetVarInt();
+  eventsKilled = (unsigned int)buf.GetVarUInt();
+  eventsKilledThisSlot = (unsigned int)buf.GetVarUInt();
+  eventKillAttempts = (unsigned int)buf.GetVarUInt();
+  eventKillAttemptsThisSlot = (unsigned int)buf.GetVarUInt();
+  consecutiveSuccessfulEventPeriods = (unsigned int)buf.GetVarUInt();
+  sleeping_count = (int)buf.GetVarInt();
+  if (!energyUsage.LoadState(buf)) return false;
+  total_energy_donated = buf.GetDouble();
+  total_energy_received = buf.GetDouble();
+  total_energy_applied = buf.GetDouble();
+
+  if (!buf.GetIntArray(cur_task_exe_count) || !buf.GetIntArray(cur_reaction_count) ||
+      !buf.GetIntArray(last_task_exe_count) || !buf.GetIntArray(last_reaction_count) ||
+      !buf.GetIntArray(cur_org_task_count) || !buf.GetIntArray(cur_org_task_exe_count) ||
+      !buf.GetIntArray(cur_org_reaction_count) || !buf.GetIntArray(last_org_task_count) ||
+      !buf.GetIntArray(last_org_task_exe_count) || !buf.GetIntArray(last_org_reaction_count)) return false;
+  avg_founder_generation = buf.GetDouble();
+  generations_per_lifetime = buf.GetDouble();
+
+  if (!deme_resource_count.LoadState(buf)) return false;
+  m_res_synced = buf.GetDouble();
+
+  m_germline_genotype_id = (int)buf.GetVarInt();
+  if (!buf.GetIntArray(m_founder_genotype_ids)) return false;
+  const int num_founders = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_founders > buf.GetRemaining()) return false;
+  m_founder_phenotypes.ResizeClear(num_founders);
+  for (int i = 0; i < num_founders; i++) {
+    if (!m_founder_phenotypes[i].LoadState(buf)) return false;
+  }
+  _current_merit = buf.GetDouble();
+  _next_merit = buf.GetDouble();
+  points = buf.GetDouble();
+  migrations_out = (unsigned int)buf.GetVarUInt();
+  migrations_in = (unsigned int)buf.GetVarUInt();
+  suicides = (unsigned int)buf.GetVarUInt();
+
+  // Deme input and output
+  m_input_pointer = (int)buf.GetVarInt();
+  if (!buf.GetIntArray(m_inputs) || !m_input_buf.LoadState(buf) || !m_output_buf.LoadState(buf)) return false;
+  if (buf.GetBool()) return false;
+  if (!buf.GetIntArray(m_task_count) || !buf.GetIntArray(m_last_task_count) || !buf.GetIntArray(m_reaction_count)) return false;
+  if (!buf.GetDoubleArray(m_cur_reaction_add_reward)) return false;
+  m_cur_bonus = buf.GetDouble();
+  m_cur_merit = buf.GetDouble();
+
+  // Division of labor
+  m_total_res_consumed = buf.GetDouble();
+  m_switch_penalties = (int)buf.GetVarInt();
+  const int rows = (int)buf.GetVarUInt();
+  if (buf.Fail() || rows > buf.GetRemaining()) return false;
+  m_shannon_matrix.resize(rows);
+  for (int i = 0; i < rows; i++) {
+    const int cols = (int)buf.GetVarUInt();
+    if (buf.Fail() || cols > buf.GetRemaining()) return false;
+    m_shannon_matrix[i].resize(cols);
+    for (int j = 0; j < cols; j++) m_shannon_matrix[i][j] = buf.GetDouble();
+  }
+  m_num_active = (int)buf.GetVarInt();
+  m_num_reproductives = (int)buf.GetVarInt();
+  return !buf.Fail();
+}
+
 void cDeme::SetupDemeRes(int id, cResource * res, int verbosity, cWorld* world) {               
   const double decay = 1.0 - res->GetOutflow();
   //addjust the resources cell list pointer here if we want CELL env. commands to be replicated in each deme
@@ -754,6 +962,7 @@ double cDeme::GetCellEnergy(int absolute_cell_id, cAvidaContext& ctx) const
 
   double total_energy = 0.0;
   int relative_cell_id = GetRelativeCellID(absolute_cell_id);
+  syncResourceTime();
   Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(relative_cell_id, ctx);
   
   // sum all energy resources
@@ -774,6 +983,7 @@ double cDeme::GetAndClearCellEnergy(int absolute_cell_id, cAvidaContext& ctx)
   
   double total_energy = 0.0;
   int relative_cell_id = GetRelativeCellID(absolute_cell_id);
+  syncResourceTime();
   Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(relative_cell_id, ctx);
   
   // sum all energy resources
@@ -796,6 +1006,7 @@ void cDeme::GiveBackCellEnergy(int absolute_cell_id, double value, cAvidaContext
   assert(absolute_cell_id <= cell_ids[cell_ids.GetSize()-1]);
   
   int relative_cell_id = GetRelativeCellID(absolute_cell_id);
+  syncResourceTime();
   Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(relative_cell_id, ctx);
   
   double amount_per_resource = value / energy_res_ids.GetSize();
@@ -1141,6 +1352,7 @@ void cDeme::AddPheromone(int absolute_cell_id, double value, cAvidaContext& ctx)
   //  cPopulation& pop = m_world->GetPopulation();
   
   int relative_cell_id = GetRelativeCellID(absolute_cell_id);
+  syncResourceTime();
   Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(relative_cell_id, ctx);
   
   for (int i = 0; i < deme_resource_count.GetSize(); i++) {
@@ -1172,6 +1384,7 @@ double cDeme::GetSpatialResource(int rel_cellid, int resource_id, cAvidaContext&
   assert(resource_id >= 0);
   assert(resource_id < deme_resource_count.GetSize());
   
+  syncResourceTime();
   Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(rel_cellid, ctx);
   return cell_resources[resource_id];
 }
@@ -1187,11 +1400,13 @@ void cDeme::AdjustSpatialResource(cAvidaContext& ctx, int rel_cellid, int resour
   res_change.Resize(deme_resource_count.GetSize(), 0);
   res_change[resource_id] = amount;
   
+  syncResourceTime();
   deme_resource_count.ModifyCell(ctx, res_change, rel_cellid);  
 }
 
 void cDeme::AdjustResource(cAvidaContext& ctx, int resource_id, double amount)
 {
+  syncResourceTime();
   double new_amount = deme_resource_count.Get(ctx, resource_id) + amount;
   deme_resource_count.Set(ctx, resource_id, new_amount);
 }
@@ -1262,8 +1477,8 @@ void cDeme::DoDemeOutput(cAvidaContext& ctx, int value)
   m_output_buf.Add(value);
 
   // Needed to setup taskctx, but will not actually be used
-  tList<tBuffer<int> > other_input_list;
-  tList<tBuffer<int> > other_output_list;
+  Apto::Array<const tBuffer<int>*, Apto::Smart> other_input_list;
+  Apto::Array<const tBuffer<int>*, Apto::Smart> other_output_list;
   Apto::Array<int, Apto::Smart> ext_mem;
 
   // Setup the task context
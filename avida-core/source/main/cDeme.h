@@ -35,6 +35,7 @@
 #include "cStringList.h"
 #include "cDoubleSum.h"
 
+class cChunkBuffer;
 class cResource;
 class cWorld;
 class cPopulationCell;
@@ -116,11 +117,27 @@ private:
   cDeme(const cDeme&); // @not_implemented
   
   cResourceCount deme_resource_count; //!< Resources available to the deme
+  const double* m_res_clock; //!< Elapsed update time shared by all demes, owned by cPopulation
+  mutable double m_res_synced; //!< Value of *m_res_clock already applied to deme_resource_count
   Apto::Array<int> energy_res_ids; //!< IDs of energy resources
   
   Apto::Array<cDemeCellEvent, Apto::Smart> cell_events;
   std::vector<std::pair<int, int> > event_slot_end_points; // (slot end point, slot flow rate)
   
+  // Flow rate sample taken by ProcessUpdate at the end of an event slot, added to the stats by RecordUpdateStats
+  struct sFlowRateSample
+  {
+    int flow_rate;
+    int org_count;
+    int events_killed;
+    int kill_attempts;
+    double energy_usage;
+    int births;
+    int sleeping;
+  };
+  sFlowRateSample m_flow_sample;
+  bool m_flow_sample_pending;
+  
   int         m_germline_genotype_id; // Genotype id of germline (if in use)
   Apto::Array<int> m_founder_genotype_ids; // List of genotype ids used to found deme.
                                       // Keep a lease on these genotypes for the deme's lifetime.
@@ -139,6 +156,15 @@ private:
 	unsigned int migrations_in;
 	unsigned int suicides;
 	
+  //! Bring deme_resource_count up to date with the shared clock.
+  void syncResourceTime() const
+  {
+    if (m_res_clock && *m_res_clock != m_res_synced) {
+      deme_resource_count.Update(*m_res_clock - m_res_synced);
+      m_res_synced = *m_res_clock;
+    }
+  }
+  
 public:
 	//! Constructor.
   cDeme();
@@ -168,6 +194,11 @@ public:
   void Reset(cAvidaContext& ctx, bool resetResources = true, double deme_energy = 0.0); //! used to pass energy to offspring deme
   void DivideReset(cAvidaContext& ctx, cDeme& parent_deme, bool resetResources = true, double deme_energy = 0.0);
 
+  //! Snapshot state: counters, founders, merit, deme inputs and outputs, and deme resources.
+  //! Germlines, cell events, predicates and per-task state are not included; LoadState fails if task state is held.
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
+
   //! Kills all organisms currently in this deme.
   void KillAll(cAvidaContext& ctx);
 
@@ -253,28 +284,35 @@ public:
 
   // -= Update support =-
   void ProcessPreUpdate(); 
-  //! Called once, at the end of every update.
+  //! Called once, at the end of every update.  Only touches this deme, so demes may be processed concurrently.
   void ProcessUpdate(cAvidaContext& ctx); 
+  //! Adds the update's deme samples to the world stats; called after ProcessUpdate, in deme order.
+  void RecordUpdateStats();
   //! Returns the age of this deme in updates, where age is defined as the number of updates since the last time Reset() was called.
   int GetAge() const { return _age; }
   //! Called when an organism living in a cell in this deme is about to be killed.
   void OrganismDeath(cPopulationCell& cell);
   
-  const cResourceCount& GetDemeResourceCount() const { return deme_resource_count; }
-  cResourceCount& GetDemeResources() { return deme_resource_count; }
-  void SetResource(cAvidaContext& ctx, int id, double new_level) { deme_resource_count.Set(ctx, id, new_level); }
+  const cResourceCount& GetDemeResourceCount() const { syncResourceTime(); return deme_resource_count; }
+  cResourceCount& GetDemeResources() { syncResourceTime(); return deme_resource_count; }
+  void SetResource(cAvidaContext& ctx, int id, double new_level) { syncResourceTime(); deme_resource_count.Set(ctx, id, new_level); }
   double GetSpatialResource(int rel_cellid, int resource_id, cAvidaContext& ctx) const;
   void AdjustSpatialResource(cAvidaContext& ctx, int rel_cellid, int resource_id, double amount);
   void AdjustResource(cAvidaContext& ctx, int resource_id, double amount);
-  void SetDemeResourceCount(const cResourceCount in_res) { deme_resource_count = in_res; }
+  void SetDemeResourceCount(const cResourceCount in_res) { deme_resource_count = in_res; m_res_synced = m_res_clock ? *m_res_clock : 0.0; }
   void ResizeSpatialGrids(const int in_x, const int in_y) { deme_resource_count.ResizeSpatialGrids(in_x, in_y); }
   void ModifyDemeResCount(cAvidaContext& ctx, const Apto::Array<double> & res_change, const int absolute_cell_id);
   double GetCellEnergy(int absolute_cell_id, cAvidaContext& ctx) const; 
   double GetAndClearCellEnergy(int absolute_cell_id, cAvidaContext& ctx); 
   void GiveBackCellEnergy(int absolute_cell_id, double value, cAvidaContext& ctx); 
   void SetupDemeRes(int id, cResource * res, int verbosity, cWorld* world);                 
-  void UpdateDemeRes(cAvidaContext& ctx) { deme_resource_count.GetResources(ctx); } 
+  void UpdateDemeRes(cAvidaContext& ctx) { syncResourceTime(); deme_resource_count.GetResources(ctx); } 
   void Update(double time_step) { deme_resource_count.Update(time_step); }
+  
+  //! Elapsed time is not pushed to every deme on every step; each deme pulls it from the shared clock when its resources are accessed.
+  void SetResourceClock(const double* clock) { m_res_clock = clock; m_res_synced = clock ? *clock : 0.0; }
+  //! Apply all pending time and rebase on a clock about to be reset to zero (called once per update, for every deme).
+  void FlushResourceTime() { syncResourceTime(); m_res_synced = 0.0; }
   int GetRelativeCellID(int absolute_cell_id) const { return absolute_cell_id % GetSize(); } //!< assumes all demes are the same size
   int GetAbsoluteCellID(int relative_cell_id) const { return relative_cell_id + (_id * GetSize()); } //!< assumes all demes are the same size
 	
@@ -299,6 +337,8 @@ public:
   
   void IncTimeUsed(double merit) 
     { time_used++; cur_normalized_time_used += 1.0/merit/(double)cur_org_count; }
+  void IncTimeUsed(int cycles, double inv_merit_sum)
+    { time_used += cycles; cur_normalized_time_used += inv_merit_sum/(double)cur_org_count; }
   int GetTimeUsed() { return time_used; }
   int GetGestationTime() { return gestation_time; }
   double GetNormalizedTimeUsed() { return cur_normalized_time_used; }
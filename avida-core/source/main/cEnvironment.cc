@@ -53,11 +53,12 @@ using namespace Avida;
 
 cEnvironment::cEnvironment(cWorld* world) : m_world(world) , m_tasklib(world),
 m_input_size(INPUT_SIZE_DEFAULT), m_output_size(OUTPUT_SIZE_DEFAULT), m_true_rand(false),
-m_use_specific_inputs(false), m_specific_inputs(), m_mask(0), m_hammers(false), m_paths(false)
+m_use_specific_inputs(false), m_specific_inputs(), m_mask(0), m_hammers(false), m_paths(false), m_version(0)
 {
   mut_rates.Setup(world);
   if (m_world->GetConfig().DEFAULT_GROUP.Get() != -1) possible_group_ids.insert(m_world->GetConfig().DEFAULT_GROUP.Get());
   pp_fts.Resize(0);
+  m_reaction_index.Resize(257);
 }
 
 cEnvironment::~cEnvironment()
@@ -1152,9 +1153,13 @@ bool cEnvironment::LoadLine(cString line, Feedback& feedback)
   cString type = line.PopWord();      // Determine type of this entry.
   type.ToUpper();                     // Make type case insensitive.
 
+  m_version++;
   bool load_ok = true;
   if (type == "RESOURCE") load_ok = LoadResource(line, feedback);
-  else if (type == "REACTION") load_ok = LoadReaction(line, feedback);
+  else if (type == "REACTION") {
+    load_ok = LoadReaction(line, feedback);
+    BuildReactionIndex();
+  }
   else if (type == "SET_ACTIVE") load_ok = LoadSetActive(line, feedback);
   else if (type == "CELL") load_ok = LoadCell(line, feedback);
   else if (type == "GRID") load_ok = LoadStateGrid(line, feedback);
@@ -1288,10 +1293,12 @@ bool cEnvironment::TestOutput(cAvidaContext& ctx, cReactionResult& result,
 
   // Do setup for reaction tests...
   m_tasklib.SetupTests(taskctx);
+  if (context_phenotype != 0) context_phenotype->ResizeCounts(task_count.GetSize(), reaction_lib.GetSize());
 
-  // Loop through all reactions to see if any have been triggered...
-  const int num_reactions = reaction_lib.GetSize();
-  for (int i = 0; i < num_reactions; i++) {
+  // Loop through all reactions that could trigger on this output to see if any have been triggered...
+  const Apto::Array<int>& candidates = m_reaction_index[taskctx.GetLogicId() + 1];
+  for (int c = 0; c < candidates.GetSize(); c++) {
+    const int i = candidates[c];
     cReaction* cur_reaction = reaction_lib.GetReaction(i);
     assert(cur_reaction != NULL);
 
@@ -1315,18 +1322,6 @@ bool cEnvironment::TestOutput(cAvidaContext& ctx, cReactionResult& result,
     }
 
     if (context_phenotype != 0) {
-      Apto::Array<int> blank_tasks;
-      Apto::Array<int> blank_reactions;
-      blank_tasks.ResizeClear(task_count.GetSize());
-      for(int count=0;count<task_count.GetSize();count++) {
-        blank_tasks[count] = 0;
-      }
-      blank_reactions.ResizeClear(this->GetReactionLib().GetSize());
-      for(int count=0;count<reaction_count.GetSize();count++) {
-        blank_reactions[count] = 0;
-      }
-      context_phenotype->AddTaskCounts(blank_tasks.GetSize(), blank_tasks);
-      context_phenotype->AddReactionCounts(blank_reactions.GetSize(), blank_reactions);
       int context_task_count = context_phenotype->GetTaskCounts()[task_id];
       if (TestContextRequisites(cur_reaction, context_task_count, context_phenotype->GetReactionCounts(), on_divide) == false) {
         if (!skipProcessing) {  // for those parasites again
@@ -1367,6 +1362,34 @@ bool cEnvironment::TestOutput(cAvidaContext& ctx, cReactionResult& result,
   return result.GetActive();
 }
 
+void cEnvironment::BuildReactionIndex()
+{
+  for (int logic_id = -1; logic_id < 256; logic_id++) m_reaction_index[logic_id + 1].Resize(0);
+  
+  for (int i = 0; i < reaction_lib.GetSize(); i++) {
+    cReaction* cur_reaction = reaction_lib.GetReaction(i);
+    cTaskEntry* cur_task = cur_reaction->GetTask();
+    
+    // Reactions with any phenotypic plasticity bonus method are always tested, since evaluating them looks up task
+    // probabilities (drawing random numbers) and the bonus methods can mark a task that was not performed
+    bool indexed = (cur_task != NULL && cur_task->IsLogicOnly());
+    tLWConstListIterator<cReactionProcess> proc_it(cur_reaction->GetProcesses());
+    const cReactionProcess* cur_proc;
+    while (indexed && (cur_proc = proc_it.Next()) != NULL) {
+      ePHENPLAST_BONUS_METHOD pp_meth = cur_proc->GetPhenPlastBonusMethod();
+      if (pp_meth != DEFAULT) indexed = false;
+    }
+    
+    if (indexed) {
+      const Apto::Array<int>& logic_ids = cur_task->GetLogicIDs();
+      for (int j = 0; j < logic_ids.GetSize(); j++) m_reaction_index[logic_ids[j] + 1].Push(i);
+    } else {
+      for (int logic_id = -1; logic_id < 256; logic_id++) m_reaction_index[logic_id + 1].Push(i);
+    }
+  }
+}
+
+
 bool cEnvironment::TestRequisites(cTaskContext& taskctx, const cReaction* cur_reaction,
                                   int task_count, const Apto::Array<int>& reaction_count, const bool on_divide, bool is_parasite) const
 {
@@ -1841,6 +1864,7 @@ bool cEnvironment::SetReactionValue(cAvidaContext& ctx, const cString& name, dou
       assert(cur_reaction != NULL);
       cur_reaction->ModifyValue(value);
     }
+    m_version++;
 
     return true;
   }
@@ -1861,12 +1885,14 @@ bool cEnvironment::SetReactionValue(cAvidaContext& ctx, const cString& name, dou
       assert(cur_reaction != NULL);
       cur_reaction->ModifyValue(value);
     }
+    m_version++;
     return true;
   }
 
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   found_reaction->ModifyValue(value);
+  m_version++;
   return true;
 }
 
@@ -1875,6 +1901,7 @@ bool cEnvironment::SetReactionValueMult(const cString& name, double value_mult)
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   found_reaction->MultiplyValue(value_mult);
+  m_version++;
   return true;
 }
 
@@ -1883,6 +1910,7 @@ bool cEnvironment::SetReactionInst(const cString& name, cString inst_name)
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   found_reaction->ModifyInst(inst_name);
+  m_version++;
   return true;
 }
 
@@ -1890,6 +1918,7 @@ bool cEnvironment::SetReactionMinTaskCount(const cString& name, int min_count)
 {
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
+  m_version++;
   return found_reaction->SetMinTaskCount( min_count );
 }
 
@@ -1897,6 +1926,7 @@ bool cEnvironment::SetReactionMaxTaskCount(const cString& name, int max_count)
 {
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
+  m_version++;
   return found_reaction->SetMaxTaskCount( max_count );
 }
 
@@ -1904,6 +1934,7 @@ bool cEnvironment::SetReactionMinCount(const cString& name, int reaction_min_cou
 {
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
+  m_version++;
   return found_reaction->SetMinReactionCount( reaction_min_count );
 }
 
@@ -1911,6 +1942,7 @@ bool cEnvironment::SetReactionMaxCount(const cString& name, int reaction_max_cou
 {
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
+  m_version++;
   return found_reaction->SetMaxReactionCount( reaction_max_count );
 }
 
@@ -1924,6 +1956,8 @@ bool cEnvironment::SetReactionTask(const cString& name, const cString& task)
     if (m_tasklib.GetTask(i).GetName() == task)
     {
       found_reaction->SetTask( m_tasklib.GetTaskReference(i) );
+      BuildReactionIndex();
+      m_version++;
       return true;
     }
   }
@@ -1936,6 +1970,7 @@ bool cEnvironment::SetResourceInflow(const cString& name, double _inflow )
   cResource* found_resource = resource_lib.GetResource(name);
   if (found_resource == NULL) return false;
   found_resource->SetInflow( _inflow );
+  m_version++;
   return true;
 }
 
@@ -1944,6 +1979,7 @@ bool cEnvironment::SetResourceOutflow(const cString& name, double _outflow )
   cResource* found_resource = resource_lib.GetResource(name);
   if (found_resource == NULL) return false;
   found_resource->SetOutflow( _outflow );
+  m_version++;
   return true;
 }
 
@@ -1951,6 +1987,7 @@ bool cEnvironment::ChangeResource(cReaction* reaction, const cString& res, int p
 {
   cReactionProcess* process = reaction->GetProcess(process_num);
   process->SetResource(m_world->GetEnvironment().GetResourceLib().GetResource(res));
+  m_version++;
   return true;
 }
 
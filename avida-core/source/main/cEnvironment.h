@@ -82,6 +82,12 @@ private:
   
   bool m_hammers;
   bool m_paths;
+
+  int m_version;  // incremented whenever reactions or resources are added or altered
+  
+  // Reactions that can trigger for each logic ID (offset by one, index 0 is an inconsistent output), in reaction order.
+  // Reactions whose task reads only the logic ID are listed under the IDs their task accepts, all others under every ID.
+  Apto::Array<Apto::Array<int> > m_reaction_index;
   
   cEnvironment(); // @not_implemented
   cEnvironment(const cEnvironment&); // @not_implemented
@@ -131,6 +137,8 @@ public:
   int GetNumStateGrids() const { return m_state_grids.GetSize(); }
   const cStateGrid& GetStateGrid(int sg) const { return *m_state_grids[sg]; }  
 
+  int GetVersion() const { return m_version; }
+
   int GetInputSize()  const { return m_input_size; };
   int GetOutputSize() const { return m_output_size; };
 
@@ -181,6 +189,7 @@ private:
   bool LoadReaction(cString desc, Feedback& feedback);
   bool LoadStateGrid(cString desc, Feedback& feedback);
   bool LoadSetActive(cString desc, Feedback& feedback);
+  void BuildReactionIndex();
   
   bool LoadGradientResource(cString desc, Feedback& feedback);
   double GetTaskProbability(cAvidaContext& ctx, cTaskContext& taskctx,
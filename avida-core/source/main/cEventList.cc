@@ -25,6 +25,7 @@
 #include "avida/Avida.h"
 
 #include "cActionLibrary.h"
+#include "cChunkedFile.h"
 #include "cInitFile.h"
 #include "cStats.h"
 #include "cString.h"
@@ -60,19 +61,7 @@ bool cEventList::AddEvent(eTriggerType trigger, double start, double interval,
   
   if (action != NULL) {
     cEventListEntry* entry = new cEventListEntry(action, name, trigger, start, interval, stop);
-    
-    // If there are no events in the list yet.
-    if (m_tail == NULL) {
-      assert(m_head == NULL);
-      m_head = entry;
-      m_tail = entry;
-    } else {
-      // Add to the end of the list
-      m_tail->SetNext(entry);
-      entry->SetPrev(m_tail);
-      m_tail = entry;
-    }
-    
+    Append(entry);
     SyncEvent(entry);
 		
 		if (trigger == BIRTHS_INTERRUPT)  //Operates outside of usual event processing
@@ -103,6 +92,22 @@ bool cEventList::LoadEventFile(const cString& filename, const cString& working_d
 }
 
 
+void cEventList::Append(cEventListEntry* entry)
+{
+  // If there are no events in the list yet.
+  if (m_tail == NULL) {
+    assert(m_head == NULL);
+    m_head = entry;
+    m_tail = entry;
+  } else {
+    // Add to the end of the list
+    m_tail->SetNext(entry);
+    entry->SetPrev(m_tail);
+    m_tail = entry;
+  }
+}
+
+
 void cEventList::Delete(cEventListEntry* entry) 
 {
   assert(entry != NULL);
@@ -354,6 +359,63 @@ void cEventList::PrintEventList(ostream& os)
 }
 
 
+void cEventList::SaveState(cChunkBuffer& buf) const
+{
+  int num_entries = 0;
+  for (cEventListEntry* entry = m_head; entry != NULL; entry = entry->GetNext()) num_entries++;
+  
+  buf.PutVarUInt(num_entries);
+  for (cEventListEntry* entry = m_head; entry != NULL; entry = entry->GetNext()) {
+    buf.PutByte(entry->GetTrigger());
+    buf.PutDouble(entry->GetStart());
+    buf.PutDouble(entry->GetInterval());
+    buf.PutDouble(entry->GetStop());
+    buf.PutDouble(entry->GetOriginalStart());
+    buf.PutString(entry->GetName());
+    buf.PutString(entry->GetArgs());
+  }
+  
+  tConstListIterator<double> it(m_birth_interrupt_queue);
+  buf.PutVarUInt(m_birth_interrupt_queue.GetSize());
+  while (it.Next() != NULL) buf.PutDouble(*it.Get());
+}
+
+
+bool cEventList::LoadState(cChunkBuffer& buf, Feedback& feedback)
+{
+  while (m_head != NULL) Delete(m_head);
+  while (m_birth_interrupt_queue.GetSize()) delete m_birth_interrupt_queue.Pop();
+  m_num_events = 0;
+  
+  const int num_entries = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_entries > buf.GetRemaining()) return false;
+  for (int i = 0; i < num_entries; i++) {
+    const int trigger = buf.GetByte();
+    const double start = buf.GetDouble();
+    const double interval = buf.GetDouble();
+    const double stop = buf.GetDouble();
+    const double original_start = buf.GetDouble();
+    cString name, args;
+    if (!buf.GetString(name) || !buf.GetString(args) || trigger > BIRTHS_INTERRUPT) return false;
+    
+    cAction* action = cActionLibrary::GetInstance().Create((const char*)name, m_world, args, feedback);
+    if (action == NULL) return false;
+    
+    // Created at its original start so that Reset rewinds as it would have, then moved to where it had got to
+    cEventListEntry* entry = new cEventListEntry(action, name, (eTriggerType)trigger, original_start, interval, stop);
+    entry->SetStart(start);
+    Append(entry);
+    ++m_num_events;
+  }
+  
+  const int num_queued = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_queued > buf.GetRemaining()) return false;
+  for (int i = 0; i < num_queued; i++) m_birth_interrupt_queue.PushRear(new double(buf.GetDouble()));
+  
+  return !buf.Fail();
+}
+
+
 // Dequeue a particular birth interrupt event
 void cEventList::DequeueBirthInterruptEvent(double t_val)
 {
@@ -35,6 +35,7 @@ namespace Avida {
 };
 
 class cAvidaContext;
+class cChunkBuffer;
 class cString;
 class cWorld;
 
@@ -84,6 +85,7 @@ private:
   void SyncEvent(cEventListEntry* event);
   double GetTriggerValue(eTriggerType trigger) const;
   void Delete(cEventListEntry* entry);
+  void Append(cEventListEntry* entry);
   
   cEventList(); // @not_implemented
   cEventList(const cEventList&); // @not_implemented
@@ -131,6 +133,13 @@ public:
 	
 	//! Check to see if an event with the given name is upcoming at some point in the future.
 	bool IsEventUpcoming(const cString& event_name);
+
+  /**
+   * Snapshot state: every pending entry with its current position, in list order.  LoadState replaces the list,
+   * creating each action anew from its name and arguments, so state held inside actions is not carried over.
+   **/
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf, Feedback& feedback);
   
   
 private:
@@ -165,6 +174,7 @@ private:
     
     void NextInterval(){ m_start += m_interval; }
     void Reset() { m_start = m_original_start; }
+    void SetStart(double start) { m_start = start; }
     
     // accessors
     cAction* GetAction() const { assert(m_action != NULL); return m_action; }
@@ -176,6 +186,7 @@ private:
     double GetStart() const { return m_start; }
     double GetInterval() const { return m_interval; }
     double GetStop() const { return m_stop; }
+    double GetOriginalStart() const { return m_original_start; }
     
     cEventListEntry* GetPrev() const { return m_prev; }
     cEventListEntry* GetNext() const { return m_next; }
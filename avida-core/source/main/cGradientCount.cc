@@ -27,6 +27,7 @@
 #include "avida/core/WorldDriver.h"
 
 #include "cAvidaContext.h"
+#include "cChunkedFile.h"
 #include "cPopulation.h"
 #include "cStats.h"
 #include "cWorld.h"
@@ -37,6 +38,24 @@
 using namespace Avida;
 
 
+// Grows the box (min_x, min_y)-(max_x, max_y) to cover the box (x1, y1)-(x2, y2); an empty box has min_x == -1
+static void growBox(int& min_x, int& min_y, int& max_x, int& max_y, int x1, int y1, int x2, int y2)
+{
+  if (x1 == -1) return;
+  if (min_x == -1) {
+    min_x = x1;
+    min_y = y1;
+    max_x = x2;
+    max_y = y2;
+    return;
+  }
+  if (x1 < min_x) min_x = x1;
+  if (y1 < min_y) min_y = y1;
+  if (x2 > max_x) max_x = x2;
+  if (y2 > max_y) max_y = y2;
+}
+
+
 /* cGradientCount is designed to give moving peaks of resources. Peaks are <optionally> capped with plateaus. The slope of the peaks
 is height / distance. Consequently, when height = distance from center of peak, the value at that cell = 1. This was 
 designed this way because the organims used for this could only consume resources when the value is >= 1. Thus, height also 
@@ -119,12 +138,173 @@ cGradientCount::cGradientCount(cWorld* world, int peakx, int peaky, int height,
   , m_min_usedy(-1)
   , m_max_usedx(-1)
   , m_max_usedy(-1)
+  , m_stencil_size(-1)
+  , m_stencil_spread(0)
+  , m_stencil_height(0)
+  , m_live_min_x(-1)
+  , m_live_min_y(-1)
+  , m_live_max_x(-1)
+  , m_live_max_y(-1)
+  , m_defer_fills(false)
 {
   ResetGradRes(m_world->GetDefaultContext(), worldx, worldy);
 }
 
 cGradientCount::~cGradientCount() { ; }
 
+void cGradientCount::SaveState(cChunkBuffer& buf) const
+{
+  cSpatialResCount::SaveState(buf);
+  buf.PutVarInt(m_peakx);
+  buf.PutVarInt(m_peaky);
+  buf.PutVarInt(m_height);
+  buf.PutVarInt(m_spread);
+  buf.PutDouble(m_plateau);
+  buf.PutVarInt(m_decay);
+  buf.PutVarInt(m_max_x);
+  buf.PutVarInt(m_max_y);
+  buf.PutVarInt(m_min_x);
+  buf.PutVarInt(m_min_y);
+  buf.PutDouble(m_move_a_scaler);
+  buf.PutVarInt(m_updatestep);
+  buf.PutVarInt(m_halo);
+  buf.PutVarInt(m_halo_inner_radius);
+  buf.PutVarInt(m_halo_width);
+  buf.PutVarInt(m_halo_anchor_x);
+  buf.PutVarInt(m_halo_anchor_y);
+  buf.PutVarInt(m_move_speed);
+  buf.PutVarInt(m_move_resistance);
+  buf.PutDouble(m_plateau_inflow);
+  buf.PutDouble(m_plateau_outflow);
+  buf.PutDouble(m_cone_inflow);
+  buf.PutDouble(m_cone_outflow);
+  buf.PutDouble(m_gradient_inflow);
+  buf.PutVarInt(m_is_plateau_common);
+  buf.PutDouble(m_floor);
+  buf.PutVarInt(m_habitat);
+  buf.PutVarInt(m_min_size);
+  buf.PutVarInt(m_max_size);
+  buf.PutVarInt(m_config);
+  buf.PutVarInt(m_count);
+  buf.PutDouble(m_initial_plat);
+  buf.PutDouble(m_threshold);
+  buf.PutDouble(m_damage);
+  buf.PutVarInt(m_geometry);
+  buf.PutBool(m_initial);
+  buf.PutDouble(m_move_y_scaler);
+  buf.PutVarInt(m_counter);
+  buf.PutVarInt(m_move_counter);
+  buf.PutVarInt(m_topo_counter);
+  buf.PutVarInt(m_movesignx);
+  buf.PutVarInt(m_movesigny);
+  buf.PutVarInt(m_old_peakx);
+  buf.PutVarInt(m_old_peaky);
+  buf.PutVarInt(m_halo_dir);
+  buf.PutVarInt(m_changling);
+  buf.PutBool(m_just_reset);
+  buf.PutDouble(m_past_height);
+  buf.PutDouble(m_current_height);
+  buf.PutDouble(m_ave_plat_cell_loss);
+  buf.PutDouble(m_common_plat_height);
+  buf.PutVarInt(m_skip_moves);
+  buf.PutVarInt(m_skip_counter);
+  buf.PutDoubleArray(m_plateau_array);
+  buf.PutIntArray(m_plateau_cell_IDs);
+  buf.PutIntArray(m_wall_cells);
+  buf.PutDouble(m_mean_plat_inflow);
+  buf.PutDouble(m_var_plat_inflow);
+  buf.PutDouble(m_pred_odds);
+  buf.PutBool(m_predator);
+  buf.PutDouble(m_death_odds);
+  buf.PutBool(m_deadly);
+  buf.PutVarInt(m_path);
+  buf.PutVarInt(m_hammer);
+  buf.PutVarInt(m_guarded_juvs_per_adult);
+  buf.PutBool(m_probabilistic);
+  buf.PutIntArray(m_prob_res_cells);
+  buf.PutVarInt(m_min_usedx);
+  buf.PutVarInt(m_min_usedy);
+  buf.PutVarInt(m_max_usedx);
+  buf.PutVarInt(m_max_usedy);
+}
+
+bool cGradientCount::LoadState(cChunkBuffer& buf)
+{
+  if (!cSpatialResCount::LoadState(buf)) return false;
+  m_peakx = (int)buf.GetVarInt();
+  m_peaky = (int)buf.GetVarInt();
+  m_height = (int)buf.GetVarInt();
+  m_spread = (int)buf.GetVarInt();
+  m_plateau = buf.GetDouble();
+  m_decay = (int)buf.GetVarInt();
+  m_max_x = (int)buf.GetVarInt();
+  m_max_y = (int)buf.GetVarInt();
+  m_min_x = (int)buf.GetVarInt();
+  m_min_y = (int)buf.GetVarInt();
+  m_move_a_scaler = buf.GetDouble();
+  m_updatestep = (int)buf.GetVarInt();
+  m_halo = (int)buf.GetVarInt();
+  m_halo_inner_radius = (int)buf.GetVarInt();
+  m_halo_width = (int)buf.GetVarInt();
+  m_halo_anchor_x = (int)buf.GetVarInt();
+  m_halo_anchor_y = (int)buf.GetVarInt();
+  m_move_speed = (int)buf.GetVarInt();
+  m_move_resistance = (int)buf.GetVarInt();
+  m_plateau_inflow = buf.GetDouble();
+  m_plateau_outflow = buf.GetDouble();
+  m_cone_inflow = buf.GetDouble();
+  m_cone_outflow = buf.GetDouble();
+  m_gradient_inflow = buf.GetDouble();
+  m_is_plateau_common = (int)buf.GetVarInt();
+  m_floor = buf.GetDouble();
+  m_habitat = (int)buf.GetVarInt();
+  m_min_size = (int)buf.GetVarInt();
+  m_max_size = (int)buf.GetVarInt();
+  m_config = (int)buf.GetVarInt();
+  m_count = (int)buf.GetVarInt();
+  m_initial_plat = buf.GetDouble();
+  m_threshold = buf.GetDouble();
+  m_damage = buf.GetDouble();
+  m_geometry = (int)buf.GetVarInt();
+  m_initial = buf.GetBool();
+  m_move_y_scaler = buf.GetDouble();
+  m_counter = (int)buf.GetVarInt();
+  m_move_counter = (int)buf.GetVarInt();
+  m_topo_counter = (int)buf.GetVarInt();
+  m_movesignx = (int)buf.GetVarInt();
+  m_movesigny = (int)buf.GetVarInt();
+  m_old_peakx = (int)buf.GetVarInt();
+  m_old_peaky = (int)buf.GetVarInt();
+  m_halo_dir = (int)buf.GetVarInt();
+  m_changling = (int)buf.GetVarInt();
+  m_just_reset = buf.GetBool();
+  m_past_height = buf.GetDouble();
+  m_current_height = buf.GetDouble();
+  m_ave_plat_cell_loss = buf.GetDouble();
+  m_common_plat_height = buf.GetDouble();
+  m_skip_moves = (int)buf.GetVarInt();
+  m_skip_counter = (int)buf.GetVarInt();
+  if (!buf.GetDoubleArray(m_plateau_array)) return false;
+  if (!buf.GetIntArray(m_plateau_cell_IDs)) return false;
+  if (!buf.GetIntArray(m_wall_cells)) return false;
+  m_mean_plat_inflow = buf.GetDouble();
+  m_var_plat_inflow = buf.GetDouble();
+  m_pred_odds = buf.GetDouble();
+  m_predator = buf.GetBool();
+  m_death_odds = buf.GetDouble();
+  m_deadly = buf.GetBool();
+  m_path = (int)buf.GetVarInt();
+  m_hammer = (int)buf.GetVarInt();
+  m_guarded_juvs_per_adult = (int)buf.GetVarInt();
+  m_probabilistic = buf.GetBool();
+  if (!buf.GetIntArray(m_prob_res_cells)) return false;
+  m_min_usedx = (int)buf.GetVarInt();
+  m_min_usedy = (int)buf.GetVarInt();
+  m_max_usedx = (int)buf.GetVarInt();
+  m_max_usedy = (int)buf.GetVarInt();
+  return !buf.Fail();
+}
+
 void cGradientCount::StateAll()
 {
   return;
@@ -140,6 +320,39 @@ void cGradientCount::UpdateCount(cAvidaContext& ctx)
   else updatePeakRes(ctx);
 }
 
+// Plain peaks touch nothing but their own cells once their peak has moved, so the fills (by far the most expensive
+// part of an update) can be put off and run in parallel with those of other resources.  Barriers, hills, probabilistic
+// resources, and peaks that act on the organisms in them are updated in one go.
+bool cGradientCount::CanSplitUpdateCount() const
+{
+  return !(m_habitat == 2 || m_habitat == 1 || m_probabilistic || m_predator || m_damage || m_deadly);
+}
+
+void cGradientCount::BeginUpdateCount(cAvidaContext& ctx)
+{
+  assert(CanSplitUpdateCount());
+  m_defer_fills = true;
+  UpdateCount(ctx);
+  m_defer_fills = false;
+}
+
+void cGradientCount::FinishUpdateCount()
+{
+  const int peakx = m_peakx;
+  const int peaky = m_peaky;
+  const bool just_reset = m_just_reset;
+  for (int i = 0; i < m_pending_fills.GetSize(); i++) {
+    m_peakx = m_pending_fills[i].peakx;
+    m_peaky = m_pending_fills[i].peaky;
+    m_just_reset = m_pending_fills[i].just_reset;
+    fillinResourceValues();
+  }
+  m_pending_fills.Resize(0);
+  m_peakx = peakx;
+  m_peaky = peaky;
+  m_just_reset = just_reset;
+}
+
 void cGradientCount::updatePeakRes(cAvidaContext& ctx)
 {  
   bool has_edible = false; 
@@ -155,7 +368,7 @@ void cGradientCount::updatePeakRes(cAvidaContext& ctx)
     int min_pos_y = max(m_peaky - m_spread - 1, 0);
     for (int ii = min_pos_x; ii < max_pos_x + 1; ii++) {
       for (int jj = min_pos_y; jj < max_pos_y + 1; jj++) {
-        if (Element(jj * GetX() + ii).GetAmount() >= 1) {
+        if (GetAmount(jj * GetX() + ii) >= 1) {
           has_edible = true;
           break;
         }
@@ -268,6 +481,16 @@ void cGradientCount::generatePeak(cAvidaContext& ctx)
 
 void cGradientCount::fillinResourceValues()
 {  
+  // while an update is split, only note which peak this fill is for and leave the filling to FinishUpdateCount
+  if (m_defer_fills) {
+    const sPendingFill fill = { m_peakx, m_peaky, m_just_reset };
+    m_pending_fills.Push(fill);
+    SetCurrPeakX(m_peakx);
+    SetCurrPeakY(m_peaky);
+    m_just_reset = false;
+    return;
+  }
+  
   int max_pos_x;
   int min_pos_x;
   int max_pos_y;
@@ -311,17 +534,58 @@ void cGradientCount::fillinResourceValues()
     m_current_height = m_height;
   }
 
+  // every cell in range but outside the spread of the peak is set to 0, so we only need to visit the cells within the
+  // spread and those in range that may still hold something (everything else is 0 already). The cells are visited in 
+  // the same order as the full range would be, so cone cells reading back from already updated cells see the same values
+  buildStencil();
+  const int reach = m_stencil_size - 1;
+  
+  int live_min_x = m_live_min_x;
+  int live_min_y = m_live_min_y;
+  int live_max_x = m_live_max_x;
+  int live_max_y = m_live_max_y;
+  int changed_min_x, changed_min_y, changed_max_x, changed_max_y;
+  if (GetChangedBounds(changed_min_x, changed_min_y, changed_max_x, changed_max_y)) {
+    growBox(live_min_x, live_min_y, live_max_x, live_max_y, changed_min_x, changed_min_y, changed_max_x, changed_max_y);
+  }
+  
+  int fill_min_x = -1;
+  int fill_min_y = -1;
+  int fill_max_x = -1;
+  int fill_max_y = -1;
+  if (reach >= 0) {
+    growBox(fill_min_x, fill_min_y, fill_max_x, fill_max_y, max(m_peakx - reach, min_pos_x), max(m_peaky - reach, min_pos_y),
+            min(m_peakx + reach, max_pos_x), min(m_peaky + reach, max_pos_y));
+  }
+  if (live_min_x != -1) {
+    const int x1 = max(live_min_x, min_pos_x);
+    const int y1 = max(live_min_y, min_pos_y);
+    const int x2 = min(live_max_x, max_pos_x);
+    const int y2 = min(live_max_y, max_pos_y);
+    if (x1 <= x2 && y1 <= y2) growBox(fill_min_x, fill_min_y, fill_max_x, fill_max_y, x1, y1, x2, y2);
+  }
+  min_pos_x = fill_min_x;
+  min_pos_y = fill_min_y;
+  max_pos_x = fill_max_x;
+  max_pos_y = fill_max_y;
+  if (fill_min_x == -1) max_pos_x = max_pos_y = -2;
+  
   int plateau_cell = 0;
   for (int ii = min_pos_x; ii < max_pos_x + 1; ii++) {
+    const int dx = abs(m_peakx - ii);
     for (int jj = min_pos_y; jj < max_pos_y + 1; jj++) {
       double thisheight = 0.0;
-      double thisdist = sqrt((double) (m_peakx - ii) * (m_peakx - ii) + (m_peaky - jj) * (m_peaky - jj));
-      if (m_spread >= thisdist) {
+      const int dy = abs(m_peaky - jj);
+      const int stencil_cell = dy * m_stencil_size + dx;
+      if (dx <= reach && dy <= reach && m_spread >= m_stencil_dist[stencil_cell]) {
+        const double thisdist = m_stencil_dist[stencil_cell];
+        
         // determine theoretical individual cells values and add one to distance from center 
         // (so that center point = radius 1, not 0)
         // also used to distinguish plateau cells
         
-        thisheight = m_current_height / (thisdist + 1);
+        if (m_current_height == m_height) thisheight = m_stencil_slope[stencil_cell];
+        else thisheight = m_current_height / (thisdist + 1);
         
         // set the floor values
         // plateaus will override this so that plateaus can hit 0 when being eaten
@@ -330,7 +594,7 @@ void cGradientCount::fillinResourceValues()
         // create cylindrical profiles of resources whereever thisheight would be >1 (area where thisdist + 1 <= m_height)
         // and slopes outside of that range
         // plateau = -1 turns off this option; if activated, causes 'peaks' to be flat plateaus = plateau value 
-        bool is_plat_cell = ((m_height / (thisdist + 1)) >= 1);
+        bool is_plat_cell = (m_stencil_slope[stencil_cell] >= 1);
         // apply plateau inflow(s) and outflow 
         if ((is_plat_cell && m_plateau >= 0) || (m_plateau < 0 && thisdist == 0 && m_plateau_array.GetSize())) { 
           if (m_just_reset || m_world->GetStats().GetUpdate() <= 0) {
@@ -378,7 +642,7 @@ void cGradientCount::fillinResourceValues()
               thisheight = 0;
             }
             else {
-              double past_height = Element(old_cell_y * GetX() + old_cell_x).GetAmount(); 
+              double past_height = GetAmount(old_cell_y * GetX() + old_cell_x); 
               double newheight = past_height; 
               if (m_cone_inflow > 0 || m_cone_outflow > 0) newheight += m_cone_inflow - (past_height * m_cone_outflow);
               if (m_gradient_inflow > 0) newheight += m_gradient_inflow / (thisdist + 1); 
@@ -389,15 +653,45 @@ void cGradientCount::fillinResourceValues()
           }
         }
       }
-      Element(jj * GetX() + ii).SetAmount(thisheight);
+      SetCellAmount(jj * GetX() + ii, thisheight);
       if (thisheight > 0) updateBounds(ii, jj);
     }
   }         
+  
+  // cells that may hold something are now those just filled in, plus any outside the visited box, which kept their values
+  const bool all_visited = (live_min_x == -1 || (live_min_x >= min_pos_x && live_min_y >= min_pos_y &&
+                                                  live_max_x <= max_pos_x && live_max_y <= max_pos_y));
+  m_live_min_x = m_min_usedx;
+  m_live_min_y = m_min_usedy;
+  m_live_max_x = m_max_usedx;
+  m_live_max_y = m_max_usedy;
+  if (!all_visited) growBox(m_live_min_x, m_live_min_y, m_live_max_x, m_live_max_y, live_min_x, live_min_y, live_max_x, live_max_y);
+  ClearChangedBounds();
+  
   SetCurrPeakX(m_peakx);
   SetCurrPeakY(m_peaky);
   m_just_reset = false;
 }
 
+void cGradientCount::buildStencil()
+{
+  const int size = max(min(m_spread, max(GetX(), GetY()) - 1) + 1, 0);
+  if (size == m_stencil_size && m_spread == m_stencil_spread && m_height == m_stencil_height) return;
+  
+  m_stencil_size = size;
+  m_stencil_spread = m_spread;
+  m_stencil_height = m_height;
+  m_stencil_dist.ResizeClear(size * size);
+  m_stencil_slope.ResizeClear(size * size);
+  for (int dy = 0; dy < size; dy++) {
+    for (int dx = 0; dx < size; dx++) {
+      const double dist = sqrt((double) (dx * dx + dy * dy));
+      m_stencil_dist[dy * size + dx] = dist;
+      m_stencil_slope[dy * size + dx] = m_height / (dist + 1);
+    }
+  }
+}
+
 void cGradientCount::getCurrentPlatValues()
 { 
   int temp_height = 0;
@@ -415,7 +709,7 @@ void cGradientCount::getCurrentPlatValues()
       double find_plat_dist = temp_height / (thisdist + 1);
       if ((find_plat_dist >= 1 && m_plateau >= 0) || (m_plateau < 0 && thisdist == 0 && m_plateau_array.GetSize() > 0)) {
         double past_cell_height = m_plateau_array[plateau_cell];
-        double pre_move_height = Element(m_plateau_cell_IDs[plateau_cell]).GetAmount();  
+        double pre_move_height = GetAmount(m_plateau_cell_IDs[plateau_cell]);  
         if (pre_move_height < past_cell_height) {
           m_plateau_array[plateau_cell] = pre_move_height; 
           amount_devoured = amount_devoured + past_cell_height - pre_move_height;
@@ -661,13 +955,13 @@ void cGradientCount::generateBarrier(cAvidaContext& ctx)
     // clear any old resource
     if (m_wall_cells.GetSize()) {
       for (int i = 0; i < m_wall_cells.GetSize(); i++) {
-        Element(m_wall_cells[i]).SetAmount(0);
+        SetCellAmount(m_wall_cells[i], 0);
       }
     }
     else {
       for (int ii = 0; ii < GetX(); ii++) {
         for (int jj = 0; jj < GetY(); jj++) {
-          Element(jj * GetX() + ii).SetAmount(0);
+          SetCellAmount(jj * GetX() + ii, 0);
         }
       }
     }
@@ -685,7 +979,7 @@ void cGradientCount::generateBarrier(cAvidaContext& ctx)
         start_randx = ctx.GetRandom().GetUInt(0, GetX());
         start_randy = ctx.GetRandom().GetUInt(0, GetY());  
       }
-      Element(start_randy * GetX() + start_randx).SetAmount(m_plateau);
+      SetCellAmount(start_randy * GetX() + start_randx, m_plateau);
       // if (m_plateau > 0) updateBounds(start_randx, start_randy);
       updateBounds(start_randx, start_randy);
       m_wall_cells.Push(start_randy * GetX() + start_randx);
@@ -779,12 +1073,12 @@ void cGradientCount::generateBarrier(cAvidaContext& ctx)
                randy < (m_halo_anchor_y + m_halo_inner_radius) && 
                randx > (m_halo_anchor_x - m_halo_inner_radius) && 
                randy > (m_halo_anchor_y - m_halo_inner_radius)) || 
-              (m_config == 0 && Element(randy * GetX() + randx).GetAmount())) {
+              (m_config == 0 && GetAmount(randy * GetX() + randx))) {
             num_blocks --;
             count_block = false;
           }
           if (count_block) {
-            Element(randy * GetX() + randx).SetAmount(m_plateau);
+            SetCellAmount(randy * GetX() + randx, m_plateau);
             if (m_plateau > 0) updateBounds(randx, randy);
             m_wall_cells.Push(randy * GetX() + randx);
             if (place_corner) {
@@ -793,7 +1087,7 @@ void cGradientCount::generateBarrier(cAvidaContext& ctx)
                      cornery < (m_halo_anchor_y + m_halo_inner_radius) && 
                      cornerx > (m_halo_anchor_x - m_halo_inner_radius) && 
                      cornery > (m_halo_anchor_y - m_halo_inner_radius))) ){
-                  Element(cornery * GetX() + cornerx).SetAmount(m_plateau);
+                  SetCellAmount(cornery * GetX() + cornerx, m_plateau);
                   if (m_plateau > 0) updateBounds(cornerx, cornery);
                   m_wall_cells.Push(randy * GetX() + randx);
                 }
@@ -832,14 +1126,14 @@ void cGradientCount::generateHills(cAvidaContext& ctx)
     if (m_min_usedx == -1 || m_min_usedy == -1 || m_max_usedx == -1 || m_max_usedy == -1) {
       for (int ii = 0; ii < GetX(); ii++) {
         for (int jj = 0; jj < GetY(); jj++) {
-          Element(jj * GetX() + ii).SetAmount(0);
+          SetCellAmount(jj * GetX() + ii, 0);
         }
       }
     }
     else {
       for (int ii = m_min_usedx; ii < m_max_usedx + 1; ii++) {
         for (int jj = m_min_usedy; jj < m_max_usedy + 1; jj++) {
-          Element(jj * GetX() + ii).SetAmount(0);
+          SetCellAmount(jj * GetX() + ii, 0);
         }
       }
     }
@@ -879,9 +1173,9 @@ void cGradientCount::generateHills(cAvidaContext& ctx)
           double thisheight = 0.0;
           double thisdist = sqrt((double) (m_peakx - ii) * (m_peakx - ii) + (m_peaky - jj) * (m_peaky - jj));
           // only plot values when within set config radius & if no larger amount has already been plotted for another overlapping hill
-          if ((thisdist <= rand_hill_radius) && (Element(jj * GetX() + ii).GetAmount() <  m_plateau / (thisdist + 1))) {
+          if ((thisdist <= rand_hill_radius) && (GetAmount(jj * GetX() + ii) <  m_plateau / (thisdist + 1))) {
           thisheight = m_plateau / (thisdist + 1);
-          Element(jj * GetX() + ii).SetAmount(thisheight);
+          SetCellAmount(jj * GetX() + ii, thisheight);
           if (thisheight > 0) updateBounds(ii, jj);
           }
         }
@@ -920,6 +1214,7 @@ void cGradientCount::ResetGradRes(cAvidaContext& ctx, int worldx, int worldy)
   
   m_initial = true;
   ResizeClear(worldx, worldy, m_geometry);
+  m_live_min_x = m_live_min_y = m_live_max_x = m_live_max_y = -1;
   if (m_habitat == 2) {
     m_topo_counter = m_updatestep;
     generateBarrier(ctx);
@@ -970,7 +1265,7 @@ void cGradientCount::UpdatePredatoryRes(cAvidaContext& ctx)
   // kill off up to 1 org per update within the predator radius (plateau area), with prob of death for selected prey = m_pred_odds
   if (m_predator) {
     for (int i = 0; i < m_plateau_cell_IDs.GetSize(); i ++) {
-      if (Element(m_plateau_cell_IDs[i]).GetAmount() >= 1) {
+      if (GetAmount(m_plateau_cell_IDs[i]) >= 1) {
         m_world->GetPopulation().ExecutePredatoryResource(ctx, m_plateau_cell_IDs[i], m_pred_odds, m_guarded_juvs_per_adult, m_hammer);
       }
     }
@@ -989,7 +1284,7 @@ void cGradientCount::UpdateDamagingRes(cAvidaContext& ctx)
   // we don't call this for walls and hills because they never move
   if (m_damage) {
     for (int i = 0; i < m_plateau_cell_IDs.GetSize(); i ++) {
-      if (Element(m_plateau_cell_IDs[i]).GetAmount() >= m_threshold) {
+      if (GetAmount(m_plateau_cell_IDs[i]) >= m_threshold) {
         // skip if initiating world and resources (cells don't exist yet)
         if (ctx.HasDriver()) m_world->GetPopulation().ExecuteDamagingResource(ctx, m_plateau_cell_IDs[i], m_damage, m_hammer);
       }
@@ -1002,7 +1297,7 @@ void cGradientCount::UpdateDeadlyRes(cAvidaContext& ctx)
   // we don't call this for walls and hills because they never move
   if (m_deadly) {
     for (int i = 0; i < m_plateau_cell_IDs.GetSize(); i ++) {
-      if (Element(m_plateau_cell_IDs[i]).GetAmount() >= m_threshold) {
+      if (GetAmount(m_plateau_cell_IDs[i]) >= m_threshold) {
         // skip if initiating world and resources (cells don't exist yet)
         if (ctx.HasDriver()) m_world->GetPopulation().ExecuteDeadlyResource(ctx, m_plateau_cell_IDs[i], m_death_odds, m_hammer);
       }
@@ -1044,7 +1339,7 @@ void cGradientCount::BuildProbabilisticRes(cAvidaContext& ctx, double lambda, do
 
   // only if theta == 1 do want want a 'hill' with resource for certain in the center
   if (theta == 0) {
-    Element(m_peaky * worldx + m_peakx).SetAmount(m_initial_plat);
+    SetCellAmount(m_peaky * worldx + m_peakx, m_initial_plat);
     if (m_initial_plat > 0) updateBounds(m_peakx, m_peaky);
     if (m_plateau_outflow > 0 || m_plateau_inflow > 0) { 
       if (num_cells == -1) m_prob_res_cells.Push(m_peaky * worldx + m_peakx);
@@ -1079,7 +1374,7 @@ void cGradientCount::BuildProbabilisticRes(cAvidaContext& ctx, double lambda, do
     double this_prob = (1/lambda) * (sqrt(2 / 3.14159)) * exp(-0.5 * pow(((cell_dist - theta) / lambda), 2));
     
     if (ctx.GetRandom().P(this_prob)) {
-      Element(cell_id).SetAmount(m_initial_plat);
+      SetCellAmount(cell_id, m_initial_plat);
       if (m_initial_plat > 0) updateBounds(this_x, this_y);
       if (m_plateau_outflow > 0 || m_plateau_inflow > 0) {
         if (loop_once) m_prob_res_cells.Push(cell_id);
@@ -1090,7 +1385,7 @@ void cGradientCount::BuildProbabilisticRes(cAvidaContext& ctx, double lambda, do
     }
     // just push this cell out of the way for this loop, but keep it around for next time
     else { 
-      Element(cell_id).SetAmount(0); 
+      SetCellAmount(cell_id, 0); 
       cell_id_array.Swap(cell_idx, max_unused_idx--);
     }
 
@@ -1106,9 +1401,9 @@ void cGradientCount::UpdateProbabilisticRes()
 {
   if (m_plateau_outflow > 0 || m_plateau_inflow > 0) {
     for (int i = 0; i < m_prob_res_cells.GetSize(); i++) {
-      double curr_val = Element(m_prob_res_cells[i]).GetAmount();
+      double curr_val = GetAmount(m_prob_res_cells[i]);
       double amount = curr_val + m_plateau_inflow - (curr_val * m_plateau_outflow);
-      Element(m_prob_res_cells[i]).SetAmount(amount); 
+      SetCellAmount(m_prob_res_cells[i], amount); 
       if (amount > 0) updateBounds(m_prob_res_cells[i] % GetX(), m_prob_res_cells[i] / GetX());
     }
   }
@@ -1118,7 +1413,7 @@ void cGradientCount::clearExistingProbRes()
 {
   for (int x = m_min_usedx; x < m_max_usedx + 1; x ++) {
     for (int y = m_min_usedy; y < m_max_usedy + 1; y ++) {
-      Element(y * GetX() + x).SetAmount(0);
+      SetCellAmount(y * GetX() + x, 0);
     }
   }
 }
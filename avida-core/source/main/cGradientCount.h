@@ -116,6 +116,31 @@ private:
   int m_min_usedy;
   int m_max_usedx;
   int m_max_usedy;
+  
+  // Distance from the peak at each offset (dx, dy), 0 <= dx, dy < m_stencil_size, and the slope m_height / (dist + 1)
+  // there.  Offsets beyond the spread (or the world) are outside every peak, so the stencil is only rebuilt when the
+  // spread, height or world size change.
+  Apto::Array<double> m_stencil_dist;
+  Apto::Array<double> m_stencil_slope;
+  int m_stencil_size;
+  int m_stencil_spread;
+  int m_stencil_height;
+  
+  // Bounding box of the cells that may hold any resource after the last fill (-1 if none)
+  int m_live_min_x;
+  int m_live_min_y;
+  int m_live_max_x;
+  int m_live_max_y;
+  
+  // Fills put off by BeginUpdateCount until FinishUpdateCount, with the peak each was made for
+  struct sPendingFill
+  {
+    int peakx;
+    int peaky;
+    bool just_reset;
+  };
+  bool m_defer_fills;
+  Apto::Array<sPendingFill> m_pending_fills;
     
 public:
   cGradientCount(cWorld* world, int peakx, int peaky, int height, int spread, double plateau, int decay,              
@@ -128,7 +153,12 @@ public:
   ~cGradientCount();
 
   void UpdateCount(cAvidaContext& ctx);
+  bool CanSplitUpdateCount() const;
+  void BeginUpdateCount(cAvidaContext& ctx);
+  void FinishUpdateCount();
   void StateAll();
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
   
   void SetGradInitialPlat(double plat_val) { m_initial_plat = plat_val; m_initial = true; }
   void SetGradPeakX(int peakx) { m_peakx = peakx; }
@@ -187,6 +217,7 @@ public:
   
 private:
   void fillinResourceValues();
+  void buildStencil();
   void updatePeakRes(cAvidaContext& ctx);
   void moveRes(cAvidaContext& ctx);
   int setHaloOrbit(cAvidaContext& ctx, int current_orbit);
@@ -50,6 +50,7 @@ void cLandscape::Reset(const Genome& in_genome)
 {
   base_genome       = in_genome;
   peak_genome       = in_genome;
+  m_base_checkpoints.Clear();
   base_fitness    = 0.0;
   base_merit      = 0.0;
   base_gestation  = 0;
@@ -96,7 +97,7 @@ void cLandscape::Reset(const Genome& in_genome)
 
 double cLandscape::ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome& in_genome)
 {
-  testcpu->TestGenome(ctx, m_cpu_test_info, in_genome);
+  testcpu->TestGenome(ctx, m_cpu_test_info, in_genome, m_base_checkpoints);
   
   double test_fitness = m_cpu_test_info.GetColonyFitness();
   
@@ -124,9 +125,9 @@ double cLandscape::ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome&
 
 void cLandscape::ProcessBase(cAvidaContext& ctx, cTestCPU* testcpu)
 {
-  // Collect info on base creature.
+  // Collect info on base creature, recording its gestation for the mutant tests to resume from.
   
-  testcpu->TestGenome(ctx, m_cpu_test_info, base_genome);
+  testcpu->RecordCheckpoints(ctx, m_cpu_test_info, base_genome, m_base_checkpoints);
   
   cPhenotype & phenotype = m_cpu_test_info.GetColonyOrganism()->GetPhenotype();
   base_fitness = m_cpu_test_info.GetColonyFitness();
@@ -921,7 +922,7 @@ double cLandscape::TestMutPair(cAvidaContext& ctx, cTestCPU* testcpu, Genome& mo
 
   mod_seq[line1] = mut1;
   mod_seq[line2] = mut2;
-  testcpu->TestGenome(ctx, m_cpu_test_info, mod_genome);
+  testcpu->TestGenome(ctx, m_cpu_test_info, mod_genome, m_base_checkpoints);
   double combo_fitness = m_cpu_test_info.GetColonyFitness() / base_fitness;
   
   mod_seq[line1] = base_seq[line1];
@@ -28,6 +28,7 @@
 #include "avida/output/Types.h"
 
 #include "cCPUTestInfo.h"
+#include "cTestCPUCheckpoints.h"
 #include "tMatrix.h"
 
 class cAvidaContext;
@@ -44,6 +45,7 @@ private:
   cWorld* m_world;
   cCPUTestInfo m_cpu_test_info;
   Genome base_genome;
+  cTestCPUCheckpoints m_base_checkpoints;  // Gestation of base_genome, resumed by the mutant tests
   Genome peak_genome;
   double base_fitness;
   double base_merit;
@@ -0,0 +1,135 @@
+/*
+ *  cMigrationTransport.cc
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/Avida.h"
+
+/* By default, Boost is not available.  To enable Boost, either modify your environment,
+ alter your build settings, or change this value -- BUT BE CAREFUL NOT TO CHECK IT IN LIKE THAT!
+ */
+#ifndef BOOST_IS_AVAILABLE
+#define BOOST_IS_AVAILABLE 0
+#endif
+
+#if BOOST_IS_AVAILABLE
+#include "cMigrationTransport.h"
+
+#include <cassert>
+#include <functional>
+
+
+//! First of the tags used for migration messages.
+static const int MIGRATION_TAG = 1;
+
+
+/*! Destructor.
+
+ Every world posts the same exchanges, so waiting on the outstanding ones here cannot
+ deadlock; it just makes sure that no request is left pending when MPI is finalized.
+ */
+cMPIMigrationTransport::~cMPIMigrationTransport() {
+	std::vector<migration_batch> discard;
+	while(!m_exchanges.empty()) {
+		Complete(discard);
+	}
+}
+
+
+/*! Starts an exchange by posting all of its sends and receives.
+ */
+void cMPIMigrationTransport::Post(std::vector<migration_batch>& outgoing) {
+	assert((int)outgoing.size() == m_comm.size());
+	assert((int)m_exchanges.size() < m_num_tags);
+
+	// every world posts its exchanges in the same order, so they agree on each exchange's tag:
+	const int tag = MIGRATION_TAG + m_next_tag;
+	m_next_tag = (m_next_tag + 1) % m_num_tags;
+
+	m_exchanges.push_back(exchange());
+	exchange& ex = m_exchanges.back();
+	ex.sent.swap(outgoing);
+	ex.recvd.resize(m_comm.size());
+	ex.reqs.reserve(2 * m_comm.size());
+
+	// receives first, so that each matching send can complete as soon as it arrives:
+	for(int i=0; i<m_comm.size(); ++i) {
+		ex.reqs.push_back(m_comm.irecv(i, tag, ex.recvd[i]));
+	}
+	for(int i=0; i<m_comm.size(); ++i) {
+		ex.reqs.push_back(m_comm.isend(i, tag, ex.sent[i]));
+	}
+
+	outgoing.clear();
+	outgoing.resize(m_comm.size());
+}
+
+
+/*! Completes the oldest outstanding exchange, blocking until all of its messages have
+ been both sent and received.
+ */
+void cMPIMigrationTransport::Complete(std::vector<migration_batch>& incoming) {
+	assert(!m_exchanges.empty());
+
+	exchange& ex = m_exchanges.front();
+	boost::mpi::wait_all(ex.reqs.begin(), ex.reqs.end());
+	incoming.swap(ex.recvd);
+	m_exchanges.pop_front();
+}
+
+
+/*! Sums a value across all worlds.
+ */
+int cMPIMigrationTransport::SumAll(int value) {
+	int total;
+	boost::mpi::all_reduce(m_comm, value, total, std::plus<int>());
+	return total;
+}
+
+
+/*! Sums a value across all worlds.
+ */
+double cMPIMigrationTransport::SumAll(double value) {
+	double total;
+	boost::mpi::all_reduce(m_comm, value, total, std::plus<double>());
+	return total;
+}
+
+
+/*! Starts an exchange; the single batch is held until it is completed.
+ */
+void cLoopbackMigrationTransport::Post(std::vector<migration_batch>& outgoing) {
+	assert(outgoing.size() == 1);
+
+	m_exchanges.push_back(migration_batch());
+	m_exchanges.back().swap(outgoing[0]);
+}
+
+
+/*! Completes the oldest outstanding exchange, delivering its batch back to this world.
+ */
+void cLoopbackMigrationTransport::Complete(std::vector<migration_batch>& incoming) {
+	assert(!m_exchanges.empty());
+
+	incoming.clear();
+	incoming.resize(1);
+	incoming[0].swap(m_exchanges.front());
+	m_exchanges.pop_front();
+}
+
+#endif // boost_is_available
@@ -0,0 +1,176 @@
+/*
+ *  cMigrationTransport.h
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cMigrationTransport_h
+#define cMigrationTransport_h
+
+/* THIS HEADER REQUIRES BOOST */
+#include <boost/mpi.hpp>
+#include <boost/mpi/environment.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include <deque>
+#include <string>
+#include <vector>
+
+class cAvidaContext;
+class cOrganism;
+class cPopulationCell;
+
+
+/*! Message that is sent from one cMultiProcessWorld to another during organism
+ migration.
+ */
+struct migration_message {
+	//! Default constructor.
+	migration_message() { }
+
+	//! Initializing constructor.
+	migration_message(cOrganism* org, const cPopulationCell& cell, double merit, int lineage);
+
+	//! Finish unpacking an organism from this message.
+	void unpack(cAvidaContext& ctx, cOrganism* org);
+
+	//! Serializer, used to (de)marshal organisms for migration.
+	template<class Archive>
+	void serialize(Archive & ar, const unsigned int version) {
+		ar & _genome & _merit & _lineage & _x & _y & _generation;
+	}
+
+	std::string _genome; //!< Genome of the migrating organism.
+	double _merit; //!< Merit of this organism in its originating population.
+	int _lineage; //!< Lineage label of this organism in its orginating population.
+	int _x; //!< X-coordinate of the cell from which this migrant originated.
+	int _y; //!< Y-coordinate of the cell from which this migrant originated.
+	int _generation; //!< Generation of this organism.
+};
+
+//! All of the migrants sent from one world to another during a single update.
+typedef std::vector<migration_message> migration_batch;
+
+
+/*! Transport used by cMultiProcessWorld to move migrants between worlds.
+
+ Exchanges are collective: during every update, every world posts exactly one batch
+ (possibly empty) to every world, including itself, and later completes that exchange
+ by collecting one batch from every world.  Exchanges are completed in the order in
+ which they were posted, and any number of them may be outstanding at once, which is
+ what allows communication to overlap with the computation of later updates.
+ */
+class cMigrationTransport
+	{
+	public:
+		//! Destructor.
+		virtual ~cMigrationTransport() { }
+
+		//! Returns the index of this world.
+		virtual int Rank() const = 0;
+
+		//! Returns the number of worlds.
+		virtual int Size() const = 0;
+
+		//! Starts an exchange; outgoing[i] is the batch for world i (outgoing.size() == Size()).
+		virtual void Post(std::vector<migration_batch>& outgoing) = 0;
+
+		//! Completes the oldest outstanding exchange; incoming[i] is the batch received from world i.
+		virtual void Complete(std::vector<migration_batch>& incoming) = 0;
+
+		//! Returns the number of exchanges that have been posted but not completed.
+		virtual int Outstanding() const = 0;
+
+		//! Sums a value across all worlds.
+		virtual int SumAll(int value) = 0;
+
+		//! Sums a value across all worlds.
+		virtual double SumAll(double value) = 0;
+	};
+
+
+/*! Migration transport over Boost.MPI.
+
+ Each exchange is one non-blocking send and one non-blocking receive per pair of worlds.
+ Boost.MPI sends a serialized batch as two messages (its size, then its contents) and
+ only posts the receive for the contents once the size has arrived, so receives of two
+ outstanding exchanges under one tag could pick up each other's messages.  Each
+ outstanding exchange therefore gets its own tag, rotating over max_outstanding values.
+ */
+class cMPIMigrationTransport : public cMigrationTransport
+	{
+	private:
+		cMPIMigrationTransport(); // @not_implemented
+		cMPIMigrationTransport(const cMPIMigrationTransport&); // @not_implemented
+		cMPIMigrationTransport& operator=(const cMPIMigrationTransport&); // @not_implemented
+
+		//! Requests and buffers of one outstanding exchange.
+		struct exchange {
+			std::vector<migration_batch> sent; //!< Outgoing batches; must outlive their send requests.
+			std::vector<migration_batch> recvd; //!< Incoming batches, by source world.
+			std::vector<boost::mpi::request> reqs; //!< Send and receive requests.
+		};
+
+		boost::mpi::communicator& m_comm; //!< World-wide MPI communicator.
+		std::deque<exchange> m_exchanges; //!< Outstanding exchanges, oldest first.
+		int m_num_tags; //!< Number of exchanges that may be outstanding at once, each with its own tag.
+		int m_next_tag; //!< Offset of the tag for the next exchange.
+
+	public:
+		//! Constructor; max_outstanding is MP_MIGRATION_LAG + 1.
+		cMPIMigrationTransport(boost::mpi::communicator& comm, int max_outstanding)
+		: m_comm(comm), m_num_tags(max_outstanding), m_next_tag(0) { }
+
+		//! Destructor; completes any outstanding exchanges, discarding their migrants.
+		virtual ~cMPIMigrationTransport();
+
+		virtual int Rank() const { return m_comm.rank(); }
+		virtual int Size() const { return m_comm.size(); }
+		virtual void Post(std::vector<migration_batch>& outgoing);
+		virtual void Complete(std::vector<migration_batch>& incoming);
+		virtual int Outstanding() const { return m_exchanges.size(); }
+		virtual int SumAll(int value);
+		virtual double SumAll(double value);
+	};
+
+
+/*! In-process loopback transport, for testing Avida-MP without MPI.
+
+ This is a universe of a single world: every batch posted is delivered back to that
+ same world, which exercises batching and the migration lag exactly as a one-process
+ MPI run would.
+ */
+class cLoopbackMigrationTransport : public cMigrationTransport
+	{
+	private:
+		std::deque<migration_batch> m_exchanges; //!< Outstanding exchanges, oldest first.
+
+	public:
+		//! Constructor.
+		cLoopbackMigrationTransport() { }
+
+		virtual int Rank() const { return 0; }
+		virtual int Size() const { return 1; }
+		virtual void Post(std::vector<migration_batch>& outgoing);
+		virtual void Complete(std::vector<migration_batch>& incoming);
+		virtual int Outstanding() const { return m_exchanges.size(); }
+		virtual int SumAll(int value) { return value; }
+		virtual double SumAll(double value) { return value; }
+	};
+
+#endif
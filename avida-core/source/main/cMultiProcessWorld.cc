@@ -38,12 +38,9 @@
 #include "cPopulationCell.h"
 #include "cMultiProcessWorld.h"
 #include "nGeometry.h"
-#include <map>
-#include <functional>
 #include <iostream>
 #include <sstream>
 #include <cmath>
-#include <boost/optional.hpp>
 
 using namespace Avida;
 
@@ -52,48 +49,42 @@ using namespace Avida;
 static const char* UPDATE="mean update time [ut]";
 static const char* POSTUPDATE="mean post-update time [post]";
 static const char* CALCUPDATE="mean calc-update time [calc]";
+static const char* MIGRATIONWAIT="mean migration wait time [wait]";
 
-/*! Message that is sent from one cMultiProcessWorld to another during organism
- migration.
+
+/*! Pack an organism into a migration message.
  */
-struct migration_message {
-	//! Default constructor.
-	migration_message() { }
-	
-	//! Initializing constructor.
-	migration_message(cOrganism* org, const cPopulationCell& cell, double merit, int lineage)
-	: _merit(merit), _lineage(lineage) {
-		_genome = org->GetGenome().AsString();
-		cell.GetPosition(_x, _y);
-		_generation = org->GetPhenotype().GetGeneration();
-	}
+migration_message::migration_message(cOrganism* org, const cPopulationCell& cell, double merit, int lineage)
+: _merit(merit), _lineage(lineage) {
+	_genome = org->GetGenome().AsString();
+	cell.GetPosition(_x, _y);
+	_generation = org->GetPhenotype().GetGeneration();
+}
 
-	//! Finish unpacking an organism from this message.
-	void unpack(cOrganism* org) {
-		org->UpdateMerit(cAvidaContext& ctx, _merit);
-		org->GetPhenotype().SetGeneration(_generation);
-	}	
-	
-	//! Serializer, used to (de)marshal organisms for migration.
-	template<class Archive>
-	void serialize(Archive & ar, const unsigned int version) {
-		ar & _genome & _merit & _lineage & _x & _y & _generation;
-	}
-	
-	std::string _genome; //!< Genome of the migrating organism.
-	double _merit; //!< Merit of this organism in its originating population.
-	int _lineage; //!< Lineage label of this organism in its orginating population.
-	int _x; //!< X-coordinate of the cell from which this migrant originated.
-	int _y; //!< Y-coordinate of the cell from which this migrant originated.
-	int _generation; //!< Generation of this organism.
-};
+
+/*! Finish unpacking an organism from this message.
+ */
+void migration_message::unpack(cAvidaContext& ctx, cOrganism* org) {
+	org->UpdateMerit(ctx, _merit);
+	org->GetPhenotype().SetGeneration(_generation);
+}
 
 
-/*! Create and initialize a cMultiProcessWorld.
+/*! Create and initialize a cMultiProcessWorld that migrates over MPI.
  */
 cMultiProcessWorld* cMultiProcessWorld::Initialize(cAvidaConfig* cfg, const cString& cwd, boost::mpi::environment& env, boost::mpi::communicator& worldcomm)
 {
-  cMultiProcessWorld* world = new cMultiProcessWorld(cfg, cwd, env, worldcomm);
+  // a lag of N keeps up to N+1 exchanges outstanding (a negative lag is rejected by the constructor)
+  const int max_outstanding = Apto::Max(0, cfg->MP_MIGRATION_LAG.Get()) + 1;
+  return Initialize(cfg, cwd, new cMPIMigrationTransport(worldcomm, max_outstanding));
+}
+
+
+/*! Create and initialize a cMultiProcessWorld that migrates over the given transport.
+ */
+cMultiProcessWorld* cMultiProcessWorld::Initialize(cAvidaConfig* cfg, const cString& cwd, cMigrationTransport* transport)
+{
+  cMultiProcessWorld* world = new cMultiProcessWorld(cfg, cwd, transport);
   if (!world->setup(NULL)) {
     delete world;
     world = NULL;
@@ -107,31 +98,45 @@ cMultiProcessWorld* cMultiProcessWorld::Initialize(cAvidaConfig* cfg, const cStr
  Since we're running in a multi-process environment from a single command line,
  we need to tweak the random seed and data dirs a bit.
  */
-cMultiProcessWorld::cMultiProcessWorld(cAvidaConfig* cfg, const cString& cwd, boost::mpi::environment& env, boost::mpi::communicator& worldcomm) 
+cMultiProcessWorld::cMultiProcessWorld(cAvidaConfig* cfg, const cString& cwd, cMigrationTransport* transport) 
 : cWorld(cfg, cwd)
-, m_mpi_env(env)
-, m_mpi_world(worldcomm)
+, m_transport(transport)
+, m_outgoing(transport->Size())
+, m_migration_lag(cfg->MP_MIGRATION_LAG.Get())
 , m_universe_dim(0)
 , m_universe_x(0)
 , m_universe_y(0)
 , m_universe_popsize(-1) {
+	if(m_migration_lag < 0) {
+		GetDriver().RaiseFatalException(-1, "MP_MIGRATION_LAG must not be negative.");
+	}
+
 	if(GetConfig().BIRTH_METHOD.Get() == POSITION_OFFSPRING_RANDOM) {
 		// there are a couple bugs in spatial that still need to be worked out:
 		// specifically, what to do about size(1) universes?
 		GetDriver().RaiseFatalException(-1, "Spatial Avida-MP worlds are not currently supported.");
 
-		m_universe_dim = sqrt(m_mpi_world.size());
-		if((m_universe_dim*m_universe_dim) != m_mpi_world.size()) {
+		m_universe_dim = sqrt(m_transport->Size());
+		if((m_universe_dim*m_universe_dim) != m_transport->Size()) {
 			GetDriver().RaiseFatalException(-1, "Spatial Avida-MP worlds must be square.");
 		}
 		
 		// where is *this* world in the universe?
-		m_universe_x = m_mpi_world.rank() % m_universe_dim;
-		m_universe_y = m_mpi_world.rank() / m_universe_dim;
+		m_universe_x = m_transport->Rank() % m_universe_dim;
+		m_universe_y = m_transport->Rank() / m_universe_dim;
 	}
 }
 
 
+/*! Destructor.
+ 
+ Migrants still in transit when the run ends are dropped.
+ */
+cMultiProcessWorld::~cMultiProcessWorld() {
+	delete m_transport;
+}
+
+
 /*! Migrate this organism to a different world.
  
  If this method is called, it means that this organism is to be migrated to a
@@ -142,6 +147,8 @@ cMultiProcessWorld::cMultiProcessWorld(cAvidaConfig* cfg, const cString& cwd, bo
 void cMultiProcessWorld::MigrateOrganism(cOrganism* org, const cPopulationCell& cell, const cMerit& merit, int lineage) {
 	assert(org!=0);
 	int dst_world=-1;
+	const int rank = m_transport->Rank();
+	const int size = m_transport->Size();
 	
 	// which world is this organism migrating to?
 	switch(GetConfig().BIRTH_METHOD.Get()) {
@@ -150,27 +157,27 @@ void cMultiProcessWorld::MigrateOrganism(cOrganism* org, const cPopulationCell&
 			cell.GetPosition(x,y);
 			if(x == 0) {
 				// migrate left
-				dst_world = m_mpi_world.rank() - 1;
+				dst_world = rank - 1;
 			} else if(x == (GetConfig().WORLD_X.Get()-1)) {
 				// migrate right
-				dst_world = m_mpi_world.rank() + 1;
+				dst_world = rank + 1;
 			} else if(y == 0) {
 				// migrate down
-				dst_world = m_mpi_world.rank() - m_universe_dim;
+				dst_world = rank - m_universe_dim;
 			} else if(y == (GetConfig().WORLD_Y.Get()-1)) {
 				// migrate up
-				dst_world = m_mpi_world.rank() + m_universe_dim;
+				dst_world = rank + m_universe_dim;
 			}
 			break;
 		}
 		case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
 			// prevent a migration back to this same world, unless this is the only world
 			// we have:
-			if(m_mpi_world.size() == 1) {
+			if(size == 1) {
 				dst_world = 0;
 			} else {
-				dst_world = GetRandom().GetInt(m_mpi_world.size()-1);
-				if (dst_world >= m_mpi_world.rank()) {
+				dst_world = GetRandom().GetInt(size-1);
+				if (dst_world >= rank) {
 					++dst_world;
 				}
 			}
@@ -181,12 +188,12 @@ void cMultiProcessWorld::MigrateOrganism(cOrganism* org, const cPopulationCell&
 		}
 	}
 
-	assert(dst_world < m_mpi_world.size());
+	assert(dst_world < size);
 	assert(dst_world >= 0);
 
-	// the tag is set to the number of messages previously sent; this is to allow
-	// the receiver to sort messages for consistency.
-	m_reqs.push_back(m_mpi_world.isend(dst_world, m_reqs.size(), migration_message(org, cell, merit.GetDouble(), lineage)));
+	// migrants are held until the end of the update, and then sent as one batch per
+	// destination; their order within the batch is the order in which they left.
+	m_outgoing[dst_world].push_back(migration_message(org, cell, merit.GetDouble(), lineage));
 	
 	// stats tracking:
 	GetStats().OutgoingMigrant(org);
@@ -210,10 +217,10 @@ void cMultiProcessWorld::MigrateOrganism(cOrganism* org, const cPopulationCell&
 bool cMultiProcessWorld::TestForMigration() {
 	switch(GetConfig().BIRTH_METHOD.Get()) {
 		case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
-			if(m_mpi_world.size() == 1) {
+			if(m_transport->Size() == 1) {
 				return true; // 1 world == always migrate
 			}
-			return GetRandom().P((m_mpi_world.size() - 1) / m_mpi_world.size());
+			return GetRandom().P((m_transport->Size() - 1) / m_transport->Size());
 		}
 		default: {
 			// default is to not migrate!
@@ -259,94 +266,44 @@ bool cMultiProcessWorld::IsWorldBoundary(const cPopulationCell& cell) {
 /*! Process post-update events.
  
  This method is called after each update of the local population completes.  Here
- we check to see if this world has received any migrants from other worlds, and if
- so, we inject them into the local population.  Note that this is an unconditional
- injection -- that is, migrants are "pushed" to this world.
+ we send the migrants that left this world during the update, one batch per world,
+ and inject the migrants that other worlds sent MP_MIGRATION_LAG updates ago into the
+ local population.  Note that this is an unconditional injection -- that is, migrants
+ are "pushed" to this world.
  
- Migrants are injected according to BIRTH_METHOD.
+ Every world exchanges a batch (possibly empty) with every other world each update, so
+ completing an exchange is itself the synchronization point; no barriers are needed.
+ With a lag of 0 this method blocks until the exchange for the current update is done,
+ as before.  With a lag of 1 or more, the exchange only has to finish by the end of a
+ later update, and ordinarily it will have finished long before then.
  
- \todo What to do about cross-world lineage labels?
+ Migrants are injected according to BIRTH_METHOD, ordered by source world and then by
+ the order in which they left it, so that results do not depend on message timing.
  
- \todo At the moment, this method forces synchronization on update boundaries across
- *all* worlds.  This could slow things down quite a bit, so we may need to consider a
- second mode that relaxes consistency in favor of speed.
+ \todo What to do about cross-world lineage labels?
  */
 void cMultiProcessWorld::ProcessPostUpdate(cAvidaContext& ctx) {
-	namespace mpi = boost::mpi;
-	using namespace boost;
-	
 	// restart the timer for this method, and get the elapsed time for the past update:
 	m_pf[UPDATE] = m_update_timer.elapsed();
 	m_post_update_timer.restart();
 	
-	// wait until we're sure that this process has sent all its messages:
-	mpi::wait_all(m_reqs.begin(), m_reqs.end());
-	m_reqs.clear();
+	// send this update's migrants:
+	m_transport->Post(m_outgoing);
 	
-	// at this point, we know that *this* process has sent everything.  but, we don't
-	// know if it's *received* everything.  so, we're going to put in a synchronization
-	// barrier, which means that every process must reach the barrier before any are allowed
-	// to proceed.  since we just finished waiting for all communication to complete,
-	// this means that all messages must have been received, too.
-	m_mpi_world.barrier();	
-	
-	// now, receive all the messages, but store them in order by source and tag:
-	typedef std::map<int,migration_message> rx_tag_t;
-	typedef std::map<int,rx_tag_t> rx_src_t;
-	rx_src_t recvd;
-	optional<mpi::status> s = m_mpi_world.iprobe(mpi::any_source,mpi::any_tag);
-	while(s.is_initialized()) {
-		migration_message msg;
-		m_mpi_world.recv(s->source(), s->tag(), msg);
-		recvd[s->source()][s->tag()] = msg;		
-		// any others?
-		s = m_mpi_world.iprobe(mpi::any_source,mpi::any_tag);		
-	}
-	
-	// iterate over received messages in-order, injecting genomes into our population:
-	for(rx_src_t::iterator i=recvd.begin(); i!=recvd.end(); ++i) {
-		for(rx_tag_t::iterator j=i->second.begin(); j!=i->second.end(); ++j) {
-			//std::cerr << "**********  INJECTING *********** " << i->first << " " << j->first << std::endl;
-			// ok, add this migrant to the current population
-			migration_message& migrant = j->second;
-			int target_cell=-1;
-			
-			switch(GetConfig().BIRTH_METHOD.Get()) {
-				case POSITION_OFFSPRING_RANDOM: { // spatial
-					// invert the orginating cell
-					migrant._x = GetConfig().WORLD_X.Get() - migrant._x - 1;
-					migrant._y = GetConfig().WORLD_Y.Get() - migrant._y - 1;
-					target_cell = GetConfig().WORLD_Y.Get() * migrant._y + migrant._x;
-					break;
-				}
-				case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
-					target_cell = GetRandom().GetInt(GetPopulation().GetSize());
-					break;
-				}
-				default: {
-					GetDriver().RaiseFatalException(-1, "Avida-MP only supports BIRTH_METHODS 0 (POSITION_OFFSPRING_RANDOM) and 4 (POSITION_OFFSPRING_FULL_SOUP_RANDOM).");
-				}
-			}
-			
-			GetPopulation().InjectGenome(target_cell,
-																	 SRC_ORGANISM_RANDOM, // for right now, we'll treat this as a random organism injection
-																	 Genome(cString(migrant._genome.c_str())), // genome unpacked from message
-																	 ctx, migrant._lineage); // lineage label
-			// unpack the rest from the message:
-			migrant.unpack(GetPopulation().GetCell(target_cell).GetOrganism());
-			GetStats().IncomingMigrant(GetPopulation().GetCell(target_cell).GetOrganism());
+	// receive the migrants that are due, and inject them into our population:
+	double wait_time = 0.0;
+	while(m_transport->Outstanding() > m_migration_lag) {
+		m_migration_timer.restart();
+		m_transport->Complete(m_incoming);
+		wait_time += m_migration_timer.elapsed();
+		
+		for(std::size_t i=0; i<m_incoming.size(); ++i) {
+			InjectMigrants(ctx, m_incoming[i]);
 		}
 	}
 	
-	// oh, sweet sanity; make sure that we actually processed all messages.
-	assert(!m_mpi_world.iprobe(mpi::any_source,mpi::any_tag).is_initialized());
-	
-	// finally, we need another barrier down here, in the off chance that one of the
-	// processes is really speedy and manages to migrate another org to this world
-	// before we finished the probe-loop.
-	m_mpi_world.barrier();
-
 	// record profiling stats:
+	m_pf[MIGRATIONWAIT] = wait_time;
 	m_pf[POSTUPDATE] = m_post_update_timer.elapsed();
 	GetStats().ProfilingData(m_pf);
 	m_pf.clear();
@@ -356,6 +313,43 @@ void cMultiProcessWorld::ProcessPostUpdate(cAvidaContext& ctx) {
 }
 
 
+/*! Inject a batch of migrants into the local population.
+ */
+void cMultiProcessWorld::InjectMigrants(cAvidaContext& ctx, migration_batch& batch) {
+	for(migration_batch::iterator i=batch.begin(); i!=batch.end(); ++i) {
+		// ok, add this migrant to the current population
+		migration_message& migrant = *i;
+		int target_cell=-1;
+		
+		switch(GetConfig().BIRTH_METHOD.Get()) {
+			case POSITION_OFFSPRING_RANDOM: { // spatial
+				// invert the orginating cell
+				migrant._x = GetConfig().WORLD_X.Get() - migrant._x - 1;
+				migrant._y = GetConfig().WORLD_Y.Get() - migrant._y - 1;
+				target_cell = GetConfig().WORLD_Y.Get() * migrant._y + migrant._x;
+				break;
+			}
+			case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
+				target_cell = GetRandom().GetInt(GetPopulation().GetSize());
+				break;
+			}
+			default: {
+				GetDriver().RaiseFatalException(-1, "Avida-MP only supports BIRTH_METHODS 0 (POSITION_OFFSPRING_RANDOM) and 4 (POSITION_OFFSPRING_FULL_SOUP_RANDOM).");
+			}
+		}
+		
+		GetPopulation().InjectGenome(target_cell,
+																 SRC_ORGANISM_RANDOM, // for right now, we'll treat this as a random organism injection
+																 Genome(cString(migrant._genome.c_str())), // genome unpacked from message
+																 ctx, migrant._lineage); // lineage label
+		// unpack the rest from the message:
+		migrant.unpack(ctx, GetPopulation().GetCell(target_cell).GetOrganism());
+		GetStats().IncomingMigrant(GetPopulation().GetCell(target_cell).GetOrganism());
+	}
+	batch.clear();
+}
+
+
 /*! Returns true if this world allows early exits, e.g., when the population reaches 0.
  */
 bool cMultiProcessWorld::AllowsEarlyExit() const
@@ -375,8 +369,6 @@ bool cMultiProcessWorld::AllowsEarlyExit() const
  */
 int cMultiProcessWorld::CalculateUpdateSize()
 {
-	namespace mpi = boost::mpi;
-	using namespace boost;
 	m_calc_update_timer.restart();
 	
 	int update_size=0;
@@ -388,7 +380,7 @@ int cMultiProcessWorld::CalculateUpdateSize()
 		case MP_SCHEDULING_INTEGRATED: { // MP aware
 			// sum the total number of organisms in all populations, storing that value
 			// so that we know if we have to exit early:
-			all_reduce(m_mpi_world, GetPopulation().GetNumOrganisms(), m_universe_popsize, std::plus<int>());
+			m_universe_popsize = m_transport->SumAll(GetPopulation().GetNumOrganisms());
 			
 			// sum the merits of organisms in all populations.
 			// there's no clean way to do this across the different schedulers in avida,
@@ -400,8 +392,7 @@ int cMultiProcessWorld::CalculateUpdateSize()
 					local_merit += cell.GetOrganism()->GetPhenotype().GetMerit().GetDouble();
 				}
 			}
-			double total_merit;
-			all_reduce(m_mpi_world, local_merit, total_merit, std::plus<double>());
+			double total_merit = m_transport->SumAll(local_merit);
 			
 			// ok, calculate the total CPU cycles allotted to this population:
 			update_size = (local_merit/total_merit) * GetConfig().AVE_TIME_SLICE.Get() * m_universe_popsize;
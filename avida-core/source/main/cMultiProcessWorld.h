@@ -30,6 +30,7 @@
 
 #include "cWorld.h"
 #include "cAvidaConfig.h"
+#include "cMigrationTransport.h"
 #include "cStats.h"
 
 /*! Multi-process Avida world.
@@ -39,6 +40,12 @@
  a single new technique, that of "cross-world migration," where an individual organism
  is transferred to a different Avida world and injected into a random location in that
  world's population.
+
+ Migrants are batched by destination world, and all of the batches from an update are
+ exchanged at once (see cMigrationTransport).  With MP_MIGRATION_LAG > 0, the migrants of
+ update N are delivered at the end of update N+MP_MIGRATION_LAG, so that their transfer
+ overlaps with the computation of the intervening updates instead of blocking every
+ world at each update boundary.
  */
 class cMultiProcessWorld : public cWorld
 	{
@@ -48,9 +55,10 @@ class cMultiProcessWorld : public cWorld
 		cMultiProcessWorld& operator=(const cMultiProcessWorld&); // @not_implemented
 		
 	protected:
-		boost::mpi::environment& m_mpi_env; //!< MPI environment.
-		boost::mpi::communicator& m_mpi_world; //!< World-wide MPI communicator.
-		std::vector<boost::mpi::request> m_reqs; //!< Requests outstanding since the last ProcessPostUpdate.
+		cMigrationTransport* m_transport; //!< Moves migrants between worlds (owned).
+		std::vector<migration_batch> m_outgoing; //!< Migrants leaving during the current update, by destination world.
+		std::vector<migration_batch> m_incoming; //!< Migrants arriving, by source world; reused across updates.
+		int m_migration_lag; //!< Number of updates that migrants spend in transit.
 		int m_universe_dim; //!< Dimension (x & y) of the universe (number of worlds along the side of a grid of worlds).
 		int m_universe_x; //!< X coordinate of this world.
 		int m_universe_y; //!< Y coordinate of this world.
@@ -59,17 +67,24 @@ class cMultiProcessWorld : public cWorld
 		boost::timer m_update_timer; //!< Tracks the clock-time of updates.
 		boost::timer m_post_update_timer; //!< Tracks the clock-time of post-update processing.
 		boost::timer m_calc_update_timer; //!< Tracks the clock-time of calculating the update size.
+		boost::timer m_migration_timer; //!< Tracks the clock-time spent waiting for migrants.
 		cStats::profiling_stats_t m_pf; //!< Buffers profiling stats until the post-update step.
 		
 		//! Constructor (prefer Initialize).
-		cMultiProcessWorld(cAvidaConfig* cfg, const cString& cwd, boost::mpi::environment& env, boost::mpi::communicator& worldcomm);
+		cMultiProcessWorld(cAvidaConfig* cfg, const cString& cwd, cMigrationTransport* transport);
+
+		//! Inject a batch of migrants into the local population.
+		void InjectMigrants(cAvidaContext& ctx, migration_batch& batch);
 
 	public:
-		//! Create and initialize a cMultiProcessWorld.
+		//! Create and initialize a cMultiProcessWorld that migrates over MPI.
 		static cMultiProcessWorld* Initialize(cAvidaConfig* cfg, const cString& cwd, boost::mpi::environment& env, boost::mpi::communicator& worldcomm);
+
+		//! Create and initialize a cMultiProcessWorld that migrates over the given transport (takes ownership).
+		static cMultiProcessWorld* Initialize(cAvidaConfig* cfg, const cString& cwd, cMigrationTransport* transport);
 		
 		//! Destructor.
-		virtual ~cMultiProcessWorld() { }
+		virtual ~cMultiProcessWorld();
 		
 		//! Migrate this organism to a different world.
 		virtual void MigrateOrganism(cOrganism* org, const cPopulationCell& cell,
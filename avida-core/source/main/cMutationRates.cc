@@ -24,6 +24,7 @@
 
 #include "cWorld.h"
 #include "cAvidaConfig.h"
+#include "cChunkedFile.h"
 
 
 void cMutationRates::Setup(cWorld* world)
@@ -133,3 +134,37 @@ void cMutationRates::Copy(const cMutationRates& in_muts)
   meta = in_muts.meta;
   update = in_muts.update;
 }
+
+// Every rate is a double, so each group of rates is saved as a run of doubles
+template <class RateGroup> static void saveRates(cChunkBuffer& buf, const RateGroup& rates)
+{
+  const double* values = reinterpret_cast<const double*>(&rates);
+  for (int i = 0; i < (int)(sizeof(RateGroup) / sizeof(double)); i++) buf.PutDouble(values[i]);
+}
+
+template <class RateGroup> static void loadRates(cChunkBuffer& buf, RateGroup& rates)
+{
+  double* values = reinterpret_cast<double*>(&rates);
+  for (int i = 0; i < (int)(sizeof(RateGroup) / sizeof(double)); i++) values[i] = buf.GetDouble();
+}
+
+void cMutationRates::SaveState(cChunkBuffer& buf) const
+{
+  saveRates(buf, copy);
+  saveRates(buf, divide);
+  saveRates(buf, point);
+  saveRates(buf, inject);
+  saveRates(buf, meta);
+  saveRates(buf, update);
+}
+
+bool cMutationRates::LoadState(cChunkBuffer& buf)
+{
+  loadRates(buf, copy);
+  loadRates(buf, divide);
+  loadRates(buf, point);
+  loadRates(buf, inject);
+  loadRates(buf, meta);
+  loadRates(buf, update);
+  return !buf.Fail();
+}
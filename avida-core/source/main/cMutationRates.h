@@ -25,6 +25,7 @@
 
 #include "cAvidaContext.h"
 
+class cChunkBuffer;
 class cWorld;
 
 class cMutationRates
@@ -107,6 +108,10 @@ public:
   void Setup(cWorld* world);
   void Clear();
   void Copy(const cMutationRates& in_muts);
+  
+  // Snapshot state
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
 
   // Copy muts should always check if they are 0.0 before consulting the random number generator for performance
   bool TestCopyMut(cAvidaContext& ctx) const { return (copy.mut_prob == 0.0) ? false : ctx.GetRandom().P(copy.mut_prob); }
@@ -123,6 +123,9 @@ public:
   virtual int GetCurrPeakY(cAvidaContext& ctx, int res_id) = 0;
   virtual int GetFrozenPeakX(cAvidaContext& ctx, int res_id) = 0; 
   virtual int GetFrozenPeakY(cAvidaContext& ctx, int res_id) = 0;
+  virtual int CountFrozenResCells(int res_id, int x1, int y1, int x2, int y2) = 0;   // -1 if not known
+  virtual int CountOccupiedCells(int x1, int y1, int x2, int y2) = 0;                 // -1 if not known
+  virtual int CountAVs(int x1, int y1, int x2, int y2) = 0;                           // -1 if not known
   virtual cResourceCount* GetResourceCount() = 0;
   virtual void TriggerDoUpdates(cAvidaContext& ctx) = 0;
   virtual void UpdateResources(cAvidaContext& ctx, const Apto::Array<double>& res_change) = 0;
@@ -42,6 +42,29 @@ void cOrgSensor::ResetOrgSensor()
   m_soloBounds.Resize(m_world->GetEnvironment().GetResourceLib().GetSize());
 }
 
+void cOrgSensor::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutBool(m_return_rel_facing);
+  buf.PutBool(m_has_seen_display);
+  buf.PutVarInt(m_last_seen_display.distance);
+  buf.PutVarInt(m_last_seen_display.direction);
+  buf.PutVarInt(m_last_seen_display.thing_id);
+  buf.PutVarInt(m_last_seen_display.value);
+  buf.PutVarInt(m_last_seen_display.message);
+}
+
+bool cOrgSensor::LoadState(cChunkBuffer& buf)
+{
+  m_return_rel_facing = buf.GetBool();
+  m_has_seen_display = buf.GetBool();
+  m_last_seen_display.distance = (int)buf.GetVarInt();
+  m_last_seen_display.direction = (int)buf.GetVarInt();
+  m_last_seen_display.thing_id = (int)buf.GetVarInt();
+  m_last_seen_display.value = (int)buf.GetVarInt();
+  m_last_seen_display.message = (int)buf.GetVarInt();
+  return !buf.Fail();
+}
+
 const cOrgSensor::sLookOut cOrgSensor::SetLooking(cAvidaContext& ctx, sLookInit& in_defs, int facing, int cell_id, bool use_ft)
 {
   int& habitat_used = in_defs.habitat;
@@ -466,6 +489,7 @@ void cOrgSensor::WalkCells(cAvidaContext& ctx, sLookInit& in_defs, const int fac
   bool foundFirstVisible = false;
   
   bool stop_at_first_found = (search_type == 0) || (habitat_used == -2 && (search_type == -1 || search_type == 1));
+  const bool pass_over_empty = CanPassOverEmptyCells(in_defs, val_res);
   
   // START WALKING
   bool first_step = true;
@@ -485,6 +509,18 @@ void cOrgSensor::WalkCells(cAvidaContext& ctx, sLookInit& in_defs, const int fac
       if (!do_left && direction == left) continue;
       if (!do_right && direction == right) break;
       
+      // when every cell on this side is valid but the indexes show nothing there to see, testing each would find nothing
+      if (pass_over_empty && num_cells_either_side > 0 && !((habitat_used != -2 && habitat_used != 3) && !TestBounds(center_cell, tot_bounds))) {
+        const Apto::Coord<int> near_cell = center_cell + direction;
+        const Apto::Coord<int> far_cell = center_cell + direction * num_cells_either_side;
+        if (TestBounds(near_cell, worldBounds) && TestBounds(far_cell, worldBounds) && SideRunIsEmpty(in_defs, val_res, near_cell, far_cell, worldBounds)) {
+          any_valid_side_cells = true;
+          first_step = false;
+          this_cell = near_cell;
+          continue;
+        }
+      }
+      
       // walk in from the farthest cell on side towards the center
       for (int j = num_cells_either_side; j > 0; j--) {
         bool valid_cell = true;
@@ -676,6 +712,7 @@ void cOrgSensor::WalkTorus(cAvidaContext& ctx, sLookInit& in_defs, const int fac
   bool foundFirstVisible = false;
   
   bool stop_at_first_found = (search_type == 0) || (habitat_used == -2 && (search_type == -1 || search_type == 1));
+  const bool pass_over_empty = CanPassOverEmptyCells(in_defs, val_res);
   
   // START WALKING
   bool first_step = true;
@@ -691,6 +728,19 @@ void cOrgSensor::WalkTorus(cAvidaContext& ctx, sLookInit& in_defs, const int fac
     for (int do_lr = 0; do_lr <= 1; do_lr++) {
       if (do_lr == 1) direction = right;
       
+      // when every cell on this side is valid but the indexes show nothing there to see, testing each would find nothing
+      if (pass_over_empty && num_cells_either_side > 0 && !(habitat_used != -2 && habitat_used != 3 && !TestBounds(center_cell, tot_bounds))) {
+        const Apto::Coord<int> near_cell = center_cell + direction;
+        const Apto::Coord<int> far_cell = center_cell + direction * num_cells_either_side;
+        if (SideRunIsEmpty(in_defs, val_res, near_cell, far_cell, worldBounds)) {
+          any_valid_side_cells = true;
+          first_step = false;
+          this_cell = near_cell;
+          CorrectTorusEdge(this_cell, worldBounds);
+          continue;
+        }
+      }
+      
       // walk in from the farthest cell on side towards the center
       for (int j = num_cells_either_side; j > 0; j--) {
         bool valid_cell = true;
@@ -1084,6 +1134,76 @@ cOrgSensor::sSearchInfo cOrgSensor::TestCell(cAvidaContext& ctx, sLookInit& in_d
   return returnInfo;
 }
 
+/* Tests whether the look can pass over empty cells: cells holding none of the resources (or organisms) sought must
+ * never be counted.  Every resource must be spatial, since a global one is counted in every cell, and have a positive
+ * threshold, since otherwise an empty cell would be edible.
+ */
+bool cOrgSensor::CanPassOverEmptyCells(const sLookInit& in_defs, const Apto::Array<int, Apto::Smart>& val_res)
+{
+  if (in_defs.habitat == -2) return (m_use_avatar == 0 || m_use_avatar == 2);
+  if (in_defs.habitat == 3 || val_res.GetSize() == 0) return false;
+  
+  for (int k = 0; k < val_res.GetSize(); k++) {
+    cResource* res = m_res_lib.GetResource(val_res[k]);
+    if (res->GetGeometry() == nGeometry::GLOBAL || res->GetGeometry() == nGeometry::PARTIAL) return false;
+    if (res->GetThreshold() <= 0.0) return false;
+  }
+  return true;
+}
+
+/* Tests the run of side cells from near_cell out to far_cell (along one row or column, possibly across the edge of a
+ * torus) against the grid indexes.
+ *
+ * Returns:
+ *    true if no cell of the run holds anything sought; false if any might, so that its cells must be tested
+ */
+bool cOrgSensor::SideRunIsEmpty(sLookInit& in_defs, const Apto::Array<int, Apto::Smart>& val_res,
+                                const Apto::Coord<int>& near_cell, const Apto::Coord<int>& far_cell, sBounds& worldBounds)
+{
+  const bool along_x = (near_cell.Y() == far_cell.Y());
+  const int fixed = along_x ? near_cell.Y() : near_cell.X();
+  const int size = along_x ? (worldBounds.max_x + 1) : (worldBounds.max_y + 1);
+  const int lo = along_x ? min(near_cell.X(), far_cell.X()) : min(near_cell.Y(), far_cell.Y());
+  const int hi = along_x ? max(near_cell.X(), far_cell.X()) : max(near_cell.Y(), far_cell.Y());
+  
+  // split a run that wraps around the world into the spans on either side of the edge
+  int span_lo[2] = { lo, 0 };
+  int span_hi[2] = { hi, 0 };
+  int num_spans = 1;
+  if (hi - lo + 1 >= size) {
+    span_lo[0] = 0;
+    span_hi[0] = size - 1;
+  } else if (lo < 0) {
+    span_lo[0] = lo + size;
+    span_hi[0] = size - 1;
+    span_hi[1] = hi;
+    num_spans = 2;
+  } else if (hi >= size) {
+    span_hi[0] = size - 1;
+    span_hi[1] = hi - size;
+    num_spans = 2;
+  }
+  
+  cOrgInterface& iface = m_organism->GetOrgInterface();
+  for (int i = 0; i < num_spans; i++) {
+    const int x1 = along_x ? span_lo[i] : fixed;
+    const int x2 = along_x ? span_hi[i] : fixed;
+    const int y1 = along_x ? fixed : span_lo[i];
+    const int y2 = along_x ? fixed : span_hi[i];
+    
+    // counts of -1 (nothing indexed) are never taken as empty
+    if (in_defs.habitat == -2) {
+      const int orgs = (m_use_avatar == 2) ? iface.CountAVs(x1, y1, x2, y2) : iface.CountOccupiedCells(x1, y1, x2, y2);
+      if (orgs != 0) return false;
+    } else {
+      for (int k = 0; k < val_res.GetSize(); k++) {
+        if (iface.CountFrozenResCells(val_res[k], x1, y1, x2, y2) != 0) return false;
+      }
+    }
+  }
+  return true;
+}
+
 int cOrgSensor::GetMinDist(const int worldx, sBounds& bounds, const int cell_id, const int distance_sought, const int facing)
 {
   const int org_x = cell_id % worldx;
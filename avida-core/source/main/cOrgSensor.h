@@ -28,6 +28,8 @@
 #include "cResourceLib.h"
 #include "cWorld.h"
 
+class cChunkBuffer;
+
 struct sOrgDisplay 
 {
   int distance;
@@ -118,10 +120,16 @@ class cOrgSensor
   };
   
   void Reset() { ResetOrgSensor(); }
+  void SaveState(cChunkBuffer& buf) const;  // Snapshot state, the bounds cache is rebuilt by each look
+  bool LoadState(cChunkBuffer& buf);
+  void SetOrganism(cOrganism* in_organism) { m_organism = in_organism; }
   const sLookOut SetLooking(cAvidaContext& ctx, sLookInit& in_defs, int facing, int cell_id, bool use_ft);
   sSearchInfo TestCell(cAvidaContext& ctx, sLookInit& in_defs, const Apto::Coord<int>& target_cell_coords,
                       const Apto::Array<int, Apto::Smart>& val_res, bool first_step, bool stop_at_first_found);
   sLookOut PreWalk(cAvidaContext& ctx, sLookInit& in_defs, const int facing, const int cell_id);
+  bool CanPassOverEmptyCells(const sLookInit& in_defs, const Apto::Array<int, Apto::Smart>& val_res);
+  bool SideRunIsEmpty(sLookInit& in_defs, const Apto::Array<int, Apto::Smart>& val_res,
+                      const Apto::Coord<int>& near_cell, const Apto::Coord<int>& far_cell, sBounds& worldBounds);
   void SetWalkLimits(cAvidaContext& ctx, sLookInit& in_defs, sWalkLimits& limits, sBounds& worldBounds, sBounds& tot_bounds, Apto::Array<int, Apto::Smart>& val_res, int worldx, Apto::Coord<int>& this_cell, int facing, int cell, Apto::Coord<int>& center_cell, const Apto::Coord<int>& ahead_dir);
   void SetCoords(Apto::Coord<int>& left, Apto::Coord<int>& right, const int facing);
   
@@ -26,6 +26,7 @@
 #include "avida/core/WorldDriver.h"
 
 #include "cAvidaContext.h"
+#include "cChunkedFile.h"
 #include "cContextPhenotype.h"
 #include "cDeme.h"
 #include "cEnvironment.h"
@@ -245,10 +246,98 @@ void cOrganism::initialize(cAvidaContext& ctx)
 	}
 }
 
-cOrganism::~cOrganism()
-{  
+void cOrganism::recycle(cAvidaContext& ctx, const Genome& genome, int parent_generation, Systematics::Source src,
+                        const cPhenotype& blank)
+{
+  // Mirrors the constructor, reusing the storage held by the phenotype, buffers and IO scratch space
+  m_phenotype.Recycle(blank, parent_generation, m_world->GetHardwareManager().GetInstSet(genome.Properties().Get(s_ext_prop_name_instset).StringValue()).GetNumNops());
+  m_src = src;
+  const_cast<Genome&>(m_initial_genome) = genome;
+  m_mut_rates.Clear();
+  m_lineage_label = -1;
+  m_lineage = NULL;
+  m_org_list_index = -1;
+  m_display = false;
+  m_lyse_display = false;
+  m_offspring_genome = Genome();
+  
+  m_input_pointer = 0;
+  const cEnvironment& env = m_world->GetEnvironment();
+  if (m_input_buf.GetCapacity() == env.GetInputSize()) m_input_buf.Clear();
+  else m_input_buf = tBuffer<int>(env.GetInputSize());
+  if (m_output_buf.GetCapacity() == env.GetOutputSize()) m_output_buf.Clear();
+  else m_output_buf = tBuffer<int>(env.GetOutputSize());
+  m_received_messages.Clear();
+  
+  m_cur_sg = 0;
+  m_sent_value = 0;
+  m_sent_active = false;
+  m_test_receive_pos = 0;
+  m_pher_drop = false;
+  frac_energy_donating = m_world->GetConfig().ENERGY_SHARING_PCT.Get();
+  m_max_executed = -1;
+  m_is_running = false;
+  m_is_sleeping = false;
+  m_is_dead = false;
+  killed_event = false;
+  
+  m_self_raw_materials = m_world->GetConfig().RAW_MATERIAL_AMOUNT.Get();
+  m_other_raw_materials = 0;
+  donor_list.clear();
+  donating_lineages.clear();
+  m_num_donate = 0;
+  m_num_donate_received = 0;
+  m_amount_donate_received = 0;
+  m_num_reciprocate = 0;
+  m_failed_reputation_increases = 0;
+  m_tag = make_pair(-1, 0);
+  m_northerly = 0;
+  m_easterly = 0;
+  m_forage_target = -1;
+  m_show_ft = -1;
+  m_has_set_ft = false;
+  m_teach = false;
+  m_parent_teacher = false;
+  m_parent_ft = -1;
+  m_parent_group = m_world->GetConfig().DEFAULT_GROUP.Get();
+  m_p_merit = 0;
+  m_beggar = false;
+  m_para_donate = m_world->GetConfig().PARASITE_VIRULENCE.Get();
+  m_guard = false;
+  m_num_guard = 0;
+  m_num_deposits = 0;
+  m_amount_deposited = 0;
+  m_num_point_mut = 0;
+  m_av_in_index = -1;
+  m_av_out_index = -1;
+  
+  m_id = m_world->GetStats().GetTotCreatures();
+  m_hardware = m_world->GetHardwareManager().Create(ctx, this, genome);
+  
+  initialize(ctx);
+}
+
+void cOrganism::retire()
+{
   assert(m_is_running == false);
-  delete m_hardware;
+  releaseAttachments();
+  
+  m_hardware = NULL;
+  m_interface = NULL;
+  m_msg = NULL;
+  m_opinion = NULL;
+  m_neighborhood = NULL;
+  m_org_display = NULL;
+  m_queued_display_data = NULL;
+  m_string_map = NULL;
+  
+  m_parasites.Resize(0);
+  ResetClassification();
+}
+
+void cOrganism::releaseAttachments()
+{
+  m_world->GetHardwareManager().Release(m_hardware);
   delete m_interface;
   
   if(m_msg) delete m_msg;
@@ -259,6 +348,12 @@ cOrganism::~cOrganism()
   if (m_string_map) delete m_string_map;
 }
 
+cOrganism::~cOrganism()
+{  
+  assert(m_is_running == false);
+  releaseAttachments();
+}
+
 
 const PropertyMap& cOrganism::Properties() const { return m_prop_map; }
 
@@ -404,6 +499,12 @@ void cOrganism::DoOutput(cAvidaContext& ctx, tBuffer<int>& input_buffer, tBuffer
 }
 
 
+static inline void clearScratch(Apto::Array<double>& scratch, int size)
+{
+  if (scratch.GetSize() != size) scratch.Resize(size);
+  scratch.SetAll(0.0);
+}
+
 void cOrganism::doOutput(cAvidaContext& ctx, 
                          tBuffer<int>& input_buffer, 
                          tBuffer<int>& output_buffer,
@@ -416,8 +517,8 @@ void cOrganism::doOutput(cAvidaContext& ctx,
   const Apto::Array<double> & deme_resource_count = m_interface->GetDemeResources(deme_id, ctx);
   const Apto::Array< Apto::Array<int> > & cell_id_lists = m_interface->GetCellIdLists();
   
-  tList<tBuffer<int> > other_input_list;
-  tList<tBuffer<int> > other_output_list;
+  m_io_other_inputs.Resize(0);
+  m_io_other_outputs.Resize(0);
   
   // If tasks require us to consider neighbor inputs, collect them...
   if (m_world->GetEnvironment().UseNeighborInput()) {
@@ -427,7 +528,7 @@ void cOrganism::doOutput(cAvidaContext& ctx,
       cOrganism * cur_neighbor = m_interface->GetNeighbor();
       if (cur_neighbor == NULL) continue;
       
-      other_input_list.Push( &(cur_neighbor->m_input_buf) );
+      m_io_other_inputs.Push( &(cur_neighbor->m_input_buf) );
     }
   }
   
@@ -439,28 +540,29 @@ void cOrganism::doOutput(cAvidaContext& ctx,
       cOrganism * cur_neighbor = m_interface->GetNeighbor();
       if (cur_neighbor == NULL) continue;
       
-      other_output_list.Push( &(cur_neighbor->m_output_buf) );
+      m_io_other_outputs.Push( &(cur_neighbor->m_output_buf) );
     }
   }
   
   // Do the testing of tasks performed...
   
-  
-  Apto::Array<double> global_res_change(global_resource_count.GetSize());
-  global_res_change.SetAll(0.0);
-  Apto::Array<double> deme_res_change(deme_resource_count.GetSize());
-  deme_res_change.SetAll(0.0);
-  Apto::Array<cString> insts_triggered;
+  const int num_global = global_resource_count.GetSize();
+  const int num_deme = deme_resource_count.GetSize();
+  clearScratch(m_io_global_res_change, num_global);
+  clearScratch(m_io_deme_res_change, num_deme);
+  m_io_insts_triggered.Resize(0);
   
   tBuffer<int>* received_messages_point = &m_received_messages;
   if (!m_world->GetConfig().SAVE_RECEIVED.Get()) received_messages_point = NULL;
   
-  cTaskContext taskctx(this, input_buffer, output_buffer, other_input_list, other_output_list,
+  cTaskContext taskctx(this, input_buffer, output_buffer, m_io_other_inputs, m_io_other_outputs,
                        m_hardware->GetExtendedMemory(), on_divide, received_messages_point);
   
   //combine global and deme resource counts
-  Apto::Array<double> globalAndDeme_resource_count = global_resource_count + deme_resource_count;
-  Apto::Array<double> globalAndDeme_res_change = global_res_change + deme_res_change;
+  if (m_io_res_count.GetSize() != num_global + num_deme) m_io_res_count.Resize(num_global + num_deme);
+  for (int i = 0; i < num_global; i++) m_io_res_count[i] = global_resource_count[i];
+  for (int i = 0; i < num_deme; i++) m_io_res_count[i + num_global] = deme_resource_count[i];
+  clearScratch(m_io_res_change, num_global + num_deme);
   
   // set any resource amount to 0 if a cell cannot access this resource
   int cell_id=GetCellID();
@@ -477,14 +579,14 @@ void cOrganism::doOutput(cAvidaContext& ctx,
             break;
         }
         if (j==cell_id_lists[i].GetSize())
-          globalAndDeme_resource_count[i]=0;
+          m_io_res_count[i]=0;
       }
     }
   }
   
-  bool task_completed = m_phenotype.TestOutput(ctx, taskctx, globalAndDeme_resource_count, 
-                                               m_phenotype.GetCurRBinsAvail(), globalAndDeme_res_change, 
-                                               insts_triggered, is_parasite, context_phenotype);
+  bool task_completed = m_phenotype.TestOutput(ctx, taskctx, m_io_res_count, 
+                                               m_phenotype.GetCurRBinsAvail(), m_io_res_change, 
+                                               m_io_insts_triggered, is_parasite, context_phenotype);
   
   // Handle merit increases that take the organism above it's current population merit
   if (m_world->GetConfig().MERIT_INC_APPLY_IMMEDIATE.Get()) {
@@ -493,8 +595,8 @@ void cOrganism::doOutput(cAvidaContext& ctx,
   }
   
   //disassemble global and deme resource counts 
-  for (int i = 0; i < global_res_change.GetSize(); i++) global_res_change[i] = globalAndDeme_res_change[i];
-  for (int i = 0; i < deme_res_change.GetSize(); i++) deme_res_change[i] = globalAndDeme_res_change[i + global_res_change.GetSize()];
+  for (int i = 0; i < num_global; i++) m_io_global_res_change[i] = m_io_res_change[i];
+  for (int i = 0; i < num_deme; i++) m_io_deme_res_change[i] = m_io_res_change[i + num_global];
   
   if(m_world->GetConfig().ENERGY_ENABLED.Get() && m_world->GetConfig().APPLY_ENERGY_METHOD.Get() == 1 && task_completed) {
     m_phenotype.RefreshEnergy();
@@ -507,17 +609,16 @@ void cOrganism::doOutput(cAvidaContext& ctx,
   }
   if (m_phenotype.GetMakeRandomResource()){
     //call the random resource update function
-    m_interface->UpdateRandomResources(ctx, global_res_change);
+    m_interface->UpdateRandomResources(ctx, m_io_global_res_change);
     
   }else{
-    m_interface->UpdateResources(ctx, global_res_change);
+    m_interface->UpdateResources(ctx, m_io_global_res_change);
   }
 
   //update deme resources
-  m_interface->UpdateDemeResources(ctx, deme_res_change);
+  m_interface->UpdateDemeResources(ctx, m_io_deme_res_change);
 
-  for (int i = 0; i < insts_triggered.GetSize(); i++) 
-    m_hardware->ProcessBonusInst(ctx, m_hardware->GetInstSet().GetInst(insts_triggered[i]));
+  processTriggeredInsts(ctx);
 }
 
 void cOrganism::doAVOutput(cAvidaContext& ctx, 
@@ -532,8 +633,8 @@ void cOrganism::doAVOutput(cAvidaContext& ctx,
   //  const tArray<double> & deme_resource_count = m_interface->GetDemeResources(deme_id, ctx); //todo: DemeAVResources
   const Apto::Array< Apto::Array<int> > & cell_id_lists = m_interface->GetCellIdLists();
   
-  tList<tBuffer<int> > other_input_list;
-  tList<tBuffer<int> > other_output_list;
+  m_io_other_inputs.Resize(0);
+  m_io_other_outputs.Resize(0);
   
   // If tasks require us to consider neighbor inputs, collect them...
   if (m_world->GetEnvironment().UseNeighborInput()) {
@@ -543,7 +644,7 @@ void cOrganism::doAVOutput(cAvidaContext& ctx,
       const Apto::Array<cOrganism*>& cur_neighbors = m_interface->GetFacedAVs();
       for (int i = 0; i < cur_neighbors.GetSize(); i++) {
         if (cur_neighbors[i] == NULL) continue;
-        other_input_list.Push( &(cur_neighbors[i]->m_input_buf) );
+        m_io_other_inputs.Push( &(cur_neighbors[i]->m_input_buf) );
       }
     }
   }
@@ -556,30 +657,31 @@ void cOrganism::doAVOutput(cAvidaContext& ctx,
       const Apto::Array<cOrganism*>& cur_neighbors = m_interface->GetFacedAVs();
       for (int i = 0; i < cur_neighbors.GetSize(); i++) {
         if (cur_neighbors[i] == NULL) continue;
-        other_output_list.Push( &(cur_neighbors[i]->m_output_buf) );
+        m_io_other_outputs.Push( &(cur_neighbors[i]->m_output_buf) );
       }
     }
   }
   
   // Do the testing of tasks performed...
-  Apto::Array<double> avatar_res_change(m_world->GetEnvironment().GetResourceLib().GetSize());
-  avatar_res_change.SetAll(0.0);
+  const int num_resources = m_world->GetEnvironment().GetResourceLib().GetSize();
+  clearScratch(m_io_global_res_change, num_resources);
 
   //  tArray<double> deme_res_change(deme_resource_count.GetSize());
   //  deme_res_change.SetAll(0.0);
 
-  Apto::Array<cString> insts_triggered;
+  m_io_insts_triggered.Resize(0);
   
   tBuffer<int>* received_messages_point = &m_received_messages;
   if (!m_world->GetConfig().SAVE_RECEIVED.Get()) received_messages_point = NULL;
   
-  cTaskContext taskctx(this, input_buffer, output_buffer, other_input_list, other_output_list,
+  cTaskContext taskctx(this, input_buffer, output_buffer, m_io_other_inputs, m_io_other_outputs,
                        m_hardware->GetExtendedMemory(), on_divide, received_messages_point);
   
   //combine global and deme resource counts
   const Apto::Array<double>& av_res_count = m_interface->GetAVResources(ctx);
-  Apto::Array<double> avatarAndDeme_res_count = av_res_count; // + deme_resource_count;
-  Apto::Array<double> avatarAndDeme_res_change = avatar_res_change; // + deme_res_change;
+  if (m_io_res_count.GetSize() != av_res_count.GetSize()) m_io_res_count.Resize(av_res_count.GetSize());
+  for (int i = 0; i < av_res_count.GetSize(); i++) m_io_res_count[i] = av_res_count[i]; // + deme_resource_count;
+  clearScratch(m_io_res_change, num_resources); // + deme_res_change;
   
   // set any resource amount to 0 if a cell cannot access this resource
   int cell_id = m_interface->GetAVCellID();
@@ -596,14 +698,14 @@ void cOrganism::doAVOutput(cAvidaContext& ctx,
 					  break;
 			  }
 			  if (j == cell_id_lists[i].GetSize())
-				  avatarAndDeme_res_count[i] = 0;
+				  m_io_res_count[i] = 0;
 		  }
 	  }
   }
   
-  bool task_completed = m_phenotype.TestOutput(ctx, taskctx, avatarAndDeme_res_count, 
-                                               m_phenotype.GetCurRBinsAvail(), avatarAndDeme_res_change, 
-                                               insts_triggered, is_parasite, context_phenotype);
+  bool task_completed = m_phenotype.TestOutput(ctx, taskctx, m_io_res_count, 
+                                               m_phenotype.GetCurRBinsAvail(), m_io_res_change, 
+                                               m_io_insts_triggered, is_parasite, context_phenotype);
   
   // Handle merit increases that take the organism above it's current population merit
   if (m_world->GetConfig().MERIT_INC_APPLY_IMMEDIATE.Get()) {
@@ -612,7 +714,7 @@ void cOrganism::doAVOutput(cAvidaContext& ctx,
   }
   
   //disassemble avatar and deme resource counts
-  for (int i = 0; i < avatar_res_change.GetSize(); i++) avatar_res_change[i] = avatarAndDeme_res_change[i];
+  for (int i = 0; i < num_resources; i++) m_io_global_res_change[i] = m_io_res_change[i];
 //  deme_res_change = avatarAndDeme_res_change.Subset(avatar_res_change.GetSize(), avatarAndDeme_res_change.GetSize());
   
   if(m_world->GetConfig().ENERGY_ENABLED.Get() && m_world->GetConfig().APPLY_ENERGY_METHOD.Get() == 1 && task_completed) {
@@ -624,10 +726,19 @@ void cOrganism::doAVOutput(cAvidaContext& ctx,
 			GetPhenotype().SetToDie();
 		}
   }
-  m_interface->UpdateAVResources(ctx, avatar_res_change);
+  m_interface->UpdateAVResources(ctx, m_io_global_res_change);
   //update deme resources
 //  m_interface->UpdateDemeResources(ctx, deme_res_change);
   
+  processTriggeredInsts(ctx);
+}
+
+void cOrganism::processTriggeredInsts(cAvidaContext& ctx)
+{
+  if (!m_io_insts_triggered.GetSize()) return;
+  
+  // Bonus instructions may perform IO themselves, which reuses the scratch list, so run them from a copy
+  Apto::Array<cString> insts_triggered(m_io_insts_triggered);
   for (int i = 0; i < insts_triggered.GetSize(); i++) 
     m_hardware->ProcessBonusInst(ctx, m_hardware->GetInstSet().GetInst(insts_triggered[i]));
 }
@@ -957,6 +1068,139 @@ void cOrganism::Fault(int fault_loc, int fault_type, cString fault_desc)
   m_phenotype.IncErrors();
 }
 
+static void saveIntSet(cChunkBuffer& buf, const set<int>& values)
+{
+  buf.PutVarUInt(values.size());
+  for (set<int>::const_iterator it = values.begin(); it != values.end(); it++) buf.PutVarInt(*it);
+}
+
+static bool loadIntSet(cChunkBuffer& buf, set<int>& values)
+{
+  const int size = (int)buf.GetVarUInt();
+  if (buf.Fail() || size > buf.GetRemaining()) return false;
+  values.clear();
+  for (int i = 0; i < size; i++) values.insert((int)buf.GetVarInt());
+  return !buf.Fail();
+}
+
+void cOrganism::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarInt(m_id);
+  buf.PutVarInt(m_lineage_label);
+  buf.PutBool(m_display);
+  buf.PutBool(m_lyse_display);
+
+  buf.PutVarInt(m_input_pointer);
+  m_input_buf.SaveState(buf);
+  m_output_buf.SaveState(buf);
+  m_received_messages.SaveState(buf);
+  buf.PutVarInt(m_cur_sg);
+  buf.PutVarInt(m_sent_value);
+  buf.PutBool(m_sent_active);
+  buf.PutDouble(m_gradient_movement);
+  buf.PutBool(m_pher_drop);
+  buf.PutDouble(frac_energy_donating);
+  buf.PutVarInt(m_max_executed);
+  buf.PutBool(m_is_sleeping);
+  buf.PutBool(killed_event);
+
+  // Reputation and forage state
+  buf.PutVarInt(m_self_raw_materials);
+  buf.PutVarInt(m_other_raw_materials);
+  saveIntSet(buf, donor_list);
+  saveIntSet(buf, donating_lineages);
+  buf.PutVarInt(m_num_donate);
+  buf.PutVarInt(m_num_donate_received);
+  buf.PutVarInt(m_amount_donate_received);
+  buf.PutVarInt(m_num_reciprocate);
+  buf.PutVarInt(m_k);
+  buf.PutVarInt(m_failed_reputation_increases);
+  buf.PutVarInt(m_tag.first);
+  buf.PutVarInt(m_tag.second);
+  buf.PutVarInt(m_northerly);
+  buf.PutVarInt(m_easterly);
+  buf.PutVarInt(m_forage_target);
+  buf.PutVarInt(m_show_ft);
+  buf.PutBool(m_has_set_ft);
+  buf.PutBool(m_teach);
+  buf.PutBool(m_parent_teacher);
+  buf.PutVarInt(m_parent_ft);
+  buf.PutVarInt(m_parent_group);
+  buf.PutDouble(m_p_merit);
+  buf.PutBool(m_p_mthread);
+  buf.PutBool(m_beggar);
+  buf.PutDouble(m_para_donate);
+  buf.PutBool(m_guard);
+  buf.PutVarInt(m_num_guard);
+  buf.PutVarInt(m_num_deposits);
+  buf.PutDouble(m_amount_deposited);
+  buf.PutVarInt(m_num_point_mut);
+  buf.PutBool(m_repair);
+  buf.PutVarInt(m_av_in_index);
+  buf.PutVarInt(m_av_out_index);
+  m_mut_rates.SaveState(buf);
+
+  m_phenotype.SaveState(buf);
+  m_hardware->SaveState(buf);
+}
+
+bool cOrganism::LoadState(cChunkBuffer& buf)
+{
+  m_id = (int)buf.GetVarInt();
+  m_lineage_label = (int)buf.GetVarInt();
+  m_display = buf.GetBool();
+  m_lyse_display = buf.GetBool();
+
+  m_input_pointer = (int)buf.GetVarInt();
+  if (!m_input_buf.LoadState(buf) || !m_output_buf.LoadState(buf) || !m_received_messages.LoadState(buf)) return false;
+  m_cur_sg = (int)buf.GetVarInt();
+  m_sent_value = (int)buf.GetVarInt();
+  m_sent_active = buf.GetBool();
+  m_gradient_movement = buf.GetDouble();
+  m_pher_drop = buf.GetBool();
+  frac_energy_donating = buf.GetDouble();
+  m_max_executed = (int)buf.GetVarInt();
+  m_is_sleeping = buf.GetBool();
+  killed_event = buf.GetBool();
+
+  // Reputation and forage state
+  m_self_raw_materials = (int)buf.GetVarInt();
+  m_other_raw_materials = (int)buf.GetVarInt();
+  if (!loadIntSet(buf, donor_list) || !loadIntSet(buf, donating_lineages)) return false;
+  m_num_donate = (int)buf.GetVarInt();
+  m_num_donate_received = (int)buf.GetVarInt();
+  m_amount_donate_received = (int)buf.GetVarInt();
+  m_num_reciprocate = (int)buf.GetVarInt();
+  m_k = (int)buf.GetVarInt();
+  m_failed_reputation_increases = (int)buf.GetVarInt();
+  m_tag.first = (int)buf.GetVarInt();
+  m_tag.second = (int)buf.GetVarInt();
+  m_northerly = (int)buf.GetVarInt();
+  m_easterly = (int)buf.GetVarInt();
+  m_forage_target = (int)buf.GetVarInt();
+  m_show_ft = (int)buf.GetVarInt();
+  m_has_set_ft = buf.GetBool();
+  m_teach = buf.GetBool();
+  m_parent_teacher = buf.GetBool();
+  m_parent_ft = (int)buf.GetVarInt();
+  m_parent_group = (int)buf.GetVarInt();
+  m_p_merit = buf.GetDouble();
+  m_p_mthread = buf.GetBool();
+  m_beggar = buf.GetBool();
+  m_para_donate = buf.GetDouble();
+  m_guard = buf.GetBool();
+  m_num_guard = (int)buf.GetVarInt();
+  m_num_deposits = (int)buf.GetVarInt();
+  m_amount_deposited = buf.GetDouble();
+  m_num_point_mut = (int)buf.GetVarInt();
+  m_repair = buf.GetBool();
+  m_av_in_index = (int)buf.GetVarInt();
+  m_av_out_index = (int)buf.GetVarInt();
+  if (!m_mut_rates.LoadState(buf)) return false;
+
+  return m_phenotype.LoadState(buf) && m_hardware->LoadState(buf);
+}
+
 void cOrganism::NewTrial()
 {
   //More should be reset here... @JEB
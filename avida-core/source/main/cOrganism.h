@@ -46,6 +46,7 @@
 
 class cAvidaContext;
 class cBioGroup;
+class cChunkBuffer;
 class cContextPhenotype;
 class cEnvironment;
 class cHardwareBase;
@@ -91,6 +92,15 @@ private:
   tBuffer<int> m_output_buf;
   tBuffer<int> m_received_messages;
 
+  // Scratch space for doOutput/doAVOutput, sized on first use and kept so that IO does not allocate afterwards
+  Apto::Array<const tBuffer<int>*, Apto::Smart> m_io_other_inputs;
+  Apto::Array<const tBuffer<int>*, Apto::Smart> m_io_other_outputs;
+  Apto::Array<double> m_io_res_count;
+  Apto::Array<double> m_io_res_change;
+  Apto::Array<double> m_io_global_res_change;
+  Apto::Array<double> m_io_deme_res_change;
+  Apto::Array<cString> m_io_insts_triggered;
+
   int m_cur_sg;
 
   // Communication
@@ -142,6 +152,10 @@ public:
   void PrintFinalStatus(std::ostream& fp, int time_used, int time_allocated) const;
   void Fault(int fault_loc, int fault_type, cString fault_desc="");
 
+  // Snapshot state, including the hardware and phenotype.  Messaging, opinions and string tracking are not included.
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
+
   void NewTrial();
 
   // --------  Accessor Methods  --------
@@ -248,6 +262,8 @@ public:
   int GetInputAt(int i) { return m_interface->GetInputAt(i); }
   int GetNextInput() { return m_interface->GetInputAt(m_input_pointer); }
   int GetNextInput(int& in_input_pointer) { return m_interface->GetInputAt(in_input_pointer); }
+  int GetInputPointer() const { return m_input_pointer; }
+  void SetInputPointer(int input_pointer) { m_input_pointer = input_pointer; }
   tBuffer<int>& GetInputBuf() { return m_input_buf; }
   tBuffer<int>& GetOutputBuf() { return m_output_buf; }
   void Die(cAvidaContext& ctx) { m_interface->Die(ctx); m_is_dead = true; } 
@@ -398,6 +414,8 @@ public:
   const message_list_type& GetSentMessages() { InitMessaging(); return m_msg->sent; }
   //! Use at your own rish; clear all the message buffers.
   void FlushMessageBuffers() { InitMessaging(); m_msg->sent.clear(); m_msg->received.clear(); }
+  //! Returns whether this organism has set up (or been asked about) messaging.
+  bool HasMessagingState() const { return m_msg != NULL; }
   int PeekAtNextMessageType() { InitMessaging(); return m_msg->received.front().GetMessageType(); }
 
 private:
@@ -474,6 +492,8 @@ public:
   const DatedOpinionList& GetOpinions() { InitOpinions(); return m_opinion->opinion_list; }
   //! Return whether this organism has an opinion.
   bool HasOpinion();
+  //! Returns whether this organism has set up (or been asked about) opinions, which also carry group membership.
+  bool HasOpinionState() const { return m_opinion != NULL; }
   //! remove all opinions
   void ClearOpinion() { InitOpinions(); m_opinion->opinion_list.clear(); }
 
@@ -743,7 +763,15 @@ private:
   
   void initialize(cAvidaContext& ctx);
   
+  // Organisms are pooled by the hardware manager: retire() releases everything a dead organism holds, recycle() resets
+  // a retired organism as if it had been constructed with the given arguments
+  void recycle(cAvidaContext& ctx, const Genome& genome, int parent_generation, Systematics::Source src,
+               const cPhenotype& blank);
+  void retire();
+  void releaseAttachments();
+  
   
+  friend class cHardwareManager;
   friend class OrgPropRetrievalContainer;
   template <class T> friend class OrgPropOfType;
   
@@ -833,6 +861,7 @@ private:
   void doOutput(cAvidaContext& ctx, tBuffer<int>& input_buffer, tBuffer<int>& output_buffer, const bool on_divide, bool is_parasite=false, cContextPhenotype* context_phenotype = 0);
   // Need seperate doOutput function for avatars to avoid triggering reactions by true orgs
   void doAVOutput(cAvidaContext& ctx, tBuffer<int>& input_buffer, tBuffer<int>& output_buffer, const bool on_divide, bool is_parasite=false, cContextPhenotype* context_phenotype = 0);
+  void processTriggeredInsts(cAvidaContext& ctx);
 };
 
 
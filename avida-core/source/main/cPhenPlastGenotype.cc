@@ -21,19 +21,21 @@
 
 #include "cPhenPlastGenotype.h"
 #include "cPhenPlastSummary.h"
+#include "cTestCPU.h"
 #include <iostream>
 #include <cmath>
 #include <cfloat>
 
 const Apto::String cPhenPlastSummary::ObjectKey("cPhenPlastSummary");
 
-cPhenPlastGenotype::cPhenPlastGenotype(const Genome& in_genome, int num_trials, cCPUTestInfo& test_info,  cWorld* world, cAvidaContext& ctx)
+cPhenPlastGenotype::cPhenPlastGenotype(const Genome& in_genome, int num_trials, cCPUTestInfo& test_info,  cWorld* world, cAvidaContext& ctx,
+                                       cTestCPU* test_cpu)
 : m_genome(in_genome), m_num_trials(num_trials), m_world(world)
 {
   // Override input mode if more than one recalculation requested
   if (num_trials > 1)  
     test_info.UseRandomInputs(true);
-  Process(test_info, world, ctx);
+  Process(test_info, world, ctx, test_cpu);
 }
 
 cPhenPlastGenotype::~cPhenPlastGenotype()
@@ -45,14 +47,23 @@ cPhenPlastGenotype::~cPhenPlastGenotype()
   }
 }
 
-void cPhenPlastGenotype::Process(cCPUTestInfo& test_info, cWorld* world, cAvidaContext& ctx)
+void cPhenPlastGenotype::Process(cCPUTestInfo& test_info, cWorld* world, cAvidaContext& ctx, cTestCPU* test_cpu)
 {
-  cTestCPU* test_cpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* local_test_cpu = NULL;
+  if (!test_cpu) {
+    local_test_cpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+    test_cpu = local_test_cpu;
+  }
 
   if (m_num_trials > 1) test_info.UseRandomInputs(true);
   
+  // Trials only differ in their inputs, so the first is recorded and the others resume from its last saved state
+  // before any input was read
+  cTestCPUCheckpoints checkpoints;
   for (int k = 0; k < m_num_trials; k++){
-    test_cpu->TestGenome(ctx, test_info, m_genome);
+    if (m_num_trials == 1) test_cpu->TestGenome(ctx, test_info, m_genome);
+    else if (k == 0) test_cpu->RecordCheckpoints(ctx, test_info, m_genome, checkpoints);
+    else test_cpu->TestGenome(ctx, test_info, m_genome, checkpoints);
     //Is this a new phenotype?
     UniquePhenotypes::iterator uit = m_unique.find(&test_info.GetTestPhenotype());
     if (uit == m_unique.end()){  // Yes, make a new entry for it
@@ -106,7 +117,7 @@ void cPhenPlastGenotype::Process(cCPUTestInfo& test_info, cWorld* world, cAvidaC
     ++uit;
   }
   
-  if (test_cpu) delete test_cpu;
+  delete local_test_cpu;
 }
 
 
@@ -69,10 +69,12 @@ private:
     
     
   
-  void Process(cCPUTestInfo& test_info, cWorld* world, cAvidaContext& ctx);
+  void Process(cCPUTestInfo& test_info, cWorld* world, cAvidaContext& ctx, cTestCPU* test_cpu);
   
 public:
-  cPhenPlastGenotype(const Genome& in_genome, int num_trails, cCPUTestInfo& test_info,  cWorld* world, cAvidaContext& ctx);
+  // If test_cpu is NULL a temporary test CPU is created for the trials
+  cPhenPlastGenotype(const Genome& in_genome, int num_trails, cCPUTestInfo& test_info,  cWorld* world, cAvidaContext& ctx,
+                     cTestCPU* test_cpu = NULL);
   ~cPhenPlastGenotype();
     
   // Accessors
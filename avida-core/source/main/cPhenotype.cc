@@ -22,6 +22,7 @@
 
 #include "cPhenotype.h"
 #include "avida/systematics/Types.h"
+#include "cChunkedFile.h"
 #include "cContextPhenotype.h"
 #include "cEnvironment.h"
 #include "cDeme.h"
@@ -94,6 +95,18 @@ cPhenotype::cPhenotype(cWorld* world, int parent_generation, int num_nops)
 , last_task_time(0)
 
 { 
+  initialize(parent_generation, num_nops);
+}
+
+void cPhenotype::Recycle(const cPhenotype& blank, int parent_generation, int num_nops)
+{
+  // Assignment keeps the existing array storage wherever the sizes match
+  *this = blank;
+  initialize(parent_generation, num_nops);
+}
+
+void cPhenotype::initialize(int parent_generation, int num_nops)
+{
   if (parent_generation >= 0) {
     generation = parent_generation;
     if (m_world->GetConfig().GENERATION_INC_METHOD.Get() != GENERATION_INC_BOTH) generation++;
@@ -102,7 +115,8 @@ cPhenotype::cPhenotype(cWorld* world, int parent_generation, int num_nops)
   double num_resources = m_world->GetEnvironment().GetResourceLib().GetSize();
   if (num_resources <= 0 || num_nops <= 0) return;
   double most_nops_needed = ceil(log(num_resources) / log((double)num_nops));
-  cur_collect_spec_counts.Resize(int((pow((double)num_nops, most_nops_needed + 1.0) - 1.0) / ((double)num_nops - 1.0)));
+  const int num_specs = int((pow((double)num_nops, most_nops_needed + 1.0) - 1.0) / ((double)num_nops - 1.0));
+  if (cur_collect_spec_counts.GetSize() != num_specs) cur_collect_spec_counts.Resize(num_specs);
 }
 
 cPhenotype::~cPhenotype()
@@ -189,9 +203,13 @@ cPhenotype& cPhenotype::operator=(const cPhenotype& in_phen)
   cur_from_message_count    = in_phen.cur_from_message_count;
 
   // Dynamically allocated m_task_states requires special handling
-  for (Apto::Map<void*, cTaskState*>::ConstIterator it = in_phen.m_task_states.Begin(); it.Next();) {
-    cTaskState* new_ts = new cTaskState(**((*it.Get()).Value2()));
-    m_task_states.Set((*it.Get()).Value1(), new_ts);
+  if (&in_phen != this) {
+    for (Apto::Map<void*, cTaskState*>::ValueIterator it = m_task_states.Values(); it.Next();) delete (*it.Get());
+    m_task_states.Clear();
+    for (Apto::Map<void*, cTaskState*>::ConstIterator it = in_phen.m_task_states.Begin(); it.Next();) {
+      cTaskState* new_ts = new cTaskState(**((*it.Get()).Value2()));
+      m_task_states.Set((*it.Get()).Value1(), new_ts);
+    }
   }
   
   // 3. These mark the status of "in progess" variables at the last divide.
@@ -1726,6 +1744,494 @@ void cPhenotype::Sterilize()
 }
 
 
+static void saveNestedArray(cChunkBuffer& buf, const Apto::Array< Apto::Array<int> >& values)
+{
+  buf.PutVarUInt(values.GetSize());
+  for (int i = 0; i < values.GetSize(); i++) buf.PutIntArray(values[i]);
+}
+
+static bool loadNestedArray(cChunkBuffer& buf, Apto::Array< Apto::Array<int> >& values)
+{
+  const int size = (int)buf.GetVarUInt();
+  if (buf.Fail() || size > buf.GetRemaining()) return false;
+  values.Resize(size);
+  for (int i = 0; i < size; i++) if (!buf.GetIntArray(values[i])) return false;
+  return true;
+}
+
+static void saveUpdateList(cChunkBuffer& buf, const tList<int>& updates)
+{
+  buf.PutVarUInt(updates.GetSize());
+  for (int i = 0; i < updates.GetSize(); i++) buf.PutVarInt(*updates.GetPos(i));
+}
+
+static bool loadUpdateList(cChunkBuffer& buf, tList<int>& updates)
+{
+  const int size = (int)buf.GetVarUInt();
+  if (buf.Fail() || size > buf.GetRemaining()) return false;
+  updates.Clear();
+  for (int i = 0; i < size; i++) updates.PushRear(new int((int)buf.GetVarInt()));
+  return !buf.Fail();
+}
+
+static void saveIntPairs(cChunkBuffer& buf, const Apto::Array<pair<int,int> >& values)
+{
+  buf.PutVarUInt(values.GetSize());
+  for (int i = 0; i < values.GetSize(); i++) {
+    buf.PutVarInt(values[i].first);
+    buf.PutVarInt(values[i].second);
+  }
+}
+
+static bool loadIntPairs(cChunkBuffer& buf, Apto::Array<pair<int,int> >& values)
+{
+  const int size = (int)buf.GetVarUInt();
+  if (buf.Fail() || size > buf.GetRemaining()) return false;
+  values.Resize(size);
+  for (int i = 0; i < size; i++) {
+    values[i].first = (int)buf.GetVarInt();
+    values[i].second = (int)buf.GetVarInt();
+  }
+  return !buf.Fail();
+}
+
+void cPhenotype::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutBool(initialized);
+
+  // 1. These are values calculated at the last divide (of self or offspring)
+  buf.PutDouble(merit.GetDouble());
+  buf.PutDouble(executionRatio);
+  buf.PutDouble(energy_store);
+  buf.PutVarInt(genome_length);
+  buf.PutVarInt(bonus_instruction_count);
+  buf.PutVarInt(copied_size);
+  buf.PutVarInt(executed_size);
+  buf.PutVarInt(gestation_time);
+  buf.PutVarInt(gestation_start);
+  buf.PutDouble(fitness);
+  buf.PutDouble(div_type);
+
+  // 2. These are "in progress" variables, updated as the organism operates
+  buf.PutDouble(cur_bonus);
+  buf.PutDouble(cur_energy_bonus);
+  buf.PutDouble(energy_tobe_applied);
+  buf.PutDouble(energy_testament);
+  buf.PutDouble(energy_received_buffer);
+  buf.PutDouble(total_energy_donated);
+  buf.PutDouble(total_energy_received);
+  buf.PutDouble(total_energy_applied);
+  buf.PutVarInt(num_energy_requests);
+  buf.PutVarInt(num_energy_donations);
+  buf.PutVarInt(num_energy_receptions);
+  buf.PutVarInt(num_energy_applications);
+  buf.PutVarInt(cur_num_errors);
+  buf.PutVarInt(cur_num_donates);
+  buf.PutIntArray(cur_task_count);
+  buf.PutIntArray(cur_para_tasks);
+  buf.PutIntArray(cur_host_tasks);
+  buf.PutIntArray(cur_internal_task_count);
+  buf.PutIntArray(eff_task_count);
+  buf.PutDoubleArray(cur_task_quality);
+  buf.PutDoubleArray(cur_task_value);
+  buf.PutDoubleArray(cur_internal_task_quality);
+  buf.PutDoubleArray(cur_rbins_total);
+  buf.PutDoubleArray(cur_rbins_avail);
+  buf.PutIntArray(cur_collect_spec_counts);
+  buf.PutIntArray(cur_reaction_count);
+  buf.PutIntArray(first_reaction_cycles);
+  buf.PutIntArray(first_reaction_execs);
+  buf.PutIntArray(cur_stolen_reaction_count);
+  buf.PutDoubleArray(cur_reaction_add_reward);
+  buf.PutIntArray(cur_inst_count);
+  buf.PutIntArray(cur_from_sensor_count);
+  saveNestedArray(buf, cur_group_attack_count);
+  saveNestedArray(buf, cur_top_pred_group_attack_count);
+  buf.PutIntArray(cur_killed_targets);
+  buf.PutVarInt(cur_attacks);
+  buf.PutVarInt(cur_kills);
+  buf.PutIntArray(cur_sense_count);
+  buf.PutDoubleArray(sensed_resources);
+  buf.PutDoubleArray(cur_task_time);
+  buf.PutBool(m_task_states.GetSize() > 0);
+  buf.PutDoubleArray(cur_trial_fitnesses);
+  buf.PutDoubleArray(cur_trial_bonuses);
+  buf.PutIntArray(cur_trial_times_used);
+  buf.PutIntArray(cur_from_message_count);
+  buf.PutVarInt(trial_time_used);
+  buf.PutVarInt(trial_cpu_cycles_used);
+  saveUpdateList(buf, m_tolerance_immigrants);
+  saveUpdateList(buf, m_tolerance_offspring_own);
+  saveUpdateList(buf, m_tolerance_offspring_others);
+  saveIntPairs(buf, m_intolerances);
+  buf.PutDouble(last_child_germline_propensity);
+  buf.PutVarInt(mating_type);
+  buf.PutVarInt(mate_preference);
+  buf.PutVarInt(cur_mating_display_a);
+  buf.PutVarInt(cur_mating_display_b);
+
+  // 3. These mark the status of "in progress" variables at the last divide.
+  buf.PutDouble(last_merit_base);
+  buf.PutDouble(last_bonus);
+  buf.PutDouble(last_energy_bonus);
+  buf.PutVarInt(last_num_errors);
+  buf.PutVarInt(last_num_donates);
+  buf.PutIntArray(last_task_count);
+  buf.PutIntArray(last_para_tasks);
+  buf.PutIntArray(last_host_tasks);
+  buf.PutIntArray(last_internal_task_count);
+  buf.PutDoubleArray(last_task_quality);
+  buf.PutDoubleArray(last_task_value);
+  buf.PutDoubleArray(last_internal_task_quality);
+  buf.PutDoubleArray(last_rbins_total);
+  buf.PutDoubleArray(last_rbins_avail);
+  buf.PutIntArray(last_collect_spec_counts);
+  buf.PutIntArray(last_reaction_count);
+  buf.PutDoubleArray(last_reaction_add_reward);
+  buf.PutIntArray(last_inst_count);
+  buf.PutIntArray(last_from_sensor_count);
+  buf.PutIntArray(last_sense_count);
+  saveNestedArray(buf, last_group_attack_count);
+  saveNestedArray(buf, last_top_pred_group_attack_count);
+  buf.PutIntArray(last_killed_targets);
+  buf.PutVarInt(last_attacks);
+  buf.PutVarInt(last_kills);
+  buf.PutIntArray(last_from_message_count);
+  buf.PutDouble(last_fitness);
+  buf.PutVarInt(last_cpu_cycles_used);
+  buf.PutDouble(cur_child_germline_propensity);
+  buf.PutVarInt(last_mating_display_a);
+  buf.PutVarInt(last_mating_display_b);
+
+  // 4. Records from this organism's life...
+  buf.PutVarInt(num_divides_failed);
+  buf.PutVarInt(num_divides);
+  buf.PutVarInt(generation);
+  buf.PutVarInt(cpu_cycles_used);
+  buf.PutVarInt(time_used);
+  buf.PutVarInt(num_execs);
+  buf.PutVarInt(age);
+  buf.PutString(fault_desc);
+  buf.PutDouble(neutral_metric);
+  buf.PutDouble(life_fitness);
+  buf.PutVarInt(exec_time_born);
+  buf.PutDouble(gmu_exec_time_born);
+  buf.PutVarInt(birth_update);
+  buf.PutVarInt(birth_cell_id);
+  buf.PutVarInt(av_birth_cell_id);
+  buf.PutVarInt(birth_group_id);
+  buf.PutVarInt(birth_forager_type);
+  buf.PutIntArray(testCPU_inst_count);
+  buf.PutVarInt(last_task_id);
+  buf.PutVarInt(num_new_unique_reactions);
+  buf.PutDouble(res_consumed);
+  buf.PutBool(is_germ_cell);
+  buf.PutVarInt(last_task_time);
+
+  // 5. Status Flags...  (updated at each divide)
+  buf.PutBool(to_die);
+  buf.PutBool(to_delete);
+  buf.PutBool(make_random_resource);
+  buf.PutBool(is_injected);
+  buf.PutBool(is_clone);
+  buf.PutBool(is_donor_cur);
+  buf.PutBool(is_donor_last);
+  buf.PutBool(is_donor_rand);
+  buf.PutBool(is_donor_rand_last);
+  buf.PutBool(is_donor_null);
+  buf.PutBool(is_donor_null_last);
+  buf.PutBool(is_donor_kin);
+  buf.PutBool(is_donor_kin_last);
+  buf.PutBool(is_donor_edit);
+  buf.PutBool(is_donor_edit_last);
+  buf.PutBool(is_donor_gbg);
+  buf.PutBool(is_donor_gbg_last);
+  buf.PutBool(is_donor_truegb);
+  buf.PutBool(is_donor_truegb_last);
+  buf.PutBool(is_donor_threshgb);
+  buf.PutBool(is_donor_threshgb_last);
+  buf.PutBool(is_donor_quanta_threshgb);
+  buf.PutBool(is_donor_quanta_threshgb_last);
+  buf.PutBool(is_donor_shadedgb);
+  buf.PutBool(is_donor_shadedgb_last);
+  buf.PutBoolArray(is_donor_locus);
+  buf.PutBoolArray(is_donor_locus_last);
+  buf.PutBool(is_energy_requestor);
+  buf.PutBool(is_energy_donor);
+  buf.PutBool(is_energy_receiver);
+  buf.PutBool(has_used_donated_energy);
+  buf.PutBool(has_open_energy_request);
+  buf.PutVarInt(num_thresh_gb_donations);
+  buf.PutVarInt(num_thresh_gb_donations_last);
+  buf.PutVarInt(num_quanta_thresh_gb_donations);
+  buf.PutVarInt(num_quanta_thresh_gb_donations_last);
+  buf.PutVarInt(num_shaded_gb_donations);
+  buf.PutVarInt(num_shaded_gb_donations_last);
+  buf.PutVarInt(num_donations_locus);
+  buf.PutVarInt(num_donations_locus_last);
+  buf.PutBool(is_receiver);
+  buf.PutBool(is_receiver_last);
+  buf.PutBool(is_receiver_rand);
+  buf.PutBool(is_receiver_kin);
+  buf.PutBool(is_receiver_kin_last);
+  buf.PutBool(is_receiver_edit);
+  buf.PutBool(is_receiver_edit_last);
+  buf.PutBool(is_receiver_gbg);
+  buf.PutBool(is_receiver_truegb);
+  buf.PutBool(is_receiver_truegb_last);
+  buf.PutBool(is_receiver_threshgb);
+  buf.PutBool(is_receiver_threshgb_last);
+  buf.PutBool(is_receiver_quanta_threshgb);
+  buf.PutBool(is_receiver_quanta_threshgb_last);
+  buf.PutBool(is_receiver_shadedgb);
+  buf.PutBool(is_receiver_shadedgb_last);
+  buf.PutBool(is_receiver_gb_same_locus);
+  buf.PutBool(is_receiver_gb_same_locus_last);
+  buf.PutBool(is_modifier);
+  buf.PutBool(is_modified);
+  buf.PutBool(is_fertile);
+  buf.PutBool(is_mutated);
+  buf.PutBool(is_multi_thread);
+  buf.PutBool(parent_true);
+  buf.PutBool(parent_sex);
+  buf.PutVarInt(parent_cross_num);
+  buf.PutBool(born_parent_group);
+  buf.PutBool(kaboom_executed);
+  buf.PutBool(kaboom_executed2);
+
+  // 6. Child information...
+  buf.PutBool(copy_true);
+  buf.PutBool(divide_sex);
+  buf.PutVarInt(mate_select_id);
+  buf.PutVarInt(cross_num);
+  buf.PutBool(child_fertile);
+  buf.PutBool(last_child_fertile);
+  buf.PutVarInt(child_copied_size);
+
+  // 7. Information that is set once (when organism was born)
+  buf.PutDouble(permanent_germline_propensity);
+}
+
+bool cPhenotype::LoadState(cChunkBuffer& buf)
+{
+  initialized = buf.GetBool();
+
+  // 1. These are values calculated at the last divide (of self or offspring)
+  merit = buf.GetDouble();
+  executionRatio = buf.GetDouble();
+  energy_store = buf.GetDouble();
+  genome_length = (int)buf.GetVarInt();
+  bonus_instruction_count = (int)buf.GetVarInt();
+  copied_size = (int)buf.GetVarInt();
+  executed_size = (int)buf.GetVarInt();
+  gestation_time = (int)buf.GetVarInt();
+  gestation_start = (int)buf.GetVarInt();
+  fitness = buf.GetDouble();
+  div_type = buf.GetDouble();
+
+  // 2. These are "in progress" variables, updated as the organism operates
+  cur_bonus = buf.GetDouble();
+  cur_energy_bonus = buf.GetDouble();
+  energy_tobe_applied = buf.GetDouble();
+  energy_testament = buf.GetDouble();
+  energy_received_buffer = buf.GetDouble();
+  total_energy_donated = buf.GetDouble();
+  total_energy_received = buf.GetDouble();
+  total_energy_applied = buf.GetDouble();
+  num_energy_requests = (int)buf.GetVarInt();
+  num_energy_donations = (int)buf.GetVarInt();
+  num_energy_receptions = (int)buf.GetVarInt();
+  num_energy_applications = (int)buf.GetVarInt();
+  cur_num_errors = (int)buf.GetVarInt();
+  cur_num_donates = (int)buf.GetVarInt();
+  if (!buf.GetIntArray(cur_task_count)) return false;
+  if (!buf.GetIntArray(cur_para_tasks)) return false;
+  if (!buf.GetIntArray(cur_host_tasks)) return false;
+  if (!buf.GetIntArray(cur_internal_task_count)) return false;
+  if (!buf.GetIntArray(eff_task_count)) return false;
+  if (!buf.GetDoubleArray(cur_task_quality)) return false;
+  if (!buf.GetDoubleArray(cur_task_value)) return false;
+  if (!buf.GetDoubleArray(cur_internal_task_quality)) return false;
+  if (!buf.GetDoubleArray(cur_rbins_total)) return false;
+  if (!buf.GetDoubleArray(cur_rbins_avail)) return false;
+  if (!buf.GetIntArray(cur_collect_spec_counts)) return false;
+  if (!buf.GetIntArray(cur_reaction_count)) return false;
+  if (!buf.GetIntArray(first_reaction_cycles)) return false;
+  if (!buf.GetIntArray(first_reaction_execs)) return false;
+  if (!buf.GetIntArray(cur_stolen_reaction_count)) return false;
+  if (!buf.GetDoubleArray(cur_reaction_add_reward)) return false;
+  if (!buf.GetIntArray(cur_inst_count)) return false;
+  if (!buf.GetIntArray(cur_from_sensor_count)) return false;
+  if (!loadNestedArray(buf, cur_group_attack_count)) return false;
+  if (!loadNestedArray(buf, cur_top_pred_group_attack_count)) return false;
+  if (!buf.GetIntArray(cur_killed_targets)) return false;
+  cur_attacks = (int)buf.GetVarInt();
+  cur_kills = (int)buf.GetVarInt();
+  if (!buf.GetIntArray(cur_sense_count)) return false;
+  if (!buf.GetDoubleArray(sensed_resources)) return false;
+  if (!buf.GetDoubleArray(cur_task_time)) return false;
+  if (buf.GetBool()) return false;  // Per-task state (e.g. fib-seq) is not saved
+  if (!buf.GetDoubleArray(cur_trial_fitnesses)) return false;
+  if (!buf.GetDoubleArray(cur_trial_bonuses)) return false;
+  if (!buf.GetIntArray(cur_trial_times_used)) return false;
+  if (!buf.GetIntArray(cur_from_message_count)) return false;
+  trial_time_used = (int)buf.GetVarInt();
+  trial_cpu_cycles_used = (int)buf.GetVarInt();
+  if (!loadUpdateList(buf, m_tolerance_immigrants)) return false;
+  if (!loadUpdateList(buf, m_tolerance_offspring_own)) return false;
+  if (!loadUpdateList(buf, m_tolerance_offspring_others)) return false;
+  if (!loadIntPairs(buf, m_intolerances)) return false;
+  last_child_germline_propensity = buf.GetDouble();
+  mating_type = (int)buf.GetVarInt();
+  mate_preference = (int)buf.GetVarInt();
+  cur_mating_display_a = (int)buf.GetVarInt();
+  cur_mating_display_b = (int)buf.GetVarInt();
+
+  // 3. These mark the status of "in progress" variables at the last divide.
+  last_merit_base = buf.GetDouble();
+  last_bonus = buf.GetDouble();
+  last_energy_bonus = buf.GetDouble();
+  last_num_errors = (int)buf.GetVarInt();
+  last_num_donates = (int)buf.GetVarInt();
+  if (!buf.GetIntArray(last_task_count)) return false;
+  if (!buf.GetIntArray(last_para_tasks)) return false;
+  if (!buf.GetIntArray(last_host_tasks)) return false;
+  if (!buf.GetIntArray(last_internal_task_count)) return false;
+  if (!buf.GetDoubleArray(last_task_quality)) return false;
+  if (!buf.GetDoubleArray(last_task_value)) return false;
+  if (!buf.GetDoubleArray(last_internal_task_quality)) return false;
+  if (!buf.GetDoubleArray(last_rbins_total)) return false;
+  if (!buf.GetDoubleArray(last_rbins_avail)) return false;
+  if (!buf.GetIntArray(last_collect_spec_counts)) return false;
+  if (!buf.GetIntArray(last_reaction_count)) return false;
+  if (!buf.GetDoubleArray(last_reaction_add_reward)) return false;
+  if (!buf.GetIntArray(last_inst_count)) return false;
+  if (!buf.GetIntArray(last_from_sensor_count)) return false;
+  if (!buf.GetIntArray(last_sense_count)) return false;
+  if (!loadNestedArray(buf, last_group_attack_count)) return false;
+  if (!loadNestedArray(buf, last_top_pred_group_attack_count)) return false;
+  if (!buf.GetIntArray(last_killed_targets)) return false;
+  last_attacks = (int)buf.GetVarInt();
+  last_kills = (int)buf.GetVarInt();
+  if (!buf.GetIntArray(last_from_message_count)) return false;
+  last_fitness = buf.GetDouble();
+  last_cpu_cycles_used = (int)buf.GetVarInt();
+  cur_child_germline_propensity = buf.GetDouble();
+  last_mating_display_a = (int)buf.GetVarInt();
+  last_mating_display_b = (int)buf.GetVarInt();
+
+  // 4. Records from this organism's life...
+  num_divides_failed = (int)buf.GetVarInt();
+  num_divides = (int)buf.GetVarInt();
+  generation = (int)buf.GetVarInt();
+  cpu_cycles_used = (int)buf.GetVarInt();
+  time_used = (int)buf.GetVarInt();
+  num_execs = (int)buf.GetVarInt();
+  age = (int)buf.GetVarInt();
+  if (!buf.GetString(fault_desc)) return false;
+  neutral_metric = buf.GetDouble();
+  life_fitness = buf.GetDouble();
+  exec_time_born = (int)buf.GetVarInt();
+  gmu_exec_time_born = buf.GetDouble();
+  birth_update = (int)buf.GetVarInt();
+  birth_cell_id = (int)buf.GetVarInt();
+  av_birth_cell_id = (int)buf.GetVarInt();
+  birth_group_id = (int)buf.GetVarInt();
+  birth_forager_type = (int)buf.GetVarInt();
+  if (!buf.GetIntArray(testCPU_inst_count)) return false;
+  last_task_id = (int)buf.GetVarInt();
+  num_new_unique_reactions = (int)buf.GetVarInt();
+  res_consumed = buf.GetDouble();
+  is_germ_cell = buf.GetBool();
+  last_task_time = (int)buf.GetVarInt();
+
+  // 5. Status Flags...  (updated at each divide)
+  to_die = buf.GetBool();
+  to_delete = buf.GetBool();
+  make_random_resource = buf.GetBool();
+  is_injected = buf.GetBool();
+  is_clone = buf.GetBool();
+  is_donor_cur = buf.GetBool();
+  is_donor_last = buf.GetBool();
+  is_donor_rand = buf.GetBool();
+  is_donor_rand_last = buf.GetBool();
+  is_donor_null = buf.GetBool();
+  is_donor_null_last = buf.GetBool();
+  is_donor_kin = buf.GetBool();
+  is_donor_kin_last = buf.GetBool();
+  is_donor_edit = buf.GetBool();
+  is_donor_edit_last = buf.GetBool();
+  is_donor_gbg = buf.GetBool();
+  is_donor_gbg_last = buf.GetBool();
+  is_donor_truegb = buf.GetBool();
+  is_donor_truegb_last = buf.GetBool();
+  is_donor_threshgb = buf.GetBool();
+  is_donor_threshgb_last = buf.GetBool();
+  is_donor_quanta_threshgb = buf.GetBool();
+  is_donor_quanta_threshgb_last = buf.GetBool();
+  is_donor_shadedgb = buf.GetBool();
+  is_donor_shadedgb_last = buf.GetBool();
+  if (!buf.GetBoolArray(is_donor_locus)) return false;
+  if (!buf.GetBoolArray(is_donor_locus_last)) return false;
+  is_energy_requestor = buf.GetBool();
+  is_energy_donor = buf.GetBool();
+  is_energy_receiver = buf.GetBool();
+  has_used_donated_energy = buf.GetBool();
+  has_open_energy_request = buf.GetBool();
+  num_thresh_gb_donations = (int)buf.GetVarInt();
+  num_thresh_gb_donations_last = (int)buf.GetVarInt();
+  num_quanta_thresh_gb_donations = (int)buf.GetVarInt();
+  num_quanta_thresh_gb_donations_last = (int)buf.GetVarInt();
+  num_shaded_gb_donations = (int)buf.GetVarInt();
+  num_shaded_gb_donations_last = (int)buf.GetVarInt();
+  num_donations_locus = (int)buf.GetVarInt();
+  num_donations_locus_last = (int)buf.GetVarInt();
+  is_receiver = buf.GetBool();
+  is_receiver_last = buf.GetBool();
+  is_receiver_rand = buf.GetBool();
+  is_receiver_kin = buf.GetBool();
+  is_receiver_kin_last = buf.GetBool();
+  is_receiver_edit = buf.GetBool();
+  is_receiver_edit_last = buf.GetBool();
+  is_receiver_gbg = buf.GetBool();
+  is_receiver_truegb = buf.GetBool();
+  is_receiver_truegb_last = buf.GetBool();
+  is_receiver_threshgb = buf.GetBool();
+  is_receiver_threshgb_last = buf.GetBool();
+  is_receiver_quanta_threshgb = buf.GetBool();
+  is_receiver_quanta_threshgb_last = buf.GetBool();
+  is_receiver_shadedgb = buf.GetBool();
+  is_receiver_shadedgb_last = buf.GetBool();
+  is_receiver_gb_same_locus = buf.GetBool();
+  is_receiver_gb_same_locus_last = buf.GetBool();
+  is_modifier = buf.GetBool();
+  is_modified = buf.GetBool();
+  is_fertile = buf.GetBool();
+  is_mutated = buf.GetBool();
+  is_multi_thread = buf.GetBool();
+  parent_true = buf.GetBool();
+  parent_sex = buf.GetBool();
+  parent_cross_num = (int)buf.GetVarInt();
+  born_parent_group = buf.GetBool();
+  kaboom_executed = buf.GetBool();
+  kaboom_executed2 = buf.GetBool();
+
+  // 6. Child information...
+  copy_true = buf.GetBool();
+  divide_sex = buf.GetBool();
+  mate_select_id = (int)buf.GetVarInt();
+  cross_num = (int)buf.GetVarInt();
+  child_fertile = buf.GetBool();
+  last_child_fertile = buf.GetBool();
+  child_copied_size = (int)buf.GetVarInt();
+
+  // 7. Information that is set once (when organism was born)
+  permanent_germline_propensity = buf.GetDouble();
+  
+  return !buf.Fail();
+}
+
+
 void cPhenotype::PrintStatus(ostream& fp) const
 {
   fp << "  MeritBase:"
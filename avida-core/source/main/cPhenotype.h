@@ -60,6 +60,7 @@
  *************************************************************************/
 
 class cAvidaContext;
+class cChunkBuffer;
 class cContextPhenotype;
 class cEnvironment;
 template <class T> class tBuffer;
@@ -314,6 +315,8 @@ private:
   inline void SetInstSetSize(int inst_set_size);
   inline void SetGroupAttackInstSetSize(int num_group_attack_inst);
   
+  void initialize(int parent_generation, int num_nops);
+  
 public:
   cPhenotype() : m_world(NULL), m_reaction_result(NULL) { ; } // Will not construct a valid cPhenotype! Only exists to support incorrect cDeme Apto::Array usage.
   cPhenotype(cWorld* world, int parent_generation, int num_nops);
@@ -323,6 +326,10 @@ public:
   cPhenotype& operator=(const cPhenotype&); 
   ~cPhenotype();
   
+  // Returns a phenotype in use by a dead organism to the state it was constructed in, blank being a phenotype freshly
+  // constructed for the current environment
+  void Recycle(const cPhenotype& blank, int parent_generation, int num_nops);
+  
   enum energy_levels {ENERGY_LEVEL_LOW = 0, ENERGY_LEVEL_MEDIUM, ENERGY_LEVEL_HIGH};
 	
   void ResetMerit();
@@ -350,6 +357,8 @@ public:
                   Apto::Array<cString>& insts_triggered, bool is_parasite=false, cContextPhenotype* context_phenotype = 0);
 
   // State saving and loading, and printing...
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);  // Fails if the saved phenotype held per-task state, which is not saved
   void PrintStatus(std::ostream& fp) const;
 
   // Some useful methods...
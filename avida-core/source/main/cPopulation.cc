@@ -29,13 +29,16 @@
 #include "avida/data/Package.h"
 #include "avida/data/Util.h"
 #include "avida/output/File.h"
+#include "avida/output/Manager.h"
 #include "avida/systematics/Arbiter.h"
 #include "avida/systematics/Group.h"
 #include "avida/systematics/Manager.h"
 
 #include "avida/private/systematics/GenomeTestMetrics.h"
 #include "avida/private/systematics/Genotype.h"
+#include "avida/private/systematics/GenotypeArbiter.h"
 
+#include "apto/core/FileSystem.h"
 #include "apto/rng.h"
 #include "apto/scheduler.h"
 #include "apto/stat/Accumulator.h"
@@ -43,6 +46,7 @@
 #include "AvidaTools.h"
 
 #include "cAvidaContext.h"
+#include "cBatchedScheduler.h"
 #include "cCPUTestInfo.h"
 #include "cCodeLabel.h"
 #include "cDemePlaceholderUnit.h"
@@ -56,10 +60,13 @@
 #include "cParasite.h"
 #include "cPhenotype.h"
 #include "cPopulationCell.h"
+#include "cPopulationCheckpoint.h"
+#include "cPopulationTile.h"
 #include "cResource.h"
 #include "cResourceCount.h"
 #include "cStats.h"
 #include "cTestCPU.h"
+#include "cThreadPool.h"
 #include "cTopology.h"
 #include "cWorld.h"
 
@@ -266,6 +273,10 @@ cPopulation::cPopulation(cWorld* world)
 : m_world(world)
 , m_scheduler(NULL)
 , birth_chamber(world)
+, m_deme_tiles(false)
+, m_parallel_refused(false)
+, m_thread_pool(NULL)
+, m_deme_res_time(0.0)
 , print_mini_trace_genomes(false)
 , use_micro_traces(false)
 , m_next_prey_q(0)
@@ -317,6 +328,7 @@ void cPopulation::ClearCellGrid()
   delete sleep_log; sleep_log = NULL;
   reaper_queue.Clear();
   delete m_scheduler; m_scheduler = NULL;
+  ClearTiles();
 }
 
 
@@ -334,6 +346,8 @@ void cPopulation::SetupCellGrid()
   
   // Allocate the cells, resources, and market.
   cell_array.ResizeClear(num_cells);
+  m_occupied_cells.ResizeClear(world_x, world_y);
+  m_avatar_counts.ResizeClear(world_x, world_y);
   empty_cell_id_array.ResizeClear(cell_array.GetSize());
   for (int i = 0; i < empty_cell_id_array.GetSize(); i++) {
     empty_cell_id_array[i] = i;
@@ -364,6 +378,7 @@ void cPopulation::SetupCellGrid()
       cell_array[cell_id].SetDemeID(deme_id);
     }
     deme_array[deme_id].Setup(deme_id, deme_cells, deme_size_x, m_world);
+    deme_array[deme_id].SetResourceClock(&m_deme_res_time);
   }
   
   // Setup the topology.
@@ -402,6 +417,11 @@ void cPopulation::SetupCellGrid()
   }
   
   BuildTimeSlicer();
+  // Decided before any tile draws its seed, so that a refused configuration runs exactly as a serial one would
+  if (m_world->GetConfig().PARALLEL_UPDATE.Get()) {
+    if (parallelUpdateAllowed()) BuildTiles();
+    else m_parallel_refused = true;
+  }
   
   
   // Setup the resources...
@@ -604,6 +624,7 @@ cPopulation::~cPopulation()
 {
   for (int i = 0; i < cell_array.GetSize(); i++) delete cell_array[i].GetOrganism(); 
   delete m_scheduler;
+  ClearTiles();
 }
 
 
@@ -611,7 +632,9 @@ inline void cPopulation::AdjustSchedule(const cPopulationCell& cell, const cMeri
 {
   const int deme_id = cell.GetDemeID();
   const cDeme& deme = deme_array[deme_id];
-  m_scheduler->AdjustPriority(cell.GetID(), deme.HasDemeMerit() ? (merit.GetDouble() * deme.GetDemeMerit().GetDouble()) : merit.GetDouble());
+  const double priority = deme.HasDemeMerit() ? (merit.GetDouble() * deme.GetDemeMerit().GetDouble()) : merit.GetDouble();
+  m_scheduler->AdjustPriority(cell.GetID(), priority);
+  if (m_tiles.GetSize()) m_tiles[m_cell_tile[cell.GetID()]]->AdjustPriority(m_cell_tile_id[cell.GetID()], priority);
 }
 
 
@@ -686,7 +709,7 @@ bool cPopulation::ActivateOffspring(cAvidaContext& ctx, const Genome& offspring_
       if (m_world->TestForMigration()) {
         // this offspring is outta here!
         m_world->MigrateOrganism(offspring_array[i], parent_cell, merit_array[i], parent_organism->GetLineageLabel());
-        delete offspring_array[i]; // this offspring isn't hanging around.
+        m_world->GetHardwareManager().ReleaseOrganism(offspring_array[i]); // this offspring isn't hanging around.
       } else {
         // boring; stay here.
         non_migrants.Push(offspring_array[i]);
@@ -916,15 +939,16 @@ bool cPopulation::ActivateOffspring(cAvidaContext& ctx, const Genome& offspring_
           Genome mg(parent_organism->GetGenome().HardwareType(),
                     parent_organism->GetGenome().Properties(),
                     GeneticRepresentationPtr(new InstructionSequence(parent_organism->GetHardware().GetMemory())));
-          test_cpu->TestGenome(ctx, test_info, mg); // Use the true genome
+          cPhenotypeCache::sPhenotype precalc;
+          test_cpu->PrecalcPhenotype(ctx, test_info, mg, precalc); // Use the true genome
           if (pc_phenotype & 1) {  // If we must update the merit
-            parent_phenotype.SetMerit(test_info.GetTestPhenotype().GetMerit());
+            parent_phenotype.SetMerit(precalc.merit);
           }
           if (pc_phenotype & 2) {  // If we must update the gestation time
-            parent_phenotype.SetGestationTime(test_info.GetTestPhenotype().GetGestationTime());
+            parent_phenotype.SetGestationTime(precalc.gestation_time);
           }
           if (pc_phenotype & 4) {  // If we must update the last instruction counts
-            parent_phenotype.SetTestCPUInstCount(test_info.GetTestPhenotype().GetLastInstCount());
+            parent_phenotype.SetTestCPUInstCount(precalc.last_inst_count);
           }
           parent_phenotype.SetFitness(parent_phenotype.GetMerit().CalcFitness(parent_phenotype.GetGestationTime())); // Update fitness
           delete test_cpu;
@@ -975,7 +999,7 @@ bool cPopulation::ActivateOffspring(cAvidaContext& ctx, const Genome& offspring_
         else KillOrganism(GetCell(target_cells[i]), ctx);
       }
     } else {
-      delete offspring_array[i];
+      m_world->GetHardwareManager().ReleaseOrganism(offspring_array[i]);
     }
   }
   if (m_world->GetConfig().DIVIDE_METHOD.Get() == DIVIDE_METHOD_SPLIT && parent_alive && m_world->GetConfig().RESET_INPUTS_ON_DIVIDE.Get()) TestForMiniTrace(parent_organism);
@@ -1315,12 +1339,13 @@ bool cPopulation::ActivateOrganism(cAvidaContext& ctx, cOrganism* in_organism, c
     Genome mg(in_organism->GetGenome().HardwareType(),
               in_organism->GetGenome().Properties(),
               GeneticRepresentationPtr(new InstructionSequence(in_organism->GetHardware().GetMemory())));
-    test_cpu->TestGenome(ctx, test_info, mg);  // Use the true genome
+    cPhenotypeCache::sPhenotype precalc;
+    test_cpu->PrecalcPhenotype(ctx, test_info, mg, precalc);  // Use the true genome
     
     if (pc_phenotype & 1)
-      in_organism->GetPhenotype().SetMerit(test_info.GetTestPhenotype().GetMerit());
+      in_organism->GetPhenotype().SetMerit(precalc.merit);
     if (pc_phenotype & 2)
-      in_organism->GetPhenotype().SetGestationTime(test_info.GetTestPhenotype().GetGestationTime());
+      in_organism->GetPhenotype().SetGestationTime(precalc.gestation_time);
     in_organism->GetPhenotype().SetFitness(in_organism->GetPhenotype().GetMerit().CalcFitness(in_organism->GetPhenotype().GetGestationTime()));
     delete test_cpu;
   }
@@ -2257,7 +2282,7 @@ void cPopulation::KillOrganism(cPopulationCell& in_cell, cAvidaContext& ctx)
   
   // And clear it!
   in_cell.RemoveOrganism(ctx); 
-  if (!organism->IsRunning()) delete organism;
+  if (!organism->IsRunning()) m_world->GetHardwareManager().ReleaseOrganism(organism);
   else organism->GetPhenotype().SetToDelete();
   
   // Alert the scheduler that this cell has a 0 merit.
@@ -3984,7 +4009,7 @@ bool cPopulation::SeedDeme(cDeme& source_deme, cDeme& target_deme, cAvidaContext
         old_target_organisms[i]->SetRunning(false);
         // ONLY delete target orgs if seeding was successful
         // otherwise they still exist in the population!!!
-        if (successfully_seeded) delete old_target_organisms[i];
+        if (successfully_seeded) m_world->GetHardwareManager().ReleaseOrganism(old_target_organisms[i]);
       }
       
       for(int i=0; i<old_source_organisms.GetSize(); ++i) {
@@ -3993,7 +4018,7 @@ bool cPopulation::SeedDeme(cDeme& source_deme, cDeme& target_deme, cAvidaContext
         // delete old source organisms ONLY if source was replaced
         if ( (m_world->GetConfig().DEMES_DIVIDE_METHOD.Get() == 0)
             || (m_world->GetConfig().DEMES_DIVIDE_METHOD.Get() == 1) ) {
-          delete old_source_organisms[i];
+          m_world->GetHardwareManager().ReleaseOrganism(old_source_organisms[i]);
         }
       }
       
@@ -5101,7 +5126,7 @@ void cPopulation::PrintDemeTasks() {
   df->Endl();
 }
 
-void cPopulation::DumpDemeFounders(ofstream& fp) {
+void cPopulation::DumpDemeFounders(ostream& fp) {
   fp << "#filetype deme_founders" << endl
   << "#format deme_id num_founders genotype_ids" << endl
   << endl
@@ -5692,16 +5717,14 @@ void cPopulation::ProcessStep(cAvidaContext& ctx, double step_size, int cell_id)
   double merit = cur_org->GetPhenotype().GetMerit().GetDouble();
   if (cur_org->GetPhenotype().GetToDelete() == true) {
     cur_org->GetHardware().DeleteMiniTrace(print_mini_trace_reacs);
-    delete cur_org;
+    m_world->GetHardwareManager().ReleaseOrganism(cur_org);
   }
   
   m_world->GetStats().IncExecuted();
   resource_count.Update(step_size);
   
-  // These must be done even if there is only one deme.
-  for(int i = 0; i < GetNumDemes(); i++) {
-    GetDeme(i).Update(step_size);
-  }
+  // These must be done even if there is only one deme.  Each deme applies the elapsed time when it is next accessed.
+  m_deme_res_time += step_size;
   
   cDeme & deme = GetDeme(GetCell(cell_id).GetDemeID());
   deme.IncTimeUsed(merit);
@@ -5745,7 +5768,7 @@ void cPopulation::ProcessStepSpeculative(cAvidaContext& ctx, double step_size, i
   
   // Deme specific
   if (GetNumDemes() > 1) {
-    for(int i = 0; i < GetNumDemes(); i++) GetDeme(i).Update(step_size);
+    m_deme_res_time += step_size;
     
     cDeme& deme = GetDeme(GetCell(cell_id).GetDemeID());
     deme.IncTimeUsed(cur_org->GetPhenotype().GetMerit().GetDouble());
@@ -5754,7 +5777,7 @@ void cPopulation::ProcessStepSpeculative(cAvidaContext& ctx, double step_size, i
   
   if (cur_org->GetPhenotype().GetToDelete() == true) {
     cur_org->GetHardware().DeleteMiniTrace(print_mini_trace_reacs);
-    delete cur_org;
+    m_world->GetHardwareManager().ReleaseOrganism(cur_org);
     cur_org = NULL;
   }
   
@@ -5762,14 +5785,172 @@ void cPopulation::ProcessStepSpeculative(cAvidaContext& ctx, double step_size, i
   resource_count.Update(step_size);
 }
 
+
+class cTileProcessTask : public cThreadPool::cTask
+{
+private:
+  cPopulation& m_pop;
+  Apto::Array<cPopulationTile*>& m_tiles;
+  Avida::WorldDriver* m_driver;
+  bool m_first_phase;
+  
+public:
+  cTileProcessTask(cPopulation& pop, Apto::Array<cPopulationTile*>& tiles, Avida::WorldDriver* driver, bool first_phase)
+    : m_pop(pop), m_tiles(tiles), m_driver(driver), m_first_phase(first_phase) { ; }
+  
+  void Run(int item)
+  {
+    cPopulationTile& tile = *m_tiles[item];
+    cAvidaContext tile_ctx(m_driver, tile.GetRandom());
+    tile.ProcessPhase(m_pop, tile_ctx, m_first_phase);
+  }
+};
+
+class cDemeUpdateTask : public cThreadPool::cTask
+{
+public:
+  enum eStage { UPDATE_RESOURCES, PROCESS_UPDATE };
+  
+private:
+  cPopulation& m_pop;
+  Apto::Array<cPopulationTile*>& m_tiles;
+  Avida::WorldDriver* m_driver;
+  eStage m_stage;
+  
+public:
+  cDemeUpdateTask(cPopulation& pop, Apto::Array<cPopulationTile*>& tiles, Avida::WorldDriver* driver, eStage stage)
+    : m_pop(pop), m_tiles(tiles), m_driver(driver), m_stage(stage) { ; }
+  
+  void Run(int item)
+  {
+    cPopulationTile& tile = *m_tiles[item];
+    cAvidaContext tile_ctx(m_driver, tile.GetRandom());
+    cDeme& deme = m_pop.GetDeme(tile.GetDemeID());
+    if (m_stage == UPDATE_RESOURCES) {
+      deme.UpdateDemeRes(tile_ctx);
+      deme.FlushResourceTime();
+    } else {
+      deme.ProcessUpdate(tile_ctx);
+    }
+  }
+};
+
+void cPopulation::ProcessUpdateParallel(cAvidaContext& ctx, int update_size)
+{
+  if (update_size <= 0) return;
+  const double step_size = 1.0 / (double) update_size;
+  const int num_tiles = m_tiles.GetSize();
+  
+  // Divide the update's cycles among the tiles in proportion to their total merit, handing out the cycles lost to
+  // rounding by largest remainder (ties going to the lower tile ID) so that the split is fully deterministic
+  Apto::Array<double> tile_priority(num_tiles);
+  double total_priority = 0.0;
+  for (int i = 0; i < num_tiles; i++) {
+    tile_priority[i] = m_tiles[i]->GetTotalPriority();
+    total_priority += tile_priority[i];
+  }
+  if (total_priority <= 0.0) return;
+  
+  Apto::Array<double> remainder(num_tiles);
+  int assigned = 0;
+  for (int i = 0; i < num_tiles; i++) {
+    const double share = (double) update_size * tile_priority[i] / total_priority;
+    const int budget = (int) share;
+    m_tiles[i]->SetBudget(budget);
+    remainder[i] = (tile_priority[i] > 0.0) ? (share - (double) budget) : -1.0;
+    assigned += budget;
+  }
+  for (; assigned < update_size; assigned++) {
+    int best = -1;
+    for (int i = 0; i < num_tiles; i++) if (remainder[i] >= 0.0 && (best < 0 || remainder[i] > remainder[best])) best = i;
+    if (best < 0) break;
+    m_tiles[best]->SetBudget(m_tiles[best]->m_budget + 1);
+    remainder[best] = -1.0;
+  }
+  
+  bool first_phase = true;
+  while (true) {
+    // Bring the shared resources up to date before the tiles start, so that reading them during the phase never
+    // triggers a lazy update (with whichever tile's random stream got there first)
+    resource_count.UpdateResources(ctx);
+    if (!m_deme_tiles) {
+      for (int i = 0; i < GetNumDemes(); i++) GetDeme(i).UpdateDemeRes(ctx);
+    }
+    
+    cTileProcessTask task(*this, m_tiles, ctx.HasDriver() ? &ctx.Driver() : NULL, first_phase);
+    m_thread_pool->Execute(task, num_tiles);
+    first_phase = false;
+    
+    // Barrier: account for the cycles executed in parallel...
+    int executed = 0;
+    for (int i = 0; i < num_tiles; i++) {
+      cPopulationTile& tile = *m_tiles[i];
+      if (tile.m_executed == 0) continue;
+      executed += tile.m_executed;
+      GetDeme(tile.GetDemeID()).IncTimeUsed(tile.m_executed, tile.m_time_used);
+    }
+    if (executed) {
+      m_world->GetStats().AddExecuted(executed);
+      resource_count.Update(executed * step_size);
+      m_deme_res_time += executed * step_size;
+    }
+    
+    // ...replicate the demes that have reached their implicit replication thresholds, in deme order...
+    if (m_deme_tiles && GetNumDemes() > 1) {
+      for (int i = 0; i < num_tiles; i++) {
+        cPopulationTile& tile = *m_tiles[i];
+        if (tile.m_executed == 0) continue;
+        cAvidaContext tile_ctx(ctx.HasDriver() ? &ctx.Driver() : NULL, tile.GetRandom());
+        CheckImplicitDemeRepro(GetDeme(tile.GetDemeID()), tile_ctx);
+      }
+    }
+    
+    // ...then commit the deferred instructions serially, in tile order, using each tile's own random stream
+    bool catchup = false;
+    for (int i = 0; i < num_tiles; i++) {
+      cPopulationTile& tile = *m_tiles[i];
+      if (!tile.HasDeferred()) continue;
+      cAvidaContext tile_ctx(ctx.HasDriver() ? &ctx.Driver() : NULL, tile.GetRandom());
+      for (int d = 0; d < tile.m_deferred.GetSize(); d++) {
+        const int local_id = tile.m_deferred[d];
+        const int cell_id = tile.m_cells[local_id];
+        cPopulationCell& cell = GetCell(cell_id);
+        tile.m_blocked[local_id] = false;
+        
+        // The organism may have been replaced by an earlier commit during this barrier, in which case its debt is void
+        if (!cell.IsOccupied() || cell.GetOrganism()->GetID() != tile.m_owed_org[local_id]) {
+          tile.m_owed[local_id] = 0;
+          continue;
+        }
+        tile.m_owed[local_id]--;
+        ProcessStep(tile_ctx, step_size, cell_id);
+      }
+      tile.m_catchup = tile.m_deferred;
+      tile.m_deferred.Resize(0);
+      catchup = true;
+    }
+    
+    if (!catchup) break;
+  }
+}
+
+
 // Loop through all the demes getting stats and doing calculations
 // which must be done on a deme by deme basis.
 void cPopulation::UpdateDemeStats(cAvidaContext& ctx) { 
   
-  // These must be updated, even if there is only one deme
-  for(int i = 0; i < GetNumDemes(); i++) {
-    GetDeme(i).UpdateDemeRes(ctx); 
+  // These must be updated, even if there is only one deme.  Once every deme has caught up, rebase the shared clock.
+  if (UsingDemeParallelUpdate()) {
+    // Each deme only touches its own resources, using its own random stream
+    cDemeUpdateTask task(*this, m_tiles, ctx.HasDriver() ? &ctx.Driver() : NULL, cDemeUpdateTask::UPDATE_RESOURCES);
+    m_thread_pool->Execute(task, m_tiles.GetSize());
+  } else {
+    for(int i = 0; i < GetNumDemes(); i++) {
+      GetDeme(i).UpdateDemeRes(ctx); 
+      GetDeme(i).FlushResourceTime();
+    }
   }
+  m_deme_res_time = 0.0;
   
   // bail early to save time if there are no demes
   if (GetNumDemes() == 1) return ;
@@ -6204,6 +6385,10 @@ void cPopulation::UpdateResStats(cAvidaContext& ctx)
 
 void cPopulation::ProcessPreUpdate()
 {
+  // Batched schedulers pick up the merit changes made during the last update all at once
+  cBatchedScheduler* batched_scheduler = dynamic_cast<cBatchedScheduler*>(m_scheduler);
+  if (batched_scheduler) batched_scheduler->Flush();
+  
   resource_count.SetSpatialUpdate(m_world->GetStats().GetUpdate());
   for (int i = 0; i < deme_array.GetSize(); i++) deme_array[i].ProcessPreUpdate();   
 }
@@ -6225,7 +6410,13 @@ void cPopulation::ProcessPostUpdate(cAvidaContext& ctx)
     UpdateMaleFemaleOrgStats(ctx);
   }
   
-  for (int i = 0; i < deme_array.GetSize(); i++) deme_array[i].ProcessUpdate(ctx);   
+  if (UsingDemeParallelUpdate()) {
+    cDemeUpdateTask task(*this, m_tiles, ctx.HasDriver() ? &ctx.Driver() : NULL, cDemeUpdateTask::PROCESS_UPDATE);
+    m_thread_pool->Execute(task, m_tiles.GetSize());
+  } else {
+    for (int i = 0; i < deme_array.GetSize(); i++) deme_array[i].ProcessUpdate(ctx);
+  }
+  for (int i = 0; i < deme_array.GetSize(); i++) deme_array[i].RecordUpdateStats();
 }
 
 void cPopulation::ProcessUpdateCellActions(cAvidaContext& ctx)
@@ -6266,13 +6457,132 @@ struct sGroupInfo {
   sGroupInfo(Systematics::GroupPtr in_bg, bool is_para = false) : bg(in_bg), parasite(is_para) { ; }
 };
 
-bool cPopulation::SavePopulation(const cString& filename, bool save_historic, bool save_groupings, bool save_avatars, bool save_rebirth)
+// Cell lists are written as comma separated text to .spop files and as integer lists to binary checkpoints
+static void writeIntList(Avida::Output::File& df, const Apto::Array<int>& list, const char* descr, const char* format)
+{
+  cString str;
+  if (list.GetSize()) str.Set("%d", list[0]);
+  for (int i = 1; i < list.GetSize(); i++) str += cStringUtil::Stringf(",%d", list[i]);
+  df.Write(str, descr, format);
+}
+
+static void writeIntList(cPopulationCheckpointWriter& df, const Apto::Array<int>& list, const char* descr, const char* format)
+{
+  df.WriteIntList(list, descr, format);
+}
+
+static void legacySaveGroup(Avida::Output::File& df, Systematics::GroupPtr group)
+{
+  group->LegacySave(&df);
+}
+
+static void legacySaveGroup(cPopulationCheckpointWriter& df, Systematics::GroupPtr group)
+{
+  Systematics::GenotypePtr genotype;
+  genotype.DynamicCastFrom(group);
+  assert(genotype);
+  genotype->LegacySave(df);
+}
+
+template <class DF>
+static void savePopulationGroups(DF& df, Apto::Map<int, sGroupInfo*>& genotype_map, bool save_groupings, bool save_avatars,
+                                 bool save_rebirth)
+{
+  Apto::Array<int> cells;
+  Apto::Array<int> offsets;
+  Apto::Array<int> lineages;
+  Apto::Array<int> groups;
+  Apto::Array<int> forages;
+  Apto::Array<int> births;
+  Apto::Array<int> avatars;
+  Apto::Array<int> avatarbs;
+  Apto::Array<int> pforages;
+  Apto::Array<int> pteaches;
+  
+  for (Apto::Map<int, sGroupInfo*>::ValueIterator it = genotype_map.Values(); it.Next();) {
+    sGroupInfo* group_info = *it.Get();
+    
+    legacySaveGroup(df, group_info->bg);
+    
+    Apto::Array<sOrgInfo>& orgs = group_info->orgs;
+    const int num_orgs = orgs.GetSize();
+    cells.Resize(num_orgs);
+    offsets.Resize(num_orgs);
+    lineages.Resize(num_orgs);
+    groups.Resize(num_orgs);
+    forages.Resize(num_orgs);
+    births.Resize(num_orgs);
+    avatars.Resize(num_orgs);
+    avatarbs.Resize(num_orgs);
+    pforages.Resize(num_orgs);
+    pteaches.Resize(num_orgs);
+    
+    cString pmeritstr;
+    pmeritstr.Set("%f", orgs[0].parent_merit);
+    
+    for (int i = 0; i < num_orgs; i++) {
+      cells[i] = orgs[i].cell_id;
+      offsets[i] = orgs[i].offset;
+      lineages[i] = orgs[i].lineage_label;
+      groups[i] = orgs[i].curr_group;
+      forages[i] = orgs[i].curr_forage;
+      births[i] = orgs[i].birth_cell;
+      avatars[i] = orgs[i].avatar_cell;
+      avatarbs[i] = orgs[i].av_bcell;
+      pforages[i] = orgs[i].parent_ft;
+      pteaches[i] = orgs[i].parent_is_teacher;
+      if (i && save_rebirth) pmeritstr += cStringUtil::Stringf(",%f", orgs[i].parent_merit);
+    }
+    
+    writeIntList(df, cells, "Occupied Cell IDs", "cells");
+    if (group_info->parasite) df.Write("", "Gestation (CPU) Cycle Offsets", "gest_offset");
+    else writeIntList(df, offsets, "Gestation (CPU) Cycle Offsets", "gest_offset");
+    writeIntList(df, lineages, "Lineage Label", "lineage");
+      if (!save_rebirth) {
+        if (save_groupings) {
+          writeIntList(df, groups, "Current Group IDs", "group_id");
+          writeIntList(df, forages, "Current Forager Types", "forager_type");
+          writeIntList(df, births, "Birth Cells", "birth_cell");
+        }
+        if (save_avatars) {
+          writeIntList(df, avatars, "Current Avatar Cell Locations", "avatar_cell");
+          writeIntList(df, avatarbs, "Avatar Birth Cell", "av_bcell");
+        }
+      }
+      else if (save_rebirth) {
+        writeIntList(df, groups, "Current Group IDs", "group_id");
+        writeIntList(df, forages, "Current Forager Types", "forager_type");
+        writeIntList(df, births, "Birth Cells", "birth_cell");
+        writeIntList(df, avatars, "Current Avatar Cell Locations", "avatar_cell");
+        writeIntList(df, avatarbs, "Avatar Birth Cell", "av_bcell");
+        writeIntList(df, pforages, "Parent forager type", "parent_ft");
+        writeIntList(df, pteaches, "Was Parent a Teacher", "parent_is_teach");
+        df.Write(pmeritstr, "Parent Merit", "parent_merit");
+      }
+    df.Endl();
+    
+    delete group_info;
+  }
+}
+
+bool cPopulation::SavePopulation(const cString& filename, bool save_historic, bool save_groupings, bool save_avatars, bool save_rebirth,
+                                 bool binary, bool background)
 {
   Apto::String file_path((const char*)filename);
-  Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), file_path);
-  df->SetFileType("genotype_data");
-  df->WriteComment("Structured Population Save");
-  df->WriteTimeStamp();
+  Avida::Output::FilePtr df;
+  cPopulationCheckpointWriter bdf;
+  if (binary) {
+    Apto::String output_path = Avida::Output::Manager::Of(m_world->GetNewWorld())->OutputIDFromPath(file_path);
+    if (!output_path.GetSize() || !bdf.Open((const char*)output_path, background)) return false;
+    bdf.SetFileType("genotype_data");
+    bdf.WriteComment("Structured Population Save");
+    // No time stamp, so that identical populations produce identical binary saves
+  } else {
+    df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), file_path);
+    df->SetFileType("genotype_data");
+    df->WriteComment("Structured Population Save");
+    df->WriteTimeStamp();
+  }
   
   // Build up hash table of all current genotypes and the cells in which the organisms reside
   Apto::Map<int, sGroupInfo*> genotype_map;
@@ -6370,102 +6680,23 @@ bool cPopulation::SavePopulation(const cString& filename, bool save_historic, bo
   }
   
   // Output all current genotypes
-  for (Apto::Map<int, sGroupInfo*>::ValueIterator it = genotype_map.Values(); it.Next();) {
-    sGroupInfo* group_info = *it.Get();
-    Systematics::GroupPtr genotype = group_info->bg;
-    
-    genotype->LegacySave(Apto::GetInternalPtr(df));
-    
-    Apto::Array<sOrgInfo>& cells = group_info->orgs;
-    cString cellstr;
-    cString offsetstr;
-    cString lineagestr;
-    cString groupstr;
-    cString foragestr;
-    cString birthstr;
-    cString avatarstr;
-    cString avatarbstr;
-    
-    cString pforagestr;
-    cString pteachstr;
-    cString pmeritstr;
-    
-    cellstr.Set("%d", cells[0].cell_id);
-    offsetstr.Set("%d", cells[0].offset);
-    lineagestr.Set("%d", cells[0].lineage_label);
-    groupstr.Set("%d", cells[0].curr_group);
-    foragestr.Set("%d", cells[0].curr_forage);
-    birthstr.Set("%d", cells[0].birth_cell);
-    avatarstr.Set("%d", cells[0].avatar_cell);
-    avatarbstr.Set("%d", cells[0].av_bcell);
-    
-    pforagestr.Set("%d", cells[0].parent_ft);
-    pteachstr.Set("%d", cells[0].parent_is_teacher);
-    pmeritstr.Set("%f", cells[0].parent_merit);
-    
-    for (int cell_i = 1; cell_i < cells.GetSize(); cell_i++) {
-      cellstr += cStringUtil::Stringf(",%d", cells[cell_i].cell_id);
-      offsetstr += cStringUtil::Stringf(",%d", cells[cell_i].offset);
-      lineagestr += cStringUtil::Stringf(",%d", cells[cell_i].lineage_label);
-      if (!save_rebirth) {
-        if (save_groupings) {
-          groupstr += cStringUtil::Stringf(",%d", cells[cell_i].curr_group);
-          foragestr += cStringUtil::Stringf(",%d", cells[cell_i].curr_forage);
-          birthstr += cStringUtil::Stringf(",%d", cells[cell_i].birth_cell);
-        }
-        if (save_avatars) {
-          avatarstr += cStringUtil::Stringf(",%d",cells[cell_i].avatar_cell);
-          avatarbstr += cStringUtil::Stringf(",%d",cells[cell_i].av_bcell);
-        }
-      }
-      else if (save_rebirth) {
-        groupstr += cStringUtil::Stringf(",%d", cells[cell_i].curr_group);
-        foragestr += cStringUtil::Stringf(",%d", cells[cell_i].curr_forage);
-        birthstr += cStringUtil::Stringf(",%d", cells[cell_i].birth_cell);
-        avatarstr += cStringUtil::Stringf(",%d",cells[cell_i].avatar_cell);
-        avatarbstr += cStringUtil::Stringf(",%d",cells[cell_i].av_bcell);
-        
-        pforagestr += cStringUtil::Stringf(",%d",cells[cell_i].parent_ft);
-        pteachstr += cStringUtil::Stringf(",%d",cells[cell_i].parent_is_teacher);
-        pmeritstr += cStringUtil::Stringf(",%f",cells[cell_i].parent_merit);
-      }
-    }
-
-    df->Write(cellstr, "Occupied Cell IDs", "cells");
-    if (group_info->parasite) df->Write("", "Gestation (CPU) Cycle Offsets", "gest_offset");
-    else df->Write(offsetstr, "Gestation (CPU) Cycle Offsets", "gest_offset");
-    df->Write(lineagestr, "Lineage Label", "lineage");
-      if (!save_rebirth) {
-        if (save_groupings) {
-          df->Write(groupstr, "Current Group IDs", "group_id");
-          df->Write(foragestr, "Current Forager Types", "forager_type");
-          df->Write(birthstr, "Birth Cells", "birth_cell");
-        }
-        if (save_avatars) {
-          df->Write(avatarstr, "Current Avatar Cell Locations", "avatar_cell");
-          df->Write(avatarbstr, "Avatar Birth Cell", "av_bcell");
-        }
-      }
-      else if (save_rebirth) {
-        df->Write(groupstr, "Current Group IDs", "group_id");
-        df->Write(foragestr, "Current Forager Types", "forager_type");
-        df->Write(birthstr, "Birth Cells", "birth_cell");
-        df->Write(avatarstr, "Current Avatar Cell Locations", "avatar_cell");
-        df->Write(avatarbstr, "Avatar Birth Cell", "av_bcell");
-        df->Write(pforagestr, "Parent forager type", "parent_ft");
-        df->Write(pteachstr, "Was Parent a Teacher", "parent_is_teach");
-        df->Write(pmeritstr, "Parent Merit", "parent_merit");
-      }
-    df->Endl();
-    
-    delete group_info;
-  }
+  if (binary) savePopulationGroups(bdf, genotype_map, save_groupings, save_avatars, save_rebirth);
+  else savePopulationGroups(*df, genotype_map, save_groupings, save_avatars, save_rebirth);
   
   // Output historic genotypes
   if (save_historic) {
-    Systematics::Manager::Of(m_world->GetNewWorld())->ArbiterForRole("genotype")->LegacySave(Apto::GetInternalPtr(df));
+    Systematics::ArbiterPtr arbiter = Systematics::Manager::Of(m_world->GetNewWorld())->ArbiterForRole("genotype");
+    if (binary) {
+      Systematics::GenotypeArbiterPtr genotype_arbiter;
+      genotype_arbiter.DynamicCastFrom(arbiter);
+      assert(genotype_arbiter);
+      genotype_arbiter->LegacySave(bdf);
+    } else {
+      arbiter->LegacySave(Apto::GetInternalPtr(df));
+    }
   }
   
+  if (binary) return bdf.Close();
   return true;
 }
 
@@ -6638,6 +6869,7 @@ struct sTmpGenotype
 public:
   int id_num;
   Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> > props;
+  Apto::Map<Apto::String, Apto::Array<int> > int_lists; // list columns of binary population saves
   
   int num_cpus;
   Apto::Array<int> cells;
@@ -6695,28 +6927,86 @@ bool cPopulation::LoadHostGenotypeList(const cString& filename, cAvidaContext& c
 }
 
 
-bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, int cellid_offset, int lineage_offset, bool load_groups, bool load_birth_cells, bool load_avatars, bool load_rebirth, bool load_parent_dat, int traceq)
+// Reads a comma separated list column, returning false if the column is not present
+static bool readIntList(sTmpGenotype& tmp, const char* key, Apto::Array<int>& list)
+{
+  list.Resize(0);
+  if (tmp.int_lists.Get(key, list)) return true;
+  
+  Apto::String str;
+  if (!tmp.props->Get(key, str)) return false;
+  
+  const char* p = str;
+  while (*p) {
+    char* end;
+    list.Push((int)strtol(p, &end, 10));
+    p = end;
+    while (*p && *p != ',') p++;
+    if (*p == ',') p++;
+  }
+  return true;
+}
+
+bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, int cellid_offset, int lineage_offset, bool load_groups, bool load_birth_cells, bool load_avatars, bool load_rebirth, bool load_parent_dat, int traceq, bool use_mmap)
 {
   // @TODO - build in support for verifying population dimensions
   
-  cInitFile input_file(filename, m_world->GetWorkingDir(), ctx.Driver().Feedback());
-  if (!input_file.WasOpened()) return false;
+  // First, we read in all the genotypes and store them in an array
+  Apto::Array<sTmpGenotype, Apto::ManagedPointer> genotypes;
+  
+  cString path(Apto::FileSystem::GetAbsolutePath(Apto::String(filename), Apto::String(m_world->GetWorkingDir())));
+  if (cPopulationCheckpoint::IsCheckpoint(path)) {
+    cPopulationCheckpointReader reader;
+    if (!reader.Open(path, use_mmap)) {
+      ctx.Driver().Feedback().Error("unable to read population checkpoint '%s'", (const char*)filename);
+      return false;
+    }
+    
+    int num_genotypes = 0;
+    cPopulationCheckpointRecord record;
+    while (reader.NextRecord(record)) {
+      if (num_genotypes == genotypes.GetSize()) genotypes.Resize(Apto::Max(64, num_genotypes * 2));
+      sTmpGenotype& tmp = genotypes[num_genotypes++];
+      tmp.props = Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> >(new Apto::Map<Apto::String, Apto::String>);
+      
+      // Cell lists stay binary, leaving an empty placeholder in the properties
+      const int num_values = Apto::Min(record.GetNumValues(), reader.GetNumColumns());
+      for (int i = 0; i < num_values; i++) {
+        Apto::String key((const char*)reader.GetColumnKey(i));
+        if (record.GetType(i) == cPopulationCheckpoint::INT_LIST) {
+          tmp.int_lists.Set(key, record.GetIntList(i));
+          tmp.props->Set(key, "");
+        } else {
+          tmp.props->Set(key, (const char*)record.AsString(i));
+        }
+      }
+    }
+    genotypes.Resize(num_genotypes);
+    
+    if (reader.Fail()) {
+      ctx.Driver().Feedback().Error("population checkpoint '%s' is corrupt or truncated", (const char*)filename);
+      return false;
+    }
+  } else {
+    cInitFile input_file(filename, m_world->GetWorkingDir(), ctx.Driver().Feedback());
+    if (!input_file.WasOpened()) return false;
+    
+    genotypes.Resize(input_file.GetNumLines());
+    for (int line_id = 0; line_id < input_file.GetNumLines(); line_id++) {
+      genotypes[line_id].props = input_file.GetLineAsDict(line_id);
+    }
+  }
   
   // Clear out the population, unless an offset is being used
   if (cellid_offset == 0) {
     for (int i = 0; i < cell_array.GetSize(); i++) KillOrganism(cell_array[i], ctx); 
   }
   
-  // First, we read in all the genotypes and store them in an array
-  Apto::Array<sTmpGenotype, Apto::ManagedPointer> genotypes(input_file.GetNumLines());
-  
   bool structured = false;
-  for (int line_id = 0; line_id < input_file.GetNumLines(); line_id++) {
-    cString cur_line = input_file.GetLine(line_id);
-    
+  Apto::Array<int> teachers;
+  for (int gen_i = 0; gen_i < genotypes.GetSize(); gen_i++) {
     // Setup the genotype for this line...
-    sTmpGenotype& tmp = genotypes[line_id];
-    tmp.props = input_file.GetLineAsDict(line_id);
+    sTmpGenotype& tmp = genotypes[gen_i];
     tmp.id_num = Apto::StrAs(tmp.props->Get("id"));
 
     // Loads "num_units" preferrentially, but will fall back to "num_cpus" if present
@@ -6724,47 +7014,35 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
     tmp.num_cpus = (tmp.props->Has("num_units")) ? Apto::StrAs(tmp.props->Get("num_units")) : Apto::StrAs(tmp.props->Get("num_cpus"));
     
     // Process resident cell ids
-    cString cellstr(tmp.props->Get("cells"));
-    if (structured || cellstr.GetSize()) {
+    readIntList(tmp, "cells", tmp.cells);
+    if (structured || tmp.cells.GetSize()) {
       structured = true;
-      while (cellstr.GetSize()) tmp.cells.Push(cellstr.Pop(',').AsInt());
       assert(tmp.cells.GetSize() == tmp.num_cpus);
     }
     
     // Process gestation time offsets
     if (!load_rebirth) {
-      cString offsetstr(tmp.props->Get("gest_offset"));
-      if (offsetstr.GetSize()) {
-        while (offsetstr.GetSize()) tmp.offsets.Push(offsetstr.Pop(',').AsInt());
-        assert(tmp.offsets.GetSize() == tmp.num_cpus);
-      }
+      readIntList(tmp, "gest_offset", tmp.offsets);
+      assert(tmp.offsets.GetSize() == 0 || tmp.offsets.GetSize() == tmp.num_cpus);
     }
     // Lineage label (only set if given in file)
-    cString lineagestr(tmp.props->Get("lineage"));
-    while (lineagestr.GetSize()) tmp.lineage_labels.Push(lineagestr.Pop(',').AsInt());
+    readIntList(tmp, "lineage", tmp.lineage_labels);
     // @blw preserve compatability with older .spop files that don't have lineage labels
     assert(tmp.lineage_labels.GetSize() == 0 || tmp.lineage_labels.GetSize() == tmp.num_cpus);
     
     // Other org specs (if given in file)
     if (load_rebirth) {
-      if (tmp.props->Has("birth_cell")) {
-        cString birthstr(tmp.props->Get("birth_cell"));
-        while (birthstr.GetSize()) tmp.birth_cells.Push(birthstr.Pop(',').AsInt());
+      if (readIntList(tmp, "birth_cell", tmp.birth_cells)) {
         assert(tmp.birth_cells.GetSize() == 0 || tmp.birth_cells.GetSize() == tmp.num_cpus);      
       }
-      if (tmp.props->Has("av_bcell") && m_world->GetConfig().USE_AVATARS.Get()) {
-        cString avatarstr(tmp.props->Get("av_bcell"));
-        while (avatarstr.GetSize()) tmp.avatar_cells.Push(avatarstr.Pop(',').AsInt());
+      if (m_world->GetConfig().USE_AVATARS.Get() && readIntList(tmp, "av_bcell", tmp.avatar_cells)) {
         assert(tmp.avatar_cells.GetSize() == 0 || tmp.avatar_cells.GetSize() == tmp.num_cpus);
       }
-      if (tmp.props->Has("parent_is_teach")) {
-        cString teachstr(tmp.props->Get("parent_is_teach"));
-        while (teachstr.GetSize()) tmp.parent_teacher.Push((bool)(teachstr.Pop(',').AsInt()));
+      if (readIntList(tmp, "parent_is_teach", teachers)) {
+        for (int i = 0; i < teachers.GetSize(); i++) tmp.parent_teacher.Push((bool)teachers[i]);
         assert(tmp.parent_teacher.GetSize() == 0 || tmp.parent_teacher.GetSize() == tmp.num_cpus);
       }
-      if (tmp.props->Has("parent_ft")) {
-        cString parentftstr(tmp.props->Get("parent_ft"));
-        while (parentftstr.GetSize()) tmp.parent_ft.Push(parentftstr.Pop(',').AsInt());
+      if (readIntList(tmp, "parent_ft", tmp.parent_ft)) {
         assert(tmp.parent_ft.GetSize() == 0 || tmp.parent_ft.GetSize() == tmp.num_cpus);
       }
       if (tmp.props->Has("parent_merit")) {
@@ -6775,43 +7053,30 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
     }
     else {
       if (load_groups) {
-        if (tmp.props->Has("group_id")) {
-          cString groupstr(tmp.props->Get("group_id"));
-          while (groupstr.GetSize()) tmp.group_ids.Push(groupstr.Pop(',').AsInt());
+        if (readIntList(tmp, "group_id", tmp.group_ids)) {
           assert(tmp.group_ids.GetSize() == 0 || tmp.group_ids.GetSize() == tmp.num_cpus);
         }
-        if (tmp.props->Has("forager_type")) {
-          cString foragestr(tmp.props->Get("forager_type"));
-          while (foragestr.GetSize()) tmp.forager_types.Push(foragestr.Pop(',').AsInt());
+        if (readIntList(tmp, "forager_type", tmp.forager_types)) {
           assert(tmp.forager_types.GetSize() == 0 || tmp.forager_types.GetSize() == tmp.num_cpus);
         }
       }
       if (load_birth_cells) {   
-        if (tmp.props->Has("birth_cell")) {
-          cString birthstr(tmp.props->Get("birth_cell"));
-          while (birthstr.GetSize()) tmp.birth_cells.Push(birthstr.Pop(',').AsInt());
+        if (readIntList(tmp, "birth_cell", tmp.birth_cells)) {
           assert(tmp.birth_cells.GetSize() == 0 || tmp.birth_cells.GetSize() == tmp.num_cpus);
         }
-        if (tmp.props->Has("av_bcell") && m_world->GetConfig().USE_AVATARS.Get()) {
-          cString avatarstr(tmp.props->Get("av_bcell"));
-          while (avatarstr.GetSize()) tmp.avatar_cells.Push(avatarstr.Pop(',').AsInt());
+        if (m_world->GetConfig().USE_AVATARS.Get() && readIntList(tmp, "av_bcell", tmp.avatar_cells)) {
           assert(tmp.avatar_cells.GetSize() == 0 || tmp.avatar_cells.GetSize() == tmp.num_cpus);
         }
       }
-      else if (!load_birth_cells && load_avatars && tmp.props->Has("avatar_cell")) {
-        cString avatarstr(tmp.props->Get("avatar_cell"));
-        while (avatarstr.GetSize()) tmp.avatar_cells.Push(avatarstr.Pop(',').AsInt());
+      else if (!load_birth_cells && load_avatars && readIntList(tmp, "avatar_cell", tmp.avatar_cells)) {
         assert(tmp.avatar_cells.GetSize() == 0 || tmp.avatar_cells.GetSize() == tmp.num_cpus);
       }
     if (load_parent_dat) {
-      if (tmp.props->Has("parent_is_teach")) {
-        cString teachstr(tmp.props->Get("parent_is_teach"));
-        while (teachstr.GetSize()) tmp.parent_teacher.Push((bool)(teachstr.Pop(',').AsInt()));
+      if (readIntList(tmp, "parent_is_teach", teachers)) {
+        for (int i = 0; i < teachers.GetSize(); i++) tmp.parent_teacher.Push((bool)teachers[i]);
         assert(tmp.parent_teacher.GetSize() == 0 || tmp.parent_teacher.GetSize() == tmp.num_cpus);
       }
-      if (tmp.props->Has("parent_ft")) {
-        cString parentftstr(tmp.props->Get("parent_ft"));
-        while (parentftstr.GetSize()) tmp.parent_ft.Push(parentftstr.Pop(',').AsInt());
+      if (readIntList(tmp, "parent_ft", tmp.parent_ft)) {
         assert(tmp.parent_ft.GetSize() == 0 || tmp.parent_ft.GetSize() == tmp.num_cpus);
       }
       if (tmp.props->Has("parent_merit")) {
@@ -6822,8 +7087,7 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
     }
     }
     if (m_world->GetConfig().USE_AVATARS.Get() && !tmp.avatar_cells.GetSize()) {
-      cString avatarstr(tmp.props->Get("avatar_cell"));
-      while (avatarstr.GetSize()) tmp.avatar_cells.Push(avatarstr.Pop(',').AsInt());
+      readIntList(tmp, "avatar_cell", tmp.avatar_cells);
       assert(tmp.avatar_cells.GetSize() == 0 || tmp.avatar_cells.GetSize() == tmp.num_cpus);
     }
   }
@@ -6834,23 +7098,27 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
   Systematics::ManagerPtr classmgr = Systematics::Manager::Of(m_world->GetNewWorld());
   Systematics::ArbiterPtr bgm = classmgr->ArbiterForRole("genotype");
   
+  // Index the genotypes by their saved id, so that parents can be found without scanning
+  Apto::Map<int, int> id_index;
+  for (int i = genotypes.GetSize() - 1; i >= 0; i--) id_index.Set(genotypes[i].id_num, i);
+  
   bool some_missing = false;
+  Apto::Array<int> opids;
   for (int i = genotypes.GetSize() - 1; i >= 0; i--) {
     // Fix Parent IDs
     cString nparentstr;
     int pcount = 0;
-    cString lparentstr = (const char*)genotypes[i].props->Get("parents");
-    if (lparentstr == "(none)") lparentstr = "";
-    cStringList opidlist(lparentstr, ',');
-    while (opidlist.GetSize()) {
-      int opid = opidlist.Pop().AsInt();
+    opids.Resize(0);
+    if (genotypes[i].props->Get("parents") != "(none)") readIntList(genotypes[i], "parents", opids);
+    for (int p = 0; p < opids.GetSize(); p++) {
+      int opid = opids[p];
       int npid = -1;
-      for (int j = i; j < genotypes.GetSize(); j++) {
-        if (genotypes[j].id_num == opid) {
-          npid = genotypes[j].bg->ID();
-          break;
-        }
+      int j = -1;
+      if (id_index.Get(opid, j) && j < i) {
+        // Duplicate ids, find the first one at or after this genotype as before
+        for (j = i; j < genotypes.GetSize() && genotypes[j].id_num != opid; j++) ;
       }
+      if (j >= 0 && j < genotypes.GetSize()) npid = genotypes[j].bg->ID();
       // only for pop saves that include historic (i.e. parent id found):
       if (npid != -1) {
         if (pcount) nparentstr += ",";
@@ -6883,7 +7151,7 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
       
       assert(tmp.bg->Properties().Has("genome"));
       Genome mg(tmp.bg->Properties().Get("genome"));
-      cOrganism* new_organism = new cOrganism(m_world, ctx, mg, -1, Systematics::Source(Systematics::DIVISION, (const char*)filename, true));
+      cOrganism* new_organism = m_world->GetHardwareManager().CreateOrganism(ctx, mg, -1, Systematics::Source(Systematics::DIVISION, (const char*)filename, true));
       
       // Setup the phenotype...
       cPhenotype& phenotype = new_organism->GetPhenotype();
@@ -7002,6 +7270,148 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
   return true;
 }
 
+bool cPopulation::CheckSnapshotSupport(Feedback& feedback)
+{
+  bool supported = true;
+  
+  // Only the batched schedulers can save their state (Apto's schedulers keep theirs private)
+  const int slicing_method = m_world->GetConfig().SLICING_METHOD.Get();
+  if (slicing_method != SLICE_BATCHED_PROB_MERIT && slicing_method != SLICE_BATCHED_INTEGRATED_MERIT) {
+    feedback.Error("snapshots require SLICING_METHOD 6 or 7, whose scheduler state can be saved");
+    supported = false;
+  }
+  if (m_world->GetConfig().DEMES_USE_GERMLINE.Get()) {
+    feedback.Error("snapshots do not carry deme germlines (DEMES_USE_GERMLINE)");
+    supported = false;
+  }
+  if (m_world->GetConfig().USE_FORM_GROUPS.Get() || m_groups.size()) {
+    feedback.Error("snapshots do not carry group membership (USE_FORM_GROUPS)");
+    supported = false;
+  }
+  if (birth_chamber.InUse()) {
+    feedback.Error("snapshots do not carry offspring waiting in the birth chamber");
+    supported = false;
+  }
+  
+  bool hgt = false;
+  bool messaging = false;
+  bool opinions = false;
+  for (int i = 0; i < cell_array.GetSize(); i++) {
+    cPopulationCell& cell = cell_array[i];
+    if (cell.IsHGTInitialized()) hgt = true;
+    if (!cell.IsOccupied()) continue;
+    if (cell.GetOrganism()->HasMessagingState()) messaging = true;
+    if (cell.GetOrganism()->HasOpinionState()) opinions = true;
+  }
+  if (hgt) feedback.Error("snapshots do not carry HGT genome fragments");
+  if (messaging) feedback.Error("snapshots do not carry organism messaging");
+  if (opinions) feedback.Error("snapshots do not carry organism opinions");
+  if (hgt || messaging || opinions) supported = false;
+  
+  bool cell_events = false;
+  bool predicates = false;
+  for (int i = 0; i < deme_array.GetSize(); i++) {
+    cDeme& deme = deme_array[i];
+    if (deme.GetNumEvents()) cell_events = true;
+    if (deme.GetNumDemePredicates() || deme.GetNumMessagePredicates() || deme.GetNumMovementPredicates()) predicates = true;
+  }
+  if (cell_events) feedback.Error("snapshots do not carry deme cell events");
+  if (predicates) feedback.Error("snapshots do not carry deme predicates");
+  if (cell_events || predicates) supported = false;
+  
+  return supported;
+}
+
+void cPopulation::SaveSnapshotState(cChunkBuffer& buf)
+{
+  buf.PutVarInt(world_x);
+  buf.PutVarInt(world_y);
+  buf.PutVarUInt(cell_array.GetSize());
+  for (int i = 0; i < cell_array.GetSize(); i++) {
+    const cPopulationCell& cell = cell_array[i];
+    cell.SaveState(buf);
+    buf.PutBool(cell.IsOccupied());
+    if (cell.IsOccupied()) cell.GetOrganism()->SaveState(buf);
+  }
+  
+  // Organism list and reaper queue order, by cell
+  buf.PutVarUInt(live_org_list.GetSize());
+  for (int i = 0; i < live_org_list.GetSize(); i++) buf.PutVarInt(live_org_list[i]->GetCellID());
+  buf.PutVarUInt(reaper_queue.GetSize());
+  tConstListIterator<cPopulationCell> reaper_it(reaper_queue);
+  while (reaper_it.Next() != NULL) buf.PutVarInt(reaper_it.Get()->GetID());
+  
+  buf.PutVarInt(num_prey_organisms);
+  buf.PutVarInt(num_pred_organisms);
+  buf.PutVarInt(num_top_pred_organisms);
+  buf.PutVarInt(m_next_prey_q);
+  buf.PutVarInt(m_next_pred_q);
+  buf.PutBool(sync_events);
+  
+  resource_count.SaveState(buf);
+  buf.PutDouble(m_deme_res_time);
+  buf.PutVarUInt(deme_array.GetSize());
+  for (int i = 0; i < deme_array.GetSize(); i++) deme_array[i].SaveState(buf);
+  
+  // Schedulers, with the random streams they and the parallel update tiles draw from
+  cBatchedScheduler* scheduler = dynamic_cast<cBatchedScheduler*>(m_scheduler);
+  assert(scheduler);
+  scheduler->SaveState(buf);
+  buf.PutVarUInt(m_tiles.GetSize());
+  for (int i = 0; i < m_tiles.GetSize(); i++) m_tiles[i]->SaveState(buf);
+}
+
+bool cPopulation::LoadSnapshotState(cChunkBuffer& buf)
+{
+  if ((int)buf.GetVarInt() != world_x || (int)buf.GetVarInt() != world_y) return false;
+  if ((int)buf.GetVarUInt() != cell_array.GetSize()) return false;
+  for (int i = 0; i < cell_array.GetSize(); i++) {
+    cPopulationCell& cell = cell_array[i];
+    if (!cell.LoadState(buf)) return false;
+    if (buf.GetBool() != cell.IsOccupied()) return false;
+    if (cell.IsOccupied() && !cell.GetOrganism()->LoadState(buf)) return false;
+  }
+  
+  const int num_live = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_live != live_org_list.GetSize()) return false;
+  for (int i = 0; i < num_live; i++) {
+    const int cell_id = (int)buf.GetVarInt();
+    if (cell_id < 0 || cell_id >= cell_array.GetSize() || !cell_array[cell_id].IsOccupied()) return false;
+    live_org_list[i] = cell_array[cell_id].GetOrganism();
+    live_org_list[i]->SetOrgIndex(i);
+  }
+  const int num_reaper = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_reaper > buf.GetRemaining()) return false;
+  reaper_queue.Clear();
+  for (int i = 0; i < num_reaper; i++) {
+    const int cell_id = (int)buf.GetVarInt();
+    if (cell_id < 0 || cell_id >= cell_array.GetSize()) return false;
+    reaper_queue.PushRear(&cell_array[cell_id]);
+  }
+  
+  num_prey_organisms = (int)buf.GetVarInt();
+  num_pred_organisms = (int)buf.GetVarInt();
+  num_top_pred_organisms = (int)buf.GetVarInt();
+  m_next_prey_q = (int)buf.GetVarInt();
+  m_next_pred_q = (int)buf.GetVarInt();
+  sync_events = buf.GetBool();
+  
+  if (!resource_count.LoadState(buf)) return false;
+  m_deme_res_time = buf.GetDouble();
+  if ((int)buf.GetVarUInt() != deme_array.GetSize()) return false;
+  for (int i = 0; i < deme_array.GetSize(); i++) {
+    if (!deme_array[i].LoadState(buf)) return false;
+  }
+  
+  cBatchedScheduler* scheduler = dynamic_cast<cBatchedScheduler*>(m_scheduler);
+  if (!scheduler || !scheduler->LoadState(buf)) return false;
+  if ((int)buf.GetVarUInt() != m_tiles.GetSize()) return false;
+  for (int i = 0; i < m_tiles.GetSize(); i++) {
+    if (!m_tiles[i]->LoadState(buf)) return false;
+  }
+  return !buf.Fail();
+}
+
 /**
  * This function loads a genome from a given file, and initializes
  * a cpu with it.
@@ -7295,9 +7705,15 @@ void cPopulation::ResetInputs(cAvidaContext& ctx)
 
 void cPopulation::BuildTimeSlicer()
 {
+  m_scheduler = BuildScheduler(cell_array.GetSize());
+}
+
+Apto::PriorityScheduler* cPopulation::BuildScheduler(int num_entries)
+{
+  Apto::PriorityScheduler* scheduler = NULL;
   switch (m_world->GetConfig().SLICING_METHOD.Get()) {
     case SLICE_CONSTANT:
-      m_scheduler = new Apto::Scheduler::RoundRobin(cell_array.GetSize());
+      scheduler = new Apto::Scheduler::RoundRobin(num_entries);
       break;
 //    case SLICE_DEME_PROB_MERIT:
 //      schedule = new cDemeProbSchedule(cell_array.GetSize(), ctx.GetRandom().GetInt(0x7FFFFFFF), deme_array.GetSize());
@@ -7306,25 +7722,140 @@ void cPopulation::BuildTimeSlicer()
 //      schedule = new cProbDemeProbSchedule(cell_array.GetSize(), ctx.GetRandom().GetInt(0x7FFFFFFF), deme_array.GetSize());
 //      break;
     case SLICE_INTEGRATED_MERIT:
-      m_scheduler = new Apto::Scheduler::Integrated(cell_array.GetSize());
+      scheduler = new Apto::Scheduler::Integrated(num_entries);
       break;
     case SLICE_PROB_MERIT:
     {
       Apto::SmartPtr<Apto::Random> rng(new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(0x7FFFFFFF)));
-      m_scheduler = new Apto::Scheduler::Probabilistic(cell_array.GetSize(), rng);
+      scheduler = new Apto::Scheduler::Probabilistic(num_entries, rng);
     }
       break;
     case SLICE_PROB_INTEGRATED_MERIT:
     {
       Apto::SmartPtr<Apto::Random> rng(new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(m_world->GetRandom().MaxSeed())));
-      m_scheduler = new Apto::Scheduler::ProbabilisticIntegrated(cell_array.GetSize(), rng);
+      scheduler = new Apto::Scheduler::ProbabilisticIntegrated(num_entries, rng);
+    }
+      break;
+    case SLICE_BATCHED_PROB_MERIT:
+    {
+      Apto::SmartPtr<Apto::RNG::AvidaRNG> rng(new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(0x7FFFFFFF)));
+      scheduler = new cAliasScheduler(num_entries, rng);
     }
       break;
+    case SLICE_BATCHED_INTEGRATED_MERIT:
+      scheduler = new cStrideScheduler(num_entries);
+      break;
     default:
       cout << "error: requested time slicer not found." << endl;
       m_world->GetDriver().Abort(Avida::INVALID_CONFIG);
       break;
   }
+  return scheduler;
+}
+
+
+bool cPopulation::parallelUpdateAllowed()
+{
+  cAvidaConfig& cfg = m_world->GetConfig();
+  const double point_mut_prob = cfg.POINT_MUT_PROB.Get() + cfg.POINT_INS_PROB.Get() + cfg.POINT_DEL_PROB.Get() +
+                                cfg.DIV_LGT_PROB.Get();
+  
+  // Instruction costs paid outside of STALL instructions touch resources, energy and deme state shared between tiles.
+  // Deme-parallel updates are no different: every deme still reads the world's global resources and energy settings,
+  // so the same restrictions apply to both modes; only the single deme requirement is lifted.
+  bool shared_costs = false;
+  cHardwareManager& hw_mgr = m_world->GetHardwareManager();
+  for (int i = 0; i < hw_mgr.GetNumInstSets(); i++) {
+    const cInstSet& inst_set = hw_mgr.GetInstSet(i);
+    if (inst_set.HasResCosts() || inst_set.HasFemResCosts() || inst_set.HasEnergyCosts() || inst_set.HasPostCosts()) {
+      shared_costs = true;
+    }
+  }
+  
+  const bool shared_state = shared_costs || cfg.TASK_SWITCH_PENALTY.Get() || cfg.ENERGY_ENABLED.Get() ||
+                            cfg.USE_AVATARS.Get();
+  const bool multiple_demes = (cfg.NUM_DEMES.Get() > 1 && cfg.PARALLEL_UPDATE.Get() != 2);
+  
+  return !(cfg.THREAD_SLICING_METHOD.Get() == 1 || multiple_demes || shared_state || point_mut_prob > 0.0 ||
+           cfg.IMPLICIT_REPRO_BONUS.Get() || cfg.IMPLICIT_REPRO_CPU_CYCLES.Get() || cfg.IMPLICIT_REPRO_TIME.Get() ||
+           cfg.IMPLICIT_REPRO_END.Get() || cfg.IMPLICIT_REPRO_ENERGY.Get() > 0.0);
+}
+
+void cPopulation::BuildTiles()
+{
+  m_cell_tile.ResizeClear(cell_array.GetSize());
+  m_cell_tile_id.ResizeClear(cell_array.GetSize());
+  m_deme_tiles = (m_world->GetConfig().PARALLEL_UPDATE.Get() == 2);
+  
+  if (m_deme_tiles) {
+    // One tile per deme, holding the deme's cells in deme order
+    m_tiles.ResizeClear(deme_array.GetSize());
+    Apto::Array<int> tile_cells;
+    for (int deme_id = 0; deme_id < deme_array.GetSize(); deme_id++) {
+      const cDeme& deme = deme_array[deme_id];
+      tile_cells.ResizeClear(deme.GetSize());
+      for (int local_id = 0; local_id < deme.GetSize(); local_id++) {
+        const int cell_id = deme.GetCellID(local_id);
+        tile_cells[local_id] = cell_id;
+        m_cell_tile[cell_id] = deme_id;
+        m_cell_tile_id[cell_id] = local_id;
+      }
+      
+      // Seeds are drawn in deme order, so each deme's stream depends only on the run seed and the number of demes
+      const int seed = m_world->GetRandom().GetInt(m_world->GetRandom().MaxSeed());
+      m_tiles[deme_id] = new cPopulationTile(deme_id, deme_id, tile_cells, BuildScheduler(tile_cells.GetSize()), seed);
+    }
+    
+    m_thread_pool = new cThreadPool(m_world->GetConfig().PARALLEL_THREADS.Get());
+    resource_count.SetThreadPool(m_thread_pool);
+    return;
+  }
+  
+  const int tile_x = Apto::Max(1, m_world->GetConfig().PARALLEL_TILE_X.Get());
+  const int tile_y = Apto::Max(1, m_world->GetConfig().PARALLEL_TILE_Y.Get());
+  const int tiles_x = (world_x + tile_x - 1) / tile_x;
+  const int tiles_y = (world_y + tile_y - 1) / tile_y;
+  
+  m_tiles.ResizeClear(tiles_x * tiles_y);
+  
+  Apto::Array<int> tile_cells;
+  for (int ty = 0; ty < tiles_y; ty++) {
+    for (int tx = 0; tx < tiles_x; tx++) {
+      const int tile_id = ty * tiles_x + tx;
+      const int x_end = Apto::Min(world_x, (tx + 1) * tile_x);
+      const int y_end = Apto::Min(world_y, (ty + 1) * tile_y);
+      
+      tile_cells.ResizeClear((x_end - tx * tile_x) * (y_end - ty * tile_y));
+      int local_id = 0;
+      for (int y = ty * tile_y; y < y_end; y++) {
+        for (int x = tx * tile_x; x < x_end; x++) {
+          const int cell_id = y * world_x + x;
+          tile_cells[local_id] = cell_id;
+          m_cell_tile[cell_id] = tile_id;
+          m_cell_tile_id[cell_id] = local_id;
+          local_id++;
+        }
+      }
+      
+      // Seeds are drawn in tile order, so each tile's stream depends only on the run seed and the tile layout
+      const int seed = m_world->GetRandom().GetInt(m_world->GetRandom().MaxSeed());
+      m_tiles[tile_id] = new cPopulationTile(tile_id, 0, tile_cells, BuildScheduler(tile_cells.GetSize()), seed);
+    }
+  }
+  
+  m_thread_pool = new cThreadPool(m_world->GetConfig().PARALLEL_THREADS.Get());
+  resource_count.SetThreadPool(m_thread_pool);
+}
+
+void cPopulation::ClearTiles()
+{
+  for (int i = 0; i < m_tiles.GetSize(); i++) delete m_tiles[i];
+  m_tiles.Resize(0);
+  m_cell_tile.Resize(0);
+  m_cell_tile_id.Resize(0);
+  m_deme_tiles = false;
+  resource_count.SetThreadPool(NULL);
+  delete m_thread_pool; m_thread_pool = NULL;
 }
 
 
@@ -7350,7 +7881,7 @@ void cPopulation::InjectClone(int cell_id, cOrganism& orig_org, Systematics::Sou
   
   cAvidaContext& ctx = m_world->GetDefaultContext();
   
-  cOrganism* new_organism = new cOrganism(m_world, ctx, orig_org.GetGenome(), orig_org.GetPhenotype().GetGeneration(), src);
+  cOrganism* new_organism = m_world->GetHardwareManager().CreateOrganism(ctx, orig_org.GetGenome(), orig_org.GetPhenotype().GetGeneration(), src);
   Systematics::UnitPtr unit(new_organism);
   new_organism->AddReference(); // creating new smart pointer to new_organism, explicitly add reference
   
@@ -7414,7 +7945,7 @@ void cPopulation::CompeteOrganisms_ConstructOffspring(int cell_id, cOrganism& pa
   Genome child_genome = parent.OffspringGenome();
   parent.GetHardware().Divide_TestFitnessMeasures(ctx);
   parent.OffspringGenome() = save_child;
-  cOrganism* new_organism = new cOrganism(m_world, ctx, child_genome, parent.GetPhenotype().GetGeneration(), Systematics::Source(Systematics::DUPLICATION, ""));
+  cOrganism* new_organism = m_world->GetHardwareManager().CreateOrganism(ctx, child_genome, parent.GetPhenotype().GetGeneration(), Systematics::Source(Systematics::DUPLICATION, ""));
   
   // Classify the offspring
   Systematics::ConstParentGroupsPtr pgrps(new Systematics::ConstParentGroups(1));
@@ -7457,7 +7988,7 @@ void cPopulation::InjectGenome(int cell_id, Systematics::Source src, const Genom
   }
   
   
-  cOrganism* new_organism = new cOrganism(m_world, ctx, genome, -1, src);
+  cOrganism* new_organism = m_world->GetHardwareManager().CreateOrganism(ctx, genome, -1, src);
   
   // Setup the phenotype...
   cPhenotype& phenotype = new_organism->GetPhenotype();
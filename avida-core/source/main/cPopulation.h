@@ -27,6 +27,7 @@
 
 #include "cBirthChamber.h"
 #include "cDeme.h"
+#include "cGridLineCounts.h"
 #include "cOrgInterface.h"
 #include "cPopulationInterface.h"
 #include "cResourceCount.h"
@@ -39,11 +40,14 @@
 
 
 class cAvidaContext;
+class cChunkBuffer;
 class cCodeLabel;
 class cEnvironment;
 class cLineage;
 class cOrganism;
 class cPopulationCell;
+class cPopulationTile;
+class cThreadPool;
 
 using namespace Avida;
 
@@ -70,6 +74,20 @@ private:
   Apto::Array<int> empty_cell_id_array;     // Used for PREFER_EMPTY birth methods
   cResourceCount resource_count;       // Global resources available
   cBirthChamber birth_chamber;         // Global birth chamber.
+  
+  // Parallel update support
+  Apto::Array<cPopulationTile*> m_tiles;    // Tiles partitioning the world grid (empty when PARALLEL_UPDATE is off)
+  bool m_deme_tiles;                        // One tile per deme (PARALLEL_UPDATE 2)
+  bool m_parallel_refused;                  // PARALLEL_UPDATE was set, but the configuration does not allow it
+  Apto::Array<int> m_cell_tile;             // Tile containing each cell
+  Apto::Array<int> m_cell_tile_id;          // Local ID of each cell within its tile
+  cThreadPool* m_thread_pool;
+  
+  // Occupancy of the grid, kept current by the cells so that sensors can pass over runs of empty cells
+  cGridLineCounts m_occupied_cells;         // 1 for each cell holding an organism
+  cGridLineCounts m_avatar_counts;          // Number of avatars in each cell
+  
+  double m_deme_res_time;              // Update time elapsed since deme resources were last brought up to date
   //Keeps track of which organisms are in which group.
   Apto::Map<int, Apto::Array<cOrganism*, Apto::Smart> > m_group_list;
   Apto::Map<int, Apto::Array<pair<int,int> > > m_group_intolerances;
@@ -250,7 +268,7 @@ public:
   void PrintDemesMeritsData(); //@JJB**
   
   // Print deme founders
-  void DumpDemeFounders(ofstream& fp);
+  void DumpDemeFounders(ostream& fp);
   
   // Print donation stats
   void PrintDonationStats();
@@ -259,6 +277,12 @@ public:
   int ScheduleOrganism();          // Determine next organism to be processed.
   void ProcessStep(cAvidaContext& ctx, double step_size, int cell_id);
   void ProcessStepSpeculative(cAvidaContext& ctx, double step_size, int cell_id);
+  
+  // Process an entire update across the parallel update tiles
+  bool UsingParallelUpdate() const { return m_tiles.GetSize() > 0; }
+  bool UsingDemeParallelUpdate() const { return m_deme_tiles && m_tiles.GetSize() > 0; }
+  void ProcessUpdateParallel(cAvidaContext& ctx, int update_size);
+  bool ParallelUpdateRefused() const { return m_parallel_refused; }
 
   // Calculate the statistics from the most recent update.
   void ProcessPostUpdate(cAvidaContext& ctx);
@@ -274,13 +298,22 @@ public:
   bool LoadHostGenotypeList(const cString& filename, cAvidaContext& ctx);
 
   bool SavePopulation(const cString& filename, bool save_historic, bool save_group_info = false, bool save_avatars = false,
-                      bool save_rebirth = false);
+                      bool save_rebirth = false, bool binary = false, bool background = false);
   bool SaveStructuredSystematicsGroup(const Systematics::RoleID& role, const cString& filename);
   bool LoadStructuredSystematicsGroup(cAvidaContext& ctx, const Systematics::RoleID& role, const cString& filename);
   bool LoadPopulation(const cString& filename, cAvidaContext& ctx, int cellid_offset=0, int lineage_offset=0,
-                      bool load_groups = false, bool load_birth_cells = false, bool load_avatars = false, bool load_rebirth = false, bool load_parent_dat = false, int traceq = 0);
+                      bool load_groups = false, bool load_birth_cells = false, bool load_avatars = false, bool load_rebirth = false, bool load_parent_dat = false, int traceq = 0,
+                      bool use_mmap = false);
   bool SaveFlameData(const cString& filename);
   
+  // Snapshot state that a population save does not hold: every cell and organism, the organism list order, resources,
+  // demes and the schedulers (with their random streams, which saving reseeds).  LoadSnapshotState expects the population
+  // to have just been loaded from the matching population save.  CheckSnapshotSupport reports (as errors) any state in
+  // use that snapshots do not carry, and whether a snapshot may be taken.
+  bool CheckSnapshotSupport(Feedback& feedback);
+  void SaveSnapshotState(cChunkBuffer& buf);
+  bool LoadSnapshotState(cChunkBuffer& buf);
+  
   void SetMiniTraceQueue(Apto::Array<int, Apto::Smart> new_queue, const bool print_genomes, const bool print_reacs, const bool use_micro = false);
   void AppendMiniTraces(Apto::Array<int, Apto::Smart> new_queue, const bool print_genomes, const bool print_reacs, const bool use_micro = false);
   void LoadMiniTraceQ(const cString& filename, int orgs_per, bool print_genomes, bool print_reacs);
@@ -318,6 +351,13 @@ public:
   int GetFrozenPeakY(cAvidaContext& ctx, int res_id) const { return resource_count.GetFrozenPeakY(ctx, res_id); } 
   Apto::Array<int>* GetWallCells(int res_id) { return resource_count.GetWallCells(res_id); }
 
+  // Counts over a run of cells in one row or column, for sensors
+  int CountFrozenResCells(int res_id, int x1, int y1, int x2, int y2) const { return resource_count.CountFrozenResCells(res_id, x1, y1, x2, y2); }
+  int CountOccupiedCells(int x1, int y1, int x2, int y2) const { return m_occupied_cells.Count(x1, y1, x2, y2); }
+  int CountAvatars(int x1, int y1, int x2, int y2) const { return m_avatar_counts.Count(x1, y1, x2, y2); }
+  void AdjustCellOccupancy(int cell_id, int delta) { m_occupied_cells.Add(cell_id % world_x, cell_id / world_x, delta); }
+  void AdjustCellAvatars(int cell_id, int delta) { m_avatar_counts.Add(cell_id % world_x, cell_id / world_x, delta); }
+
   cBirthChamber& GetBirthChamber(int id) { (void) id; return birth_chamber; }
 
   void UpdateResources(cAvidaContext& ctx, const Apto::Array<double>& res_change);
@@ -452,6 +492,10 @@ private:
   void SetupCellGrid();
   void ClearCellGrid();
   void BuildTimeSlicer(); // Build the schedule object
+  Apto::PriorityScheduler* BuildScheduler(int num_entries);
+  bool parallelUpdateAllowed();
+  void BuildTiles();
+  void ClearTiles();
   
   // Methods to place offspring in the population.
   cPopulationCell& PositionOffspring(cPopulationCell& parent_cell, cAvidaContext& ctx, bool parent_ok = true); 
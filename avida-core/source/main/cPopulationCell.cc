@@ -23,6 +23,7 @@
 #include "cPopulationCell.h"
 
 #include "avida/core/Feedback.h"
+#include "cChunkedFile.h"
 #include "cDoubleSum.h"
 #include "nHardware.h"
 #include "cOrganism.h"
@@ -140,6 +141,47 @@ void cPopulationCell::Rotate(cPopulationCell& new_facing)
   }
 }
 
+void cPopulationCell::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarInt(m_connections.GetSize() ? m_connections.GetFirst()->GetID() : -1);
+  buf.PutIntArray(m_inputs);
+  buf.PutVarInt(m_cell_data.contents);
+  buf.PutVarInt(m_cell_data.org_id);
+  buf.PutVarInt(m_cell_data.update);
+  buf.PutVarInt(m_cell_data.territory);
+  buf.PutVarInt(m_cell_data.current);
+  buf.PutVarInt(m_cell_data.forager);
+  buf.PutVarInt(m_spec_state);
+  buf.PutBool(m_migrant);
+  buf.PutVarInt(m_visits);
+  m_mut_rates->SaveState(buf);
+}
+
+bool cPopulationCell::LoadState(cChunkBuffer& buf)
+{
+  // Rotate round to the saved facing
+  const int faced_id = (int)buf.GetVarInt();
+  if (m_connections.GetSize()) {
+    int scan_count = 0;
+    while (m_connections.GetFirst()->GetID() != faced_id) {
+      if (++scan_count > m_connections.GetSize()) return false;
+      m_connections.CircNext();
+    }
+  }
+  
+  if (!buf.GetIntArray(m_inputs)) return false;
+  m_cell_data.contents = (int)buf.GetVarInt();
+  m_cell_data.org_id = (int)buf.GetVarInt();
+  m_cell_data.update = (int)buf.GetVarInt();
+  m_cell_data.territory = (int)buf.GetVarInt();
+  m_cell_data.current = (int)buf.GetVarInt();
+  m_cell_data.forager = (int)buf.GetVarInt();
+  m_spec_state = (int)buf.GetVarInt();
+  m_migrant = buf.GetBool();
+  m_visits = (int)buf.GetVarInt();
+  return m_mut_rates->LoadState(buf);
+}
+
 /*! This method recursively builds a set of cells that neighbor this cell, out to 
  the given depth.  The set must be passed in by-reference, as calls to this method 
  must share a common set of already-visited cells.
@@ -267,6 +309,7 @@ void cPopulationCell::InsertOrganism(cOrganism* new_org, cAvidaContext& ctx)
   // Adjust this cell's attributes to account for the new organism.
   m_organism = new_org;
   m_hardware = &new_org->GetHardware();
+  m_world->GetPopulation().AdjustCellOccupancy(m_cell_id, 1);
   m_world->GetStats().AddSpeculativeWaste(m_spec_state);
   m_spec_state = 0;
 	
@@ -303,6 +346,7 @@ cOrganism * cPopulationCell::RemoveOrganism(cAvidaContext& ctx)
   }
   m_organism = NULL;
   m_hardware = NULL;
+  m_world->GetPopulation().AdjustCellOccupancy(m_cell_id, -1);
   return out_organism;
 }
 
@@ -330,6 +374,7 @@ double cPopulationCell::UptakeCellEnergy(double frac_to_uptake, cAvidaContext& c
 void cPopulationCell::AddPredAV(cAvidaContext& ctx, cOrganism* org)
 {
   m_av_pred.Push(org);
+  m_world->GetPopulation().AdjustCellAvatars(m_cell_id, 1);
   // Swaps the added avatar into a random position in the array
   int loc = ctx.GetRandom().GetUInt(0, m_av_pred.GetSize());
   cOrganism* exist_org = m_av_pred[loc];
@@ -342,6 +387,7 @@ void cPopulationCell::AddPredAV(cAvidaContext& ctx, cOrganism* org)
 void cPopulationCell::AddPreyAV(cAvidaContext& ctx, cOrganism* org)
 {
   m_av_prey.Push(org);
+  m_world->GetPopulation().AdjustCellAvatars(m_cell_id, 1);
   // Swaps the added avatar into a random position in the array
   int loc = ctx.GetRandom().GetUInt(0, m_av_prey.GetSize());
   cOrganism* exist_org = m_av_prey[loc];
@@ -360,6 +406,7 @@ void cPopulationCell::RemovePredAV(cOrganism* org)
   exist_org->SetAVInIndex(org->GetAVInIndex());
   m_av_pred.Swap(org->GetAVInIndex(), last);
   m_av_pred.Pop();
+  m_world->GetPopulation().AdjustCellAvatars(m_cell_id, -1);
 }
 
 // Removes the organism from the cell's output avatars (prey)
@@ -372,6 +419,7 @@ void cPopulationCell::RemovePreyAV(cOrganism* org)
   exist_org->SetAVOutIndex(org->GetAVOutIndex());
   m_av_prey.Swap(org->GetAVOutIndex(), last);
   m_av_prey.Pop();
+  m_world->GetPopulation().AdjustCellAvatars(m_cell_id, -1);
 }
 
 // Returns whether a cell has an output AV that the org will be able to receive messages from.
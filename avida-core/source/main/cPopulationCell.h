@@ -33,6 +33,7 @@
 #include "tList.h"
 #include "cGenomeUtil.h"
 
+class cChunkBuffer;
 class cHardwareBase;
 class cPopulation;
 class cOrganism;
@@ -96,6 +97,10 @@ public:
   void SetDemeID(int in_id) { m_deme_id = in_id; }
   void Rotate(cPopulationCell& new_facing);
 
+  // Snapshot state: facing, inputs, cell data and mutation rates.  The occupant and HGT fragments are not included.
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
+
   //@AWC -- This is, admittedly, a hack to get migration between demes working under local copy...
   void SetMigrant() {m_migrant = true;} //@AWC -- this cell will contain a migrant genome
   void UnsetMigrant() {m_migrant = false;} //@AWC -- unset the migrant flag
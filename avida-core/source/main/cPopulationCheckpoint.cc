@@ -0,0 +1,474 @@
+/*
+ *  cPopulationCheckpoint.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPopulationCheckpoint.h"
+
+#include "avida/core/Feedback.h"
+#include "avida/output/File.h"
+
+#include "cStringUtil.h"
+
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string>
+
+
+const char cPopulationCheckpoint::MAGIC[8] = { 'A', 'V', 'I', 'D', 'A', 'P', 'O', 'P' };
+
+
+// Parses a token that reads back exactly as it would be written by "%d", so that the text form is preserved
+static bool parseCanonicalInt(const char* str, int len, int& value)
+{
+  int pos = 0;
+  bool neg = false;
+  if (pos < len && str[pos] == '-') { neg = true; pos++; }
+  if (pos == len || len - pos > 10) return false;
+  if (str[pos] == '0' && (len - pos > 1 || neg)) return false;
+
+  long long v = 0;
+  for (; pos < len; pos++) {
+    if (str[pos] < '0' || str[pos] > '9') return false;
+    v = v * 10 + (str[pos] - '0');
+  }
+  if (neg) v = -v;
+  if (v < INT_MIN || v > INT_MAX) return false;
+
+  value = (int)v;
+  return true;
+}
+
+static bool parseCanonicalIntList(const char* str, int len, Apto::Array<int>& list)
+{
+  list.Resize(0);
+  int start = 0;
+  for (int i = 0; i <= len; i++) {
+    if (i < len && str[i] != ',') continue;
+    int value;
+    if (!parseCanonicalInt(str + start, i - start, value)) return false;
+    list.Push(value);
+    start = i + 1;
+  }
+  return true;
+}
+
+
+bool cPopulationCheckpoint::IsCheckpoint(const cString& path)
+{
+  return cChunkedFileReader::HasMagic(Apto::String((const char*)path), MAGIC);
+}
+
+
+bool cPopulationCheckpoint::ConvertFromText(const cString& in_path, const cString& out_path, Feedback& feedback)
+{
+  Avida::Output::File::WaitForPendingWrites();
+  std::ifstream fp((const char*)in_path);
+  if (!fp.good()) {
+    feedback.Error("unable to open file '%s'", (const char*)in_path);
+    return false;
+  }
+
+  cPopulationCheckpointWriter writer;
+  if (!writer.Open(out_path)) {
+    feedback.Error("unable to open file '%s' for writing", (const char*)out_path);
+    return false;
+  }
+
+  Apto::Array<int> list;
+  std::string line;
+  std::string data;
+  while (std::getline(fp, line)) {
+    if (line.size() && line[line.size() - 1] == '\r') line.resize(line.size() - 1);
+
+    // Directives and comments, handled as by cInitFile
+    if (line.size() && line[0] == '#' && !data.size()) {
+      if (line.compare(0, 10, "#filetype ") == 0) {
+        cString ft(line.c_str() + 10);
+        writer.SetFileType(ft.PopWord());
+      } else if (line.compare(0, 8, "#format ") == 0) {
+        cString fmt(line.c_str() + 8);
+        while (fmt.GetSize()) {
+          cString key = fmt.PopWord();
+          if (key.GetSize() && !writer.m_header_written) writer.m_keys.Push(key);
+        }
+      } else {
+        writer.WriteRawComment(line.c_str());
+      }
+      continue;
+    }
+
+    // Strip comments and surrounding whitespace, then join lines ending with the continuation mark
+    std::string::size_type end = line.find('#');
+    if (end != std::string::npos) line.resize(end);
+    std::string::size_type first = line.find_first_not_of(" \t");
+    std::string::size_type last = line.find_last_not_of(" \t");
+    if (first != std::string::npos) data.append(line, first, last - first + 1);
+    if (data.size() && data[data.size() - 1] == '\\') {
+      data.resize(data.size() - 1);
+      continue;
+    }
+    if (!data.size()) continue;
+    if (!writer.m_header_written) writer.writeHeader();
+
+    // Split into whitespace separated values in place
+    char* str = &data[0];
+    const int size = (int)data.size();
+    int pos = 0;
+    while (pos < size) {
+      while (pos < size && (str[pos] == ' ' || str[pos] == '\t')) pos++;
+      if (pos == size) break;
+      const int start = pos;
+      while (pos < size && str[pos] != ' ' && str[pos] != '\t') pos++;
+      str[pos] = '\0';
+
+      int value;
+      if (parseCanonicalInt(str + start, pos - start, value)) writer.Write(value, "");
+      else if (parseCanonicalIntList(str + start, pos - start, list)) writer.WriteIntList(list, "");
+      else writer.Write(str + start, "");
+      pos++;
+    }
+    writer.Endl();
+    data.clear();
+  }
+
+  if (!writer.Close()) {
+    feedback.Error("error writing file '%s'", (const char*)out_path);
+    return false;
+  }
+  return true;
+}
+
+
+bool cPopulationCheckpoint::ConvertToText(const cString& in_path, const cString& out_path, Feedback& feedback,
+                                          bool use_mmap)
+{
+  cPopulationCheckpointReader reader;
+  if (!reader.Open(in_path, use_mmap)) {
+    feedback.Error("unable to read population checkpoint '%s'", (const char*)in_path);
+    return false;
+  }
+
+  std::ofstream fp((const char*)out_path);
+  if (!fp.good()) {
+    feedback.Error("unable to open file '%s' for writing", (const char*)out_path);
+    return false;
+  }
+
+  // Same layout as Output::File
+  if (reader.GetFileType().GetSize()) fp << "#filetype " << reader.GetFileType() << "\n";
+  if (reader.GetNumColumns()) {
+    fp << "#format ";
+    for (int i = 0; i < reader.GetNumColumns(); i++) fp << reader.GetColumnKey(i) << " ";
+    fp << "\n";
+  }
+  fp << reader.GetHeaderText() << "\n";
+
+  cPopulationCheckpointRecord record;
+  while (reader.NextRecord(record)) {
+    for (int i = 0; i < record.GetNumValues(); i++) fp << record.AsString(i) << " ";
+    fp << "\n";
+  }
+
+  if (reader.Fail()) {
+    feedback.Error("population checkpoint '%s' is corrupt or truncated", (const char*)in_path);
+    return false;
+  }
+
+  fp.close();
+  if (fp.fail()) {
+    feedback.Error("error writing file '%s'", (const char*)out_path);
+    return false;
+  }
+  return true;
+}
+
+
+
+cString cPopulationCheckpointRecord::AsString(int i) const
+{
+  const sValue& value = m_values[i];
+  switch (value.type) {
+    case cPopulationCheckpoint::INT:
+      return cStringUtil::Stringf("%lld", value.int_value);
+
+    case cPopulationCheckpoint::DOUBLE:
+      return cStringUtil::Stringf("%g", value.double_value);
+
+    case cPopulationCheckpoint::INT_LIST:
+      {
+        cString str;
+        for (int j = 0; j < value.list.GetSize(); j++) {
+          if (j) str += ",";
+          str += cStringUtil::Convert(value.list[j]);
+        }
+        return str;
+      }
+
+    case cPopulationCheckpoint::TEXT:
+    default:
+      return value.text;
+  }
+}
+
+
+
+bool cPopulationCheckpointWriter::Open(const cString& path, bool background)
+{
+  m_chunk.Clear();
+  m_record.Clear();
+  m_record_values = 0;
+  m_filetype = "";
+  m_descr = "";
+  m_keys.Resize(0);
+  m_num_cols = 0;
+  m_header_written = false;
+
+  return m_file.Open(Apto::String((const char*)path), cPopulationCheckpoint::MAGIC, cPopulationCheckpoint::VERSION,
+                     background);
+}
+
+bool cPopulationCheckpointWriter::Close()
+{
+  if (!m_file.Good()) return m_file.Close();
+
+  if (!m_header_written) writeHeader();
+  flushChunk();
+  return m_file.Close();
+}
+
+
+void cPopulationCheckpointWriter::WriteComment(const char* comment)
+{
+  if (!m_header_written) m_descr += cStringUtil::Stringf("# %s\n", comment);
+}
+
+void cPopulationCheckpointWriter::WriteRawComment(const char* comment)
+{
+  if (!m_header_written) m_descr += cStringUtil::Stringf("%s\n", comment);
+}
+
+void cPopulationCheckpointWriter::WriteTimeStamp()
+{
+  if (!m_header_written) {
+    time_t time_p = time(0);
+    m_descr += cStringUtil::Stringf("# %s", ctime(&time_p));
+  }
+}
+
+void cPopulationCheckpointWriter::WriteColumnDesc(const char* descr, const char* format)
+{
+  if (!m_header_written) {
+    m_num_cols++;
+    m_descr += cStringUtil::Stringf("# %2d: %s\n", m_num_cols, descr);
+    if (format[0] != '\0') m_keys.Push(format);
+  }
+}
+
+
+void cPopulationCheckpointWriter::Write(double x, const char* descr, const char* format)
+{
+  WriteColumnDesc(descr, format);
+  m_record.PutByte(cPopulationCheckpoint::DOUBLE);
+  m_record.PutDouble(x);
+  m_record_values++;
+}
+
+void cPopulationCheckpointWriter::Write(int i, const char* descr, const char* format)
+{
+  WriteColumnDesc(descr, format);
+  m_record.PutByte(cPopulationCheckpoint::INT);
+  m_record.PutVarInt(i);
+  m_record_values++;
+}
+
+void cPopulationCheckpointWriter::Write(long i, const char* descr, const char* format)
+{
+  WriteColumnDesc(descr, format);
+  m_record.PutByte(cPopulationCheckpoint::INT);
+  m_record.PutVarInt(i);
+  m_record_values++;
+}
+
+void cPopulationCheckpointWriter::Write(unsigned int i, const char* descr, const char* format)
+{
+  WriteColumnDesc(descr, format);
+  m_record.PutByte(cPopulationCheckpoint::INT);
+  m_record.PutVarInt(i);
+  m_record_values++;
+}
+
+void cPopulationCheckpointWriter::Write(const char* data_str, const char* descr, const char* format)
+{
+  WriteColumnDesc(descr, format);
+  const int size = (int)strlen(data_str);
+  m_record.PutByte(cPopulationCheckpoint::TEXT);
+  m_record.PutVarUInt(size);
+  m_record.PutBytes(data_str, size);
+  m_record_values++;
+}
+
+void cPopulationCheckpointWriter::WriteIntList(const Apto::Array<int>& list, const char* descr, const char* format)
+{
+  WriteColumnDesc(descr, format);
+  m_record.PutByte(cPopulationCheckpoint::INT_LIST);
+  m_record.PutVarUInt(list.GetSize());
+
+  // Cell lists are mostly ascending runs, so store the differences
+  long long prev = 0;
+  for (int i = 0; i < list.GetSize(); i++) {
+    m_record.PutVarInt(list[i] - prev);
+    prev = list[i];
+  }
+  m_record_values++;
+}
+
+
+void cPopulationCheckpointWriter::Endl()
+{
+  if (!m_header_written) writeHeader();
+
+  m_chunk.PutVarUInt(m_record_values);
+  m_chunk.PutBytes(m_record.GetData(), m_record.GetSize());
+  m_record.Clear();
+  m_record_values = 0;
+
+  if (m_chunk.GetSize() >= cPopulationCheckpoint::CHUNK_SIZE) flushChunk();
+}
+
+
+void cPopulationCheckpointWriter::writeHeader()
+{
+  cChunkBuffer header;
+  header.PutString(m_filetype);
+  header.PutString(m_descr);
+  header.PutVarUInt(m_keys.GetSize());
+  for (int i = 0; i < m_keys.GetSize(); i++) header.PutString(m_keys[i]);
+  m_file.WriteChunk(header);
+
+  m_header_written = true;
+}
+
+void cPopulationCheckpointWriter::flushChunk()
+{
+  if (!m_chunk.GetSize()) return;
+  m_file.WriteChunk(m_chunk);
+  m_chunk.Clear();
+}
+
+
+
+bool cPopulationCheckpointReader::Open(const cString& path, bool use_mmap)
+{
+  m_fail = true;
+  m_filetype = "";
+  m_descr = "";
+  m_keys.Resize(0);
+  m_chunk.StartRead(NULL, 0);
+
+  if (!m_file.Open(Apto::String((const char*)path), cPopulationCheckpoint::MAGIC, use_mmap)) return false;
+  if (m_file.GetVersion() != cPopulationCheckpoint::VERSION) return false;
+
+  cChunkBuffer header;
+  if (!m_file.ReadChunk(header)) return false;
+  header.GetString(m_filetype);
+  header.GetString(m_descr);
+  const unsigned long long num_keys = header.GetVarUInt();
+  for (unsigned long long i = 0; i < num_keys && !header.Fail(); i++) {
+    cString key;
+    header.GetString(key);
+    m_keys.Push(key);
+  }
+  if (header.Fail()) return false;
+
+  m_fail = false;
+  return true;
+}
+
+
+bool cPopulationCheckpointReader::NextRecord(cPopulationCheckpointRecord& record)
+{
+  if (m_fail) return false;
+
+  while (m_chunk.AtEnd()) {
+    if (!m_file.ReadChunk(m_chunk)) {
+      m_fail = m_file.Fail();
+      return false;
+    }
+  }
+
+  // Every value takes at least two bytes, which bounds the counts before anything is allocated
+  const unsigned long long num_values = m_chunk.GetVarUInt();
+  if (m_chunk.Fail() || num_values > (unsigned long long)m_chunk.GetRemaining() / 2) {
+    m_fail = true;
+    return false;
+  }
+  if (record.m_values.GetSize() < (int)num_values) record.m_values.Resize((int)num_values);
+  record.m_num_values = (int)num_values;
+
+  for (int i = 0; i < record.m_num_values && !m_chunk.Fail(); i++) {
+    cPopulationCheckpointRecord::sValue& value = record.m_values[i];
+    const int type = m_chunk.GetByte();
+    switch (type) {
+      case cPopulationCheckpoint::TEXT:
+        value.type = cPopulationCheckpoint::TEXT;
+        m_chunk.GetString(value.text);
+        break;
+
+      case cPopulationCheckpoint::INT:
+        value.type = cPopulationCheckpoint::INT;
+        value.int_value = m_chunk.GetVarInt();
+        break;
+
+      case cPopulationCheckpoint::DOUBLE:
+        value.type = cPopulationCheckpoint::DOUBLE;
+        value.double_value = m_chunk.GetDouble();
+        break;
+
+      case cPopulationCheckpoint::INT_LIST:
+        {
+          value.type = cPopulationCheckpoint::INT_LIST;
+          const unsigned long long size = m_chunk.GetVarUInt();
+          if (m_chunk.Fail() || size > (unsigned long long)m_chunk.GetRemaining()) {
+            m_fail = true;
+            return false;
+          }
+          value.list.Resize((int)size);
+          long long prev = 0;
+          for (int j = 0; j < (int)size; j++) {
+            prev += m_chunk.GetVarInt();
+            value.list[j] = (int)prev;
+          }
+        }
+        break;
+
+      default:
+        m_fail = true;
+        return false;
+    }
+  }
+
+  if (m_chunk.Fail()) {
+    m_fail = true;
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,169 @@
+/*
+ *  cPopulationCheckpoint.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cPopulationCheckpoint_h
+#define cPopulationCheckpoint_h
+
+#include "apto/core.h"
+
+#include "cChunkedFile.h"
+#include "cString.h"
+
+namespace Avida {
+  class Feedback;
+};
+
+using namespace Avida;
+
+
+// Binary population save (.bpop).  Holds the same table as a structured population save (.spop) -- the same columns,
+// one record per genotype -- in a cChunkedFile.  The first chunk holds the file type, the header comment text and the
+// column keys; each following chunk holds as many whole records as fit in about CHUNK_SIZE bytes.  A record is a value
+// count followed by typed values, so that integers and cell lists are stored without being formatted as text.
+//
+// cPopulationCheckpointWriter follows the Output::File interface, so that the population save can write either one.
+
+class cPopulationCheckpoint
+{
+public:
+  static const char MAGIC[8];
+  static const unsigned int VERSION = 1;
+  static const int CHUNK_SIZE = 256 * 1024;
+
+  enum eValueType { TEXT = 0, INT = 1, INT_LIST = 2, DOUBLE = 3 };
+
+  static bool IsCheckpoint(const cString& path);
+
+  // Streaming conversion between the text and binary forms, a line or record at a time
+  static bool ConvertFromText(const cString& in_path, const cString& out_path, Feedback& feedback);
+  static bool ConvertToText(const cString& in_path, const cString& out_path, Feedback& feedback, bool use_mmap = false);
+};
+
+
+class cPopulationCheckpointRecord
+{
+  friend class cPopulationCheckpointReader;
+private:
+  struct sValue
+  {
+    cPopulationCheckpoint::eValueType type;
+    long long int_value;
+    double double_value;
+    cString text;
+    Apto::Array<int> list;
+  };
+
+  Apto::Array<sValue> m_values;   // Grown as needed and reused across records
+  int m_num_values;
+
+public:
+  cPopulationCheckpointRecord() : m_num_values(0) { ; }
+
+  int GetNumValues() const { return m_num_values; }
+  cPopulationCheckpoint::eValueType GetType(int i) const { return m_values[i].type; }
+
+  long long GetInt(int i) const { return m_values[i].int_value; }
+  double GetDouble(int i) const { return m_values[i].double_value; }
+  const cString& GetText(int i) const { return m_values[i].text; }
+  const Apto::Array<int>& GetIntList(int i) const { return m_values[i].list; }
+
+  // Formats a value the way it appears in a .spop file
+  cString AsString(int i) const;
+};
+
+
+class cPopulationCheckpointWriter
+{
+  friend class cPopulationCheckpoint;
+private:
+  cChunkedFileWriter m_file;
+  cChunkBuffer m_chunk;
+  cChunkBuffer m_record;
+  int m_record_values;
+
+  cString m_filetype;
+  cString m_descr;
+  Apto::Array<cString> m_keys;
+  int m_num_cols;
+  bool m_header_written;
+
+  void writeHeader();
+  void flushChunk();
+
+  cPopulationCheckpointWriter(const cPopulationCheckpointWriter&); // @not_implemented
+  cPopulationCheckpointWriter& operator=(const cPopulationCheckpointWriter&); // @not_implemented
+
+public:
+  cPopulationCheckpointWriter() : m_record_values(0), m_num_cols(0), m_header_written(false) { ; }
+  ~cPopulationCheckpointWriter() { Close(); }
+
+  bool Open(const cString& path, bool background = false);  // See cChunkedFileWriter for background writing
+  bool Close();
+  bool Good() const { return m_file.Good(); }
+
+  // Header values, ignored once the first record has been written
+  void SetFileType(const char* filetype) { if (!m_header_written) m_filetype = filetype; }
+  void WriteComment(const char* comment);
+  void WriteRawComment(const char* comment);
+  void WriteTimeStamp();
+  void WriteColumnDesc(const char* descr, const char* format = "");
+
+  void Write(double x, const char* descr, const char* format = "");
+  void Write(int i, const char* descr, const char* format = "");
+  void Write(long i, const char* descr, const char* format = "");
+  void Write(unsigned int i, const char* descr, const char* format = "");
+  void Write(const char* data_str, const char* descr, const char* format = "");
+  void WriteIntList(const Apto::Array<int>& list, const char* descr, const char* format = "");
+
+  void Endl();
+};
+
+
+class cPopulationCheckpointReader
+{
+private:
+  cChunkedFileReader m_file;
+  cChunkBuffer m_chunk;
+  bool m_fail;
+
+  cString m_filetype;
+  cString m_descr;
+  Apto::Array<cString> m_keys;
+
+  cPopulationCheckpointReader(const cPopulationCheckpointReader&); // @not_implemented
+  cPopulationCheckpointReader& operator=(const cPopulationCheckpointReader&); // @not_implemented
+
+public:
+  cPopulationCheckpointReader() : m_fail(false) { ; }
+
+  bool Open(const cString& path, bool use_mmap = false);
+
+  const cString& GetFileType() const { return m_filetype; }
+  const cString& GetHeaderText() const { return m_descr; }
+  int GetNumColumns() const { return m_keys.GetSize(); }
+  const cString& GetColumnKey(int i) const { return m_keys[i]; }
+
+  // Reads the next record, returning false at the end of the file or on error (see Fail)
+  bool NextRecord(cPopulationCheckpointRecord& record);
+  bool Fail() const { return m_fail; }
+};
+
+#endif
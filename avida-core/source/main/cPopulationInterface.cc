@@ -418,6 +418,21 @@ int cPopulationInterface::GetFrozenPeakY(cAvidaContext& ctx, int res_id)
   return m_world->GetPopulation().GetFrozenPeakY(ctx, res_id); 
 } 
 
+int cPopulationInterface::CountFrozenResCells(int res_id, int x1, int y1, int x2, int y2)
+{
+  return m_world->GetPopulation().CountFrozenResCells(res_id, x1, y1, x2, y2);
+}
+
+int cPopulationInterface::CountOccupiedCells(int x1, int y1, int x2, int y2)
+{
+  return m_world->GetPopulation().CountOccupiedCells(x1, y1, x2, y2);
+}
+
+int cPopulationInterface::CountAVs(int x1, int y1, int x2, int y2)
+{
+  return m_world->GetPopulation().CountAvatars(x1, y1, x2, y2);
+}
+
 void cPopulationInterface::TriggerDoUpdates(cAvidaContext& ctx)
 {
   m_world->GetPopulation().TriggerDoUpdates(ctx);
@@ -125,6 +125,9 @@ public:
   int GetCurrPeakY(cAvidaContext& ctx, int res_id);
   int GetFrozenPeakX(cAvidaContext& ctx, int res_id); 
   int GetFrozenPeakY(cAvidaContext& ctx, int res_id);
+  int CountFrozenResCells(int res_id, int x1, int y1, int x2, int y2);
+  int CountOccupiedCells(int x1, int y1, int x2, int y2);
+  int CountAVs(int x1, int y1, int x2, int y2);
   cResourceCount* GetResourceCount();
   void TriggerDoUpdates(cAvidaContext& ctx);
   void UpdateResources(cAvidaContext& ctx, const Apto::Array<double>& res_change);
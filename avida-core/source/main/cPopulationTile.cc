@@ -0,0 +1,162 @@
+/*
+ *  cPopulationTile.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPopulationTile.h"
+
+#include "cAvidaContext.h"
+#include "cBatchedScheduler.h"
+#include "cChunkedFile.h"
+#include "cHardwareBase.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+#include "cPopulation.h"
+#include "cPopulationCell.h"
+
+
+cPopulationTile::cPopulationTile(int tile_id, int deme_id, const Apto::Array<int>& cells, Apto::PriorityScheduler* scheduler, int seed)
+: m_id(tile_id), m_deme_id(deme_id), m_cells(cells), m_scheduler(scheduler), m_rng(seed), m_budget(0), m_executed(0), m_time_used(0.0)
+{
+  const int num_cells = m_cells.GetSize();
+  m_priority.ResizeClear(num_cells);
+  m_owed.ResizeClear(num_cells);
+  m_owed_org.ResizeClear(num_cells);
+  m_blocked.ResizeClear(num_cells);
+  m_priority.SetAll(0.0);
+  m_owed.SetAll(0);
+  m_owed_org.SetAll(-1);
+  m_blocked.SetAll(false);
+}
+
+cPopulationTile::~cPopulationTile()
+{
+  delete m_scheduler;
+}
+
+
+void cPopulationTile::AdjustPriority(int local_id, double priority)
+{
+  m_priority[local_id] = priority;
+  m_scheduler->AdjustPriority(local_id, priority);
+}
+
+double cPopulationTile::GetTotalPriority() const
+{
+  // Summed fresh each update rather than maintained incrementally, so that round-off cannot drift across a long run
+  double total = 0.0;
+  for (int i = 0; i < m_priority.GetSize(); i++) total += m_priority[i];
+  return total;
+}
+
+int cPopulationTile::GetNumActive() const
+{
+  int active = 0;
+  for (int i = 0; i < m_priority.GetSize(); i++) if (m_priority[i] > 0.0) active++;
+  return active;
+}
+
+
+void cPopulationTile::SaveState(cChunkBuffer& buf)
+{
+  buf.PutDoubleArray(m_priority);
+  buf.PutIntArray(m_owed);
+  buf.PutIntArray(m_owed_org);
+  buf.PutBoolArray(m_blocked);
+  buf.PutIntArray(m_catchup);
+  buf.PutRNG(m_rng);
+  
+  cBatchedScheduler* scheduler = dynamic_cast<cBatchedScheduler*>(m_scheduler);
+  assert(scheduler);
+  scheduler->SaveState(buf);
+}
+
+bool cPopulationTile::LoadState(cChunkBuffer& buf)
+{
+  const int num_cells = m_cells.GetSize();
+  if (!buf.GetDoubleArray(m_priority) || !buf.GetIntArray(m_owed) || !buf.GetIntArray(m_owed_org)) return false;
+  if (!buf.GetBoolArray(m_blocked) || !buf.GetIntArray(m_catchup) || !buf.GetRNG(m_rng)) return false;
+  if (m_priority.GetSize() != num_cells || m_owed.GetSize() != num_cells || m_owed_org.GetSize() != num_cells ||
+      m_blocked.GetSize() != num_cells) return false;
+  for (int i = 0; i < m_catchup.GetSize(); i++) if (m_catchup[i] < 0 || m_catchup[i] >= num_cells) return false;
+  m_deferred.Resize(0);
+  
+  cBatchedScheduler* scheduler = dynamic_cast<cBatchedScheduler*>(m_scheduler);
+  return scheduler && scheduler->LoadState(buf);
+}
+
+
+void cPopulationTile::ProcessPhase(cPopulation& pop, cAvidaContext& ctx, bool first_phase)
+{
+  m_executed = 0;
+  m_time_used = 0.0;
+
+  if (first_phase) {
+    cBatchedScheduler* batched_scheduler = dynamic_cast<cBatchedScheduler*>(m_scheduler);
+    if (batched_scheduler) batched_scheduler->Flush();
+    
+    for (int i = 0; i < m_budget; i++) {
+      const int local_id = m_scheduler->Next();
+      if (local_id < 0) break;
+      processCycle(pop, ctx, local_id);
+    }
+    return;
+  }
+
+  // Catch-up phase: hand out the cycles owed to the organisms that were just committed, in order of their deferral.
+  // A later commit in the same barrier (a birth, or a deme replication) may have replaced the organism, voiding its debt.
+  for (int i = 0; i < m_catchup.GetSize(); i++) {
+    const int local_id = m_catchup[i];
+    const cPopulationCell& cell = pop.GetCell(m_cells[local_id]);
+    if (!cell.IsOccupied() || cell.GetOrganism()->GetID() != m_owed_org[local_id]) {
+      m_owed[local_id] = 0;
+      continue;
+    }
+    while (m_owed[local_id] > 0 && !m_blocked[local_id]) {
+      m_owed[local_id]--;
+      processCycle(pop, ctx, local_id);
+    }
+  }
+  m_catchup.Resize(0);
+}
+
+
+void cPopulationTile::processCycle(cPopulation& pop, cAvidaContext& ctx, int local_id)
+{
+  // Blocked organisms accumulate their scheduled cycles until their pending instruction has been committed
+  if (m_blocked[local_id]) {
+    m_owed[local_id]++;
+    return;
+  }
+
+  cPopulationCell& cell = pop.GetCell(m_cells[local_id]);
+  if (!cell.IsOccupied()) return;
+
+  cOrganism* org = cell.GetOrganism();
+  if (cell.GetHardware()->SingleProcess(ctx, true)) {
+    m_executed++;
+    m_time_used += 1.0 / org->GetPhenotype().GetMerit().GetDouble();
+  } else {
+    // Instruction stalled (or the organism is due to die), defer it to the barrier
+    m_blocked[local_id] = true;
+    m_owed[local_id]++;
+    m_owed_org[local_id] = org->GetID();
+    m_deferred.Push(local_id);
+  }
+}
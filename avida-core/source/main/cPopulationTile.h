@@ -0,0 +1,103 @@
+/*
+ *  cPopulationTile.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cPopulationTile_h
+#define cPopulationTile_h
+
+#include "avida/core/Types.h"
+
+#include "apto/rng.h"
+#include "apto/scheduler.h"
+
+class cAvidaContext;
+class cChunkBuffer;
+class cPopulation;
+
+
+// A rectangular region of the population grid that is processed independently during parallel updates.
+//
+// Each tile owns a scheduler over its own cells and a private RNG stream.  During the parallel phase of an update the
+// tile only executes instructions speculatively (those not flagged STALL, and therefore local to the organism).  When an
+// organism reaches an instruction that may interact with the rest of the world (divide, IO, movement, messaging...) the
+// organism is blocked and its cell is deferred.  Deferred cells are committed serially, in tile order, at the barrier
+// between phases, after which any cycles the blocked organisms were owed are executed in a catch-up phase.
+//
+// With PARALLEL_UPDATE 1 the tiles are rectangles of the grid of a single deme; with PARALLEL_UPDATE 2 each deme is one
+// tile, so that every deme has its own scheduler and random stream.
+
+class cPopulationTile
+{
+  friend class cPopulation;
+
+private:
+  int m_id;
+  int m_deme_id;                            // Deme containing every cell of the tile
+  Apto::Array<int> m_cells;                 // Global cell IDs, indexed by local cell ID
+  Apto::Array<double> m_priority;           // Current scheduling priority of each local cell
+  Apto::PriorityScheduler* m_scheduler;
+  Apto::RNG::AvidaRNG m_rng;
+
+  int m_budget;                             // CPU cycles allotted to this tile for the current update
+  int m_executed;                           // Cycles executed during the current phase
+  double m_time_used;                       // Sum of 1/merit credit for executed cycles (deme time used accounting)
+
+  Apto::Array<int> m_owed;                  // Cycles owed to each (blocked) local cell
+  Apto::Array<int> m_owed_org;              // ID of the organism the cycles are owed to
+  Apto::Array<bool> m_blocked;              // Cell is waiting on a commit
+  Apto::Array<int, Apto::Smart> m_deferred; // Local cells awaiting commit, in order of deferral
+  Apto::Array<int, Apto::Smart> m_catchup;  // Local cells committed at the last barrier that may still be owed cycles
+
+
+  cPopulationTile(); // @not_implemented
+  cPopulationTile(const cPopulationTile&); // @not_implemented
+  cPopulationTile& operator=(const cPopulationTile&); // @not_implemented
+
+public:
+  cPopulationTile(int tile_id, int deme_id, const Apto::Array<int>& cells, Apto::PriorityScheduler* scheduler, int seed);
+  ~cPopulationTile();
+
+  int GetID() const { return m_id; }
+  int GetDemeID() const { return m_deme_id; }
+  int GetSize() const { return m_cells.GetSize(); }
+  int GetCellID(int local_id) const { return m_cells[local_id]; }
+
+  void AdjustPriority(int local_id, double priority);
+  double GetTotalPriority() const;
+  int GetNumActive() const;
+
+  Apto::Random& GetRandom() { return m_rng; }
+
+  // Snapshot state between updates: priorities, cycles still owed, the random stream (which saving reseeds) and the
+  // scheduler (which must be a batched scheduler, see cPopulation::CheckSnapshotSupport)
+  void SaveState(cChunkBuffer& buf);
+  bool LoadState(cChunkBuffer& buf);
+
+  void SetBudget(int budget) { m_budget = budget; }
+  bool HasDeferred() const { return m_deferred.GetSize() > 0; }
+
+  // Execute this tile's share of the update (first phase) or the cycles owed to organisms committed at the last barrier
+  void ProcessPhase(cPopulation& pop, cAvidaContext& ctx, bool first_phase);
+
+private:
+  void processCycle(cPopulation& pop, cAvidaContext& ctx, int local_id);
+};
+
+#endif
@@ -21,8 +21,10 @@
  */
 
 #include "cResourceCount.h"
+#include "cChunkedFile.h"
 #include "cResource.h"
 #include "cGradientCount.h"
+#include "cThreadPool.h"
 #include "cWorld.h"
 #include "cStats.h"
 
@@ -37,71 +39,12 @@ const double cResourceCount::EPSILON (1.0e-15);
 const int cResourceCount::PRECALC_DISTANCE(100);
 
 
-void FlowMatter(cSpatialCountElem &elem1, cSpatialCountElem &elem2, 
-                double inxdiffuse, 
-                double inydiffuse, double inxgravity, double inygravity,
-                int xdist, int ydist, double dist) {
-
-  /* Routine to calculate the amount of flow from one Element to another.
-     Amount of flow is a function of:
-
-       1) Amount of material in each cell (will try to equalize)
-       2) Distance between each cell
-       3) x and y "gravity"
-
-     This method only effect the delta amount of each element.  The State
-     method will need to be called at the end of each time step to complete
-     the movement of material.
-  */
-
-  double  diff, flowamt, xgravity, xdiffuse, ygravity,  ydiffuse;
-
-  if (((elem1.amount == 0.0) && (elem2.amount == 0.0)) && (dist < 0.0)) return;
-  diff = (elem1.amount - elem2.amount);
-  if (xdist != 0) {
-
-    /* if there is material to be effected by x gravity */
-
-    if (((xdist>0) && (inxgravity>0.0)) || ((xdist<0) && (inxgravity<0.0))) {
-      xgravity = elem1.amount * fabs(inxgravity)/3.0;
-    } else {
-      xgravity = -elem2.amount * fabs(inxgravity)/3.0;
-    }
-    
-    /* Diffusion uses the diffusion constant x half the difference (as the 
-       elements attempt to equalize) / the number of possible neighbors (8) */
-
-    xdiffuse = inxdiffuse * diff / 16.0;
-  } else {
-    xdiffuse = 0.0;
-    xgravity = 0.0;
-  }  
-  if (ydist != 0) {
-
-    /* if there is material to be effected by y gravity */
-
-    if (((ydist>0) && (inygravity>0.0)) || ((ydist<0) && (inygravity<0.0))) {
-      ygravity = elem1.amount * fabs(inygravity)/3.0;
-    } else {
-      ygravity = -elem2.amount * fabs(inygravity)/3.0;
-    }
-    ydiffuse = inydiffuse * diff / 16.0;
-  } else {
-    ydiffuse = 0.0;
-    ygravity = 0.0;
-  }  
-
-  flowamt = ((xdiffuse + ydiffuse + xgravity + ygravity)/
-             (fabs(xdist*1.0) + fabs(ydist*1.0)))/dist;
-  elem1.delta -= flowamt;
-  elem2.delta += flowamt;
-}
-
 cResourceCount::cResourceCount(int num_resources)
   : update_time(0.0)
   , spatial_update_time(0.0)
   , m_last_updated(0)
   , m_spatial_update(0)
+  , m_thread_pool(NULL)
 {
   if(num_resources > 0) {
     SetSize(num_resources);
@@ -110,7 +53,7 @@ cResourceCount::cResourceCount(int num_resources)
   return;
 }
 
-cResourceCount::cResourceCount(const cResourceCount &rc) {
+cResourceCount::cResourceCount(const cResourceCount &rc) : m_thread_pool(NULL) {
   *this = rc;
 
   return;
@@ -533,7 +476,7 @@ void cResourceCount::SetDecay(const cString& name, const double _decay)
   }
 }
 
-void cResourceCount::Update(double in_time) 
+void cResourceCount::Update(double in_time) const
 { 
   update_time += in_time;
   spatial_update_time += in_time;
@@ -590,6 +533,13 @@ double cResourceCount::GetFrozenCellResVal(cAvidaContext& ctx, int cell_id, int
   else return spatial_resource_count[res_id]->GetAmount(cell_id);
 }
 
+int cResourceCount::CountFrozenResCells(int res_id, int x1, int y1, int x2, int y2) const
+// Number of cells holding any of a spatial resource along a run of one row or column, without updating.
+{
+  if (geometry[res_id] == nGeometry::GLOBAL || geometry[res_id]==nGeometry::PARTIAL) return -1;
+  return spatial_resource_count[res_id]->CountPresent(x1, y1, x2, y2);
+}
+
 double cResourceCount::GetCellResVal(cAvidaContext& ctx, int cell_id, int res_id) const
 // This differs from GetCellResources by only pulling for res of interest.
 {
@@ -655,7 +605,7 @@ void cResourceCount::ModifyCell(cAvidaContext& ctx, const Apto::Array<double> &
         resource_count[i] += res_change[i];
       assert(resource_count[i] >= 0.0);
     } else {
-      double temp = spatial_resource_count[i]->Element(cell_id).GetAmount();
+      double temp = spatial_resource_count[i]->GetAmount(cell_id);
       spatial_resource_count[i]->Rate(cell_id, res_change[i]);
       /* Ideally the state of the cell's resource should not be set till
          the end of the update so that all processes (inflow, outflow, 
@@ -664,10 +614,10 @@ void cResourceCount::ModifyCell(cAvidaContext& ctx, const Apto::Array<double> &
          the organism demand to work immediately on the state of the resource */ 
     
       spatial_resource_count[i]->State(cell_id);
-      if(spatial_resource_count[i]->Element(cell_id).GetAmount() != temp){
+      if(spatial_resource_count[i]->GetAmount(cell_id) != temp){
         spatial_resource_count[i]->SetModified(true);
       }
-      assert(spatial_resource_count[i]->Element(cell_id).GetAmount() >= 0.0);
+      assert(spatial_resource_count[i]->GetAmount(cell_id) >= 0.0);
     }
   }
 }
@@ -758,6 +708,9 @@ void cResourceCount::DoUpdates(cAvidaContext& ctx, bool global_only) const
   // Determine how many update steps have progressed
   int num_steps = (int) (update_time / UPDATE_STEP);
 
+  // Nothing is due, leave everything untouched (parallel updates read resources from several threads at once)
+  if (num_steps == 0 && (global_only || m_spatial_update <= m_last_updated)) return;
+
   // Preserve remainder of update_time
   update_time -=  num_steps * UPDATE_STEP;
 
@@ -781,24 +734,117 @@ void cResourceCount::DoUpdates(cAvidaContext& ctx, bool global_only) const
   
   if (global_only) return;
 
+  // With threads available, resources that can split their updates start them in order (so random numbers are drawn
+  // exactly as they would be serially) and finish them together, in parallel, before any later resource that cannot
+  const bool split_updates = (m_thread_pool != NULL && m_thread_pool->GetNumThreads() > 1);
+  Apto::Array<int> split_res;
+
   // If one (or more) complete update has occured update the spatial resources
   while (m_spatial_update > m_last_updated) {
     m_last_updated++;
     for (int i = 0; i < resource_count.GetSize(); i++) {
      if (geometry[i] != nGeometry::GLOBAL && geometry[i] != nGeometry::PARTIAL) {
-        spatial_resource_count[i]->UpdateCount(ctx);
-        spatial_resource_count[i]->Source(inflow_rate[i]);
-        spatial_resource_count[i]->Sink(decay_rate[i]);
-        if (spatial_resource_count[i]->GetCellListSize() > 0) {
-          spatial_resource_count[i]->CellInflow();
-          spatial_resource_count[i]->CellOutflow();
+        if (split_updates && spatial_resource_count[i]->CanSplitUpdateCount()) {
+          spatial_resource_count[i]->BeginUpdateCount(ctx);
+          split_res.Push(i);
+          continue;
         }
-        spatial_resource_count[i]->FlowAll();
-        spatial_resource_count[i]->StateAll();
-        // BDB: resource_count[i] = spatial_resource_count[i]->SumAll();
+        finishSplitUpdates(split_res);
+        spatial_resource_count[i]->UpdateCount(ctx);
+        flowSpatialResource(i);
       }
     }
+    finishSplitUpdates(split_res);
+  }
+}
+
+void cResourceCount::flowSpatialResource(int res_id) const
+{
+  spatial_resource_count[res_id]->Source(inflow_rate[res_id]);
+  spatial_resource_count[res_id]->Sink(decay_rate[res_id]);
+  if (spatial_resource_count[res_id]->GetCellListSize() > 0) {
+    spatial_resource_count[res_id]->CellInflow();
+    spatial_resource_count[res_id]->CellOutflow();
+  }
+  spatial_resource_count[res_id]->FlowAll(m_thread_pool);
+  spatial_resource_count[res_id]->StateAll();
+  // BDB: resource_count[res_id] = spatial_resource_count[res_id]->SumAll();
+}
+
+
+class cResourceCount::cFinishUpdateTask : public cThreadPool::cTask
+{
+private:
+  Apto::Array<cSpatialResCount*>& m_resources;
+  const Apto::Array<int>& m_res_ids;
+  
+public:
+  cFinishUpdateTask(Apto::Array<cSpatialResCount*>& resources, const Apto::Array<int>& res_ids)
+    : m_resources(resources), m_res_ids(res_ids) { ; }
+  
+  void Run(int item) { m_resources[m_res_ids[item]]->FinishUpdateCount(); }
+};
+
+// Finishes the split updates of the given resources in parallel, then applies their flows in resource order
+void cResourceCount::finishSplitUpdates(Apto::Array<int>& res_ids) const
+{
+  if (res_ids.GetSize() == 0) return;
+  
+  cFinishUpdateTask task(spatial_resource_count, res_ids);
+  m_thread_pool->Execute(task, res_ids.GetSize());
+  for (int i = 0; i < res_ids.GetSize(); i++) flowSpatialResource(res_ids[i]);
+  res_ids.Resize(0);
+}
+
+static void saveMatrix(cChunkBuffer& buf, const tMatrix<double>& matrix)
+{
+  buf.PutVarUInt(matrix.GetNumRows());
+  buf.PutVarUInt(matrix.GetNumRows() ? matrix.GetNumCols() : 0);
+  for (int r = 0; r < matrix.GetNumRows(); r++) {
+    for (int c = 0; c < matrix.GetNumCols(); c++) buf.PutDouble(matrix(r, c));
+  }
+}
+
+static bool loadMatrix(cChunkBuffer& buf, tMatrix<double>& matrix)
+{
+  const int rows = (int)buf.GetVarUInt();
+  const int cols = (int)buf.GetVarUInt();
+  if (buf.Fail() || rows != matrix.GetNumRows() || (rows && cols != matrix.GetNumCols())) return false;
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < cols; c++) matrix(r, c) = buf.GetDouble();
+  }
+  return !buf.Fail();
+}
+
+void cResourceCount::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutDoubleArray(resource_count);
+  buf.PutDoubleArray(decay_rate);
+  buf.PutDoubleArray(inflow_rate);
+  saveMatrix(buf, decay_precalc);
+  saveMatrix(buf, inflow_precalc);
+  buf.PutDouble(update_time);
+  buf.PutDouble(spatial_update_time);
+  buf.PutVarInt(m_last_updated);
+  buf.PutVarInt(m_spatial_update);
+  for (int i = 0; i < spatial_resource_count.GetSize(); i++) spatial_resource_count[i]->SaveState(buf);
+}
+
+bool cResourceCount::LoadState(cChunkBuffer& buf)
+{
+  const int num_resources = resource_count.GetSize();
+  if (!buf.GetDoubleArray(resource_count) || resource_count.GetSize() != num_resources) return false;
+  if (!buf.GetDoubleArray(decay_rate) || decay_rate.GetSize() != num_resources) return false;
+  if (!buf.GetDoubleArray(inflow_rate) || inflow_rate.GetSize() != num_resources) return false;
+  if (!loadMatrix(buf, decay_precalc) || !loadMatrix(buf, inflow_precalc)) return false;
+  update_time = buf.GetDouble();
+  spatial_update_time = buf.GetDouble();
+  m_last_updated = (int)buf.GetVarInt();
+  m_spatial_update = (int)buf.GetVarInt();
+  for (int i = 0; i < spatial_resource_count.GetSize(); i++) {
+    if (!spatial_resource_count[i]->LoadState(buf)) return false;
   }
+  return !buf.Fail();
 }
 
 void cResourceCount::ReinitializeResources(cAvidaContext& ctx, double additional_resource)
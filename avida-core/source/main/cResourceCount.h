@@ -31,6 +31,8 @@
 #include "tMatrix.h"
 #include "nGeometry.h"
 
+class cChunkBuffer;
+class cThreadPool;
 class cWorld;
 
 
@@ -56,8 +58,14 @@ private:
   mutable double spatial_update_time;
   mutable int m_last_updated;
   mutable int m_spatial_update;
+  
+  cThreadPool* m_thread_pool;     // Optional, used to spread diffusion of large spatial resources across threads
 
   void DoUpdates(cAvidaContext& ctx, bool global_only = false) const;         // Update resource count based on update time
+  void flowSpatialResource(int res_id) const;   // Inflow, outflow and diffusion of a spatial resource after UpdateCount
+  void finishSplitUpdates(Apto::Array<int>& res_ids) const;
+
+  class cFinishUpdateTask;
 
   // A few constants to describe update process...
   static const double UPDATE_STEP;   // Fraction of an update per step
@@ -126,7 +134,7 @@ public:
   double GetDecay(const cString& name);
   void SetDecay(const cString& name, const double _decay);
   
-  void Update(double in_time);
+  void Update(double in_time) const;
 
   int GetSize(void) const { return resource_count.GetSize(); }
   const Apto::Array<double>& ReadResources(void) const { return resource_count; }
@@ -134,6 +142,7 @@ public:
   const Apto::Array<double>& GetCellResources(int cell_id, cAvidaContext& ctx) const;
   const Apto::Array<double>& GetFrozenResources(cAvidaContext& ctx, int cell_id) const;
   double GetFrozenCellResVal(cAvidaContext& ctx, int cell_id, int res_id) const;
+  int CountFrozenResCells(int res_id, int x1, int y1, int x2, int y2) const;   // -1 for non-spatial resources
   double GetCellResVal(cAvidaContext& ctx, int cell_id, int res_id) const;
   const Apto::Array<int>& GetResourcesGeometry() const;
   int GetResourceGeometry(int res_id) const { return geometry[res_id]; }
@@ -148,6 +157,10 @@ public:
   cSpatialResCount GetSpatialResource(int id) { return *(spatial_resource_count[id]); }
   const cSpatialResCount& GetSpatialResource(int id) const { return *(spatial_resource_count[id]); }
   void ReinitializeResources(cAvidaContext& ctx, double additional_resource);
+
+  // Snapshot state: global amounts, rates, pending update time and every spatial grid
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
   double GetInitialResourceValue(int resourceID) const { return resource_initial[resourceID]; }
   const cString& GetResName(int id) const { return resource_name[id]; }
   bool IsSpatial(int id) const { return ((geometry[id] != nGeometry::GLOBAL) && (geometry[id] != nGeometry::PARTIAL)); }
@@ -164,6 +177,7 @@ public:
   int GetMaxUsedY(int res_id);
   
   void SetSpatialUpdate(int update) { m_spatial_update = update; }
+  void SetThreadPool(cThreadPool* pool) { m_thread_pool = pool; }
   void UpdateGlobalResources(cAvidaContext& ctx) { DoUpdates(ctx, true); }
   void UpdateRandomResources(cAvidaContext& ctx) { DoUpdates(ctx, false); }
   void UpdateResources(cAvidaContext& ctx) { DoUpdates(ctx, false); }
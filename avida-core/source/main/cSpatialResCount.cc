@@ -22,6 +22,8 @@
 #include "cSpatialResCount.h"
 
 #include "AvidaTools.h"
+#include "cChunkedFile.h"
+#include "cThreadPool.h"
 #include "nGeometry.h"
 
 #include <cmath>
@@ -29,14 +31,163 @@
 using namespace std;
 using namespace AvidaTools;
 
+
+const int cSpatialResCount::PARALLEL_FLOW_CELLS(128 * 128);
+
+
+namespace {
+  const double SQRT2 = sqrt(2.0);
+  
+  struct sFlowParams
+  {
+    double xdiffuse;
+    double ydiffuse;
+    double xgravity;
+    double ygravity;
+  };
+  
+  /* The gravity contribution of a cell to any of its flows depends only on its own amount */
+  
+  inline double GravityTerm(double amount, double ingravity) { return amount * fabs(ingravity) / 3.0; }
+  
+  /* Routine to calculate the amount of flow from one cell to the neighbor that is XDIST, YDIST away from it.
+     Amount of flow is a function of:
+
+       1) Amount of material in each cell (will try to equalize)
+       2) Distance between each cell
+       3) x and y "gravity"
+
+     The arithmetic matches the original per-element FlowMatter operation for operation, so results are identical to
+     the bit regardless of which kernel path computes a given flow.
+  */
+  
+  template <int XDIST, int YDIST>
+  inline double EdgeFlow(double amount1, double amount2, double xgrav1, double xgrav2, double ygrav1, double ygrav2,
+                         const sFlowParams& p)
+  {
+    double xgravity, xdiffuse, ygravity, ydiffuse;
+    
+    const double diff = (amount1 - amount2);
+    if (XDIST != 0) {
+      
+      /* if there is material to be effected by x gravity */
+      
+      if (((XDIST > 0) && (p.xgravity > 0.0)) || ((XDIST < 0) && (p.xgravity < 0.0))) {
+        xgravity = xgrav1;
+      } else {
+        xgravity = -xgrav2;
+      }
+      
+      /* Diffusion uses the diffusion constant x half the difference (as the
+         elements attempt to equalize) / the number of possible neighbors (8) */
+      
+      xdiffuse = p.xdiffuse * diff / 16.0;
+    } else {
+      xdiffuse = 0.0;
+      xgravity = 0.0;
+    }
+    if (YDIST != 0) {
+      
+      /* if there is material to be effected by y gravity */
+      
+      if (((YDIST > 0) && (p.ygravity > 0.0)) || ((YDIST < 0) && (p.ygravity < 0.0))) {
+        ygravity = ygrav1;
+      } else {
+        ygravity = -ygrav2;
+      }
+      ydiffuse = p.ydiffuse * diff / 16.0;
+    } else {
+      ydiffuse = 0.0;
+      ygravity = 0.0;
+    }
+    
+    const double dist = (XDIST != 0 && YDIST != 0) ? SQRT2 : 1.0;
+    return ((xdiffuse + ydiffuse + xgravity + ygravity) / (fabs(XDIST * 1.0) + fabs(YDIST * 1.0))) / dist;
+  }
+  
+  
+  /* Because flow is two way, each cell only computes the flow towards half of its neighbors (directions 3 through 6
+     of the original pointer layout, clockwise from the cell to the right):
+   
+       3 = (+1,  0)   4 = (+1, +1)   5 = ( 0, +1)   6 = (-1, +1)
+  */
+  
+  const int FLOW_DIR_X[4] = { +1, +1,  0, -1 };
+  const int FLOW_DIR_Y[4] = {  0, +1, +1, +1 };
+  
+  inline double DirFlow(int dir, double amount1, double amount2, const sFlowParams& p)
+  {
+    const double xg1 = GravityTerm(amount1, p.xgravity), xg2 = GravityTerm(amount2, p.xgravity);
+    const double yg1 = GravityTerm(amount1, p.ygravity), yg2 = GravityTerm(amount2, p.ygravity);
+    switch (dir) {
+      case 0: return EdgeFlow<+1,  0>(amount1, amount2, xg1, xg2, yg1, yg2, p);
+      case 1: return EdgeFlow<+1, +1>(amount1, amount2, xg1, xg2, yg1, yg2, p);
+      case 2: return EdgeFlow< 0, +1>(amount1, amount2, xg1, xg2, yg1, yg2, p);
+      default: return EdgeFlow<-1, +1>(amount1, amount2, xg1, xg2, yg1, yg2, p);
+    }
+  }
+  
+  
+  /* Row kernels, written as flat loops over contiguous arrays so that the compiler can vectorize them */
+  
+  void RowGravity(const double* row, int size, const sFlowParams& p, double* xgrav, double* ygrav)
+  {
+    for (int x = 0; x < size; x++) {
+      xgrav[x] = GravityTerm(row[x], p.xgravity);
+      ygrav[x] = GravityTerm(row[x], p.ygravity);
+    }
+  }
+  
+  /* Flows out of each cell of a row towards its right and lower neighbors, for every cell whose neighbor does not
+     wrap around the sides of the world */
+  
+  void RowOutflows(const double* row, const double* xg, const double* yg,
+                   const double* below, const double* xg_below, const double* yg_below,
+                   int size, const sFlowParams& p, double* east, double* southeast, double* south, double* southwest)
+  {
+    for (int x = 0; x < size - 1; x++) {
+      east[x] = EdgeFlow<+1, 0>(row[x], row[x + 1], xg[x], xg[x + 1], yg[x], yg[x + 1], p);
+    }
+    for (int x = 0; x < size - 1; x++) {
+      southeast[x] = EdgeFlow<+1, +1>(row[x], below[x + 1], xg[x], xg_below[x + 1], yg[x], yg_below[x + 1], p);
+    }
+    for (int x = 0; x < size; x++) {
+      south[x] = EdgeFlow<0, +1>(row[x], below[x], xg[x], xg_below[x], yg[x], yg_below[x], p);
+    }
+    for (int x = 1; x < size; x++) {
+      southwest[x] = EdgeFlow<-1, +1>(row[x], below[x - 1], xg[x], xg_below[x - 1], yg[x], yg_below[x - 1], p);
+    }
+  }
+  
+  
+  /* One addition to (or subtraction from) a cell's delta.  Flows must be applied in the same order as the original
+     scatter loop (by source cell, then direction, with the source's own subtraction first) for the floating point
+     sums to be identical. */
+  
+  struct sFlowEvent
+  {
+    int source;
+    int dir;
+    int incoming;
+    double amount;
+    
+    inline bool operator<(const sFlowEvent& rhs) const
+    {
+      if (source != rhs.source) return source < rhs.source;
+      if (dir != rhs.dir) return dir < rhs.dir;
+      return incoming < rhs.incoming;
+    }
+  };
+}
+
+
 /* Setup a single spatial resource with known flows */
 
 cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry, double inxdiffuse, double inydiffuse,
                                    double inxgravity, double inygravity)
-: grid(inworld_x * inworld_y), m_initial(0.0), m_modified(false)
+: m_amount(inworld_x * inworld_y), m_delta(inworld_x * inworld_y), m_initial(0.0), cell_list_ptr(NULL), m_modified(false), m_present_valid(false)
+, m_changed_min_x(-1), m_changed_min_y(-1), m_changed_max_x(-1), m_changed_max_y(-1)
 {
-  int i;
- 
   xdiffuse = inxdiffuse;
   ydiffuse = inydiffuse;
   xgravity = inxgravity;
@@ -45,20 +196,17 @@ cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry,
   world_y = inworld_y;
   geometry = ingeometry;
   num_cells = world_x * world_y;
-  for (i = 0; i < GetSize(); i++) {
-    cSpatialCountElem tmpelem;
-    grid[i] = tmpelem;
-  } 
+  m_amount.SetAll(0.0);
+  m_delta.SetAll(0.0);
   SetPointers();
 }
 
 /* Setup a single spatial resource using default flow amounts  */
 
 cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry)
-: grid(inworld_x * inworld_y), m_initial(0.0), m_modified(false)
+: m_amount(inworld_x * inworld_y), m_delta(inworld_x * inworld_y), m_initial(0.0), cell_list_ptr(NULL), m_modified(false), m_present_valid(false)
+, m_changed_min_x(-1), m_changed_min_y(-1), m_changed_max_x(-1), m_changed_max_y(-1)
 {
-  int i;
- 
   xdiffuse = 1.0;
   ydiffuse = 1.0;
   xgravity = 0.0;
@@ -67,14 +215,15 @@ cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry)
   world_y = inworld_y;
   geometry = ingeometry;
   num_cells = world_x * world_y;
-  for (i = 0; i < GetSize(); i++) {
-    cSpatialCountElem tmpelem;
-    grid[i] = tmpelem;
-   } 
-   SetPointers();
+  m_amount.SetAll(0.0);
+  m_delta.SetAll(0.0);
+  SetPointers();
 }
 
-cSpatialResCount::cSpatialResCount() : m_initial(0.0), xdiffuse(1.0), ydiffuse(1.0), xgravity(0.0), ygravity(0.0), m_modified(false)
+cSpatialResCount::cSpatialResCount()
+: m_initial(0.0), xdiffuse(1.0), ydiffuse(1.0), xgravity(0.0), ygravity(0.0), world_x(0), world_y(0), num_cells(0)
+, cell_list_ptr(NULL), m_modified(false), m_flow_bounded(false), m_present_valid(false)
+, m_changed_min_x(-1), m_changed_min_y(-1), m_changed_max_x(-1), m_changed_max_y(-1)
 {
   geometry = nGeometry::GLOBAL;
 }
@@ -84,69 +233,25 @@ cSpatialResCount::~cSpatialResCount() { ; }
 
 void cSpatialResCount::ResizeClear(int inworld_x, int inworld_y, int ingeometry)
 {
-  int i;
- 
-  grid.ResizeClear(inworld_x * inworld_y); 
+  m_amount.ResizeClear(inworld_x * inworld_y);
+  m_delta.ResizeClear(inworld_x * inworld_y);
   world_x = inworld_x;
   world_y = inworld_y;
   geometry = ingeometry;
   num_cells = world_x * world_y;
-  for (i = 0; i < GetSize(); i++) {
-    cSpatialCountElem tmpelem;
-    grid[i] = tmpelem;
-   } 
-   SetPointers();
+  m_amount.SetAll(0.0);
+  m_delta.SetAll(0.0);
+  m_present_valid = false;
+  ClearChangedBounds();
+  SetPointers();
 }
 
 void cSpatialResCount::SetPointers()
 {
-  /* Pointer 0 will point to the cell above and to the left the current cell
-     and will go clockwise around the cell.                               */
-
-  int     i,ii;
-  double  SQRT2 = sqrt(2.0);
-
-  /* First treat all cells like they are in a torus */
-
-  for (i = 0; i < GetSize(); i++) {
-    grid[i].SetPtr(0 ,GridNeighbor(i, world_x, world_y, -1, -1), -1, -1, SQRT2);
-    grid[i].SetPtr(1 ,GridNeighbor(i, world_x, world_y,  0, -1),  0, -1, 1.0);
-    grid[i].SetPtr(2 ,GridNeighbor(i, world_x, world_y, +1, -1), +1, -1, SQRT2);
-    grid[i].SetPtr(3 ,GridNeighbor(i, world_x, world_y, +1,  0), +1,  0, 1.0);
-    grid[i].SetPtr(4 ,GridNeighbor(i, world_x, world_y, +1, +1), +1, +1, SQRT2);
-    grid[i].SetPtr(5 ,GridNeighbor(i, world_x, world_y,  0, +1),  0, +1, 1.0);
-    grid[i].SetPtr(6 ,GridNeighbor(i, world_x, world_y, -1, +1), -1, +1, SQRT2);
-    grid[i].SetPtr(7 ,GridNeighbor(i, world_x, world_y, -1,  0), -1,  0, 1.0);
-  }
- 
-  /* Fix links for top, bottom and sides for non-torus */
-  
-  if (geometry == nGeometry::GRID) {
-    /* Top and bottom */
-
-    for (i = 0; i < world_x; i++) {
-      grid[i].SetPtr(0, -99, -99, -99, -99.0);
-      grid[i].SetPtr(1, -99, -99, -99, -99.0);
-      grid[i].SetPtr(2, -99, -99, -99, -99.0);
-      ii = num_cells-1-i;
-      grid[ii].SetPtr(4, -99, -99, -99, -99.0);
-      grid[ii].SetPtr(5, -99, -99, -99, -99.0);
-      grid[ii].SetPtr(6, -99, -99, -99, -99.0);
-    }
+  /* Neighbors are computed on the fly by FlowAll.  All geometries flow as a torus, except GRID, which has no links
+     across the top, bottom and sides of the world. */
 
-    /* fix links for right and left sides */
-
-    for (i = 0; i < world_y; i++) {
-      ii = i * world_x;    
-      grid[ii].SetPtr(0, -99, -99, -99, -99.0);
-      grid[ii].SetPtr(7, -99, -99, -99, -99.0);
-      grid[ii].SetPtr(6, -99, -99, -99, -99.0);
-      ii = ((i + 1) * world_x) - 1;
-      grid[ii].SetPtr(2, -99, -99, -99, -99.0);
-      grid[ii].SetPtr(3, -99, -99, -99, -99.0);
-      grid[ii].SetPtr(4, -99, -99, -99, -99.0);
-    }
-  }
+  m_flow_bounded = (geometry == nGeometry::GRID);
 }
 
 
@@ -222,10 +327,9 @@ void cSpatialResCount::SetCellList(Apto::Array<cCellResource>* in_cell_list_ptr)
     /* Be sure the user entered a valid cell id or if the the program is loading
        the resource for the testCPU that does not have a grid set up */
        
-    if (cell_id >= 0 && cell_id <= grid.GetSize()) {
-      Rate((*cell_list_ptr)[i].GetId(), (*cell_list_ptr)[i].GetInitial());
-      State((*cell_list_ptr)[i].GetId());
-      Element(cell_id).SetInitial((*cell_list_ptr)[i].GetInitial());
+    if (cell_id >= 0 && cell_id < GetSize()) {
+      Rate(cell_id, (*cell_list_ptr)[i].GetInitial());
+      State(cell_id);
     }
   }
 }
@@ -233,8 +337,8 @@ void cSpatialResCount::SetCellList(Apto::Array<cCellResource>* in_cell_list_ptr)
 /* Set the rate variable for one element using the array index */
 
 void cSpatialResCount::Rate(int x, double ratein) const {
-  if (x >= 0 && x < grid.GetSize()) {
-    grid[x].Rate(ratein);
+  if (x >= 0 && x < GetSize()) {
+    m_delta[x] += ratein;
   } else {
     assert(false); // x not valid id
   }
@@ -244,7 +348,7 @@ void cSpatialResCount::Rate(int x, double ratein) const {
 
 void cSpatialResCount::Rate(int x, int y, double ratein) const { 
   if (x >= 0 && x < world_x && y>= 0 && y < world_y) {
-    grid[y * world_x + x].Rate(ratein);
+    m_delta[y * world_x + x] += ratein;
   } else {
     assert(false); // x or y not valid id
   }
@@ -254,8 +358,12 @@ void cSpatialResCount::Rate(int x, int y, double ratein) const {
    the array index */
    
 void cSpatialResCount::State(int x) { 
-  if (x >= 0 && x < grid.GetSize()) {
-    grid[x].State();
+  if (x >= 0 && x < GetSize()) {
+    const double prev_amount = m_amount[x];
+    m_amount[x] += m_delta[x];
+    m_delta[x] = 0.0;
+    notePresence(x, prev_amount);
+    noteChanged(x);
   } else {
     assert(false); // x not valid id
   }
@@ -266,7 +374,7 @@ void cSpatialResCount::State(int x) {
    
 void cSpatialResCount::State(int x, int y) { 
   if (x >= 0 && x < world_x && y >= 0 && y < world_y) {
-    grid[y*world_x + x].State();
+    State(y * world_x + x);
   } else {
     assert(false); // x or y not valid id
   }
@@ -275,8 +383,8 @@ void cSpatialResCount::State(int x, int y) {
 /* Get the state of one element using the array index */
 
 double cSpatialResCount::GetAmount(int x) const { 
-  if (x >= 0 && x < grid.GetSize()) {
-    return grid[x].GetAmount(); 
+  if (x >= 0 && x < GetSize()) {
+    return m_amount[x]; 
   } else {
     return -99.9;
   }
@@ -286,57 +394,185 @@ double cSpatialResCount::GetAmount(int x) const {
 
 double cSpatialResCount::GetAmount(int x, int y) const { 
   if (x >= 0 && x < world_x && y >= 0 && y < world_y) {
-    return grid[y*world_x + x].GetAmount(); 
+    return m_amount[y * world_x + x]; 
   } else {
     return -99.9;
   }
 }
 
 void cSpatialResCount::RateAll(double ratein) {
-
-  int i;
- 
-  for (i = 0; i < num_cells; i++) {
-    grid[i].Rate(ratein);
-  } 
+  for (int i = 0; i < num_cells; i++) m_delta[i] += ratein;
 }
 
 /* For each cell in the grid add the changes stored in the rate variable
    with the total of the resource */
 
 void cSpatialResCount::StateAll() {
-
-  int i;
- 
-  for (i = 0; i < num_cells; i++) {
-    grid[i].State();
+  for (int i = 0; i < num_cells; i++) {
+    m_amount[i] += m_delta[i];
+    m_delta[i] = 0.0;
   } 
+  m_present_valid = false;
+  noteAllChanged();
 }
 
-void cSpatialResCount::FlowAll() {
+
+class cSpatialResCount::cFlowTask : public cThreadPool::cTask
+{
+private:
+  cSpatialResCount& m_res;
+  int m_rows_per_band;
+  
+public:
+  cFlowTask(cSpatialResCount& res, int rows_per_band) : m_res(res), m_rows_per_band(rows_per_band) { ; }
+  
+  void Run(int item)
+  {
+    const int y_begin = item * m_rows_per_band;
+    m_res.flowRows(y_begin, Apto::Min(y_begin + m_rows_per_band, m_res.world_y));
+  }
+};
+
+void cSpatialResCount::FlowAll(cThreadPool* pool) {
 
   // @JEB save time if diffusion and gravity off...
   if ((xdiffuse == 0.0) && (ydiffuse == 0.0) && (xgravity == 0.0) && (ygravity == 0.0)) return;
+  if (num_cells == 0) return;
+  
+  /* Each cell gathers the flows with all eight of its neighbors into its own delta, so rows are independent of one
+     another and may be processed in any order (or concurrently) without changing the result. */
+  
+  if (pool && pool->GetNumThreads() > 1 && num_cells >= PARALLEL_FLOW_CELLS) {
+    const int num_bands = Apto::Min(world_y, pool->GetNumThreads() * 4);
+    const int rows_per_band = (world_y + num_bands - 1) / num_bands;
+    cFlowTask task(*this, rows_per_band);
+    pool->Execute(task, (world_y + rows_per_band - 1) / rows_per_band);
+  } else {
+    flowRows(0, world_y);
+  }
+}
 
-  int     i,k,ii,xdist,ydist;
-  double  dist;
- 
-  for (i = 0; i < num_cells; i++) {
+void cSpatialResCount::flowRows(int y_begin, int y_end)
+{
+  const sFlowParams params = { xdiffuse, ydiffuse, xgravity, ygravity };
+  const double* amount = &m_amount[0];
+  double* delta = &m_delta[0];
+  
+  /* Rows with an above and a below neighbor that do not wrap around the world share a fixed summation order: the flows
+     in from the three cells above and the one to the left, then the flows out to the right and the three cells below.
+     Every other cell, including the first and last of each row, sees wrapped neighbors and is handled individually. */
+  
+  int first = Apto::Max(y_begin, 1);
+  int last = Apto::Min(y_end, world_y - 1);
+  if (world_x < 3 || first > last) first = last = y_end;
+  
+  for (int y = y_begin; y < first; y++) {
+    for (int x = 0; x < world_x; x++) flowCell(x, y);
+  }
+  
+  if (first < last) {
+    // Rolling buffers of per-cell gravity terms (three rows) and outgoing flows (two rows)
+    Apto::Array<double> scratch(14 * world_x);
+    double* xgrav[3];
+    double* ygrav[3];
+    double* out[2][4];
+    for (int i = 0; i < 3; i++) {
+      xgrav[i] = &scratch[(2 * i) * world_x];
+      ygrav[i] = &scratch[(2 * i + 1) * world_x];
+    }
+    for (int i = 0; i < 2; i++) {
+      for (int dir = 0; dir < 4; dir++) out[i][dir] = &scratch[(6 + 4 * i + dir) * world_x];
+    }
+    
+    RowGravity(amount + (first - 1) * world_x, world_x, params, xgrav[(first - 1) % 3], ygrav[(first - 1) % 3]);
+    RowGravity(amount + first * world_x, world_x, params, xgrav[first % 3], ygrav[first % 3]);
+    double** prev = out[(first - 1) % 2];
+    RowOutflows(amount + (first - 1) * world_x, xgrav[(first - 1) % 3], ygrav[(first - 1) % 3],
+                amount + first * world_x, xgrav[first % 3], ygrav[first % 3],
+                world_x, params, prev[0], prev[1], prev[2], prev[3]);
+    
+    for (int y = first; y < last; y++) {
+      const int cur = y % 3, next = (y + 1) % 3;
+      RowGravity(amount + (y + 1) * world_x, world_x, params, xgrav[next], ygrav[next]);
       
-    /* because flow is two way we must check only half the neighbors to 
-       prevent double flow calculations */
-
-    for (k = 3; k <= 6; k++) {
-      ii = grid[i].GetElemPtr(k);
-      xdist = grid[i].GetPtrXdist(k);
-      ydist = grid[i].GetPtrYdist(k);
-      dist = grid[i].GetPtrDist(k);
-      if (ii >= 0) {
-        FlowMatter(grid[i],grid[ii],xdiffuse,ydiffuse,xgravity,ygravity,
-                   xdist, ydist, dist);
+      double** above = out[(y - 1) % 2];
+      double** own = out[y % 2];
+      RowOutflows(amount + y * world_x, xgrav[cur], ygrav[cur], amount + (y + 1) * world_x, xgrav[next], ygrav[next],
+                  world_x, params, own[0], own[1], own[2], own[3]);
+      
+      double* row_delta = delta + y * world_x;
+      const int x_end = world_x - 1;
+      for (int x = 1; x < x_end; x++) {
+        double d = row_delta[x];
+        d += above[1][x - 1];
+        d += above[2][x];
+        d += above[3][x + 1];
+        d += own[0][x - 1];
+        d -= own[0][x];
+        d -= own[1][x];
+        d -= own[2][x];
+        d -= own[3][x];
+        row_delta[x] = d;
       }
+      
+      flowCell(0, y);
+      flowCell(world_x - 1, y);
     }
   }
+  
+  for (int y = last; y < y_end; y++) {
+    for (int x = 0; x < world_x; x++) flowCell(x, y);
+  }
+}
+
+void cSpatialResCount::flowCell(int x, int y)
+{
+  const sFlowParams params = { xdiffuse, ydiffuse, xgravity, ygravity };
+  const int cell_id = y * world_x + x;
+  sFlowEvent events[8];
+  int num_events = 0;
+  
+  for (int dir = 0; dir < 4; dir++) {
+    const int dx = FLOW_DIR_X[dir];
+    const int dy = FLOW_DIR_Y[dir];
+    
+    // Flow out of this cell to its neighbor in this direction
+    int nx = x + dx, ny = y + dy;
+    if (!m_flow_bounded || (nx >= 0 && nx < world_x && ny >= 0 && ny < world_y)) {
+      const int neighbor = Mod(ny, world_y) * world_x + Mod(nx, world_x);
+      sFlowEvent& event = events[num_events++];
+      event.source = cell_id;
+      event.dir = dir;
+      event.incoming = 0;
+      event.amount = DirFlow(dir, m_amount[cell_id], m_amount[neighbor], params);
+    }
+    
+    // Flow into this cell from the neighbor that has this cell in this direction
+    nx = x - dx; ny = y - dy;
+    if (!m_flow_bounded || (nx >= 0 && nx < world_x && ny >= 0 && ny < world_y)) {
+      const int source = Mod(ny, world_y) * world_x + Mod(nx, world_x);
+      sFlowEvent& event = events[num_events++];
+      event.source = source;
+      event.dir = dir;
+      event.incoming = 1;
+      event.amount = DirFlow(dir, m_amount[source], m_amount[cell_id], params);
+    }
+  }
+  
+  // Insertion sort into the original scatter order
+  for (int i = 1; i < num_events; i++) {
+    const sFlowEvent event = events[i];
+    int j = i;
+    for (; j > 0 && event < events[j - 1]; j--) events[j] = events[j - 1];
+    events[j] = event;
+  }
+  
+  double d = m_delta[cell_id];
+  for (int i = 0; i < num_events; i++) {
+    if (events[i].incoming) d += events[i].amount;
+    else d -= events[i].amount;
+  }
+  m_delta[cell_id] = d;
 }
 
 /* Total up all the resources in each cell */
@@ -352,6 +588,20 @@ double cSpatialResCount::SumAll() const{
   return sum;
 }
 
+/* Count the cells holding any of the resource along a run of cells in one row or column */
+
+int cSpatialResCount::CountPresent(int x1, int y1, int x2, int y2) const
+{
+  if (!m_present_valid) {
+    Apto::Array<int> present(num_cells);
+    for (int i = 0; i < num_cells; i++) present[i] = (m_amount[i] > 0.0) ? 1 : 0;
+    m_present.ResizeClear(world_x, world_y);
+    m_present.Build(present);
+    m_present_valid = true;
+  }
+  return m_present.Count(x1, y1, x2, y2);
+}
+
 /* Take a given amount of resource and spread it among all the cells in the 
    inflow rectange */
 
@@ -379,7 +629,7 @@ void cSpatialResCount::CellInflow() const {
     /* Be sure the user entered a valid cell id or if the the program is loading
        the resource for the testCPU that does not have a grid set up */
        
-    if (cell_id >= 0 && cell_id < grid.GetSize()) {
+    if (cell_id >= 0 && cell_id < GetSize()) {
       Rate(cell_id, (*cell_list_ptr)[i].GetInflow());
     }
   }
@@ -415,7 +665,7 @@ void cSpatialResCount::CellOutflow() const {
     /* Be sure the user entered a valid cell id or if the the program is loading
        the resource for the testCPU that does not have a grid set up */
        
-    if (cell_id >= 0 && cell_id < grid.GetSize()) {
+    if (cell_id >= 0 && cell_id < GetSize()) {
       deltaamount = Apto::Max((GetAmount(cell_id) * (*cell_list_ptr)[i].GetOutflow()), 0.0);
     }                     
     Rate((*cell_list_ptr)[i].GetId(), -deltaamount); 
@@ -424,14 +674,77 @@ void cSpatialResCount::CellOutflow() const {
 
 void cSpatialResCount::SetCellAmount(int cell_id, double res)
 {
-  if (cell_id >= 0 && cell_id < grid.GetSize())
+  if (cell_id >= 0 && cell_id < GetSize())
   {
-    Element(cell_id).SetAmount(res);
+    const double prev_amount = m_amount[cell_id];
+    m_amount[cell_id] = res;
+    notePresence(cell_id, prev_amount);
+    noteChanged(cell_id);
   }
 }
 
 
+bool cSpatialResCount::GetChangedBounds(int& min_x, int& min_y, int& max_x, int& max_y) const
+{
+  if (m_changed_min_x == -1) return false;
+  min_x = m_changed_min_x;
+  min_y = m_changed_min_y;
+  max_x = m_changed_max_x;
+  max_y = m_changed_max_y;
+  return true;
+}
+
+void cSpatialResCount::noteAllChanged()
+{
+  if (num_cells == 0) return;
+  m_changed_min_x = 0;
+  m_changed_min_y = 0;
+  m_changed_max_x = world_x - 1;
+  m_changed_max_y = world_y - 1;
+}
+
+
 void cSpatialResCount::ResetResourceCounts()
 {
-  for (int i = 0; i < grid.GetSize(); i++) grid[i].ResetResourceCount(m_initial);
+  for (int i = 0; i < GetSize(); i++) m_amount[i] = m_initial;
+  m_present_valid = false;
+  noteAllChanged();
+  
+  // Cells given by the CELL command start with their own initial amount on top of the common one
+  if (cell_list_ptr == NULL) return;
+  for (int i = 0; i < cell_list_ptr->GetSize(); i++) {
+    const int cell_id = (*cell_list_ptr)[i].GetId();
+    if (cell_id >= 0 && cell_id < GetSize()) m_amount[cell_id] = m_initial + (*cell_list_ptr)[i].GetInitial();
+  }
+}
+
+void cSpatialResCount::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutDoubleArray(m_amount);
+  buf.PutDoubleArray(m_delta);
+  buf.PutDouble(m_initial);
+  buf.PutDouble(xdiffuse);
+  buf.PutDouble(ydiffuse);
+  buf.PutDouble(xgravity);
+  buf.PutDouble(ygravity);
+  buf.PutVarInt(curr_peakx);
+  buf.PutVarInt(curr_peaky);
+  buf.PutBool(m_modified);
+}
+
+bool cSpatialResCount::LoadState(cChunkBuffer& buf)
+{
+  if (!buf.GetDoubleArray(m_amount) || m_amount.GetSize() != num_cells) return false;
+  if (!buf.GetDoubleArray(m_delta) || m_delta.GetSize() != num_cells) return false;
+  m_initial = buf.GetDouble();
+  xdiffuse = buf.GetDouble();
+  ydiffuse = buf.GetDouble();
+  xgravity = buf.GetDouble();
+  ygravity = buf.GetDouble();
+  curr_peakx = (int)buf.GetVarInt();
+  curr_peaky = (int)buf.GetVarInt();
+  m_modified = buf.GetBool();
+  m_present_valid = false;
+  noteAllChanged();
+  return !buf.Fail();
 }
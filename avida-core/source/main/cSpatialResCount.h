@@ -26,14 +26,20 @@
 #define cSpatialResCount_h
 
 #include "cAvidaContext.h"
-#include "cSpatialCountElem.h"
+#include "cGridLineCounts.h"
 #include "cResource.h"
 
+class cChunkBuffer;
+class cThreadPool;
+
 
 class cSpatialResCount
 {
 private:
-  Apto::Array<cSpatialCountElem> grid;
+  // Resource amounts are stored as contiguous, row-major grids.  Changes accumulate in m_delta (via Rate) until they
+  // are folded into m_amount (via State), so that all flows within an update step see the same starting amounts.
+  Apto::Array<double> m_amount;
+  mutable Apto::Array<double> m_delta;
   double m_initial;
   double xdiffuse, ydiffuse;
   double xgravity, ygravity;
@@ -45,6 +51,28 @@ private:
   /* instead of creating a new array use the existing one from cResource */
   Apto::Array<cCellResource> *cell_list_ptr;
   bool m_modified;
+  bool m_flow_bounded;   // GRID geometry has no flow across the world edges, all others wrap as a torus
+
+  // Index of the cells holding any of the resource (amount > 0), for sensors.  It is built when first needed, kept up
+  // to date through changes to single cells, and dropped by changes to the whole grid.
+  mutable cGridLineCounts m_present;
+  mutable bool m_present_valid;
+
+  // Bounding box of the cells changed one at a time since it was last cleared, or the whole grid after a change to
+  // every cell (m_changed_min_x is -1 when nothing has changed), so subclasses can tell which cells may need redoing
+  int m_changed_min_x, m_changed_min_y, m_changed_max_x, m_changed_max_y;
+
+  // Minimum world size (in cells) at which FlowAll splits its rows across an available thread pool
+  static const int PARALLEL_FLOW_CELLS;
+
+  void flowCell(int x, int y);
+  void flowRows(int y_begin, int y_end);
+  inline void notePresence(int cell_id, double prev_amount);
+  inline void noteChanged(int cell_id);
+  void noteAllChanged();
+
+  class cFlowTask;
+  friend class cFlowTask;
   
 public:
   cSpatialResCount();
@@ -58,11 +86,10 @@ public:
   void SetPointers();
   void CheckRanges();
   void SetCellList(Apto::Array<cCellResource> *in_cell_list_ptr);
-  int GetSize() const { return grid.GetSize(); }
+  int GetSize() const { return m_amount.GetSize(); }
   int GetX() const { return world_x; }
   int GetY() const { return world_y; }
   int GetCellListSize() const { return cell_list_ptr->GetSize(); }
-  cSpatialCountElem& Element(int x) { return grid[x]; }
   void Rate(int x, double ratein) const;
   void Rate(int x, int y, double ratein) const;
   void State(int x);
@@ -71,8 +98,9 @@ public:
   double GetAmount(int x, int y) const;
   void RateAll(double ratein); 
   virtual void StateAll();
-  void FlowAll(); 
+  void FlowAll(cThreadPool* pool = NULL);
   double SumAll() const;
+  int CountPresent(int x1, int y1, int x2, int y2) const;   // Cells with amount > 0 in a run of one row or column
   void Source(double amount) const;
   void CellInflow() const;
   void Sink(double percent) const;
@@ -95,6 +123,20 @@ public:
   void SetOutflowY2(int in_outflowY2) { outflowY2 = in_outflowY2; }
   virtual void UpdateCount(cAvidaContext&) { ; }
   void ResetResourceCounts();
+  
+  // Resources whose updates touch nothing outside their own grid may split UpdateCount in two, so that the expensive
+  // part of several of them can run in parallel: BeginUpdateCount does everything that must happen in resource order
+  // (e.g. drawing random numbers), and FinishUpdateCount, which may run on any thread, does the rest.
+  virtual bool CanSplitUpdateCount() const { return false; }
+  virtual void BeginUpdateCount(cAvidaContext& ctx) { UpdateCount(ctx); }
+  virtual void FinishUpdateCount() { ; }
+  
+  bool GetChangedBounds(int& min_x, int& min_y, int& max_x, int& max_y) const;   // False if no cell has changed
+  void ClearChangedBounds() { m_changed_min_x = m_changed_min_y = m_changed_max_x = m_changed_max_y = -1; }
+
+  // Snapshot state: amounts, pending changes and flow settings.  Subclasses add their own dynamics.
+  virtual void SaveState(cChunkBuffer& buf) const;
+  virtual bool LoadState(cChunkBuffer& buf);
   void SetModified(bool in_modified) { m_modified = in_modified; }
   bool GetModified() { return m_modified; }
   
@@ -155,4 +197,27 @@ public:
   virtual int GetMaxUsedY() { return -1; }
 };
 
+
+inline void cSpatialResCount::notePresence(int cell_id, double prev_amount)
+{
+  if (m_present_valid && ((prev_amount > 0.0) != (m_amount[cell_id] > 0.0))) {
+    m_present.Add(cell_id % world_x, cell_id / world_x, (m_amount[cell_id] > 0.0) ? 1 : -1);
+  }
+}
+
+inline void cSpatialResCount::noteChanged(int cell_id)
+{
+  const int x = cell_id % world_x;
+  const int y = cell_id / world_x;
+  if (m_changed_min_x == -1) {
+    m_changed_min_x = m_changed_max_x = x;
+    m_changed_min_y = m_changed_max_y = y;
+    return;
+  }
+  if (x < m_changed_min_x) m_changed_min_x = x;
+  else if (x > m_changed_max_x) m_changed_max_x = x;
+  if (y < m_changed_min_y) m_changed_min_y = y;
+  else if (y > m_changed_max_y) m_changed_max_y = y;
+}
+
 #endif
@@ -28,6 +28,7 @@
 #include "avida/data/Package.h"
 #include "avida/data/Util.h"
 #include "avida/output/File.h"
+#include "cChunkedFile.h"
 
 #include "cEnvironment.h"
 #include "cHardwareBase.h"
@@ -567,6 +568,365 @@ void cStats::RecordBirth(bool breed_true)
   else num_breed_in++;
 }
 
+void cStats::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarInt(m_num_genotypes);
+  buf.PutVarInt(m_threshold_genotypes);
+  buf.PutVarInt(m_update);
+  buf.PutDouble(avida_time);
+  sum_merit.SaveState(buf);
+  sum_mem_size.SaveState(buf);
+  sum_creature_age.SaveState(buf);
+  sum_generation.SaveState(buf);
+  sum_neutral_metric.SaveState(buf);
+  sum_lineage_label.SaveState(buf);
+  sum_copy_mut_rate.SaveState(buf);
+  sum_log_copy_mut_rate.SaveState(buf);
+  sum_div_mut_rate.SaveState(buf);
+  sum_log_div_mut_rate.SaveState(buf);
+  sum_gestation.SaveState(buf);
+  sum_fitness.SaveState(buf);
+  sum_repro_rate.SaveState(buf);
+  rave_true_replication_rate.SaveState(buf);
+  sum_copy_size.SaveState(buf);
+  sum_exe_size.SaveState(buf);
+  buf.PutDouble(max_viable_fitness);
+  buf.PutDouble(max_fitness);
+  buf.PutDouble(max_merit);
+  buf.PutVarInt(max_gestation_time);
+  buf.PutVarInt(max_genome_length);
+  buf.PutDouble(min_fitness);
+  buf.PutDouble(min_merit);
+  buf.PutVarInt(min_gestation_time);
+  buf.PutVarInt(min_genome_length);
+  buf.PutVarInt(num_births);
+  buf.PutVarInt(cumulative_births);
+  buf.PutVarInt(num_deaths);
+  buf.PutVarInt(num_breed_in);
+  buf.PutVarInt(num_breed_true);
+  buf.PutVarInt(num_breed_true_creatures);
+  buf.PutVarInt(num_creatures);
+  buf.PutVarInt(num_executed);
+  buf.PutVarInt(num_parasites);
+  buf.PutVarInt(num_no_birth_creatures);
+  buf.PutVarInt(num_single_thread_creatures);
+  buf.PutVarInt(num_multi_thread_creatures);
+  buf.PutVarInt(m_num_threads);
+  buf.PutVarInt(num_modified);
+  buf.PutVarInt(tot_organisms);
+  buf.PutVarInt(tot_executed);
+  buf.PutIntArray(tasks_host_current);
+  buf.PutIntArray(tasks_host_last);
+  buf.PutIntArray(tasks_parasite_current);
+  buf.PutIntArray(tasks_parasite_last);
+  buf.PutVarInt(num_kabooms);
+  buf.PutVarInt(num_kabooms_pre);
+  buf.PutVarInt(num_kabooms_post);
+  buf.PutVarInt(num_kaboom_kills);
+  buf.PutVarInt(num_sa_kin);
+  buf.PutVarInt(num_sa_notkin);
+  buf.PutVarInt(num_nsa_kin);
+  buf.PutVarInt(num_nsa_notkin);
+  buf.PutDouble(sum_perc_lyse);
+  buf.PutDouble(sum_cpu_cycles);
+  buf.PutIntArray(hd_list);
+  buf.PutVarInt(num_stop_explode);
+  buf.PutVarInt(ave_threshold_ub);
+  buf.PutVarInt(num_quorum);
+  buf.PutVarInt(juv_killed);
+  buf.PutVarInt(num_guard_fail);
+  buf.PutIntArray(task_cur_count);
+  buf.PutIntArray(task_last_count);
+  buf.PutIntArray(task_test_count);
+  buf.PutDoubleArray(task_cur_quality);
+  buf.PutDoubleArray(task_last_quality);
+  buf.PutDoubleArray(task_cur_max_quality);
+  buf.PutDoubleArray(task_last_max_quality);
+  buf.PutIntArray(task_exe_count);
+  buf.PutIntArray(new_task_count);
+  buf.PutIntArray(prev_task_count);
+  buf.PutIntArray(cur_task_count);
+  buf.PutIntArray(new_reaction_count);
+  buf.PutIntArray(task_internal_cur_count);
+  buf.PutIntArray(task_internal_last_count);
+  buf.PutDoubleArray(task_internal_cur_quality);
+  buf.PutDoubleArray(task_internal_last_quality);
+  buf.PutDoubleArray(task_internal_cur_max_quality);
+  buf.PutDoubleArray(task_internal_last_max_quality);
+  buf.PutIntArray(m_reaction_cur_count);
+  buf.PutIntArray(m_reaction_last_count);
+  buf.PutDoubleArray(m_reaction_cur_add_reward);
+  buf.PutDoubleArray(m_reaction_last_add_reward);
+  buf.PutIntArray(m_reaction_exe_count);
+  buf.PutDoubleArray(resource_count);
+  buf.PutIntArray(resource_geometry);
+  buf.PutVarInt(num_resamplings);
+  buf.PutVarInt(num_failedResamplings);
+  buf.PutVarInt(last_update);
+  buf.PutVarInt(sense_size);
+  buf.PutIntArray(sense_last_count);
+  buf.PutIntArray(sense_last_exe_count);
+  buf.PutDoubleArray(avg_trial_fitnesses);
+  buf.PutDouble(avg_competition_fitness);
+  buf.PutDouble(min_competition_fitness);
+  buf.PutDouble(max_competition_fitness);
+  buf.PutDouble(avg_competition_copied_fitness);
+  buf.PutDouble(min_competition_copied_fitness);
+  buf.PutDouble(max_competition_copied_fitness);
+  buf.PutVarInt(num_orgs_replicated);
+  sum_deme_normalized_time_used.SaveState(buf);
+  sum_deme_merit.SaveState(buf);
+  sum_deme_generations_per_lifetime.SaveState(buf);
+  buf.PutVarInt(m_num_occupied_demes);
+  EnergyTestamentToFutureDeme.SaveState(buf);
+  EnergyTestamentToNeighborOrganisms.SaveState(buf);
+  EnergyTestamentToDemeOrganisms.SaveState(buf);
+  EnergyTestamentAcceptedByOrganisms.SaveState(buf);
+  EnergyTestamentAcceptedByDeme.SaveState(buf);
+  buf.PutVarInt(m_spec_total);
+  buf.PutVarInt(m_spec_num);
+  buf.PutVarInt(m_spec_waste);
+  buf.PutVarInt(num_migrations);
+  buf.PutVarInt(m_num_successful_mates);
+  sum_prey_fitness.SaveState(buf);
+  sum_prey_gestation.SaveState(buf);
+  sum_prey_merit.SaveState(buf);
+  sum_prey_creature_age.SaveState(buf);
+  sum_prey_generation.SaveState(buf);
+  sum_prey_size.SaveState(buf);
+  sum_pred_fitness.SaveState(buf);
+  sum_pred_gestation.SaveState(buf);
+  sum_pred_merit.SaveState(buf);
+  sum_pred_creature_age.SaveState(buf);
+  sum_pred_generation.SaveState(buf);
+  sum_pred_size.SaveState(buf);
+  sum_tpred_fitness.SaveState(buf);
+  sum_tpred_gestation.SaveState(buf);
+  sum_tpred_merit.SaveState(buf);
+  sum_tpred_creature_age.SaveState(buf);
+  sum_tpred_generation.SaveState(buf);
+  sum_tpred_size.SaveState(buf);
+  sum_attacks.SaveState(buf);
+  sum_kills.SaveState(buf);
+  buf.PutDouble(prey_entropy);
+  buf.PutDouble(pred_entropy);
+  buf.PutDouble(tpred_entropy);
+  sum_male_fitness.SaveState(buf);
+  sum_male_gestation.SaveState(buf);
+  sum_male_merit.SaveState(buf);
+  sum_male_creature_age.SaveState(buf);
+  sum_male_generation.SaveState(buf);
+  sum_male_size.SaveState(buf);
+  sum_female_fitness.SaveState(buf);
+  sum_female_gestation.SaveState(buf);
+  sum_female_merit.SaveState(buf);
+  sum_female_creature_age.SaveState(buf);
+  sum_female_generation.SaveState(buf);
+  sum_female_size.SaveState(buf);
+  buf.PutIntArray(toptrace);
+  buf.PutIntArray(topnavtraceupdate);
+  buf.PutIntArray(topnavtraceloc);
+  buf.PutIntArray(topnavtracefacing);
+  buf.PutIntArray(topreactions);
+  buf.PutIntArray(topreactioncycles);
+  buf.PutIntArray(topreactionexecs);
+  buf.PutVarInt(topreac);
+  buf.PutVarInt(topcycle);
+  buf.PutVarInt(topid);
+  buf.PutVarInt(topgenid);
+  buf.PutVarInt(toptarget);
+  buf.PutVarInt(topgroup);
+  buf.PutVarInt(topbirthud);
+  buf.PutVarInt(topstart);
+  buf.PutVarInt(toprepro);
+  buf.PutBool(firstnavtrace);
+
+  buf.PutVarUInt(spatial_res_count.GetSize());
+  for (int i = 0; i < spatial_res_count.GetSize(); i++) buf.PutDoubleArray(spatial_res_count[i]);
+}
+
+bool cStats::LoadState(cChunkBuffer& buf)
+{
+  m_num_genotypes = (int)buf.GetVarInt();
+  m_threshold_genotypes = (int)buf.GetVarInt();
+  m_update = (int)buf.GetVarInt();
+  avida_time = buf.GetDouble();
+  if (!sum_merit.LoadState(buf)) return false;
+  if (!sum_mem_size.LoadState(buf)) return false;
+  if (!sum_creature_age.LoadState(buf)) return false;
+  if (!sum_generation.LoadState(buf)) return false;
+  if (!sum_neutral_metric.LoadState(buf)) return false;
+  if (!sum_lineage_label.LoadState(buf)) return false;
+  if (!sum_copy_mut_rate.LoadState(buf)) return false;
+  if (!sum_log_copy_mut_rate.LoadState(buf)) return false;
+  if (!sum_div_mut_rate.LoadState(buf)) return false;
+  if (!sum_log_div_mut_rate.LoadState(buf)) return false;
+  if (!sum_gestation.LoadState(buf)) return false;
+  if (!sum_fitness.LoadState(buf)) return false;
+  if (!sum_repro_rate.LoadState(buf)) return false;
+  if (!rave_true_replication_rate.LoadState(buf)) return false;
+  if (!sum_copy_size.LoadState(buf)) return false;
+  if (!sum_exe_size.LoadState(buf)) return false;
+  max_viable_fitness = buf.GetDouble();
+  max_fitness = buf.GetDouble();
+  max_merit = buf.GetDouble();
+  max_gestation_time = (int)buf.GetVarInt();
+  max_genome_length = (int)buf.GetVarInt();
+  min_fitness = buf.GetDouble();
+  min_merit = buf.GetDouble();
+  min_gestation_time = (int)buf.GetVarInt();
+  min_genome_length = (int)buf.GetVarInt();
+  num_births = (int)buf.GetVarInt();
+  cumulative_births = (int)buf.GetVarInt();
+  num_deaths = (int)buf.GetVarInt();
+  num_breed_in = (int)buf.GetVarInt();
+  num_breed_true = (int)buf.GetVarInt();
+  num_breed_true_creatures = (int)buf.GetVarInt();
+  num_creatures = (int)buf.GetVarInt();
+  num_executed = (int)buf.GetVarInt();
+  num_parasites = (int)buf.GetVarInt();
+  num_no_birth_creatures = (int)buf.GetVarInt();
+  num_single_thread_creatures = (int)buf.GetVarInt();
+  num_multi_thread_creatures = (int)buf.GetVarInt();
+  m_num_threads = (int)buf.GetVarInt();
+  num_modified = (int)buf.GetVarInt();
+  tot_organisms = (int)buf.GetVarInt();
+  tot_executed = (int)buf.GetVarInt();
+  if (!buf.GetIntArray(tasks_host_current)) return false;
+  if (!buf.GetIntArray(tasks_host_last)) return false;
+  if (!buf.GetIntArray(tasks_parasite_current)) return false;
+  if (!buf.GetIntArray(tasks_parasite_last)) return false;
+  num_kabooms = (int)buf.GetVarInt();
+  num_kabooms_pre = (int)buf.GetVarInt();
+  num_kabooms_post = (int)buf.GetVarInt();
+  num_kaboom_kills = (int)buf.GetVarInt();
+  num_sa_kin = (int)buf.GetVarInt();
+  num_sa_notkin = (int)buf.GetVarInt();
+  num_nsa_kin = (int)buf.GetVarInt();
+  num_nsa_notkin = (int)buf.GetVarInt();
+  sum_perc_lyse = buf.GetDouble();
+  sum_cpu_cycles = buf.GetDouble();
+  if (!buf.GetIntArray(hd_list)) return false;
+  num_stop_explode = (int)buf.GetVarInt();
+  ave_threshold_ub = (int)buf.GetVarInt();
+  num_quorum = (int)buf.GetVarInt();
+  juv_killed = (int)buf.GetVarInt();
+  num_guard_fail = (int)buf.GetVarInt();
+  if (!buf.GetIntArray(task_cur_count)) return false;
+  if (!buf.GetIntArray(task_last_count)) return false;
+  if (!buf.GetIntArray(task_test_count)) return false;
+  if (!buf.GetDoubleArray(task_cur_quality)) return false;
+  if (!buf.GetDoubleArray(task_last_quality)) return false;
+  if (!buf.GetDoubleArray(task_cur_max_quality)) return false;
+  if (!buf.GetDoubleArray(task_last_max_quality)) return false;
+  if (!buf.GetIntArray(task_exe_count)) return false;
+  if (!buf.GetIntArray(new_task_count)) return false;
+  if (!buf.GetIntArray(prev_task_count)) return false;
+  if (!buf.GetIntArray(cur_task_count)) return false;
+  if (!buf.GetIntArray(new_reaction_count)) return false;
+  if (!buf.GetIntArray(task_internal_cur_count)) return false;
+  if (!buf.GetIntArray(task_internal_last_count)) return false;
+  if (!buf.GetDoubleArray(task_internal_cur_quality)) return false;
+  if (!buf.GetDoubleArray(task_internal_last_quality)) return false;
+  if (!buf.GetDoubleArray(task_internal_cur_max_quality)) return false;
+  if (!buf.GetDoubleArray(task_internal_last_max_quality)) return false;
+  if (!buf.GetIntArray(m_reaction_cur_count)) return false;
+  if (!buf.GetIntArray(m_reaction_last_count)) return false;
+  if (!buf.GetDoubleArray(m_reaction_cur_add_reward)) return false;
+  if (!buf.GetDoubleArray(m_reaction_last_add_reward)) return false;
+  if (!buf.GetIntArray(m_reaction_exe_count)) return false;
+  if (!buf.GetDoubleArray(resource_count)) return false;
+  if (!buf.GetIntArray(resource_geometry)) return false;
+  num_resamplings = (int)buf.GetVarInt();
+  num_failedResamplings = (int)buf.GetVarInt();
+  last_update = (int)buf.GetVarInt();
+  sense_size = (int)buf.GetVarInt();
+  if (!buf.GetIntArray(sense_last_count)) return false;
+  if (!buf.GetIntArray(sense_last_exe_count)) return false;
+  if (!buf.GetDoubleArray(avg_trial_fitnesses)) return false;
+  avg_competition_fitness = buf.GetDouble();
+  min_competition_fitness = buf.GetDouble();
+  max_competition_fitness = buf.GetDouble();
+  avg_competition_copied_fitness = buf.GetDouble();
+  min_competition_copied_fitness = buf.GetDouble();
+  max_competition_copied_fitness = buf.GetDouble();
+  num_orgs_replicated = (int)buf.GetVarInt();
+  if (!sum_deme_normalized_time_used.LoadState(buf)) return false;
+  if (!sum_deme_merit.LoadState(buf)) return false;
+  if (!sum_deme_generations_per_lifetime.LoadState(buf)) return false;
+  m_num_occupied_demes = (int)buf.GetVarInt();
+  if (!EnergyTestamentToFutureDeme.LoadState(buf)) return false;
+  if (!EnergyTestamentToNeighborOrganisms.LoadState(buf)) return false;
+  if (!EnergyTestamentToDemeOrganisms.LoadState(buf)) return false;
+  if (!EnergyTestamentAcceptedByOrganisms.LoadState(buf)) return false;
+  if (!EnergyTestamentAcceptedByDeme.LoadState(buf)) return false;
+  m_spec_total = (int)buf.GetVarInt();
+  m_spec_num = (int)buf.GetVarInt();
+  m_spec_waste = (int)buf.GetVarInt();
+  num_migrations = (int)buf.GetVarInt();
+  m_num_successful_mates = (int)buf.GetVarInt();
+  if (!sum_prey_fitness.LoadState(buf)) return false;
+  if (!sum_prey_gestation.LoadState(buf)) return false;
+  if (!sum_prey_merit.LoadState(buf)) return false;
+  if (!sum_prey_creature_age.LoadState(buf)) return false;
+  if (!sum_prey_generation.LoadState(buf)) return false;
+  if (!sum_prey_size.LoadState(buf)) return false;
+  if (!sum_pred_fitness.LoadState(buf)) return false;
+  if (!sum_pred_gestation.LoadState(buf)) return false;
+  if (!sum_pred_merit.LoadState(buf)) return false;
+  if (!sum_pred_creature_age.LoadState(buf)) return false;
+  if (!sum_pred_generation.LoadState(buf)) return false;
+  if (!sum_pred_size.LoadState(buf)) return false;
+  if (!sum_tpred_fitness.LoadState(buf)) return false;
+  if (!sum_tpred_gestation.LoadState(buf)) return false;
+  if (!sum_tpred_merit.LoadState(buf)) return false;
+  if (!sum_tpred_creature_age.LoadState(buf)) return false;
+  if (!sum_tpred_generation.LoadState(buf)) return false;
+  if (!sum_tpred_size.LoadState(buf)) return false;
+  if (!sum_attacks.LoadState(buf)) return false;
+  if (!sum_kills.LoadState(buf)) return false;
+  prey_entropy = buf.GetDouble();
+  pred_entropy = buf.GetDouble();
+  tpred_entropy = buf.GetDouble();
+  if (!sum_male_fitness.LoadState(buf)) return false;
+  if (!sum_male_gestation.LoadState(buf)) return false;
+  if (!sum_male_merit.LoadState(buf)) return false;
+  if (!sum_male_creature_age.LoadState(buf)) return false;
+  if (!sum_male_generation.LoadState(buf)) return false;
+  if (!sum_male_size.LoadState(buf)) return false;
+  if (!sum_female_fitness.LoadState(buf)) return false;
+  if (!sum_female_gestation.LoadState(buf)) return false;
+  if (!sum_female_merit.LoadState(buf)) return false;
+  if (!sum_female_creature_age.LoadState(buf)) return false;
+  if (!sum_female_generation.LoadState(buf)) return false;
+  if (!sum_female_size.LoadState(buf)) return false;
+  if (!buf.GetIntArray(toptrace)) return false;
+  if (!buf.GetIntArray(topnavtraceupdate)) return false;
+  if (!buf.GetIntArray(topnavtraceloc)) return false;
+  if (!buf.GetIntArray(topnavtracefacing)) return false;
+  if (!buf.GetIntArray(topreactions)) return false;
+  if (!buf.GetIntArray(topreactioncycles)) return false;
+  if (!buf.GetIntArray(topreactionexecs)) return false;
+  topreac = (int)buf.GetVarInt();
+  topcycle = (int)buf.GetVarInt();
+  topid = (int)buf.GetVarInt();
+  topgenid = (int)buf.GetVarInt();
+  toptarget = (int)buf.GetVarInt();
+  topgroup = (int)buf.GetVarInt();
+  topbirthud = (int)buf.GetVarInt();
+  topstart = (int)buf.GetVarInt();
+  toprepro = (int)buf.GetVarInt();
+  firstnavtrace = buf.GetBool();
+
+  const int num_spatial = (int)buf.GetVarUInt();
+  if (buf.Fail() || num_spatial > buf.GetRemaining()) return false;
+  spatial_res_count.ResizeClear(num_spatial);
+  for (int i = 0; i < num_spatial; i++) {
+    if (!buf.GetDoubleArray(spatial_res_count[i])) return false;
+  }
+  return !buf.Fail();
+}
+
 void cStats::ProcessUpdate()
 {
   // Increment the "avida_time"
@@ -1609,7 +1969,7 @@ void cStats::PrintResWallLocData(const cString& filename, cAvidaContext& ctx)
     df->Endl();
   }
   
-  std::ofstream& fp = df->OFStream();
+  std::ostream& fp = df->OFStream();
   fp << m_update << " ";
   
   const cResourceLib& resLib = m_world->GetEnvironment().GetResourceLib();
@@ -1699,6 +2059,50 @@ void cStats::PrintExtendedTimeData(const cString& filename)
 	df->Endl();
 }
 
+void cStats::PrintPhenotypeCacheData(const cString& filename)
+{
+  Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
+  const cPhenotypeCache& cache = m_world->GetHardwareManager().GetPhenotypeCache();
+
+  df->WriteComment("Avida precalculated phenotype cache data");
+  df->WriteComment("Counts are cumulative over the run");
+  df->WriteTimeStamp();
+
+  const long hits = cache.GetHits();
+  const long lookups = hits + cache.GetMisses();
+
+  df->Write(m_update,                 "update");
+  df->Write(cache.GetCapacity(),      "capacity");
+  df->Write(cache.GetSize(),          "entries");
+  df->Write(hits,                     "hits");
+  df->Write(cache.GetMisses(),        "misses");
+  df->Write(cache.GetEvictions(),     "evictions");
+  df->Write(cache.GetInvalidations(), "invalidations (environment changes)");
+  df->Write((lookups) ? (double)hits / (double)lookups : 0.0, "hit rate");
+  df->Endl();
+}
+
+void cStats::PrintObjectPoolData(const cString& filename)
+{
+  Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
+  const cHardwareManager& hw_mgr = m_world->GetHardwareManager();
+
+  df->WriteComment("Avida organism and hardware allocation data");
+  df->WriteComment("Allocated and reused counts are cumulative; organisms include their phenotypes");
+  df->WriteTimeStamp();
+
+  df->Write(m_update,                       "update");
+  df->Write(hw_mgr.GetHardwareCreated(),    "hardware allocated");
+  df->Write(hw_mgr.GetHardwareReused(),     "hardware reused");
+  df->Write(hw_mgr.GetHardwarePoolSize(),   "idle hardware pooled");
+  df->Write(hw_mgr.GetHardwarePoolPeak(),   "peak idle hardware pooled");
+  df->Write(hw_mgr.GetOrganismsCreated(),   "organisms allocated");
+  df->Write(hw_mgr.GetOrganismsReused(),    "organisms reused");
+  df->Write(hw_mgr.GetOrganismPoolSize(),   "idle organisms pooled");
+  df->Write(hw_mgr.GetOrganismPoolPeak(),   "peak idle organisms pooled");
+  df->Endl();
+}
+
 void cStats::PrintMutationRateData(const cString& filename)
 {
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
@@ -1930,7 +2334,7 @@ void cStats::PrintPredicatedMessages(const cString& filename)
   df->WriteColumnDesc("predicate data: [pdata]");
   df->FlushComments();
   
-  std::ofstream& out = df->OFStream();
+  std::ostream& out = df->OFStream();
   for(message_pred_ptr_list::iterator i=m_message_predicates.begin();
       i!=m_message_predicates.end(); ++i) {
     (*i)->Print(GetUpdate(), out);
@@ -2184,7 +2588,7 @@ void cStats::PrintDemeGLSFounders(const cString& filename){
   df->WriteColumnDesc("{target genotype ID, target genome... founder 0, ...}");
   df->FlushComments();
   
-  std::ofstream& out = df->OFStream();
+  std::ostream& out = df->OFStream();
   
   //  typedef std::map<std::pair<int, int>, std::vector<std::pair<int, std::string> > > t_gls_founder_map;
   
@@ -2356,7 +2760,7 @@ void cStats::PrintGroupAttackData(const cString& filename, const cString& inst_s
     df->Endl();
   }
   
-  std::ofstream& fp = df->OFStream();
+  std::ostream& fp = df->OFStream();
   cString inst;
   for (int i = 0; i < m_group_attack_names[inst_set].GetSize(); i++) {
     inst = m_group_attack_names[inst_set][i];
@@ -2378,7 +2782,7 @@ void cStats::PrintGroupAttackBits(unsigned char raw_bits)
     df->WriteTimeStamp();
     df->Endl();
   }  
-  std::ofstream& fp = df->OFStream();
+  std::ostream& fp = df->OFStream();
   fp << raw_bits << endl;
 }
 
@@ -2400,7 +2804,7 @@ void cStats::PrintGroupAttackString(cString& string)
     df->Endl();
   }
   
-  std::ofstream& fp = df->OFStream();
+  std::ostream& fp = df->OFStream();
   fp << GetUpdate() << "," << string << endl;
 }
 
@@ -2477,7 +2881,7 @@ void cStats::PrintBirthLocData(int org_idx)
   const int locy = loc / worldx;
   const int ft = org->GetParentFT();
   
-  std::ofstream& fp = df->OFStream();
+  std::ostream& fp = df->OFStream();
   fp << GetUpdate() << "," << org->GetID() << "," << ft << "," << locx << "," << locy;
   fp << endl;
 }
@@ -2502,7 +2906,7 @@ void cStats::PrintLookData(cString& string)
     df->Endl();
   }
   
-  std::ofstream& fp = df->OFStream();
+  std::ostream& fp = df->OFStream();
   fp << GetUpdate() << "," << string << endl;
 }
 
@@ -2530,7 +2934,7 @@ void cStats::PrintLookDataOutput(cString& string)
     df->Endl();
   }
   
-  std::ofstream& fp = df->OFStream();
+  std::ostream& fp = df->OFStream();
   fp << GetUpdate() << "," << string << endl;
 }
 
@@ -2555,7 +2959,7 @@ void cStats::PrintLookEXDataOutput(cString& string)
     df->Endl();
   }
   
-  std::ofstream& fp = df->OFStream();
+  std::ostream& fp = df->OFStream();
   fp << GetUpdate() << "," << string << endl;
 }
 
@@ -2578,7 +2982,7 @@ void cStats::PrintDemeFoundersData(const cString& filename)
   df->WriteColumnDesc("{Genotype ID of founder 0, ...}");
   df->FlushComments();
   
-  std::ofstream& out = df->OFStream();
+  std::ostream& out = df->OFStream();
   for(t_founder_map::iterator i=m_deme_founders.begin(); i!=m_deme_founders.end(); ++i) {
     out << GetUpdate() << " " << i->first << " " << i->second.size();
     for(std::vector<int>::iterator j=i->second.begin(); j!=i->second.end(); ++j) {
@@ -2904,7 +3308,7 @@ void cStats::PrintDemeCurrentTaskExeData(const cString& filename)
 void cStats::PrintCurrentTaskCounts(const cString& filename)
 {
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  ofstream& fp = df->OFStream();
+  ostream& fp = df->OFStream();
   fp << "Update " << m_world->GetStats().GetUpdate() << ":" << endl;
   for (int y = 0; y < m_world->GetPopulation().GetWorldY(); y++) {
     for (int x = 0; x < m_world->GetPopulation().GetWorldX(); x++) {
@@ -4848,7 +5252,7 @@ void cStats::PrintSuccessfulMates(cString& filename) {
   df->WriteComment("Second half of each line gives information about the 'chooser'");
   df->WriteComment(cBirthEntry::GetPhenotypeStringFormat());
   df->Endl();
-  std::ofstream& df_stream = df->OFStream();
+  std::ostream& df_stream = df->OFStream();
   for (int i = 0; i < m_num_successful_mates; i++) {
     df_stream << m_successful_mates[i].GetPhenotypeString() << " " << m_choosers[i].GetPhenotypeString() << endl;
   }
@@ -5019,7 +5423,7 @@ void cStats::PrintMiniTraceReactions(cOrganism* org)
     df->Endl();
   }
   
-  std::ofstream& fp = df->OFStream();
+  std::ostream& fp = df->OFStream();
   
   Apto::Array<int> reaction_count = org->GetPhenotype().GetCurReactionCount();
   Apto::Array<int> reaction_cycles = org->GetPhenotype().GetFirstReactionCycles();
@@ -5059,7 +5463,7 @@ void cStats::PrintMicroTraces(Apto::Array<char, Apto::Smart>& exec_trace, int bi
     df->Endl();
   }
   
-  std::ofstream& fp = df->OFStream();
+  std::ostream& fp = df->OFStream();
   fp << death_update << "," << birth_update << "," << org_id << "," << gen_id << "," << ft << ",";
   for (int i = 0; i < exec_trace.GetSize(); i++) {
     fp << exec_trace[i];
@@ -5169,7 +5573,7 @@ void cStats::PrintTopNavTrace(bool flush)
   df->WriteComment("Execution Trace to First Reproduction");
   df->Endl();
   
-  std::ofstream& fp = df->OFStream();
+  std::ostream& fp = df->OFStream();
   
   // in case nobody has reproduced (e.g. in single org trial) print what we know to date
   if (!topreactions.GetSize()) {
@@ -5253,7 +5657,7 @@ void cStats::PrintReproData(cOrganism* org)
     df->Endl();
   }
   
-  std::ofstream& fp = df->OFStream();
+  std::ostream& fp = df->OFStream();
   fp << update << " " << org->SystematicsGroup("genotype")->ID()<< " " << org->GetID() << " " << org->GetPhenotype().GetAge() << " " << org->GetPhenotype().GetTimeUsed()
   << " " << org->GetPhenotype().GetNumExecs() << " ";
   Apto::Array<int> reaction_count = org->GetPhenotype().GetCurReactionCount();
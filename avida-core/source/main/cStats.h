@@ -51,6 +51,7 @@
 #include <set>
 #include <utility>
 
+class cChunkBuffer;
 class cWorld;
 class cOrganism;
 class cOrgMessage;
@@ -439,6 +440,11 @@ public:
   // cStats
   void ProcessUpdate();
 
+  // Snapshot state: counters, sums and per task/reaction/resource tallies.  The per-instruction execution maps, deme
+  // accumulators, mating records and top navigator trace genome are rebuilt from the next update on.
+  void SaveState(cChunkBuffer& buf) const;
+  bool LoadState(cChunkBuffer& buf);
+
   inline void SetCurrentUpdate(int new_update) { m_update = new_update; }
   inline void IncCurrentUpdate() { m_update++; }
 
@@ -650,6 +656,7 @@ public:
   void RecordDeath() { num_deaths++; }
 
   void IncExecuted() { num_executed++; }
+  void AddExecuted(int count) { num_executed += count; }
 
   void AddNumOrgsKilled(long num) { sum_orgs_killed.Add(num); }
 	void AddNumUnoccupiedCellAttemptedToKill(long num) { sum_unoccupied_cell_kill_attempts.Add(num); }
@@ -901,6 +908,8 @@ public:
   void PrintCompetitionData(const cString& filename);
   void PrintCellVisitsData(const cString& filename);
   void PrintExtendedTimeData(const cString& filename);
+  void PrintPhenotypeCacheData(const cString& filename);
+  void PrintObjectPoolData(const cString& filename);
   void PrintNumOrgsKilledData(const cString& filename);
   void PrintMigrationData(const cString& filename);
   void PrintGroupsFormedData(const cString& filename);
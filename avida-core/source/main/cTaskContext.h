@@ -36,8 +36,8 @@ private:
   cOrganism* m_organism;
   const tBuffer<int>& m_input_buffer;
   const tBuffer<int>& m_output_buffer;
-  const tList<tBuffer<int> >& m_other_input_buffers;
-  const tList<tBuffer<int> >& m_other_output_buffers;
+  const Apto::Array<const tBuffer<int>*, Apto::Smart>& m_other_input_buffers;
+  const Apto::Array<const tBuffer<int>*, Apto::Smart>& m_other_output_buffers;
   const Apto::Array<int, Apto::Smart>& m_ext_mem;
   tBuffer<int>* m_received_messages;
   int m_logic_id;
@@ -53,7 +53,8 @@ private:
   
 public:
   cTaskContext(cOrganism* organism, const tBuffer<int>& inputs, const tBuffer<int>& outputs,
-               const tList<tBuffer<int> >& other_inputs, const tList<tBuffer<int> >& other_outputs,
+               const Apto::Array<const tBuffer<int>*, Apto::Smart>& other_inputs,
+               const Apto::Array<const tBuffer<int>*, Apto::Smart>& other_outputs,
                const Apto::Array<int, Apto::Smart>& ext_mem, bool in_on_divide = false,
                tBuffer<int>* in_received_messages = NULL, cDeme* deme = NULL)
     : m_organism(organism)
@@ -74,8 +75,8 @@ public:
   inline cOrganism* GetOrganism() { return m_organism; }
   inline const tBuffer<int>& GetInputBuffer() { return m_input_buffer; }
   inline const tBuffer<int>& GetOutputBuffer() { return m_output_buffer; }
-  inline const tList<tBuffer<int> >& GetNeighborhoodInputBuffers() { return m_other_input_buffers; }
-  inline const tList<tBuffer<int> >& GetNeighborhoodOutputBuffers() { return m_other_output_buffers; }
+  inline const Apto::Array<const tBuffer<int>*, Apto::Smart>& GetNeighborhoodInputBuffers() { return m_other_input_buffers; }
+  inline const Apto::Array<const tBuffer<int>*, Apto::Smart>& GetNeighborhoodOutputBuffers() { return m_other_output_buffers; }
   inline const Apto::Array<int, Apto::Smart>& GetExtendedMemory() const { return m_ext_mem; }
   inline tBuffer<int>* GetReceivedMessages() { return m_received_messages; }
   inline int GetLogicId() const { return m_logic_id; }
@@ -42,12 +42,14 @@ private:
   int m_id;
   tTaskTest m_test_fun;
   cArgContainer* m_args;
+  bool m_logic_only;               // Quality depends only on the logic ID of the output
+  Apto::Array<int> m_logic_ids;    // Logic IDs accepted, when m_logic_only
   Apto::String m_prop_id_ave;
   Apto::String m_prop_id_count;
 
 public:
   cTaskEntry(const cString& name, const cString& desc, int in_id, tTaskTest fun, cArgContainer* args)
-    : m_name(name), m_desc(desc), m_id(in_id), m_test_fun(fun), m_args(args)
+    : m_name(name), m_desc(desc), m_id(in_id), m_test_fun(fun), m_args(args), m_logic_only(false)
   {
     m_prop_id_ave = Apto::FormatStr("environment.triggers.%s.average", (const char*)name);
     m_prop_id_count = Apto::FormatStr("environment.triggers.%s.count", (const char*)name);
@@ -62,6 +64,10 @@ public:
   int GetID() const { return m_id; }
   tTaskTest GetTestFun() const { return m_test_fun; }
   
+  bool IsLogicOnly() const { return m_logic_only; }
+  const Apto::Array<int>& GetLogicIDs() const { return m_logic_ids; }
+  void SetLogicIDs(const Apto::Array<int>& logic_ids) { m_logic_only = true; m_logic_ids = logic_ids; }
+  
   const Apto::String& AveragePropertyID() const { return m_prop_id_ave; }
   const Apto::String& CountPropertyID() const { return m_prop_id_count; }
   
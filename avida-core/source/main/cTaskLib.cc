@@ -93,24 +93,24 @@ cTaskEntry* cTaskLib::AddTask(const cString& name, const cString& info, cEnvReqs
   else if (name == "dontcare")  NewTask(name, "DontCare", &cTaskLib::Task_DontCare);
   
   // All 1- and 2-Input Logic Functions
-  if (name == "not") NewTask(name, "Not", &cTaskLib::Task_Not);
-  else if (name == "not_dup") NewTask(name, "Not_dup", &cTaskLib::Task_Not);
-  else if (name == "nand") NewTask(name, "Nand", &cTaskLib::Task_Nand);
-  else if (name == "nand_dup") NewTask(name, "Nand_dup", &cTaskLib::Task_Nand);
-  else if (name == "and") NewTask(name, "And", &cTaskLib::Task_And);
-  else if (name == "and_dup") NewTask(name, "And_dup", &cTaskLib::Task_And);
-  else if (name == "orn") NewTask(name, "OrNot", &cTaskLib::Task_OrNot);
-  else if (name == "orn_dup") NewTask(name, "OrNot_dup", &cTaskLib::Task_OrNot);
-  else if (name == "or") NewTask(name, "Or", &cTaskLib::Task_Or);
-  else if (name == "or_dup") NewTask(name, "Or_dup", &cTaskLib::Task_Or);
-  else if (name == "andn") NewTask(name, "AndNot", &cTaskLib::Task_AndNot);
-  else if (name == "andn_dup") NewTask(name, "AndNot_dup", &cTaskLib::Task_AndNot);
-  else if (name == "nor") NewTask(name, "Nor", &cTaskLib::Task_Nor);
-  else if (name == "nor_dup") NewTask(name, "Nor_dup", &cTaskLib::Task_Nor);
-  else if (name == "xor") NewTask(name, "Xor", &cTaskLib::Task_Xor);
-  else if (name == "xor_dup") NewTask(name, "Xor_dup", &cTaskLib::Task_Xor);
-  else if (name == "equ") NewTask(name, "Equals", &cTaskLib::Task_Equ);
-  else if (name == "equ_dup") NewTask(name, "Equals_dup", &cTaskLib::Task_Equ);
+  if (name == "not") NewTask(name, "Not", &cTaskLib::Task_Not, REQ_LOGIC_ID_ONLY);
+  else if (name == "not_dup") NewTask(name, "Not_dup", &cTaskLib::Task_Not, REQ_LOGIC_ID_ONLY);
+  else if (name == "nand") NewTask(name, "Nand", &cTaskLib::Task_Nand, REQ_LOGIC_ID_ONLY);
+  else if (name == "nand_dup") NewTask(name, "Nand_dup", &cTaskLib::Task_Nand, REQ_LOGIC_ID_ONLY);
+  else if (name == "and") NewTask(name, "And", &cTaskLib::Task_And, REQ_LOGIC_ID_ONLY);
+  else if (name == "and_dup") NewTask(name, "And_dup", &cTaskLib::Task_And, REQ_LOGIC_ID_ONLY);
+  else if (name == "orn") NewTask(name, "OrNot", &cTaskLib::Task_OrNot, REQ_LOGIC_ID_ONLY);
+  else if (name == "orn_dup") NewTask(name, "OrNot_dup", &cTaskLib::Task_OrNot, REQ_LOGIC_ID_ONLY);
+  else if (name == "or") NewTask(name, "Or", &cTaskLib::Task_Or, REQ_LOGIC_ID_ONLY);
+  else if (name == "or_dup") NewTask(name, "Or_dup", &cTaskLib::Task_Or, REQ_LOGIC_ID_ONLY);
+  else if (name == "andn") NewTask(name, "AndNot", &cTaskLib::Task_AndNot, REQ_LOGIC_ID_ONLY);
+  else if (name == "andn_dup") NewTask(name, "AndNot_dup", &cTaskLib::Task_AndNot, REQ_LOGIC_ID_ONLY);
+  else if (name == "nor") NewTask(name, "Nor", &cTaskLib::Task_Nor, REQ_LOGIC_ID_ONLY);
+  else if (name == "nor_dup") NewTask(name, "Nor_dup", &cTaskLib::Task_Nor, REQ_LOGIC_ID_ONLY);
+  else if (name == "xor") NewTask(name, "Xor", &cTaskLib::Task_Xor, REQ_LOGIC_ID_ONLY);
+  else if (name == "xor_dup") NewTask(name, "Xor_dup", &cTaskLib::Task_Xor, REQ_LOGIC_ID_ONLY);
+  else if (name == "equ") NewTask(name, "Equals", &cTaskLib::Task_Equ, REQ_LOGIC_ID_ONLY);
+  else if (name == "equ_dup") NewTask(name, "Equals_dup", &cTaskLib::Task_Equ, REQ_LOGIC_ID_ONLY);
   
   else if (name == "xor-max") NewTask(name, "Xor-max", &cTaskLib::Task_XorMax);
 	// resoruce dependent version
@@ -118,74 +118,74 @@ cTaskEntry* cTaskLib::AddTask(const cString& name, const cString& info, cEnvReqs
   else if (name == "nor-resourceDependent") NewTask(name, "Nor-resourceDependent", &cTaskLib::Task_Nor_ResourceDependent);
 	
   // All 3-Input Logic Functions
-  if (name == "logic_3AA")      NewTask(name, "Logic 3AA (A+B+C == 0)", &cTaskLib::Task_Logic3in_AA);
-  else if (name == "logic_3AB") NewTask(name, "Logic 3AB (A+B+C == 1)", &cTaskLib::Task_Logic3in_AB);
-  else if (name == "logic_3AC") NewTask(name, "Logic 3AC (A+B+C <= 1)", &cTaskLib::Task_Logic3in_AC);
-  else if (name == "logic_3AD") NewTask(name, "Logic 3AD (A+B+C == 2)", &cTaskLib::Task_Logic3in_AD);
-  else if (name == "logic_3AE") NewTask(name, "Logic 3AE (A+B+C == 0,2)", &cTaskLib::Task_Logic3in_AE);
-  else if (name == "logic_3AF") NewTask(name, "Logic 3AF (A+B+C == 1,2)", &cTaskLib::Task_Logic3in_AF);
-  else if (name == "logic_3AG") NewTask(name, "Logic 3AG (A+B+C <= 2)", &cTaskLib::Task_Logic3in_AG);
-  else if (name == "logic_3AH") NewTask(name, "Logic 3AH (A+B+C == 3)", &cTaskLib::Task_Logic3in_AH);
-  else if (name == "logic_3AI") NewTask(name, "Logic 3AI (A+B+C == 0,3)", &cTaskLib::Task_Logic3in_AI);
-  else if (name == "logic_3AJ") NewTask(name, "Logic 3AJ (A+B+C == 1,3) XOR", &cTaskLib::Task_Logic3in_AJ);
-  else if (name == "logic_3AK") NewTask(name, "Logic 3AK (A+B+C != 2)", &cTaskLib::Task_Logic3in_AK);
-  else if (name == "logic_3AL") NewTask(name, "Logic 3AL (A+B+C >= 2)", &cTaskLib::Task_Logic3in_AL);
-  else if (name == "logic_3AM") NewTask(name, "Logic 3AM (A+B+C != 1)", &cTaskLib::Task_Logic3in_AM);
-  else if (name == "logic_3AN") NewTask(name, "Logic 3AN (A+B+C != 0)", &cTaskLib::Task_Logic3in_AN);
-  else if (name == "logic_3AO") NewTask(name, "Logic 3AO (A & ~B & ~C) [3]", &cTaskLib::Task_Logic3in_AO);
-  else if (name == "logic_3AP") NewTask(name, "Logic 3AP (A^B & ~C)  [3]", &cTaskLib::Task_Logic3in_AP);
-  else if (name == "logic_3AQ") NewTask(name, "Logic 3AQ (A==B & ~C) [3]", &cTaskLib::Task_Logic3in_AQ);
-  else if (name == "logic_3AR") NewTask(name, "Logic 3AR (A & B & ~C) [3]", &cTaskLib::Task_Logic3in_AR);
-  else if (name == "logic_3AS") NewTask(name, "Logic 3AS", &cTaskLib::Task_Logic3in_AS);
-  else if (name == "logic_3AT") NewTask(name, "Logic 3AT", &cTaskLib::Task_Logic3in_AT);
-  else if (name == "logic_3AU") NewTask(name, "Logic 3AU", &cTaskLib::Task_Logic3in_AU);
-  else if (name == "logic_3AV") NewTask(name, "Logic 3AV", &cTaskLib::Task_Logic3in_AV);
-  else if (name == "logic_3AW") NewTask(name, "Logic 3AW", &cTaskLib::Task_Logic3in_AW);
-  else if (name == "logic_3AX") NewTask(name, "Logic 3AX", &cTaskLib::Task_Logic3in_AX);
-  else if (name == "logic_3AY") NewTask(name, "Logic 3AY", &cTaskLib::Task_Logic3in_AY);
-  else if (name == "logic_3AZ") NewTask(name, "Logic 3AZ", &cTaskLib::Task_Logic3in_AZ);
-  else if (name == "logic_3BA") NewTask(name, "Logic 3BA", &cTaskLib::Task_Logic3in_BA);
-  else if (name == "logic_3BB") NewTask(name, "Logic 3BB", &cTaskLib::Task_Logic3in_BB);
-  else if (name == "logic_3BC") NewTask(name, "Logic 3BC", &cTaskLib::Task_Logic3in_BC);
-  else if (name == "logic_3BD") NewTask(name, "Logic 3BD", &cTaskLib::Task_Logic3in_BD);
-  else if (name == "logic_3BE") NewTask(name, "Logic 3BE", &cTaskLib::Task_Logic3in_BE);
-  else if (name == "logic_3BF") NewTask(name, "Logic 3BF", &cTaskLib::Task_Logic3in_BF);
-  else if (name == "logic_3BG") NewTask(name, "Logic 3BG", &cTaskLib::Task_Logic3in_BG);
-  else if (name == "logic_3BH") NewTask(name, "Logic 3BH", &cTaskLib::Task_Logic3in_BH);
-  else if (name == "logic_3BI") NewTask(name, "Logic 3BI", &cTaskLib::Task_Logic3in_BI);
-  else if (name == "logic_3BJ") NewTask(name, "Logic 3BJ", &cTaskLib::Task_Logic3in_BJ);
-  else if (name == "logic_3BK") NewTask(name, "Logic 3BK", &cTaskLib::Task_Logic3in_BK);
-  else if (name == "logic_3BL") NewTask(name, "Logic 3BL", &cTaskLib::Task_Logic3in_BL);
-  else if (name == "logic_3BM") NewTask(name, "Logic 3BM", &cTaskLib::Task_Logic3in_BM);
-  else if (name == "logic_3BN") NewTask(name, "Logic 3BN", &cTaskLib::Task_Logic3in_BN);
-  else if (name == "logic_3BO") NewTask(name, "Logic 3BO", &cTaskLib::Task_Logic3in_BO);
-  else if (name == "logic_3BP") NewTask(name, "Logic 3BP", &cTaskLib::Task_Logic3in_BP);
-  else if (name == "logic_3BQ") NewTask(name, "Logic 3BQ", &cTaskLib::Task_Logic3in_BQ);
-  else if (name == "logic_3BR") NewTask(name, "Logic 3BR", &cTaskLib::Task_Logic3in_BR);
-  else if (name == "logic_3BS") NewTask(name, "Logic 3BS", &cTaskLib::Task_Logic3in_BS);
-  else if (name == "logic_3BT") NewTask(name, "Logic 3BT", &cTaskLib::Task_Logic3in_BT);
-  else if (name == "logic_3BU") NewTask(name, "Logic 3BU", &cTaskLib::Task_Logic3in_BU);
-  else if (name == "logic_3BV") NewTask(name, "Logic 3BV", &cTaskLib::Task_Logic3in_BV);
-  else if (name == "logic_3BW") NewTask(name, "Logic 3BW", &cTaskLib::Task_Logic3in_BW);
-  else if (name == "logic_3BX") NewTask(name, "Logic 3BX", &cTaskLib::Task_Logic3in_BX);
-  else if (name == "logic_3BY") NewTask(name, "Logic 3BY", &cTaskLib::Task_Logic3in_BY);
-  else if (name == "logic_3BZ") NewTask(name, "Logic 3BZ", &cTaskLib::Task_Logic3in_BZ);
-  else if (name == "logic_3CA") NewTask(name, "Logic 3CA", &cTaskLib::Task_Logic3in_CA);
-  else if (name == "logic_3CB") NewTask(name, "Logic 3CB", &cTaskLib::Task_Logic3in_CB);
-  else if (name == "logic_3CC") NewTask(name, "Logic 3CC", &cTaskLib::Task_Logic3in_CC);
-  else if (name == "logic_3CD") NewTask(name, "Logic 3CD", &cTaskLib::Task_Logic3in_CD);
-  else if (name == "logic_3CE") NewTask(name, "Logic 3CE", &cTaskLib::Task_Logic3in_CE);
-  else if (name == "logic_3CF") NewTask(name, "Logic 3CF", &cTaskLib::Task_Logic3in_CF);
-  else if (name == "logic_3CG") NewTask(name, "Logic 3CG", &cTaskLib::Task_Logic3in_CG);
-  else if (name == "logic_3CH") NewTask(name, "Logic 3CH", &cTaskLib::Task_Logic3in_CH);
-  else if (name == "logic_3CI") NewTask(name, "Logic 3CI", &cTaskLib::Task_Logic3in_CI);
-  else if (name == "logic_3CJ") NewTask(name, "Logic 3CJ", &cTaskLib::Task_Logic3in_CJ);
-  else if (name == "logic_3CK") NewTask(name, "Logic 3CK", &cTaskLib::Task_Logic3in_CK);
-  else if (name == "logic_3CL") NewTask(name, "Logic 3CL", &cTaskLib::Task_Logic3in_CL);
-  else if (name == "logic_3CM") NewTask(name, "Logic 3CM", &cTaskLib::Task_Logic3in_CM);
-  else if (name == "logic_3CN") NewTask(name, "Logic 3CN", &cTaskLib::Task_Logic3in_CN);
-  else if (name == "logic_3CO") NewTask(name, "Logic 3CO", &cTaskLib::Task_Logic3in_CO);
-  else if (name == "logic_3CP") NewTask(name, "Logic 3CP", &cTaskLib::Task_Logic3in_CP);
+  if (name == "logic_3AA")      NewTask(name, "Logic 3AA (A+B+C == 0)", &cTaskLib::Task_Logic3in_AA, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AB") NewTask(name, "Logic 3AB (A+B+C == 1)", &cTaskLib::Task_Logic3in_AB, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AC") NewTask(name, "Logic 3AC (A+B+C <= 1)", &cTaskLib::Task_Logic3in_AC, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AD") NewTask(name, "Logic 3AD (A+B+C == 2)", &cTaskLib::Task_Logic3in_AD, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AE") NewTask(name, "Logic 3AE (A+B+C == 0,2)", &cTaskLib::Task_Logic3in_AE, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AF") NewTask(name, "Logic 3AF (A+B+C == 1,2)", &cTaskLib::Task_Logic3in_AF, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AG") NewTask(name, "Logic 3AG (A+B+C <= 2)", &cTaskLib::Task_Logic3in_AG, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AH") NewTask(name, "Logic 3AH (A+B+C == 3)", &cTaskLib::Task_Logic3in_AH, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AI") NewTask(name, "Logic 3AI (A+B+C == 0,3)", &cTaskLib::Task_Logic3in_AI, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AJ") NewTask(name, "Logic 3AJ (A+B+C == 1,3) XOR", &cTaskLib::Task_Logic3in_AJ, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AK") NewTask(name, "Logic 3AK (A+B+C != 2)", &cTaskLib::Task_Logic3in_AK, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AL") NewTask(name, "Logic 3AL (A+B+C >= 2)", &cTaskLib::Task_Logic3in_AL, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AM") NewTask(name, "Logic 3AM (A+B+C != 1)", &cTaskLib::Task_Logic3in_AM, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AN") NewTask(name, "Logic 3AN (A+B+C != 0)", &cTaskLib::Task_Logic3in_AN, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AO") NewTask(name, "Logic 3AO (A & ~B & ~C) [3]", &cTaskLib::Task_Logic3in_AO, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AP") NewTask(name, "Logic 3AP (A^B & ~C)  [3]", &cTaskLib::Task_Logic3in_AP, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AQ") NewTask(name, "Logic 3AQ (A==B & ~C) [3]", &cTaskLib::Task_Logic3in_AQ, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AR") NewTask(name, "Logic 3AR (A & B & ~C) [3]", &cTaskLib::Task_Logic3in_AR, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AS") NewTask(name, "Logic 3AS", &cTaskLib::Task_Logic3in_AS, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AT") NewTask(name, "Logic 3AT", &cTaskLib::Task_Logic3in_AT, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AU") NewTask(name, "Logic 3AU", &cTaskLib::Task_Logic3in_AU, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AV") NewTask(name, "Logic 3AV", &cTaskLib::Task_Logic3in_AV, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AW") NewTask(name, "Logic 3AW", &cTaskLib::Task_Logic3in_AW, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AX") NewTask(name, "Logic 3AX", &cTaskLib::Task_Logic3in_AX, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AY") NewTask(name, "Logic 3AY", &cTaskLib::Task_Logic3in_AY, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3AZ") NewTask(name, "Logic 3AZ", &cTaskLib::Task_Logic3in_AZ, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BA") NewTask(name, "Logic 3BA", &cTaskLib::Task_Logic3in_BA, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BB") NewTask(name, "Logic 3BB", &cTaskLib::Task_Logic3in_BB, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BC") NewTask(name, "Logic 3BC", &cTaskLib::Task_Logic3in_BC, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BD") NewTask(name, "Logic 3BD", &cTaskLib::Task_Logic3in_BD, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BE") NewTask(name, "Logic 3BE", &cTaskLib::Task_Logic3in_BE, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BF") NewTask(name, "Logic 3BF", &cTaskLib::Task_Logic3in_BF, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BG") NewTask(name, "Logic 3BG", &cTaskLib::Task_Logic3in_BG, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BH") NewTask(name, "Logic 3BH", &cTaskLib::Task_Logic3in_BH, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BI") NewTask(name, "Logic 3BI", &cTaskLib::Task_Logic3in_BI, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BJ") NewTask(name, "Logic 3BJ", &cTaskLib::Task_Logic3in_BJ, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BK") NewTask(name, "Logic 3BK", &cTaskLib::Task_Logic3in_BK, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BL") NewTask(name, "Logic 3BL", &cTaskLib::Task_Logic3in_BL, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BM") NewTask(name, "Logic 3BM", &cTaskLib::Task_Logic3in_BM, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BN") NewTask(name, "Logic 3BN", &cTaskLib::Task_Logic3in_BN, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BO") NewTask(name, "Logic 3BO", &cTaskLib::Task_Logic3in_BO, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BP") NewTask(name, "Logic 3BP", &cTaskLib::Task_Logic3in_BP, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BQ") NewTask(name, "Logic 3BQ", &cTaskLib::Task_Logic3in_BQ, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BR") NewTask(name, "Logic 3BR", &cTaskLib::Task_Logic3in_BR, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BS") NewTask(name, "Logic 3BS", &cTaskLib::Task_Logic3in_BS, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BT") NewTask(name, "Logic 3BT", &cTaskLib::Task_Logic3in_BT, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BU") NewTask(name, "Logic 3BU", &cTaskLib::Task_Logic3in_BU, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BV") NewTask(name, "Logic 3BV", &cTaskLib::Task_Logic3in_BV, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BW") NewTask(name, "Logic 3BW", &cTaskLib::Task_Logic3in_BW, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BX") NewTask(name, "Logic 3BX", &cTaskLib::Task_Logic3in_BX, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BY") NewTask(name, "Logic 3BY", &cTaskLib::Task_Logic3in_BY, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3BZ") NewTask(name, "Logic 3BZ", &cTaskLib::Task_Logic3in_BZ, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CA") NewTask(name, "Logic 3CA", &cTaskLib::Task_Logic3in_CA, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CB") NewTask(name, "Logic 3CB", &cTaskLib::Task_Logic3in_CB, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CC") NewTask(name, "Logic 3CC", &cTaskLib::Task_Logic3in_CC, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CD") NewTask(name, "Logic 3CD", &cTaskLib::Task_Logic3in_CD, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CE") NewTask(name, "Logic 3CE", &cTaskLib::Task_Logic3in_CE, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CF") NewTask(name, "Logic 3CF", &cTaskLib::Task_Logic3in_CF, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CG") NewTask(name, "Logic 3CG", &cTaskLib::Task_Logic3in_CG, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CH") NewTask(name, "Logic 3CH", &cTaskLib::Task_Logic3in_CH, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CI") NewTask(name, "Logic 3CI", &cTaskLib::Task_Logic3in_CI, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CJ") NewTask(name, "Logic 3CJ", &cTaskLib::Task_Logic3in_CJ, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CK") NewTask(name, "Logic 3CK", &cTaskLib::Task_Logic3in_CK, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CL") NewTask(name, "Logic 3CL", &cTaskLib::Task_Logic3in_CL, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CM") NewTask(name, "Logic 3CM", &cTaskLib::Task_Logic3in_CM, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CN") NewTask(name, "Logic 3CN", &cTaskLib::Task_Logic3in_CN, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CO") NewTask(name, "Logic 3CO", &cTaskLib::Task_Logic3in_CO, REQ_LOGIC_ID_ONLY);
+  else if (name == "logic_3CP") NewTask(name, "Logic 3CP", &cTaskLib::Task_Logic3in_CP, REQ_LOGIC_ID_ONLY);
   
   // Arbitrary 1-Input Math Tasks
   else if (name == "math_1AA") NewTask(name, "Math 1AA (2X)", &cTaskLib::Task_Math1in_AA);
@@ -363,6 +363,22 @@ void cTaskLib::NewTask(const cString& name, const cString& desc, tTaskTest task_
   const int id = task_array.GetSize();
   task_array.Resize(id + 1);
   task_array[id] = new cTaskEntry(name, desc, id, task_fun, args);
+  
+  if (reqs & REQ_LOGIC_ID_ONLY) {
+    // Probe the test with every logic ID to find the ones it accepts
+    tBuffer<int> no_io(1);
+    Apto::Array<const tBuffer<int>*, Apto::Smart> no_neighbors;
+    Apto::Array<int, Apto::Smart> no_ext_mem;
+    cTaskContext probe(NULL, no_io, no_io, no_neighbors, no_neighbors, no_ext_mem);
+    probe.SetTaskEntry(task_array[id]);
+    
+    Apto::Array<int> logic_ids;
+    for (int logic_id = 0; logic_id < 256; logic_id++) {
+      probe.SetLogicId(logic_id);
+      if ((this->*task_fun)(probe) > 0.0) logic_ids.Push(logic_id);
+    }
+    task_array[id]->SetLogicIDs(logic_ids);
+  }
 }
 
 
@@ -3217,10 +3233,10 @@ double cTaskLib::Task_CommEcho(cTaskContext& ctx) const
 {
   const int test_output = ctx.GetOutputBuffer()[0];
   
-  tConstListIterator<tBuffer<int> > buff_it(ctx.GetNeighborhoodInputBuffers());  
+  const Apto::Array<const tBuffer<int>*, Apto::Smart>& buffers = ctx.GetNeighborhoodInputBuffers();
   
-  while (buff_it.Next() != NULL) {
-    const tBuffer<int>& cur_buff = *(buff_it.Get());
+  for (int b = 0; b < buffers.GetSize(); b++) {
+    const tBuffer<int>& cur_buff = *buffers[b];
     const int buff_size = cur_buff.GetNumStored();
     for (int i = 0; i < buff_size; i++) {
       if (test_output == cur_buff[i]) return 1.0;
@@ -3235,10 +3251,10 @@ double cTaskLib::Task_CommNot(cTaskContext& ctx) const
 {
   const int test_output = ctx.GetOutputBuffer()[0];
   
-  tConstListIterator<tBuffer<int> > buff_it(ctx.GetNeighborhoodInputBuffers());  
+  const Apto::Array<const tBuffer<int>*, Apto::Smart>& buffers = ctx.GetNeighborhoodInputBuffers();
   
-  while (buff_it.Next() != NULL) {
-    const tBuffer<int>& cur_buff = *(buff_it.Get());
+  for (int b = 0; b < buffers.GetSize(); b++) {
+    const tBuffer<int>& cur_buff = *buffers[b];
     const int buff_size = cur_buff.GetNumStored();
     for (int i = 0; i < buff_size; i++) {
       if (test_output == (0-(cur_buff[i]+1))) return 1.0;
@@ -48,7 +48,7 @@ private:
   {
     REQ_NEIGHBOR_INPUT=1,
     REQ_NEIGHBOR_OUTPUT=2, 
-    UNUSED_REQ_C=4,
+    REQ_LOGIC_ID_ONLY=4,   // Task test reads nothing but the logic ID (lets the environment index reactions by ID)
     UNUSED_REQ_D=8
   };
   
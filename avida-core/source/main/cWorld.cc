@@ -34,6 +34,7 @@
 
 #include "cAnalyze.h"
 #include "cAnalyzeGenotype.h"
+#include "cChunkedFile.h"
 #include "cEnvironment.h"
 #include "cEventList.h"
 #include "cHardwareManager.h"
@@ -52,7 +53,7 @@ using namespace AvidaTools;
 cWorld::cWorld(cAvidaConfig* cfg, const cString& wd)
   : m_working_dir(wd), m_analyze(NULL), m_conf(cfg), m_ctx(NULL)
   , m_env(NULL), m_event_list(NULL), m_hw_mgr(NULL), m_pop(NULL), m_stats(NULL), m_mig_mat(NULL), m_driver(NULL), m_data_mgr(NULL)
-  , m_own_driver(false)
+  , m_own_driver(false), m_snapshot_background(true)
 {
 }
 
@@ -70,6 +71,9 @@ cWorld::~cWorld()
 {
   // m_actlib is not owned by cWorld, DO NOT DELETE
   
+  // Finish any population saves and snapshots still being written in the background
+  cChunkedFileWriter::FlushBackground();
+  
   // These must be deleted first
   delete m_analyze; m_analyze = NULL;
   
@@ -114,7 +118,8 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
     
     // Output Manager
     Apto::String opath = Apto::FileSystem::GetAbsolutePath(Apto::String(m_conf->DATA_DIR.Get()), Apto::String(m_working_dir));
-    Output::ManagerPtr(new Output::Manager(opath))->AttachTo(new_world);
+    const int buffer_mb = Apto::Min(m_conf->OUTPUT_BUFFER_SIZE.Get(), 1024);
+    Output::ManagerPtr(new Output::Manager(opath, buffer_mb * 1024 * 1024))->AttachTo(new_world);
   }
   
 
@@ -222,6 +227,99 @@ void cWorld::GetEvents(cAvidaContext& ctx)
     m_pop->SetSyncEvents(false);
   }
   m_event_list->Process(ctx);
+  
+  if (m_snapshot_name.GetSize()) {
+    if (!saveSnapshot(m_snapshot_name, m_snapshot_background)) {
+      m_driver->Feedback().Error("unable to save snapshot '%s'", (const char*)m_snapshot_name);
+    }
+    m_snapshot_name = "";
+  }
+  if (m_restore_path.GetSize()) {
+    if (!restoreSnapshot(ctx, m_restore_path)) {
+      m_driver->Feedback().Error("unable to restore snapshot '%s'", (const char*)m_restore_path);
+      m_driver->Abort(Avida::INVALID_CONFIG);
+    }
+    m_restore_path = "";
+  }
+}
+
+
+static const char SNAPSHOT_MAGIC[8] = { 'A', 'V', 'I', 'D', 'A', 'S', 'N', 'P' };
+static const unsigned int SNAPSHOT_VERSION = 3;
+
+bool cWorld::saveSnapshot(const cString& name, bool background)
+{
+  if (!m_pop->CheckSnapshotSupport(m_driver->Feedback())) return false;
+  
+  const cString pop_name = name + ".bpop";
+  Apto::String snap_path = Output::Manager::Of(m_new_world)->OutputIDFromPath(Apto::String((const char*)(name + ".snap")));
+  if (!snap_path.GetSize()) return false;
+  
+  // The state is always captured here, between updates while the worker threads are idle.  A background snapshot only
+  // leaves the compression and writing of the captured chunks to the background writer thread.
+  if (!m_pop->SavePopulation(pop_name, true, false, false, false, true, background)) return false;
+  
+  cChunkedFileWriter file;
+  if (!file.Open(snap_path, SNAPSHOT_MAGIC, SNAPSHOT_VERSION, background)) return false;
+  
+  // Header, then world level state, then the population
+  cChunkBuffer chunk;
+  chunk.PutVarInt(m_stats->GetUpdate());
+  chunk.PutRNG(m_rng);
+  file.WriteChunk(chunk);
+  
+  chunk.Clear();
+  Systematics::GenotypeArbiterPtr arbiter;
+  arbiter.DynamicCastFrom(Systematics::Manager::Of(m_new_world)->ArbiterForRole("genotype"));
+  m_stats->SaveState(chunk);
+  arbiter->SaveState(chunk);
+  m_event_list->SaveState(chunk);
+  file.WriteChunk(chunk);
+  
+  chunk.Clear();
+  m_pop->SaveSnapshotState(chunk);
+  file.WriteChunk(chunk);
+  
+  return file.Close();
+}
+
+bool cWorld::restoreSnapshot(cAvidaContext& ctx, const cString& snap_path)
+{
+  // The snapshot may have been taken by this run and still be on its way to disk
+  if (!cChunkedFileWriter::FlushBackground()) return false;
+  
+  cString path(Apto::FileSystem::GetAbsolutePath(Apto::String(snap_path), Apto::String(m_working_dir)));
+  cChunkedFileReader file;
+  cChunkBuffer header;
+  cChunkBuffer chunk;
+  if (!file.Open(Apto::String((const char*)path), SNAPSHOT_MAGIC) || file.GetVersion() != SNAPSHOT_VERSION) return false;
+  if (!file.ReadChunk(header)) return false;
+  const int update = (int)header.GetVarInt();
+  if (header.Fail()) return false;
+  
+  // The population save sits beside the snapshot
+  cString pop_path = path;
+  if (pop_path.GetSize() > 5 && pop_path.Substring(pop_path.GetSize() - 5, 5) == ".snap") {
+    pop_path = pop_path.Substring(0, pop_path.GetSize() - 5);
+  }
+  pop_path += ".bpop";
+  
+  Systematics::GenotypeArbiterPtr arbiter;
+  arbiter.DynamicCastFrom(Systematics::Manager::Of(m_new_world)->ArbiterForRole("genotype"));
+  arbiter->SetKeepLoadedIDs(true);
+  const bool loaded = m_pop->LoadPopulation(pop_path, ctx);
+  arbiter->SetKeepLoadedIDs(false);
+  if (!loaded) return false;
+  
+  if (!file.ReadChunk(chunk)) return false;
+  if (!m_stats->LoadState(chunk) || !arbiter->LoadState(chunk)) return false;
+  if (!m_event_list->LoadState(chunk, m_driver->Feedback())) return false;
+  if (m_stats->GetUpdate() != update) return false;
+  
+  if (!file.ReadChunk(chunk) || !m_pop->LoadSnapshotState(chunk)) return false;
+  
+  // Loading the population draws from the RNG, so its saved state goes back in last
+  return header.GetRNG(m_rng);
 }
 
 int cWorld::GetNumResources()
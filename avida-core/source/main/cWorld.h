@@ -75,6 +75,11 @@ protected:
   bool m_test_sterilize;  // flag derived from a collection of configuration settings
   
   bool m_own_driver;      // specifies whether this world object should manage its driver object
+  
+  // Pending snapshot requests, carried out by GetEvents once the event list has been processed
+  cString m_snapshot_name;
+  bool m_snapshot_background;
+  cString m_restore_path;
 
   cWorld(cAvidaConfig* cfg, const cString& wd);
   
@@ -117,6 +122,15 @@ public:
   void GetEvents(cAvidaContext& ctx);
 	
 	cEventList* GetEventsList() { return m_event_list; }
+  
+  // Snapshots hold the full simulation state at an update boundary: a binary population save (<name>.bpop) and the
+  // state of every cell, organism, resource, deme, the stats, the event list, the schedulers and the RNGs (<name>.snap).
+  // Requests are carried out at the end of event processing, so that the saved event list has already moved past the
+  // request.  Taking a snapshot reseeds the random streams from themselves (the only state of theirs that can be saved),
+  // so it changes the rest of the run; a run restored from it repeats the saving run exactly.
+  // Configurations holding state that snapshots do not carry are refused (see cPopulation::CheckSnapshotSupport).
+  void RequestSnapshot(const cString& name, bool background = true) { m_snapshot_name = name; m_snapshot_background = background; }
+  void RequestRestore(const cString& snap_path) { m_restore_path = snap_path; }
 
 	//! Migrate this organism to a different world (does nothing here; see cMultiProcessWorld).
 	virtual void MigrateOrganism(cOrganism* org, const cPopulationCell& cell, const cMerit& merit, int lineage);
@@ -139,6 +153,8 @@ public:
 protected:
   // Internal Methods
   bool setup(World* new_world, cUserFeedback* errors,  const Apto::Map<Apto::String, Apto::String>* mappings);
+  bool saveSnapshot(const cString& name, bool background);
+  bool restoreSnapshot(cAvidaContext& ctx, const cString& snap_path);
 
 };
 
@@ -27,7 +27,246 @@
 #include "avida/core/Feedback.h"
 #include "avida/output/Manager.h"
 
+#include "apto/core/Thread.h"
+
 #include <ctime>
+#include <deque>
+#include <fstream>
+
+
+// Background Writing
+// --------------------------------------------------------------------------------------------------------------
+
+namespace {
+  
+  // Open file written by the background writer.  Only the writer touches the stream once the file has been opened.
+  class Sink
+  {
+  public:
+    std::ofstream fp;
+    int pending;    // Operations queued and not yet done
+    bool failed;
+    
+    Sink() : pending(0), failed(false) { ; }
+  };
+  
+  
+  // A single writer thread, started on first use, carries out queued operations in order.  Files are closed (and
+  // their sinks deleted) by the writer, so a file can be dropped while its output is still waiting to be written.
+  class BackgroundWriter : public Apto::Thread
+  {
+  public:
+    enum OpType { WRITE, FLUSH, CLOSE };
+    
+    struct Op
+    {
+      Sink* sink;
+      OpType type;
+      char* data;     // WRITE only, deleted once written
+      int size;
+    };
+    
+  private:
+    Apto::Mutex m_mutex;
+    Apto::ConditionVariable m_cond;       // signaled when an operation is queued (or on shutdown)
+    Apto::ConditionVariable m_done_cond;  // signaled when an operation has been done
+    std::deque<Op> m_queue;
+    long long m_queued_bytes;
+    int m_active;
+    bool m_started;
+    bool m_shutdown;
+    
+    void Run()
+    {
+      m_mutex.Lock();
+      while (true) {
+        while (!m_shutdown && m_queue.empty()) m_cond.Wait(m_mutex);
+        if (m_queue.empty()) break;
+        
+        Op op = m_queue.front();
+        m_queue.pop_front();
+        m_active++;
+        m_mutex.Unlock();
+        
+        bool ok = true;
+        switch (op.type) {
+          case WRITE:
+            op.sink->fp.write(op.data, op.size);
+            ok = op.sink->fp.good();
+            delete [] op.data;
+            break;
+          case FLUSH:
+            op.sink->fp.flush();
+            ok = op.sink->fp.good();
+            break;
+          case CLOSE:
+            op.sink->fp.close();
+            delete op.sink;
+            break;
+        }
+        
+        m_mutex.Lock();
+        m_active--;
+        if (op.type == WRITE) m_queued_bytes -= op.size;
+        if (op.type != CLOSE) {
+          if (!ok) op.sink->failed = true;
+          op.sink->pending--;
+        }
+        m_done_cond.Broadcast();
+      }
+      m_mutex.Unlock();
+    }
+    
+  public:
+    BackgroundWriter() : m_queued_bytes(0), m_active(0), m_started(false), m_shutdown(false) { ; }
+    ~BackgroundWriter()
+    {
+      // Runs at exit, after which everything queued has been written
+      if (!m_started) return;
+      m_mutex.Lock();
+      m_shutdown = true;
+      m_mutex.Unlock();
+      m_cond.Broadcast();
+      Join();
+    }
+    
+    void Queue(Sink* sink, OpType type, char* data = NULL, int size = 0, long long limit = 0)
+    {
+      m_mutex.Lock();
+      if (!m_started) {
+        m_started = true;
+        Start();
+      }
+      
+      // Hold the caller back while the writer is too far behind, so that buffered output stays within the limit
+      if (type == WRITE) while (m_queued_bytes > 0 && m_queued_bytes + size > limit) m_done_cond.Wait(m_mutex);
+      
+      Op op = { sink, type, data, size };
+      m_queue.push_back(op);
+      if (type == WRITE) m_queued_bytes += size;
+      if (type != CLOSE) sink->pending++;
+      m_mutex.Unlock();
+      m_cond.Broadcast();
+    }
+    
+    void Wait(Sink* sink)
+    {
+      m_mutex.Lock();
+      while (sink->pending > 0) m_done_cond.Wait(m_mutex);
+      m_mutex.Unlock();
+    }
+    
+    void WaitAll()
+    {
+      m_mutex.Lock();
+      while (!m_queue.empty() || m_active > 0) m_done_cond.Wait(m_mutex);
+      m_mutex.Unlock();
+    }
+    
+    bool Failed(Sink* sink)
+    {
+      m_mutex.Lock();
+      const bool failed = sink->failed;
+      m_mutex.Unlock();
+      return failed;
+    }
+  };
+  
+  BackgroundWriter& backgroundWriter()
+  {
+    static BackgroundWriter writer;
+    return writer;
+  }
+  
+};
+
+
+// Stream buffer collecting the file's output into blocks.  With a buffer limit, full blocks (and the partial block at
+// each Submit) are queued for the writer; endl and flush do not write anything.  Without one, blocks are written
+// directly and endl and flush behave as they would on an ofstream.
+class Avida::Output::File::Buffer : public std::streambuf
+{
+public:
+  static const int BLOCK_SIZE = 64 * 1024;
+  
+private:
+  Sink* m_sink;
+  long long m_limit;
+  char* m_block;
+  
+  Buffer(const Buffer&); // @not_implemented
+  Buffer& operator=(const Buffer&); // @not_implemented
+  
+public:
+  Buffer(const OutputID& path, bool append, int limit) : m_sink(new Sink), m_limit(limit), m_block(new char[BLOCK_SIZE])
+  {
+    // Opened here, so that failures show up when the file is created
+    m_sink->fp.open(path, (append) ? (std::ios::out | std::ios::app) : std::ios::out);
+    m_sink->failed = !m_sink->fp.good();
+    setp(m_block, m_block + BLOCK_SIZE);
+  }
+  
+  ~Buffer()
+  {
+    Submit();
+    if (m_limit > 0) {
+      backgroundWriter().Queue(m_sink, BackgroundWriter::CLOSE);
+    } else {
+      m_sink->fp.close();
+      delete m_sink;
+    }
+    delete [] m_block;
+  }
+  
+  bool Failed() const { return (m_limit > 0) ? backgroundWriter().Failed(m_sink) : m_sink->failed; }
+  
+  bool Submit()
+  {
+    const int size = static_cast<int>(pptr() - pbase());
+    if (size > 0) {
+      if (m_limit > 0) {
+        backgroundWriter().Queue(m_sink, BackgroundWriter::WRITE, m_block, size, m_limit);
+        m_block = new char[BLOCK_SIZE];
+      } else {
+        m_sink->fp.write(m_block, size);
+        if (!m_sink->fp.good()) m_sink->failed = true;
+      }
+      setp(m_block, m_block + BLOCK_SIZE);
+    }
+    return (m_limit > 0) || !m_sink->failed;
+  }
+  
+  void Flush()
+  {
+    if (m_limit > 0) {
+      Submit();
+      backgroundWriter().Queue(m_sink, BackgroundWriter::FLUSH);
+      backgroundWriter().Wait(m_sink);
+    } else {
+      sync();
+    }
+  }
+  
+protected:
+  int overflow(int c)
+  {
+    if (!Submit()) return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+  
+  int sync()
+  {
+    if (m_limit > 0) return 0;
+    if (!Submit()) return -1;
+    m_sink->fp.flush();
+    return (m_sink->fp.good()) ? 0 : -1;
+  }
+};
+
 
 
 Avida::Output::FilePtr Avida::Output::File::createWithPath(World* world, Apto::String path, bool append, Feedback* feedback)
@@ -90,12 +329,26 @@ Avida::Output::FilePtr Avida::Output::File::StaticWithPath(World* world, Apto::S
 
 Avida::Output::File::File(World* world, const OutputID& name, bool append)
   : Socket(world, name), m_descr_written(false), m_num_cols(0)
+  , m_buf(new Buffer(name, append, Output::Manager::Of(world)->BufferLimit())), m_fp(m_buf)
+{
+}
+
+Avida::Output::File::~File()
+{
+  m_fp.rdbuf(NULL);
+  delete m_buf;
+}
+
+
+bool Avida::Output::File::Fail() const
 {
-  m_fp.open(name, (append) ? (std::ios::out | std::ios::app) : std::ios::out);
-  assert(m_fp.good());
+  return m_fp.fail() || m_buf->Failed();
 }
 
-Avida::Output::File::~File() { ; }
+bool Avida::Output::File::Good() const
+{
+  return m_fp.good() && !m_buf->Failed();
+}
 
 
 
@@ -254,5 +507,15 @@ void Avida::Output::File::Endl()
 
 void Avida::Output::File::Flush()
 {
-  m_fp.flush();
+  m_buf->Flush();
+}
+
+void Avida::Output::File::Submit()
+{
+  m_buf->Submit();
+}
+
+void Avida::Output::File::WaitForPendingWrites()
+{
+  backgroundWriter().WaitAll();
 }
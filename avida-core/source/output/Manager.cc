@@ -24,9 +24,11 @@
 
 #include "avida/output/Manager.h"
 
+#include "avida/output/File.h"
 #include "avida/output/Socket.h"
 
-Avida::Output::Manager::Manager(const Apto::String& output_path) : m_world(NULL)
+Avida::Output::Manager::Manager(const Apto::String& output_path, int buffer_limit)
+  : m_world(NULL), m_buffer_limit((buffer_limit > 0) ? buffer_limit : 0)
 {
   m_output_path = output_path;
   m_output_path.Trim();
@@ -112,6 +114,8 @@ void Avida::Output::Manager::FlushAll()
     (*it.Get())->Flush();
   }
   m_mutex.Unlock();
+  
+  File::WaitForPendingWrites();
 }
 
 
@@ -155,6 +159,16 @@ Avida::WorldFacetID Avida::Output::Manager::UpdateAfter() const
   return "";
 }
 
+void Avida::Output::Manager::PerformUpdate(Context&, Update)
+{
+  // Hand this update's output to the background writer, rather than holding it until the file buffers fill
+  m_mutex.Lock();
+  for (Apto::Map<OutputID, SocketWeakRef>::ValueIterator it = m_sockets.Values(); it.Next();) {
+    (*it.Get())->Submit();
+  }
+  m_mutex.Unlock();
+}
+
 
 bool Avida::Output::Manager::RegisterSocket(const OutputID& output_id, SocketWeakRef socket_ref)
 {
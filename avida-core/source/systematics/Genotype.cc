@@ -30,6 +30,7 @@
 #include "avida/private/systematics/GenotypeArbiter.h"
 
 #include "cHardwareManager.h"
+#include "cPopulationCheckpoint.h"
 #include "cStringList.h"
 #include "cStringUtil.h"
 
@@ -129,6 +130,7 @@ Avida::Systematics::Genotype::Genotype(GenotypeArbiterPtr mgr, GroupID in_id, Un
   : Group(in_id)
   , m_mgr(mgr)
   , m_handle(NULL)
+  , m_threshold_handle(NULL)
   , m_src(founder->UnitSource())
   , m_genome(founder->UnitGenome())
   , m_name("001-no_name")
@@ -187,6 +189,7 @@ Avida::Systematics::Genotype::Genotype(GenotypeArbiterPtr mgr, GroupID in_id, vo
 : Group(in_id)
 , m_mgr(mgr)
 , m_handle(NULL)
+, m_threshold_handle(NULL)
 , m_name("001-no_name")
 , m_threshold(false)
 , m_active(false)
@@ -341,9 +344,8 @@ bool Avida::Systematics::Genotype::Serialize(ArchivePtr) const
   return false;
 }
 
-bool Avida::Systematics::Genotype::LegacySave(void* dfp) const
+template <class DF> void Avida::Systematics::Genotype::legacySave(DF& df) const
 {
-  Avida::Output::File& df = *static_cast<Avida::Output::File*>(dfp);
   df.Write(m_id, "ID", "id");
   
   df.Write(m_src.AsString(), "Source", "src");
@@ -374,8 +376,22 @@ bool Avida::Systematics::Genotype::LegacySave(void* dfp) const
   df.Write(m_update_born, "Update Born", "update_born");
   df.Write(m_update_deactivated, "Update Deactivated", "update_deactivated");
   df.Write(m_depth, "Phylogenetic Depth", "depth");
-  m_genome.LegacySave(dfp);
   
+  // Same columns as Genome::LegacySave
+  df.Write(m_genome.HardwareType(), "Hardware Type ID", "hw_type");
+  df.Write(m_genome.Properties().Get("instset").StringValue(), "Inst Set Name" , "inst_set");
+  df.Write(m_genome.Representation()->AsString(), "Genome Sequence", "sequence");
+}
+
+bool Avida::Systematics::Genotype::LegacySave(void* dfp) const
+{
+  legacySave(*static_cast<Avida::Output::File*>(dfp));
+  return false;
+}
+
+bool Avida::Systematics::Genotype::LegacySave(cPopulationCheckpointWriter& df) const
+{
+  legacySave(df);
   return false;
 }
 
@@ -389,6 +405,15 @@ void Avida::Systematics::Genotype::RemoveActiveReference() const
   if (!m_a_refs) m_mgr->AdjustGenotype(nc_this->thisPtr(), m_num_organisms, 0);
 }
 
+void Avida::Systematics::Genotype::RemovePassiveReference() const
+{
+  Group::RemovePassiveReference();
+  
+  // Historic genotypes are dropped once nothing refers to them, which the arbiter checks at the end of the update
+  Genotype* nc_this = const_cast<Genotype*>(this);
+  if (!m_active && !ReferenceCount()) m_mgr->queueRemoval(nc_this->thisPtr());
+}
+
 
 
 bool Avida::Systematics::Genotype::Matches(UnitPtr u)
@@ -31,7 +31,9 @@
 
 #include "avida/private/systematics/Genotype.h"
 
+#include "cChunkedFile.h"
 #include "cDoubleSum.h"
+#include "cPopulationCheckpoint.h"
 
 #include <cmath>
 
@@ -40,6 +42,10 @@ Avida::Systematics::GenotypeArbiter::GenotypeArbiter(World* world, const RoleID&
   : Arbiter(role)
   , m_threshold(threshold)
   , m_disable_class(disable_class)
+  , m_keep_loaded_ids(false)
+  , m_active_hash(64)
+  , m_active_hash_count(0)
+  , m_active_hash_stamp(0)
   , m_active_sz(1)
   , m_coalescent(NULL)
   , m_best(0)
@@ -47,6 +53,7 @@ Avida::Systematics::GenotypeArbiter::GenotypeArbiter(World* world, const RoleID&
   , m_dom_prev(-1)
   , m_dom_time(0)
   , m_cur_update(-1)
+  , m_stats_update(0)
   , m_tot_genotypes(0)
   , m_coalescent_depth(-1)
 {
@@ -86,20 +93,15 @@ void Avida::Systematics::GenotypeArbiter::PerformUpdate(Context&, Update current
 {
   m_cur_update = current_update + 1; // +1 since PerformUpdate happens at end of updates, but m_cur_update is used during
   
-  if (m_active_sz.GetSize() < HASH_SIZE) {
-    for (int i = 0; i < m_active_sz.GetSize(); i++) {
-      Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_sz[i].Begin());
-      while (list_it.Next() != NULL) if ((*list_it.Get())->IsThreshold()) (*list_it.Get())->UpdateReset();
-    }
-  } else {
-    for (int i = 0; i < HASH_SIZE; i++) {
-      Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_hash[i].Begin());
-      while (list_it.Next() != NULL) if ((*list_it.Get())->IsThreshold()) (*list_it.Get())->UpdateReset();
-    }    
-  }
+  Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_threshold_list.Begin());
+  while (list_it.Next() != NULL) (*list_it.Get())->UpdateReset();
 
-  Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_historic.Begin());
-  while (list_it.Next() != NULL) if (!(*list_it.Get())->ReferenceCount()) removeGenotype(*list_it.Get());
+  // Drop historic genotypes that lost their last reference, skipping any that were removed or revived since queued
+  for (int i = 0; i < m_pending_removal.GetSize(); i++) {
+    GenotypePtr genotype = m_pending_removal[i];
+    if (genotype->m_handle && !genotype->IsActive() && !genotype->ReferenceCount()) removeGenotype(genotype);
+  }
+  m_pending_removal.Resize(0);
 }
 
 void Avida::Systematics::GenotypeArbiter::PrintListStatus()
@@ -130,24 +132,57 @@ bool Avida::Systematics::GenotypeArbiter::LegacySave(void* dfp) const
   return true;
 }
 
+bool Avida::Systematics::GenotypeArbiter::LegacySave(cPopulationCheckpointWriter& df) const
+{
+  Apto::List<GenotypePtr, Apto::SparseVector>::ConstIterator list_it(m_historic.Begin());
+  while (list_it.Next() != NULL) {
+    (*list_it.Get())->LegacySave(df);
+    df.Endl();
+  }
+  return true;
+}
+
 Avida::Systematics::GroupPtr Avida::Systematics::GenotypeArbiter::LegacyLoad(void* props)
 {
-  GenotypePtr g(new Genotype(thisPtr(), m_next_id++, props));
+  int g_id = m_next_id;
+  if (m_keep_loaded_ids) {
+    Apto::Map<Apto::String, Apto::String>& prop_map = *(*static_cast<Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> >*>(props));
+    g_id = Apto::StrAs(prop_map.Get("id"));
+  }
+  if (g_id >= m_next_id) m_next_id = g_id + 1;
+  
+  GenotypePtr g(new Genotype(thisPtr(), g_id, props));
   m_historic.Push(g, &g->m_handle);
+  m_id_index.Set(g->ID(), g);
+  queueRemoval(g);
   return g;
 }
 
 
+void Avida::Systematics::GenotypeArbiter::SaveState(cChunkBuffer& buf) const
+{
+  buf.PutVarInt(m_next_id);
+  buf.PutVarInt(m_dom_prev);
+  buf.PutVarInt(m_dom_time);
+  buf.PutVarInt(m_tot_genotypes);
+}
+
+bool Avida::Systematics::GenotypeArbiter::LoadState(cChunkBuffer& buf)
+{
+  const int next_id = (int)buf.GetVarInt();
+  m_dom_prev = (int)buf.GetVarInt();
+  m_dom_time = (int)buf.GetVarInt();
+  m_tot_genotypes = (int)buf.GetVarInt();
+  if (buf.Fail() || next_id < m_next_id) return false;
+  m_next_id = next_id;
+  return true;
+}
+
 
 Avida::Systematics::GroupPtr Avida::Systematics::GenotypeArbiter::Group(GroupID g_id)
 {
-  for (int i = m_best; i >= 0; i--) {
-    Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_sz[i].Begin());
-    while (list_it.Next() != NULL) if ((*list_it.Get())->ID() == g_id) return *list_it.Get();
-  }
-  
-  Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_historic.Begin());
-  while (list_it.Next() != NULL) if ((*list_it.Get())->ID() == g_id) return *list_it.Get();
+  GenotypePtr found;
+  if (m_id_index.Get(g_id, found)) return found;
   
   return GroupPtr(NULL);
 }
@@ -175,6 +210,63 @@ Avida::Data::ConstDataSetPtr Avida::Systematics::GenotypeArbiter::Provides() con
 }
 
 void Avida::Systematics::GenotypeArbiter::UpdateProvidedValues(Update current_update)
+{
+  // Bring the running age sums up to date
+  if (current_update != m_stats_update) {
+    m_age_stats.Shift(current_update - m_stats_update);
+    m_threshold_age_stats.Shift(current_update - m_stats_update);
+    m_stats_update = current_update;
+  }
+  
+  if (!m_age_stats.IsExact() || !m_abundance_stats.IsExact() || !m_depth_stats.IsExact() ||
+      !m_size_stats.IsExact() || !m_threshold_age_stats.IsExact()) {
+    // Sums too large for a double to hold exactly depend on the order they are accumulated in, so rebuild them
+    scanProvidedValues(current_update);
+    return;
+  }
+  
+  // Genotypes of the same abundance contribute equally to entropy.  Adding each contribution once per genotype, in
+  // order of abundance, matches the result of summing over the genotypes themselves.
+  const int tot_units = (int)m_abundance_stats.s1;
+  m_entropy = 0.0;
+  for (int i = 1; i < m_active_sz.GetSize(); i++) {
+    const int count = m_active_sz[i].GetSize();
+    if (!count) continue;
+    
+    // - when p = 1.0, partial_ent calculation would return -0.0. This may propagate
+    //   to the output stage, but behavior is dependent on compiler used and optimization
+    //   level.  For consistent output, ensures that 0.0 is returned.
+    const double p = ((double) i) / (double) tot_units;
+    const double partial_ent = (i == tot_units) ? 0.0 : -(p * log(p));
+    for (int j = 0; j < count; j++) m_entropy += partial_ent;
+  }
+  
+  // Stash all stats so that the can be retrieved using the provider mechanisms
+  m_num_genotypes = (int)m_abundance_stats.n;
+  m_num_historic_genotypes = m_historic.GetSize();
+  
+  m_ave_age = m_age_stats.Average();
+  m_ave_abundance = m_abundance_stats.Average();
+  m_ave_depth = m_depth_stats.Average();
+  m_ave_size = m_size_stats.Average();
+  m_ave_threshold_age = m_threshold_age_stats.Average();
+  
+  m_stderr_age = m_age_stats.StdError();
+  m_stderr_abundance = m_abundance_stats.StdError();
+  m_stderr_depth = m_depth_stats.StdError();
+  m_stderr_size = m_size_stats.StdError();
+  m_stderr_threshold_age = m_threshold_age_stats.StdError();
+  
+  m_var_age = m_age_stats.Variance();
+  m_var_abundance = m_abundance_stats.Variance();
+  m_var_depth = m_depth_stats.Variance();
+  m_var_size = m_size_stats.Variance();
+  m_var_threshold_age = m_threshold_age_stats.Variance();
+  
+  m_dom_id = (getBest()) ? getBest()->ID() : -1;
+}
+
+void Avida::Systematics::GenotypeArbiter::scanProvidedValues(Update current_update)
 {
   cDoubleSum sum_age;
   cDoubleSum sum_abundance;
@@ -283,7 +375,7 @@ Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::ClassifyNew
   ConstInstructionSequencePtr seq;
   seq.DynamicCastFrom(u->UnitGenome().Representation());
   assert(seq);
-  int list_num = hashGenome(*seq);
+  const unsigned long long hash = hashGenome(*seq);
   
   GenotypePtr found;
 
@@ -291,41 +383,29 @@ Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::ClassifyNew
   if (hints && hints->Get("id", gid_str)) {
     int gid = Apto::StrAs(gid_str);
     
-    // Search all lists attempting to locate the referenced genotype by ID
-    for (int i = 0; i < m_active_sz.GetSize() && !found; i++) {
-      Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_sz[i].Begin());
-      while (list_it.Next() != NULL) {
-        if ((*list_it.Get())->ID() == gid) {
-          found = *list_it.Get();
-          found->NotifyNewUnit(u);
-          break;
-        }
-      }
-    }
-    
-    if (!found) {
-      Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_historic.Begin());
-      while (list_it.Next() != NULL) {
-        if ((*list_it.Get())->ID() == gid) {
-          found = *list_it.Get();
-          seq.DynamicCastFrom(found->GroupGenome().Representation());
-          assert(seq);
-          
-          m_active_hash[hashGenome(*seq)].Push(found);
-          found->m_handle->Remove(); // Remove from historic list
-          resizeActiveList(found->NumUnits());
-          m_active_sz[found->NumUnits()].PushRear(found, &found->m_handle);
-          found->Reactivate();
-          found->NotifyNewUnit(u);
-          m_tot_genotypes++;
-          if (found->NumUnits() > m_best) {
-            m_best = found->NumUnits();
-            found->SetThreshold();
-            found->SetName(nameGenotype(seq->GetSize()));
-            m_num_threshold++;
-            m_tot_threshold++;
-            notifyListeners(found, EVENT_ADD_THRESHOLD);
-          }          
+    // Locate the referenced genotype by ID, reactivating it if it has gone historic
+    if (m_id_index.Get(gid, found)) {
+      if (found->IsActive()) {
+        found->NotifyNewUnit(u);
+      } else {
+        seq.DynamicCastFrom(found->GroupGenome().Representation());
+        assert(seq);
+        
+        insertActive(found, hashGenome(*seq));
+        found->m_handle->Remove(); // Remove from historic list
+        resizeActiveList(found->NumUnits());
+        m_active_sz[found->NumUnits()].PushRear(found, &found->m_handle);
+        found->Reactivate();
+        found->NotifyNewUnit(u);
+        m_tot_genotypes++;
+        if (found->NumUnits() > m_best) {
+          m_best = found->NumUnits();
+          found->SetThreshold();
+          addThreshold(found);
+          found->SetName(nameGenotype(seq->GetSize()));
+          m_num_threshold++;
+          m_tot_threshold++;
+          notifyListeners(found, EVENT_ADD_THRESHOLD);
         }
       }
     }
@@ -333,14 +413,8 @@ Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::ClassifyNew
   
   // No hints or unable to locate hinted genome, search for a matching genotype
   if (!found) {
-    Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_hash[list_num].Begin());
-    while (list_it.Next() != NULL) {
-      if ((*list_it.Get())->Matches(u)) {
-        found = *list_it.Get();
-        found->NotifyNewUnit(u);
-        break;
-      }
-    }
+    found = findActive(u, hash);
+    if (found) found->NotifyNewUnit(u);
   }
   
   // No matching genotype (hinted or otherwise), so create a new one
@@ -350,13 +424,16 @@ Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::ClassifyNew
     } else {
       found = GenotypePtr(new Genotype(thisPtr(), m_next_id++, u, m_cur_update, ConstGroupMembershipPtr(NULL)));
     }
-    m_active_hash[list_num].Push(found);
+    insertActive(found, hash);
+    m_id_index.Set(found->ID(), found);
     resizeActiveList(found->NumUnits());
     m_active_sz[found->NumUnits()].PushRear(found, &found->m_handle);
+    adjustStats(found, 0, found->NumUnits());
     m_tot_genotypes++;
     if (found->NumUnits() > m_best) {
       m_best = found->NumUnits();
       found->SetThreshold();
+      addThreshold(found);
       seq.DynamicCastFrom(found->GroupGenome().Representation());
       assert(seq);
       found->SetName(nameGenotype(seq->GetSize()));
@@ -371,6 +448,8 @@ Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::ClassifyNew
 
 void Avida::Systematics::GenotypeArbiter::AdjustGenotype(GenotypePtr genotype, int old_size, int new_size)
 {
+  adjustStats(genotype, old_size, new_size);
+  
   // Remove from old size list
   genotype->m_handle->Remove();
   if (m_coalescent == genotype) m_coalescent = GenotypePtr(NULL);
@@ -399,6 +478,7 @@ void Avida::Systematics::GenotypeArbiter::AdjustGenotype(GenotypePtr genotype, i
   
   if (!genotype->IsThreshold() && (new_size >= m_threshold || genotype == getBest())) {
     genotype->SetThreshold();
+    addThreshold(genotype);
     ConstInstructionSequencePtr seq;
     seq.DynamicCastFrom(genotype->GroupGenome().Representation());
     assert(seq);
@@ -468,15 +548,95 @@ void Avida::Systematics::GenotypeArbiter::setupProvidedData(World* world)
 
 
 
-unsigned int Avida::Systematics::GenotypeArbiter::hashGenome(const InstructionSequence& genome) const
+unsigned long long Avida::Systematics::GenotypeArbiter::hashGenome(const InstructionSequence& genome) const
 {
-  unsigned int total = 0;
-  
+  // FNV-1a over the op codes and length, followed by a 64-bit finalizer so that the low bits used for the slot index
+  // depend on every instruction
+  unsigned long long hash = 14695981039346656037ULL;
   for (int i = 0; i < genome.GetSize(); i++) {
-    total += (genome[i].GetOp() + 3) * i;
+    hash ^= (unsigned long long)genome[i].GetOp();
+    hash *= 1099511628211ULL;
+  }
+  hash ^= (unsigned long long)genome.GetSize();
+  hash *= 1099511628211ULL;
+  
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  
+  return hash;
+}
+
+Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::findActive(UnitPtr u, unsigned long long hash)
+{
+  // Scan the whole probe run, since a genome can have more than one active genotype (see ClassifyNewUnit hints), in
+  // which case the most recently inserted one wins
+  const int mask = m_active_hash.GetSize() - 1;
+  GenotypePtr found;
+  int found_stamp = -1;
+  for (int i = (int)(hash & mask); m_active_hash[i].genotype; i = (i + 1) & mask) {
+    GenomeSlot& slot = m_active_hash[i];
+    if (slot.hash == hash && slot.stamp > found_stamp && slot.genotype->Matches(u)) {
+      found = slot.genotype;
+      found_stamp = slot.stamp;
+    }
+  }
+  return found;
+}
+
+void Avida::Systematics::GenotypeArbiter::insertActive(GenotypePtr genotype, unsigned long long hash)
+{
+  // Keep the load factor at or below one half
+  if ((m_active_hash_count + 1) * 2 > m_active_hash.GetSize()) growActiveHash();
+  
+  const int mask = m_active_hash.GetSize() - 1;
+  int i = (int)(hash & mask);
+  while (m_active_hash[i].genotype) i = (i + 1) & mask;
+  
+  m_active_hash[i].genotype = genotype;
+  m_active_hash[i].hash = hash;
+  m_active_hash[i].stamp = m_active_hash_stamp++;
+  m_active_hash_count++;
+}
+
+void Avida::Systematics::GenotypeArbiter::removeActive(GenotypePtr genotype, unsigned long long hash)
+{
+  const int mask = m_active_hash.GetSize() - 1;
+  int i = (int)(hash & mask);
+  while (m_active_hash[i].genotype != genotype) {
+    assert(m_active_hash[i].genotype);
+    i = (i + 1) & mask;
   }
   
-  return total % HASH_SIZE;
+  // Backward shift deletion: pull later entries of the probe run into the hole whenever their home slot does not lie
+  // cyclically within (hole, entry], so that lookups never need tombstones
+  for (int j = (i + 1) & mask; m_active_hash[j].genotype; j = (j + 1) & mask) {
+    const int home = (int)(m_active_hash[j].hash & mask);
+    const bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+    if (stays) continue;
+    m_active_hash[i] = m_active_hash[j];
+    i = j;
+  }
+  m_active_hash[i] = GenomeSlot();
+  m_active_hash_count--;
+}
+
+void Avida::Systematics::GenotypeArbiter::growActiveHash()
+{
+  Apto::Array<GenomeSlot> old_slots(m_active_hash);
+  
+  m_active_hash.Resize(old_slots.GetSize() * 2);
+  m_active_hash.SetAll(GenomeSlot());
+  
+  const int mask = m_active_hash.GetSize() - 1;
+  for (int s = 0; s < old_slots.GetSize(); s++) {
+    if (!old_slots[s].genotype) continue;
+    int i = (int)(old_slots[s].hash & mask);
+    while (m_active_hash[i].genotype) i = (i + 1) & mask;
+    m_active_hash[i] = old_slots[s];
+  }
 }
 
 Apto::String Avida::Systematics::GenotypeArbiter::nameGenotype(int size)
@@ -502,8 +662,7 @@ void Avida::Systematics::GenotypeArbiter::removeGenotype(GenotypePtr genotype)
   if (genotype->IsActive()) {
     ConstInstructionSequencePtr seq;
     seq.DynamicCastFrom(genotype->GroupGenome().Representation());
-    int list_num = hashGenome(*seq);
-    m_active_hash[list_num].Remove(genotype);
+    removeActive(genotype, hashGenome(*seq));
     genotype->Deactivate(m_cur_update);
     m_historic.Push(genotype, &genotype->m_handle);
   }
@@ -511,6 +670,7 @@ void Avida::Systematics::GenotypeArbiter::removeGenotype(GenotypePtr genotype)
   if (genotype->IsThreshold()) {
     m_num_threshold--;
     notifyListeners(genotype, EVENT_REMOVE_THRESHOLD);
+    removeThreshold(genotype);
     genotype->ClearThreshold();
   }
   
@@ -530,6 +690,58 @@ void Avida::Systematics::GenotypeArbiter::removeGenotype(GenotypePtr genotype)
   
   delete genotype->m_handle;
   genotype->m_handle = NULL;
+  
+  // Ids kept from a snapshot may have been reused while this genotype was waiting to be removed
+  GenotypePtr indexed;
+  if (m_id_index.Get(genotype->ID(), indexed) && Apto::GetInternalPtr(indexed) == Apto::GetInternalPtr(genotype)) {
+    m_id_index.Remove(genotype->ID());
+  }
+}
+
+void Avida::Systematics::GenotypeArbiter::adjustStats(GenotypePtr genotype, int old_size, int new_size)
+{
+  if (old_size == new_size) return;
+  
+  ConstInstructionSequencePtr seq;
+  seq.DynamicCastFrom(genotype->GroupGenome().Representation());
+  assert(seq);
+  const int age = m_stats_update - genotype->GetUpdateBorn();
+  
+  // Only genotypes with units are included in the stats
+  if (old_size) {
+    m_age_stats.Subtract(age, old_size);
+    m_abundance_stats.Subtract(old_size, 1);
+    m_depth_stats.Subtract(genotype->Depth(), old_size);
+    m_size_stats.Subtract(seq->GetSize(), old_size);
+    if (genotype->IsThreshold()) m_threshold_age_stats.Subtract(age, old_size);
+  }
+  if (new_size) {
+    m_age_stats.Add(age, new_size);
+    m_abundance_stats.Add(new_size, 1);
+    m_depth_stats.Add(genotype->Depth(), new_size);
+    m_size_stats.Add(seq->GetSize(), new_size);
+    if (genotype->IsThreshold()) m_threshold_age_stats.Add(age, new_size);
+  }
+}
+
+void Avida::Systematics::GenotypeArbiter::addThreshold(GenotypePtr genotype)
+{
+  assert(!genotype->m_threshold_handle);
+  m_threshold_list.Push(genotype, &genotype->m_threshold_handle);
+  if (genotype->NumUnits()) {
+    m_threshold_age_stats.Add(m_stats_update - genotype->GetUpdateBorn(), genotype->NumUnits());
+  }
+}
+
+void Avida::Systematics::GenotypeArbiter::removeThreshold(GenotypePtr genotype)
+{
+  assert(genotype->m_threshold_handle);
+  genotype->m_threshold_handle->Remove();
+  delete genotype->m_threshold_handle;
+  genotype->m_threshold_handle = NULL;
+  if (genotype->NumUnits()) {
+    m_threshold_age_stats.Subtract(m_stats_update - genotype->GetUpdateBorn(), genotype->NumUnits());
+  }
 }
 
 void Avida::Systematics::GenotypeArbiter::updateCoalescent()
@@ -64,6 +64,14 @@ Avida::Systematics::Unit::~Unit()
   }
 }
 
+void Avida::Systematics::Unit::ResetClassification()
+{
+  for (int i = 0; i < m_groups->GetSize(); i++) {
+    m_groups->Get(i)->RemoveUnit();
+  }
+  m_groups = GroupMembershipPtr(new GroupMembership);
+}
+
 Avida::Systematics::GroupPtr Avida::Systematics::Unit::SystematicsGroup(const RoleID& role) const
 {
   for (int i = 0; i < m_groups->GetSize(); i++) if (m_groups->Get(i)->Role() == role) return m_groups->Get(i);
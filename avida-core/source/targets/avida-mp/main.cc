@@ -64,7 +64,13 @@ int main(int argc, char * argv[])
 	cfg->DATA_DIR.Set(dirname.str().c_str());
 	cout << "Data directory overwritten for Avida-MP: " << cfg->DATA_DIR.Get() << endl;
   
-  cWorld* world = cMultiProcessWorld::Initialize(cfg, AvidaTools::FileSystem::GetCWD(), mpi_env, mpi_world);
+  cWorld* world = NULL;
+  if (cfg->MP_TRANSPORT.Get() == 1) {
+    cout << "Using in-process loopback migration; MPI is not used for this world." << endl;
+    world = cMultiProcessWorld::Initialize(cfg, AvidaTools::FileSystem::GetCWD(), new cLoopbackMigrationTransport());
+  } else {
+    world = cMultiProcessWorld::Initialize(cfg, AvidaTools::FileSystem::GetCWD(), mpi_env, mpi_world);
+  }
 
   cout << endl;
   
@@ -87,6 +87,12 @@ void cOptionsScreen::Draw(cAvidaContext& ctx)
   case SLICE_INTEGRATED_MERIT:
     Print(1, 55, "Integrated");
     break;
+  case SLICE_BATCHED_PROB_MERIT:
+    Print(1, 55, "Batched Prob.");
+    break;
+  case SLICE_BATCHED_INTEGRATED_MERIT:
+    Print(1, 55, "Batched Integ.");
+    break;
   }
 
   switch(info.GetConfig().BASE_MERIT_METHOD.Get()) {
@@ -20,6 +20,8 @@
 
 #include "cTextViewerDriver_Base.h"
 
+#include "avida/output/Manager.h"
+
 #include "cAnalyze.h"
 #include "cString.h"
 #include "cStringList.h"
@@ -40,6 +42,11 @@ cTextViewerDriver_Base::~cTextViewerDriver_Base()
 
 void cTextViewerDriver_Base::Abort(AbortCondition condition)
 {
+  // Output files still being buffered would otherwise be cut short
+  if (m_world && m_world->GetNewWorld()) {
+    Avida::Output::ManagerPtr output_mgr = Avida::Output::Manager::Of(m_world->GetNewWorld());
+    if (output_mgr) output_mgr->FlushAll();
+  }
   exit(condition);
 }
 
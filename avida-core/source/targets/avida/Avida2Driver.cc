@@ -26,6 +26,7 @@
 
 #include "avida/core/Context.h"
 #include "avida/core/World.h"
+#include "avida/output/Manager.h"
 #include "avida/systematics/Group.h"
 
 #include "cAnalyze.h"
@@ -85,6 +86,11 @@ void Avida2Driver::Run()
     ActiveProcessStep = &cPopulation::ProcessStepSpeculative;
   }
   
+  const bool parallel_update = population.UsingParallelUpdate();
+  if (population.ParallelUpdateRefused()) {
+    Feedback().Warning("PARALLEL_UPDATE is incompatible with the current configuration, processing updates serially");
+  }
+  
   cAvidaContext& ctx = m_world->GetDefaultContext();
   Avida::Context new_ctx(this, &m_world->GetRandom());
   
@@ -108,11 +114,15 @@ void Avida2Driver::Run()
     const int UD_size = m_world->CalculateUpdateSize();
     const double step_size = 1.0 / (double) UD_size;
     
-    for (int i = 0; i < UD_size; i++) {
-      if(population.GetNumOrganisms() == 0) {
-        break;
+    if (parallel_update) {
+      population.ProcessUpdateParallel(ctx, UD_size);
+    } else {
+      for (int i = 0; i < UD_size; i++) {
+        if(population.GetNumOrganisms() == 0) {
+          break;
+        }
+        (population.*ActiveProcessStep)(ctx, step_size, population.ScheduleOrganism());
       }
-      (population.*ActiveProcessStep)(ctx, step_size, population.ScheduleOrganism());
     }
     
     // end of update stats...
@@ -164,6 +174,11 @@ void Avida2Driver::Run()
 
 void Avida2Driver::Abort(Avida::AbortCondition condition)
 {
+  // Output files still being buffered would otherwise be cut short
+  if (m_new_world) {
+    Avida::Output::ManagerPtr output_mgr = Avida::Output::Manager::Of(m_new_world);
+    if (output_mgr) output_mgr->FlushAll();
+  }
   exit(condition);
 }
 
@@ -0,0 +1,285 @@
+/*
+ *  cBatchedScheduler.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cBatchedScheduler.h"
+
+#include "cChunkedFile.h"
+
+
+cBatchedScheduler::cBatchedScheduler(int num_entries)
+: m_priority(num_entries), m_table(num_entries), m_live(0), m_dirty(false), m_batch_pos(0)
+{
+  m_priority.SetAll(0.0);
+  m_table.SetAll(0.0);
+}
+
+
+void cBatchedScheduler::AdjustPriority(int entry_id, double priority)
+{
+  if (priority < 0.0) priority = 0.0;
+
+  if (m_table[entry_id] > 0.0) {
+    const bool was_live = (m_priority[entry_id] > 0.0);
+    const bool is_live = (priority > 0.0);
+    if (was_live && !is_live) m_live--;
+    else if (!was_live && is_live) m_live++;
+  }
+
+  m_priority[entry_id] = priority;
+  m_dirty = true;
+}
+
+
+int cBatchedScheduler::Next()
+{
+  while (true) {
+    while (m_batch_pos < m_batch.GetSize()) {
+      const int entry_id = m_batch[m_batch_pos++];
+      if (m_priority[entry_id] > 0.0) return entry_id;
+    }
+
+    if (m_live == 0) {
+      Flush();
+      if (m_live == 0) return -1;
+    }
+
+    m_batch.Resize(0);
+    m_batch_pos = 0;
+    drawBatch(m_batch);
+  }
+}
+
+
+void cBatchedScheduler::Flush()
+{
+  m_batch.Resize(0);
+  m_batch_pos = 0;
+
+  if (!m_dirty) return;
+
+  m_live = 0;
+  for (int i = 0; i < m_priority.GetSize(); i++) {
+    m_table[i] = m_priority[i];
+    if (m_table[i] > 0.0) m_live++;
+  }
+  rebuild();
+  m_dirty = false;
+}
+
+
+void cBatchedScheduler::SaveState(cChunkBuffer& buf)
+{
+  buf.PutDoubleArray(m_priority);
+  buf.PutDoubleArray(m_table);
+  buf.PutVarInt(m_live);
+  buf.PutBool(m_dirty);
+  buf.PutIntArray(m_batch);
+  buf.PutVarInt(m_batch_pos);
+  saveTables(buf);
+}
+
+
+bool cBatchedScheduler::LoadState(cChunkBuffer& buf)
+{
+  const int num_entries = m_priority.GetSize();
+  if (!buf.GetDoubleArray(m_priority) || !buf.GetDoubleArray(m_table)) return false;
+  if (m_priority.GetSize() != num_entries || m_table.GetSize() != num_entries) return false;
+  m_live = (int)buf.GetVarInt();
+  m_dirty = buf.GetBool();
+  if (!buf.GetIntArray(m_batch)) return false;
+  m_batch_pos = (int)buf.GetVarInt();
+  if (buf.Fail() || m_batch_pos < 0 || m_batch_pos > m_batch.GetSize()) return false;
+  for (int i = 0; i < m_batch.GetSize(); i++) if (m_batch[i] < 0 || m_batch[i] >= num_entries) return false;
+  return loadTables(buf);
+}
+
+
+
+void cAliasScheduler::rebuild()
+{
+  int num_ids = 0;
+  double total = 0.0;
+  for (int i = 0; i < m_table.GetSize(); i++) {
+    if (m_table[i] > 0.0) {
+      num_ids++;
+      total += m_table[i];
+    }
+  }
+
+  m_ids.Resize(num_ids);
+  m_prob.Resize(num_ids);
+  m_alias.Resize(num_ids);
+  if (!num_ids) return;
+
+  // Vose's method: scale each weight so that the average is 1, then pair each under-full slot with an over-full one
+  Apto::Array<int, Apto::Smart> small;
+  Apto::Array<int, Apto::Smart> large;
+  for (int i = 0, slot = 0; i < m_table.GetSize(); i++) {
+    if (m_table[i] <= 0.0) continue;
+    m_ids[slot] = i;
+    m_prob[slot] = m_table[i] * num_ids / total;
+    m_alias[slot] = slot;
+    if (m_prob[slot] < 1.0) small.Push(slot);
+    else large.Push(slot);
+    slot++;
+  }
+
+  while (small.GetSize() && large.GetSize()) {
+    const int under = small.Pop();
+    const int over = large[large.GetSize() - 1];
+    m_alias[under] = over;
+    m_prob[over] -= 1.0 - m_prob[under];
+    if (m_prob[over] < 1.0) {
+      large.Pop();
+      small.Push(over);
+    }
+  }
+
+  // Anything left over is full, up to round-off
+  while (large.GetSize()) m_prob[large.Pop()] = 1.0;
+  while (small.GetSize()) m_prob[small.Pop()] = 1.0;
+}
+
+
+void cAliasScheduler::drawBatch(Apto::Array<int, Apto::Smart>& batch)
+{
+  const int num_ids = m_ids.GetSize();
+  if (!num_ids) return;
+
+  for (int i = 0; i < BATCH_SIZE; i++) {
+    // A single uniform deviate picks the slot (integer part) and the side of the slot (fractional part)
+    const double draw = m_rng->GetDouble() * num_ids;
+    int slot = (int)draw;
+    if (slot >= num_ids) slot = num_ids - 1;
+    batch.Push(((draw - slot) < m_prob[slot]) ? m_ids[slot] : m_ids[m_alias[slot]]);
+  }
+}
+
+
+void cAliasScheduler::saveTables(cChunkBuffer& buf)
+{
+  buf.PutIntArray(m_ids);
+  buf.PutDoubleArray(m_prob);
+  buf.PutIntArray(m_alias);
+  buf.PutRNG(*m_rng);
+}
+
+
+bool cAliasScheduler::loadTables(cChunkBuffer& buf)
+{
+  if (!buf.GetIntArray(m_ids) || !buf.GetDoubleArray(m_prob) || !buf.GetIntArray(m_alias)) return false;
+  if (m_prob.GetSize() != m_ids.GetSize() || m_alias.GetSize() != m_ids.GetSize()) return false;
+  for (int i = 0; i < m_ids.GetSize(); i++) {
+    if (m_ids[i] < 0 || m_ids[i] >= m_table.GetSize() || m_alias[i] < 0 || m_alias[i] >= m_ids.GetSize()) return false;
+  }
+  return buf.GetRNG(*m_rng);
+}
+
+
+
+cStrideScheduler::cStrideScheduler(int num_entries)
+: cBatchedScheduler(num_entries), m_pass(num_entries), m_vtime(0.0)
+{
+  m_pass.SetAll(-1.0);
+}
+
+
+void cStrideScheduler::rebuild()
+{
+  // Entries that stay scheduled keep their position (rebased to the current virtual time), new entries start one stride
+  // from now
+  m_heap.Resize(0);
+  for (int i = 0; i < m_table.GetSize(); i++) {
+    if (m_table[i] <= 0.0) {
+      m_pass[i] = -1.0;
+      continue;
+    }
+
+    if (m_pass[i] < 0.0) m_pass[i] = 1.0 / m_table[i];
+    else m_pass[i] = Apto::Max(0.0, m_pass[i] - m_vtime);
+
+    sEntry entry;
+    entry.pass = m_pass[i];
+    entry.id = i;
+    m_heap.Push(entry);
+  }
+  m_vtime = 0.0;
+
+  for (int i = m_heap.GetSize() / 2 - 1; i >= 0; i--) siftDown(i);
+}
+
+
+void cStrideScheduler::drawBatch(Apto::Array<int, Apto::Smart>& batch)
+{
+  // Only one entry per draw: unconsumed draws would already have advanced their pass when the batch is discarded
+  if (!m_heap.GetSize()) return;
+
+  sEntry& top = m_heap[0];
+  batch.Push(top.id);
+  m_vtime = top.pass;
+  top.pass += 1.0 / m_table[top.id];
+  m_pass[top.id] = top.pass;
+  siftDown(0);
+}
+
+
+void cStrideScheduler::saveTables(cChunkBuffer& buf)
+{
+  buf.PutVarUInt(m_heap.GetSize());
+  for (int i = 0; i < m_heap.GetSize(); i++) {
+    buf.PutDouble(m_heap[i].pass);
+    buf.PutVarInt(m_heap[i].id);
+  }
+  buf.PutDoubleArray(m_pass);
+  buf.PutDouble(m_vtime);
+}
+
+
+bool cStrideScheduler::loadTables(cChunkBuffer& buf)
+{
+  const int heap_size = (int)buf.GetVarUInt();
+  if (buf.Fail() || heap_size > m_table.GetSize()) return false;
+  m_heap.Resize(heap_size);
+  for (int i = 0; i < heap_size; i++) {
+    m_heap[i].pass = buf.GetDouble();
+    m_heap[i].id = (int)buf.GetVarInt();
+    if (m_heap[i].id < 0 || m_heap[i].id >= m_table.GetSize()) return false;
+  }
+  if (!buf.GetDoubleArray(m_pass) || m_pass.GetSize() != m_table.GetSize()) return false;
+  m_vtime = buf.GetDouble();
+  return !buf.Fail();
+}
+
+
+void cStrideScheduler::siftDown(int pos)
+{
+  const int size = m_heap.GetSize();
+  const sEntry entry = m_heap[pos];
+  while (true) {
+    int child = 2 * pos + 1;
+    if (child >= size) break;
+    if (child + 1 < size && before(m_heap[child + 1], m_heap[child])) child++;
+    if (!before(m_heap[child], entry)) break;
+    m_heap[pos] = m_heap[child];
+    pos = child;
+  }
+  m_heap[pos] = entry;
+}
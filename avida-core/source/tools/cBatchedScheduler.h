@@ -0,0 +1,126 @@
+/*
+ *  cBatchedScheduler.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cBatchedScheduler_h
+#define cBatchedScheduler_h
+
+#include "apto/core.h"
+#include "apto/rng.h"
+#include "apto/scheduler.h"
+
+class cChunkBuffer;
+
+
+// Priority schedulers for large worlds that take priority changes in bulk.  AdjustPriority only records the new value;
+// the draw tables are rebuilt from the recorded priorities when Flush is called (once per update by the population).
+// Entries are drawn BATCH_SIZE at a time.  An entry whose priority has dropped to zero since the last rebuild is
+// skipped when its turn comes up, so dead organisms are never scheduled, but an entry that gains priority (a birth into
+// an empty cell) is not scheduled until the next Flush.  If every entry in the tables has died, Next rebuilds early.
+
+class cBatchedScheduler : public Apto::PriorityScheduler
+{
+protected:
+  static const int BATCH_SIZE = 64;
+
+  Apto::Array<double> m_priority;   // Most recent priority of each entry
+  Apto::Array<double> m_table;      // Priority of each entry when the draw tables were last built
+  int m_live;                       // Entries with both table and current priority above zero
+  bool m_dirty;
+
+  Apto::Array<int, Apto::Smart> m_batch;
+  int m_batch_pos;
+
+
+  virtual void rebuild() = 0;
+  virtual void drawBatch(Apto::Array<int, Apto::Smart>& batch) = 0;
+  virtual void saveTables(cChunkBuffer& buf) = 0;
+  virtual bool loadTables(cChunkBuffer& buf) = 0;
+
+  cBatchedScheduler(); // @not_implemented
+  cBatchedScheduler(const cBatchedScheduler&); // @not_implemented
+  cBatchedScheduler& operator=(const cBatchedScheduler&); // @not_implemented
+
+public:
+  cBatchedScheduler(int num_entries);
+  virtual ~cBatchedScheduler() { ; }
+
+  void AdjustPriority(int entry_id, double priority);
+  int Next();
+
+  void Flush();
+
+  // Snapshot state: priorities, draw tables and the pending batch (and the random stream, where there is one, which
+  // saving reseeds)
+  void SaveState(cChunkBuffer& buf);
+  bool LoadState(cChunkBuffer& buf);
+};
+
+
+// Probabilistic, proportional to priority.  Draws are O(1) from a Walker/Vose alias table, which is rebuilt in O(n).
+
+class cAliasScheduler : public cBatchedScheduler
+{
+private:
+  Apto::SmartPtr<Apto::RNG::AvidaRNG> m_rng;
+
+  Apto::Array<int> m_ids;           // Entries with positive priority, in ID order
+  Apto::Array<double> m_prob;       // Probability of keeping slot i rather than taking its alias
+  Apto::Array<int> m_alias;
+
+  void rebuild();
+  void drawBatch(Apto::Array<int, Apto::Smart>& batch);
+  void saveTables(cChunkBuffer& buf);
+  bool loadTables(cChunkBuffer& buf);
+
+public:
+  cAliasScheduler(int num_entries, Apto::SmartPtr<Apto::RNG::AvidaRNG> rng) : cBatchedScheduler(num_entries), m_rng(rng) { ; }
+};
+
+
+// Deterministic, proportional to priority.  Stride scheduling: each entry advances its pass by 1/priority whenever it
+// runs, and the entry with the lowest pass runs next (ties go to the lower ID).  Draws are O(log n) from a binary heap.
+
+class cStrideScheduler : public cBatchedScheduler
+{
+private:
+  struct sEntry
+  {
+    double pass;
+    int id;
+  };
+
+  Apto::Array<sEntry, Apto::Smart> m_heap;
+  Apto::Array<double> m_pass;
+  double m_vtime;                   // Pass of the most recently drawn entry
+
+  static inline bool before(const sEntry& a, const sEntry& b) { return (a.pass < b.pass) || (a.pass == b.pass && a.id < b.id); }
+  void siftDown(int pos);
+
+  void rebuild();
+  void drawBatch(Apto::Array<int, Apto::Smart>& batch);
+  void saveTables(cChunkBuffer& buf);
+  bool loadTables(cChunkBuffer& buf);
+
+public:
+  cStrideScheduler(int num_entries);
+};
+
+#endif
@@ -0,0 +1,693 @@
+/*
+ *  cChunkedFile.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cChunkedFile.h"
+
+#include "apto/platform.h"
+#include "apto/core/Thread.h"
+
+#include <cstring>
+
+#if !APTO_PLATFORM(WINDOWS)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+
+// Chunk Header: raw size, stored size, method, checksum
+static const int CHUNK_HEADER_SIZE = 13;
+static const int MAX_CHUNK_SIZE = 1 << 30;
+
+enum { METHOD_STORED = 0, METHOD_LZ = 1 };
+
+
+// Block Compression
+// --------------------------------------------------------------------------------------------------------------
+//
+// The compressed block is a series of sequences: a token byte holding the literal count (high nibble) and the match
+// length minus MIN_MATCH (low nibble), with 15 in either nibble continued by bytes that are added on until one is below
+// 255; then the literals; then the 2 byte match offset and any match length continuation bytes.  The final sequence
+// ends after its literals.
+
+static const int MIN_MATCH = 4;
+static const int MAX_OFFSET = 65535;
+static const int HASH_BITS = 14;
+
+static inline unsigned int read32(const unsigned char* p)
+{
+  unsigned int v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline int hash32(unsigned int v)
+{
+  return (int)((v * 2654435761U) >> (32 - HASH_BITS));
+}
+
+static inline bool putLength(unsigned char*& op, const unsigned char* oend, int len)
+{
+  for (; len >= 255; len -= 255) {
+    if (op >= oend) return false;
+    *op++ = 255;
+  }
+  if (op >= oend) return false;
+  *op++ = (unsigned char)len;
+  return true;
+}
+
+static bool putSequence(unsigned char*& op, const unsigned char* oend, const unsigned char* lit, int lit_len,
+                        int offset, int match_len)
+{
+  if (op >= oend) return false;
+  unsigned char* token = op++;
+
+  const int lit_code = (lit_len < 15) ? lit_len : 15;
+  if (lit_code == 15 && !putLength(op, oend, lit_len - 15)) return false;
+  if (oend - op < lit_len) return false;
+  memcpy(op, lit, lit_len);
+  op += lit_len;
+
+  if (!match_len) {
+    *token = (unsigned char)(lit_code << 4);
+    return true;
+  }
+
+  const int match_code = (match_len - MIN_MATCH < 15) ? match_len - MIN_MATCH : 15;
+  *token = (unsigned char)((lit_code << 4) | match_code);
+  if (oend - op < 2) return false;
+  *op++ = (unsigned char)(offset & 0xFF);
+  *op++ = (unsigned char)(offset >> 8);
+  if (match_code == 15 && !putLength(op, oend, match_len - MIN_MATCH - 15)) return false;
+  return true;
+}
+
+static int compressBlock(const unsigned char* src, int size, unsigned char* dst)
+{
+  int table[1 << HASH_BITS];
+  for (int i = 0; i < (1 << HASH_BITS); i++) table[i] = -1;
+
+  unsigned char* op = dst;
+  const unsigned char* oend = dst + size;
+
+  int anchor = 0;
+  int i = 0;
+  while (i + MIN_MATCH <= size) {
+    const unsigned int v = read32(src + i);
+    const int h = hash32(v);
+    const int cand = table[h];
+    table[h] = i;
+
+    if (cand < 0 || i - cand > MAX_OFFSET || read32(src + cand) != v) {
+      i++;
+      continue;
+    }
+
+    int len = MIN_MATCH;
+    while (i + len < size && src[cand + len] == src[i + len]) len++;
+    if (!putSequence(op, oend, src + anchor, i - anchor, i - cand, len)) return -1;
+
+    // Index the tail of the match, so runs of repeated records keep chaining
+    if (i + len - 2 > i && i + len + 2 <= size) table[hash32(read32(src + i + len - 2))] = i + len - 2;
+
+    i += len;
+    anchor = i;
+  }
+
+  if (!putSequence(op, oend, src + anchor, size - anchor, 0, 0)) return -1;
+  if (op - dst >= size) return -1;
+  return (int)(op - dst);
+}
+
+static inline bool getLength(const unsigned char*& ip, const unsigned char* iend, int& len)
+{
+  unsigned char b;
+  do {
+    if (ip >= iend) return false;
+    b = *ip++;
+    len += b;
+    if (len > MAX_CHUNK_SIZE) return false;
+  } while (b == 255);
+  return true;
+}
+
+static bool decompressBlock(const unsigned char* src, int src_size, unsigned char* dst, int raw_size)
+{
+  const unsigned char* ip = src;
+  const unsigned char* iend = src + src_size;
+  unsigned char* op = dst;
+  unsigned char* oend = dst + raw_size;
+
+  while (ip < iend) {
+    const unsigned char token = *ip++;
+
+    int lit_len = token >> 4;
+    if (lit_len == 15 && !getLength(ip, iend, lit_len)) return false;
+    if (iend - ip < lit_len || oend - op < lit_len) return false;
+    memcpy(op, ip, lit_len);
+    ip += lit_len;
+    op += lit_len;
+
+    if (ip == iend) break; // Final sequence
+
+    if (iend - ip < 2) return false;
+    const int offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > op - dst) return false;
+
+    int match_len = token & 0x0F;
+    if (match_len == 15 && !getLength(ip, iend, match_len)) return false;
+    match_len += MIN_MATCH;
+    if (oend - op < match_len) return false;
+
+    // Byte at a time, since the match may overlap the bytes it produces
+    const unsigned char* match = op - offset;
+    for (int i = 0; i < match_len; i++) op[i] = match[i];
+    op += match_len;
+  }
+
+  return (op == oend && ip == iend);
+}
+
+static unsigned int checksum(const unsigned char* data, int size)
+{
+  // FNV-1a
+  unsigned int hash = 2166136261U;
+  for (int i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+static inline void encodeUInt32(unsigned char* p, unsigned int value)
+{
+  p[0] = (unsigned char)(value & 0xFF);
+  p[1] = (unsigned char)((value >> 8) & 0xFF);
+  p[2] = (unsigned char)((value >> 16) & 0xFF);
+  p[3] = (unsigned char)((value >> 24) & 0xFF);
+}
+
+static inline unsigned int decodeUInt32(const unsigned char* p)
+{
+  return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+
+
+// cChunkBuffer
+// --------------------------------------------------------------------------------------------------------------
+
+void cChunkBuffer::PutUInt32(unsigned int value)
+{
+  unsigned char bytes[4];
+  encodeUInt32(bytes, value);
+  PutBytes(bytes, 4);
+}
+
+void cChunkBuffer::PutVarUInt(unsigned long long value)
+{
+  while (value >= 0x80) {
+    m_data.Push((unsigned char)(value | 0x80));
+    value >>= 7;
+  }
+  m_data.Push((unsigned char)value);
+}
+
+void cChunkBuffer::PutDouble(double value)
+{
+  unsigned long long bits;
+  memcpy(&bits, &value, sizeof(bits));
+  PutUInt32((unsigned int)(bits & 0xFFFFFFFFULL));
+  PutUInt32((unsigned int)(bits >> 32));
+}
+
+void cChunkBuffer::PutBytes(const void* data, int size)
+{
+  if (size <= 0) return;
+  const int start = m_data.GetSize();
+  m_data.Resize(start + size);
+  memcpy(&m_data[start], data, size);
+}
+
+// Apto's generators have no state accessors, but their state is fully determined by a seed.  So the generator is
+// reseeded from its own stream and the new seed is saved; loading the seed puts an identical generator in place.
+void cChunkBuffer::PutRNG(Apto::RNG::AvidaRNG& rng)
+{
+  const int seed = rng.GetInt(rng.MaxSeed());
+  rng.ResetSeed(seed);
+  PutVarInt(seed);
+}
+
+
+unsigned int cChunkBuffer::GetUInt32()
+{
+  const unsigned char* p = GetBytes(4);
+  return (p) ? decodeUInt32(p) : 0;
+}
+
+unsigned long long cChunkBuffer::GetVarUInt()
+{
+  unsigned long long value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (m_pos >= m_size) break;
+    const unsigned char b = m_view[m_pos++];
+    value |= (unsigned long long)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return value;
+  }
+  m_fail = true;
+  return 0;
+}
+
+double cChunkBuffer::GetDouble()
+{
+  unsigned long long bits = GetUInt32();
+  bits |= (unsigned long long)GetUInt32() << 32;
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+bool cChunkBuffer::GetString(cString& str)
+{
+  const unsigned long long size = GetVarUInt();
+  if (m_fail || size > (unsigned long long)(m_size - m_pos)) {
+    m_fail = true;
+    return false;
+  }
+  str = cString((const char*)(m_view + m_pos), (int)size);
+  m_pos += (int)size;
+  return true;
+}
+
+const unsigned char* cChunkBuffer::GetBytes(int size)
+{
+  if (size < 0 || m_size - m_pos < size) {
+    m_fail = true;
+    return NULL;
+  }
+  const unsigned char* p = m_view + m_pos;
+  m_pos += size;
+  return p;
+}
+
+bool cChunkBuffer::GetRNG(Apto::RNG::AvidaRNG& rng)
+{
+  const long long seed = GetVarInt();
+  if (m_fail || seed < 0 || seed > rng.MaxSeed()) {
+    m_fail = true;
+    return false;
+  }
+  rng.ResetSeed((int)seed);
+  return true;
+}
+
+bool cChunkBuffer::getArraySize(int& size)
+{
+  // Every element takes at least one byte, which bounds the size of a corrupt array
+  const unsigned long long count = GetVarUInt();
+  if (m_fail || count > (unsigned long long)(m_size - m_pos)) {
+    m_fail = true;
+    size = 0;
+    return false;
+  }
+  size = (int)count;
+  return true;
+}
+
+
+
+// Background File Writing
+// --------------------------------------------------------------------------------------------------------------
+
+class cChunkedFileWriter::cBackgroundFile
+{
+public:
+  Apto::String path;
+  char magic[8];
+  unsigned int version;
+  Apto::Array<Apto::Array<unsigned char, Apto::Smart>*, Apto::Smart> chunks;
+
+  ~cBackgroundFile() { for (int i = 0; i < chunks.GetSize(); i++) delete chunks[i]; }
+
+  bool Write() const
+  {
+    cChunkedFileWriter writer;
+    if (!writer.Open(path, magic, version)) return false;
+    bool ok = true;
+    for (int i = 0; ok && i < chunks.GetSize(); i++) ok = writer.WriteChunk(&(*chunks[i])[0], chunks[i]->GetSize());
+    return writer.Close() && ok;
+  }
+};
+
+
+// A single writer thread, started on first use, writes queued files in the order they were closed
+class cBackgroundWriter : public Apto::Thread
+{
+private:
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;       // signaled when a file is queued (or on shutdown)
+  Apto::ConditionVariable m_done_cond;  // signaled when a file has been written
+  Apto::Array<cChunkedFileWriter::cBackgroundFile*, Apto::Smart> m_queue;
+  int m_writing;
+  bool m_started;
+  bool m_shutdown;
+  bool m_failed;
+
+  void Run()
+  {
+    m_mutex.Lock();
+    while (true) {
+      while (!m_shutdown && m_queue.GetSize() == 0) m_cond.Wait(m_mutex);
+      if (m_queue.GetSize() == 0) break;
+
+      cChunkedFileWriter::cBackgroundFile* file = m_queue[0];
+      for (int i = 1; i < m_queue.GetSize(); i++) m_queue[i - 1] = m_queue[i];
+      m_queue.Resize(m_queue.GetSize() - 1);
+      m_writing++;
+      m_mutex.Unlock();
+
+      const bool ok = file->Write();
+      delete file;
+
+      m_mutex.Lock();
+      m_writing--;
+      if (!ok) m_failed = true;
+      m_done_cond.Broadcast();
+    }
+    m_mutex.Unlock();
+  }
+
+public:
+  cBackgroundWriter() : m_writing(0), m_started(false), m_shutdown(false), m_failed(false) { ; }
+  ~cBackgroundWriter()
+  {
+    if (!m_started) return;
+    m_mutex.Lock();
+    m_shutdown = true;
+    m_mutex.Unlock();
+    m_cond.Broadcast();
+    Join();
+  }
+
+  void Queue(cChunkedFileWriter::cBackgroundFile* file)
+  {
+    m_mutex.Lock();
+    if (!m_started) {
+      m_started = true;
+      Start();
+    }
+    while (m_queue.GetSize() + m_writing >= cChunkedFileWriter::MAX_BACKGROUND_FILES) m_done_cond.Wait(m_mutex);
+    m_queue.Push(file);
+    m_mutex.Unlock();
+    m_cond.Broadcast();
+  }
+
+  bool Flush()
+  {
+    m_mutex.Lock();
+    while (m_queue.GetSize() + m_writing > 0) m_done_cond.Wait(m_mutex);
+    const bool ok = !m_failed;
+    m_failed = false;
+    m_mutex.Unlock();
+    return ok;
+  }
+};
+
+static cBackgroundWriter& backgroundWriter()
+{
+  static cBackgroundWriter writer;
+  return writer;
+}
+
+
+
+// cChunkedFileWriter
+// --------------------------------------------------------------------------------------------------------------
+
+bool cChunkedFileWriter::Open(const Apto::String& path, const char magic[8], unsigned int version, bool background)
+{
+  Close();
+
+  if (background) {
+    // Check that the file can be created now, so that the caller still sees the failure
+    m_fp.open((const char*)path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_fp.good()) return false;
+    m_fp.close();
+
+    m_background = new cBackgroundFile;
+    m_background->path = path;
+    memcpy(m_background->magic, magic, 8);
+    m_background->version = version;
+    m_closed = false;
+    m_bytes_written = 0;
+    return true;
+  }
+
+  m_fp.open((const char*)path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_fp.good()) return false;
+  m_closed = false;
+  m_bytes_written = 0;
+
+  unsigned char header[12];
+  memcpy(header, magic, 8);
+  encodeUInt32(header + 8, version);
+  m_fp.write((const char*)header, sizeof(header));
+  m_bytes_written += sizeof(header);
+
+  return m_fp.good();
+}
+
+bool cChunkedFileWriter::WriteChunk(const unsigned char* data, int size)
+{
+  if (m_closed) return false;
+  if (size <= 0) return true; // an empty chunk would read as the end marker
+  assert(size <= MAX_CHUNK_SIZE);
+
+  if (m_background) {
+    Apto::Array<unsigned char, Apto::Smart>* chunk = new Apto::Array<unsigned char, Apto::Smart>(size);
+    memcpy(&(*chunk)[0], data, size);
+    m_background->chunks.Push(chunk);
+    m_bytes_written += size;
+    return true;
+  }
+
+  m_compressed.Resize(size);
+  const int compressed_size = compressBlock(data, size, &m_compressed[0]);
+  const bool stored = (compressed_size < 0);
+
+  unsigned char header[CHUNK_HEADER_SIZE];
+  encodeUInt32(header, size);
+  encodeUInt32(header + 4, stored ? size : compressed_size);
+  header[8] = stored ? METHOD_STORED : METHOD_LZ;
+  encodeUInt32(header + 9, checksum(data, size));
+
+  m_fp.write((const char*)header, CHUNK_HEADER_SIZE);
+  if (stored) m_fp.write((const char*)data, size);
+  else m_fp.write((const char*)&m_compressed[0], compressed_size);
+  m_bytes_written += CHUNK_HEADER_SIZE + (stored ? size : compressed_size);
+
+  return m_fp.good();
+}
+
+bool cChunkedFileWriter::Close()
+{
+  if (m_closed) return true;
+
+  if (m_background) {
+    cBackgroundFile* file = m_background;
+    m_background = NULL;
+    m_closed = true;
+    backgroundWriter().Queue(file);
+    return true;
+  }
+
+  unsigned char header[CHUNK_HEADER_SIZE];
+  memset(header, 0, CHUNK_HEADER_SIZE);
+  m_fp.write((const char*)header, CHUNK_HEADER_SIZE);
+  m_bytes_written += CHUNK_HEADER_SIZE;
+
+  m_fp.close();
+  m_closed = true;
+  return !m_fp.fail();
+}
+
+bool cChunkedFileWriter::Flush()
+{
+  if (m_closed || m_background) return false;
+  m_fp.flush();
+  return m_fp.good();
+}
+
+bool cChunkedFileWriter::FlushBackground()
+{
+  return backgroundWriter().Flush();
+}
+
+
+
+// cChunkedFileReader
+// --------------------------------------------------------------------------------------------------------------
+
+bool cChunkedFileReader::HasMagic(const Apto::String& path, const char magic[8])
+{
+  std::ifstream fp((const char*)path, std::ios::in | std::ios::binary);
+  char found[8];
+  if (!fp.read(found, 8)) return false;
+  return (memcmp(found, magic, 8) == 0);
+}
+
+bool cChunkedFileReader::Open(const Apto::String& path, const char magic[8], bool use_mmap)
+{
+  closeMap();
+  if (m_fp.is_open()) m_fp.close();
+  m_fp.clear();
+  m_done = true;
+  m_fail = true;
+  m_incomplete = false;
+
+  unsigned char header[12];
+
+#if !APTO_PLATFORM(WINDOWS)
+  if (use_mmap) {
+    int fd = open((const char*)path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(header)) {
+      void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map != MAP_FAILED) {
+        m_map = static_cast<unsigned char*>(map);
+        m_map_size = st.st_size;
+      }
+    }
+    ::close(fd);
+  }
+
+  if (m_map) {
+    memcpy(header, m_map, sizeof(header));
+    m_map_pos = sizeof(header);
+  } else
+#endif
+  {
+    m_fp.open((const char*)path, std::ios::in | std::ios::binary);
+    if (!m_fp.read((char*)header, sizeof(header))) return false;
+  }
+
+  if (memcmp(header, magic, 8) != 0) return false;
+  m_version = decodeUInt32(header + 8);
+  m_done = false;
+  m_fail = false;
+  return true;
+}
+
+bool cChunkedFileReader::ReadChunk(cChunkBuffer& buffer)
+{
+  if (m_done || m_fail) return false;
+
+  unsigned char header[CHUNK_HEADER_SIZE];
+  const unsigned char* stored = NULL;
+
+  m_chunk_start = (m_map) ? m_map_pos : (long long)m_fp.tellg();
+  if (m_map) {
+    if (m_map_size - m_map_pos < CHUNK_HEADER_SIZE) {
+      m_fail = m_incomplete = true;
+      return false;
+    }
+    memcpy(header, m_map + m_map_pos, CHUNK_HEADER_SIZE);
+    m_map_pos += CHUNK_HEADER_SIZE;
+  } else if (!m_fp.read((char*)header, CHUNK_HEADER_SIZE)) {
+    m_fail = m_incomplete = true;
+    return false;
+  }
+
+  const unsigned int raw_size = decodeUInt32(header);
+  const unsigned int stored_size = decodeUInt32(header + 4);
+  const int method = header[8];
+
+  if (raw_size == 0) {
+    m_done = true;
+    return false;
+  }
+
+  if (raw_size > (unsigned int)MAX_CHUNK_SIZE || stored_size > raw_size ||
+      (method == METHOD_STORED && stored_size != raw_size) || (method != METHOD_STORED && method != METHOD_LZ)) {
+    m_fail = true;
+    return false;
+  }
+
+  if (m_map) {
+    if (m_map_size - m_map_pos < (long long)stored_size) {
+      m_fail = m_incomplete = true;
+      return false;
+    }
+    stored = m_map + m_map_pos;
+    m_map_pos += stored_size;
+  } else {
+    m_stored.Resize(stored_size);
+    if (!m_fp.read((char*)&m_stored[0], stored_size)) {
+      m_fail = m_incomplete = true;
+      return false;
+    }
+    stored = &m_stored[0];
+  }
+
+  const unsigned char* raw = stored;
+  if (method == METHOD_LZ) {
+    m_raw.Resize(raw_size);
+    if (!decompressBlock(stored, stored_size, &m_raw[0], raw_size)) {
+      m_fail = true;
+      return false;
+    }
+    raw = &m_raw[0];
+  }
+
+  if (checksum(raw, raw_size) != decodeUInt32(header + 9)) {
+    m_fail = true;
+    return false;
+  }
+
+  buffer.StartRead(raw, raw_size);
+  return true;
+}
+
+bool cChunkedFileReader::Resume()
+{
+  // A memory map does not grow with the file
+  if (!m_incomplete || m_map) return false;
+
+  m_fp.clear();
+  m_fp.seekg(m_chunk_start);
+  if (!m_fp.good()) return false;
+  m_fail = m_incomplete = false;
+  return true;
+}
+
+void cChunkedFileReader::closeMap()
+{
+#if !APTO_PLATFORM(WINDOWS)
+  if (m_map) munmap(m_map, (size_t)m_map_size);
+#endif
+  m_map = NULL;
+  m_map_size = 0;
+  m_map_pos = 0;
+}
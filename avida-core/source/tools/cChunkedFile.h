@@ -0,0 +1,242 @@
+/*
+ *  cChunkedFile.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cChunkedFile_h
+#define cChunkedFile_h
+
+#include "apto/core.h"
+#include "apto/rng.h"
+#include "cString.h"
+
+#include <fstream>
+
+
+// Versioned binary container for large save files.  The file starts with an 8 byte magic string naming the content and
+// a content version, followed by a sequence of chunks, each compressed on its own so that files can be written and read
+// a chunk at a time.  Every chunk header holds the raw size, the stored size, the compression method and a checksum of
+// the raw bytes.  An empty chunk marks the end of the file, so a truncated file is detected rather than read short.
+// All integers are little endian.
+//
+// cChunkBuffer builds and parses chunk payloads using fixed width and variable length (LEB128, zigzag for signed)
+// integers, doubles and length prefixed strings.
+//
+// A writer opened for background writing copies each chunk and hands the file to a shared writer thread on Close, which
+// compresses and writes it.  At most MAX_BACKGROUND_FILES closed files are held waiting to be written; Close blocks
+// until there is room.  FlushBackground waits for all of them and reports whether they were all written.
+//
+// A file can be read while it is still being written, as long as the writer flushes after each chunk.  The reader stops
+// at the first incomplete chunk (see Incomplete) and Resume picks up from there once more of the file is present.
+
+class cChunkBuffer
+{
+private:
+  Apto::Array<unsigned char, Apto::Smart> m_data;
+  const unsigned char* m_view;    // Data being read, either m_data or a chunk held by a reader
+  int m_size;
+  int m_pos;
+  bool m_fail;
+
+  cChunkBuffer(const cChunkBuffer&); // @not_implemented
+  cChunkBuffer& operator=(const cChunkBuffer&); // @not_implemented
+
+public:
+  cChunkBuffer() : m_view(NULL), m_size(0), m_pos(0), m_fail(false) { ; }
+
+  // --------  Writing  --------
+  void Clear() { m_data.Resize(0); m_view = NULL; m_size = 0; m_pos = 0; m_fail = false; }
+  int GetSize() const { return m_data.GetSize(); }
+  const unsigned char* GetData() const { return m_data.GetSize() ? &m_data[0] : NULL; }
+
+  inline void PutByte(unsigned char value) { m_data.Push(value); }
+  void PutUInt32(unsigned int value);
+  void PutVarUInt(unsigned long long value);
+  inline void PutVarInt(long long value) { PutVarUInt(((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63)); }
+  void PutDouble(double value);
+  void PutBytes(const void* data, int size);
+  inline void PutString(const cString& str) { PutVarUInt(str.GetSize()); PutBytes((const char*)str, str.GetSize()); }
+  inline void PutBool(bool value) { PutByte(value ? 1 : 0); }
+  template <class ArrayType> void PutIntArray(const ArrayType& values);
+  template <class ArrayType> void PutDoubleArray(const ArrayType& values);
+  template <class ArrayType> void PutBoolArray(const ArrayType& values);
+  void PutRNG(Apto::RNG::AvidaRNG& rng);  // Reseeds rng from its own stream, and saves the new seed
+
+  // --------  Reading  --------
+  // Reads from the data written into this buffer, or from size bytes at data (which must stay valid while reading)
+  void StartRead() { m_view = GetData(); m_size = m_data.GetSize(); m_pos = 0; m_fail = false; }
+  void StartRead(const unsigned char* data, int size) { m_view = data; m_size = size; m_pos = 0; m_fail = false; }
+
+  bool AtEnd() const { return m_pos >= m_size; }
+  int GetRemaining() const { return m_size - m_pos; }
+  bool Fail() const { return m_fail; }
+
+  inline unsigned char GetByte();
+  unsigned int GetUInt32();
+  unsigned long long GetVarUInt();
+  inline long long GetVarInt() { unsigned long long v = GetVarUInt(); return (long long)(v >> 1) ^ -(long long)(v & 1); }
+  double GetDouble();
+  bool GetString(cString& str);
+  const unsigned char* GetBytes(int size);  // NULL if fewer than size bytes remain
+  inline bool GetBool() { return GetByte() != 0; }
+  template <class ArrayType> bool GetIntArray(ArrayType& values);
+  template <class ArrayType> bool GetDoubleArray(ArrayType& values);
+  template <class ArrayType> bool GetBoolArray(ArrayType& values);
+  bool GetRNG(Apto::RNG::AvidaRNG& rng);
+
+private:
+  bool getArraySize(int& size);
+};
+
+
+class cChunkedFileWriter
+{
+public:
+  static const int MAX_BACKGROUND_FILES = 2;
+
+  class cBackgroundFile;
+
+private:
+  std::ofstream m_fp;
+  Apto::Array<unsigned char, Apto::Smart> m_compressed;
+  long long m_bytes_written;
+  bool m_closed;
+  cBackgroundFile* m_background;  // Chunks waiting for the writer thread, when opened for background writing
+
+  cChunkedFileWriter(const cChunkedFileWriter&); // @not_implemented
+  cChunkedFileWriter& operator=(const cChunkedFileWriter&); // @not_implemented
+
+public:
+  cChunkedFileWriter() : m_bytes_written(0), m_closed(true), m_background(NULL) { ; }
+  ~cChunkedFileWriter() { Close(); }
+
+  bool Open(const Apto::String& path, const char magic[8], unsigned int version, bool background = false);
+  bool WriteChunk(const cChunkBuffer& chunk) { return WriteChunk(chunk.GetData(), chunk.GetSize()); }
+  bool WriteChunk(const unsigned char* data, int size);
+  bool Close();  // Writes the end marker, or queues the file for background writing
+  bool Flush();  // Makes the chunks written so far visible to readers (not for background files)
+
+  bool Good() const { return !m_closed && (m_background || m_fp.good()); }
+  long long GetBytesWritten() const { return m_bytes_written; }  // Raw chunk bytes for background files
+
+  static bool FlushBackground();
+};
+
+
+class cChunkedFileReader
+{
+private:
+  std::ifstream m_fp;
+  unsigned int m_version;
+
+  // Memory mapped input, if requested and supported
+  unsigned char* m_map;
+  long long m_map_size;
+  long long m_map_pos;
+
+  Apto::Array<unsigned char, Apto::Smart> m_stored;
+  Apto::Array<unsigned char, Apto::Smart> m_raw;
+  long long m_chunk_start;
+  bool m_done;
+  bool m_fail;
+  bool m_incomplete;
+
+  void closeMap();
+
+  cChunkedFileReader(const cChunkedFileReader&); // @not_implemented
+  cChunkedFileReader& operator=(const cChunkedFileReader&); // @not_implemented
+
+public:
+  cChunkedFileReader()
+    : m_version(0), m_map(NULL), m_map_size(0), m_map_pos(0), m_chunk_start(0), m_done(true), m_fail(false), m_incomplete(false) { ; }
+  ~cChunkedFileReader() { closeMap(); }
+
+  // Checks the magic string and reads the content version; the version must be checked by the caller
+  bool Open(const Apto::String& path, const char magic[8], bool use_mmap = false);
+  unsigned int GetVersion() const { return m_version; }
+
+  // Loads the next chunk into buffer for reading.  Returns false at the end of the file or on error (see Fail).
+  bool ReadChunk(cChunkBuffer& buffer);
+  bool Fail() const { return m_fail; }
+  bool AtEnd() const { return m_done; }
+
+  // True when the last read failed only because the file ends partway through a chunk, or where the end marker should
+  // be, as a file still being written does.  Resume rewinds to the start of that chunk so that it can be read again.
+  bool Incomplete() const { return m_incomplete; }
+  bool Resume();
+
+  static bool HasMagic(const Apto::String& path, const char magic[8]);
+};
+
+
+inline unsigned char cChunkBuffer::GetByte()
+{
+  if (m_pos >= m_size) {
+    m_fail = true;
+    return 0;
+  }
+  return m_view[m_pos++];
+}
+
+template <class ArrayType> void cChunkBuffer::PutIntArray(const ArrayType& values)
+{
+  PutVarUInt(values.GetSize());
+  for (int i = 0; i < values.GetSize(); i++) PutVarInt(values[i]);
+}
+
+template <class ArrayType> void cChunkBuffer::PutDoubleArray(const ArrayType& values)
+{
+  PutVarUInt(values.GetSize());
+  for (int i = 0; i < values.GetSize(); i++) PutDouble(values[i]);
+}
+
+template <class ArrayType> void cChunkBuffer::PutBoolArray(const ArrayType& values)
+{
+  PutVarUInt(values.GetSize());
+  for (int i = 0; i < values.GetSize(); i++) PutBool(values[i]);
+}
+
+template <class ArrayType> bool cChunkBuffer::GetIntArray(ArrayType& values)
+{
+  int size;
+  if (!getArraySize(size)) return false;
+  values.ResizeClear(size);
+  for (int i = 0; i < size; i++) values[i] = (int)GetVarInt();
+  return !m_fail;
+}
+
+template <class ArrayType> bool cChunkBuffer::GetDoubleArray(ArrayType& values)
+{
+  int size;
+  if (!getArraySize(size)) return false;
+  values.ResizeClear(size);
+  for (int i = 0; i < size; i++) values[i] = GetDouble();
+  return !m_fail;
+}
+
+template <class ArrayType> bool cChunkBuffer::GetBoolArray(ArrayType& values)
+{
+  int size;
+  if (!getArraySize(size)) return false;
+  values.ResizeClear(size);
+  for (int i = 0; i < size; i++) values[i] = GetBool();
+  return !m_fail;
+}
+
+#endif
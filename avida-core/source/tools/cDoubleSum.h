@@ -69,6 +69,24 @@ public:
     s1 -= w_val;
     s2 -= w_val * w_val;
   }
+
+  // Snapshot state, written to a cChunkBuffer
+  template <class ChunkBuffer> void SaveState(ChunkBuffer& buf) const
+  {
+    buf.PutDouble(s1);
+    buf.PutDouble(s2);
+    buf.PutDouble(n);
+    buf.PutDouble(max);
+  }
+
+  template <class ChunkBuffer> bool LoadState(ChunkBuffer& buf)
+  {
+    s1 = buf.GetDouble();
+    s2 = buf.GetDouble();
+    n = buf.GetDouble();
+    max = buf.GetDouble();
+    return !buf.Fail();
+  }
 };
 
 #endif
@@ -0,0 +1,94 @@
+/*
+ *  cGridLineCounts.cc
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGridLineCounts.h"
+
+#include <cassert>
+
+
+void cGridLineCounts::ResizeClear(int size_x, int size_y)
+{
+  m_size_x = size_x;
+  m_size_y = size_y;
+  m_rows.ResizeClear(size_x * size_y);
+  m_cols.ResizeClear(size_x * size_y);
+  m_rows.SetAll(0);
+  m_cols.SetAll(0);
+}
+
+void cGridLineCounts::Build(const Apto::Array<int>& counts)
+{
+  assert(counts.GetSize() == m_size_x * m_size_y);
+  if (counts.GetSize() == 0) return;
+
+  for (int y = 0; y < m_size_y; y++) {
+    for (int x = 0; x < m_size_x; x++) {
+      m_rows[y * m_size_x + x] = counts[y * m_size_x + x];
+      m_cols[x * m_size_y + y] = counts[y * m_size_x + x];
+    }
+  }
+  for (int y = 0; y < m_size_y; y++) buildTree(&m_rows[y * m_size_x], m_size_x);
+  for (int x = 0; x < m_size_x; x++) buildTree(&m_cols[x * m_size_y], m_size_y);
+}
+
+void cGridLineCounts::Add(int x, int y, int delta)
+{
+  assert(x >= 0 && x < m_size_x && y >= 0 && y < m_size_y);
+  addTree(&m_rows[y * m_size_x], m_size_x, x, delta);
+  addTree(&m_cols[x * m_size_y], m_size_y, y, delta);
+}
+
+int cGridLineCounts::Count(int x1, int y1, int x2, int y2) const
+{
+  if (x1 > x2) { const int t = x1; x1 = x2; x2 = t; }
+  if (y1 > y2) { const int t = y1; y1 = y2; y2 = t; }
+  assert(x1 >= 0 && x2 < m_size_x && y1 >= 0 && y2 < m_size_y);
+
+  if (y1 == y2) {
+    const int* tree = &m_rows[y1 * m_size_x];
+    return sumTree(tree, x2 + 1) - sumTree(tree, x1);
+  }
+  assert(x1 == x2);
+  const int* tree = &m_cols[x1 * m_size_y];
+  return sumTree(tree, y2 + 1) - sumTree(tree, y1);
+}
+
+
+// Converts plain counts into a tree in place, in linear time (entry i, 1-based, holds the sum of the i & -i entries
+// ending at i)
+void cGridLineCounts::buildTree(int* tree, int size)
+{
+  for (int i = 1; i <= size; i++) {
+    const int parent = i + (i & -i);
+    if (parent <= size) tree[parent - 1] += tree[i - 1];
+  }
+}
+
+void cGridLineCounts::addTree(int* tree, int size, int pos, int delta)
+{
+  for (int i = pos + 1; i <= size; i += (i & -i)) tree[i - 1] += delta;
+}
+
+int cGridLineCounts::sumTree(const int* tree, int pos)
+{
+  int sum = 0;
+  for (int i = pos; i > 0; i -= (i & -i)) sum += tree[i - 1];
+  return sum;
+}
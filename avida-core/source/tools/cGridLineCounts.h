@@ -0,0 +1,59 @@
+/*
+ *  cGridLineCounts.h
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cGridLineCounts_h
+#define cGridLineCounts_h
+
+#include "apto/core/Array.h"
+
+
+// Counts of things in the cells of a grid, indexed for sums along any run of cells in a single row or column.
+//
+// Every row and every column is kept as a Fenwick (binary indexed) tree, so both changing the count in one cell and
+// summing a run of a row or column take O(log n) time, and the whole index can be rebuilt from scratch in O(cells).
+
+class cGridLineCounts
+{
+private:
+  int m_size_x;
+  int m_size_y;
+  Apto::Array<int> m_rows;   // m_size_y trees of m_size_x entries
+  Apto::Array<int> m_cols;   // m_size_x trees of m_size_y entries
+
+  static void buildTree(int* tree, int size);
+  static void addTree(int* tree, int size, int pos, int delta);
+  static int sumTree(const int* tree, int pos);   // Sum of the first pos entries
+
+public:
+  cGridLineCounts() : m_size_x(0), m_size_y(0) { ; }
+
+  void ResizeClear(int size_x, int size_y);
+  void Build(const Apto::Array<int>& counts);   // Row-major counts for every cell
+
+  void Add(int x, int y, int delta);
+
+  // Sum of the inclusive run of cells from (x1, y1) to (x2, y2), which must lie in one row or one column
+  int Count(int x1, int y1, int x2, int y2) const;
+
+  int GetSizeX() const { return m_size_x; }
+  int GetSizeY() const { return m_size_y; }
+};
+
+#endif
@@ -23,6 +23,7 @@
 #include "cInitFile.h"
 
 #include "apto/core/FileSystem.h"
+#include "avida/output/File.h"
 
 #include "AvidaTools.h"
 #include "cFile.h"
@@ -103,6 +104,10 @@ bool cInitFile::loadFile(const cString& filename, Apto::Array<sLine*, Apto::Smar
                          const Apto::Set<Apto::String>* custom_directives, Feedback& feedback)
 {
   cString path = cString(Apto::FileSystem::GetAbsolutePath(Apto::String(filename), Apto::String(working_dir))); 
+  
+  // The file may have been written during this run and still be queued for the background writer
+  Avida::Output::File::WaitForPendingWrites();
+  
   cFile file(path);
   if (!file.IsOpen()) {
     feedback.Error("unable to open file '%s'.", (const char*)filename);
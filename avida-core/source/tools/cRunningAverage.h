@@ -68,6 +68,29 @@ public:
   // Notation Shortcuts
   double Ave() const { return Average(); }
   double Var() const { return Variance(); }
+
+  // Snapshot state, written to a cChunkBuffer.  The window size must match.
+  template <class ChunkBuffer> void SaveState(ChunkBuffer& buf) const
+  {
+    buf.PutVarInt(m_window_size);
+    buf.PutVarInt(m_pointer);
+    buf.PutVarInt(m_n);
+    buf.PutDouble(m_s1);
+    buf.PutDouble(m_s2);
+    for (int i = 0; i < m_n; i++) buf.PutDouble(m_values[i]);
+  }
+
+  template <class ChunkBuffer> bool LoadState(ChunkBuffer& buf)
+  {
+    if ((int)buf.GetVarInt() != m_window_size) return false;
+    m_pointer = (int)buf.GetVarInt();
+    m_n = (int)buf.GetVarInt();
+    if (buf.Fail() || m_n < 0 || m_n > m_window_size || m_pointer < 0 || m_pointer >= m_window_size) return false;
+    m_s1 = buf.GetDouble();
+    m_s2 = buf.GetDouble();
+    for (int i = 0; i < m_n; i++) m_values[i] = buf.GetDouble();
+    return !buf.Fail();
+  }
 };
 
 #endif
@@ -48,6 +48,26 @@ public:
   inline double Variance() const { return (m_n > 1.0) ? (m_m2 / (m_n - 1.0)) : 0.0; }
   inline double Skewness() const { return sqrt(m_n) * m_m3 / pow(m_m2, 1.5); }
   inline double Kurtosis() const { return m_n * m_m4 / (m_m2 * m_m2); }
+
+  // Snapshot state, written to a cChunkBuffer
+  template <class ChunkBuffer> void SaveState(ChunkBuffer& buf) const
+  {
+    buf.PutDouble(m_n);
+    buf.PutDouble(m_m1);
+    buf.PutDouble(m_m2);
+    buf.PutDouble(m_m3);
+    buf.PutDouble(m_m4);
+  }
+
+  template <class ChunkBuffer> bool LoadState(ChunkBuffer& buf)
+  {
+    m_n = buf.GetDouble();
+    m_m1 = buf.GetDouble();
+    m_m2 = buf.GetDouble();
+    m_m3 = buf.GetDouble();
+    m_m4 = buf.GetDouble();
+    return !buf.Fail();
+  }
 };
 
 
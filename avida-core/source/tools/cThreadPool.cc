@@ -0,0 +1,119 @@
+/*
+ *  cThreadPool.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cThreadPool.h"
+
+#include "apto/platform.h"
+
+
+cThreadPool::cThreadPool(int num_threads)
+: m_task(NULL), m_num_items(0), m_next_item(0), m_completed(0), m_batch(0), m_shutdown(false)
+{
+  if (num_threads < 1) num_threads = Apto::Platform::AvailableCPUs();
+
+  // The calling thread always participates, so only spawn the additional workers
+  m_workers.Resize(num_threads - 1);
+  for (int i = 0; i < m_workers.GetSize(); i++) {
+    m_workers[i] = new cWorker(this);
+    m_workers[i]->Start();
+  }
+}
+
+cThreadPool::~cThreadPool()
+{
+  m_mutex.Lock();
+  m_shutdown = true;
+  m_mutex.Unlock();
+  m_cond.Broadcast();
+
+  for (int i = 0; i < m_workers.GetSize(); i++) {
+    m_workers[i]->Join();
+    delete m_workers[i];
+  }
+}
+
+
+// Must be called with m_mutex held, returns with m_mutex held
+bool cThreadPool::runNextItem()
+{
+  if (m_next_item >= m_num_items) return false;
+
+  const int item = m_next_item++;
+  cTask* task = m_task;
+  m_mutex.Unlock();
+
+  task->Run(item);
+
+  m_mutex.Lock();
+  if (++m_completed == m_num_items) m_done_cond.Broadcast();
+  return true;
+}
+
+
+void cThreadPool::Execute(cTask& task, int num_items)
+{
+  if (num_items <= 0) return;
+
+  // Skip all synchronization when there is nothing to share
+  if (m_workers.GetSize() == 0 || num_items == 1) {
+    for (int i = 0; i < num_items; i++) task.Run(i);
+    return;
+  }
+
+  m_mutex.Lock();
+  
+  // A task that itself calls Execute (e.g. lazily triggered resource updates) runs its nested items inline
+  if (m_task) {
+    m_mutex.Unlock();
+    for (int i = 0; i < num_items; i++) task.Run(i);
+    return;
+  }
+  
+  m_task = &task;
+  m_num_items = num_items;
+  m_next_item = 0;
+  m_completed = 0;
+  m_batch++;
+  m_mutex.Unlock();
+  m_cond.Broadcast();
+
+  m_mutex.Lock();
+  while (runNextItem()) ;
+  while (m_completed < m_num_items) m_done_cond.Wait(m_mutex);
+  m_task = NULL;
+  m_mutex.Unlock();
+}
+
+
+void cThreadPool::cWorker::Run()
+{
+  int last_batch = 0;
+
+  m_pool->m_mutex.Lock();
+  while (true) {
+    while (!m_pool->m_shutdown && m_pool->m_batch == last_batch) m_pool->m_cond.Wait(m_pool->m_mutex);
+    if (m_pool->m_shutdown) break;
+
+    last_batch = m_pool->m_batch;
+    while (m_pool->runNextItem()) ;
+  }
+  m_pool->m_mutex.Unlock();
+}
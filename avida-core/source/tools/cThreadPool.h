@@ -0,0 +1,88 @@
+/*
+ *  cThreadPool.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cThreadPool_h
+#define cThreadPool_h
+
+#include "apto/core.h"
+#include "apto/core/Thread.h"
+
+
+// A small fork/join pool of persistent worker threads.  Execute() hands out the items [0, num_items) of a task to the
+// workers (and the calling thread) and returns once every item has completed.  Items are claimed in index order, but may
+// run in any order and on any thread, so tasks must not depend on cross-item ordering for deterministic results.  Calls to
+// Execute made while another batch is in progress are run serially on the calling thread.
+
+class cThreadPool
+{
+public:
+  class cTask
+  {
+  public:
+    virtual ~cTask() { ; }
+    virtual void Run(int item) = 0;
+  };
+
+private:
+  class cWorker : public Apto::Thread
+  {
+  private:
+    cThreadPool* m_pool;
+
+    void Run();
+
+  public:
+    cWorker(cThreadPool* pool) : m_pool(pool) { ; }
+  };
+  friend class cWorker;
+
+
+  Apto::Array<cWorker*> m_workers;
+
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;       // signaled when a new batch is available (or on shutdown)
+  Apto::ConditionVariable m_done_cond;  // signaled when the last item of a batch completes
+
+  cTask* m_task;
+  int m_num_items;
+  int m_next_item;
+  int m_completed;
+  int m_batch;                          // incremented for each batch, lets sleeping workers detect new work
+  bool m_shutdown;
+
+
+  bool runNextItem();
+
+  cThreadPool(); // @not_implemented
+  cThreadPool(const cThreadPool&); // @not_implemented
+  cThreadPool& operator=(const cThreadPool&); // @not_implemented
+
+public:
+  // num_threads includes the calling thread; values < 1 use all available CPUs
+  cThreadPool(int num_threads);
+  ~cThreadPool();
+
+  int GetNumThreads() const { return m_workers.GetSize() + 1; }
+
+  void Execute(cTask& task, int num_items);
+};
+
+#endif
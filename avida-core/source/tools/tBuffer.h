@@ -81,6 +81,24 @@ public:
   int GetTotal() const { return total; }
   int GetNumStored() const { return (total <= data.GetSize()) ? total : data.GetSize(); }
   int GetNum() const { return total - last_total; }
+
+  // Snapshot state, written to a cChunkBuffer (integer buffers only)
+  template <class ChunkBuffer> void SaveState(ChunkBuffer& buf) const
+  {
+    buf.PutIntArray(data);
+    buf.PutVarInt(offset);
+    buf.PutVarInt(total);
+    buf.PutVarInt(last_total);
+  }
+
+  template <class ChunkBuffer> bool LoadState(ChunkBuffer& buf)
+  {
+    if (!buf.GetIntArray(data)) return false;
+    offset = (int)buf.GetVarInt();
+    total = (int)buf.GetVarInt();
+    last_total = (int)buf.GetVarInt();
+    return !buf.Fail() && offset >= 0 && (offset < data.GetSize() || offset == 0);
+  }
 };
 
 #endif
@@ -0,0 +1,121 @@
+/*
+ *  series_dump.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Prints a binary time series file (.tsr, written by the RecordTimeSeries action) as a text data file.  With -c only
+// the selected columns are printed; with -f the file is followed as the run adds rows, until the run closes it.
+
+#include "avida/data/ColumnarRecorder.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+using namespace std;
+
+
+static void usage(const char* name)
+{
+  cerr << "Usage: " << name << " [-f] [-c data_id[,data_id...]] [-o output] <file.tsr>" << endl
+       << "  -f  keep reading rows as the run adds them, until the file is complete" << endl
+       << "  -c  print only the listed columns, in the order given" << endl
+       << "  -o  write to the named file instead of standard output" << endl;
+  exit(1);
+}
+
+
+int main(int argc, char* argv[])
+{
+  bool follow = false;
+  Apto::String columns;
+  const char* out_path = NULL;
+  const char* in_path = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-f") == 0) follow = true;
+    else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) columns = argv[++i];
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out_path = argv[++i];
+    else if (argv[i][0] != '-' && !in_path) in_path = argv[i];
+    else usage(argv[0]);
+  }
+  if (!in_path) usage(argv[0]);
+
+  Avida::Data::ColumnarReader reader;
+  if (!reader.Open(in_path)) {
+    cerr << "error: unable to read time series file '" << in_path << "'" << endl;
+    return 1;
+  }
+
+  // Resolve the selected columns
+  Apto::Array<int> selected;
+  if (columns.GetSize()) {
+    while (columns.GetSize()) {
+      Apto::String data_id = columns.Pop(',');
+      int col = -1;
+      for (int i = 0; i < reader.NumColumns(); i++) if (reader.ColumnID(i) == data_id) col = i;
+      if (col < 0) {
+        cerr << "error: no column '" << (const char*)data_id << "' in '" << in_path << "'" << endl;
+        return 1;
+      }
+      selected.Push(col);
+    }
+  } else {
+    for (int i = 0; i < reader.NumColumns(); i++) selected.Push(i);
+  }
+
+  ofstream out_file;
+  if (out_path) {
+    out_file.open(out_path);
+    if (!out_file.good()) {
+      cerr << "error: unable to open '" << out_path << "' for writing" << endl;
+      return 1;
+    }
+  }
+  ostream& out = (out_path) ? out_file : cout;
+
+  out << "# Avida time series data, recorded every " << reader.Interval() << " updates" << endl;
+  out << "#  1: Update" << endl;
+  for (int i = 0; i < selected.GetSize(); i++) {
+    out << "# " << ((i + 2 < 10) ? " " : "") << (i + 2) << ": " << (const char*)reader.ColumnID(selected[i]) << endl;
+  }
+  out << endl;
+
+  while (true) {
+    while (reader.NextRow()) {
+      out << reader.RowUpdate() << " ";
+      for (int i = 0; i < selected.GetSize(); i++) out << (const char*)reader.StringValue(selected[i]) << " ";
+      out << "\n";
+    }
+    if (reader.Fail() || reader.Done() || !follow) break;
+
+    out.flush();
+    sleep(1);
+  }
+
+  if (reader.Fail()) {
+    cerr << "error: time series file '" << in_path << "' is damaged" << endl;
+    return 1;
+  }
+  if (!reader.Done()) cerr << "warning: '" << in_path << "' is still being written, printed the rows so far" << endl;
+
+  return 0;
+}